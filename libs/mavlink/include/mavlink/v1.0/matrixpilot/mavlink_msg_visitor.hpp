@@ -0,0 +1,2701 @@
+/** @file
+ *	@brief MAVLink typed message visitor built from matrixpilot.xml
+ *	@see http://pixhawk.ethz.ch/software/mavlink
+ */
+#ifndef MAVLINK_MSG_VISITOR_HPP
+#define MAVLINK_MSG_VISITOR_HPP
+
+#include "mavlink.h"
+
+/*
+ * Typed access to every field of a message, with the wire offsets and
+ * types resolved at compile time:
+ *
+ *   mavlink::message<MSGID>          number of fields and payload length
+ *   mavlink::field<MSGID, FIELD>     type, wire offset and array length
+ *   mavlink::get<MSGID, FIELD>(msg)  value of a field (or array entry)
+ *   mavlink::visit(msg, visitor)     unpacks all fields into a visitor
+ *
+ * FIELD is the index of the field in MAVLINK_MESSAGE_INFO. A visitor
+ * implements
+ *
+ *   void value(uint8_t field, T value);
+ *   void element(uint8_t field, uint8_t index, T value);
+ *   void text(uint8_t field, const char* text, uint8_t length);
+ *
+ * for T in char, int8_t .. uint64_t, float and double. value() is
+ * called for single values, element() for every entry of an array and
+ * text() for char arrays, which are not null terminated on the wire.
+ */
+
+namespace mavlink {
+
+template <typename T> struct wire;
+template <> struct wire<char> { static char get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_char(msg, ofs); } };
+template <> struct wire<int8_t> { static int8_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_int8_t(msg, ofs); } };
+template <> struct wire<uint8_t> { static uint8_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_uint8_t(msg, ofs); } };
+template <> struct wire<int16_t> { static int16_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_int16_t(msg, ofs); } };
+template <> struct wire<uint16_t> { static uint16_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_uint16_t(msg, ofs); } };
+template <> struct wire<int32_t> { static int32_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_int32_t(msg, ofs); } };
+template <> struct wire<uint32_t> { static uint32_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_uint32_t(msg, ofs); } };
+template <> struct wire<int64_t> { static int64_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_int64_t(msg, ofs); } };
+template <> struct wire<uint64_t> { static uint64_t get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_uint64_t(msg, ofs); } };
+template <> struct wire<float> { static float get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_float(msg, ofs); } };
+template <> struct wire<double> { static double get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_double(msg, ofs); } };
+
+template <uint8_t MSGID> struct message;
+template <uint8_t MSGID, uint8_t FIELD> struct field;
+
+template <uint8_t MSGID, uint8_t FIELD>
+inline typename field<MSGID, FIELD>::type get(const mavlink_message_t* msg, uint8_t index = 0)
+{
+	typedef field<MSGID, FIELD> f;
+	return wire<typename f::type>::get(msg, f::wire_offset + index * sizeof(typename f::type));
+}
+
+/* HEARTBEAT */
+template <> struct message<MAVLINK_MSG_ID_HEARTBEAT> { enum { num_fields = 6, length = MAVLINK_MSG_ID_HEARTBEAT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // custom_mode
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 1> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // type
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 2> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // autopilot
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 3> { typedef uint8_t type; enum { wire_offset = 6, array_length = 0 }; }; // base_mode
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 4> { typedef uint8_t type; enum { wire_offset = 7, array_length = 0 }; }; // system_status
+template <> struct field<MAVLINK_MSG_ID_HEARTBEAT, 5> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // mavlink_version
+
+template <class Visitor>
+inline void visit_heartbeat(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HEARTBEAT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HEARTBEAT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HEARTBEAT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HEARTBEAT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HEARTBEAT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HEARTBEAT, 5>(msg));
+}
+
+/* SYS_STATUS */
+template <> struct message<MAVLINK_MSG_ID_SYS_STATUS> { enum { num_fields = 13, length = MAVLINK_MSG_ID_SYS_STATUS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // onboard_control_sensors_present
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 1> { typedef uint32_t type; enum { wire_offset = 4, array_length = 0 }; }; // onboard_control_sensors_enabled
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 2> { typedef uint32_t type; enum { wire_offset = 8, array_length = 0 }; }; // onboard_control_sensors_health
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 3> { typedef uint16_t type; enum { wire_offset = 12, array_length = 0 }; }; // load
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 4> { typedef uint16_t type; enum { wire_offset = 14, array_length = 0 }; }; // voltage_battery
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 5> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // current_battery
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 6> { typedef uint16_t type; enum { wire_offset = 18, array_length = 0 }; }; // drop_rate_comm
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 7> { typedef uint16_t type; enum { wire_offset = 20, array_length = 0 }; }; // errors_comm
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 8> { typedef uint16_t type; enum { wire_offset = 22, array_length = 0 }; }; // errors_count1
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 9> { typedef uint16_t type; enum { wire_offset = 24, array_length = 0 }; }; // errors_count2
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 10> { typedef uint16_t type; enum { wire_offset = 26, array_length = 0 }; }; // errors_count3
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 11> { typedef uint16_t type; enum { wire_offset = 28, array_length = 0 }; }; // errors_count4
+template <> struct field<MAVLINK_MSG_ID_SYS_STATUS, 12> { typedef int8_t type; enum { wire_offset = 30, array_length = 0 }; }; // battery_remaining
+
+template <class Visitor>
+inline void visit_sys_status(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SYS_STATUS, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SYS_STATUS, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SYS_STATUS, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SYS_STATUS, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SYS_STATUS, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SYS_STATUS, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SYS_STATUS, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SYS_STATUS, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SYS_STATUS, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SYS_STATUS, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_SYS_STATUS, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_SYS_STATUS, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_SYS_STATUS, 12>(msg));
+}
+
+/* SYSTEM_TIME */
+template <> struct message<MAVLINK_MSG_ID_SYSTEM_TIME> { enum { num_fields = 2, length = MAVLINK_MSG_ID_SYSTEM_TIME_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SYSTEM_TIME, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_unix_usec
+template <> struct field<MAVLINK_MSG_ID_SYSTEM_TIME, 1> { typedef uint32_t type; enum { wire_offset = 8, array_length = 0 }; }; // time_boot_ms
+
+template <class Visitor>
+inline void visit_system_time(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SYSTEM_TIME, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SYSTEM_TIME, 1>(msg));
+}
+
+/* PING */
+template <> struct message<MAVLINK_MSG_ID_PING> { enum { num_fields = 4, length = MAVLINK_MSG_ID_PING_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_PING, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_PING, 1> { typedef uint32_t type; enum { wire_offset = 8, array_length = 0 }; }; // seq
+template <> struct field<MAVLINK_MSG_ID_PING, 2> { typedef uint8_t type; enum { wire_offset = 12, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_PING, 3> { typedef uint8_t type; enum { wire_offset = 13, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_ping(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_PING, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_PING, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_PING, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_PING, 3>(msg));
+}
+
+/* CHANGE_OPERATOR_CONTROL */
+template <> struct message<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL> { enum { num_fields = 4, length = MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // control_request
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // version
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 3> { typedef char type; enum { wire_offset = 3, array_length = 25 }; }; // passkey
+
+template <class Visitor>
+inline void visit_change_operator_control(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL, 2>(msg));
+	visitor.text(3, &_MAV_PAYLOAD(msg)[3], 25);
+}
+
+/* CHANGE_OPERATOR_CONTROL_ACK */
+template <> struct message<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK> { enum { num_fields = 3, length = MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // gcs_system_id
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // control_request
+template <> struct field<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // ack
+
+template <class Visitor>
+inline void visit_change_operator_control_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK, 2>(msg));
+}
+
+/* AUTH_KEY */
+template <> struct message<MAVLINK_MSG_ID_AUTH_KEY> { enum { num_fields = 1, length = MAVLINK_MSG_ID_AUTH_KEY_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_AUTH_KEY, 0> { typedef char type; enum { wire_offset = 0, array_length = 32 }; }; // key
+
+template <class Visitor>
+inline void visit_auth_key(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.text(0, &_MAV_PAYLOAD(msg)[0], 32);
+}
+
+/* SET_MODE */
+template <> struct message<MAVLINK_MSG_ID_SET_MODE> { enum { num_fields = 3, length = MAVLINK_MSG_ID_SET_MODE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_MODE, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // custom_mode
+template <> struct field<MAVLINK_MSG_ID_SET_MODE, 1> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_SET_MODE, 2> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // base_mode
+
+template <class Visitor>
+inline void visit_set_mode(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_MODE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_MODE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_MODE, 2>(msg));
+}
+
+/* PARAM_REQUEST_READ */
+template <> struct message<MAVLINK_MSG_ID_PARAM_REQUEST_READ> { enum { num_fields = 4, length = MAVLINK_MSG_ID_PARAM_REQUEST_READ_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 0 }; }; // param_index
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 3> { typedef char type; enum { wire_offset = 4, array_length = 16 }; }; // param_id
+
+template <class Visitor>
+inline void visit_param_request_read(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_PARAM_REQUEST_READ, 2>(msg));
+	visitor.text(3, &_MAV_PAYLOAD(msg)[4], 16);
+}
+
+/* PARAM_REQUEST_LIST */
+template <> struct message<MAVLINK_MSG_ID_PARAM_REQUEST_LIST> { enum { num_fields = 2, length = MAVLINK_MSG_ID_PARAM_REQUEST_LIST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_LIST, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_PARAM_REQUEST_LIST, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_param_request_list(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_PARAM_REQUEST_LIST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_PARAM_REQUEST_LIST, 1>(msg));
+}
+
+/* PARAM_VALUE */
+template <> struct message<MAVLINK_MSG_ID_PARAM_VALUE> { enum { num_fields = 5, length = MAVLINK_MSG_ID_PARAM_VALUE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_PARAM_VALUE, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // param_value
+template <> struct field<MAVLINK_MSG_ID_PARAM_VALUE, 1> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // param_count
+template <> struct field<MAVLINK_MSG_ID_PARAM_VALUE, 2> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // param_index
+template <> struct field<MAVLINK_MSG_ID_PARAM_VALUE, 3> { typedef char type; enum { wire_offset = 8, array_length = 16 }; }; // param_id
+template <> struct field<MAVLINK_MSG_ID_PARAM_VALUE, 4> { typedef uint8_t type; enum { wire_offset = 24, array_length = 0 }; }; // param_type
+
+template <class Visitor>
+inline void visit_param_value(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_PARAM_VALUE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_PARAM_VALUE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_PARAM_VALUE, 2>(msg));
+	visitor.text(3, &_MAV_PAYLOAD(msg)[8], 16);
+	visitor.value(4, get<MAVLINK_MSG_ID_PARAM_VALUE, 4>(msg));
+}
+
+/* PARAM_SET */
+template <> struct message<MAVLINK_MSG_ID_PARAM_SET> { enum { num_fields = 5, length = MAVLINK_MSG_ID_PARAM_SET_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_PARAM_SET, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // param_value
+template <> struct field<MAVLINK_MSG_ID_PARAM_SET, 1> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_PARAM_SET, 2> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_PARAM_SET, 3> { typedef char type; enum { wire_offset = 6, array_length = 16 }; }; // param_id
+template <> struct field<MAVLINK_MSG_ID_PARAM_SET, 4> { typedef uint8_t type; enum { wire_offset = 22, array_length = 0 }; }; // param_type
+
+template <class Visitor>
+inline void visit_param_set(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_PARAM_SET, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_PARAM_SET, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_PARAM_SET, 2>(msg));
+	visitor.text(3, &_MAV_PAYLOAD(msg)[6], 16);
+	visitor.value(4, get<MAVLINK_MSG_ID_PARAM_SET, 4>(msg));
+}
+
+/* GPS_RAW_INT */
+template <> struct message<MAVLINK_MSG_ID_GPS_RAW_INT> { enum { num_fields = 10, length = MAVLINK_MSG_ID_GPS_RAW_INT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 1> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // lat
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 2> { typedef int32_t type; enum { wire_offset = 12, array_length = 0 }; }; // lon
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 3> { typedef int32_t type; enum { wire_offset = 16, array_length = 0 }; }; // alt
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 4> { typedef uint16_t type; enum { wire_offset = 20, array_length = 0 }; }; // eph
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 5> { typedef uint16_t type; enum { wire_offset = 22, array_length = 0 }; }; // epv
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 6> { typedef uint16_t type; enum { wire_offset = 24, array_length = 0 }; }; // vel
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 7> { typedef uint16_t type; enum { wire_offset = 26, array_length = 0 }; }; // cog
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 8> { typedef uint8_t type; enum { wire_offset = 28, array_length = 0 }; }; // fix_type
+template <> struct field<MAVLINK_MSG_ID_GPS_RAW_INT, 9> { typedef uint8_t type; enum { wire_offset = 29, array_length = 0 }; }; // satellites_visible
+
+template <class Visitor>
+inline void visit_gps_raw_int(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GPS_RAW_INT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_GPS_RAW_INT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_GPS_RAW_INT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_GPS_RAW_INT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_GPS_RAW_INT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_GPS_RAW_INT, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_GPS_RAW_INT, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_GPS_RAW_INT, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_GPS_RAW_INT, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_GPS_RAW_INT, 9>(msg));
+}
+
+/* GPS_STATUS */
+template <> struct message<MAVLINK_MSG_ID_GPS_STATUS> { enum { num_fields = 6, length = MAVLINK_MSG_ID_GPS_STATUS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // satellites_visible
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 20 }; }; // satellite_prn
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 2> { typedef uint8_t type; enum { wire_offset = 21, array_length = 20 }; }; // satellite_used
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 3> { typedef uint8_t type; enum { wire_offset = 41, array_length = 20 }; }; // satellite_elevation
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 4> { typedef uint8_t type; enum { wire_offset = 61, array_length = 20 }; }; // satellite_azimuth
+template <> struct field<MAVLINK_MSG_ID_GPS_STATUS, 5> { typedef uint8_t type; enum { wire_offset = 81, array_length = 20 }; }; // satellite_snr
+
+template <class Visitor>
+inline void visit_gps_status(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GPS_STATUS, 0>(msg));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(1, i, get<MAVLINK_MSG_ID_GPS_STATUS, 1>(msg, i));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(2, i, get<MAVLINK_MSG_ID_GPS_STATUS, 2>(msg, i));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(3, i, get<MAVLINK_MSG_ID_GPS_STATUS, 3>(msg, i));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(4, i, get<MAVLINK_MSG_ID_GPS_STATUS, 4>(msg, i));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(5, i, get<MAVLINK_MSG_ID_GPS_STATUS, 5>(msg, i));
+}
+
+/* SCALED_IMU */
+template <> struct message<MAVLINK_MSG_ID_SCALED_IMU> { enum { num_fields = 10, length = MAVLINK_MSG_ID_SCALED_IMU_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 1> { typedef int16_t type; enum { wire_offset = 4, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 2> { typedef int16_t type; enum { wire_offset = 6, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 3> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // zacc
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 4> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // xgyro
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 5> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // ygyro
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 6> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // zgyro
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 7> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // xmag
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 8> { typedef int16_t type; enum { wire_offset = 18, array_length = 0 }; }; // ymag
+template <> struct field<MAVLINK_MSG_ID_SCALED_IMU, 9> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // zmag
+
+template <class Visitor>
+inline void visit_scaled_imu(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SCALED_IMU, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SCALED_IMU, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SCALED_IMU, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SCALED_IMU, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SCALED_IMU, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SCALED_IMU, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SCALED_IMU, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SCALED_IMU, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SCALED_IMU, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SCALED_IMU, 9>(msg));
+}
+
+/* RAW_IMU */
+template <> struct message<MAVLINK_MSG_ID_RAW_IMU> { enum { num_fields = 10, length = MAVLINK_MSG_ID_RAW_IMU_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 1> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 2> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // zacc
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 4> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // xgyro
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 5> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // ygyro
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 6> { typedef int16_t type; enum { wire_offset = 18, array_length = 0 }; }; // zgyro
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 7> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // xmag
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 8> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // ymag
+template <> struct field<MAVLINK_MSG_ID_RAW_IMU, 9> { typedef int16_t type; enum { wire_offset = 24, array_length = 0 }; }; // zmag
+
+template <class Visitor>
+inline void visit_raw_imu(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RAW_IMU, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RAW_IMU, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RAW_IMU, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RAW_IMU, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RAW_IMU, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_RAW_IMU, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_RAW_IMU, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_RAW_IMU, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_RAW_IMU, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_RAW_IMU, 9>(msg));
+}
+
+/* RAW_PRESSURE */
+template <> struct message<MAVLINK_MSG_ID_RAW_PRESSURE> { enum { num_fields = 5, length = MAVLINK_MSG_ID_RAW_PRESSURE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RAW_PRESSURE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_RAW_PRESSURE, 1> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // press_abs
+template <> struct field<MAVLINK_MSG_ID_RAW_PRESSURE, 2> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // press_diff1
+template <> struct field<MAVLINK_MSG_ID_RAW_PRESSURE, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // press_diff2
+template <> struct field<MAVLINK_MSG_ID_RAW_PRESSURE, 4> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // temperature
+
+template <class Visitor>
+inline void visit_raw_pressure(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RAW_PRESSURE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RAW_PRESSURE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RAW_PRESSURE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RAW_PRESSURE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RAW_PRESSURE, 4>(msg));
+}
+
+/* SCALED_PRESSURE */
+template <> struct message<MAVLINK_MSG_ID_SCALED_PRESSURE> { enum { num_fields = 4, length = MAVLINK_MSG_ID_SCALED_PRESSURE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SCALED_PRESSURE, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_SCALED_PRESSURE, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // press_abs
+template <> struct field<MAVLINK_MSG_ID_SCALED_PRESSURE, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // press_diff
+template <> struct field<MAVLINK_MSG_ID_SCALED_PRESSURE, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // temperature
+
+template <class Visitor>
+inline void visit_scaled_pressure(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SCALED_PRESSURE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SCALED_PRESSURE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SCALED_PRESSURE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SCALED_PRESSURE, 3>(msg));
+}
+
+/* ATTITUDE */
+template <> struct message<MAVLINK_MSG_ID_ATTITUDE> { enum { num_fields = 7, length = MAVLINK_MSG_ID_ATTITUDE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // rollspeed
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // pitchspeed
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // yawspeed
+
+template <class Visitor>
+inline void visit_attitude(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ATTITUDE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ATTITUDE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ATTITUDE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ATTITUDE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ATTITUDE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_ATTITUDE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_ATTITUDE, 6>(msg));
+}
+
+/* ATTITUDE_QUATERNION */
+template <> struct message<MAVLINK_MSG_ID_ATTITUDE_QUATERNION> { enum { num_fields = 8, length = MAVLINK_MSG_ID_ATTITUDE_QUATERNION_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // q1
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // q2
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // q3
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // q4
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // rollspeed
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // pitchspeed
+template <> struct field<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 7> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // yawspeed
+
+template <class Visitor>
+inline void visit_attitude_quaternion(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_ATTITUDE_QUATERNION, 7>(msg));
+}
+
+/* LOCAL_POSITION_NED */
+template <> struct message<MAVLINK_MSG_ID_LOCAL_POSITION_NED> { enum { num_fields = 7, length = MAVLINK_MSG_ID_LOCAL_POSITION_NED_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // vx
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // vy
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // vz
+
+template <class Visitor>
+inline void visit_local_position_ned(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED, 6>(msg));
+}
+
+/* GLOBAL_POSITION_INT */
+template <> struct message<MAVLINK_MSG_ID_GLOBAL_POSITION_INT> { enum { num_fields = 9, length = MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // lat
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // lon
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 3> { typedef int32_t type; enum { wire_offset = 12, array_length = 0 }; }; // alt
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 4> { typedef int32_t type; enum { wire_offset = 16, array_length = 0 }; }; // relative_alt
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 5> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // vx
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 6> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // vy
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 7> { typedef int16_t type; enum { wire_offset = 24, array_length = 0 }; }; // vz
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 8> { typedef uint16_t type; enum { wire_offset = 26, array_length = 0 }; }; // hdg
+
+template <class Visitor>
+inline void visit_global_position_int(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 8>(msg));
+}
+
+/* RC_CHANNELS_SCALED */
+template <> struct message<MAVLINK_MSG_ID_RC_CHANNELS_SCALED> { enum { num_fields = 11, length = MAVLINK_MSG_ID_RC_CHANNELS_SCALED_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 1> { typedef int16_t type; enum { wire_offset = 4, array_length = 0 }; }; // chan1_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 2> { typedef int16_t type; enum { wire_offset = 6, array_length = 0 }; }; // chan2_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 3> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // chan3_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 4> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // chan4_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 5> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // chan5_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 6> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // chan6_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 7> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // chan7_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 8> { typedef int16_t type; enum { wire_offset = 18, array_length = 0 }; }; // chan8_scaled
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 9> { typedef uint8_t type; enum { wire_offset = 20, array_length = 0 }; }; // port
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 10> { typedef uint8_t type; enum { wire_offset = 21, array_length = 0 }; }; // rssi
+
+template <class Visitor>
+inline void visit_rc_channels_scaled(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_RC_CHANNELS_SCALED, 10>(msg));
+}
+
+/* RC_CHANNELS_RAW */
+template <> struct message<MAVLINK_MSG_ID_RC_CHANNELS_RAW> { enum { num_fields = 11, length = MAVLINK_MSG_ID_RC_CHANNELS_RAW_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 1> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // chan1_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 2> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // chan2_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 3> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // chan3_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 4> { typedef uint16_t type; enum { wire_offset = 10, array_length = 0 }; }; // chan4_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 5> { typedef uint16_t type; enum { wire_offset = 12, array_length = 0 }; }; // chan5_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 6> { typedef uint16_t type; enum { wire_offset = 14, array_length = 0 }; }; // chan6_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 7> { typedef uint16_t type; enum { wire_offset = 16, array_length = 0 }; }; // chan7_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 8> { typedef uint16_t type; enum { wire_offset = 18, array_length = 0 }; }; // chan8_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 9> { typedef uint8_t type; enum { wire_offset = 20, array_length = 0 }; }; // port
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 10> { typedef uint8_t type; enum { wire_offset = 21, array_length = 0 }; }; // rssi
+
+template <class Visitor>
+inline void visit_rc_channels_raw(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_RC_CHANNELS_RAW, 10>(msg));
+}
+
+/* SERVO_OUTPUT_RAW */
+template <> struct message<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW> { enum { num_fields = 10, length = MAVLINK_MSG_ID_SERVO_OUTPUT_RAW_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 1> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // servo1_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 2> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // servo2_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 3> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // servo3_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 4> { typedef uint16_t type; enum { wire_offset = 10, array_length = 0 }; }; // servo4_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 5> { typedef uint16_t type; enum { wire_offset = 12, array_length = 0 }; }; // servo5_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 6> { typedef uint16_t type; enum { wire_offset = 14, array_length = 0 }; }; // servo6_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 7> { typedef uint16_t type; enum { wire_offset = 16, array_length = 0 }; }; // servo7_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 8> { typedef uint16_t type; enum { wire_offset = 18, array_length = 0 }; }; // servo8_raw
+template <> struct field<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 9> { typedef uint8_t type; enum { wire_offset = 20, array_length = 0 }; }; // port
+
+template <class Visitor>
+inline void visit_servo_output_raw(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 9>(msg));
+}
+
+/* MISSION_REQUEST_PARTIAL_LIST */
+template <> struct message<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST> { enum { num_fields = 4, length = MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 0 }; }; // start_index
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 1> { typedef int16_t type; enum { wire_offset = 2, array_length = 0 }; }; // end_index
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 2> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 3> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_request_partial_list(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST, 3>(msg));
+}
+
+/* MISSION_WRITE_PARTIAL_LIST */
+template <> struct message<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST> { enum { num_fields = 4, length = MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 0 }; }; // start_index
+template <> struct field<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 1> { typedef int16_t type; enum { wire_offset = 2, array_length = 0 }; }; // end_index
+template <> struct field<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 2> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 3> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_write_partial_list(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST, 3>(msg));
+}
+
+/* MISSION_ITEM */
+template <> struct message<MAVLINK_MSG_ID_MISSION_ITEM> { enum { num_fields = 14, length = MAVLINK_MSG_ID_MISSION_ITEM_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // param1
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // param2
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // param3
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // param4
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 7> { typedef uint16_t type; enum { wire_offset = 28, array_length = 0 }; }; // seq
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 8> { typedef uint16_t type; enum { wire_offset = 30, array_length = 0 }; }; // command
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 9> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 10> { typedef uint8_t type; enum { wire_offset = 33, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 11> { typedef uint8_t type; enum { wire_offset = 34, array_length = 0 }; }; // frame
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 12> { typedef uint8_t type; enum { wire_offset = 35, array_length = 0 }; }; // current
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM, 13> { typedef uint8_t type; enum { wire_offset = 36, array_length = 0 }; }; // autocontinue
+
+template <class Visitor>
+inline void visit_mission_item(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_ITEM, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_ITEM, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_ITEM, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_MISSION_ITEM, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_MISSION_ITEM, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_MISSION_ITEM, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_MISSION_ITEM, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_MISSION_ITEM, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_MISSION_ITEM, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_MISSION_ITEM, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_MISSION_ITEM, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_MISSION_ITEM, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_MISSION_ITEM, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_MISSION_ITEM, 13>(msg));
+}
+
+/* MISSION_REQUEST */
+template <> struct message<MAVLINK_MSG_ID_MISSION_REQUEST> { enum { num_fields = 3, length = MAVLINK_MSG_ID_MISSION_REQUEST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // seq
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_request(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_REQUEST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_REQUEST, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_REQUEST, 2>(msg));
+}
+
+/* MISSION_SET_CURRENT */
+template <> struct message<MAVLINK_MSG_ID_MISSION_SET_CURRENT> { enum { num_fields = 3, length = MAVLINK_MSG_ID_MISSION_SET_CURRENT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // seq
+template <> struct field<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_set_current(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_SET_CURRENT, 2>(msg));
+}
+
+/* MISSION_CURRENT */
+template <> struct message<MAVLINK_MSG_ID_MISSION_CURRENT> { enum { num_fields = 1, length = MAVLINK_MSG_ID_MISSION_CURRENT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_CURRENT, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // seq
+
+template <class Visitor>
+inline void visit_mission_current(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_CURRENT, 0>(msg));
+}
+
+/* MISSION_REQUEST_LIST */
+template <> struct message<MAVLINK_MSG_ID_MISSION_REQUEST_LIST> { enum { num_fields = 2, length = MAVLINK_MSG_ID_MISSION_REQUEST_LIST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_LIST, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_REQUEST_LIST, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_request_list(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_REQUEST_LIST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_REQUEST_LIST, 1>(msg));
+}
+
+/* MISSION_COUNT */
+template <> struct message<MAVLINK_MSG_ID_MISSION_COUNT> { enum { num_fields = 3, length = MAVLINK_MSG_ID_MISSION_COUNT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_COUNT, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // count
+template <> struct field<MAVLINK_MSG_ID_MISSION_COUNT, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_COUNT, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_count(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_COUNT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_COUNT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_COUNT, 2>(msg));
+}
+
+/* MISSION_CLEAR_ALL */
+template <> struct message<MAVLINK_MSG_ID_MISSION_CLEAR_ALL> { enum { num_fields = 2, length = MAVLINK_MSG_ID_MISSION_CLEAR_ALL_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_CLEAR_ALL, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_CLEAR_ALL, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_mission_clear_all(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_CLEAR_ALL, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_CLEAR_ALL, 1>(msg));
+}
+
+/* MISSION_ITEM_REACHED */
+template <> struct message<MAVLINK_MSG_ID_MISSION_ITEM_REACHED> { enum { num_fields = 1, length = MAVLINK_MSG_ID_MISSION_ITEM_REACHED_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_ITEM_REACHED, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // seq
+
+template <class Visitor>
+inline void visit_mission_item_reached(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_ITEM_REACHED, 0>(msg));
+}
+
+/* MISSION_ACK */
+template <> struct message<MAVLINK_MSG_ID_MISSION_ACK> { enum { num_fields = 3, length = MAVLINK_MSG_ID_MISSION_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MISSION_ACK, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_MISSION_ACK, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_MISSION_ACK, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // type
+
+template <class Visitor>
+inline void visit_mission_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MISSION_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MISSION_ACK, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MISSION_ACK, 2>(msg));
+}
+
+/* SET_GPS_GLOBAL_ORIGIN */
+template <> struct message<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN> { enum { num_fields = 4, length = MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 0> { typedef int32_t type; enum { wire_offset = 0, array_length = 0 }; }; // latitude
+template <> struct field<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // longitude
+template <> struct field<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // altitude
+template <> struct field<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 3> { typedef uint8_t type; enum { wire_offset = 12, array_length = 0 }; }; // target_system
+
+template <class Visitor>
+inline void visit_set_gps_global_origin(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN, 3>(msg));
+}
+
+/* GPS_GLOBAL_ORIGIN */
+template <> struct message<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN> { enum { num_fields = 3, length = MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 0> { typedef int32_t type; enum { wire_offset = 0, array_length = 0 }; }; // latitude
+template <> struct field<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // longitude
+template <> struct field<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // altitude
+
+template <class Visitor>
+inline void visit_gps_global_origin(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN, 2>(msg));
+}
+
+/* SET_LOCAL_POSITION_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT> { enum { num_fields = 7, length = MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 4> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 5> { typedef uint8_t type; enum { wire_offset = 17, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 6> { typedef uint8_t type; enum { wire_offset = 18, array_length = 0 }; }; // coordinate_frame
+
+template <class Visitor>
+inline void visit_set_local_position_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT, 6>(msg));
+}
+
+/* LOCAL_POSITION_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 4> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // coordinate_frame
+
+template <class Visitor>
+inline void visit_local_position_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT, 4>(msg));
+}
+
+/* GLOBAL_POSITION_SETPOINT_INT */
+template <> struct message<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 0> { typedef int32_t type; enum { wire_offset = 0, array_length = 0 }; }; // latitude
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // longitude
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // altitude
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 4> { typedef uint8_t type; enum { wire_offset = 14, array_length = 0 }; }; // coordinate_frame
+
+template <class Visitor>
+inline void visit_global_position_setpoint_int(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT, 4>(msg));
+}
+
+/* SET_GLOBAL_POSITION_SETPOINT_INT */
+template <> struct message<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 0> { typedef int32_t type; enum { wire_offset = 0, array_length = 0 }; }; // latitude
+template <> struct field<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // longitude
+template <> struct field<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // altitude
+template <> struct field<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 4> { typedef uint8_t type; enum { wire_offset = 14, array_length = 0 }; }; // coordinate_frame
+
+template <class Visitor>
+inline void visit_set_global_position_setpoint_int(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT, 4>(msg));
+}
+
+/* SAFETY_SET_ALLOWED_AREA */
+template <> struct message<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA> { enum { num_fields = 9, length = MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // p1x
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // p1y
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // p1z
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // p2x
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // p2y
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // p2z
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 6> { typedef uint8_t type; enum { wire_offset = 24, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 7> { typedef uint8_t type; enum { wire_offset = 25, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 8> { typedef uint8_t type; enum { wire_offset = 26, array_length = 0 }; }; // frame
+
+template <class Visitor>
+inline void visit_safety_set_allowed_area(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA, 8>(msg));
+}
+
+/* SAFETY_ALLOWED_AREA */
+template <> struct message<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA> { enum { num_fields = 7, length = MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // p1x
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // p1y
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // p1z
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // p2x
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // p2y
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // p2z
+template <> struct field<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 6> { typedef uint8_t type; enum { wire_offset = 24, array_length = 0 }; }; // frame
+
+template <class Visitor>
+inline void visit_safety_allowed_area(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA, 6>(msg));
+}
+
+/* SET_ROLL_PITCH_YAW_THRUST */
+template <> struct message<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST> { enum { num_fields = 6, length = MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // thrust
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 4> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 5> { typedef uint8_t type; enum { wire_offset = 17, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_set_roll_pitch_yaw_thrust(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST, 5>(msg));
+}
+
+/* SET_ROLL_PITCH_YAW_SPEED_THRUST */
+template <> struct message<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST> { enum { num_fields = 6, length = MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // roll_speed
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // pitch_speed
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // yaw_speed
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // thrust
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 4> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 5> { typedef uint8_t type; enum { wire_offset = 17, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_set_roll_pitch_yaw_speed_thrust(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST, 5>(msg));
+}
+
+/* ROLL_PITCH_YAW_THRUST_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // thrust
+
+template <class Visitor>
+inline void visit_roll_pitch_yaw_thrust_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT, 4>(msg));
+}
+
+/* ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // roll_speed
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // pitch_speed
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw_speed
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // thrust
+
+template <class Visitor>
+inline void visit_roll_pitch_yaw_speed_thrust_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT, 4>(msg));
+}
+
+/* SET_QUAD_MOTORS_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // motor_front_nw
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // motor_right_ne
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 2> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // motor_back_se
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 3> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // motor_left_sw
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 4> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // target_system
+
+template <class Visitor>
+inline void visit_set_quad_motors_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT, 4>(msg));
+}
+
+/* SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST */
+template <> struct message<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST> { enum { num_fields = 6, length = MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 4 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 1> { typedef int16_t type; enum { wire_offset = 8, array_length = 4 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 2> { typedef int16_t type; enum { wire_offset = 16, array_length = 4 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 3> { typedef uint16_t type; enum { wire_offset = 24, array_length = 4 }; }; // thrust
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 4> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // group
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 5> { typedef uint8_t type; enum { wire_offset = 33, array_length = 0 }; }; // mode
+
+template <class Visitor>
+inline void visit_set_quad_swarm_roll_pitch_yaw_thrust(const mavlink_message_t* msg, Visitor& visitor)
+{
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(0, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 0>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(1, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 1>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(2, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 2>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(3, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 3>(msg, i));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST, 5>(msg));
+}
+
+/* NAV_CONTROLLER_OUTPUT */
+template <> struct message<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT> { enum { num_fields = 8, length = MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // nav_roll
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // nav_pitch
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // alt_error
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // aspd_error
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // xtrack_error
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 5> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // nav_bearing
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 6> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // target_bearing
+template <> struct field<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 7> { typedef uint16_t type; enum { wire_offset = 24, array_length = 0 }; }; // wp_dist
+
+template <class Visitor>
+inline void visit_nav_controller_output(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT, 7>(msg));
+}
+
+/* SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST */
+template <> struct message<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST> { enum { num_fields = 9, length = MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 4 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 1> { typedef int16_t type; enum { wire_offset = 8, array_length = 4 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 2> { typedef int16_t type; enum { wire_offset = 16, array_length = 4 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 3> { typedef uint16_t type; enum { wire_offset = 24, array_length = 4 }; }; // thrust
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 4> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // group
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 5> { typedef uint8_t type; enum { wire_offset = 33, array_length = 0 }; }; // mode
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 6> { typedef uint8_t type; enum { wire_offset = 34, array_length = 4 }; }; // led_red
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 7> { typedef uint8_t type; enum { wire_offset = 38, array_length = 4 }; }; // led_blue
+template <> struct field<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 8> { typedef uint8_t type; enum { wire_offset = 42, array_length = 4 }; }; // led_green
+
+template <class Visitor>
+inline void visit_set_quad_swarm_led_roll_pitch_yaw_thrust(const mavlink_message_t* msg, Visitor& visitor)
+{
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(0, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 0>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(1, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 1>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(2, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 2>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(3, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 3>(msg, i));
+	visitor.value(4, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 5>(msg));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(6, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 6>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(7, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 7>(msg, i));
+	for (uint8_t i = 0; i < 4; ++i) visitor.element(8, i, get<MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST, 8>(msg, i));
+}
+
+/* STATE_CORRECTION */
+template <> struct message<MAVLINK_MSG_ID_STATE_CORRECTION> { enum { num_fields = 9, length = MAVLINK_MSG_ID_STATE_CORRECTION_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // xErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // yErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // zErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // rollErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // pitchErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // yawErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // vxErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 7> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // vyErr
+template <> struct field<MAVLINK_MSG_ID_STATE_CORRECTION, 8> { typedef float type; enum { wire_offset = 32, array_length = 0 }; }; // vzErr
+
+template <class Visitor>
+inline void visit_state_correction(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_STATE_CORRECTION, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_STATE_CORRECTION, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_STATE_CORRECTION, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_STATE_CORRECTION, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_STATE_CORRECTION, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_STATE_CORRECTION, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_STATE_CORRECTION, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_STATE_CORRECTION, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_STATE_CORRECTION, 8>(msg));
+}
+
+/* REQUEST_DATA_STREAM */
+template <> struct message<MAVLINK_MSG_ID_REQUEST_DATA_STREAM> { enum { num_fields = 5, length = MAVLINK_MSG_ID_REQUEST_DATA_STREAM_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // req_message_rate
+template <> struct field<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 3> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // req_stream_id
+template <> struct field<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 4> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // start_stop
+
+template <class Visitor>
+inline void visit_request_data_stream(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_REQUEST_DATA_STREAM, 4>(msg));
+}
+
+/* DATA_STREAM */
+template <> struct message<MAVLINK_MSG_ID_DATA_STREAM> { enum { num_fields = 3, length = MAVLINK_MSG_ID_DATA_STREAM_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_DATA_STREAM, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // message_rate
+template <> struct field<MAVLINK_MSG_ID_DATA_STREAM, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // stream_id
+template <> struct field<MAVLINK_MSG_ID_DATA_STREAM, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // on_off
+
+template <class Visitor>
+inline void visit_data_stream(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_DATA_STREAM, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_DATA_STREAM, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_DATA_STREAM, 2>(msg));
+}
+
+/* MANUAL_CONTROL */
+template <> struct message<MAVLINK_MSG_ID_MANUAL_CONTROL> { enum { num_fields = 6, length = MAVLINK_MSG_ID_MANUAL_CONTROL_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 1> { typedef int16_t type; enum { wire_offset = 2, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 2> { typedef int16_t type; enum { wire_offset = 4, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 3> { typedef int16_t type; enum { wire_offset = 6, array_length = 0 }; }; // r
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 4> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // buttons
+template <> struct field<MAVLINK_MSG_ID_MANUAL_CONTROL, 5> { typedef uint8_t type; enum { wire_offset = 10, array_length = 0 }; }; // target
+
+template <class Visitor>
+inline void visit_manual_control(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_MANUAL_CONTROL, 5>(msg));
+}
+
+/* RC_CHANNELS_OVERRIDE */
+template <> struct message<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE> { enum { num_fields = 10, length = MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // chan1_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // chan2_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 2> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // chan3_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 3> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // chan4_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 4> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // chan5_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 5> { typedef uint16_t type; enum { wire_offset = 10, array_length = 0 }; }; // chan6_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 6> { typedef uint16_t type; enum { wire_offset = 12, array_length = 0 }; }; // chan7_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 7> { typedef uint16_t type; enum { wire_offset = 14, array_length = 0 }; }; // chan8_raw
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 8> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 9> { typedef uint8_t type; enum { wire_offset = 17, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_rc_channels_override(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE, 9>(msg));
+}
+
+/* VFR_HUD */
+template <> struct message<MAVLINK_MSG_ID_VFR_HUD> { enum { num_fields = 6, length = MAVLINK_MSG_ID_VFR_HUD_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // airspeed
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // groundspeed
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // alt
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // climb
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 4> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // heading
+template <> struct field<MAVLINK_MSG_ID_VFR_HUD, 5> { typedef uint16_t type; enum { wire_offset = 18, array_length = 0 }; }; // throttle
+
+template <class Visitor>
+inline void visit_vfr_hud(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_VFR_HUD, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_VFR_HUD, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_VFR_HUD, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_VFR_HUD, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_VFR_HUD, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_VFR_HUD, 5>(msg));
+}
+
+/* COMMAND_LONG */
+template <> struct message<MAVLINK_MSG_ID_COMMAND_LONG> { enum { num_fields = 11, length = MAVLINK_MSG_ID_COMMAND_LONG_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // param1
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // param2
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // param3
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // param4
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // param5
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // param6
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // param7
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 7> { typedef uint16_t type; enum { wire_offset = 28, array_length = 0 }; }; // command
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 8> { typedef uint8_t type; enum { wire_offset = 30, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 9> { typedef uint8_t type; enum { wire_offset = 31, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_COMMAND_LONG, 10> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // confirmation
+
+template <class Visitor>
+inline void visit_command_long(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_COMMAND_LONG, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_COMMAND_LONG, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_COMMAND_LONG, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_COMMAND_LONG, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_COMMAND_LONG, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_COMMAND_LONG, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_COMMAND_LONG, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_COMMAND_LONG, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_COMMAND_LONG, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_COMMAND_LONG, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_COMMAND_LONG, 10>(msg));
+}
+
+/* COMMAND_ACK */
+template <> struct message<MAVLINK_MSG_ID_COMMAND_ACK> { enum { num_fields = 2, length = MAVLINK_MSG_ID_COMMAND_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_COMMAND_ACK, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // command
+template <> struct field<MAVLINK_MSG_ID_COMMAND_ACK, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // result
+
+template <class Visitor>
+inline void visit_command_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_COMMAND_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_COMMAND_ACK, 1>(msg));
+}
+
+/* ROLL_PITCH_YAW_RATES_THRUST_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // roll_rate
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // pitch_rate
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw_rate
+template <> struct field<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // thrust
+
+template <class Visitor>
+inline void visit_roll_pitch_yaw_rates_thrust_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT, 4>(msg));
+}
+
+/* MANUAL_SETPOINT */
+template <> struct message<MAVLINK_MSG_ID_MANUAL_SETPOINT> { enum { num_fields = 7, length = MAVLINK_MSG_ID_MANUAL_SETPOINT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // thrust
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 5> { typedef uint8_t type; enum { wire_offset = 20, array_length = 0 }; }; // mode_switch
+template <> struct field<MAVLINK_MSG_ID_MANUAL_SETPOINT, 6> { typedef uint8_t type; enum { wire_offset = 21, array_length = 0 }; }; // manual_override_switch
+
+template <class Visitor>
+inline void visit_manual_setpoint(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_MANUAL_SETPOINT, 6>(msg));
+}
+
+/* LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET */
+template <> struct message<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET> { enum { num_fields = 7, length = MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // yaw
+
+template <class Visitor>
+inline void visit_local_position_ned_system_global_offset(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET, 6>(msg));
+}
+
+/* HIL_STATE */
+template <> struct message<MAVLINK_MSG_ID_HIL_STATE> { enum { num_fields = 16, length = MAVLINK_MSG_ID_HIL_STATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // rollspeed
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // pitchspeed
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // yawspeed
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 7> { typedef int32_t type; enum { wire_offset = 32, array_length = 0 }; }; // lat
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 8> { typedef int32_t type; enum { wire_offset = 36, array_length = 0 }; }; // lon
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 9> { typedef int32_t type; enum { wire_offset = 40, array_length = 0 }; }; // alt
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 10> { typedef int16_t type; enum { wire_offset = 44, array_length = 0 }; }; // vx
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 11> { typedef int16_t type; enum { wire_offset = 46, array_length = 0 }; }; // vy
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 12> { typedef int16_t type; enum { wire_offset = 48, array_length = 0 }; }; // vz
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 13> { typedef int16_t type; enum { wire_offset = 50, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 14> { typedef int16_t type; enum { wire_offset = 52, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_HIL_STATE, 15> { typedef int16_t type; enum { wire_offset = 54, array_length = 0 }; }; // zacc
+
+template <class Visitor>
+inline void visit_hil_state(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HIL_STATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HIL_STATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HIL_STATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HIL_STATE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HIL_STATE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HIL_STATE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_HIL_STATE, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_HIL_STATE, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_HIL_STATE, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_HIL_STATE, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_HIL_STATE, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_HIL_STATE, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_HIL_STATE, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_HIL_STATE, 13>(msg));
+	visitor.value(14, get<MAVLINK_MSG_ID_HIL_STATE, 14>(msg));
+	visitor.value(15, get<MAVLINK_MSG_ID_HIL_STATE, 15>(msg));
+}
+
+/* HIL_CONTROLS */
+template <> struct message<MAVLINK_MSG_ID_HIL_CONTROLS> { enum { num_fields = 11, length = MAVLINK_MSG_ID_HIL_CONTROLS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // roll_ailerons
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // pitch_elevator
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // yaw_rudder
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // throttle
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // aux1
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // aux2
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 7> { typedef float type; enum { wire_offset = 32, array_length = 0 }; }; // aux3
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 8> { typedef float type; enum { wire_offset = 36, array_length = 0 }; }; // aux4
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 9> { typedef uint8_t type; enum { wire_offset = 40, array_length = 0 }; }; // mode
+template <> struct field<MAVLINK_MSG_ID_HIL_CONTROLS, 10> { typedef uint8_t type; enum { wire_offset = 41, array_length = 0 }; }; // nav_mode
+
+template <class Visitor>
+inline void visit_hil_controls(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HIL_CONTROLS, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HIL_CONTROLS, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HIL_CONTROLS, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HIL_CONTROLS, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HIL_CONTROLS, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HIL_CONTROLS, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_HIL_CONTROLS, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_HIL_CONTROLS, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_HIL_CONTROLS, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_HIL_CONTROLS, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_HIL_CONTROLS, 10>(msg));
+}
+
+/* HIL_RC_INPUTS_RAW */
+template <> struct message<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW> { enum { num_fields = 14, length = MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 1> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // chan1_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 2> { typedef uint16_t type; enum { wire_offset = 10, array_length = 0 }; }; // chan2_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 3> { typedef uint16_t type; enum { wire_offset = 12, array_length = 0 }; }; // chan3_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 4> { typedef uint16_t type; enum { wire_offset = 14, array_length = 0 }; }; // chan4_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 5> { typedef uint16_t type; enum { wire_offset = 16, array_length = 0 }; }; // chan5_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 6> { typedef uint16_t type; enum { wire_offset = 18, array_length = 0 }; }; // chan6_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 7> { typedef uint16_t type; enum { wire_offset = 20, array_length = 0 }; }; // chan7_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 8> { typedef uint16_t type; enum { wire_offset = 22, array_length = 0 }; }; // chan8_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 9> { typedef uint16_t type; enum { wire_offset = 24, array_length = 0 }; }; // chan9_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 10> { typedef uint16_t type; enum { wire_offset = 26, array_length = 0 }; }; // chan10_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 11> { typedef uint16_t type; enum { wire_offset = 28, array_length = 0 }; }; // chan11_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 12> { typedef uint16_t type; enum { wire_offset = 30, array_length = 0 }; }; // chan12_raw
+template <> struct field<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 13> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // rssi
+
+template <class Visitor>
+inline void visit_hil_rc_inputs_raw(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW, 13>(msg));
+}
+
+/* OPTICAL_FLOW */
+template <> struct message<MAVLINK_MSG_ID_OPTICAL_FLOW> { enum { num_fields = 8, length = MAVLINK_MSG_ID_OPTICAL_FLOW_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // flow_comp_m_x
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // flow_comp_m_y
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // ground_distance
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 4> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // flow_x
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 5> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // flow_y
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 6> { typedef uint8_t type; enum { wire_offset = 24, array_length = 0 }; }; // sensor_id
+template <> struct field<MAVLINK_MSG_ID_OPTICAL_FLOW, 7> { typedef uint8_t type; enum { wire_offset = 25, array_length = 0 }; }; // quality
+
+template <class Visitor>
+inline void visit_optical_flow(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_OPTICAL_FLOW, 7>(msg));
+}
+
+/* GLOBAL_VISION_POSITION_ESTIMATE */
+template <> struct message<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE> { enum { num_fields = 7, length = MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // usec
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // yaw
+
+template <class Visitor>
+inline void visit_global_vision_position_estimate(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE, 6>(msg));
+}
+
+/* VISION_POSITION_ESTIMATE */
+template <> struct message<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE> { enum { num_fields = 7, length = MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // usec
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // yaw
+
+template <class Visitor>
+inline void visit_vision_position_estimate(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE, 6>(msg));
+}
+
+/* VISION_SPEED_ESTIMATE */
+template <> struct message<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE> { enum { num_fields = 4, length = MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // usec
+template <> struct field<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // z
+
+template <class Visitor>
+inline void visit_vision_speed_estimate(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE, 3>(msg));
+}
+
+/* VICON_POSITION_ESTIMATE */
+template <> struct message<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE> { enum { num_fields = 7, length = MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // usec
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // yaw
+
+template <class Visitor>
+inline void visit_vicon_position_estimate(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE, 6>(msg));
+}
+
+/* HIGHRES_IMU */
+template <> struct message<MAVLINK_MSG_ID_HIGHRES_IMU> { enum { num_fields = 15, length = MAVLINK_MSG_ID_HIGHRES_IMU_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // zacc
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 4> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // xgyro
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 5> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // ygyro
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // zgyro
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 7> { typedef float type; enum { wire_offset = 32, array_length = 0 }; }; // xmag
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 8> { typedef float type; enum { wire_offset = 36, array_length = 0 }; }; // ymag
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 9> { typedef float type; enum { wire_offset = 40, array_length = 0 }; }; // zmag
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 10> { typedef float type; enum { wire_offset = 44, array_length = 0 }; }; // abs_pressure
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 11> { typedef float type; enum { wire_offset = 48, array_length = 0 }; }; // diff_pressure
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 12> { typedef float type; enum { wire_offset = 52, array_length = 0 }; }; // pressure_alt
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 13> { typedef float type; enum { wire_offset = 56, array_length = 0 }; }; // temperature
+template <> struct field<MAVLINK_MSG_ID_HIGHRES_IMU, 14> { typedef uint16_t type; enum { wire_offset = 60, array_length = 0 }; }; // fields_updated
+
+template <class Visitor>
+inline void visit_highres_imu(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HIGHRES_IMU, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HIGHRES_IMU, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HIGHRES_IMU, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HIGHRES_IMU, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HIGHRES_IMU, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HIGHRES_IMU, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_HIGHRES_IMU, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_HIGHRES_IMU, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_HIGHRES_IMU, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_HIGHRES_IMU, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_HIGHRES_IMU, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_HIGHRES_IMU, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_HIGHRES_IMU, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_HIGHRES_IMU, 13>(msg));
+	visitor.value(14, get<MAVLINK_MSG_ID_HIGHRES_IMU, 14>(msg));
+}
+
+/* OMNIDIRECTIONAL_FLOW */
+template <> struct message<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW> { enum { num_fields = 6, length = MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // front_distance_m
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 2> { typedef int16_t type; enum { wire_offset = 12, array_length = 10 }; }; // left
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 3> { typedef int16_t type; enum { wire_offset = 32, array_length = 10 }; }; // right
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 4> { typedef uint8_t type; enum { wire_offset = 52, array_length = 0 }; }; // sensor_id
+template <> struct field<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 5> { typedef uint8_t type; enum { wire_offset = 53, array_length = 0 }; }; // quality
+
+template <class Visitor>
+inline void visit_omnidirectional_flow(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 1>(msg));
+	for (uint8_t i = 0; i < 10; ++i) visitor.element(2, i, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 2>(msg, i));
+	for (uint8_t i = 0; i < 10; ++i) visitor.element(3, i, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 3>(msg, i));
+	visitor.value(4, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW, 5>(msg));
+}
+
+/* HIL_SENSOR */
+template <> struct message<MAVLINK_MSG_ID_HIL_SENSOR> { enum { num_fields = 21, length = MAVLINK_MSG_ID_HIL_SENSOR_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 4> { typedef int32_t type; enum { wire_offset = 20, array_length = 0 }; }; // lat
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 5> { typedef int32_t type; enum { wire_offset = 24, array_length = 0 }; }; // lon
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 6> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 7> { typedef float type; enum { wire_offset = 32, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 8> { typedef float type; enum { wire_offset = 36, array_length = 0 }; }; // zacc
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 9> { typedef float type; enum { wire_offset = 40, array_length = 0 }; }; // xgyro
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 10> { typedef float type; enum { wire_offset = 44, array_length = 0 }; }; // ygyro
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 11> { typedef float type; enum { wire_offset = 48, array_length = 0 }; }; // zgyro
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 12> { typedef float type; enum { wire_offset = 52, array_length = 0 }; }; // xmag
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 13> { typedef float type; enum { wire_offset = 56, array_length = 0 }; }; // ymag
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 14> { typedef float type; enum { wire_offset = 60, array_length = 0 }; }; // zmag
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 15> { typedef float type; enum { wire_offset = 64, array_length = 0 }; }; // abs_pressure
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 16> { typedef float type; enum { wire_offset = 68, array_length = 0 }; }; // diff_pressure
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 17> { typedef float type; enum { wire_offset = 72, array_length = 0 }; }; // pressure_alt
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 18> { typedef float type; enum { wire_offset = 76, array_length = 0 }; }; // gps_alt
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 19> { typedef float type; enum { wire_offset = 80, array_length = 0 }; }; // temperature
+template <> struct field<MAVLINK_MSG_ID_HIL_SENSOR, 20> { typedef uint32_t type; enum { wire_offset = 84, array_length = 0 }; }; // fields_updated
+
+template <class Visitor>
+inline void visit_hil_sensor(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_HIL_SENSOR, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_HIL_SENSOR, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_HIL_SENSOR, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_HIL_SENSOR, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_HIL_SENSOR, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_HIL_SENSOR, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_HIL_SENSOR, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_HIL_SENSOR, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_HIL_SENSOR, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_HIL_SENSOR, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_HIL_SENSOR, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_HIL_SENSOR, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_HIL_SENSOR, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_HIL_SENSOR, 13>(msg));
+	visitor.value(14, get<MAVLINK_MSG_ID_HIL_SENSOR, 14>(msg));
+	visitor.value(15, get<MAVLINK_MSG_ID_HIL_SENSOR, 15>(msg));
+	visitor.value(16, get<MAVLINK_MSG_ID_HIL_SENSOR, 16>(msg));
+	visitor.value(17, get<MAVLINK_MSG_ID_HIL_SENSOR, 17>(msg));
+	visitor.value(18, get<MAVLINK_MSG_ID_HIL_SENSOR, 18>(msg));
+	visitor.value(19, get<MAVLINK_MSG_ID_HIL_SENSOR, 19>(msg));
+	visitor.value(20, get<MAVLINK_MSG_ID_HIL_SENSOR, 20>(msg));
+}
+
+/* SIM_STATE */
+template <> struct message<MAVLINK_MSG_ID_SIM_STATE> { enum { num_fields = 11, length = MAVLINK_MSG_ID_SIM_STATE_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // roll
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // pitch
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // yaw
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // xacc
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // yacc
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // zacc
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // xgyro
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 7> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // ygyro
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 8> { typedef float type; enum { wire_offset = 32, array_length = 0 }; }; // zgyro
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 9> { typedef float type; enum { wire_offset = 36, array_length = 0 }; }; // lat
+template <> struct field<MAVLINK_MSG_ID_SIM_STATE, 10> { typedef float type; enum { wire_offset = 40, array_length = 0 }; }; // lng
+
+template <class Visitor>
+inline void visit_sim_state(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SIM_STATE, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SIM_STATE, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SIM_STATE, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SIM_STATE, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SIM_STATE, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SIM_STATE, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SIM_STATE, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SIM_STATE, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SIM_STATE, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SIM_STATE, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_SIM_STATE, 10>(msg));
+}
+
+/* RADIO_STATUS */
+template <> struct message<MAVLINK_MSG_ID_RADIO_STATUS> { enum { num_fields = 7, length = MAVLINK_MSG_ID_RADIO_STATUS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // rxerrors
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // fixed
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 2> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // rssi
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 3> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // remrssi
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 4> { typedef uint8_t type; enum { wire_offset = 6, array_length = 0 }; }; // txbuf
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 5> { typedef uint8_t type; enum { wire_offset = 7, array_length = 0 }; }; // noise
+template <> struct field<MAVLINK_MSG_ID_RADIO_STATUS, 6> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // remnoise
+
+template <class Visitor>
+inline void visit_radio_status(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_RADIO_STATUS, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_RADIO_STATUS, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_RADIO_STATUS, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_RADIO_STATUS, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_RADIO_STATUS, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_RADIO_STATUS, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_RADIO_STATUS, 6>(msg));
+}
+
+/* FILE_TRANSFER_START */
+template <> struct message<MAVLINK_MSG_ID_FILE_TRANSFER_START> { enum { num_fields = 5, length = MAVLINK_MSG_ID_FILE_TRANSFER_START_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_START, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // transfer_uid
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_START, 1> { typedef uint32_t type; enum { wire_offset = 8, array_length = 0 }; }; // file_size
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_START, 2> { typedef char type; enum { wire_offset = 12, array_length = 240 }; }; // dest_path
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_START, 3> { typedef uint8_t type; enum { wire_offset = 252, array_length = 0 }; }; // direction
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_START, 4> { typedef uint8_t type; enum { wire_offset = 253, array_length = 0 }; }; // flags
+
+template <class Visitor>
+inline void visit_file_transfer_start(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FILE_TRANSFER_START, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FILE_TRANSFER_START, 1>(msg));
+	visitor.text(2, &_MAV_PAYLOAD(msg)[12], 240);
+	visitor.value(3, get<MAVLINK_MSG_ID_FILE_TRANSFER_START, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_FILE_TRANSFER_START, 4>(msg));
+}
+
+/* FILE_TRANSFER_DIR_LIST */
+template <> struct message<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST> { enum { num_fields = 3, length = MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // transfer_uid
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST, 1> { typedef char type; enum { wire_offset = 8, array_length = 240 }; }; // dir_path
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST, 2> { typedef uint8_t type; enum { wire_offset = 248, array_length = 0 }; }; // flags
+
+template <class Visitor>
+inline void visit_file_transfer_dir_list(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST, 0>(msg));
+	visitor.text(1, &_MAV_PAYLOAD(msg)[8], 240);
+	visitor.value(2, get<MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST, 2>(msg));
+}
+
+/* FILE_TRANSFER_RES */
+template <> struct message<MAVLINK_MSG_ID_FILE_TRANSFER_RES> { enum { num_fields = 2, length = MAVLINK_MSG_ID_FILE_TRANSFER_RES_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_RES, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // transfer_uid
+template <> struct field<MAVLINK_MSG_ID_FILE_TRANSFER_RES, 1> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // result
+
+template <class Visitor>
+inline void visit_file_transfer_res(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FILE_TRANSFER_RES, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FILE_TRANSFER_RES, 1>(msg));
+}
+
+/* BATTERY_STATUS */
+template <> struct message<MAVLINK_MSG_ID_BATTERY_STATUS> { enum { num_fields = 9, length = MAVLINK_MSG_ID_BATTERY_STATUS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // voltage_cell_1
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // voltage_cell_2
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 2> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // voltage_cell_3
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 3> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // voltage_cell_4
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 4> { typedef uint16_t type; enum { wire_offset = 8, array_length = 0 }; }; // voltage_cell_5
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 5> { typedef uint16_t type; enum { wire_offset = 10, array_length = 0 }; }; // voltage_cell_6
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 6> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // current_battery
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 7> { typedef uint8_t type; enum { wire_offset = 14, array_length = 0 }; }; // accu_id
+template <> struct field<MAVLINK_MSG_ID_BATTERY_STATUS, 8> { typedef int8_t type; enum { wire_offset = 15, array_length = 0 }; }; // battery_remaining
+
+template <class Visitor>
+inline void visit_battery_status(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_BATTERY_STATUS, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_BATTERY_STATUS, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_BATTERY_STATUS, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_BATTERY_STATUS, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_BATTERY_STATUS, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_BATTERY_STATUS, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_BATTERY_STATUS, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_BATTERY_STATUS, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_BATTERY_STATUS, 8>(msg));
+}
+
+/* SETPOINT_8DOF */
+template <> struct message<MAVLINK_MSG_ID_SETPOINT_8DOF> { enum { num_fields = 9, length = MAVLINK_MSG_ID_SETPOINT_8DOF_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // val1
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // val2
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // val3
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // val4
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // val5
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // val6
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // val7
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 7> { typedef float type; enum { wire_offset = 28, array_length = 0 }; }; // val8
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_8DOF, 8> { typedef uint8_t type; enum { wire_offset = 32, array_length = 0 }; }; // target_system
+
+template <class Visitor>
+inline void visit_setpoint_8dof(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SETPOINT_8DOF, 8>(msg));
+}
+
+/* SETPOINT_6DOF */
+template <> struct message<MAVLINK_MSG_ID_SETPOINT_6DOF> { enum { num_fields = 7, length = MAVLINK_MSG_ID_SETPOINT_6DOF_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // trans_x
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // trans_y
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // trans_z
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // rot_x
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // rot_y
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // rot_z
+template <> struct field<MAVLINK_MSG_ID_SETPOINT_6DOF, 6> { typedef uint8_t type; enum { wire_offset = 24, array_length = 0 }; }; // target_system
+
+template <class Visitor>
+inline void visit_setpoint_6dof(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SETPOINT_6DOF, 6>(msg));
+}
+
+/* FLEXIFUNCTION_SET */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_SET> { enum { num_fields = 2, length = MAVLINK_MSG_ID_FLEXIFUNCTION_SET_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_SET, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_SET, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_flexifunction_set(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_SET, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_SET, 1>(msg));
+}
+
+/* FLEXIFUNCTION_READ_REQ */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ> { enum { num_fields = 4, length = MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 0> { typedef int16_t type; enum { wire_offset = 0, array_length = 0 }; }; // read_req_type
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 1> { typedef int16_t type; enum { wire_offset = 2, array_length = 0 }; }; // data_index
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 2> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 3> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_flexifunction_read_req(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ, 3>(msg));
+}
+
+/* FLEXIFUNCTION_BUFFER_FUNCTION */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION> { enum { num_fields = 7, length = MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // func_index
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // func_count
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 2> { typedef uint16_t type; enum { wire_offset = 4, array_length = 0 }; }; // data_address
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 3> { typedef uint16_t type; enum { wire_offset = 6, array_length = 0 }; }; // data_size
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 4> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 5> { typedef uint8_t type; enum { wire_offset = 9, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 6> { typedef int8_t type; enum { wire_offset = 10, array_length = 48 }; }; // data
+
+template <class Visitor>
+inline void visit_flexifunction_buffer_function(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 5>(msg));
+	for (uint8_t i = 0; i < 48; ++i) visitor.element(6, i, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION, 6>(msg, i));
+}
+
+/* FLEXIFUNCTION_BUFFER_FUNCTION_ACK */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK> { enum { num_fields = 4, length = MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // func_index
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // result
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 2> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 3> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // target_component
+
+template <class Visitor>
+inline void visit_flexifunction_buffer_function_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK, 3>(msg));
+}
+
+/* FLEXIFUNCTION_DIRECTORY */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY> { enum { num_fields = 6, length = MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // directory_type
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 3> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // start_index
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 4> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // count
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 5> { typedef int8_t type; enum { wire_offset = 5, array_length = 48 }; }; // directory_data
+
+template <class Visitor>
+inline void visit_flexifunction_directory(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 4>(msg));
+	for (uint8_t i = 0; i < 48; ++i) visitor.element(5, i, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY, 5>(msg, i));
+}
+
+/* FLEXIFUNCTION_DIRECTORY_ACK */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK> { enum { num_fields = 6, length = MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // result
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 3> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // directory_type
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 4> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // start_index
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 5> { typedef uint8_t type; enum { wire_offset = 6, array_length = 0 }; }; // count
+
+template <class Visitor>
+inline void visit_flexifunction_directory_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK, 5>(msg));
+}
+
+/* FLEXIFUNCTION_COMMAND */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND> { enum { num_fields = 3, length = MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // target_system
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // target_component
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // command_type
+
+template <class Visitor>
+inline void visit_flexifunction_command(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND, 2>(msg));
+}
+
+/* FLEXIFUNCTION_COMMAND_ACK */
+template <> struct message<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK> { enum { num_fields = 2, length = MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // command_type
+template <> struct field<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK, 1> { typedef uint16_t type; enum { wire_offset = 2, array_length = 0 }; }; // result
+
+template <class Visitor>
+inline void visit_flexifunction_command_ack(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK, 1>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F2_A */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A> { enum { num_fields = 28, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // sue_time
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // sue_latitude
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // sue_longitude
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 3> { typedef int32_t type; enum { wire_offset = 12, array_length = 0 }; }; // sue_altitude
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 4> { typedef uint16_t type; enum { wire_offset = 16, array_length = 0 }; }; // sue_waypoint_index
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 5> { typedef int16_t type; enum { wire_offset = 18, array_length = 0 }; }; // sue_rmat0
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 6> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // sue_rmat1
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 7> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // sue_rmat2
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 8> { typedef int16_t type; enum { wire_offset = 24, array_length = 0 }; }; // sue_rmat3
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 9> { typedef int16_t type; enum { wire_offset = 26, array_length = 0 }; }; // sue_rmat4
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 10> { typedef int16_t type; enum { wire_offset = 28, array_length = 0 }; }; // sue_rmat5
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 11> { typedef int16_t type; enum { wire_offset = 30, array_length = 0 }; }; // sue_rmat6
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 12> { typedef int16_t type; enum { wire_offset = 32, array_length = 0 }; }; // sue_rmat7
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 13> { typedef int16_t type; enum { wire_offset = 34, array_length = 0 }; }; // sue_rmat8
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 14> { typedef uint16_t type; enum { wire_offset = 36, array_length = 0 }; }; // sue_cog
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 15> { typedef int16_t type; enum { wire_offset = 38, array_length = 0 }; }; // sue_sog
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 16> { typedef uint16_t type; enum { wire_offset = 40, array_length = 0 }; }; // sue_cpu_load
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 17> { typedef int16_t type; enum { wire_offset = 42, array_length = 0 }; }; // sue_voltage_milis
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 18> { typedef uint16_t type; enum { wire_offset = 44, array_length = 0 }; }; // sue_air_speed_3DIMU
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 19> { typedef int16_t type; enum { wire_offset = 46, array_length = 0 }; }; // sue_estimated_wind_0
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 20> { typedef int16_t type; enum { wire_offset = 48, array_length = 0 }; }; // sue_estimated_wind_1
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 21> { typedef int16_t type; enum { wire_offset = 50, array_length = 0 }; }; // sue_estimated_wind_2
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 22> { typedef int16_t type; enum { wire_offset = 52, array_length = 0 }; }; // sue_magFieldEarth0
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 23> { typedef int16_t type; enum { wire_offset = 54, array_length = 0 }; }; // sue_magFieldEarth1
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 24> { typedef int16_t type; enum { wire_offset = 56, array_length = 0 }; }; // sue_magFieldEarth2
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 25> { typedef int16_t type; enum { wire_offset = 58, array_length = 0 }; }; // sue_svs
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 26> { typedef int16_t type; enum { wire_offset = 60, array_length = 0 }; }; // sue_hdop
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 27> { typedef uint8_t type; enum { wire_offset = 62, array_length = 0 }; }; // sue_status
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f2_a(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 13>(msg));
+	visitor.value(14, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 14>(msg));
+	visitor.value(15, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 15>(msg));
+	visitor.value(16, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 16>(msg));
+	visitor.value(17, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 17>(msg));
+	visitor.value(18, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 18>(msg));
+	visitor.value(19, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 19>(msg));
+	visitor.value(20, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 20>(msg));
+	visitor.value(21, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 21>(msg));
+	visitor.value(22, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 22>(msg));
+	visitor.value(23, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 23>(msg));
+	visitor.value(24, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 24>(msg));
+	visitor.value(25, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 25>(msg));
+	visitor.value(26, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 26>(msg));
+	visitor.value(27, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A, 27>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F2_B */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B> { enum { num_fields = 33, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // sue_time
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 1> { typedef uint32_t type; enum { wire_offset = 4, array_length = 0 }; }; // sue_flags
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 2> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // sue_pwm_input_1
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 3> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // sue_pwm_input_2
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 4> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // sue_pwm_input_3
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 5> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // sue_pwm_input_4
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 6> { typedef int16_t type; enum { wire_offset = 16, array_length = 0 }; }; // sue_pwm_input_5
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 7> { typedef int16_t type; enum { wire_offset = 18, array_length = 0 }; }; // sue_pwm_input_6
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 8> { typedef int16_t type; enum { wire_offset = 20, array_length = 0 }; }; // sue_pwm_input_7
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 9> { typedef int16_t type; enum { wire_offset = 22, array_length = 0 }; }; // sue_pwm_input_8
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 10> { typedef int16_t type; enum { wire_offset = 24, array_length = 0 }; }; // sue_pwm_input_9
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 11> { typedef int16_t type; enum { wire_offset = 26, array_length = 0 }; }; // sue_pwm_input_10
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 12> { typedef int16_t type; enum { wire_offset = 28, array_length = 0 }; }; // sue_pwm_output_1
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 13> { typedef int16_t type; enum { wire_offset = 30, array_length = 0 }; }; // sue_pwm_output_2
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 14> { typedef int16_t type; enum { wire_offset = 32, array_length = 0 }; }; // sue_pwm_output_3
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 15> { typedef int16_t type; enum { wire_offset = 34, array_length = 0 }; }; // sue_pwm_output_4
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 16> { typedef int16_t type; enum { wire_offset = 36, array_length = 0 }; }; // sue_pwm_output_5
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 17> { typedef int16_t type; enum { wire_offset = 38, array_length = 0 }; }; // sue_pwm_output_6
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 18> { typedef int16_t type; enum { wire_offset = 40, array_length = 0 }; }; // sue_pwm_output_7
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 19> { typedef int16_t type; enum { wire_offset = 42, array_length = 0 }; }; // sue_pwm_output_8
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 20> { typedef int16_t type; enum { wire_offset = 44, array_length = 0 }; }; // sue_pwm_output_9
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 21> { typedef int16_t type; enum { wire_offset = 46, array_length = 0 }; }; // sue_pwm_output_10
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 22> { typedef int16_t type; enum { wire_offset = 48, array_length = 0 }; }; // sue_imu_location_x
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 23> { typedef int16_t type; enum { wire_offset = 50, array_length = 0 }; }; // sue_imu_location_y
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 24> { typedef int16_t type; enum { wire_offset = 52, array_length = 0 }; }; // sue_imu_location_z
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 25> { typedef int16_t type; enum { wire_offset = 54, array_length = 0 }; }; // sue_osc_fails
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 26> { typedef int16_t type; enum { wire_offset = 56, array_length = 0 }; }; // sue_imu_velocity_x
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 27> { typedef int16_t type; enum { wire_offset = 58, array_length = 0 }; }; // sue_imu_velocity_y
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 28> { typedef int16_t type; enum { wire_offset = 60, array_length = 0 }; }; // sue_imu_velocity_z
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 29> { typedef int16_t type; enum { wire_offset = 62, array_length = 0 }; }; // sue_waypoint_goal_x
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 30> { typedef int16_t type; enum { wire_offset = 64, array_length = 0 }; }; // sue_waypoint_goal_y
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 31> { typedef int16_t type; enum { wire_offset = 66, array_length = 0 }; }; // sue_waypoint_goal_z
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 32> { typedef int16_t type; enum { wire_offset = 68, array_length = 0 }; }; // sue_memory_stack_free
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f2_b(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 10>(msg));
+	visitor.value(11, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 11>(msg));
+	visitor.value(12, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 12>(msg));
+	visitor.value(13, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 13>(msg));
+	visitor.value(14, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 14>(msg));
+	visitor.value(15, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 15>(msg));
+	visitor.value(16, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 16>(msg));
+	visitor.value(17, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 17>(msg));
+	visitor.value(18, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 18>(msg));
+	visitor.value(19, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 19>(msg));
+	visitor.value(20, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 20>(msg));
+	visitor.value(21, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 21>(msg));
+	visitor.value(22, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 22>(msg));
+	visitor.value(23, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 23>(msg));
+	visitor.value(24, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 24>(msg));
+	visitor.value(25, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 25>(msg));
+	visitor.value(26, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 26>(msg));
+	visitor.value(27, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 27>(msg));
+	visitor.value(28, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 28>(msg));
+	visitor.value(29, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 29>(msg));
+	visitor.value(30, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 30>(msg));
+	visitor.value(31, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 31>(msg));
+	visitor.value(32, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B, 32>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F4 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4> { enum { num_fields = 10, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // sue_ROLL_STABILIZATION_AILERONS
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 1> { typedef uint8_t type; enum { wire_offset = 1, array_length = 0 }; }; // sue_ROLL_STABILIZATION_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 2> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // sue_PITCH_STABILIZATION
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 3> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // sue_YAW_STABILIZATION_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 4> { typedef uint8_t type; enum { wire_offset = 4, array_length = 0 }; }; // sue_YAW_STABILIZATION_AILERON
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 5> { typedef uint8_t type; enum { wire_offset = 5, array_length = 0 }; }; // sue_AILERON_NAVIGATION
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 6> { typedef uint8_t type; enum { wire_offset = 6, array_length = 0 }; }; // sue_RUDDER_NAVIGATION
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 7> { typedef uint8_t type; enum { wire_offset = 7, array_length = 0 }; }; // sue_ALTITUDEHOLD_STABILIZED
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 8> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // sue_ALTITUDEHOLD_WAYPOINT
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 9> { typedef uint8_t type; enum { wire_offset = 9, array_length = 0 }; }; // sue_RACING_MODE
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f4(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4, 9>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F5 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5> { enum { num_fields = 6, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // sue_YAWKP_AILERON
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // sue_YAWKD_AILERON
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // sue_ROLLKP
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // sue_ROLLKD
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // sue_YAW_STABILIZATION_AILERON
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // sue_AILERON_BOOST
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f5(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5, 5>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F6 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6> { enum { num_fields = 5, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // sue_PITCHGAIN
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // sue_PITCHKD
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // sue_RUDDER_ELEV_MIX
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // sue_ROLL_ELEV_MIX
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // sue_ELEVATOR_BOOST
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f6(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6, 4>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F7 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7> { enum { num_fields = 6, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // sue_YAWKP_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // sue_YAWKD_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // sue_ROLLKP_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // sue_ROLLKD_RUDDER
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // sue_RUDDER_BOOST
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // sue_RTL_PITCH_DOWN
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f7(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7, 5>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F8 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8> { enum { num_fields = 7, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 0> { typedef float type; enum { wire_offset = 0, array_length = 0 }; }; // sue_HEIGHT_TARGET_MAX
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // sue_HEIGHT_TARGET_MIN
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 2> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // sue_ALT_HOLD_THROTTLE_MIN
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 3> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // sue_ALT_HOLD_THROTTLE_MAX
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 4> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // sue_ALT_HOLD_PITCH_MIN
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 5> { typedef float type; enum { wire_offset = 20, array_length = 0 }; }; // sue_ALT_HOLD_PITCH_MAX
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 6> { typedef float type; enum { wire_offset = 24, array_length = 0 }; }; // sue_ALT_HOLD_PITCH_HIGH
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f8(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8, 6>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F13 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13> { enum { num_fields = 4, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 0> { typedef int32_t type; enum { wire_offset = 0, array_length = 0 }; }; // sue_lat_origin
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // sue_lon_origin
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // sue_alt_origin
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 3> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // sue_week_no
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f13(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13, 3>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F14 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14> { enum { num_fields = 11, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // sue_TRAP_SOURCE
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 1> { typedef int16_t type; enum { wire_offset = 4, array_length = 0 }; }; // sue_RCON
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 2> { typedef int16_t type; enum { wire_offset = 6, array_length = 0 }; }; // sue_TRAP_FLAGS
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 3> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // sue_osc_fail_count
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 4> { typedef uint8_t type; enum { wire_offset = 10, array_length = 0 }; }; // sue_WIND_ESTIMATION
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 5> { typedef uint8_t type; enum { wire_offset = 11, array_length = 0 }; }; // sue_GPS_TYPE
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 6> { typedef uint8_t type; enum { wire_offset = 12, array_length = 0 }; }; // sue_DR
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 7> { typedef uint8_t type; enum { wire_offset = 13, array_length = 0 }; }; // sue_BOARD_TYPE
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 8> { typedef uint8_t type; enum { wire_offset = 14, array_length = 0 }; }; // sue_AIRFRAME
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 9> { typedef uint8_t type; enum { wire_offset = 15, array_length = 0 }; }; // sue_CLOCK_CONFIG
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 10> { typedef uint8_t type; enum { wire_offset = 16, array_length = 0 }; }; // sue_FLIGHT_PLAN_TYPE
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f14(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 6>(msg));
+	visitor.value(7, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 7>(msg));
+	visitor.value(8, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 8>(msg));
+	visitor.value(9, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 9>(msg));
+	visitor.value(10, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14, 10>(msg));
+}
+
+/* SERIAL_UDB_EXTRA_F15 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15> { enum { num_fields = 2, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 40 }; }; // sue_ID_VEHICLE_MODEL_NAME
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15, 1> { typedef uint8_t type; enum { wire_offset = 40, array_length = 20 }; }; // sue_ID_VEHICLE_REGISTRATION
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f15(const mavlink_message_t* msg, Visitor& visitor)
+{
+	for (uint8_t i = 0; i < 40; ++i) visitor.element(0, i, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15, 0>(msg, i));
+	for (uint8_t i = 0; i < 20; ++i) visitor.element(1, i, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15, 1>(msg, i));
+}
+
+/* SERIAL_UDB_EXTRA_F16 */
+template <> struct message<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16> { enum { num_fields = 2, length = MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 40 }; }; // sue_ID_LEAD_PILOT
+template <> struct field<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16, 1> { typedef uint8_t type; enum { wire_offset = 40, array_length = 70 }; }; // sue_ID_DIY_DRONES_URL
+
+template <class Visitor>
+inline void visit_serial_udb_extra_f16(const mavlink_message_t* msg, Visitor& visitor)
+{
+	for (uint8_t i = 0; i < 40; ++i) visitor.element(0, i, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16, 0>(msg, i));
+	for (uint8_t i = 0; i < 70; ++i) visitor.element(1, i, get<MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16, 1>(msg, i));
+}
+
+/* ALTITUDES */
+template <> struct message<MAVLINK_MSG_ID_ALTITUDES> { enum { num_fields = 7, length = MAVLINK_MSG_ID_ALTITUDES_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // alt_gps
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 2> { typedef int32_t type; enum { wire_offset = 8, array_length = 0 }; }; // alt_imu
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 3> { typedef int32_t type; enum { wire_offset = 12, array_length = 0 }; }; // alt_barometric
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 4> { typedef int32_t type; enum { wire_offset = 16, array_length = 0 }; }; // alt_optical_flow
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 5> { typedef int32_t type; enum { wire_offset = 20, array_length = 0 }; }; // alt_range_finder
+template <> struct field<MAVLINK_MSG_ID_ALTITUDES, 6> { typedef int32_t type; enum { wire_offset = 24, array_length = 0 }; }; // alt_extra
+
+template <class Visitor>
+inline void visit_altitudes(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_ALTITUDES, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_ALTITUDES, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_ALTITUDES, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_ALTITUDES, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_ALTITUDES, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_ALTITUDES, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_ALTITUDES, 6>(msg));
+}
+
+/* AIRSPEEDS */
+template <> struct message<MAVLINK_MSG_ID_AIRSPEEDS> { enum { num_fields = 7, length = MAVLINK_MSG_ID_AIRSPEEDS_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 1> { typedef int16_t type; enum { wire_offset = 4, array_length = 0 }; }; // airspeed_imu
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 2> { typedef int16_t type; enum { wire_offset = 6, array_length = 0 }; }; // airspeed_pitot
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 3> { typedef int16_t type; enum { wire_offset = 8, array_length = 0 }; }; // airspeed_hot_wire
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 4> { typedef int16_t type; enum { wire_offset = 10, array_length = 0 }; }; // airspeed_ultrasonic
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 5> { typedef int16_t type; enum { wire_offset = 12, array_length = 0 }; }; // aoa
+template <> struct field<MAVLINK_MSG_ID_AIRSPEEDS, 6> { typedef int16_t type; enum { wire_offset = 14, array_length = 0 }; }; // aoy
+
+template <class Visitor>
+inline void visit_airspeeds(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_AIRSPEEDS, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_AIRSPEEDS, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_AIRSPEEDS, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_AIRSPEEDS, 3>(msg));
+	visitor.value(4, get<MAVLINK_MSG_ID_AIRSPEEDS, 4>(msg));
+	visitor.value(5, get<MAVLINK_MSG_ID_AIRSPEEDS, 5>(msg));
+	visitor.value(6, get<MAVLINK_MSG_ID_AIRSPEEDS, 6>(msg));
+}
+
+/* MEMORY_VECT */
+template <> struct message<MAVLINK_MSG_ID_MEMORY_VECT> { enum { num_fields = 4, length = MAVLINK_MSG_ID_MEMORY_VECT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_MEMORY_VECT, 0> { typedef uint16_t type; enum { wire_offset = 0, array_length = 0 }; }; // address
+template <> struct field<MAVLINK_MSG_ID_MEMORY_VECT, 1> { typedef uint8_t type; enum { wire_offset = 2, array_length = 0 }; }; // ver
+template <> struct field<MAVLINK_MSG_ID_MEMORY_VECT, 2> { typedef uint8_t type; enum { wire_offset = 3, array_length = 0 }; }; // type
+template <> struct field<MAVLINK_MSG_ID_MEMORY_VECT, 3> { typedef int8_t type; enum { wire_offset = 4, array_length = 32 }; }; // value
+
+template <class Visitor>
+inline void visit_memory_vect(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_MEMORY_VECT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_MEMORY_VECT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_MEMORY_VECT, 2>(msg));
+	for (uint8_t i = 0; i < 32; ++i) visitor.element(3, i, get<MAVLINK_MSG_ID_MEMORY_VECT, 3>(msg, i));
+}
+
+/* DEBUG_VECT */
+template <> struct message<MAVLINK_MSG_ID_DEBUG_VECT> { enum { num_fields = 5, length = MAVLINK_MSG_ID_DEBUG_VECT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_DEBUG_VECT, 0> { typedef uint64_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_usec
+template <> struct field<MAVLINK_MSG_ID_DEBUG_VECT, 1> { typedef float type; enum { wire_offset = 8, array_length = 0 }; }; // x
+template <> struct field<MAVLINK_MSG_ID_DEBUG_VECT, 2> { typedef float type; enum { wire_offset = 12, array_length = 0 }; }; // y
+template <> struct field<MAVLINK_MSG_ID_DEBUG_VECT, 3> { typedef float type; enum { wire_offset = 16, array_length = 0 }; }; // z
+template <> struct field<MAVLINK_MSG_ID_DEBUG_VECT, 4> { typedef char type; enum { wire_offset = 20, array_length = 10 }; }; // name
+
+template <class Visitor>
+inline void visit_debug_vect(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_DEBUG_VECT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_DEBUG_VECT, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_DEBUG_VECT, 2>(msg));
+	visitor.value(3, get<MAVLINK_MSG_ID_DEBUG_VECT, 3>(msg));
+	visitor.text(4, &_MAV_PAYLOAD(msg)[20], 10);
+}
+
+/* NAMED_VALUE_FLOAT */
+template <> struct message<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT> { enum { num_fields = 3, length = MAVLINK_MSG_ID_NAMED_VALUE_FLOAT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // value
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, 2> { typedef char type; enum { wire_offset = 8, array_length = 10 }; }; // name
+
+template <class Visitor>
+inline void visit_named_value_float(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_NAMED_VALUE_FLOAT, 1>(msg));
+	visitor.text(2, &_MAV_PAYLOAD(msg)[8], 10);
+}
+
+/* NAMED_VALUE_INT */
+template <> struct message<MAVLINK_MSG_ID_NAMED_VALUE_INT> { enum { num_fields = 3, length = MAVLINK_MSG_ID_NAMED_VALUE_INT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_INT, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_INT, 1> { typedef int32_t type; enum { wire_offset = 4, array_length = 0 }; }; // value
+template <> struct field<MAVLINK_MSG_ID_NAMED_VALUE_INT, 2> { typedef char type; enum { wire_offset = 8, array_length = 10 }; }; // name
+
+template <class Visitor>
+inline void visit_named_value_int(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_NAMED_VALUE_INT, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_NAMED_VALUE_INT, 1>(msg));
+	visitor.text(2, &_MAV_PAYLOAD(msg)[8], 10);
+}
+
+/* STATUSTEXT */
+template <> struct message<MAVLINK_MSG_ID_STATUSTEXT> { enum { num_fields = 2, length = MAVLINK_MSG_ID_STATUSTEXT_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_STATUSTEXT, 0> { typedef uint8_t type; enum { wire_offset = 0, array_length = 0 }; }; // severity
+template <> struct field<MAVLINK_MSG_ID_STATUSTEXT, 1> { typedef char type; enum { wire_offset = 1, array_length = 50 }; }; // text
+
+template <class Visitor>
+inline void visit_statustext(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_STATUSTEXT, 0>(msg));
+	visitor.text(1, &_MAV_PAYLOAD(msg)[1], 50);
+}
+
+/* DEBUG */
+template <> struct message<MAVLINK_MSG_ID_DEBUG> { enum { num_fields = 3, length = MAVLINK_MSG_ID_DEBUG_LEN }; };
+template <> struct field<MAVLINK_MSG_ID_DEBUG, 0> { typedef uint32_t type; enum { wire_offset = 0, array_length = 0 }; }; // time_boot_ms
+template <> struct field<MAVLINK_MSG_ID_DEBUG, 1> { typedef float type; enum { wire_offset = 4, array_length = 0 }; }; // value
+template <> struct field<MAVLINK_MSG_ID_DEBUG, 2> { typedef uint8_t type; enum { wire_offset = 8, array_length = 0 }; }; // ind
+
+template <class Visitor>
+inline void visit_debug(const mavlink_message_t* msg, Visitor& visitor)
+{
+	visitor.value(0, get<MAVLINK_MSG_ID_DEBUG, 0>(msg));
+	visitor.value(1, get<MAVLINK_MSG_ID_DEBUG, 1>(msg));
+	visitor.value(2, get<MAVLINK_MSG_ID_DEBUG, 2>(msg));
+}
+
+/** @brief Unpack all fields of a message, false if the message id is unknown */
+template <class Visitor>
+inline bool visit(const mavlink_message_t* msg, Visitor& visitor)
+{
+	switch (msg->msgid) {
+	case MAVLINK_MSG_ID_HEARTBEAT:
+		visit_heartbeat(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SYS_STATUS:
+		visit_sys_status(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SYSTEM_TIME:
+		visit_system_time(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_PING:
+		visit_ping(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL:
+		visit_change_operator_control(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_CHANGE_OPERATOR_CONTROL_ACK:
+		visit_change_operator_control_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_AUTH_KEY:
+		visit_auth_key(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_MODE:
+		visit_set_mode(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+		visit_param_request_read(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+		visit_param_request_list(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_PARAM_VALUE:
+		visit_param_value(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_PARAM_SET:
+		visit_param_set(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GPS_RAW_INT:
+		visit_gps_raw_int(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GPS_STATUS:
+		visit_gps_status(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SCALED_IMU:
+		visit_scaled_imu(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RAW_IMU:
+		visit_raw_imu(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RAW_PRESSURE:
+		visit_raw_pressure(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SCALED_PRESSURE:
+		visit_scaled_pressure(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ATTITUDE:
+		visit_attitude(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ATTITUDE_QUATERNION:
+		visit_attitude_quaternion(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+		visit_local_position_ned(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+		visit_global_position_int(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RC_CHANNELS_SCALED:
+		visit_rc_channels_scaled(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RC_CHANNELS_RAW:
+		visit_rc_channels_raw(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERVO_OUTPUT_RAW:
+		visit_servo_output_raw(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_REQUEST_PARTIAL_LIST:
+		visit_mission_request_partial_list(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_WRITE_PARTIAL_LIST:
+		visit_mission_write_partial_list(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_ITEM:
+		visit_mission_item(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_REQUEST:
+		visit_mission_request(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_SET_CURRENT:
+		visit_mission_set_current(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_CURRENT:
+		visit_mission_current(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+		visit_mission_request_list(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_COUNT:
+		visit_mission_count(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+		visit_mission_clear_all(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_ITEM_REACHED:
+		visit_mission_item_reached(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MISSION_ACK:
+		visit_mission_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_GPS_GLOBAL_ORIGIN:
+		visit_set_gps_global_origin(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GPS_GLOBAL_ORIGIN:
+		visit_gps_global_origin(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_LOCAL_POSITION_SETPOINT:
+		visit_set_local_position_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_LOCAL_POSITION_SETPOINT:
+		visit_local_position_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GLOBAL_POSITION_SETPOINT_INT:
+		visit_global_position_setpoint_int(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_GLOBAL_POSITION_SETPOINT_INT:
+		visit_set_global_position_setpoint_int(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SAFETY_SET_ALLOWED_AREA:
+		visit_safety_set_allowed_area(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SAFETY_ALLOWED_AREA:
+		visit_safety_allowed_area(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST:
+		visit_set_roll_pitch_yaw_thrust(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST:
+		visit_set_roll_pitch_yaw_speed_thrust(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ROLL_PITCH_YAW_THRUST_SETPOINT:
+		visit_roll_pitch_yaw_thrust_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ROLL_PITCH_YAW_SPEED_THRUST_SETPOINT:
+		visit_roll_pitch_yaw_speed_thrust_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_QUAD_MOTORS_SETPOINT:
+		visit_set_quad_motors_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_QUAD_SWARM_ROLL_PITCH_YAW_THRUST:
+		visit_set_quad_swarm_roll_pitch_yaw_thrust(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT:
+		visit_nav_controller_output(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SET_QUAD_SWARM_LED_ROLL_PITCH_YAW_THRUST:
+		visit_set_quad_swarm_led_roll_pitch_yaw_thrust(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_STATE_CORRECTION:
+		visit_state_correction(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_REQUEST_DATA_STREAM:
+		visit_request_data_stream(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_DATA_STREAM:
+		visit_data_stream(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MANUAL_CONTROL:
+		visit_manual_control(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+		visit_rc_channels_override(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_VFR_HUD:
+		visit_vfr_hud(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_COMMAND_LONG:
+		visit_command_long(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_COMMAND_ACK:
+		visit_command_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ROLL_PITCH_YAW_RATES_THRUST_SETPOINT:
+		visit_roll_pitch_yaw_rates_thrust_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MANUAL_SETPOINT:
+		visit_manual_setpoint(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_LOCAL_POSITION_NED_SYSTEM_GLOBAL_OFFSET:
+		visit_local_position_ned_system_global_offset(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_HIL_STATE:
+		visit_hil_state(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_HIL_CONTROLS:
+		visit_hil_controls(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW:
+		visit_hil_rc_inputs_raw(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_OPTICAL_FLOW:
+		visit_optical_flow(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_GLOBAL_VISION_POSITION_ESTIMATE:
+		visit_global_vision_position_estimate(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_VISION_POSITION_ESTIMATE:
+		visit_vision_position_estimate(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_VISION_SPEED_ESTIMATE:
+		visit_vision_speed_estimate(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_VICON_POSITION_ESTIMATE:
+		visit_vicon_position_estimate(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_HIGHRES_IMU:
+		visit_highres_imu(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_OMNIDIRECTIONAL_FLOW:
+		visit_omnidirectional_flow(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_HIL_SENSOR:
+		visit_hil_sensor(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SIM_STATE:
+		visit_sim_state(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_RADIO_STATUS:
+		visit_radio_status(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FILE_TRANSFER_START:
+		visit_file_transfer_start(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FILE_TRANSFER_DIR_LIST:
+		visit_file_transfer_dir_list(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FILE_TRANSFER_RES:
+		visit_file_transfer_res(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_BATTERY_STATUS:
+		visit_battery_status(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SETPOINT_8DOF:
+		visit_setpoint_8dof(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SETPOINT_6DOF:
+		visit_setpoint_6dof(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_SET:
+		visit_flexifunction_set(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_READ_REQ:
+		visit_flexifunction_read_req(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION:
+		visit_flexifunction_buffer_function(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_BUFFER_FUNCTION_ACK:
+		visit_flexifunction_buffer_function_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY:
+		visit_flexifunction_directory(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_DIRECTORY_ACK:
+		visit_flexifunction_directory_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND:
+		visit_flexifunction_command(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_FLEXIFUNCTION_COMMAND_ACK:
+		visit_flexifunction_command_ack(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_A:
+		visit_serial_udb_extra_f2_a(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F2_B:
+		visit_serial_udb_extra_f2_b(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F4:
+		visit_serial_udb_extra_f4(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F5:
+		visit_serial_udb_extra_f5(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F6:
+		visit_serial_udb_extra_f6(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F7:
+		visit_serial_udb_extra_f7(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F8:
+		visit_serial_udb_extra_f8(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F13:
+		visit_serial_udb_extra_f13(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F14:
+		visit_serial_udb_extra_f14(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F15:
+		visit_serial_udb_extra_f15(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_SERIAL_UDB_EXTRA_F16:
+		visit_serial_udb_extra_f16(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_ALTITUDES:
+		visit_altitudes(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_AIRSPEEDS:
+		visit_airspeeds(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_MEMORY_VECT:
+		visit_memory_vect(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_DEBUG_VECT:
+		visit_debug_vect(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_NAMED_VALUE_FLOAT:
+		visit_named_value_float(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_NAMED_VALUE_INT:
+		visit_named_value_int(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_STATUSTEXT:
+		visit_statustext(msg, visitor);
+		return true;
+	case MAVLINK_MSG_ID_DEBUG:
+		visit_debug(msg, visitor);
+		return true;
+	default:
+		return false;
+	}
+}
+
+} // namespace mavlink
+
+#endif // MAVLINK_MSG_VISITOR_HPP
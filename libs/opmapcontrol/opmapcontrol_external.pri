@@ -30,6 +30,8 @@ HEADERS += opmapcontrol.h \
            src/core/rawtile.h \
            src/core/size.h \
            src/core/tilecachequeue.h \
+           src/core/tilefetcher.h \
+           src/core/mbtilescache.h \
            src/core/urlfactory.h \
            src/internals/copyrightstrings.h \
            src/internals/core.h \
@@ -79,6 +81,8 @@ SOURCES += src/core/alllayersoftype.cpp \
            src/core/rawtile.cpp \
            src/core/size.cpp \
            src/core/tilecachequeue.cpp \
+           src/core/tilefetcher.cpp \
+           src/core/mbtilescache.cpp \
            src/core/urlfactory.cpp \
            src/internals/core.cpp \
            src/internals/loadtask.cpp \
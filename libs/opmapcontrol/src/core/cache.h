@@ -28,6 +28,7 @@
 #define CACHE_H
 
 #include "pureimagecache.h"
+#include "mbtilescache.h"
 #include "debugheader.h"
 
 namespace core {
@@ -38,6 +39,7 @@ namespace core {
 
 
         PureImageCache ImageCache;
+        MBTilesCache MBTiles;
         QString CacheLocation();
         void setCacheLocation(const QString& value);
         void CacheGeocoder(const QString &urlEnd,const QString &content);
@@ -0,0 +1,184 @@
+/**
+******************************************************************************
+*
+* @file       mbtilescache.cpp
+* @author     The APM_PLANNER Project, http://www.diydrones.com Copyright (C) 2013.
+* @brief      Read-only tile source backed by an MBTiles file
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "mbtilescache.h"
+#include <QFileInfo>
+#include <QVariant>
+#include <QDebug>
+#include <QtSql/QSqlError>
+//#define DEBUG_MBTILESCACHE
+namespace core {
+    QAtomicInt MBTilesCache::connectionCounter(0);
+
+    MBTilesCache::MBTilesCache():type(MapType::GoogleMap),open(false),generation(0)
+    {
+    }
+    MBTilesCache::~MBTilesCache()
+    {
+        Close();
+    }
+
+    MBTilesCache::Connection::~Connection()
+    {
+        delete query;
+        {
+            QSqlDatabase db=QSqlDatabase::database(name,false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+
+    bool MBTilesCache::Open(const QString &file,const MapType::Types &type)
+    {
+        Close();
+        if(!QFileInfo(file).exists())
+            return false;
+        bool ret=false;
+        QString name=QString("MBTilesOpen%1").arg(connectionCounter.fetchAndAddOrdered(1));
+        {
+            QSqlDatabase db=QSqlDatabase::addDatabase("QSQLITE",name);
+            db.setDatabaseName(file);
+            db.setConnectOptions("QSQLITE_OPEN_READONLY");
+            if(db.open())
+            {
+                QSqlQuery query(db);
+                // Both tables are required by the specification, tiles may be a view
+                ret=query.exec("SELECT name FROM sqlite_master WHERE name IN ('tiles','metadata')");
+                int tables=0;
+                while(ret && query.next())
+                    ++tables;
+                ret=(tables==2);
+#ifdef DEBUG_MBTILESCACHE
+                qDebug()<<"MBTilesCache: Open"<<file<<ret;
+#endif //DEBUG_MBTILESCACHE
+                query.clear();
+                db.close();
+            }
+        }
+        QSqlDatabase::removeDatabase(name);
+        if(!ret)
+            return false;
+        lock.lockForWrite();
+        this->file=file;
+        this->type=type;
+        ++generation;
+        open=true;
+        lock.unlock();
+        return true;
+    }
+    void MBTilesCache::Close()
+    {
+        lock.lockForWrite();
+        open=false;
+        file.clear();
+        // Connections of other threads are reopened or dropped when they exit
+        ++generation;
+        lock.unlock();
+        connections.setLocalData(0);
+    }
+    bool MBTilesCache::IsOpen()
+    {
+        QReadLocker locker(&lock);
+        return open;
+    }
+    bool MBTilesCache::Serves(const MapType::Types &type)
+    {
+        QReadLocker locker(&lock);
+        return open && this->type==type;
+    }
+    QString MBTilesCache::File()
+    {
+        QReadLocker locker(&lock);
+        return file;
+    }
+
+    MBTilesCache::Connection* MBTilesCache::ThreadConnection()
+    {
+        Connection* connection=connections.localData();
+        if(connection && connection->generation==generation)
+            return connection;
+        connection=new Connection(QString("MBTiles%1").arg(connectionCounter.fetchAndAddOrdered(1)),generation);
+        // Replaces and deletes the connection to the previous pack
+        connections.setLocalData(connection);
+        QSqlDatabase db=QSqlDatabase::addDatabase("QSQLITE",connection->name);
+        db.setDatabaseName(file);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        if(db.open())
+        {
+            QSqlQuery pragma(db);
+            pragma.exec(QString("PRAGMA mmap_size=%1").arg((qint64)MMAP_SIZE));
+            connection->query=new QSqlQuery(db);
+            connection->query->setForwardOnly(true);
+            connection->query->prepare("SELECT tile_data FROM tiles WHERE zoom_level=? AND tile_column=? AND tile_row=?");
+        }
+#ifdef DEBUG_MBTILESCACHE
+        else
+            qDebug()<<"MBTilesCache: "<<db.lastError().driverText();
+#endif //DEBUG_MBTILESCACHE
+        return connection;
+    }
+
+    QByteArray MBTilesCache::GetImageFromCache(const MapType::Types &type,const Point &pos,const int &zoom)
+    {
+        QByteArray ar;
+        QReadLocker locker(&lock);
+        if(!open || this->type!=type || zoom<0 || zoom>30)
+            return ar;
+        Connection* connection=ThreadConnection();
+        if(!connection->query)
+            return ar;
+        QSqlQuery* query=connection->query;
+        query->addBindValue(zoom);
+        query->addBindValue(pos.X());
+        // MBTiles numbers the rows from the south (TMS), the map from the north
+        query->addBindValue((1<<zoom)-1-pos.Y());
+        if(query->exec() && query->next())
+        {
+            ar=query->value(0).toByteArray();
+        }
+        query->finish();
+        return ar;
+    }
+
+    QHash<QString,QString> MBTilesCache::Metadata()
+    {
+        QHash<QString,QString> ret;
+        QReadLocker locker(&lock);
+        if(!open)
+            return ret;
+        Connection* connection=ThreadConnection();
+        if(!connection->query)
+            return ret;
+        QSqlQuery query(QSqlDatabase::database(connection->name,false));
+        query.exec("SELECT name, value FROM metadata");
+        while(query.next())
+        {
+            ret.insert(query.value(0).toString(),query.value(1).toString());
+        }
+        return ret;
+    }
+
+}
@@ -0,0 +1,103 @@
+/**
+******************************************************************************
+*
+* @file       mbtilescache.h
+* @author     The APM_PLANNER Project, http://www.diydrones.com Copyright (C) 2013.
+* @brief      Read-only tile source backed by an MBTiles file
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef MBTILESCACHE_H
+#define MBTILESCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QThreadStorage>
+#include <QAtomicInt>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include "maptype.h"
+#include "point.h"
+
+namespace core {
+    /**
+     * Serves tiles straight out of an MBTiles pack (http://mbtiles.org), a
+     * SQLite database of tiles prepared beforehand, without importing them
+     * into the tile cache first.
+     *
+     * The pack is opened read-only with SQLite memory mapping, so its pages
+     * are read from the mapped file instead of being copied through the
+     * page cache. Every thread keeps its own connection and prepared query.
+     */
+    class MBTilesCache
+    {
+    public:
+        enum { MMAP_SIZE=256*1024*1024 };
+
+        MBTilesCache();
+        ~MBTilesCache();
+
+        /// <summary>
+        /// Use the pack for the tiles of the map type, false if it is not an MBTiles file
+        /// </summary>
+        bool Open(const QString &file,const MapType::Types &type);
+        void Close();
+        bool IsOpen();
+        /// <summary>
+        /// True if the pack is open for the map type
+        /// </summary>
+        bool Serves(const MapType::Types &type);
+        QString File();
+        /// <summary>
+        /// Name and value pairs of the metadata table
+        /// </summary>
+        QHash<QString,QString> Metadata();
+
+        /// <summary>
+        /// Tile in XYZ numbering, empty if the pack does not have it
+        /// </summary>
+        QByteArray GetImageFromCache(const MapType::Types &type,const core::Point &pos,const int &zoom);
+
+    private:
+        struct Connection
+        {
+            Connection(const QString &name,int generation):name(name),generation(generation),query(0){}
+            ~Connection();
+            QString name;
+            int generation;
+            QSqlQuery* query;
+        };
+        /// <summary>
+        /// Connection of the calling thread, opened on first use, called with the lock held
+        /// </summary>
+        Connection* ThreadConnection();
+
+        QReadWriteLock lock;
+        QString file;
+        MapType::Types type;
+        bool open;
+        int generation;             ///< Counts Open() calls, older connections are reopened
+        QThreadStorage<Connection*> connections;
+        static QAtomicInt connectionCounter;
+    };
+
+}
+#endif // MBTILESCACHE_H
@@ -62,6 +62,14 @@ namespace core {
 
 
         QByteArray GetImageFrom(const MapType::Types &type,const core::Point &pos,const int &zoom);
+        /// <summary>
+        /// Tile from the memory or database cache, empty if it has to be downloaded
+        /// </summary>
+        QByteArray GetImageFromCache(const MapType::Types &type,const core::Point &pos,const int &zoom);
+        /// <summary>
+        /// Add a downloaded tile to the caches the access mode allows
+        /// </summary>
+        void StoreTile(const MapType::Types &type,const core::Point &pos,const int &zoom,const QByteArray &data);
         bool UseMemoryCache(){return useMemoryCache;}//TODO
         void setUseMemoryCache(const bool& value){useMemoryCache=value;}
         void setLanguage(const LanguageType::Types& language){Language=language;}//TODO
@@ -57,6 +57,20 @@ namespace core {
 #endif //DEBUG_PUREIMAGECACHE
                 CreateEmptyDB(db);
             }
+            else
+            {
+                // Caches created before the index was added
+                {
+                    QSqlDatabase cn=QSqlDatabase::addDatabase("QSQLITE",QLatin1String("IndexConn"));
+                    cn.setDatabaseName(db);
+                    if(cn.open())
+                    {
+                        CreateIndex(cn);
+                        cn.close();
+                    }
+                }
+                QSqlDatabase::removeDatabase(QLatin1String("IndexConn"));
+            }
         }
         lock.unlock();
     }
@@ -112,6 +126,8 @@ namespace core {
             db.close();
             return false;
         }
+        // Tiles are looked up by position, not by id
+        CreateIndex(db);
         query.exec("CREATE TABLE IF NOT EXISTS TilesData (id INTEGER NOT NULL PRIMARY KEY CONSTRAINT fk_Tiles_id REFERENCES Tiles(id) ON DELETE CASCADE, Tile BLOB NULL)");
         if(query.numRowsAffected()==-1)
         {
@@ -250,6 +266,64 @@ namespace core {
         lock.unlock();
         return ar;
     }
+    QSet<Point> PureImageCache::GetCachedTiles(const MapType::Types &type,const QList<Point> &tiles,const int &zoom)
+    {
+        QSet<Point> ret;
+        if(tiles.isEmpty())
+            return ret;
+        int minX=tiles.first().X(),maxX=minX,minY=tiles.first().Y(),maxY=minY;
+        foreach(const Point &p,tiles)
+        {
+            minX=qMin(minX,p.X());
+            maxX=qMax(maxX,p.X());
+            minY=qMin(minY,p.Y());
+            maxY=qMax(maxY,p.Y());
+        }
+        QSet<Point> wanted=tiles.toSet();
+        lock.lockForRead();
+        if(gtilecache.isEmpty()|gtilecache.isNull())
+        {
+            lock.unlock();
+            return ret;
+        }
+        Mcounter.lock();
+        qlonglong id=++ConnCounter;
+        Mcounter.unlock();
+        {
+            QSqlDatabase cn;
+            cn = QSqlDatabase::addDatabase("QSQLITE",QString::number(id));
+            cn.setDatabaseName(gtilecache+"Data.qmdb");
+            cn.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
+            if(cn.open())
+            {
+                {
+                    QSqlQuery query(cn);
+                    query.setForwardOnly(true);
+                    query.prepare("SELECT X, Y FROM Tiles WHERE Type=? AND Zoom=? AND X BETWEEN ? AND ? AND Y BETWEEN ? AND ?");
+                    query.addBindValue((int)type);
+                    query.addBindValue(zoom);
+                    query.addBindValue(minX);
+                    query.addBindValue(maxX);
+                    query.addBindValue(minY);
+                    query.addBindValue(maxY);
+                    query.exec();
+                    while(query.next())
+                    {
+                        Point p(query.value(0).toInt(),query.value(1).toInt());
+                        if(wanted.contains(p))
+                            ret.insert(p);
+                    }
+#ifdef DEBUG_PUREIMAGECACHE
+                    qDebug()<<"GetCachedTiles:"<<ret.count()<<"of"<<tiles.count()<<"cached";
+#endif //DEBUG_PUREIMAGECACHE
+                }
+                cn.close();
+            }
+        }
+        QSqlDatabase::removeDatabase(QString::number(id));
+        lock.unlock();
+        return ret;
+    }
     void PureImageCache::deleteOlderTiles(int const& days)
     {
         if(gtilecache.isEmpty()|gtilecache.isNull())
@@ -295,7 +369,8 @@ namespace core {
     bool PureImageCache::ExportMapDataToDB(QString sourceFile, QString destFile)
     {
         bool ret=true;
-        QList<long> add;
+        if(!QFileInfo(sourceFile).exists())
+            return false;
         if(!QFileInfo(destFile).exists())
         {
 #ifdef DEBUG_PUREIMAGECACHE
@@ -304,47 +379,62 @@ namespace core {
             ret=CreateEmptyDB(destFile);
         }
         if(!ret) return false;
-        QSqlDatabase ca = QSqlDatabase::addDatabase("QSQLITE","ca");
-        ca.setDatabaseName(sourceFile);
-
-        if(ca.open())
         {
             QSqlDatabase cb = QSqlDatabase::addDatabase("QSQLITE","cb");
             cb.setDatabaseName(destFile);
             if(cb.open())
             {
-                QSqlQuery queryb(cb);
-                queryb.exec(QString("ATTACH DATABASE \"%1\" AS Source").arg(sourceFile));
-                QSqlQuery querya(ca);
-                querya.exec("SELECT id, X, Y, Zoom, Type, Date FROM Tiles");
-                while(querya.next())
+                CreateIndex(cb);
+                QSqlQuery query(cb);
+                // Set based instead of a lookup and two inserts per tile: the tiles the
+                // destination is missing get new ids after its last one and are copied
+                // with one statement per table, in one transaction
+                ret=query.exec(QString("ATTACH DATABASE \"%1\" AS Source").arg(sourceFile));
+                if(ret)
                 {
-                    long id=querya.value(0).toLongLong();
-                    queryb.exec(QString("SELECT id FROM Tiles WHERE X=%1 AND Y=%2 AND Zoom=%3 AND Type=%4;").arg(querya.value(1).toLongLong()).arg(querya.value(2).toLongLong()).arg(querya.value(3).toLongLong()).arg(querya.value(4).toLongLong()));
-                    if(!queryb.next())
+                    ret=cb.transaction();
+                    if(ret)
+                        ret=query.exec("CREATE TEMP TABLE Import (id INTEGER NOT NULL PRIMARY KEY, Source INTEGER NOT NULL)");
+                    if(ret)
+                        ret=query.exec("INSERT INTO Import(Source) SELECT MIN(s.id) FROM Source.Tiles s "
+                                       "WHERE NOT EXISTS (SELECT 1 FROM main.Tiles t WHERE t.X=s.X AND t.Y=s.Y AND t.Zoom=s.Zoom AND t.Type=s.Type) "
+                                       "GROUP BY s.X, s.Y, s.Zoom, s.Type");
+                    qlonglong offset=0;
+                    if(ret)
                     {
-                        add.append(id);
+                        ret=query.exec("SELECT IFNULL(MAX(id), 0) FROM main.Tiles") && query.next();
+                        if(ret)
+                            offset=query.value(0).toLongLong();
                     }
-
-                }
-                long f;
-                foreach(f,add)
-                {
-                    queryb.exec(QString("INSERT INTO Tiles(X, Y, Zoom, Type, Date) SELECT X, Y, Zoom, Type, Date FROM Source.Tiles WHERE id=%1").arg(f));
-                    queryb.exec(QString("INSERT INTO TilesData(id, Tile) Values((SELECT last_insert_rowid()), (SELECT Tile FROM Source.TilesData WHERE id=%1))").arg(f));
+                    if(ret)
+                        ret=query.exec(QString("INSERT INTO main.Tiles(id, X, Y, Zoom, Type, Date) "
+                                               "SELECT i.id+%1, s.X, s.Y, s.Zoom, s.Type, s.Date FROM Import i JOIN Source.Tiles s ON s.id=i.Source").arg(offset));
+                    if(ret)
+                        ret=query.exec(QString("INSERT INTO main.TilesData(id, Tile) "
+                                               "SELECT i.id+%1, d.Tile FROM Import i JOIN Source.TilesData d ON d.id=i.Source").arg(offset));
+#ifdef DEBUG_PUREIMAGECACHE
+                    if(!ret)
+                        qDebug()<<"ExportMapDataToDB: "<<query.lastError().driverText();
+#endif //DEBUG_PUREIMAGECACHE
+                    query.exec("DROP TABLE IF EXISTS Import");
+                    if(ret)
+                        ret=cb.commit();
+                    else
+                        cb.rollback();
+                    query.exec("DETACH DATABASE Source");
                 }
-                add.clear();
-                ca.close();
+                query.clear();
                 cb.close();
-
             }
-            else return false;
+            else ret=false;
         }
-        else return false;
-        QSqlDatabase::removeDatabase("ca");
         QSqlDatabase::removeDatabase("cb");
-        return true;
-
+        return ret;
+    }
+    bool PureImageCache::CreateIndex(QSqlDatabase &db)
+    {
+        QSqlQuery query(db);
+        return query.exec("CREATE INDEX IF NOT EXISTS IndexOfTiles ON Tiles (X, Y, Zoom, Type)");
     }
 
 }
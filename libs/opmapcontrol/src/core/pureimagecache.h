@@ -40,6 +40,7 @@
 #include <QVariant>
 #include "pureimage.h"
 #include <QList>
+#include <QSet>
 #include <QMutex>
 #include <QReadWriteLock>
 namespace core {
@@ -51,11 +52,20 @@ namespace core {
         static bool CreateEmptyDB(const QString &file);
         bool PutImageToCache(const QByteArray &tile,const MapType::Types &type,const core::Point &pos, const int &zoom);
         QByteArray GetImageFromCache(MapType::Types type, core::Point pos, int zoom);
+        /// <summary>
+        /// The tiles of the list stored in the cache, looked up with one query
+        /// over their bounding box instead of one per tile
+        /// </summary>
+        QSet<core::Point> GetCachedTiles(const MapType::Types &type,const QList<core::Point> &tiles,const int &zoom);
         QString GtileCache();
         void setGtileCache(const QString &value);
+        /// <summary>
+        /// Copies the tiles of the source database the destination does not have yet
+        /// </summary>
         static bool ExportMapDataToDB(QString sourceFile, QString destFile);
         void deleteOlderTiles(int const& days);
     private:
+        static bool CreateIndex(QSqlDatabase &db);
         QString gtilecache;
         QMutex Mcounter;
         QReadWriteLock lock;
@@ -0,0 +1,568 @@
+/**
+******************************************************************************
+*
+* @file       tilefetcher.cpp
+* @author     The APM_PLANNER Project, http://www.diydrones.com Copyright (C) 2013.
+* @brief      Shared asynchronous tile downloader
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#include "tilefetcher.h"
+#include "opmaps.h"
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtNetwork/QNetworkReply>
+#include <QTimer>
+#include <QMutexLocker>
+
+//#define DEBUG_TILEFETCHER
+
+namespace core {
+    QAtomicPointer<TileFetcher> TileFetcher::m_pInstance;
+    QMutex TileFetcher::instanceMutex;
+
+    // Requests of other zoom levels and FetchAndWait() go after the viewport
+    static const qint64 OtherZoomPriority=Q_INT64_C(1)<<40;
+    static const qint64 BackgroundPriority=Q_INT64_C(1)<<50;
+
+    TileFetcher* TileFetcher::Instance()
+    {
+        // fetchAndAdd(0) is the atomic load of the Qt 4 and Qt 5 API
+        TileFetcher* fetcher=m_pInstance.fetchAndAddOrdered(0);
+        if(!fetcher)
+        {
+            QMutexLocker locker(&instanceMutex);
+            fetcher=m_pInstance.fetchAndAddOrdered(0);
+            if(!fetcher)
+            {
+                fetcher=new TileFetcher;
+                fetcher->SetTimeout(OPMaps::Instance()->Timeout);
+                fetcher->SetRetries(OPMaps::Instance()->RetryLoadTile);
+                // Published only when set up, the other threads see a ready fetcher
+                m_pInstance.fetchAndStoreOrdered(fetcher);
+            }
+        }
+        return fetcher;
+    }
+
+    TileFetcher::TileFetcher():network(0),timeoutTimer(0),dispatchScheduled(false),starting(0),timeout(5*1000),retries(2)
+    {
+        clock.start();
+        moveToThread(&thread);
+        // The network objects are created and deleted in the fetcher thread
+        connect(&thread,SIGNAL(finished()),this,SLOT(ThreadFinished()),Qt::DirectConnection);
+        thread.start();
+    }
+
+    TileFetcher::~TileFetcher()
+    {
+        thread.quit();
+        thread.wait();
+        mutex.lock();
+        foreach(Waiter* w,waiters)
+        {
+            w->done=true;
+        }
+        finished.wakeAll();
+        mutex.unlock();
+    }
+
+    void TileFetcher::Fetch(const void* owner,const MapType::Types &type,const Point &pos,const int &zoom)
+    {
+        QMutexLocker locker(&mutex);
+        Enqueue(owner,type,pos,zoom,false);
+    }
+
+    QByteArray TileFetcher::FetchAndWait(const MapType::Types &type,const Point &pos,const int &zoom)
+    {
+        QMutexLocker locker(&mutex);
+        Waiter waiter(RawTile(type,pos,zoom));
+        waiters.append(&waiter);
+        Enqueue(0,type,pos,zoom,true);
+        while(!waiter.done)
+        {
+            finished.wait(&mutex);
+        }
+        waiters.removeAll(&waiter);
+        return waiter.data;
+    }
+
+    void TileFetcher::Enqueue(const void* owner,const MapType::Types &type,const Point &pos,const int &zoom,bool wait)
+    {
+        RawTile key(type,pos,zoom);
+        Request* request=0;
+        if(pending.contains(key))
+        {
+            request=&pending[key];
+        }
+        else if(inFlightTiles.contains(key))
+        {
+            request=&inFlight[inFlightTiles.value(key)];
+            request->cancelled=false;
+        }
+
+        if(request)
+        {
+            ++stats.deduplicated;
+        }
+        else
+        {
+            request=&pending[key];
+            request->type=type;
+            request->pos=pos;
+            request->zoom=zoom;
+            ScheduleDispatch();
+        }
+        if(owner)
+        {
+            request->owners.insert(owner);
+        }
+        if(wait)
+        {
+            ++request->waiters;
+        }
+    }
+
+    void TileFetcher::SetViewport(const void* owner,const int &zoom,const Point &center,const QList<Point> &tiles)
+    {
+        QMutexLocker locker(&mutex);
+        Viewport& viewport=viewports[owner];
+        viewport.zoom=zoom;
+        viewport.center=center;
+        viewport.tiles=tiles.toSet();
+
+        QHash<RawTile,Request>::iterator i=pending.begin();
+        while(i!=pending.end())
+        {
+            Request& request=i.value();
+            if(request.owners.contains(owner) && (request.zoom!=zoom || !viewport.tiles.contains(request.pos)))
+            {
+                request.owners.remove(owner);
+                if(!IsWanted(request))
+                {
+                    ++stats.cancelled;
+                    i=pending.erase(i);
+                    continue;
+                }
+            }
+            ++i;
+        }
+        bool abort=false;
+        QHash<QNetworkReply*,Request>::iterator j;
+        for(j=inFlight.begin();j!=inFlight.end();++j)
+        {
+            Request& request=j.value();
+            if(request.owners.contains(owner) && (request.zoom!=zoom || !viewport.tiles.contains(request.pos)))
+            {
+                request.owners.remove(owner);
+                if(!IsWanted(request) && !request.cancelled)
+                {
+                    request.cancelled=true;
+                    abort=true;
+                }
+            }
+        }
+        if(abort)
+        {
+            ScheduleDispatch();
+        }
+    }
+
+    void TileFetcher::Cancel(const void* owner)
+    {
+        QMutexLocker locker(&mutex);
+        viewports.remove(owner);
+
+        QHash<RawTile,Request>::iterator i=pending.begin();
+        while(i!=pending.end())
+        {
+            i.value().owners.remove(owner);
+            if(!IsWanted(i.value()))
+            {
+                ++stats.cancelled;
+                i=pending.erase(i);
+                continue;
+            }
+            ++i;
+        }
+        bool abort=false;
+        QHash<QNetworkReply*,Request>::iterator j;
+        for(j=inFlight.begin();j!=inFlight.end();++j)
+        {
+            j.value().owners.remove(owner);
+            if(!IsWanted(j.value()) && !j.value().cancelled)
+            {
+                j.value().cancelled=true;
+                abort=true;
+            }
+        }
+        if(abort)
+        {
+            ScheduleDispatch();
+        }
+    }
+
+    int TileFetcher::Pending()
+    {
+        QMutexLocker locker(&mutex);
+        return pending.count()+inFlight.count();
+    }
+
+    TileFetcher::Statistics TileFetcher::GetStatistics()
+    {
+        QMutexLocker locker(&mutex);
+        return stats;
+    }
+
+    void TileFetcher::ScheduleDispatch()
+    {
+        if(!dispatchScheduled)
+        {
+            dispatchScheduled=true;
+            QMetaObject::invokeMethod(this,"Dispatch",Qt::QueuedConnection);
+        }
+    }
+
+    qint64 TileFetcher::Priority(const Request &request) const
+    {
+        qint64 best=BackgroundPriority;
+        foreach(const void* owner,request.owners)
+        {
+            QHash<const void*,Viewport>::const_iterator v=viewports.constFind(owner);
+            if(v==viewports.constEnd())
+            {
+                best=qMin(best,OtherZoomPriority);
+                continue;
+            }
+            qint64 dx=request.pos.X()-v.value().center.X();
+            qint64 dy=request.pos.Y()-v.value().center.Y();
+            qint64 priority=dx*dx+dy*dy;
+            if(request.zoom!=v.value().zoom)
+            {
+                priority+=OtherZoomPriority;
+            }
+            best=qMin(best,priority);
+        }
+        // Retried tiles wait behind the ones not tried yet
+        return best+request.attempts;
+    }
+
+    void TileFetcher::Dispatch()
+    {
+        if(!network)
+        {
+            network=new QNetworkAccessManager(this);
+            connect(network,SIGNAL(finished(QNetworkReply*)),this,SLOT(ReplyFinished(QNetworkReply*)));
+            timeoutTimer=new QTimer(this);
+            connect(timeoutTimer,SIGNAL(timeout()),this,SLOT(CheckTimeouts()));
+            timeoutTimer->start(TIMEOUT_CHECK_INTERVAL);
+        }
+        network->setProxy(GetProxy());
+
+        // Aborting emits finished() right away, which locks the mutex again
+        QList<QNetworkReply*> aborts;
+        mutex.lock();
+        dispatchScheduled=false;
+        QHash<QNetworkReply*,Request>::const_iterator i;
+        for(i=inFlight.constBegin();i!=inFlight.constEnd();++i)
+        {
+            if(i.value().cancelled)
+            {
+                aborts.append(i.key());
+            }
+        }
+        mutex.unlock();
+        foreach(QNetworkReply* reply,aborts)
+        {
+            reply->abort();
+        }
+
+        // The request is built without the lock, the URL factory may run an event loop
+        forever
+        {
+            mutex.lock();
+            QHash<RawTile,Request>::iterator best=pending.end();
+            qint64 bestPriority=0;
+            if(inFlight.count()+starting<MAX_IN_FLIGHT)
+            {
+                QHash<RawTile,Request>::iterator j;
+                for(j=pending.begin();j!=pending.end();++j)
+                {
+                    if(j.value().starting)
+                        continue;
+                    qint64 priority=Priority(j.value());
+                    if(best==pending.end() || priority<bestPriority)
+                    {
+                        best=j;
+                        bestPriority=priority;
+                    }
+                }
+            }
+            if(best==pending.end())
+            {
+                mutex.unlock();
+                break;
+            }
+            RawTile key=best.key();
+            Request request=best.value();
+            best.value().starting=true;
+            ++starting;
+            mutex.unlock();
+
+            QNetworkReply* reply=network->get(MakeRequest(request.type,request.pos,request.zoom));
+
+            mutex.lock();
+            --starting;
+            if(!pending.contains(key))
+            {
+                // Cancelled meanwhile
+                mutex.unlock();
+                reply->abort();
+                continue;
+            }
+            request=pending.take(key);
+            request.starting=false;
+            ++request.attempts;
+            request.startedMs=clock.elapsed();
+            inFlight.insert(reply,request);
+            inFlightTiles.insert(key,reply);
+            ++stats.requests;
+#ifdef DEBUG_TILEFETCHER
+            qDebug()<<"TileFetcher request"<<request.zoom<<request.pos.ToString()<<"priority"<<bestPriority;
+#endif //DEBUG_TILEFETCHER
+            mutex.unlock();
+        }
+    }
+
+    void TileFetcher::ReplyFinished(QNetworkReply* reply)
+    {
+        reply->deleteLater();
+        mutex.lock();
+        if(!inFlight.contains(reply))
+        {
+            mutex.unlock();
+            return;
+        }
+        Request request=inFlight.take(reply);
+        RawTile key(request.type,request.pos,request.zoom);
+        inFlightTiles.remove(key);
+
+        QByteArray data;
+        bool failed=false;
+        if(request.cancelled)
+        {
+            ++stats.cancelled;
+            mutex.unlock();
+            Dispatch();
+            return;
+        }
+        if(request.timedOut || reply->error()!=QNetworkReply::NoError)
+        {
+            if(request.timedOut)
+                ++stats.timeouts;
+            else
+                ++stats.networkerrors;
+            if(request.attempts<retries && IsWanted(request))
+            {
+                ++stats.retries;
+                request.timedOut=false;
+                pending.insert(key,request);
+            }
+            else
+            {
+                failed=true;
+            }
+        }
+        else
+        {
+            data=reply->readAll();
+            if(data.isEmpty())
+            {
+                ++stats.emptytiles;
+                failed=true;
+            }
+            else
+            {
+                ++stats.fetched;
+            }
+        }
+        mutex.unlock();
+
+        if(!data.isEmpty())
+        {
+            Store(request.type,request.pos,request.zoom,data);
+            emit TileFetched(request.type,request.pos.X(),request.pos.Y(),request.zoom,data);
+            Complete(request,data);
+        }
+        else if(failed)
+        {
+            emit TileFailed(request.type,request.pos.X(),request.pos.Y(),request.zoom);
+            Complete(request,data);
+        }
+        Dispatch();
+    }
+
+    void TileFetcher::Complete(const Request &request,const QByteArray &data)
+    {
+        if(request.waiters==0)
+            return;
+        QMutexLocker locker(&mutex);
+        RawTile key(request.type,request.pos,request.zoom);
+        foreach(Waiter* w,waiters)
+        {
+            if(w->tile==key && !w->done)
+            {
+                w->data=data;
+                w->done=true;
+            }
+        }
+        finished.wakeAll();
+    }
+
+    void TileFetcher::CheckTimeouts()
+    {
+        QList<QNetworkReply*> aborts;
+        mutex.lock();
+        qint64 now=clock.elapsed();
+        QHash<QNetworkReply*,Request>::iterator i;
+        for(i=inFlight.begin();i!=inFlight.end();++i)
+        {
+            if(!i.value().timedOut && now-i.value().startedMs>timeout)
+            {
+                i.value().timedOut=true;
+                aborts.append(i.key());
+            }
+        }
+        mutex.unlock();
+        foreach(QNetworkReply* reply,aborts)
+        {
+            reply->abort();
+        }
+    }
+
+    void TileFetcher::ThreadFinished()
+    {
+        QList<QNetworkReply*> replies;
+        mutex.lock();
+        replies=inFlight.keys();
+        inFlight.clear();
+        inFlightTiles.clear();
+        pending.clear();
+        mutex.unlock();
+        foreach(QNetworkReply* reply,replies)
+        {
+            reply->abort();
+            delete reply;
+        }
+        delete timeoutTimer;
+        timeoutTimer=0;
+        delete network;
+        network=0;
+    }
+
+    QNetworkProxy TileFetcher::GetProxy()
+    {
+        return OPMaps::Instance()->Proxy;
+    }
+
+    void TileFetcher::Store(const MapType::Types &type,const Point &pos,const int &zoom,const QByteArray &data)
+    {
+        OPMaps::Instance()->StoreTile(type,pos,zoom,data);
+    }
+
+    QNetworkRequest TileFetcher::MakeRequest(const MapType::Types &type,const Point &pos,const int &zoom)
+    {
+        OPMaps* maps=OPMaps::Instance();
+        QNetworkRequest qheader;
+        qheader.setUrl(QUrl(maps->MakeImageUrl(type,pos,zoom,LanguageType().toShortString(maps->GetLanguage()))));
+        qheader.setRawHeader("User-Agent",maps->UserAgent);
+        qheader.setRawHeader("Accept","*/*");
+        switch(type)
+        {
+        case MapType::GoogleMap:
+        case MapType::GoogleSatellite:
+        case MapType::GoogleLabels:
+        case MapType::GoogleTerrain:
+        case MapType::GoogleHybrid:
+            {
+                qheader.setRawHeader("Referrer", "http://maps.google.com/");
+            }
+            break;
+
+        case MapType::GoogleMapChina:
+        case MapType::GoogleSatelliteChina:
+        case MapType::GoogleLabelsChina:
+        case MapType::GoogleTerrainChina:
+        case MapType::GoogleHybridChina:
+            {
+                qheader.setRawHeader("Referrer", "http://ditu.google.cn/");
+            }
+            break;
+
+        case MapType::BingHybrid:
+        case MapType::BingMap:
+        case MapType::BingSatellite:
+            {
+                qheader.setRawHeader("Referrer", "http://www.bing.com/maps/");
+            }
+            break;
+
+        case MapType::YahooHybrid:
+        case MapType::YahooLabels:
+        case MapType::YahooMap:
+        case MapType::YahooSatellite:
+            {
+                qheader.setRawHeader("Referrer", "http://maps.yahoo.com/");
+            }
+            break;
+
+        case MapType::ArcGIS_MapsLT_Map_Labels:
+        case MapType::ArcGIS_MapsLT_Map:
+        case MapType::ArcGIS_MapsLT_OrtoFoto:
+        case MapType::ArcGIS_MapsLT_Map_Hybrid:
+            {
+                qheader.setRawHeader("Referrer", "http://www.maps.lt/map_beta/");
+            }
+            break;
+
+        case MapType::OpenStreetMapSurfer:
+        case MapType::OpenStreetMapSurferTerrain:
+            {
+                qheader.setRawHeader("Referrer", "http://www.mapsurfer.net/");
+            }
+            break;
+
+        case MapType::OpenStreetMap:
+        case MapType::OpenStreetOsm:
+            {
+                qheader.setRawHeader("Referrer", "http://www.openstreetmap.org/");
+            }
+            break;
+
+        case MapType::YandexMapRu:
+            {
+                qheader.setRawHeader("Referrer", "http://maps.yandex.ru/");
+            }
+            break;
+        default:
+            break;
+        }
+        return qheader;
+    }
+}
@@ -0,0 +1,214 @@
+/**
+******************************************************************************
+*
+* @file       tilefetcher.h
+* @author     The APM_PLANNER Project, http://www.diydrones.com Copyright (C) 2013.
+* @brief      Shared asynchronous tile downloader
+* @see        The GNU Public License (GPL) Version 3
+* @defgroup   OPMapWidget
+* @{
+*
+*****************************************************************************/
+/*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+* or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+* for more details.
+*
+* You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+#ifndef TILEFETCHER_H
+#define TILEFETCHER_H
+
+#include <QObject>
+#include <QAtomicPointer>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QByteArray>
+#include <QtNetwork/QNetworkProxy>
+#include <QtNetwork/QNetworkRequest>
+#include "maptype.h"
+#include "point.h"
+#include "rawtile.h"
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+namespace core {
+    /**
+     * Downloads map tiles for all maps through one QNetworkAccessManager
+     * living in its own thread, so the HTTP connections are kept alive and
+     * shared instead of being opened for every tile.
+     *
+     * Every map (owner) tells the fetcher which tiles it shows and where its
+     * center is. Requests are sent closest to the center of the current zoom
+     * level first, at most MAX_IN_FLIGHT at a time. A tile requested twice
+     * is downloaded once, and tiles no owner shows any more are dropped from
+     * the queue or aborted while downloading.
+     *
+     * The results are delivered through TileFetched() and TileFailed(),
+     * emitted from the fetcher thread.
+     */
+    class TileFetcher: public QObject
+    {
+        Q_OBJECT
+    public:
+        enum {
+            MAX_IN_FLIGHT = 6,          ///< Parallel requests, the connections Qt opens per host
+            TIMEOUT_CHECK_INTERVAL = 250
+        };
+
+        struct Statistics
+        {
+            Statistics():requests(0),fetched(0),deduplicated(0),cancelled(0),retries(0),
+                networkerrors(0),timeouts(0),emptytiles(0){}
+            int requests;       ///< Requests sent to the server
+            int fetched;        ///< Tiles received
+            int deduplicated;   ///< Fetches of a tile that was already queued or downloading
+            int cancelled;      ///< Requests dropped because no map shows the tile any more
+            int retries;
+            int networkerrors;
+            int timeouts;
+            int emptytiles;
+        };
+
+        TileFetcher();
+        ~TileFetcher();
+
+        /// <summary>
+        /// Fetcher shared by all maps, uses the proxy, timeout and retry settings of OPMaps.
+        /// Thread safe, the tile loader threads may be the first to ask for it.
+        /// </summary>
+        static TileFetcher* Instance();
+
+        /// <summary>
+        /// Queue a tile for the map owner, thread safe. Tiles that are queued or
+        /// downloading already are not requested again.
+        /// </summary>
+        void Fetch(const void* owner,const MapType::Types &type,const core::Point &pos,const int &zoom);
+        /// <summary>
+        /// Download a tile and wait for it, empty if it failed. Must not be called
+        /// from the fetcher thread.
+        /// </summary>
+        QByteArray FetchAndWait(const MapType::Types &type,const core::Point &pos,const int &zoom);
+        /// <summary>
+        /// Tiles the map owner shows now. Requests of the owner outside of them are
+        /// cancelled, the others are ordered by their distance to the center.
+        /// </summary>
+        void SetViewport(const void* owner,const int &zoom,const core::Point &center,const QList<core::Point> &tiles);
+        /// <summary>
+        /// Cancel all requests of the map owner
+        /// </summary>
+        void Cancel(const void* owner);
+
+        /// <summary>
+        /// Requests queued or downloading
+        /// </summary>
+        int Pending();
+        Statistics GetStatistics();
+
+        void SetTimeout(const int &ms){timeout=ms;}
+        int GetTimeout()const{return timeout;}
+        /// <summary>
+        /// Attempts per tile before TileFailed() is emitted
+        /// </summary>
+        void SetRetries(const int &value){retries=qMax(1,value);}
+        int GetRetries()const{return retries;}
+
+    signals:
+        void TileFetched(int type,int x,int y,int zoom,QByteArray data);
+        void TileFailed(int type,int x,int y,int zoom);
+
+    protected:
+        /// <summary>
+        /// HTTP request of a tile, by default the URL and headers of the map provider
+        /// </summary>
+        virtual QNetworkRequest MakeRequest(const MapType::Types &type,const core::Point &pos,const int &zoom);
+        virtual QNetworkProxy GetProxy();
+        /// <summary>
+        /// Called from the fetcher thread for every tile received, by default
+        /// adds it to the memory and database caches
+        /// </summary>
+        virtual void Store(const MapType::Types &type,const core::Point &pos,const int &zoom,const QByteArray &data);
+
+    private slots:
+        void Dispatch();
+        void ReplyFinished(QNetworkReply* reply);
+        void CheckTimeouts();
+        void ThreadFinished();
+
+    private:
+        struct Request
+        {
+            Request():type(MapType::GoogleMap),zoom(0),attempts(0),waiters(0),
+                starting(false),cancelled(false),timedOut(false),startedMs(0){}
+            MapType::Types type;
+            core::Point pos;
+            int zoom;
+            int attempts;
+            int waiters;                ///< Threads blocked in FetchAndWait()
+            QSet<const void*> owners;   ///< Maps that show the tile
+            bool starting;              ///< Still pending while its request is built
+            bool cancelled;             ///< Abort once the fetcher thread gets to it
+            bool timedOut;
+            qint64 startedMs;
+        };
+        struct Viewport
+        {
+            int zoom;
+            core::Point center;
+            QSet<core::Point> tiles;
+        };
+        struct Waiter
+        {
+            Waiter(const RawTile &tile):tile(tile),done(false){}
+            RawTile tile;
+            QByteArray data;
+            bool done;
+        };
+
+        /// <summary>
+        /// Lower is sent earlier, called with the mutex locked
+        /// </summary>
+        qint64 Priority(const Request &request) const;
+        bool IsWanted(const Request &request) const {return request.waiters>0 || !request.owners.isEmpty();}
+        void Enqueue(const void* owner,const MapType::Types &type,const core::Point &pos,const int &zoom,bool wait);
+        void Complete(const Request &request,const QByteArray &data);
+        void ScheduleDispatch();
+
+        QThread thread;
+        QMutex mutex;
+        QWaitCondition finished;
+        QNetworkAccessManager* network;     ///< Lives in the fetcher thread
+        QTimer* timeoutTimer;
+        QElapsedTimer clock;
+        QHash<RawTile,Request> pending;
+        QHash<QNetworkReply*,Request> inFlight;
+        QHash<RawTile,QNetworkReply*> inFlightTiles;
+        QHash<const void*,Viewport> viewports;
+        QList<Waiter*> waiters;
+        bool dispatchScheduled;
+        int starting;                       ///< Requests being built by Dispatch()
+        int timeout;
+        int retries;
+        Statistics stats;
+
+        static QAtomicPointer<TileFetcher> m_pInstance;
+        static QMutex instanceMutex;        ///< Serializes the creation of the instance
+    };
+
+}
+#endif // TILEFETCHER_H
@@ -25,6 +25,7 @@
 * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 #include "core.h"
+#include <algorithm>
 
 #ifdef DEBUG_CORE
 qlonglong internals::Core::debugcounter=0;
@@ -33,6 +34,20 @@ qlonglong internals::Core::debugcounter=0;
 using namespace projections;
 
 namespace internals {
+    namespace {
+        struct CloserTo
+        {
+            CloserTo(const Point &center) : center(center) {}
+            bool operator()(const Point &a, const Point &b) const
+            {
+                qint64 ax = a.X() - center.X(), ay = a.Y() - center.Y();
+                qint64 bx = b.X() - center.X(), by = b.Y() - center.Y();
+                return ax * ax + ay * ay < bx * bx + by * by;
+            }
+            Point center;
+        };
+    }
+
     Core::Core() :
     MouseWheelZooming(false),
     currentPosition(0,0),
@@ -58,10 +73,20 @@ namespace internals {
         CanDragMap=true;
         tilesToload=0;
         OPMaps::Instance();
+        // Delivered in the fetcher thread, like the pool threads the matrix is locked
+        connect(TileFetcher::Instance(),SIGNAL(TileFetched(int,int,int,int,QByteArray)),
+                this,SLOT(OnTileFetched(int,int,int,int,QByteArray)),Qt::DirectConnection);
+        connect(TileFetcher::Instance(),SIGNAL(TileFailed(int,int,int,int)),
+                this,SLOT(OnTileFailed(int,int,int,int)),Qt::DirectConnection);
     }
     Core::~Core()
     {
+        disconnect(TileFetcher::Instance(),0,this,0);
+        TileFetcher::Instance()->Cancel(this);
         ProcessLoadTaskCallback.waitForDone();
+        // Wait for a delivery that is running right now
+        MpendingTiles.lock();
+        MpendingTiles.unlock();
     }
 
     void Core::run()
@@ -76,8 +101,6 @@ namespace internals {
         Mdebug.unlock();
         qDebug()<<"core:run"<<" ID="<<debug;
 #endif //DEBUG_CORE
-        bool last = false;
-
         LoadTask task;
 
         MtileLoadQueue.lock();
@@ -86,8 +109,6 @@ namespace internals {
             {
                 task = tileLoadQueue.dequeue();
                 {
-
-                    last = (tileLoadQueue.count() == 0);
 #ifdef DEBUG_CORE
                     qDebug()<<"TileLoadQueue: " << tileLoadQueue.count()<<" Point:"<<task.Pos.ToString()<<" ID="<<debug;;
 #endif //DEBUG_CORE
@@ -99,143 +120,219 @@ namespace internals {
         if(task.HasValue())
             if(loaderLimit.tryAcquire(1,OPMaps::Instance()->Timeout))
             {
-            MtileToload.lock();
-            --tilesToload;
-            MtileToload.unlock();
 #ifdef DEBUG_CORE
             qDebug()<<"loadLimit semaphore aquired "<<loaderLimit.available()<<" ID="<<debug<<" TASK="<<task.Pos.ToString()<<" "<<task.Zoom;
 #endif //DEBUG_CORE
+            bool resolved = true;
 
             {
+                Tile* m = Matrix.TileAt(task.Pos);
 
-#ifdef DEBUG_CORE
-                qDebug()<<"task as value, begining get"<<" ID="<<debug;;
-#endif //DEBUG_CORE
-                {
-                    Tile* m = Matrix.TileAt(task.Pos);
-
-                    if(m==0 || m->Overlays.count() == 0)
-                    {
-#ifdef DEBUG_CORE
-                        qDebug()<<"Fill empty TileMatrix: " + task.ToString()<<" ID="<<debug;;
-#endif //DEBUG_CORE
+                MpendingTiles.lock();
+                bool downloading = pendingTiles.contains(task.Pos) && pendingTiles.value(task.Pos).zoom == task.Zoom;
+                MpendingTiles.unlock();
 
-                        Tile* t = new Tile(task.Zoom, task.Pos);
-                        QVector<MapType::Types> layers= OPMaps::Instance()->GetAllLayersOfType(GetMapType());
-
-                        foreach(MapType::Types tl,layers)
-                        {
-                            int retry = 0;
-                            do
-                            {
-                                QByteArray img;
-
-                                // tile number inversion(BottomLeft -> TopLeft) for pergo maps
-                                if(tl == MapType::PergoTurkeyMap)
-                                {
-                                    img = OPMaps::Instance()->GetImageFrom(tl, Point(task.Pos.X(), maxOfTiles.Height() - task.Pos.Y()), task.Zoom);
-                                }
-                                else // ok
-                                {
-#ifdef DEBUG_CORE
-                                    qDebug()<<"start getting image"<<" ID="<<debug;
-#endif //DEBUG_CORE
-                                    img = OPMaps::Instance()->GetImageFrom(tl, task.Pos, task.Zoom);
-#ifdef DEBUG_CORE
-                                    qDebug()<<"Core::run:gotimage size:"<<img.count()<<" ID="<<debug<<" time="<<t.elapsed();
-#endif //DEBUG_CORE
-                                }
-
-                                if(img.length()!=0)
-                                {
-                                    Moverlays.lock();
-                                    {
-                                        t->Overlays.append(img);
-#ifdef DEBUG_CORE
-                                        qDebug()<<"Core::run append img:"<<img.length()<<" to tile:"<<t->GetPos().ToString()<<" now has "<<t->Overlays.count()<<" overlays"<<" ID="<<debug;
-#endif //DEBUG_CORE
-
-                                    }
-                                    Moverlays.unlock();
-
-                                    break;
-                                }
-                                else if(OPMaps::Instance()->RetryLoadTile > 0)
-                                {
+                if((m==0 || m->Overlays.count() == 0) && !downloading && task.Zoom == Zoom())
+                {
 #ifdef DEBUG_CORE
-                                    qDebug()<<"ProcessLoadTask: " << task.ToString()<< " -> empty tile, retry " << retry<<" ID="<<debug;;
+                    qDebug()<<"Fill empty TileMatrix: " + task.ToString()<<" ID="<<debug;;
 #endif //DEBUG_CORE
-                                    {
-                                        QWaitCondition wait;
-                                        QMutex m;
-                                        m.lock();
-                                        wait.wait(&m,500);
-                                    }
-                                }
-                            }
-                            while(++retry < OPMaps::Instance()->RetryLoadTile);
-                        }
+                    QVector<MapType::Types> layers= OPMaps::Instance()->GetAllLayersOfType(GetMapType());
+                    QVector<QByteArray> overlays(layers.count());
+                    int missing = 0;
 
-                        if(t->Overlays.count() > 0)
-                        {
-                            Matrix.SetTileAt(task.Pos,t);
-                            emit OnNeedInvalidation();
-
-#ifdef DEBUG_CORE
-                            qDebug()<<"Core::run add tile "<<t->GetPos().ToString()<<" to matrix index "<<task.Pos.ToString()<<" ID="<<debug;
-                            qDebug()<<"Core::run matrix index "<<task.Pos.ToString()<<" as tile with "<<Matrix.TileAt(task.Pos)->Overlays.count()<<" ID="<<debug;
-#endif //DEBUG_CORE
-                        }
-                        else
+                    for(int i = 0; i < layers.count(); ++i)
+                    {
+                        overlays[i] = OPMaps::Instance()->GetImageFromCache(layers[i], NetworkPos(layers[i], task.Pos), task.Zoom);
+                        if(overlays[i].isEmpty())
                         {
-                            // emit OnTilesStillToLoad(tilesToload);
-
-                            delete t;
-                            t = 0;
-                            emit OnNeedInvalidation();
+                            ++missing;
                         }
-
-                        // layers = null;
                     }
-                }
-
 
-                {
-                    // last buddy cleans stuff ;}
-                    if(last)
+                    if(missing == 0 || OPMaps::Instance()->GetAccessMode() == AccessMode::CacheOnly)
                     {
-                        OPMaps::Instance()->kiberCacheLock.lockForWrite();
-                        OPMaps::Instance()->TilesInMemory.RemoveMemoryOverload();
-                        OPMaps::Instance()->kiberCacheLock.unlock();
-
-                        MtileDrawingList.lock();
+                        CommitTile(task.Pos, task.Zoom, overlays);
+                    }
+                    else
+                    {
+                        // The tile goes into the matrix once the fetcher delivered all its layers
+                        PendingTile pending;
+                        pending.zoom = task.Zoom;
+                        pending.layers = layers;
+                        pending.overlays = overlays;
+                        pending.missing = missing;
+                        for(int i = 0; i < layers.count(); ++i)
                         {
-                            Matrix.ClearPointsNotIn(tileDrawingList);
+                            pending.resolved.append(!overlays[i].isEmpty());
                         }
-                        MtileDrawingList.unlock();
-
-
-                        emit OnTileLoadComplete();
-
-
-                        emit OnNeedInvalidation();
+                        MpendingTiles.lock();
+                        pendingTiles.insert(task.Pos, pending);
+                        MpendingTiles.unlock();
+                        resolved = false;
 
+                        for(int i = 0; i < layers.count(); ++i)
+                        {
+                            if(overlays[i].isEmpty())
+                            {
+                                TileFetcher::Instance()->Fetch(this, layers[i], NetworkPos(layers[i], task.Pos), task.Zoom);
+                            }
+                        }
                     }
                 }
+            }
 
-
-
+            // Tasks of an older zoom level were taken off the count already
+            if(resolved && task.Zoom == Zoom())
+            {
+                TileResolved();
             }
 #ifdef DEBUG_CORE
             qDebug()<<"loaderLimit release:"+loaderLimit.available()<<" ID="<<debug;
 #endif
-            emit OnTilesStillToLoad(tilesToload<0? 0:tilesToload);
             loaderLimit.release();
         }
         MrunningThreads.lock();
         --runningThreads;
         MrunningThreads.unlock();
     }
+    Point Core::NetworkPos(const MapType::Types &type,const Point &pos)
+    {
+        // tile number inversion(BottomLeft -> TopLeft) for pergo maps
+        if(type == MapType::PergoTurkeyMap)
+        {
+            return Point(pos.X(), maxOfTiles.Height() - pos.Y());
+        }
+        return pos;
+    }
+    void Core::OnTileFetched(int type,int x,int y,int zoom,QByteArray data)
+    {
+        // The inversion of pergo tile numbers is its own inverse
+        LayerResolved((MapType::Types)type, NetworkPos((MapType::Types)type, Point(x, y)), zoom, data);
+    }
+    void Core::OnTileFailed(int type,int x,int y,int zoom)
+    {
+        LayerResolved((MapType::Types)type, NetworkPos((MapType::Types)type, Point(x, y)), zoom, QByteArray());
+    }
+    void Core::LayerResolved(const MapType::Types &type,const Point &pos,const int &zoom,const QByteArray &data)
+    {
+        QMutexLocker locker(&MpendingTiles);
+        QHash<Point,PendingTile>::iterator i = pendingTiles.find(pos);
+        if(i == pendingTiles.end() || i.value().zoom != zoom)
+        {
+            return;
+        }
+        PendingTile& pending = i.value();
+        for(int layer = 0; layer < pending.layers.count(); ++layer)
+        {
+            if(pending.layers[layer] == type && !pending.resolved[layer])
+            {
+                pending.overlays[layer] = data;
+                pending.resolved[layer] = true;
+                --pending.missing;
+                break;
+            }
+        }
+        if(pending.missing > 0)
+        {
+            return;
+        }
+
+        QVector<QByteArray> overlays = pending.overlays;
+        pendingTiles.erase(i);
+        if(zoom == Zoom())
+        {
+            CommitTile(pos, zoom, overlays);
+            TileResolved();
+        }
+    }
+    void Core::CommitTile(const Point &pos,const int &zoom,const QVector<QByteArray> &overlays)
+    {
+        Tile* t = new Tile(zoom, pos);
+        foreach(const QByteArray& img, overlays)
+        {
+            if(img.length() != 0)
+            {
+                Moverlays.lock();
+                t->Overlays.append(img);
+                Moverlays.unlock();
+            }
+        }
+
+        if(t->Overlays.count() > 0)
+        {
+            Matrix.SetTileAt(pos, t);
+#ifdef DEBUG_CORE
+            qDebug()<<"Core::CommitTile add tile "<<t->GetPos().ToString()<<" with "<<t->Overlays.count()<<" overlays";
+#endif //DEBUG_CORE
+        }
+        else
+        {
+            delete t;
+            t = 0;
+        }
+        emit OnNeedInvalidation();
+    }
+    void Core::TileResolved()
+    {
+        MtileToload.lock();
+        int left = --tilesToload;
+        MtileToload.unlock();
+
+        emit OnTilesStillToLoad(left < 0 ? 0 : left);
+
+        // last buddy cleans stuff ;}
+        if(left == 0)
+        {
+            OPMaps::Instance()->kiberCacheLock.lockForWrite();
+            OPMaps::Instance()->TilesInMemory.RemoveMemoryOverload();
+            OPMaps::Instance()->kiberCacheLock.unlock();
+
+            MtileDrawingList.lock();
+            {
+                Matrix.ClearPointsNotIn(tileDrawingList);
+            }
+            MtileDrawingList.unlock();
+
+            emit OnTileLoadComplete();
+
+            emit OnNeedInvalidation();
+        }
+    }
+    void Core::ClearPendingTiles()
+    {
+        MpendingTiles.lock();
+        pendingTiles.clear();
+        MpendingTiles.unlock();
+        TileFetcher::Instance()->Cancel(this);
+    }
+    int Core::UpdateFetchViewport(const QList<Point> &tiles)
+    {
+        // Pending tiles scrolled out of view are not waited for any more
+        int dropped = 0;
+        QSet<Point> visible = tiles.toSet();
+        MpendingTiles.lock();
+        QHash<Point,PendingTile>::iterator i = pendingTiles.begin();
+        while(i != pendingTiles.end())
+        {
+            if(i.value().zoom != Zoom() || !visible.contains(i.key()))
+            {
+                i = pendingTiles.erase(i);
+                ++dropped;
+                continue;
+            }
+            ++i;
+        }
+        MpendingTiles.unlock();
+
+        QList<Point> networkTiles;
+        foreach(const Point& p, tiles)
+        {
+            networkTiles.append(NetworkPos(GetMapType(), p));
+        }
+        TileFetcher::Instance()->SetViewport(this, Zoom(), NetworkPos(GetMapType(), centerTileXYLocation), networkTiles);
+        return dropped;
+    }
     diagnostics Core::GetDiagnostics()
     {
         MrunningThreads.lock();
@@ -261,6 +358,7 @@ namespace internals {
                 MtileToload.lock();
                 tilesToload=0;
                 MtileToload.unlock();
+                ClearPendingTiles();
                 Matrix.Clear();
                 GoToCurrentPositionOnZoom();
                 UpdateBounds();
@@ -511,6 +609,7 @@ namespace internals {
             MtileToload.lock();
             tilesToload=0;
             MtileToload.unlock();
+            ClearPendingTiles();
             Matrix.Clear();
 
             emit OnNeedInvalidation();
@@ -620,14 +719,17 @@ namespace internals {
             MtileToload.lock();
             tilesToload=0;
             MtileToload.unlock();
+            ClearPendingTiles();
             //  ProcessLoadTaskCallback.waitForDone();
         }
     }
     void Core::UpdateBounds()
     {
+        QList<Point> tiles;
         MtileDrawingList.lock();
         {
             FindTilesAround(tileDrawingList);
+            tiles = tileDrawingList;
 
 #ifdef DEBUG_CORE
             qDebug()<<"OnTileLoadStart: " << tileDrawingList.count() << " tiles to load at zoom " << Zoom() << ", time: " << QDateTime::currentDateTime().date();
@@ -660,6 +762,12 @@ namespace internals {
             }
         }
         MtileDrawingList.unlock();
+
+        int dropped = UpdateFetchViewport(tiles);
+        for(int i = 0; i < dropped; ++i)
+        {
+            TileResolved();
+        }
         UpdateGroundResolution();
     }
     void Core::FindTilesAround(QList<Point> &list)
@@ -693,6 +801,9 @@ namespace internals {
             }
         }
 
+        // Center first, the tiles are looked up and downloaded in this order
+        std::sort(list.begin(), list.end(), CloserTo(centerTileXYLocation));
+
 
     }
     void Core::UpdateGroundResolution()
@@ -49,6 +49,7 @@
 #include "../internals/projections/platecarreeprojectionpergo.h"
 #include "../core/geodecoderstatus.h"
 #include "../core/opmaps.h"
+#include "../core/tilefetcher.h"
 #include "../core/diagnostics.h"
 
 #include <QSemaphore>
@@ -204,7 +205,48 @@ namespace internals {
         void OnEmptyTileError(int zoom, core::Point pos);
         void OnNeedInvalidation();
 
+    private slots:
+        void OnTileFetched(int type,int x,int y,int zoom,QByteArray data);
+        void OnTileFailed(int type,int x,int y,int zoom);
+
     private:
+        /// <summary>
+        /// Tile with layers still downloading
+        /// </summary>
+        struct PendingTile
+        {
+            int zoom;
+            QVector<MapType::Types> layers;
+            QVector<QByteArray> overlays;
+            QVector<bool> resolved;
+            int missing;
+        };
+
+        /// <summary>
+        /// Tile number on the server, pergo maps count from the bottom left
+        /// </summary>
+        core::Point NetworkPos(const MapType::Types &type,const core::Point &pos);
+        void LayerResolved(const MapType::Types &type,const core::Point &pos,const int &zoom,const QByteArray &data);
+        /// <summary>
+        /// Put a tile with its overlays into the matrix
+        /// </summary>
+        void CommitTile(const core::Point &pos,const int &zoom,const QVector<QByteArray> &overlays);
+        /// <summary>
+        /// One tile less to load, cleans up after the last one
+        /// </summary>
+        void TileResolved();
+        /// <summary>
+        /// Forget the tiles waiting for downloads and cancel the downloads
+        /// </summary>
+        void ClearPendingTiles();
+        /// <summary>
+        /// Tell the fetcher which tiles are shown, returns the number of pending tiles dropped
+        /// </summary>
+        int UpdateFetchViewport(const QList<core::Point> &tiles);
+
+        QHash<core::Point,PendingTile> pendingTiles;
+        QMutex MpendingTiles;
+
 
 
         PointLatLng currentPosition;
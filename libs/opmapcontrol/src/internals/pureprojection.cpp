@@ -93,10 +93,10 @@ Point PureProjection::FromLatLngToPixel(const PointLatLng &p,const int &zoom)
          {
             for(int y = (topLeft.Y() - padding); y <= (rightBottom.Y() + padding); y++)
             {
-               Point p = Point(x, y);
-               if(!ret.contains(p) && p.X() >= 0 && p.Y() >= 0)
+               // Every x, y is visited once, no need to search the list
+               if(x >= 0 && y >= 0)
                {
-                  ret.append(p);
+                  ret.append(Point(x, y));
                }
             }
          }
@@ -174,6 +174,20 @@ public:
     */
     void ExportMapDataToDB(QString const& sourceDB, QString const& destDB)const{core::PureImageCache::ExportMapDataToDB(sourceDB,destDB);}
     /**
+    * @brief Shows the tiles of an MBTiles pack for a map type. They are read from the file, not imported.
+    *
+    * @param file the MBTiles file
+    * @param type the map type whose tiles the pack has
+    * @return false if the file is not an MBTiles pack
+    */
+    bool OpenMBTiles(QString const& file, core::MapType::Types const& type){return core::Cache::Instance()->MBTiles.Open(file,type);}
+    /**
+    * @brief Stops using the MBTiles pack
+    *
+    * @return
+    */
+    void CloseMBTiles(){core::Cache::Instance()->MBTiles.Close();}
+    /**
     * @brief Returns the location for the SQLite Database used for caching and the geocoding cache files
     *
     * @return
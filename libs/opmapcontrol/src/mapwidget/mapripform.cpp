@@ -30,9 +30,13 @@
 
 MapRipForm::MapRipForm(QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::MapRipForm)
+    ui(new Ui::MapRipForm),
+    total(0),
+    actual(0),
+    remaining(-1)
 {
     ui->setupUi(this);
+    connect(ui->cancelButton,SIGNAL(clicked()),this,SIGNAL(cancelled()));
 }
 
 MapRipForm::~MapRipForm()
@@ -49,5 +53,21 @@ void MapRipForm::SetProvider(const QString &prov,const int &zoom)
 }
 void MapRipForm::SetNumberOfTiles(const int &total, const int &actual)
 {
-    ui->statuslabel->setText(QString("Downloading tile %1 of %2").arg(actual).arg(total));
+    this->total=total;
+    this->actual=actual;
+    UpdateStatus();
+}
+void MapRipForm::SetRemainingTime(const int &seconds)
+{
+    remaining=seconds;
+    UpdateStatus();
+}
+void MapRipForm::UpdateStatus()
+{
+    QString status=QString("Downloading tile %1 of %2").arg(actual).arg(total);
+    if(remaining>=0)
+    {
+        status+=QString(", %1:%2 left").arg(remaining/60).arg(remaining%60,2,10,QChar('0'));
+    }
+    ui->statuslabel->setText(status);
 }
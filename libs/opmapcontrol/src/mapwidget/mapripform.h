@@ -44,8 +44,15 @@ public slots:
     void SetPercentage(int const& perc);
     void SetProvider(QString const& prov,int const& zoom);
     void SetNumberOfTiles(int const& total,int const& actual);
+    void SetRemainingTime(int const& seconds);
+signals:
+    void cancelled();
 private:
+    void UpdateStatus();
     Ui::MapRipForm *ui;
+    int total;
+    int actual;
+    int remaining;
 };
 
 #endif // MAPRIPFORM_H
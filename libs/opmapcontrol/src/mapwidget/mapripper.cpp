@@ -25,98 +25,342 @@
 * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
 */
 #include "mapripper.h"
+#include <QInputDialog>
+#include <QSettings>
+#include <QFile>
+#include "../core/cache.h"
 namespace mapcontrol
 {
 
-    MapRipper::MapRipper(internals::Core * core, const internals::RectLatLng & rect):sleep(100),cancel(false),progressForm(0),core(core)
+    MapRipper::MapRipper(internals::Core * core, const internals::RectLatLng & rect):fetcher(core::TileFetcher::Instance()),projection(core->Projection()),cancel(false),userInterface(true),progressForm(0),core(core),downloaded(0),skipped(0),failed(0)
     {
-        if(!rect.IsEmpty())
+        manifest=ManifestFile();
+        Job saved;
+        if(LoadJob(manifest,saved))
         {
-            type=core->GetMapType();
-            progressForm=new MapRipForm;
-            area=rect;
-            zoom=core->Zoom();
-            maxzoom=core->MaxZoom();
-            points=core->Projection()->GetAreaTileList(area,zoom,0);
-            this->start();
-            progressForm->show();
-            connect(this,SIGNAL(percentageChanged(int)),progressForm,SLOT(SetPercentage(int)));
-            connect(this,SIGNAL(numberOfTilesChanged(int,int)),progressForm,SLOT(SetNumberOfTiles(int,int)));
-            connect(this,SIGNAL(providerChanged(QString,int)),progressForm,SLOT(SetProvider(QString,int)));
-            connect(this,SIGNAL(finished()),this,SLOT(finish()));
-            emit numberOfTilesChanged(0,0);
+            QMessageBox msgBox;
+            msgBox.setText(QString("The download of %1 tiles was interrupted at zoom level %2. Resume it?").arg(core::MapType::StrByType(saved.type)).arg(saved.zoom));
+            msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+            msgBox.setDefaultButton(QMessageBox::Yes);
+            if(msgBox.exec()==QMessageBox::Yes)
+                job=saved;
         }
+        if(!job.IsValid() && !rect.IsEmpty())
+        {
+            bool ok=false;
+            int maxzoom=QInputDialog::getInt(0,"MapRipper",QString("Download the selected area from zoom level %1 up to zoom level:").arg(core->Zoom()),
+                                             qMin(core->Zoom()+4,core->MaxZoom()),core->Zoom(),core->MaxZoom(),1,&ok);
+            if(ok)
+            {
+                job.type=core->GetMapType();
+                job.area=rect;
+                job.zoom=core->Zoom();
+                job.maxzoom=maxzoom;
+                job.done=0;
+            }
+        }
+        if(!job.IsValid())
+        {
+            this->deleteLater();
+            return;
+        }
+        SaveJob(manifest,job);
+
+        // Delivered in the fetcher thread, run() waits for them
+        connect(fetcher,SIGNAL(TileFetched(int,int,int,int,QByteArray)),this,SLOT(OnTileFetched(int,int,int,int,QByteArray)),Qt::DirectConnection);
+        connect(fetcher,SIGNAL(TileFailed(int,int,int,int)),this,SLOT(OnTileFailed(int,int,int,int)),Qt::DirectConnection);
+        progressForm=new MapRipForm;
+        connect(this,SIGNAL(percentageChanged(int)),progressForm,SLOT(SetPercentage(int)));
+        connect(this,SIGNAL(numberOfTilesChanged(int,int)),progressForm,SLOT(SetNumberOfTiles(int,int)));
+        connect(this,SIGNAL(providerChanged(QString,int)),progressForm,SLOT(SetProvider(QString,int)));
+        connect(this,SIGNAL(remainingTimeChanged(int)),progressForm,SLOT(SetRemainingTime(int)));
+        connect(progressForm,SIGNAL(cancelled()),this,SLOT(Cancel()));
+        connect(this,SIGNAL(finished()),this,SLOT(finish()));
+        this->start();
+        progressForm->show();
+        emit numberOfTilesChanged(0,0);
+    }
+    MapRipper::MapRipper(core::TileFetcher *fetcher, internals::PureProjection *projection, const Job &job, const QString &manifest):job(job),manifest(manifest),fetcher(fetcher),projection(projection),cancel(false),userInterface(false),progressForm(0),core(0),downloaded(0),skipped(0),failed(0)
+    {
+        connect(fetcher,SIGNAL(TileFetched(int,int,int,int,QByteArray)),this,SLOT(OnTileFetched(int,int,int,int,QByteArray)),Qt::DirectConnection);
+        connect(fetcher,SIGNAL(TileFailed(int,int,int,int)),this,SLOT(OnTileFailed(int,int,int,int)),Qt::DirectConnection);
+    }
+    MapRipper::~MapRipper()
+    {
+        disconnect(fetcher,0,this,0);
+        Cancel();
+        wait();
     }
     void MapRipper::finish()
     {
-         if(zoom<maxzoom)
+        if(!userInterface)
+            return;
+        if(failed>0 && !cancel)
+        {
+            QMessageBox::warning(0,"MapRipper",QString("%1 tiles could not be downloaded, rip the area again to retry them.").arg(failed));
+        }
+        progressForm->close();
+        delete progressForm;
+        progressForm=0;
+        this->deleteLater();
+    }
+    void MapRipper::Cancel()
+    {
+        mutex.lock();
+        cancel=true;
+        tileDone.wakeAll();
+        mutex.unlock();
+        fetcher->Cancel(this);
+    }
+
+    QString MapRipper::ManifestFile()
+    {
+        return core::Cache::Instance()->CacheLocation()+"MapRipper.ini";
+    }
+    bool MapRipper::LoadJob(const QString &file, Job &job)
+    {
+        if(!QFile::exists(file))
+            return false;
+        QSettings settings(file,QSettings::IniFormat);
+        settings.beginGroup("MAPRIPPER");
+        job.type=(core::MapType::Types)settings.value("TYPE",core::MapType::GoogleMap).toInt();
+        job.area=internals::RectLatLng(settings.value("LATITUDE").toDouble(),settings.value("LONGITUDE").toDouble(),
+                                       settings.value("WIDTH_LONGITUDE").toDouble(),settings.value("HEIGHT_LATITUDE").toDouble());
+        job.zoom=settings.value("ZOOM").toInt();
+        job.maxzoom=settings.value("MAX_ZOOM").toInt();
+        job.done=settings.value("DONE").toInt();
+        settings.endGroup();
+        return job.IsValid();
+    }
+    void MapRipper::SaveJob(const QString &file, const Job &job)
+    {
+        QSettings settings(file,QSettings::IniFormat);
+        settings.beginGroup("MAPRIPPER");
+        settings.setValue("TYPE",(int)job.type);
+        settings.setValue("LATITUDE",job.area.Lat());
+        settings.setValue("LONGITUDE",job.area.Lng());
+        settings.setValue("WIDTH_LONGITUDE",job.area.WidthLng());
+        settings.setValue("HEIGHT_LATITUDE",job.area.HeightLat());
+        settings.setValue("ZOOM",job.zoom);
+        settings.setValue("MAX_ZOOM",job.maxzoom);
+        settings.setValue("DONE",job.done);
+        settings.endGroup();
+        settings.sync();
+    }
+
+    int MapRipper::DefaultRateLimit(const core::MapType::Types &type)
+    {
+        switch(type)
+        {
+        // The OpenStreetMap tile servers are run by volunteers and ask not to be bulk downloaded
+        case core::MapType::OpenStreetMap:
+        case core::MapType::OpenStreetOsm:
+        case core::MapType::OpenStreetMapSurfer:
+        case core::MapType::OpenStreetMapSurferTerrain:
+            return 2;
+        default:
+            return 10;
+        }
+    }
+    void MapRipper::SetRateLimit(const core::MapType::Types &type, const int &tilesPerSecond)
+    {
+        rateLimits.insert(type,tilesPerSecond);
+    }
+    bool MapRipper::WaitForRateLimit(const core::MapType::Types &type)
+    {
+        int limit=rateLimits.value(type,DefaultRateLimit(type));
+        if(limit<=0)
+            return !cancel;
+        qint64 next=qMax(clock.elapsed(),nextRequestMs.value(type,0));
+        nextRequestMs.insert(type,next+1000/limit);
+        while(!cancel && clock.elapsed()<next)
         {
-         ++zoom;
-         QMessageBox msgBox;
-         msgBox.setText(QString("Continue Ripping at zoom level %1?").arg(zoom));
-        // msgBox.setInformativeText("Do you want to save your changes?");
-         msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-         msgBox.setDefaultButton(QMessageBox::Yes);
-         int ret = msgBox.exec();
-         if(ret==QMessageBox::Yes)
-         {
-             points.clear();
-             points=core->Projection()->GetAreaTileList(area,zoom,0);
-             this->start();
-         }
-         else
-         {
-             progressForm->close();
-             delete progressForm;
-             this->deleteLater();
-         }
-     }
+            QThread::msleep(qMin<qint64>(next-clock.elapsed(),50));
+        }
+        return !cancel;
     }
 
+    void MapRipper::OnTileFetched(int type, int x, int y, int zoom, QByteArray data)
+    {
+        Q_UNUSED(data);
+        QMutexLocker locker(&mutex);
+        QHash<core::RawTile,int>::iterator i=inFlight.find(core::RawTile((core::MapType::Types)type,core::Point(x,y),zoom));
+        if(i==inFlight.end())
+            return;
+        completed.append(qMakePair(i.value(),true));
+        inFlight.erase(i);
+        tileDone.wakeAll();
+    }
+    void MapRipper::OnTileFailed(int type, int x, int y, int zoom)
+    {
+        QMutexLocker locker(&mutex);
+        QHash<core::RawTile,int>::iterator i=inFlight.find(core::RawTile((core::MapType::Types)type,core::Point(x,y),zoom));
+        if(i==inFlight.end())
+            return;
+        completed.append(qMakePair(i.value(),false));
+        inFlight.erase(i);
+        tileDone.wakeAll();
+    }
+
+    void MapRipper::ReportProgress(int total, int finished, int downloadedTiles)
+    {
+        emit numberOfTilesChanged(total,finished);
+        emit percentageChanged(total>0?(int)((qint64)finished*100/total):100);
+        qint64 elapsed=clock.elapsed();
+        if(downloadedTiles>0 && elapsed>0)
+        {
+            // Tiles left that turn out to be cached make it finish earlier
+            emit remainingTimeChanged((int)((qint64)(total-finished)*elapsed/downloadedTiles/1000));
+        }
+    }
 
     void MapRipper::run()
     {
-        int countOk = 0;
-        bool goodtile=false;
-        //  Stuff.Shuffle<Point>(ref list);
-        QVector<core::MapType::Types> types = OPMaps::Instance()->GetAllLayersOfType(type);
-        int all=points.count();
-        for(int i = 0; i < all; i++)
+        QVector<core::MapType::Types> types = OPMaps::Instance()->GetAllLayersOfType(job.type);
+        clock.start();
+        QElapsedTimer lastSave;
+        lastSave.start();
+
+        int total=0;
+        int finished=0;
+        int downloadedTiles=0;
+        for(int zoom=job.zoom;zoom<=job.maxzoom;++zoom)
         {
-            emit numberOfTilesChanged(all,i+1);
-            if(cancel)
-                break;
+            total+=projection->GetAreaTileList(job.area,zoom,0).count();
+        }
+        finished=job.done;
 
-            core::Point p = points[i];
+        for(;job.zoom<=job.maxzoom && !cancel;++job.zoom,job.done=0)
+        {
+            QList<core::Point> points=projection->GetAreaTileList(job.area,job.zoom,0);
+            int count=points.count();
+            job.done=qBound(0,job.done,count);
+            QList<core::Point> todo=points.mid(job.done);
+
+            // One query per layer instead of one per tile
+            QVector<QSet<core::Point> > cached;
+            foreach(core::MapType::Types type,types)
             {
-                //qDebug()<<"offline fetching:"<<p.ToString();
-                foreach(core::MapType::Types type,types)
+                cached.append(core::Cache::Instance()->ImageCache.GetCachedTiles(type,todo,job.zoom));
+            }
+            QList<QPair<int,core::MapType::Types> > queue;
+            QVector<int> missing(count,0);
+            QVector<bool> done(count,false);
+            QVector<bool> failedTiles(count,false);
+            for(int i=0;i<count;++i)
+            {
+                if(i<job.done)
+                {
+                    done[i]=true;
+                    continue;
+                }
+                for(int t=0;t<types.count();++t)
                 {
-                    emit providerChanged(core::MapType::StrByType(type),zoom);
-                    QByteArray img = OPMaps::Instance()->GetImageFrom(type, p, zoom);
-                    if(img.length()!=0)
+                    if(!cached.at(t).contains(points.at(i)))
                     {
-                        goodtile=true;
-                        img=NULL;
+                        queue.append(qMakePair(i,types.at(t)));
+                        ++missing[i];
                     }
-                    else
-                        goodtile=false;
                 }
-                if(goodtile)
+                if(missing.at(i)==0)
                 {
-                    countOk++;
+                    done[i]=true;
+                    ++skipped;
+                    ++finished;
                 }
-                else
+            }
+            cached.clear();
+            ReportProgress(total,finished,downloadedTiles);
+
+            int next=0;
+            int lastType=-1;
+            mutex.lock();
+            forever
+            {
+                while(!cancel && next<queue.count() && inFlight.count()<MAX_IN_FLIGHT)
                 {
-                    i--;
-                    QThread::msleep(1000);
-                    continue;
+                    QPair<int,core::MapType::Types> item=queue.at(next);
+                    mutex.unlock();
+                    if(!WaitForRateLimit(item.second))
+                    {
+                        mutex.lock();
+                        break;
+                    }
+                    if(item.second!=lastType)
+                    {
+                        lastType=item.second;
+                        emit providerChanged(core::MapType::StrByType(item.second),job.zoom);
+                    }
+                    mutex.lock();
+                    // Registered before the request, the fetcher may answer at once
+                    inFlight.insert(core::RawTile(item.second,points.at(item.first),job.zoom),item.first);
+                    ++next;
+                    mutex.unlock();
+                    fetcher->Fetch(this,item.second,points.at(item.first),job.zoom);
+                    mutex.lock();
+                }
+                if(cancel || (inFlight.isEmpty() && completed.isEmpty() && next>=queue.count()))
+                    break;
+                if(completed.isEmpty())
+                    tileDone.wait(&mutex,100);
+                QList<QPair<int,bool> > results=completed;
+                completed.clear();
+                mutex.unlock();
+
+                for(int r=0;r<results.count();++r)
+                {
+                    int i=results.at(r).first;
+                    if(!results.at(r).second)
+                        failedTiles[i]=true;
+                    if(--missing[i]>0)
+                        continue;
+                    ++finished;
+                    if(failedTiles.at(i))
+                    {
+                        ++failed;
+                    }
+                    else
+                    {
+                        done[i]=true;
+                        ++downloaded;
+                        ++downloadedTiles;
+                    }
                 }
+                if(!results.isEmpty())
+                    ReportProgress(total,finished,downloadedTiles);
+                // Resume after the tiles done in order, the cache skips the others
+                while(job.done<count && done.at(job.done))
+                    ++job.done;
+                if(lastSave.elapsed()>MANIFEST_INTERVAL)
+                {
+                    SaveJob(manifest,job);
+                    lastSave.restart();
+                }
+                mutex.lock();
             }
-            emit percentageChanged((int) ((i+1)*100/all));//, i+1);
-            // worker.ReportProgress((int) ((i+1)*100/all), i+1);
+            inFlight.clear();
+            completed.clear();
+            mutex.unlock();
 
-            QThread::msleep(sleep);
+            while(job.done<count && done.at(job.done))
+                ++job.done;
+            if(cancel)
+                break;
+            if(job.zoom<job.maxzoom)
+            {
+                Job nextZoom=job;
+                ++nextZoom.zoom;
+                nextZoom.done=0;
+                SaveJob(manifest,nextZoom);
+            }
+        }
+        if(cancel)
+        {
+            SaveJob(manifest,job);
+        }
+        else
+        {
+            QFile::remove(manifest);
         }
     }
 }
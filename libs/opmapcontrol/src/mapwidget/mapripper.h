@@ -29,36 +29,110 @@
 
 #include <QThread>
 #include "../internals/core.h"
+#include "../core/tilefetcher.h"
 #include "mapripform.h"
 #include <QObject>
 #include <QMessageBox>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
 namespace mapcontrol
 {
+    /**
+    * Downloads all tiles of an area for offline use, from a zoom level up to a
+    * maximum zoom. Tiles already in the cache are skipped, the others are
+    * requested through the shared TileFetcher, a few at a time and no faster
+    * than the rate limit of the map provider.
+    *
+    * The job is written to a manifest next to the tile cache while it runs, so
+    * a download that is cancelled or interrupted can be resumed later.
+    */
     class MapRipper:public QThread
     {
         Q_OBJECT
     public:
+        enum {
+            MAX_IN_FLIGHT=4,            ///< Tiles requested at the same time
+            MANIFEST_INTERVAL=2000      ///< ms between manifest updates
+        };
+        struct Job
+        {
+            Job():type(core::MapType::GoogleMap),zoom(0),maxzoom(0),done(0){}
+            core::MapType::Types type;
+            internals::RectLatLng area;
+            int zoom;           ///< Zoom level being downloaded
+            int maxzoom;
+            int done;           ///< Tiles of the zoom level done, in the order of GetAreaTileList()
+            bool IsValid()const{return !area.IsEmpty() && zoom<=maxzoom;}
+        };
+
+        /// <summary>
+        /// Asks up to which zoom level to download the area, or to resume an
+        /// interrupted download, and shows the progress
+        /// </summary>
         MapRipper(internals::Core *,internals::RectLatLng const&);
+        /// <summary>
+        /// Runs the job without user interface, keeping its manifest in the file
+        /// </summary>
+        MapRipper(core::TileFetcher *fetcher,internals::PureProjection *projection,Job const& job,QString const& manifest);
+        ~MapRipper();
         void run();
+
+        /// <summary>
+        /// Tiles per second requested from a provider, 0 for no limit
+        /// </summary>
+        void SetRateLimit(core::MapType::Types const& type,int const& tilesPerSecond);
+        static int DefaultRateLimit(core::MapType::Types const& type);
+
+        int Downloaded()const{return downloaded;}
+        int Skipped()const{return skipped;}
+        int Failed()const{return failed;}
+
+        static QString ManifestFile();
+        static bool LoadJob(QString const& file,Job &job);
+        static void SaveJob(QString const& file,Job const& job);
     private:
-        QList<core::Point> points;
-        int zoom;
-        core::MapType::Types type;
-        int sleep;
-        internals::RectLatLng area;
+        /// <summary>
+        /// Wait until the provider may be asked for the next tile, false if cancelled
+        /// </summary>
+        bool WaitForRateLimit(core::MapType::Types const& type);
+        void ReportProgress(int total,int finished,int downloadedTiles);
+
+        Job job;
+        QString manifest;
+        core::TileFetcher * fetcher;
+        internals::PureProjection * projection;
         bool cancel;
+        bool userInterface;
         MapRipForm * progressForm;
-        int maxzoom;
         internals::Core * core;
 
+        QMutex mutex;
+        QWaitCondition tileDone;
+        QHash<core::RawTile,int> inFlight;      ///< Tile index in the zoom level
+        QList<QPair<int,bool> > completed;      ///< Tile index and success, from the fetcher thread
+        QHash<int,int> rateLimits;
+        QHash<int,qint64> nextRequestMs;
+        QElapsedTimer clock;
+        int downloaded;
+        int skipped;
+        int failed;
+
     signals:
         void percentageChanged(int const& perc);
         void numberOfTilesChanged(int const& total,int const& actual);
         void providerChanged(QString const& prov,int const& zoom);
-
+        void remainingTimeChanged(int const& seconds);
 
     public slots:
         void finish();
+        /// <summary>
+        /// Stop downloading, the manifest is kept to resume later
+        /// </summary>
+        void Cancel();
+    private slots:
+        void OnTileFetched(int type,int x,int y,int zoom,QByteArray data);
+        void OnTileFailed(int type,int x,int y,int zoom);
     };
 }
 #endif // MAPRIPPER_H
@@ -0,0 +1,65 @@
+# -------------------------------------------------
+# APM Planner - Benchmarks of the hot paths
+# (c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+# This file is part of the APM_PLANNER project
+# APM_PLANNER is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# APM_PLANNER is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+# You should have received a copy of the GNU General Public License
+# along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+# -------------------------------------------------
+
+# Same sources and configuration as the unit tests, with the QBENCHMARK
+# classes in place of the unit tests. Run it headless and keep the JSON:
+#   qgcbenchmark -json results.json
+include(qgcunittest.pro)
+
+TARGET = qgcbenchmark
+
+HEADERS -= $$files($$TESTDIR/*Test.h)
+SOURCES -= $$files($$TESTDIR/*Test.cc) \
+    $$TESTDIR/testSuite.cc
+
+HEADERS += $$TESTDIR/BenchmarkReport.h \
+    $$TESTDIR/ProtocolBenchmark.h \
+    $$TESTDIR/TimeSeriesBenchmark.h \
+    $$TESTDIR/TileCacheBenchmark.h \
+    $$TESTDIR/MissionTransferBenchmark.h \
+    $$TESTDIR/LogCompressorBenchmark.h \
+    $$TESTDIR/VehicleStateBenchmark.h \
+    $$TESTDIR/SpeechBenchmark.h \
+    $$TESTDIR/TerminalBenchmark.h \
+    $$TESTDIR/DataFlashLogBenchmark.h \
+    $$TESTDIR/TileFetcherBenchmark.h \
+    $$TESTDIR/HilBridgeBenchmark.h \
+    $$TESTDIR/UDPLinkBenchmark.h \
+    $$TESTDIR/RGBDBenchmark.h \
+    $$TESTDIR/WaypointTableBenchmark.h
+
+SOURCES += $$TESTDIR/benchmarkSuite.cc \
+    $$TESTDIR/BenchmarkReport.cc \
+    $$TESTDIR/ProtocolBenchmark.cc \
+    $$TESTDIR/TimeSeriesBenchmark.cc \
+    $$TESTDIR/TileCacheBenchmark.cc \
+    $$TESTDIR/MissionTransferBenchmark.cc \
+    $$TESTDIR/LogCompressorBenchmark.cc \
+    $$TESTDIR/VehicleStateBenchmark.cc \
+    $$TESTDIR/SpeechBenchmark.cc \
+    $$TESTDIR/TerminalBenchmark.cc \
+    $$TESTDIR/DataFlashLogBenchmark.cc \
+    $$TESTDIR/TileFetcherBenchmark.cc \
+    $$TESTDIR/HilBridgeBenchmark.cc \
+    $$TESTDIR/UDPLinkBenchmark.cc \
+    $$TESTDIR/RGBDBenchmark.cc \
+    $$TESTDIR/WaypointTableBenchmark.cc
+
+# The 3D view imagery is only built with OpenSceneGraph
+contains(DEPENDENCIES_PRESENT, osg) {
+    HEADERS += $$TESTDIR/WebImageCacheBenchmark.h
+    SOURCES += $$TESTDIR/WebImageCacheBenchmark.cc
+}
@@ -238,18 +238,27 @@ INCLUDEPATH += src \
     src/ui/watchdog \
     src/ui/map3D \
     src/ui/mission \
-    src/ui/designer
+    src/ui/designer \
+    src/ui/configuration
 HEADERS += src/MG.h \
     src/QGCCore.h \
+    src/QGCStartupTimer.h \
+    src/QGCTimebase.h \
     src/uas/UASInterface.h \
     src/uas/UAS.h \
     src/uas/UASManager.h \
     src/comm/LinkManager.h \
+    src/comm/LinkMetrics.h \
     src/comm/LinkInterface.h \
     src/comm/SerialLinkInterface.h \
     src/comm/SerialLink.h \
     src/comm/ProtocolInterface.h \
     src/comm/MAVLinkProtocol.h \
+    src/comm/MAVLinkDecodeWorker.h \
+    src/comm/MAVLinkRouter.h \
+    src/ui/configuration/CompassCalibrator.h \
+    src/comm/LinkTxScheduler.h \
+    src/comm/QGCHilBridge.h \
     src/comm/QGCFlightGearLink.h \
     src/ui/CommConfigurationWindow.h \
     src/ui/SerialConfigurationWindow.h \
@@ -260,25 +269,34 @@ HEADERS += src/MG.h \
     src/ui/HUD.h \
     src/ui/linechart/LinechartWidget.h \
     src/ui/linechart/LinechartPlot.h \
+    src/ui/linechart/TimeSeriesStore.h \
     src/ui/linechart/Scrollbar.h \
     src/ui/linechart/ScrollZoomer.h \
     src/configuration.h \
     src/ui/uas/UASView.h \
     src/ui/CameraView.h \
     src/comm/MAVLinkSimulationLink.h \
+    src/comm/MAVLinkLoadLink.h \
     src/comm/UDPLink.h \
+    src/comm/UDPPeerTable.h \
     src/ui/ParameterInterface.h \
     src/ui/WaypointList.h \
+    src/ui/WaypointTableModel.h \
+    src/ui/WaypointItemDelegate.h \
     src/Waypoint.h \   
     src/ui/ObjectDetectionView.h \
     src/input/JoystickInput.h \
     src/ui/JoystickWidget.h \
     src/ui/DebugConsole.h \
+    src/ui/QGCTerminalBuffer.h \
+    src/ui/QGCTerminalView.h \
     src/ui/HDDisplay.h \
     src/ui/MAVLinkSettingsWidget.h \
     src/ui/AudioOutputWidget.h \
     src/GAudioOutput.h \
+    src/GAudioSpeechWorker.h \
     src/LogCompressor.h \
+    src/DataFlashLog.h \
     src/ui/QGCParamWidget.h \
     src/ui/QGCSensorSettingsWidget.h \
     src/ui/linechart/Linecharts.h \
@@ -326,6 +344,8 @@ HEADERS += src/MG.h \
     src/ui/QGCSettingsWidget.h \
     src/ui/uas/UASControlParameters.h \
     src/uas/QGCUASParamManager.h \
+    src/uas/QGCParamDownloadTracker.h \
+    src/uas/VehicleState.h \
     src/ui/map/QGCMapWidget.h \
     src/ui/map/MAV2DIcon.h \
     src/ui/map/Waypoint2DIcon.h \
@@ -345,12 +365,14 @@ HEADERS += src/MG.h \
     src/QGCGeo.h \
     src/ui/QGCToolBar.h \
     src/ui/QGCMAVLinkInspector.h \
+    src/ui/LinkMetricsWidget.h \
     src/ui/MAVLinkDecoder.h \
     src/ui/WaypointViewOnlyView.h \
     src/ui/WaypointViewOnlyView.h \
     src/ui/WaypointEditableView.h \    
     src/ui/UnconnectedUASInfoWidget.h \
     src/ui/QGCRGBDView.h \
+    src/ui/RGBDKernels.h \
     src/ui/mavlink/QGCMAVLinkMessageSender.h \
     src/ui/firmwareupdate/QGCFirmwareUpdateWidget.h \
     src/ui/QGCPluginHost.h \
@@ -367,6 +389,30 @@ HEADERS += src/MG.h \
     src/ui/mission/QGCMissionNavTakeoff.h \
     $$TESTDIR/AutoTest.h \
     $$TESTDIR/UASUnitTest.h \
+    $$TESTDIR/QGCParamDownloadTrackerTest.h \
+    $$TESTDIR/MAVLinkDecoderTest.h \
+    $$TESTDIR/QGCHilBridgeTest.h \
+    $$TESTDIR/HilStandIn.h \
+    $$TESTDIR/WaypointTableModelTest.h \
+    $$TESTDIR/MAVLinkDecodeWorkerTest.h \
+    $$TESTDIR/VehicleStateTest.h \
+    $$TESTDIR/DataFlashLogTest.h \
+    $$TESTDIR/GAudioSpeechWorkerTest.h \
+    $$TESTDIR/QGCStartupTimerTest.h \
+    $$TESTDIR/QGCTerminalBufferTest.h \
+    $$TESTDIR/UDPLinkTest.h \
+    $$TESTDIR/MAVLinkRouterTest.h \
+    $$TESTDIR/CompassCalibratorTest.h \
+    $$TESTDIR/TileFetcherTest.h \
+    $$TESTDIR/TileServer.h \
+    $$TESTDIR/MapRipperTest.h \
+    $$TESTDIR/PureImageCacheTest.h \
+    $$TESTDIR/RGBDKernelsTest.h \
+    $$TESTDIR/TimeSeriesStoreTest.h \
+    $$TESTDIR/LinkMetricsTest.h \
+    $$TESTDIR/MAVLinkLoadLinkTest.h \
+    $$TESTDIR/QGCTimebaseTest.h \
+    $$TESTDIR/LinkTxSchedulerTest.h \
 
 # Google Earth is only supported on Mac OS and Windows with Visual Studio Compiler
 macx|macx-g++|macx-g++42|win32-msvc2008|win32-msvc2010::HEADERS += src/ui/map3D/QGCGoogleEarthView.h
@@ -389,6 +435,7 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/Pixhawk3DWidget.h \
         src/ui/map3D/Q3DWidgetFactory.h \
         src/ui/map3D/WebImageCache.h \
+        src/ui/map3D/WebImageLoader.h \
         src/ui/map3D/WebImage.h \
         src/ui/map3D/TextureCache.h \
         src/ui/map3D/Texture.h \
@@ -396,7 +443,8 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/HUDScaleGeode.h \
         src/ui/map3D/WaypointGroupNode.h \
         src/ui/map3D/TerrainParamDialog.h \
-        src/ui/map3D/ImageryParamDialog.h
+        src/ui/map3D/ImageryParamDialog.h \
+        $$TESTDIR/WebImageCacheTest.h
 }
 contains(DEPENDENCIES_PRESENT, protobuf):contains(MAVLINK_CONF, pixhawk) {
     message("Including headers for Protocol Buffers")
@@ -414,12 +462,20 @@ contains(DEPENDENCIES_PRESENT, libfreenect) {
 }
 
 SOURCES += src/QGCCore.cc \
+    src/QGCStartupTimer.cc \
+    src/QGCTimebase.cc \
     src/uas/UASManager.cc \
     src/uas/UAS.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkMetrics.cc \
     src/comm/LinkInterface.cpp \
     src/comm/SerialLink.cc \
     src/comm/MAVLinkProtocol.cc \
+    src/comm/MAVLinkDecodeWorker.cc \
+    src/comm/MAVLinkRouter.cc \
+    src/ui/configuration/CompassCalibrator.cc \
+    src/comm/LinkTxScheduler.cc \
+    src/comm/QGCHilBridge.cc \
     src/comm/QGCFlightGearLink.cc \
     src/ui/CommConfigurationWindow.cc \
     src/ui/SerialConfigurationWindow.cc \
@@ -430,24 +486,33 @@ SOURCES += src/QGCCore.cc \
     src/ui/HUD.cc \
     src/ui/linechart/LinechartWidget.cc \
     src/ui/linechart/LinechartPlot.cc \
+    src/ui/linechart/TimeSeriesStore.cc \
     src/ui/linechart/Scrollbar.cc \
     src/ui/linechart/ScrollZoomer.cc \
     src/ui/uas/UASView.cc \
     src/ui/CameraView.cc \
     src/comm/MAVLinkSimulationLink.cc \
+    src/comm/MAVLinkLoadLink.cc \
     src/comm/UDPLink.cc \
+    src/comm/UDPPeerTable.cc \
     src/ui/ParameterInterface.cc \
     src/ui/WaypointList.cc \
+    src/ui/WaypointTableModel.cc \
+    src/ui/WaypointItemDelegate.cc \
     src/Waypoint.cc \
     src/ui/ObjectDetectionView.cc \
     src/input/JoystickInput.cc \
     src/ui/JoystickWidget.cc \
     src/ui/DebugConsole.cc \
+    src/ui/QGCTerminalBuffer.cc \
+    src/ui/QGCTerminalView.cc \
     src/ui/HDDisplay.cc \
     src/ui/MAVLinkSettingsWidget.cc \
     src/ui/AudioOutputWidget.cc \
     src/GAudioOutput.cc \
+    src/GAudioSpeechWorker.cc \
     src/LogCompressor.cc \
+    src/DataFlashLog.cc \
     src/ui/QGCParamWidget.cc \
     src/ui/QGCSensorSettingsWidget.cc \
     src/ui/linechart/Linecharts.cc \
@@ -493,6 +558,8 @@ SOURCES += src/QGCCore.cc \
     src/ui/QGCSettingsWidget.cc \
     src/ui/uas/UASControlParameters.cpp \
     src/uas/QGCUASParamManager.cc \
+    src/uas/QGCParamDownloadTracker.cc \
+    src/uas/VehicleState.cc \
     src/ui/map/QGCMapWidget.cc \
     src/ui/map/MAV2DIcon.cc \
     src/ui/map/Waypoint2DIcon.cc \
@@ -510,17 +577,43 @@ SOURCES += src/QGCCore.cc \
     src/ui/mission/QGCMissionNavLoiterTime.cc \
     src/ui/QGCToolBar.cc \
     src/ui/QGCMAVLinkInspector.cc \
+    src/ui/LinkMetricsWidget.cc \
     src/ui/MAVLinkDecoder.cc \
     src/ui/WaypointViewOnlyView.cc \
     src/ui/WaypointEditableView.cc \
     src/ui/UnconnectedUASInfoWidget.cc \
     src/ui/QGCRGBDView.cc \
+    src/ui/RGBDKernels.cc \
     src/ui/mavlink/QGCMAVLinkMessageSender.cc \
     src/ui/firmwareupdate/QGCFirmwareUpdateWidget.cc \
     src/ui/QGCPluginHost.cc \
     src/ui/firmwareupdate/QGCPX4FirmwareUpdate.cc \
     $$TESTDIR/testSuite.cc \
-    $$TESTDIR/UASUnitTest.cc
+    $$TESTDIR/UASUnitTest.cc \
+    $$TESTDIR/QGCParamDownloadTrackerTest.cc \
+    $$TESTDIR/MAVLinkDecoderTest.cc \
+    $$TESTDIR/QGCHilBridgeTest.cc \
+    $$TESTDIR/HilStandIn.cc \
+    $$TESTDIR/WaypointTableModelTest.cc \
+    $$TESTDIR/MAVLinkDecodeWorkerTest.cc \
+    $$TESTDIR/VehicleStateTest.cc \
+    $$TESTDIR/DataFlashLogTest.cc \
+    $$TESTDIR/GAudioSpeechWorkerTest.cc \
+    $$TESTDIR/QGCStartupTimerTest.cc \
+    $$TESTDIR/QGCTerminalBufferTest.cc \
+    $$TESTDIR/UDPLinkTest.cc \
+    $$TESTDIR/MAVLinkRouterTest.cc \
+    $$TESTDIR/CompassCalibratorTest.cc \
+    $$TESTDIR/TileFetcherTest.cc \
+    $$TESTDIR/TileServer.cc \
+    $$TESTDIR/MapRipperTest.cc \
+    $$TESTDIR/PureImageCacheTest.cc \
+    $$TESTDIR/RGBDKernelsTest.cc \
+    $$TESTDIR/TimeSeriesStoreTest.cc \
+    $$TESTDIR/LinkMetricsTest.cc \
+    $$TESTDIR/MAVLinkLoadLinkTest.cc \
+    $$TESTDIR/QGCTimebaseTest.cc \
+    $$TESTDIR/LinkTxSchedulerTest.cc
 
 # Enable Google Earth only on Mac OS and Windows with Visual Studio compiler
 macx|macx-g++|macx-g++42|win32-msvc2008|win32-msvc2010::SOURCES += src/ui/map3D/QGCGoogleEarthView.cc
@@ -544,6 +637,7 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/Pixhawk3DWidget.cc \
         src/ui/map3D/Q3DWidgetFactory.cc \
         src/ui/map3D/WebImageCache.cc \
+        src/ui/map3D/WebImageLoader.cc \
         src/ui/map3D/WebImage.cc \
         src/ui/map3D/TextureCache.cc \
         src/ui/map3D/Texture.cc \
@@ -551,7 +645,8 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/HUDScaleGeode.cc \
         src/ui/map3D/WaypointGroupNode.cc \
         src/ui/map3D/TerrainParamDialog.cc \
-        src/ui/map3D/ImageryParamDialog.cc
+        src/ui/map3D/ImageryParamDialog.cc \
+        $$TESTDIR/WebImageCacheTest.cc
 
     contains(DEPENDENCIES_PRESENT, osgearth) { 
         message("Including sources for osgEarth")
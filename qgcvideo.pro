@@ -29,6 +29,7 @@ HEADERS += \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
     src/QGC.h \
+    src/QGCTimebase.h \
     src/apps/qgcvideo/QGCVideoMainWindow.h \
     src/apps/qgcvideo/QGCVideoApp.h \
     src/apps/qgcvideo/QGCVideoWidget.h
@@ -37,6 +38,7 @@ SOURCES += \
     src/comm/UDPLink.cc \
     src/comm/LinkManager.cc \
     src/QGC.cc \
+    src/QGCTimebase.cc \
     src/apps/qgcvideo/main.cc \
     src/apps/qgcvideo/QGCVideoMainWindow.cc \
     src/apps/qgcvideo/QGCVideoApp.cc \
@@ -342,15 +342,22 @@ INCLUDEPATH += src \
     src/ui/configuration
 HEADERS += src/MG.h \
     src/QGCCore.h \
+    src/QGCStartupTimer.h \
+    src/QGCTimebase.h \
     src/uas/UASInterface.h \
     src/uas/UAS.h \
     src/uas/UASManager.h \
     src/comm/LinkManager.h \
+    src/comm/LinkMetrics.h \
     src/comm/LinkInterface.h \
     src/comm/SerialLinkInterface.h \
     src/comm/SerialLink.h \
     src/comm/ProtocolInterface.h \
     src/comm/MAVLinkProtocol.h \
+    src/comm/MAVLinkDecodeWorker.h \
+    src/comm/MAVLinkRouter.h \
+    src/comm/LinkTxScheduler.h \
+    src/comm/QGCHilBridge.h \
     src/comm/QGCFlightGearLink.h \
     src/comm/QGCJSBSimLink.h \
     src/comm/QGCXPlaneLink.h \
@@ -363,25 +370,34 @@ HEADERS += src/MG.h \
     src/ui/HUD.h \
     src/ui/linechart/LinechartWidget.h \
     src/ui/linechart/LinechartPlot.h \
+    src/ui/linechart/TimeSeriesStore.h \
     src/ui/linechart/Scrollbar.h \
     src/ui/linechart/ScrollZoomer.h \
     src/configuration.h \
     src/ui/uas/UASView.h \
     src/ui/CameraView.h \
     src/comm/MAVLinkSimulationLink.h \
+    src/comm/MAVLinkLoadLink.h \
     src/comm/UDPLink.h \
+    src/comm/UDPPeerTable.h \
     src/ui/ParameterInterface.h \
     src/ui/WaypointList.h \
+    src/ui/WaypointTableModel.h \
+    src/ui/WaypointItemDelegate.h \
     src/Waypoint.h \   
     src/ui/ObjectDetectionView.h \
     src/input/JoystickInput.h \
     src/ui/JoystickWidget.h \
     src/ui/DebugConsole.h \
+    src/ui/QGCTerminalBuffer.h \
+    src/ui/QGCTerminalView.h \
     src/ui/HDDisplay.h \
     src/ui/MAVLinkSettingsWidget.h \
     src/ui/AudioOutputWidget.h \
     src/GAudioOutput.h \
+    src/GAudioSpeechWorker.h \
     src/LogCompressor.h \
+    src/DataFlashLog.h \
     src/ui/QGCParamWidget.h \
     src/ui/QGCSensorSettingsWidget.h \
     src/ui/linechart/Linecharts.h \
@@ -428,6 +444,8 @@ HEADERS += src/MG.h \
     src/ui/QGCSettingsWidget.h \
     src/ui/uas/UASControlParameters.h \
     src/uas/QGCUASParamManager.h \
+    src/uas/QGCParamDownloadTracker.h \
+    src/uas/VehicleState.h \
     src/ui/map/QGCMapWidget.h \
     src/ui/map/MAV2DIcon.h \
     src/ui/map/Waypoint2DIcon.h \
@@ -437,11 +455,13 @@ HEADERS += src/MG.h \
     src/ui/QGCToolBar.h \
     src/ui/QGCStatusBar.h \
     src/ui/QGCMAVLinkInspector.h \
+    src/ui/LinkMetricsWidget.h \
     src/ui/MAVLinkDecoder.h \
     src/ui/WaypointViewOnlyView.h \
     src/ui/WaypointEditableView.h \    
     src/ui/UnconnectedUASInfoWidget.h \
     src/ui/QGCRGBDView.h \
+    src/ui/RGBDKernels.h \
     src/ui/mavlink/QGCMAVLinkMessageSender.h \
     src/ui/firmwareupdate/QGCFirmwareUpdateWidget.h \
     src/ui/QGCPluginHost.h \
@@ -484,6 +504,7 @@ HEADERS += src/MG.h \
     src/ui/configuration/ApmSoftwareConfig.h \
     src/ui/configuration/FrameTypeConfig.h \
     src/ui/configuration/CompassConfig.h \
+    src/ui/configuration/CompassCalibrator.h \
     src/ui/configuration/AccelCalibrationConfig.h \
     src/ui/configuration/RadioCalibrationConfig.h \
     src/ui/configuration/FlightModeConfig.h \
@@ -512,7 +533,6 @@ HEADERS += src/MG.h \
     src/ui/configuration/Console.h \
     src/ui/configuration/SerialSettingsDialog.h \
     src/ui/configuration/TerminalConsole.h \
-    src/ui/configuration/ApmHighlighter.h \
     src/ui/configuration/ApmFirmwareConfig.h \
     src/ui/designer/QGCMouseWheelEventFilter.h \
     src/ui/DebugOutput.h \
@@ -541,6 +561,7 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/Pixhawk3DWidget.h \
         src/ui/map3D/Q3DWidgetFactory.h \
         src/ui/map3D/WebImageCache.h \
+        src/ui/map3D/WebImageLoader.h \
         src/ui/map3D/WebImage.h \
         src/ui/map3D/TextureCache.h \
         src/ui/map3D/Texture.h \
@@ -548,7 +569,8 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/HUDScaleGeode.h \
         src/ui/map3D/WaypointGroupNode.h \
         src/ui/map3D/TerrainParamDialog.h \
-        src/ui/map3D/ImageryParamDialog.h
+        src/ui/map3D/ImageryParamDialog.h \
+        src/ui/map3D/OffscreenRenderBenchmark.h
 }
 contains(DEPENDENCIES_PRESENT, protobuf):contains(MAVLINK_CONF, pixhawk) {
     message("Including headers for Protocol Buffers")
@@ -566,12 +588,19 @@ contains(DEPENDENCIES_PRESENT, libfreenect) {
 }
 SOURCES += src/main.cc \
     src/QGCCore.cc \
+    src/QGCStartupTimer.cc \
+    src/QGCTimebase.cc \
     src/uas/UASManager.cc \
     src/uas/UAS.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkMetrics.cc \
     src/comm/LinkInterface.cpp \
     src/comm/SerialLink.cc \
     src/comm/MAVLinkProtocol.cc \
+    src/comm/MAVLinkDecodeWorker.cc \
+    src/comm/MAVLinkRouter.cc \
+    src/comm/LinkTxScheduler.cc \
+    src/comm/QGCHilBridge.cc \
     src/comm/QGCFlightGearLink.cc \
     src/comm/QGCJSBSimLink.cc \
     src/comm/QGCXPlaneLink.cc \
@@ -584,24 +613,33 @@ SOURCES += src/main.cc \
     src/ui/HUD.cc \
     src/ui/linechart/LinechartWidget.cc \
     src/ui/linechart/LinechartPlot.cc \
+    src/ui/linechart/TimeSeriesStore.cc \
     src/ui/linechart/Scrollbar.cc \
     src/ui/linechart/ScrollZoomer.cc \
     src/ui/uas/UASView.cc \
     src/ui/CameraView.cc \
     src/comm/MAVLinkSimulationLink.cc \
+    src/comm/MAVLinkLoadLink.cc \
     src/comm/UDPLink.cc \
+    src/comm/UDPPeerTable.cc \
     src/ui/ParameterInterface.cc \
     src/ui/WaypointList.cc \
+    src/ui/WaypointTableModel.cc \
+    src/ui/WaypointItemDelegate.cc \
     src/Waypoint.cc \
     src/ui/ObjectDetectionView.cc \
     src/input/JoystickInput.cc \
     src/ui/JoystickWidget.cc \
     src/ui/DebugConsole.cc \
+    src/ui/QGCTerminalBuffer.cc \
+    src/ui/QGCTerminalView.cc \
     src/ui/HDDisplay.cc \
     src/ui/MAVLinkSettingsWidget.cc \
     src/ui/AudioOutputWidget.cc \
     src/GAudioOutput.cc \
+    src/GAudioSpeechWorker.cc \
     src/LogCompressor.cc \
+    src/DataFlashLog.cc \
     src/ui/QGCParamWidget.cc \
     src/ui/QGCSensorSettingsWidget.cc \
     src/ui/linechart/Linecharts.cc \
@@ -647,6 +685,8 @@ SOURCES += src/main.cc \
     src/ui/QGCSettingsWidget.cc \
     src/ui/uas/UASControlParameters.cpp \
     src/uas/QGCUASParamManager.cc \
+    src/uas/QGCParamDownloadTracker.cc \
+    src/uas/VehicleState.cc \
     src/ui/map/QGCMapWidget.cc \
     src/ui/map/MAV2DIcon.cc \
     src/ui/map/Waypoint2DIcon.cc \
@@ -655,11 +695,13 @@ SOURCES += src/main.cc \
     src/ui/QGCToolBar.cc \
     src/ui/QGCStatusBar.cc \
     src/ui/QGCMAVLinkInspector.cc \
+    src/ui/LinkMetricsWidget.cc \
     src/ui/MAVLinkDecoder.cc \
     src/ui/WaypointViewOnlyView.cc \
     src/ui/WaypointEditableView.cc \
     src/ui/UnconnectedUASInfoWidget.cc \
     src/ui/QGCRGBDView.cc \
+    src/ui/RGBDKernels.cc \
     src/ui/mavlink/QGCMAVLinkMessageSender.cc \
     src/ui/firmwareupdate/QGCFirmwareUpdateWidget.cc \
     src/ui/QGCPluginHost.cc \
@@ -701,6 +743,7 @@ SOURCES += src/main.cc \
     src/ui/configuration/ApmSoftwareConfig.cc \
     src/ui/configuration/FrameTypeConfig.cc \
     src/ui/configuration/CompassConfig.cc \
+    src/ui/configuration/CompassCalibrator.cc \
     src/ui/configuration/AccelCalibrationConfig.cc \
     src/ui/configuration/RadioCalibrationConfig.cc \
     src/ui/configuration/FlightModeConfig.cc \
@@ -729,7 +772,6 @@ SOURCES += src/main.cc \
     src/ui/configuration/TerminalConsole.cc \
     src/ui/configuration/Console.cc \
     src/ui/configuration/SerialSettingsDialog.cc \
-    src/ui/configuration/ApmHighlighter.cc \
     src/ui/configuration/ApmFirmwareConfig.cc \
     src/ui/designer/QGCMouseWheelEventFilter.cc \
     src/ui/DebugOutput.cc \
@@ -758,6 +800,7 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/Pixhawk3DWidget.cc \
         src/ui/map3D/Q3DWidgetFactory.cc \
         src/ui/map3D/WebImageCache.cc \
+        src/ui/map3D/WebImageLoader.cc \
         src/ui/map3D/WebImage.cc \
         src/ui/map3D/TextureCache.cc \
         src/ui/map3D/Texture.cc \
@@ -765,7 +808,8 @@ contains(DEPENDENCIES_PRESENT, osg) {
         src/ui/map3D/HUDScaleGeode.cc \
         src/ui/map3D/WaypointGroupNode.cc \
         src/ui/map3D/TerrainParamDialog.cc \
-        src/ui/map3D/ImageryParamDialog.cc
+        src/ui/map3D/ImageryParamDialog.cc \
+        src/ui/map3D/OffscreenRenderBenchmark.cc
 
     contains(DEPENDENCIES_PRESENT, osgearth) { 
         message("Including sources for osgEarth")
@@ -39,6 +39,7 @@ HEADERS += \
     src/comm/SerialLinkInterface.h \
     src/comm/LinkManager.h \
     src/QGC.h \
+    src/QGCTimebase.h \
     src/apps/qupgrade/QUpgradeApp.h \
     src/apps/qupgrade/QUpgradeMainWindow.h \
     src/apps/qupgrade/uploader.h \
@@ -50,6 +51,7 @@ SOURCES += \
     src/comm/SerialLink.cc \
     src/comm/LinkManager.cc \
     src/QGC.cc \
+    src/QGCTimebase.cc \
     src/apps/qupgrade/main.cc \
     src/apps/qupgrade/QUpgradeApp.cc \
     src/apps/qupgrade/QUpgradeMainWindow.cc \
@@ -0,0 +1,605 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Memory mapped reader of APM DataFlash (.bin) logs
+ */
+
+#include "DataFlashLog.h"
+#include "QsLog.h"
+
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+/** Fixed size, NUL padded string of the log */
+QByteArray fixedString(const uchar* text, int maxLength)
+{
+    int length = 0;
+    while (length < maxLength && text[length] != 0) length++;
+    return QByteArray(reinterpret_cast<const char*>(text), length);
+}
+}
+
+bool DataFlashLog::Format::isNumeric(int field) const
+{
+    if (field < 0 || field >= offsets.size()) return false;
+    switch (types.at(field))
+    {
+    case 'n':
+    case 'N':
+    case 'Z':
+    case 'a':
+        return false;
+    default:
+        return true;
+    }
+}
+
+DataFlashLog::DataFlashLog() :
+    data(NULL),
+    size(0),
+    skippedBytes(0),
+    indexTime(0)
+{
+}
+
+DataFlashLog::~DataFlashLog()
+{
+    close();
+}
+
+bool DataFlashLog::open(const QString& fileName)
+{
+    close();
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorString = QObject::tr("Could not open %1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+    size = file.size();
+    if (size > (qint64)0xFFFFFFFFULL)
+    {
+        errorString = QObject::tr("%1 is larger than 4 GB").arg(fileName);
+        close();
+        return false;
+    }
+    if (size > 0)
+    {
+        data = file.map(0, size);
+        if (!data)
+        {
+            errorString = QObject::tr("Could not map %1 into memory: %2").arg(fileName, file.errorString());
+            close();
+            return false;
+        }
+    }
+    else
+    {
+        errorString = QObject::tr("%1 is empty").arg(fileName);
+        close();
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    index();
+    indexTime = timer.elapsed();
+
+    QLOG_INFO() << "DataFlash log" << fileName << ":" << size << "bytes," << layouts.size() << "message types,"
+                << skippedBytes << "bytes skipped, indexed in" << indexTime << "ms ("
+                << getIndexThroughput() << "MB/s)";
+    return true;
+}
+
+void DataFlashLog::close()
+{
+    if (data)
+    {
+        file.unmap(data);
+        data = NULL;
+    }
+    file.close();
+    size = 0;
+    skippedBytes = 0;
+    indexTime = 0;
+    formats.clear();
+    messages.clear();
+    layouts.clear();
+    columns.clear();
+}
+
+double DataFlashLog::getIndexThroughput() const
+{
+    if (indexTime <= 0) return 0.0;
+    return (size / (1024.0 * 1024.0)) / (indexTime / 1000.0);
+}
+
+void DataFlashLog::index()
+{
+    // Layout in force and its length by type, looked up for every message
+    int current[256];
+    int lengths[256];
+    for (int i = 0; i < 256; i++) current[i] = -1;
+    memset(lengths, 0, sizeof(lengths));
+    // FMT messages written before the FMT of FMT itself
+    QVector<quint32> formatMessages;
+
+    const uchar* end = data + size;
+    const uchar* p = data;
+    while (end - p >= HEADER_LENGTH)
+    {
+        if (p[0] != HEAD_BYTE1 || p[1] != HEAD_BYTE2)
+        {
+            // Resynchronize on the next candidate header
+            const uchar* next = static_cast<const uchar*>(memchr(p + 1, HEAD_BYTE1, end - p - 1));
+            if (!next) break;
+            skippedBytes += next - p;
+            p = next;
+            continue;
+        }
+
+        int type = p[2];
+        if (type == FMT_TYPE)
+        {
+            if (end - p < FMT_LENGTH) break;
+            addFormat(p, current);
+            int defined = p[HEADER_LENGTH];
+            if (current[defined] >= 0) lengths[defined] = formats.at(current[defined]).length;
+            if (current[FMT_TYPE] >= 0) messages[current[FMT_TYPE]].append(p - data);
+            else formatMessages.append(p - data);
+            p += FMT_LENGTH;
+            continue;
+        }
+
+        int length = lengths[type];
+        if (length == 0 || end - p < length)
+        {
+            // Unknown type or truncated message
+            skippedBytes++;
+            p++;
+            continue;
+        }
+        messages[current[type]].append(p - data);
+        p += length;
+    }
+    skippedBytes += end - p;
+
+    if (current[FMT_TYPE] >= 0 && !formatMessages.isEmpty())
+    {
+        messages[current[FMT_TYPE]] = formatMessages + messages.at(current[FMT_TYPE]);
+    }
+}
+
+void DataFlashLog::addFormat(const uchar* message, int* current)
+{
+    const uchar* payload = message + HEADER_LENGTH;
+    Format format;
+    format.type = payload[0];
+    format.length = payload[1];
+    format.name = QString::fromLatin1(fixedString(payload + 2, 4));
+    format.types = fixedString(payload + 6, 16);
+    format.labels = QString::fromLatin1(fixedString(payload + 22, 64)).split(',', QString::SkipEmptyParts);
+
+    if (format.type == FMT_TYPE || format.length < HEADER_LENGTH)
+    {
+        // FMT itself has a fixed layout, and a message needs at least its header
+        if (format.type != FMT_TYPE)
+        {
+            QLOG_WARN() << "DataFlash log: ignoring format" << format.name << "with length" << format.length;
+            return;
+        }
+        if (current[FMT_TYPE] >= 0) return;
+        format.length = FMT_LENGTH;
+    }
+
+    // Field offsets, up to the first field that is unknown or does not fit
+    int offset = HEADER_LENGTH;
+    for (int i = 0; i < format.types.size() && i < format.labels.size(); i++)
+    {
+        int fieldLength = fieldSize(format.types.at(i));
+        if (fieldLength == 0 || offset + fieldLength > format.length)
+        {
+            QLOG_WARN() << "DataFlash log: format" << format.name << "field" << format.labels.at(i)
+                        << "type" << format.types.at(i) << "not supported";
+            break;
+        }
+        format.offsets.append(offset);
+        offset += fieldLength;
+    }
+
+    // Logs repeat their formats, only a changed one starts a new layout
+    if (current[format.type] >= 0)
+    {
+        const Format& previous = formats.at(current[format.type]);
+        if (previous.length == format.length && previous.name == format.name
+                && previous.types == format.types && previous.labels == format.labels)
+        {
+            return;
+        }
+        QLOG_INFO() << "DataFlash log: type" << format.type << "redefined from" << previous.name << "to" << format.name;
+    }
+    current[format.type] = formats.size();
+    layouts[format.name].append(formats.size());
+    formats.append(format);
+    messages.append(QVector<quint32>());
+}
+
+int DataFlashLog::fieldSize(char type)
+{
+    switch (type)
+    {
+    case 'b':
+    case 'B':
+    case 'M':
+        return 1;
+    case 'h':
+    case 'H':
+    case 'c':
+    case 'C':
+        return 2;
+    case 'i':
+    case 'I':
+    case 'e':
+    case 'E':
+    case 'L':
+    case 'f':
+    case 'n':
+        return 4;
+    case 'd':
+    case 'q':
+    case 'Q':
+        return 8;
+    case 'N':
+        return 16;
+    case 'Z':
+    case 'a':
+        return 64;
+    default:
+        return 0;
+    }
+}
+
+double DataFlashLog::decode(const uchar* field, char type)
+{
+    switch (type)
+    {
+    case 'b':
+        return static_cast<qint8>(field[0]);
+    case 'B':
+    case 'M':
+        return field[0];
+    case 'h':
+        return qFromLittleEndian<qint16>(field);
+    case 'H':
+        return qFromLittleEndian<quint16>(field);
+    case 'i':
+        return qFromLittleEndian<qint32>(field);
+    case 'I':
+        return qFromLittleEndian<quint32>(field);
+    case 'f':
+    {
+        quint32 bits = qFromLittleEndian<quint32>(field);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    case 'd':
+    {
+        quint64 bits = qFromLittleEndian<quint64>(field);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    case 'q':
+        return qFromLittleEndian<qint64>(field);
+    case 'Q':
+        return qFromLittleEndian<quint64>(field);
+    case 'c':
+        return qFromLittleEndian<qint16>(field) / 100.0;
+    case 'C':
+        return qFromLittleEndian<quint16>(field) / 100.0;
+    case 'e':
+        return qFromLittleEndian<qint32>(field) / 100.0;
+    case 'E':
+        return qFromLittleEndian<quint32>(field) / 100.0;
+    case 'L':
+        return qFromLittleEndian<qint32>(field) / 1E7;
+    default:
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+QByteArray DataFlashLog::fieldText(const uchar* field, char type)
+{
+    switch (type)
+    {
+    case 'n':
+    case 'N':
+    case 'Z':
+        return fixedString(field, fieldSize(type));
+    case 'a':
+    {
+        QByteArray text;
+        for (int i = 0; i < 32; i++)
+        {
+            if (i > 0) text.append(' ');
+            text.append(QByteArray::number(qFromLittleEndian<qint16>(field + 2 * i)));
+        }
+        return text;
+    }
+    case 'L':
+        return QByteArray::number(decode(field, type), 'f', 7);
+    default:
+        return QByteArray::number(decode(field, type), 'g', 15);
+    }
+}
+
+QStringList DataFlashLog::getMessageNames() const
+{
+    QStringList names;
+    QHash<QString, QVector<int> >::const_iterator i;
+    for (i = layouts.constBegin(); i != layouts.constEnd(); ++i)
+    {
+        if (getMessageCount(i.key()) > 0) names.append(i.key());
+    }
+    names.sort();
+    return names;
+}
+
+const DataFlashLog::Format* DataFlashLog::getFormat(const QString& name) const
+{
+    QHash<QString, QVector<int> >::const_iterator i = layouts.constFind(name);
+    if (i == layouts.constEnd()) return NULL;
+    return &formats.at(i.value().last());
+}
+
+int DataFlashLog::getMessageCount(const QString& name) const
+{
+    int count = 0;
+    foreach (int layout, layouts.value(name))
+    {
+        count += messages.at(layout).size();
+    }
+    return count;
+}
+
+QStringList DataFlashLog::getFieldNames(const QString& name) const
+{
+    QStringList fields;
+    foreach (int layout, layouts.value(name))
+    {
+        const Format& format = formats.at(layout);
+        for (int i = 0; i < format.offsets.size(); i++)
+        {
+            if (format.isNumeric(i) && !fields.contains(format.labels.at(i))) fields.append(format.labels.at(i));
+        }
+    }
+    return fields;
+}
+
+void DataFlashLog::mergeMessages(const QVector<int>& list, QVector<quint32>& offsets, QVector<int>& layoutOf) const
+{
+    int count = 0;
+    for (int l = 0; l < list.size(); l++)
+    {
+        count += messages.at(list.at(l)).size();
+    }
+    offsets.resize(count);
+    layoutOf.resize(count);
+
+    // The layouts of a name interleave when it is defined for two types at once
+    QVector<int> next(list.size(), 0);
+    for (int m = 0; m < count; m++)
+    {
+        int best = -1;
+        for (int l = 0; l < list.size(); l++)
+        {
+            const QVector<quint32>& candidates = messages.at(list.at(l));
+            if (next.at(l) < candidates.size() && (best < 0 || candidates.at(next.at(l)) < offsets.at(m)))
+            {
+                best = l;
+                offsets[m] = candidates.at(next.at(l));
+            }
+        }
+        layoutOf[m] = best;
+        next[best]++;
+    }
+}
+
+QVector<double> DataFlashLog::decodeColumn(const QVector<int>& list, const QVector<int>& fields, const QVector<double>& scales) const
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (list.size() == 1)
+    {
+        // One layout, the usual case
+        const QVector<quint32>& offsets = messages.at(list.first());
+        QVector<double> values(offsets.size(), nan);
+        if (fields.first() < 0) return values;
+        const Format& format = formats.at(list.first());
+        const int fieldOffset = format.offsets.at(fields.first());
+        const char type = format.types.at(fields.first());
+        const double scale = scales.first();
+        double* out = values.data();
+        const quint32* in = offsets.constData();
+        for (int m = 0; m < offsets.size(); m++)
+        {
+            out[m] = decode(data + in[m] + fieldOffset, type) * scale;
+        }
+        return values;
+    }
+
+    QVector<quint32> offsets;
+    QVector<int> layoutOf;
+    mergeMessages(list, offsets, layoutOf);
+    QVector<double> values(offsets.size(), nan);
+    for (int m = 0; m < offsets.size(); m++)
+    {
+        const int l = layoutOf.at(m);
+        const int field = fields.at(l);
+        if (field < 0) continue;
+        const Format& format = formats.at(list.at(l));
+        values[m] = decode(data + offsets.at(m) + format.offsets.at(field), format.types.at(field)) * scales.at(l);
+    }
+    return values;
+}
+
+QVector<double> DataFlashLog::getColumn(const QString& name, const QString& field)
+{
+    QString key = name + "." + field;
+    QHash<QString, QVector<double> >::const_iterator cached = columns.constFind(key);
+    if (cached != columns.constEnd()) return cached.value();
+
+    QVector<double> values;
+    if (!data) return values;
+    const QVector<int> list = layouts.value(name);
+    QVector<int> fields(list.size(), -1);
+    bool found = false;
+    for (int l = 0; l < list.size(); l++)
+    {
+        const Format& format = formats.at(list.at(l));
+        int i = format.labels.indexOf(field);
+        if (i >= 0 && i < format.offsets.size())
+        {
+            fields[l] = i;
+            found = true;
+        }
+    }
+    if (!found) return values;
+
+    values = decodeColumn(list, fields, QVector<double>(list.size(), 1.0));
+    columns.insert(key, values);
+    return values;
+}
+
+QVector<double> DataFlashLog::getTime(const QString& name)
+{
+    const QVector<int> list = layouts.value(name);
+    if (list.isEmpty()) return QVector<double>();
+
+    // The layouts of a name may differ in their time field
+    QVector<int> fields(list.size(), -1);
+    QVector<double> scales(list.size(), 1.0);
+    bool found = false;
+    for (int l = 0; l < list.size(); l++)
+    {
+        const Format& format = formats.at(list.at(l));
+        int i = format.labels.indexOf("TimeUS");
+        double scale = 1E-6;
+        if (i < 0 || i >= format.offsets.size())
+        {
+            i = format.labels.indexOf("TimeMS");
+            scale = 1E-3;
+        }
+        if (i >= 0 && i < format.offsets.size())
+        {
+            fields[l] = i;
+            scales[l] = scale;
+            found = true;
+        }
+    }
+    if (found && data) return decodeColumn(list, fields, scales);
+
+    QVector<double> time(getMessageCount(name));
+    for (int i = 0; i < time.size(); i++) time[i] = i;
+    return time;
+}
+
+bool DataFlashLog::exportCsv(const QString& fileName, const QString& name, QStringList fields, const QString& separator)
+{
+    const QVector<int> list = layouts.value(name);
+    if (!data || list.isEmpty())
+    {
+        errorString = QObject::tr("No messages of type %1").arg(name);
+        return false;
+    }
+    if (fields.isEmpty())
+    {
+        const Format* format = getFormat(name);
+        fields = format->labels.mid(0, format->offsets.size());
+    }
+
+    // Index of every exported field in every layout, -1 leaves the cell empty
+    QVector<QVector<int> > fieldIndex(list.size());
+    foreach (const QString& field, fields)
+    {
+        bool found = false;
+        for (int l = 0; l < list.size(); l++)
+        {
+            const Format& format = formats.at(list.at(l));
+            int i = format.labels.indexOf(field);
+            if (i >= format.offsets.size()) i = -1;
+            if (i >= 0) found = true;
+            fieldIndex[l].append(i);
+        }
+        if (!found)
+        {
+            errorString = QObject::tr("%1 has no field %2").arg(name, field);
+            return false;
+        }
+    }
+
+    QFile out(fileName);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        errorString = QObject::tr("Could not write %1: %2").arg(fileName, out.errorString());
+        return false;
+    }
+
+    QVector<quint32> offsets;
+    QVector<int> layoutOf;
+    mergeMessages(list, offsets, layoutOf);
+
+    const QByteArray sep = separator.toLatin1();
+    QByteArray buffer = fields.join(separator).toLatin1() + "\n";
+    for (int m = 0; m < offsets.size(); m++)
+    {
+        const uchar* message = data + offsets.at(m);
+        const Format& format = formats.at(list.at(layoutOf.at(m)));
+        const QVector<int>& index = fieldIndex.at(layoutOf.at(m));
+        for (int f = 0; f < index.size(); f++)
+        {
+            if (f > 0) buffer.append(sep);
+            if (index.at(f) >= 0) buffer.append(fieldText(message + format.offsets.at(index.at(f)), format.types.at(index.at(f))));
+        }
+        buffer.append('\n');
+        if (buffer.size() > (1 << 20))
+        {
+            out.write(buffer);
+            buffer.clear();
+        }
+    }
+    out.write(buffer);
+    if (out.error() != QFile::NoError)
+    {
+        errorString = QObject::tr("Could not write %1: %2").arg(fileName, out.errorString());
+        return false;
+    }
+    return true;
+}
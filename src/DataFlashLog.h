@@ -0,0 +1,161 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Memory mapped reader of APM DataFlash (.bin) logs
+ */
+
+#ifndef DATAFLASHLOG_H
+#define DATAFLASHLOG_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Reads the binary logs the APM writes to its DataFlash / SD card. Every
+ * message starts with 0xA3 0x95 and its type, the layout of each type is
+ * described by a FMT message earlier in the log.
+ *
+ * open() maps the file and makes a single pass over it, which collects the
+ * FMT definitions and the offset of every message, grouped by type. No
+ * values are decoded at that point. getColumn() decodes one field of one
+ * message type on first use and keeps the result, so plotting a few fields
+ * of a large log only touches the bytes of these messages.
+ *
+ * A FMT message may define a type again later in the log, with another
+ * layout or name. Every definition is kept as a layout of its own and each
+ * message is decoded with the layout in force where it was written. The
+ * columns of a name run over all its layouts in log order; fields missing
+ * in a layout are NaN there.
+ *
+ * Offsets are 32 bit, logs larger than 4 GB are refused.
+ */
+class DataFlashLog
+{
+public:
+    enum {
+        HEAD_BYTE1 = 0xA3,
+        HEAD_BYTE2 = 0x95,
+        HEADER_LENGTH = 3,
+        FMT_TYPE = 128,
+        FMT_LENGTH = 89     ///< Header, type, length, name[4], format[16], labels[64]
+    };
+
+    /** @brief Layout of one message type, as defined by its FMT message */
+    struct Format {
+        Format() : type(-1), length(0) {}
+        int type;
+        int length;             ///< Full message length including the header
+        QString name;
+        QByteArray types;       ///< One format character per field
+        QStringList labels;
+        QVector<int> offsets;   ///< Offset of each field from the message start
+        bool isValid() const { return length > 0; }
+        bool isNumeric(int field) const;
+    };
+
+    DataFlashLog();
+    ~DataFlashLog();
+
+    /** @brief Map and index a log file, closes the previous one */
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const { return data != NULL; }
+    QString getFileName() const { return file.fileName(); }
+    QString getErrorString() const { return errorString; }
+
+    /** @brief Size of the log in bytes */
+    qint64 getSize() const { return size; }
+    /** @brief Bytes that were not part of a known message (corruption, partial writes) */
+    qint64 getSkippedBytes() const { return skippedBytes; }
+    /** @brief Time the indexing pass took in milliseconds */
+    qint64 getIndexTime() const { return indexTime; }
+    /** @brief Throughput of the indexing pass in MB/s */
+    double getIndexThroughput() const;
+
+    /** @brief Names of the message types present in the log, sorted */
+    QStringList getMessageNames() const;
+    /** @brief Latest format of a message type, NULL if unknown */
+    const Format* getFormat(const QString& name) const;
+    /** @brief Number of messages of a type */
+    int getMessageCount(const QString& name) const;
+    /** @brief Labels of the numeric fields of a type, of all its layouts */
+    QStringList getFieldNames(const QString& name) const;
+
+    /**
+     * @brief Values of one field of all messages of a type
+     *
+     * Scaled to their natural unit (centi-units divided by 100, coordinates
+     * by 1E7). Text fields are returned as NaN. Decoded on first use.
+     */
+    QVector<double> getColumn(const QString& name, const QString& field);
+    /** @brief Time of all messages of a type in seconds, from TimeUS or TimeMS, else the message index */
+    QVector<double> getTime(const QString& name);
+
+    /**
+     * @brief Write fields of one message type to a CSV file
+     * @param fields labels to export, all fields if empty
+     */
+    bool exportCsv(const QString& fileName, const QString& name, QStringList fields = QStringList(), const QString& separator = "\t");
+
+    /** @brief Size in bytes of a field of this format character, 0 if unknown */
+    static int fieldSize(char type);
+
+protected:
+    /** @brief One pass over the mapped file, collects formats and offsets */
+    void index();
+    /**
+     * @brief Register the format a FMT message at this position defines
+     * @param current layout in force for each type, updated
+     */
+    void addFormat(const uchar* message, int* current);
+    /**
+     * @brief Decode one field of the messages of some layouts, in log order
+     * @param fields index of the field in each layout, -1 if it is missing there
+     * @param scales factor applied to the field in each layout
+     */
+    QVector<double> decodeColumn(const QVector<int>& list, const QVector<int>& fields, const QVector<double>& scales) const;
+    /** @brief Offsets of the messages of some layouts in log order, with the position of their layout in list */
+    void mergeMessages(const QVector<int>& list, QVector<quint32>& offsets, QVector<int>& layoutOf) const;
+    /** @brief Decode one numeric field, scaled */
+    static double decode(const uchar* field, char type);
+    /** @brief Text of one field, as written to CSV */
+    static QByteArray fieldText(const uchar* field, char type);
+
+    QFile file;
+    uchar* data;                    ///< Mapped file, NULL if closed
+    qint64 size;
+    QString errorString;
+    qint64 skippedBytes;
+    qint64 indexTime;
+
+    QVector<Format> formats;        ///< Every layout defined in the log, in log order
+    QVector<QVector<quint32> > messages; ///< Offsets of the messages, by layout
+    QHash<QString, QVector<int> > layouts; ///< Layouts of each message name, in log order
+    QHash<QString, QVector<double> > columns; ///< Decoded columns, by "NAME.Field"
+};
+
+#endif // DATAFLASHLOG_H
@@ -35,13 +35,8 @@ This file is part of the QGROUNDCONTROL project
 
 #include <QApplication>
 #include <QSettings>
-#include <QTemporaryFile>
 
 
-#ifdef Q_OS_MAC
-#include <ApplicationServices/ApplicationServices.h>
-#endif
-
 // Speech synthesis is only supported with MSVC compiler
 #if _MSC_VER2
 // Documentation: http://msdn.microsoft.com/en-us/library/ee125082%28v=VS.85%29.aspx
@@ -59,15 +54,6 @@ extern CComModule _Module;
 //using System.Speech.Synthesis;
 #endif
 
-#ifdef Q_OS_LINUX
-extern "C" {
-#include <flite/flite.h>
-    cst_voice* register_cmu_us_kal(const char* voxdir);
-};
-#endif
-
-
-
 /**
  * This class follows the singleton design pattern
  * @see http://en.wikipedia.org/wiki/Singleton_pattern
@@ -93,17 +79,18 @@ GAudioOutput* GAudioOutput::instance()
 GAudioOutput::GAudioOutput(QObject* parent) : QObject(parent),
     voiceIndex(0),
     emergency(false),
-    muted(false)
+    muted(false),
+    speech(NULL)
 {
     // Load settings
     QSettings settings;
     settings.sync();
     muted = settings.value(QGC_GAUDIOOUTPUT_KEY+"muted", muted).toBool();
 
-
-#ifdef Q_OS_LINUX
-    flite_init();
-#endif
+    // Synthesis and playback block for as long as the phrase takes,
+    // keep them off the GUI thread
+    speech = new GAudioSpeechWorker(this);
+    speech->start();
 
 #if _MSC_VER2
 
@@ -158,6 +145,7 @@ void GAudioOutput::mute(bool mute)
         QSettings settings;
         settings.setValue(QGC_GAUDIOOUTPUT_KEY+"muted", this->muted);
         settings.sync();
+        if (muted) speech->clear();
         emit mutedChanged(muted);
     }
 }
@@ -167,55 +155,30 @@ bool GAudioOutput::isMuted()
     return this->muted;
 }
 
+/**
+ * Returns immediately, the text is synthesized and played by the speech
+ * worker. During an emergency only emergency messages are spoken.
+ *
+ * @param text The text to speak
+ * @param severity SEVERITY_NORMAL, SEVERITY_ALERT or SEVERITY_EMERGENCY
+ * @return true if the text was queued
+ */
 bool GAudioOutput::say(QString text, int severity)
 {
-    if (!muted)
-    {
-        // TODO Add severity filter
-        Q_UNUSED(severity);
-        bool res = false;
-        if (!emergency)
-        {
-
-            // Speech synthesis is only supported with MSVC compiler
-#ifdef _MSC_VER2
-            SpeechSynthesizer synth = new SpeechSynthesizer();
-            synth.SelectVoice("Microsoft Anna");
-            synth.SpeakText(text.toStdString().c_str());
-            res = true;
-#endif
-
-#ifdef Q_OS_LINUX
-            QTemporaryFile file;
-            file.setFileTemplate("XXXXXX.wav");
-            if (file.open()) {
-                cst_voice* v = register_cmu_us_kal(NULL);
-                cst_wave* wav = flite_text_to_wave(text.toStdString().c_str(), v);
-                // file.fileName() returns the unique file name
-                cst_wave_save(wav, file.fileName().toStdString().c_str(), "riff");
-                //m_media->setCurrentSource(Phonon::MediaSource(file.fileName().toStdString().c_str()));
-                //m_media->play();
-                res = true;
-            }
-#endif
-
-#ifdef Q_OS_MAC
-            // Slashes necessary to have the right start to the sentence
-            // copying data prevents SpeakString from reading additional chars
-            text = "\\" + text;
-            QStdWString str = text.toStdWString();
-            unsigned char str2[1024] = {};
-            memcpy(str2, text.toAscii().data(), str.length());
-            SpeakString(str2);
-            res = true;
-#endif
-        }
-        return res;
-    }
-    else
+    if (muted || (emergency && severity < SEVERITY_EMERGENCY))
     {
         return false;
     }
+    speech->enqueue(text, severity);
+    return true;
+}
+
+/**
+ * @param phrases Texts that are going to be spoken often, for example the flight modes
+ */
+void GAudioOutput::prewarm(const QStringList& phrases)
+{
+    speech->prewarm(phrases);
 }
 
 /**
@@ -228,7 +191,7 @@ bool GAudioOutput::alert(QString text)
         // Play alert sound
         beep();
         // Say alert message
-        say(text, 2);
+        say(text, SEVERITY_ALERT);
         return true;
     }
     else
@@ -330,24 +293,6 @@ void GAudioOutput::selectNeutralVoice()
 
 QStringList GAudioOutput::listVoices(void)
 {
-    QStringList l;
-#ifdef Q_OS_LINUX2
-    cst_voice *voice;
-    const cst_val *v;
-
-
-
-    printf("Voices available: ");
-    for (v=flite_voice_list; v; v=val_cdr(v)) {
-        voice = val_voice(val_car(v));
-        QString s;
-        s.sprintf("%s",voice->name);
-        printf("%s",voice->name);
-        l.append(s);
-    }
-    printf("\n");
-
-#endif
-    return l;
-
+    // Voices are chosen by the speech worker of each platform
+    return QStringList();
 }
@@ -35,6 +35,7 @@ This file is part of the PIXHAWK project
 #include <QObject>
 #include <QTimer>
 #include <QStringList>
+#include "GAudioSpeechWorker.h"
 #ifdef Q_OS_MAC
 #include <MediaObject>
 #include <AudioOutput>
@@ -84,9 +85,18 @@ public:
     /** @brief Get the mute state */
     bool isMuted();
 
+    /** @brief Severity of a spoken message, higher ones are spoken first */
+    enum Severity {
+        SEVERITY_NORMAL = GAudioSpeechWorker::PRIORITY_NORMAL,
+        SEVERITY_ALERT = GAudioSpeechWorker::PRIORITY_ALERT,
+        SEVERITY_EMERGENCY = GAudioSpeechWorker::PRIORITY_EMERGENCY
+    };
+
 public slots:
-    /** @brief Say this text if current output priority matches */
-    bool say(QString text, int severity=1);
+    /** @brief Queue this text for speech, ordered by severity */
+    bool say(QString text, int severity=SEVERITY_NORMAL);
+    /** @brief Synthesize phrases ahead of time, so they are spoken without delay later */
+    void prewarm(const QStringList& phrases);
     /** @brief Play alert sound and say notification message */
     bool alert(QString text);
     /** @brief Start emergency sound */
@@ -122,6 +132,7 @@ protected:
     bool emergency;   ///< Emergency status flag
     QTimer* emergencyTimer;
     bool muted;
+    GAudioSpeechWorker* speech; ///< Synthesizes and plays the queued phrases
 private:
     GAudioOutput(QObject* parent=NULL);
 //    ~GAudioOutput();
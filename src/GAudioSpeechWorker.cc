@@ -0,0 +1,261 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Speech synthesis and playback in a background thread
+ */
+
+#include "GAudioSpeechWorker.h"
+#include "QsLog.h"
+
+#include <cstring>
+
+#ifdef Q_OS_MAC
+#include <ApplicationServices/ApplicationServices.h>
+#endif
+
+#ifdef Q_OS_LINUX
+extern "C" {
+#include <flite/flite.h>
+    cst_voice* register_cmu_us_kal(const char* voxdir);
+};
+#endif
+
+GAudioSpeechWorker::GAudioSpeechWorker(QObject* parent) : QThread(parent),
+    cache(DEFAULT_CACHE_SIZE),
+    stopRequested(false),
+    voice(NULL)
+{
+}
+
+GAudioSpeechWorker::~GAudioSpeechWorker()
+{
+    stop();
+    wait();
+}
+
+void GAudioSpeechWorker::enqueue(const QString& text, int priority)
+{
+    if (text.isEmpty()) return;
+    QMutexLocker locker(&mutex);
+    insert(Phrase(text, qBound((int)PRIORITY_NORMAL, priority, (int)PRIORITY_EMERGENCY)));
+    queued.wakeOne();
+}
+
+void GAudioSpeechWorker::prewarm(const QStringList& phrases)
+{
+    QMutexLocker locker(&mutex);
+    foreach (const QString& text, phrases)
+    {
+        if (!text.isEmpty() && !cache.contains(text))
+        {
+            insert(Phrase(text, PRIORITY_PREWARM));
+        }
+    }
+    queued.wakeOne();
+}
+
+void GAudioSpeechWorker::clear()
+{
+    QMutexLocker locker(&mutex);
+    queue.clear();
+}
+
+void GAudioSpeechWorker::stop()
+{
+    QMutexLocker locker(&mutex);
+    stopRequested = true;
+    queued.wakeAll();
+}
+
+void GAudioSpeechWorker::setCacheSize(int kilobytes)
+{
+    QMutexLocker locker(&mutex);
+    cache.setMaxCost(kilobytes);
+}
+
+bool GAudioSpeechWorker::isCached(const QString& text)
+{
+    QMutexLocker locker(&mutex);
+    return cache.contains(text);
+}
+
+int GAudioSpeechWorker::getQueueLength()
+{
+    QMutexLocker locker(&mutex);
+    return queue.size();
+}
+
+GAudioSpeechWorker::Statistics GAudioSpeechWorker::getStatistics()
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
+
+void GAudioSpeechWorker::insert(const Phrase& phrase)
+{
+    // A phrase already waiting is spoken once, at the higher priority
+    for (int i = 0; i < queue.size(); i++)
+    {
+        if (queue.at(i).text == phrase.text)
+        {
+            if (queue.at(i).priority >= phrase.priority) return;
+            queue.removeAt(i);
+            break;
+        }
+    }
+
+    // Behind all phrases of the same or a higher priority
+    int position = queue.size();
+    for (int i = 0; i < queue.size(); i++)
+    {
+        if (queue.at(i).priority < phrase.priority)
+        {
+            position = i;
+            break;
+        }
+    }
+    queue.insert(position, phrase);
+
+    // Drop the oldest phrase of the lowest priority if too many are waiting
+    int spokenCount = 0;
+    int lowest = PRIORITY_EMERGENCY;
+    for (int i = 0; i < queue.size(); i++)
+    {
+        if (queue.at(i).priority == PRIORITY_PREWARM) continue;
+        spokenCount++;
+        lowest = qMin(lowest, queue.at(i).priority);
+    }
+    if (spokenCount > MAX_QUEUE_LENGTH)
+    {
+        for (int i = 0; i < queue.size(); i++)
+        {
+            if (queue.at(i).priority == lowest)
+            {
+                QLOG_DEBUG() << "Speech queue full, dropping" << queue.at(i).text;
+                queue.removeAt(i);
+                stats.dropped++;
+                break;
+            }
+        }
+    }
+}
+
+void GAudioSpeechWorker::run()
+{
+    forever
+    {
+        Phrase phrase;
+        Waveform wave;
+        bool cached = false;
+        {
+            QMutexLocker locker(&mutex);
+            while (queue.isEmpty() && !stopRequested)
+            {
+                queued.wait(&mutex);
+            }
+            if (stopRequested) return;
+            phrase = queue.takeFirst();
+
+            Waveform* entry = cache.object(phrase.text);
+            if (entry)
+            {
+                wave = *entry;
+                cached = true;
+                if (phrase.priority != PRIORITY_PREWARM) stats.cacheHits++;
+            }
+        }
+
+        if (!cached)
+        {
+            if (!synthesize(phrase.text, wave))
+            {
+                QLOG_WARN() << "Speech synthesis failed for" << phrase.text;
+                continue;
+            }
+            QMutexLocker locker(&mutex);
+            stats.synthesized++;
+            cache.insert(phrase.text, new Waveform(wave), qMax(1, wave.samples.size() / 1024));
+        }
+
+        if (phrase.priority == PRIORITY_PREWARM) continue;
+
+        play(phrase.text, wave);
+        {
+            QMutexLocker locker(&mutex);
+            stats.spoken++;
+        }
+        emit spoken(phrase.text);
+    }
+}
+
+bool GAudioSpeechWorker::synthesize(const QString& text, Waveform& wave)
+{
+#ifdef Q_OS_LINUX
+    if (!voice)
+    {
+        // Registering loads the lexicon, done once and only by this thread
+        flite_init();
+        voice = register_cmu_us_kal(NULL);
+    }
+    cst_wave* wav = flite_text_to_wave(text.toStdString().c_str(), static_cast<cst_voice*>(voice));
+    if (!wav) return false;
+    wave.sampleRate = wav->sample_rate;
+    wave.channels = wav->num_channels;
+    wave.samples = QByteArray(reinterpret_cast<const char*>(wav->samples),
+                              wav->num_samples * wav->num_channels * sizeof(short));
+    delete_wave(wav);
+    return true;
+#else
+    // The other platforms speak the text directly
+    Q_UNUSED(text);
+    Q_UNUSED(wave);
+    return true;
+#endif
+}
+
+void GAudioSpeechWorker::play(const QString& text, const Waveform& wave)
+{
+#ifdef Q_OS_LINUX
+    Q_UNUSED(text);
+    if (wave.samples.isEmpty() || wave.channels < 1) return;
+    cst_wave* wav = new_wave();
+    cst_wave_resize(wav, wave.samples.size() / (sizeof(short) * wave.channels), wave.channels);
+    wav->sample_rate = wave.sampleRate;
+    memcpy(wav->samples, wave.samples.constData(), wave.samples.size());
+    play_wave(wav);
+    delete_wave(wav);
+#elif defined(Q_OS_MAC)
+    Q_UNUSED(wave);
+    // Slashes necessary to have the right start to the sentence
+    // copying data prevents SpeakString from reading additional chars
+    QString spoken = "\\" + text;
+    QByteArray ascii = spoken.toAscii();
+    unsigned char str2[1024] = {};
+    memcpy(str2, ascii.constData(), qMin(ascii.size(), (int)sizeof(str2) - 1));
+    SpeakString(str2);
+#else
+    Q_UNUSED(text);
+    Q_UNUSED(wave);
+#endif
+}
@@ -0,0 +1,129 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Speech synthesis and playback in a background thread
+ */
+
+#ifndef GAUDIOSPEECHWORKER_H
+#define GAUDIOSPEECHWORKER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QCache>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+/**
+ * Speaks the phrases queued by GAudioOutput one after the other, so neither
+ * the synthesis nor the playback runs on the thread that asked for it.
+ *
+ * The queue is ordered by priority, an emergency phrase is spoken before
+ * everything queued before it. A phrase that is already waiting is not
+ * queued twice. The synthesized waveforms are kept in a cache with the
+ * least recently used ones dropped first, so announcements that recur
+ * during a flight (modes, arming, battery) are synthesized only once.
+ * prewarm() fills the cache while nothing else is queued.
+ */
+class GAudioSpeechWorker : public QThread
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        PRIORITY_PREWARM = 0,       ///< Synthesize into the cache, do not play
+        PRIORITY_NORMAL = 1,
+        PRIORITY_ALERT = 2,
+        PRIORITY_EMERGENCY = 3
+    };
+
+    enum {
+        MAX_QUEUE_LENGTH = 16,      ///< Spoken phrases waiting, the oldest of the lowest priority is dropped beyond
+        DEFAULT_CACHE_SIZE = 16384  ///< Kilobytes of waveforms kept
+    };
+
+    /** @brief Synthesized speech, 16 bit signed samples */
+    struct Waveform {
+        Waveform() : sampleRate(0), channels(1) {}
+        int sampleRate;
+        int channels;
+        QByteArray samples;
+    };
+
+    struct Statistics {
+        Statistics() : spoken(0), synthesized(0), cacheHits(0), dropped(0) {}
+        quint64 spoken;
+        quint64 synthesized;
+        quint64 cacheHits;
+        quint64 dropped;            ///< Phrases dropped from a full queue
+    };
+
+    GAudioSpeechWorker(QObject* parent = 0);
+    ~GAudioSpeechWorker();
+
+    /** @brief Queue a phrase, thread safe */
+    void enqueue(const QString& text, int priority = PRIORITY_NORMAL);
+    /** @brief Synthesize phrases into the cache when the queue is idle */
+    void prewarm(const QStringList& phrases);
+    /** @brief Drop all queued phrases */
+    void clear();
+    /** @brief Stop the thread after the current phrase */
+    void stop();
+
+    /** @brief Size of the waveform cache in kilobytes */
+    void setCacheSize(int kilobytes);
+    bool isCached(const QString& text);
+    int getQueueLength();
+    Statistics getStatistics();
+
+signals:
+    /** @brief A phrase was played, emitted from the worker thread */
+    void spoken(const QString& text);
+
+protected:
+    struct Phrase {
+        Phrase(const QString& text = QString(), int priority = PRIORITY_NORMAL) : text(text), priority(priority) {}
+        QString text;
+        int priority;
+    };
+
+    void run();
+    /** @brief Insert keeping the queue ordered by priority, the caller holds the mutex */
+    void insert(const Phrase& phrase);
+    /** @brief Create the waveform of a phrase, called from the worker thread */
+    virtual bool synthesize(const QString& text, Waveform& wave);
+    /** @brief Play a waveform and return when done, called from the worker thread */
+    virtual void play(const QString& text, const Waveform& wave);
+
+    QList<Phrase> queue;
+    QCache<QString, Waveform> cache;
+    Statistics stats;
+    QMutex mutex;                   ///< Guards queue, cache and stats
+    QWaitCondition queued;
+    bool stopRequested;
+    void* voice;                    ///< flite voice, registered once by the worker thread
+};
+
+#endif // GAUDIOSPEECHWORKER_H
@@ -34,6 +34,7 @@ This file is part of the PIXHAWK project
 #define _MG_H_
 
 #include <QDateTime>
+#include "QGCTimebase.h"
 
 #include <QDir>
 #include <QThread>
@@ -290,14 +291,10 @@ public:
      * 1.1.1970, 00:00 UTC.
      *
      * @return The number of milliseconds elapsed since unix epoch
-     * @deprecated Will the replaced by time helper class
+     * @deprecated Use QGC::groundTimeMilliseconds()
      **/
     static quint64 getGroundTimeNow() {
-        QDateTime time = QDateTime::currentDateTime();
-        time = time.toUTC();
-        /* Return seconds and milliseconds, in milliseconds unit */
-        quint64 milliseconds = time.toTime_t() * static_cast<quint64>(1000);
-        return static_cast<quint64>(milliseconds + time.time().msec());
+        return QGCTimebase::instance()->groundTimeMilliseconds();
     }
 
     /**
@@ -308,14 +305,10 @@ public:
      * 1.1.1970, 00:00 UTC.
      *
      * @return The number of milliseconds elapsed since unix epoch
-     * @deprecated Will the replaced by time helper class
+     * @deprecated Use QGC::groundTimeUsecs()
      **/
     static quint64 getGroundTimeNowUsecs() {
-        QDateTime time = QDateTime::currentDateTime();
-        time = time.toUTC();
-        /* Return seconds and milliseconds, in milliseconds unit */
-        quint64 microseconds = time.toTime_t() * static_cast<quint64>(1000000);
-        return static_cast<quint64>(microseconds + (time.time().msec()*1000));
+        return QGCTimebase::instance()->groundTimeUsecs();
     }
 
     /*tatic quint64 getMissionTimeUsecs()
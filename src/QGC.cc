@@ -22,6 +22,7 @@ This file is part of the QGROUNDCONTROL project
 ======================================================================*/
 
 #include "QGC.h"
+#include "QGCTimebase.h"
 #include <qmath.h>
 #include <float.h>
 
@@ -30,29 +31,17 @@ namespace QGC
 
 quint64 groundTimeUsecs()
 {
-    QDateTime time = QDateTime::currentDateTime();
-    time = time.toUTC();
-    /* Return seconds and milliseconds, in milliseconds unit */
-    quint64 microseconds = time.toTime_t() * static_cast<quint64>(1000000);
-    return static_cast<quint64>(microseconds + (time.time().msec()*1000));
+    return QGCTimebase::instance()->groundTimeUsecs();
 }
 
 quint64 groundTimeMilliseconds()
 {
-    QDateTime time = QDateTime::currentDateTime();
-    time = time.toUTC();
-    /* Return seconds and milliseconds, in milliseconds unit */
-    quint64 seconds = time.toTime_t() * static_cast<quint64>(1000);
-    return static_cast<quint64>(seconds + (time.time().msec()));
+    return QGCTimebase::instance()->groundTimeMilliseconds();
 }
 
 qreal groundTimeSeconds()
 {
-    QDateTime time = QDateTime::currentDateTime();
-    time = time.toUTC();
-    /* Return time in seconds unit */
-    quint64 seconds = time.toTime_t();
-    return static_cast<qreal>(seconds + (time.time().msec() / 1000.0));
+    return static_cast<qreal>(QGCTimebase::instance()->groundTimeUsecs() / 1000000.0);
 }
 
 float limitAngleToPMPIf(float angle)
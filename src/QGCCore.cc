@@ -35,12 +35,14 @@ This file is part of the QGROUNDCONTROL project
 #include "QGC.h"
 #include "MainWindow.h"
 #include "GAudioOutput.h"
+#include "QGCStartupTimer.h"
 
 #ifdef OPAL_RT
 #include "OpalLink.h"
 #endif
 #include "UDPLink.h"
 #include "MAVLinkSimulationLink.h"
+#include "MAVLinkLoadLink.h"
 #include "SerialLink.h"
 
 #include <QFile>
@@ -69,6 +71,8 @@ This file is part of the QGROUNDCONTROL project
 QGCCore::QGCCore(int &argc, char* argv[]) : QApplication(argc, argv)
 {
         m_mouseWheelFilter = new QGCMouseWheelEventFilter(this);
+        // Report the construction time of each part of the user interface: --startup-timing
+        QGCStartupTimer::instance()->setEnabled(arguments().contains("--startup-timing"));
 }
 
 void QGCCore::initialize()
@@ -144,11 +148,17 @@ void QGCCore::initialize()
 
     // Start the comm link manager
     splashScreen->showMessage(tr("Starting Communication Links"), Qt::AlignLeft | Qt::AlignBottom, QColor(62, 93, 141));
-    startLinkManager();
+    {
+        QGCStartupTimer::Scope timing("Link manager");
+        startLinkManager();
+    }
 
     // Start the UAS Manager
     splashScreen->showMessage(tr("Starting UAS Manager"), Qt::AlignLeft | Qt::AlignBottom, QColor(62, 93, 141));
-    startUASManager();
+    {
+        QGCStartupTimer::Scope timing("UAS manager");
+        startUASManager();
+    }
 
     // Start the user interface
     splashScreen->showMessage(tr("Starting User Interface"), Qt::AlignLeft | Qt::AlignBottom, QColor(62, 93, 141));
@@ -176,10 +186,31 @@ void QGCCore::initialize()
     SerialLink *slink = new SerialLink();
     MainWindow::instance()->addLink(slink);
 
-    mainWindow = MainWindow::instance(splashScreen);
+    // Synthetic telemetry for load tests and profiling:
+    // --load-test <vehicles> <messages per second> [--load-seed n] [--load-loss p] [--load-corrupt p]
+    const QStringList args = arguments();
+    int loadIndex = args.indexOf("--load-test");
+    if (loadIndex >= 0 && loadIndex + 2 < args.size())
+    {
+        int seedIndex = args.indexOf("--load-seed");
+        int lossIndex = args.indexOf("--load-loss");
+        int corruptIndex = args.indexOf("--load-corrupt");
+        quint32 seed = (seedIndex >= 0 && seedIndex + 1 < args.size()) ? args.at(seedIndex + 1).toUInt() : 1;
+        MAVLinkLoadLink* loadLink = new MAVLinkLoadLink(args.at(loadIndex + 1).toInt(), args.at(loadIndex + 2).toInt(), seed);
+        if (lossIndex >= 0 && lossIndex + 1 < args.size()) loadLink->setLossProbability(args.at(lossIndex + 1).toDouble());
+        if (corruptIndex >= 0 && corruptIndex + 1 < args.size()) loadLink->setCorruptionProbability(args.at(corruptIndex + 1).toDouble());
+        MainWindow::instance()->addLink(loadLink);
+        loadLink->connect();
+    }
+
+    {
+        QGCStartupTimer::Scope timing("Main window");
+        mainWindow = MainWindow::instance(splashScreen);
+    }
 
     // Remove splash screen
     splashScreen->finish(mainWindow);
+    QGCStartupTimer::instance()->logReport();
 
     if (upgraded) mainWindow->showInfoMessage(tr("Default Settings Loaded"),
                                               tr("APM Planner has been upgraded from version %1 to version %2. Some of your user preferences have been reset to defaults for safety reasons. Please adjust them where needed.").arg(lastApplicationVersion).arg(QGC_APPLICATION_VERSION));
@@ -0,0 +1,118 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Construction times of the application start and the lazily built views
+ */
+
+#include "QGCStartupTimer.h"
+#include "QsLog.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+
+QGCStartupTimer::Scope::Scope(const QString& name, QGCStartupTimer* timer) :
+    timer(timer ? timer : QGCStartupTimer::instance())
+{
+    index = this->timer->begin(name);
+}
+
+QGCStartupTimer::Scope::~Scope()
+{
+    timer->end(index);
+}
+
+QGCStartupTimer::QGCStartupTimer() :
+    depth(0),
+    enabled(false)
+{
+    clock.start();
+}
+
+QGCStartupTimer* QGCStartupTimer::instance()
+{
+    static QGCStartupTimer timer;
+    return &timer;
+}
+
+void QGCStartupTimer::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+int QGCStartupTimer::begin(const QString& name)
+{
+    QMutexLocker locker(&mutex);
+    Entry entry;
+    entry.name = name;
+    entry.startUs = getElapsedUs();
+    entry.durationUs = -1;
+    entry.depth = depth++;
+    entries.append(entry);
+    return entries.size() - 1;
+}
+
+void QGCStartupTimer::end(int index)
+{
+    QMutexLocker locker(&mutex);
+    if (index < 0 || index >= entries.size()) return;
+    Entry& entry = entries[index];
+    if (entry.durationUs >= 0) return;
+    entry.durationUs = getElapsedUs() - entry.startUs;
+    depth = entry.depth;
+    if (enabled)
+    {
+        QLOG_INFO() << "Startup timing:" << entry.name << "took" << entry.durationUs / 1000.0 << "ms";
+    }
+}
+
+QList<QGCStartupTimer::Entry> QGCStartupTimer::getEntries()
+{
+    QMutexLocker locker(&mutex);
+    return entries;
+}
+
+QString QGCStartupTimer::getReport()
+{
+    QStringList lines;
+    lines << QString("%1 %2  %3").arg("start ms", 10).arg("took ms", 10).arg("part");
+    foreach (const Entry& entry, getEntries())
+    {
+        QString duration = entry.durationUs < 0 ? QString("-") : QString::number(entry.durationUs / 1000.0, 'f', 1);
+        lines << QString("%1 %2  %3%4")
+                 .arg(QString::number(entry.startUs / 1000.0, 'f', 1), 10)
+                 .arg(duration, 10)
+                 .arg(QString(entry.depth * 2, ' '))
+                 .arg(entry.name);
+    }
+    return lines.join("\n");
+}
+
+void QGCStartupTimer::logReport()
+{
+    if (!enabled) return;
+    foreach (const QString& line, getReport().split("\n"))
+    {
+        QLOG_INFO() << "Startup timing:" << line;
+    }
+}
@@ -0,0 +1,92 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Construction times of the application start and the lazily built views
+ */
+
+#ifndef QGCSTARTUPTIMER_H
+#define QGCSTARTUPTIMER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+/**
+ * Collects how long each part of the user interface took to construct,
+ * relative to the start of the application. The entries are always
+ * recorded, the report is only logged if enabled with --startup-timing.
+ */
+class QGCStartupTimer
+{
+public:
+    struct Entry {
+        QString name;
+        qint64 startUs;     ///< Start of the construction since the application start
+        qint64 durationUs;  ///< Construction time
+        int depth;          ///< Number of enclosing scopes
+    };
+
+    /** @brief Times the construction of one part for the lifetime of the scope */
+    class Scope
+    {
+    public:
+        Scope(const QString& name, QGCStartupTimer* timer = 0);
+        ~Scope();
+    private:
+        QGCStartupTimer* timer;
+        int index;
+    };
+
+    QGCStartupTimer();
+
+    static QGCStartupTimer* instance();
+
+    /** @brief Log every entry as it is recorded and the report on logReport() */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    /** @brief Time since the application start in microseconds */
+    qint64 getElapsedUs() const { return clock.nsecsElapsed() / 1000; }
+
+    /** @brief Start an entry, returns its index for end() */
+    int begin(const QString& name);
+    /** @brief Finish the entry begun with begin() */
+    void end(int index);
+
+    QList<Entry> getEntries();
+    /** @brief One line per entry, nested entries are indented */
+    QString getReport();
+    /** @brief Log the report if enabled */
+    void logReport();
+
+protected:
+    QElapsedTimer clock;
+    QList<Entry> entries;
+    int depth;
+    bool enabled;
+    QMutex mutex;
+};
+
+#endif // QGCSTARTUPTIMER_H
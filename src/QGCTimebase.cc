@@ -0,0 +1,253 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Monotonic ground time and the alignment of the vehicle clocks to it
+ */
+
+#include "QGCTimebase.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace
+{
+// Onboard times from this value on are Unix time: no system runs 40 years
+// without reboot. In milliseconds: 40 * 365 * 24 * 60 * 60 * 1000
+const quint64 UNIX_TIME_MIN_MS = Q_UINT64_C(1261440000000);
+// A boot time this much earlier than the latest one is a reboot
+const quint64 REBOOT_TOLERANCE_MS = 100;
+// Onboard time over which the least delayed sample is taken for the drift
+const quint64 DRIFT_WINDOW_MS = 10000;
+// Weight of a new window in the drift estimate
+const double DRIFT_GAIN = 0.25;
+// Crystal clocks are better than 1000 ppm, a steeper slope is a delay change
+const double MAX_DRIFT = 0.001;
+// An onboard Unix time this much behind the estimate has been set again
+const qint64 UNIX_JUMP_MS = 1000;
+
+quint64 groundOf(quint64 bootMs, quint64 referenceMs, double offsetMs, double drift)
+{
+    double ground = (double)bootMs + offsetMs + drift * ((double)bootMs - (double)referenceMs);
+    return ground > 0 ? (quint64)(ground + 0.5) : 0;
+}
+
+void addSample(QGCTimebase::Alignment& a, quint64 bootMs, double groundMs)
+{
+    double observed = groundMs - (double)bootMs;
+    a.samples++;
+    if (!a.valid)
+    {
+        a.valid = true;
+        a.lastBootMs = bootMs;
+        a.referenceMs = bootMs;
+        a.offsetMs = observed;
+        a.windowStartMs = bootMs;
+        a.windowBootMs = bootMs;
+        a.windowOffsetMs = observed;
+        return;
+    }
+    if (bootMs > a.lastBootMs) a.lastBootMs = bootMs;
+
+    // A sample delayed less than the estimate moves the offset down to it
+    double predicted = a.offsetMs + a.drift * ((double)bootMs - (double)a.referenceMs);
+    if (observed < predicted)
+    {
+        a.offsetMs = observed;
+        a.referenceMs = bootMs;
+    }
+
+    if (observed < a.windowOffsetMs)
+    {
+        a.windowOffsetMs = observed;
+        a.windowBootMs = bootMs;
+    }
+    if (bootMs < a.windowStartMs + DRIFT_WINDOW_MS) return;
+
+    // The least delayed samples of two windows give the drift
+    if (a.hasPoint && a.windowBootMs > a.pointBootMs)
+    {
+        double slope = (a.windowOffsetMs - a.pointOffsetMs) / ((double)a.windowBootMs - (double)a.pointBootMs);
+        slope = qBound(-MAX_DRIFT, slope, MAX_DRIFT);
+        a.drift += (slope - a.drift) * DRIFT_GAIN;
+        a.offsetMs = a.windowOffsetMs;
+        a.referenceMs = a.windowBootMs;
+    }
+    a.hasPoint = true;
+    a.pointBootMs = a.windowBootMs;
+    a.pointOffsetMs = a.windowOffsetMs;
+    a.windowStartMs = bootMs;
+    a.windowBootMs = bootMs;
+    a.windowOffsetMs = observed;
+}
+}
+
+QGCTimebase::Alignment::Alignment() :
+    valid(false),
+    lastBootMs(0),
+    referenceMs(0),
+    offsetMs(0),
+    drift(0),
+    windowStartMs(0),
+    windowBootMs(0),
+    windowOffsetMs(0),
+    hasPoint(false),
+    pointBootMs(0),
+    pointOffsetMs(0),
+    hasUnixTime(false),
+    unixOffsetMs(0),
+    samples(0),
+    reboots(0)
+{
+}
+
+quint64 QGCTimebase::Alignment::toGround(quint64 bootMs) const
+{
+    return groundOf(bootMs, referenceMs, offsetMs, drift);
+}
+
+QGCTimebase::Snapshot::Snapshot() :
+    valid(false),
+    referenceMs(0),
+    offsetMs(0),
+    drift(0),
+    hasUnixTime(false),
+    unixOffsetMs(0)
+{
+}
+
+QGCTimebase::QGCTimebase()
+{
+    clock.start();
+    epochUsecs = QDateTime::currentMSecsSinceEpoch() * Q_UINT64_C(1000);
+}
+
+QGCTimebase* QGCTimebase::instance()
+{
+    static QGCTimebase timebase;
+    return &timebase;
+}
+
+void QGCTimebase::addBootTime(int sysid, quint64 bootMs, quint64 groundUsecs)
+{
+    if (sysid < 0 || sysid > 255 || bootMs >= UNIX_TIME_MIN_MS) return;
+    QMutexLocker locker(&mutex);
+    Alignment& a = alignments[sysid];
+    if (a.valid && bootMs + REBOOT_TOLERANCE_MS < a.lastBootMs)
+    {
+        // The onboard clock started again, so did its Unix time
+        int reboots = a.reboots + 1;
+        a = Alignment();
+        a.reboots = reboots;
+    }
+    addSample(a, bootMs, groundUsecs / 1000.0);
+    publish(sysid);
+}
+
+void QGCTimebase::addUnixTime(int sysid, quint64 unixUsecs, quint64 groundUsecs)
+{
+    if (sysid < 0 || sysid > 255 || unixUsecs == 0) return;
+    qint64 observed = (qint64)((unixUsecs + 500) / 1000) - (qint64)(groundUsecs / 1000);
+    QMutexLocker locker(&mutex);
+    Alignment& a = alignments[sysid];
+    // The least delayed sample has the largest offset
+    if (!a.hasUnixTime || observed > a.unixOffsetMs || observed < a.unixOffsetMs - UNIX_JUMP_MS)
+    {
+        a.hasUnixTime = true;
+        a.unixOffsetMs = observed;
+        publish(sysid);
+    }
+}
+
+quint64 QGCTimebase::toGroundMilliseconds(int sysid, quint64 onboardMs)
+{
+    if (onboardMs == 0 || sysid < 0 || sysid > 255) return groundTimeMilliseconds();
+    Snapshot s = readSnapshot(sysid);
+    if (onboardMs >= UNIX_TIME_MIN_MS)
+    {
+        return s.hasUnixTime ? (quint64)((qint64)onboardMs - s.unixOffsetMs) : onboardMs;
+    }
+    if (s.valid)
+    {
+        return groundOf(onboardMs, s.referenceMs, s.offsetMs, s.drift);
+    }
+
+    QMutexLocker locker(&mutex);
+    Alignment& a = alignments[sysid];
+    if (!a.valid)
+    {
+        // No frame of this vehicle was stamped, take this time as arrived now
+        addSample(a, onboardMs, groundTimeUsecs() / 1000.0);
+        publish(sysid);
+    }
+    return a.toGround(onboardMs);
+}
+
+QGCTimebase::Alignment QGCTimebase::getAlignment(int sysid)
+{
+    if (sysid < 0 || sysid > 255) return Alignment();
+    QMutexLocker locker(&mutex);
+    return alignments[sysid];
+}
+
+void QGCTimebase::reset(int sysid)
+{
+    if (sysid < 0 || sysid > 255) return;
+    QMutexLocker locker(&mutex);
+    alignments[sysid] = Alignment();
+    publish(sysid);
+}
+
+void QGCTimebase::publish(int sysid)
+{
+    const Alignment& a = alignments[sysid];
+    snapshotVersions[sysid].fetchAndAddOrdered(1);
+    Snapshot& s = snapshots[sysid];
+    s.valid = a.valid;
+    s.referenceMs = a.referenceMs;
+    s.offsetMs = a.offsetMs;
+    s.drift = a.drift;
+    s.hasUnixTime = a.hasUnixTime;
+    s.unixOffsetMs = a.unixOffsetMs;
+    snapshotVersions[sysid].fetchAndAddOrdered(1);
+}
+
+QGCTimebase::Snapshot QGCTimebase::readSnapshot(int sysid)
+{
+    // fetchAndAdd(0) is the atomic load of the Qt 4 and Qt 5 API
+    forever
+    {
+        int version = snapshotVersions[sysid].fetchAndAddOrdered(0);
+        if ((version & 1) == 0)
+        {
+            Snapshot s = snapshots[sysid];
+            if (snapshotVersions[sysid].fetchAndAddOrdered(0) == version) return s;
+        }
+        else
+        {
+            // A writer is in the middle of publish(), it takes a few instructions
+            QThread::yieldCurrentThread();
+        }
+    }
+}
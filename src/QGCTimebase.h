@@ -0,0 +1,127 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Monotonic ground time and the alignment of the vehicle clocks to it
+ */
+
+#ifndef QGCTIMEBASE_H
+#define QGCTIMEBASE_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QtGlobal>
+
+/**
+ * The one clock of the ground station. Ground time counts microseconds
+ * since the Unix epoch, it is read from the monotonic clock and anchored
+ * to the wall clock once at start, so it is cheap to read and never jumps
+ * when the system time is adjusted.
+ *
+ * The frames are stamped with the ground time as they arrive at the link.
+ * Every frame carrying the onboard boot time is a sample of the offset
+ * between the clocks of that vehicle and the ground; the least delayed
+ * samples give the offset and their slope over time the drift. Onboard
+ * Unix time (SYSTEM_TIME) is aligned by its offset to the ground time.
+ *
+ * The samples update the alignments under a mutex. Every update publishes
+ * a snapshot of the offsets, which toGroundMilliseconds() reads without
+ * locking; it is called for every stamped frame from the link threads.
+ */
+class QGCTimebase
+{
+public:
+    /** @brief Alignment of the clock of one vehicle to the ground time */
+    struct Alignment {
+        Alignment();
+        /** @brief Ground time in milliseconds of an onboard boot time */
+        quint64 toGround(quint64 bootMs) const;
+
+        bool valid;             ///< A boot time has been seen
+        quint64 lastBootMs;     ///< Latest boot time, a much earlier one is a reboot
+        quint64 referenceMs;    ///< Boot time the offset refers to
+        double offsetMs;        ///< Ground minus boot time of the least delayed sample
+        double drift;           ///< Ground milliseconds per onboard millisecond, minus one
+        quint64 windowStartMs;  ///< Boot time the current drift window started
+        quint64 windowBootMs;   ///< Boot time of the least offset in the window
+        double windowOffsetMs;  ///< Least offset in the window
+        bool hasPoint;          ///< The least offset of a complete window is known
+        quint64 pointBootMs;
+        double pointOffsetMs;
+        bool hasUnixTime;       ///< The vehicle sent its Unix time
+        qint64 unixOffsetMs;    ///< Onboard Unix minus ground time
+        quint64 samples;        ///< Boot times seen
+        int reboots;
+    };
+
+    QGCTimebase();
+
+    static QGCTimebase* instance();
+
+    /** @brief Ground time in microseconds since the Unix epoch */
+    quint64 groundTimeUsecs() const { return epochUsecs + clock.nsecsElapsed() / 1000; }
+    /** @brief Ground time in milliseconds since the Unix epoch */
+    quint64 groundTimeMilliseconds() const { return groundTimeUsecs() / 1000; }
+
+    /** @brief Onboard boot time of a frame that arrived at groundUsecs */
+    void addBootTime(int sysid, quint64 bootMs, quint64 groundUsecs);
+    /** @brief Onboard Unix time of a frame that arrived at groundUsecs, zero if unknown onboard */
+    void addUnixTime(int sysid, quint64 unixUsecs, quint64 groundUsecs);
+
+    /**
+     * @brief Ground time in milliseconds of an onboard time, locks only for the first time of a vehicle
+     * @param onboardMs Boot or Unix time of the vehicle, zero for now
+     */
+    quint64 toGroundMilliseconds(int sysid, quint64 onboardMs);
+
+    Alignment getAlignment(int sysid);
+    /** @brief Forget the alignment of a vehicle */
+    void reset(int sysid);
+
+protected:
+    /** @brief The part of an alignment toGroundMilliseconds() reads */
+    struct Snapshot {
+        Snapshot();
+        bool valid;
+        quint64 referenceMs;
+        double offsetMs;
+        double drift;
+        bool hasUnixTime;
+        qint64 unixOffsetMs;
+    };
+
+    /** @brief Copy an alignment to its snapshot, called with the mutex locked */
+    void publish(int sysid);
+    /** @brief Consistent copy of a snapshot, retried while it is written */
+    Snapshot readSnapshot(int sysid);
+
+    QElapsedTimer clock;
+    quint64 epochUsecs;     ///< Ground time at the start of the clock
+    QMutex mutex;           ///< Guards the alignments and serializes the writers of the snapshots
+    Alignment alignments[256];
+    Snapshot snapshots[256];
+    QAtomicInt snapshotVersions[256];   ///< Odd while the snapshot is written
+};
+
+#endif // QGCTIMEBASE_H
@@ -28,7 +28,10 @@ This file is part of the QGROUNDCONTROL project
  */
 
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
+#include <QTextStream>
+#include <QtAlgorithms>
 #include <QPair>
 #include <QList>
 #include <QMap>
@@ -132,6 +135,13 @@ bool MAVLinkXMLParserV10::generate()
 
     process->terminate();
     process->kill();
+
+    // The C++ visitor is generated from the same XML, only possible
+    // if the document was loaded from a file with its includes
+    if (!fileName.isEmpty())
+    {
+        generateVisitor(fileName);
+    }
     return true;//result;
 }
 
@@ -146,3 +156,266 @@ void MAVLinkXMLParserV10::readStdErr()
     QString out = QString("<font color=\"red\">%1</font>").arg(QString(process->readAllStandardError()));
     emit parseState(out);
 }
+
+namespace
+{
+struct VisitorField
+{
+    QString name;
+    QString type;
+    int typeLength;
+    int arrayLength;
+    int wireOffset;
+};
+
+struct VisitorMessage
+{
+    QString name;
+    QList<VisitorField> fields;
+};
+
+bool visitorFieldLonger(const VisitorField& a, const VisitorField& b)
+{
+    return a.typeLength > b.typeLength;
+}
+
+/**
+ * Collect the messages of one definition file and of all files it includes,
+ * with the fields in wire order (sorted by type size like mavgen does).
+ */
+bool collectVisitorMessages(const QString& xmlFileName, QMap<int, VisitorMessage>& messages, QStringList& includes)
+{
+    QDomDocument document;
+    QFile file(xmlFileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text) || !document.setContent(&file))
+    {
+        return false;
+    }
+
+    QMap<QString, int> typeLengths;
+    typeLengths.insert("char", 1);
+    typeLengths.insert("uint8_t", 1);
+    typeLengths.insert("int8_t", 1);
+    typeLengths.insert("uint16_t", 2);
+    typeLengths.insert("int16_t", 2);
+    typeLengths.insert("uint32_t", 4);
+    typeLengths.insert("int32_t", 4);
+    typeLengths.insert("uint64_t", 8);
+    typeLengths.insert("int64_t", 8);
+    typeLengths.insert("float", 4);
+    typeLengths.insert("double", 8);
+
+    QDomElement root = document.documentElement();
+    for (QDomElement include = root.firstChildElement("include"); !include.isNull(); include = include.nextSiblingElement("include"))
+    {
+        QString includeFileName = QFileInfo(xmlFileName).absoluteDir().filePath(include.text().trimmed());
+        includes.append(includeFileName);
+        QStringList nestedIncludes;
+        if (!collectVisitorMessages(includeFileName, messages, nestedIncludes))
+        {
+            return false;
+        }
+    }
+
+    QDomElement messageList = root.firstChildElement("messages");
+    for (QDomElement m = messageList.firstChildElement("message"); !m.isNull(); m = m.nextSiblingElement("message"))
+    {
+        VisitorMessage message;
+        message.name = m.attribute("name").toUpper();
+        for (QDomElement f = m.firstChildElement("field"); !f.isNull(); f = f.nextSiblingElement("field"))
+        {
+            VisitorField field;
+            field.name = f.attribute("name");
+            field.type = f.attribute("type");
+            field.arrayLength = 0;
+            field.wireOffset = 0;
+            if (field.type == "uint8_t_mavlink_version")
+            {
+                field.type = "uint8_t";
+            }
+            int bracket = field.type.indexOf('[');
+            if (bracket != -1)
+            {
+                field.arrayLength = field.type.mid(bracket + 1, field.type.length() - bracket - 2).toInt();
+                field.type = field.type.left(bracket);
+                if (field.type == "array") field.type = "int8_t";
+            }
+            if (!typeLengths.contains(field.type) && typeLengths.contains(field.type + "_t"))
+            {
+                field.type += "_t";
+            }
+            if (!typeLengths.contains(field.type))
+            {
+                return false;
+            }
+            field.typeLength = typeLengths.value(field.type);
+            message.fields.append(field);
+        }
+
+        // MAVLink 1.0 puts the largest types first, in definition order
+        qStableSort(message.fields.begin(), message.fields.end(), visitorFieldLonger);
+        int offset = 0;
+        for (int i = 0; i < message.fields.size(); ++i)
+        {
+            message.fields[i].wireOffset = offset;
+            offset += message.fields[i].typeLength * qMax(1, message.fields[i].arrayLength);
+        }
+        messages.insert(m.attribute("id").toInt(), message);
+    }
+    return true;
+}
+}
+
+/**
+ * Generate mavlink_msg_visitor.hpp next to the C headers of the dialect.
+ * It provides compile time field accessors and a visitor that unpacks all
+ * fields of a message into typed calls, so decoders do not have to walk
+ * MAVLINK_MESSAGE_INFO and compare field names at runtime.
+ *
+ * generator/mavgen_visitor.py writes the same file from the generated C
+ * headers, it keeps the visitors in libs/mavlink up to date without the
+ * XML definitions. Change both when changing the output.
+ */
+bool MAVLinkXMLParserV10::generateVisitor(const QString& xmlFileName)
+{
+    QMap<int, VisitorMessage> messages;
+    QStringList includes;
+    if (!collectVisitorMessages(xmlFileName, messages, includes))
+    {
+        emit parseState(tr("<font color=\"red\">Could not read %1 for the message visitor</font>").arg(xmlFileName));
+        return false;
+    }
+
+    QString baseName = QFileInfo(xmlFileName).completeBaseName();
+    QDir outputDir(outputDirName);
+    outputDir.mkpath(baseName);
+    QFile file(outputDir.filePath(baseName + "/mavlink_msg_visitor.hpp"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        emit parseState(tr("<font color=\"red\">Could not write %1</font>").arg(file.fileName()));
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "/** @file\n"
+        << " *\t@brief MAVLink typed message visitor built from " << baseName << ".xml\n"
+        << " *\t@see http://pixhawk.ethz.ch/software/mavlink\n"
+        << " */\n"
+        << "#ifndef MAVLINK_MSG_VISITOR_HPP\n"
+        << "#define MAVLINK_MSG_VISITOR_HPP\n"
+        << "\n"
+        << "#include \"mavlink.h\"\n"
+        << "\n"
+        << "/*\n"
+        << " * Typed access to every field of a message, with the wire offsets and\n"
+        << " * types resolved at compile time:\n"
+        << " *\n"
+        << " *   mavlink::message<MSGID>          number of fields and payload length\n"
+        << " *   mavlink::field<MSGID, FIELD>     type, wire offset and array length\n"
+        << " *   mavlink::get<MSGID, FIELD>(msg)  value of a field (or array entry)\n"
+        << " *   mavlink::visit(msg, visitor)     unpacks all fields into a visitor\n"
+        << " *\n"
+        << " * FIELD is the index of the field in MAVLINK_MESSAGE_INFO. A visitor\n"
+        << " * implements\n"
+        << " *\n"
+        << " *   void value(uint8_t field, T value);\n"
+        << " *   void element(uint8_t field, uint8_t index, T value);\n"
+        << " *   void text(uint8_t field, const char* text, uint8_t length);\n"
+        << " *\n"
+        << " * for T in char, int8_t .. uint64_t, float and double. value() is\n"
+        << " * called for single values, element() for every entry of an array and\n"
+        << " * text() for char arrays, which are not null terminated on the wire.\n"
+        << " */\n"
+        << "\n"
+        << "namespace mavlink {\n"
+        << "\n"
+        << "template <typename T> struct wire;\n";
+
+    QStringList wireTypes;
+    wireTypes << "char" << "int8_t" << "uint8_t" << "int16_t" << "uint16_t" << "int32_t"
+              << "uint32_t" << "int64_t" << "uint64_t" << "float" << "double";
+    foreach (const QString& type, wireTypes)
+    {
+        out << QString("template <> struct wire<%1> { static %1 get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_%1(msg, ofs); } };\n").arg(type);
+    }
+
+    out << "\n"
+        << "template <uint8_t MSGID> struct message;\n"
+        << "template <uint8_t MSGID, uint8_t FIELD> struct field;\n"
+        << "\n"
+        << "template <uint8_t MSGID, uint8_t FIELD>\n"
+        << "inline typename field<MSGID, FIELD>::type get(const mavlink_message_t* msg, uint8_t index = 0)\n"
+        << "{\n"
+        << "\ttypedef field<MSGID, FIELD> f;\n"
+        << "\treturn wire<typename f::type>::get(msg, f::wire_offset + index * sizeof(typename f::type));\n"
+        << "}\n";
+
+    QMap<int, VisitorMessage>::const_iterator i;
+    for (i = messages.constBegin(); i != messages.constEnd(); ++i)
+    {
+        const VisitorMessage& message = i.value();
+        QString ident = "MAVLINK_MSG_ID_" + message.name;
+        out << "\n"
+            << "/* " << message.name << " */\n"
+            << QString("template <> struct message<%1> { enum { num_fields = %2, length = %1_LEN }; };\n").arg(ident).arg(message.fields.size());
+        for (int f = 0; f < message.fields.size(); ++f)
+        {
+            const VisitorField& field = message.fields.at(f);
+            out << QString("template <> struct field<%1, %2> { typedef %3 type; enum { wire_offset = %4, array_length = %5 }; }; // %6\n")
+                   .arg(ident).arg(f).arg(field.type).arg(field.wireOffset).arg(field.arrayLength).arg(field.name);
+        }
+        out << "\n"
+            << "template <class Visitor>\n"
+            << "inline void visit_" << message.name.toLower() << "(const mavlink_message_t* msg, Visitor& visitor)\n"
+            << "{\n";
+        for (int f = 0; f < message.fields.size(); ++f)
+        {
+            const VisitorField& field = message.fields.at(f);
+            if (field.arrayLength == 0)
+            {
+                out << QString("\tvisitor.value(%1, get<%2, %1>(msg));\n").arg(f).arg(ident);
+            }
+            else if (field.type == "char")
+            {
+                out << QString("\tvisitor.text(%1, &_MAV_PAYLOAD(msg)[%2], %3);\n").arg(f).arg(field.wireOffset).arg(field.arrayLength);
+            }
+            else
+            {
+                out << QString("\tfor (uint8_t i = 0; i < %1; ++i) visitor.element(%2, i, get<%3, %2>(msg, i));\n").arg(field.arrayLength).arg(f).arg(ident);
+            }
+        }
+        out << "}\n";
+    }
+
+    out << "\n"
+        << "/** @brief Unpack all fields of a message, false if the message id is unknown */\n"
+        << "template <class Visitor>\n"
+        << "inline bool visit(const mavlink_message_t* msg, Visitor& visitor)\n"
+        << "{\n"
+        << "\tswitch (msg->msgid) {\n";
+    for (i = messages.constBegin(); i != messages.constEnd(); ++i)
+    {
+        out << "\tcase MAVLINK_MSG_ID_" << i.value().name << ":\n"
+            << "\t\tvisit_" << i.value().name.toLower() << "(msg, visitor);\n"
+            << "\t\treturn true;\n";
+    }
+    out << "\tdefault:\n"
+        << "\t\treturn false;\n"
+        << "\t}\n"
+        << "}\n"
+        << "\n"
+        << "} // namespace mavlink\n"
+        << "\n"
+        << "#endif // MAVLINK_MSG_VISITOR_HPP\n";
+    file.close();
+
+    emit parseState(tr("Generated message visitor %1").arg(file.fileName()));
+
+    // Every included dialect gets its own directory, like the C headers
+    bool result = true;
+    foreach (const QString& include, includes)
+    {
+        result &= generateVisitor(include);
+    }
+    return result;
+}
@@ -69,6 +69,9 @@ signals:
     void parseState(QString message);
 
 protected:
+    /** @brief Write the typed C++ message visitor of a dialect and its includes */
+    bool generateVisitor(const QString& xmlFileName);
+
 //    /** @brief Accumulate the X.25 CRC by adding one char at a time. */
 //    void crcAccumulate(uint8_t data, uint16_t *crcAccum);
 
@@ -0,0 +1,185 @@
+#!/usr/bin/env python
+'''
+generate mavlink_msg_visitor.hpp from the generated MAVLink C headers
+
+MAVLinkXMLParserV10::generateVisitor() writes the visitor while generating
+from the XML definitions. The definitions are not shipped with the headers
+in libs/mavlink, so the checked in visitors are produced by this script from
+the MAVLINK_MESSAGE_INFO tables of the C headers instead. Both write the
+same output for the same messages.
+
+Usage:
+    mavgen_visitor.py [--check] [dialect ...]
+
+Without dialects all dialects in libs/mavlink/include/mavlink/v1.0 that have
+a visitor are written. --check only compares and fails if a visitor differs.
+
+Released under GNU GPL version 3 or later
+'''
+
+import argparse, os, re, sys
+
+BASE = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                     '..', '..', '..', '..', 'libs', 'mavlink', 'include', 'mavlink', 'v1.0'))
+
+TYPES = {'CHAR': 'char', 'UINT8_T': 'uint8_t', 'INT8_T': 'int8_t', 'UINT16_T': 'uint16_t', 'INT16_T': 'int16_t',
+         'UINT32_T': 'uint32_t', 'INT32_T': 'int32_t', 'UINT64_T': 'uint64_t', 'INT64_T': 'int64_t',
+         'FLOAT': 'float', 'DOUBLE': 'double'}
+
+WIRE_TYPES = ['char', 'int8_t', 'uint8_t', 'int16_t', 'uint16_t', 'int32_t', 'uint32_t',
+              'int64_t', 'uint64_t', 'float', 'double']
+
+
+def message_headers(dialect):
+    '''the message headers of a dialect and of the dialects it includes'''
+    header = open(os.path.join(BASE, dialect, dialect + '.h')).read()
+    files = []
+    for include in re.findall(r'#include "\.\./(\w+)/\1\.h"', header):
+        files += message_headers(include)
+    files += [(dialect, f) for f in re.findall(r'#include "\./(mavlink_msg_\w+\.h)"', header)]
+    return files
+
+
+def read_messages(dialect):
+    '''(id, name, fields) of every message, fields in wire order as (name, type, array length, wire offset)'''
+    messages = {}
+    for directory, name in message_headers(dialect):
+        text = open(os.path.join(BASE, directory, name)).read()
+        info = re.search(r'#define MAVLINK_MESSAGE_INFO_(\w+) \{ \\\n\s*"(\w+)", \\\n\s*(\d+), \\\n(.*?)\n\}', text, re.S)
+        if info is None:
+            raise RuntimeError('no MAVLINK_MESSAGE_INFO in %s/%s' % (directory, name))
+        message = info.group(2)
+        msgid = int(re.search(r'#define MAVLINK_MSG_ID_%s (\d+)' % message, text).group(1))
+        fields = []
+        for f in re.finditer(r'\{ "(\w+)", (?:NULL|"[^"]*"), MAVLINK_TYPE_(\w+), (\d+), (\d+), offsetof', info.group(4)):
+            fields.append((f.group(1), TYPES[f.group(2)], int(f.group(3)), int(f.group(4))))
+        if len(fields) != int(info.group(3)):
+            raise RuntimeError('%s: expected %s fields, found %d' % (message, info.group(3), len(fields)))
+        messages[msgid] = (msgid, message, fields)
+    return [messages[msgid] for msgid in sorted(messages)]
+
+
+def generate(dialect):
+    '''the text of mavlink_msg_visitor.hpp, laid out like MAVLinkXMLParserV10::generateVisitor()'''
+    messages = read_messages(dialect)
+    o = []
+    w = o.append
+    w('/** @file')
+    w(' *\t@brief MAVLink typed message visitor built from %s.xml' % dialect)
+    w(' *\t@see http://pixhawk.ethz.ch/software/mavlink')
+    w(' */')
+    w('#ifndef MAVLINK_MSG_VISITOR_HPP')
+    w('#define MAVLINK_MSG_VISITOR_HPP')
+    w('')
+    w('#include "mavlink.h"')
+    w('')
+    w('/*')
+    w(' * Typed access to every field of a message, with the wire offsets and')
+    w(' * types resolved at compile time:')
+    w(' *')
+    w(' *   mavlink::message<MSGID>          number of fields and payload length')
+    w(' *   mavlink::field<MSGID, FIELD>     type, wire offset and array length')
+    w(' *   mavlink::get<MSGID, FIELD>(msg)  value of a field (or array entry)')
+    w(' *   mavlink::visit(msg, visitor)     unpacks all fields into a visitor')
+    w(' *')
+    w(' * FIELD is the index of the field in MAVLINK_MESSAGE_INFO. A visitor')
+    w(' * implements')
+    w(' *')
+    w(' *   void value(uint8_t field, T value);')
+    w(' *   void element(uint8_t field, uint8_t index, T value);')
+    w(' *   void text(uint8_t field, const char* text, uint8_t length);')
+    w(' *')
+    w(' * for T in char, int8_t .. uint64_t, float and double. value() is')
+    w(' * called for single values, element() for every entry of an array and')
+    w(' * text() for char arrays, which are not null terminated on the wire.')
+    w(' */')
+    w('')
+    w('namespace mavlink {')
+    w('')
+    w('template <typename T> struct wire;')
+    for t in WIRE_TYPES:
+        w('template <> struct wire<%s> { static %s get(const mavlink_message_t* msg, uint8_t ofs) { return _MAV_RETURN_%s(msg, ofs); } };' % (t, t, t))
+    w('')
+    w('template <uint8_t MSGID> struct message;')
+    w('template <uint8_t MSGID, uint8_t FIELD> struct field;')
+    w('')
+    w('template <uint8_t MSGID, uint8_t FIELD>')
+    w('inline typename field<MSGID, FIELD>::type get(const mavlink_message_t* msg, uint8_t index = 0)')
+    w('{')
+    w('\ttypedef field<MSGID, FIELD> f;')
+    w('\treturn wire<typename f::type>::get(msg, f::wire_offset + index * sizeof(typename f::type));')
+    w('}')
+    for msgid, name, fields in messages:
+        ident = 'MAVLINK_MSG_ID_' + name
+        w('')
+        w('/* %s */' % name)
+        w('template <> struct message<%s> { enum { num_fields = %d, length = %s_LEN }; };' % (ident, len(fields), ident))
+        for i, (fname, ftype, length, offset) in enumerate(fields):
+            w('template <> struct field<%s, %d> { typedef %s type; enum { wire_offset = %d, array_length = %d }; }; // %s' % (ident, i, ftype, offset, length, fname))
+        w('')
+        w('template <class Visitor>')
+        w('inline void visit_%s(const mavlink_message_t* msg, Visitor& visitor)' % name.lower())
+        w('{')
+        for i, (fname, ftype, length, offset) in enumerate(fields):
+            if length == 0:
+                w('\tvisitor.value(%d, get<%s, %d>(msg));' % (i, ident, i))
+            elif ftype == 'char':
+                w('\tvisitor.text(%d, &_MAV_PAYLOAD(msg)[%d], %d);' % (i, offset, length))
+            else:
+                w('\tfor (uint8_t i = 0; i < %d; ++i) visitor.element(%d, i, get<%s, %d>(msg, i));' % (length, i, ident, i))
+        w('}')
+    w('')
+    w('/** @brief Unpack all fields of a message, false if the message id is unknown */')
+    w('template <class Visitor>')
+    w('inline bool visit(const mavlink_message_t* msg, Visitor& visitor)')
+    w('{')
+    w('\tswitch (msg->msgid) {')
+    for msgid, name, fields in messages:
+        w('\tcase MAVLINK_MSG_ID_%s:' % name)
+        w('\t\tvisit_%s(msg, visitor);' % name.lower())
+        w('\t\treturn true;')
+    w('\tdefault:')
+    w('\t\treturn false;')
+    w('\t}')
+    w('}')
+    w('')
+    w('} // namespace mavlink')
+    w('')
+    w('#endif // MAVLINK_MSG_VISITOR_HPP')
+    return '\n'.join(o) + '\n'
+
+
+def main(args):
+    parser = argparse.ArgumentParser(description='generate mavlink_msg_visitor.hpp from the generated MAVLink C headers')
+    parser.add_argument('--check', action='store_true',
+                        help='only compare, fail if a visitor differs from the generated one')
+    parser.add_argument('dialects', nargs='*', metavar='dialect',
+                        help='dialect in libs/mavlink/include/mavlink/v1.0 (default: all that have a visitor)')
+    opts = parser.parse_args(args)
+    check = opts.check
+    dialects = opts.dialects
+    for dialect in dialects:
+        if not os.path.isdir(os.path.join(BASE, dialect)):
+            parser.error('unknown dialect %s' % dialect)
+    if not dialects:
+        dialects = sorted(d for d in os.listdir(BASE)
+                          if os.path.exists(os.path.join(BASE, d, 'mavlink_msg_visitor.hpp')))
+    differ = 0
+    for dialect in dialects:
+        path = os.path.join(BASE, dialect, 'mavlink_msg_visitor.hpp')
+        text = generate(dialect)
+        if check:
+            current = open(path).read() if os.path.exists(path) else None
+            if current != text:
+                print('%s differs' % path)
+                differ += 1
+            else:
+                print('%s is up to date' % path)
+        else:
+            open(path, 'w').write(text)
+            print('Generated %s' % path)
+    return 1 if differ else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -34,6 +34,8 @@ along with PIXHAWK. If not, see <http://www.gnu.org/licenses/>.
 
 #include <QThread>
 
+#include "LinkMetrics.h"
+
 /**
 * The link interface defines the interface for all links used to communicate
 * with the groundstation application.
@@ -43,8 +45,8 @@ class LinkInterface : public QThread
 {
     Q_OBJECT
 public:
-    LinkInterface(QObject* parent = 0) : QThread(parent) {}
-    virtual ~LinkInterface() { emit this->deleteLink(this); }
+    LinkInterface(QObject* parent = 0) : QThread(parent), destructionAnnounced(false) {}
+    virtual ~LinkInterface() { announceDestruction(); emit this->deleteLink(this); }
 
     /* Connection management */
 
@@ -183,6 +185,21 @@ public:
      **/
     virtual qint64 bytesAvailable() = 0;
 
+    /**
+     * @brief Traffic, parser and timing metrics of this link
+     *
+     * The link counts its bytes, the MAVLink decoder its frames and errors.
+     **/
+    LinkMetrics& getMetrics() { return metrics; }
+
+    /**
+     * @brief True if writeBytes() may be called from any thread
+     *
+     * Links that are not thread safe are only written from the thread they
+     * belong to.
+     **/
+    virtual bool isWriteThreadSafe() const { return false; }
+
 public slots:
 
     /**
@@ -250,12 +267,36 @@ signals:
 	/** @brief destroying element */
 	void deleteLink(LinkInterface* const link);
 
+    /**
+     * @brief The link is about to be destroyed, while it is still intact
+     *
+     * Emitted once, from the destructor of the link. Other threads that use
+     * the link connect to it with Qt::DirectConnection and stop using it
+     * before the signal returns.
+     **/
+    void aboutToBeDestroyed(LinkInterface* link);
+
 protected:
     static int getNextLinkId() {
         static int nextId = 1;
         return nextId++;
     }
 
+    /**
+     * @brief Emit aboutToBeDestroyed() once
+     *
+     * Links that are used from other threads call this first in their
+     * destructor, before they tear anything down.
+     **/
+    void announceDestruction() {
+        if (destructionAnnounced) return;
+        destructionAnnounced = true;
+        emit aboutToBeDestroyed(this);
+    }
+
+    LinkMetrics metrics;
+    bool destructionAnnounced;
+
 protected slots:
 
     /**
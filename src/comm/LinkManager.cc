@@ -32,6 +32,8 @@ This file is part of the QGROUNDCONTROL project
 #include "LinkManager.h"
 #include <QList>
 #include <QApplication>
+#include <QDateTime>
+#include <QTextStream>
 #include <iostream>
 
 
@@ -58,6 +60,9 @@ LinkManager::LinkManager()
 {
     links = QList<LinkInterface*>();
     protocolLinks = QMap<ProtocolInterface*, LinkInterface*>();
+
+    connect(&metricsTimer, SIGNAL(timeout()), this, SLOT(sampleMetrics()));
+    metricsTimer.start(METRICS_INTERVAL);
 }
 
 LinkManager::~LinkManager()
@@ -99,8 +104,7 @@ void LinkManager::addProtocol(LinkInterface* link, ProtocolInterface* protocol)
     if (linkList.length() == 0 || !linkList.contains(link))
     {
         // Protocol is new, add
-        connect(link, SIGNAL(bytesReceived(LinkInterface*, QByteArray)),
-                protocol, SLOT(receiveBytes(LinkInterface*, QByteArray)), Qt::QueuedConnection);
+        protocol->addLink(link);
         // Store the connection information in the protocol links map
         protocolLinks.insertMulti(protocol, link);
     }
@@ -114,6 +118,89 @@ QList<LinkInterface*> LinkManager::getLinksForProtocol(ProtocolInterface* protoc
 }
 
 
+void LinkManager::sampleMetrics()
+{
+    foreach (LinkInterface* link, links)
+    {
+        if (link) link->getMetrics().sample();
+    }
+    if (metricsFile.isOpen())
+    {
+        writeMetrics();
+    }
+    emit metricsSampled();
+}
+
+bool LinkManager::setMetricsExportFile(const QString& path)
+{
+    if (metricsFile.isOpen())
+    {
+        metricsFile.close();
+    }
+    metricsFile.setFileName(path);
+    if (path.isEmpty()) return true;
+
+    bool header = !metricsFile.exists() || metricsFile.size() == 0;
+    if (!metricsFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        QLOG_WARN() << "LinkManager: cannot write link metrics to" << path << metricsFile.errorString();
+        return false;
+    }
+    if (header)
+    {
+        QTextStream out(&metricsFile);
+        out << "time,link,rx_bytes_per_s,tx_bytes_per_s,frames_per_s";
+        for (int c = LinkMetrics::CRC_ERRORS; c < LinkMetrics::COUNTERS; ++c)
+        {
+            out << "," << LinkMetrics::counterName((LinkMetrics::Counter)c);
+        }
+        out << ",loss_percent";
+        for (int h = 0; h < LinkMetrics::HISTOGRAMS; ++h)
+        {
+            QString name = LinkMetrics::histogramName((LinkMetrics::Histogram)h);
+            out << "," << name << "_p50_us," << name << "_p95_us," << name << "_p99_us";
+        }
+        out << "\n";
+    }
+    return true;
+}
+
+/**
+ * @brief Write one row per link with the last sample interval
+ **/
+void LinkManager::writeMetrics()
+{
+    QTextStream out(&metricsFile);
+    QString time = QDateTime::currentDateTime().toString(Qt::ISODate);
+    foreach (LinkInterface* link, links)
+    {
+        if (!link) continue;
+        LinkMetrics::Window window = link->getMetrics().window(METRICS_INTERVAL / 1000);
+        QString name = link->getName();
+        name.replace(',', ' ');
+        out << time << "," << name
+            << "," << window.rate(LinkMetrics::BYTES_RECEIVED)
+            << "," << window.rate(LinkMetrics::BYTES_SENT)
+            << "," << window.rate(LinkMetrics::FRAMES);
+        for (int c = LinkMetrics::CRC_ERRORS; c < LinkMetrics::COUNTERS; ++c)
+        {
+            out << "," << window.counts[c];
+        }
+        quint64 frames = window.counts[LinkMetrics::FRAMES];
+        quint64 lost = window.counts[LinkMetrics::MESSAGES_LOST];
+        out << "," << ((frames + lost) ? 100.0 * lost / (frames + lost) : 0.0);
+        for (int h = 0; h < LinkMetrics::HISTOGRAMS; ++h)
+        {
+            LinkMetrics::Histogram histogram = (LinkMetrics::Histogram)h;
+            out << "," << window.percentile(histogram, 0.5)
+                << "," << window.percentile(histogram, 0.95)
+                << "," << window.percentile(histogram, 0.99);
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
 bool LinkManager::connectAll()
 {
     QLOG_DEBUG() << "LinkManager::connectAll()";
@@ -184,6 +271,7 @@ bool LinkManager::removeLink(LinkInterface* link)
         foreach (ProtocolInterface* proto, protocols)
         {
             protocolLinks.remove(proto, link);
+            proto->removeLink(link);
         }
 
         // Emit removal of link
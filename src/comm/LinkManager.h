@@ -35,6 +35,8 @@ This file is part of the PIXHAWK project
 #include <QThread>
 #include <QList>
 #include <QMultiMap>
+#include <QTimer>
+#include <QFile>
 #include <LinkInterface.h>
 #include <ProtocolInterface.h>
 
@@ -62,6 +64,15 @@ public:
     /** @brief Get a list of all links */
     const QList<LinkInterface*> getLinks();
 
+    /**
+     * @brief Append the link metrics of every sample interval to a CSV file
+     *
+     * An empty path stops the export.
+     * @return False if the file could not be opened
+     */
+    bool setMetricsExportFile(const QString& path);
+    QString getMetricsExportFile() const { return metricsFile.fileName(); }
+
     /** @brief Get a list of all protocols */
     const QList<ProtocolInterface*> getProtocols() {
         return protocolLinks.uniqueKeys();
@@ -81,10 +92,18 @@ public slots:
     bool disconnectAll();
     bool disconnectLink(LinkInterface* link);
 
+    /** @brief Sample the metrics of all links, runs every METRICS_INTERVAL ms */
+    void sampleMetrics();
+
 protected:
+    enum { METRICS_INTERVAL = 1000 };
+    void writeMetrics();
+
     LinkManager();
     QList<LinkInterface*> links;
     QMultiMap<ProtocolInterface*,LinkInterface*> protocolLinks;
+    QTimer metricsTimer;
+    QFile metricsFile;
 
 private:
     static LinkManager* _instance;
@@ -92,6 +111,8 @@ private:
 signals:
     void newLink(LinkInterface* link);
     void linkRemoved(LinkInterface* link);
+    /** @brief The metrics of all links have a new snapshot */
+    void metricsSampled();
 
 };
 
@@ -0,0 +1,288 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Traffic and parser metrics of a link
+ */
+
+#include "LinkMetrics.h"
+
+#include <QMutexLocker>
+#include <string.h>
+
+namespace
+{
+/** @brief Current value of an atomic counter, works with the Qt 4 and Qt 5 API */
+inline quint32 load(QAtomicInt& value)
+{
+    return static_cast<quint32>(value.fetchAndAddRelaxed(0));
+}
+}
+
+LinkMetrics::Window::Window() :
+    seconds(0.0)
+{
+    memset(counts, 0, sizeof(counts));
+    memset(bins, 0, sizeof(bins));
+}
+
+double LinkMetrics::Window::rate(Counter counter) const
+{
+    if (seconds <= 0.0) return 0.0;
+    return counts[counter] / seconds;
+}
+
+quint64 LinkMetrics::Window::count(Histogram histogram) const
+{
+    quint64 sum = 0;
+    for (int i = 0; i < BINS; ++i)
+    {
+        sum += bins[histogram][i];
+    }
+    return sum;
+}
+
+quint32 LinkMetrics::Window::percentile(Histogram histogram, double fraction) const
+{
+    quint64 total = count(histogram);
+    if (total == 0) return 0;
+    quint64 rank = static_cast<quint64>(fraction * total);
+    quint64 sum = 0;
+    for (int i = 0; i < BINS; ++i)
+    {
+        sum += bins[histogram][i];
+        if (sum > rank) return binLimit(i);
+    }
+    return binLimit(BINS - 1);
+}
+
+LinkMetrics::LinkMetrics() :
+    history(HISTORY),
+    newest(-1),
+    snapshots(0)
+{
+    clock.start();
+    totals.ms = 0;
+    memset(totals.counts, 0, sizeof(totals.counts));
+    memset(totals.bins, 0, sizeof(totals.bins));
+    memset(lastCounters, 0, sizeof(lastCounters));
+    memset(lastBins, 0, sizeof(lastBins));
+    memset(lastSystemFrames, 0, sizeof(lastSystemFrames));
+    memset(lastSystemLost, 0, sizeof(lastSystemLost));
+}
+
+void LinkMetrics::received(int bytes)
+{
+    counters[BYTES_RECEIVED].fetchAndAddRelaxed(bytes);
+    counters[READS].fetchAndAddRelaxed(1);
+    quint32 now = elapsedUs();
+    quint32 last = static_cast<quint32>(lastReadUs.fetchAndStoreRelaxed(static_cast<int>(now)));
+    if (last != 0) record(READ_INTERVAL, now - last);
+}
+
+void LinkMetrics::sent(int bytes)
+{
+    counters[BYTES_SENT].fetchAndAddRelaxed(bytes);
+    counters[WRITES].fetchAndAddRelaxed(1);
+}
+
+void LinkMetrics::frame(int sysid, int lost)
+{
+    counters[FRAMES].fetchAndAddRelaxed(1);
+    systemFrames[sysid & 0xFF].fetchAndAddRelaxed(1);
+    if (lost > 0)
+    {
+        counters[SEQUENCE_GAPS].fetchAndAddRelaxed(1);
+        counters[MESSAGES_LOST].fetchAndAddRelaxed(lost);
+        systemLost[sysid & 0xFF].fetchAndAddRelaxed(lost);
+    }
+    quint32 now = elapsedUs();
+    quint32 last = static_cast<quint32>(lastFrameUs.fetchAndStoreRelaxed(static_cast<int>(now)));
+    if (last != 0) record(FRAME_INTERVAL, now - last);
+}
+
+void LinkMetrics::sample()
+{
+    sample(clock.elapsed());
+}
+
+void LinkMetrics::sample(qint64 ms)
+{
+    QMutexLocker locker(&sampleMutex);
+
+    // Unsigned differences stay right across the wrap around of the counters
+    for (int c = 0; c < COUNTERS; ++c)
+    {
+        quint32 value = load(counters[c]);
+        totals.counts[c] += value - lastCounters[c];
+        lastCounters[c] = value;
+    }
+    for (int h = 0; h < HISTOGRAMS; ++h)
+    {
+        for (int b = 0; b < BINS; ++b)
+        {
+            quint32 value = load(bins[h][b]);
+            totals.bins[h][b] += value - lastBins[h][b];
+            lastBins[h][b] = value;
+        }
+    }
+    for (int s = 0; s < SYSTEMS; ++s)
+    {
+        quint32 frames = load(systemFrames[s]);
+        quint32 lost = load(systemLost[s]);
+        if (frames == lastSystemFrames[s] && lost == lastSystemLost[s]) continue;
+        SystemCounts& counts = totals.systems[s];
+        counts.frames += frames - lastSystemFrames[s];
+        counts.lost += lost - lastSystemLost[s];
+        lastSystemFrames[s] = frames;
+        lastSystemLost[s] = lost;
+    }
+    totals.ms = ms;
+
+    newest = (newest + 1) % HISTORY;
+    history[newest] = totals;
+    if (snapshots < HISTORY) ++snapshots;
+}
+
+const LinkMetrics::Snapshot& LinkMetrics::snapshot(int age) const
+{
+    return history.at((newest - age + HISTORY) % HISTORY);
+}
+
+quint64 LinkMetrics::total(Counter counter) const
+{
+    QMutexLocker locker(&sampleMutex);
+    quint32 value = load(counters[counter]);
+    return totals.counts[counter] + (value - lastCounters[counter]);
+}
+
+double LinkMetrics::meanRate(Counter counter) const
+{
+    qint64 ms = clock.elapsed();
+    if (ms <= 0) return 0.0;
+    return total(counter) * 1000.0 / ms;
+}
+
+double LinkMetrics::peakRate(Counter counter) const
+{
+    QMutexLocker locker(&sampleMutex);
+    double peak = 0.0;
+    for (int age = 0; age + 1 < snapshots; ++age)
+    {
+        const Snapshot& later = snapshot(age);
+        const Snapshot& earlier = snapshot(age + 1);
+        if (later.ms <= earlier.ms) continue;
+        double rate = (later.counts[counter] - earlier.counts[counter]) * 1000.0 / (later.ms - earlier.ms);
+        if (rate > peak) peak = rate;
+    }
+    return peak;
+}
+
+LinkMetrics::Window LinkMetrics::window(int seconds) const
+{
+    QMutexLocker locker(&sampleMutex);
+    Window window;
+    if (snapshots < 2) return window;
+
+    // The oldest snapshot still inside the window
+    const Snapshot& end = snapshot(0);
+    qint64 cutoff = end.ms - static_cast<qint64>(seconds) * 1000;
+    int age = 1;
+    while (age + 1 < snapshots && snapshot(age + 1).ms >= cutoff)
+    {
+        ++age;
+    }
+    const Snapshot& start = snapshot(age);
+
+    window.seconds = (end.ms - start.ms) / 1000.0;
+    for (int c = 0; c < COUNTERS; ++c)
+    {
+        window.counts[c] = end.counts[c] - start.counts[c];
+    }
+    for (int h = 0; h < HISTOGRAMS; ++h)
+    {
+        for (int b = 0; b < BINS; ++b)
+        {
+            window.bins[h][b] = end.bins[h][b] - start.bins[h][b];
+        }
+    }
+    QMap<int, SystemCounts>::const_iterator i;
+    for (i = end.systems.constBegin(); i != end.systems.constEnd(); ++i)
+    {
+        SystemCounts before = start.systems.value(i.key());
+        SystemCounts& counts = window.systems[i.key()];
+        counts.frames = i.value().frames - before.frames;
+        counts.lost = i.value().lost - before.lost;
+    }
+    return window;
+}
+
+int LinkMetrics::bin(quint32 us)
+{
+    if (us == 0) return 0;
+#if defined(__GNUC__)
+    int b = 32 - __builtin_clz(us);
+#else
+    int b = 0;
+    while (us)
+    {
+        us >>= 1;
+        ++b;
+    }
+#endif
+    return (b < BINS) ? b : BINS - 1;
+}
+
+quint32 LinkMetrics::binLimit(int bin)
+{
+    return 1u << bin;
+}
+
+QString LinkMetrics::counterName(Counter counter)
+{
+    switch (counter)
+    {
+    case BYTES_RECEIVED: return "bytes_received";
+    case BYTES_SENT: return "bytes_sent";
+    case READS: return "reads";
+    case WRITES: return "writes";
+    case FRAMES: return "frames";
+    case CRC_ERRORS: return "crc_errors";
+    case FRAMING_ERRORS: return "framing_errors";
+    case RESYNCS: return "resyncs";
+    case SEQUENCE_GAPS: return "sequence_gaps";
+    case MESSAGES_LOST: return "messages_lost";
+    default: return QString();
+    }
+}
+
+QString LinkMetrics::histogramName(Histogram histogram)
+{
+    switch (histogram)
+    {
+    case READ_INTERVAL: return "read_interval";
+    case FRAME_INTERVAL: return "frame_interval";
+    case HANDOVER_LATENCY: return "handover_latency";
+    default: return QString();
+    }
+}
@@ -0,0 +1,180 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Traffic and parser metrics of a link
+ */
+
+#ifndef LINKMETRICS_H
+#define LINKMETRICS_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Counters and histograms of one link, sampled into a short history.
+ *
+ * The I/O threads and the parser only increment 32 bit atomic counters, so
+ * the hot path never takes a lock. sample() folds the counters into 64 bit
+ * totals, the wrap around is harmless as long as it runs more often than
+ * every 2^32 bytes, and keeps one snapshot per call. Rates and histograms
+ * over any recent window are the difference of two snapshots.
+ *
+ * The histograms have power of two bins in microseconds: bin 0 counts
+ * values below 1 us, bin b values from 2^(b-1) up to 2^b us, and the last
+ * bin everything from about 4.2 s on.
+ */
+class LinkMetrics
+{
+public:
+    enum Counter
+    {
+        BYTES_RECEIVED,
+        BYTES_SENT,
+        READS,              ///< Chunks delivered by the link
+        WRITES,
+        FRAMES,             ///< MAVLink frames decoded
+        CRC_ERRORS,         ///< Frames dropped for a wrong checksum
+        FRAMING_ERRORS,     ///< Frames dropped for a bad length
+        RESYNCS,            ///< Times the parser skipped bytes to find the next frame
+        SEQUENCE_GAPS,      ///< Jumps in the sequence numbers of a component
+        MESSAGES_LOST,      ///< Messages missing in the sequence numbers
+        COUNTERS
+    };
+
+    enum Histogram
+    {
+        READ_INTERVAL,      ///< Time between two reads
+        FRAME_INTERVAL,     ///< Time between two decoded frames
+        HANDOVER_LATENCY,   ///< Wait of decoded messages until the protocol took them
+        HISTOGRAMS
+    };
+
+    enum
+    {
+        BINS = 24,
+        HISTORY = 121,      ///< Snapshots kept, two minutes at the default sample rate
+        SYSTEMS = 256
+    };
+
+    struct SystemCounts
+    {
+        SystemCounts() : frames(0), lost(0) {}
+        quint64 frames;
+        quint64 lost;
+        /** @brief Lost messages in percent of all sent */
+        double loss() const { return (frames + lost) ? 100.0 * lost / (frames + lost) : 0.0; }
+    };
+
+    /** @brief Difference between two snapshots */
+    struct Window
+    {
+        Window();
+        double seconds;
+        quint64 counts[COUNTERS];
+        quint64 bins[HISTOGRAMS][BINS];
+        QMap<int, SystemCounts> systems;    ///< Frames and losses per system id
+
+        /** @brief Mean per second, 0 for an empty window */
+        double rate(Counter counter) const;
+        /** @brief Upper bound in us of the bin the fraction of all values falls into, 0 if empty */
+        quint32 percentile(Histogram histogram, double fraction) const;
+        quint64 count(Histogram histogram) const;
+    };
+
+    LinkMetrics();
+
+    /* I/O path, lock-free and callable from any thread */
+
+    void add(Counter counter, int amount = 1) { counters[counter].fetchAndAddRelaxed(amount); }
+    void record(Histogram histogram, quint32 us) { bins[histogram][bin(us)].fetchAndAddRelaxed(1); }
+    /** @brief Count a chunk of received bytes and the time since the last one */
+    void received(int bytes);
+    void sent(int bytes);
+    /** @brief Count a decoded frame and the messages lost right before it */
+    void frame(int sysid, int lost);
+    /** @brief Microseconds since the metrics were created, wraps after 71 minutes */
+    quint32 elapsedUs() const { return static_cast<quint32>(clock.nsecsElapsed() / 1000); }
+
+    /* Sampling side */
+
+    /** @brief Fold the counters into the totals and keep a snapshot */
+    void sample();
+    /** @brief Same as sample(), at a given time in ms since creation */
+    void sample(qint64 ms);
+
+    /** @brief Total count since creation, including what was not sampled yet */
+    quint64 total(Counter counter) const;
+    /** @brief Mean per second since creation */
+    double meanRate(Counter counter) const;
+    /** @brief Highest rate between two consecutive snapshots in the history */
+    double peakRate(Counter counter) const;
+    /**
+     * @brief Counts between the newest snapshot and the one the given seconds before it
+     *
+     * The window is shorter if there is not enough history yet.
+     */
+    Window window(int seconds) const;
+
+    /** @brief Upper bound in us of a histogram bin */
+    static quint32 binLimit(int bin);
+    static QString counterName(Counter counter);
+    static QString histogramName(Histogram histogram);
+
+private:
+    struct Snapshot
+    {
+        qint64 ms;
+        quint64 counts[COUNTERS];
+        quint64 bins[HISTOGRAMS][BINS];
+        QMap<int, SystemCounts> systems;
+    };
+
+    static int bin(quint32 us);
+    /** @brief The snapshot age samples before the newest one, the mutex must be held */
+    const Snapshot& snapshot(int age) const;
+
+    QElapsedTimer clock;
+    mutable QAtomicInt counters[COUNTERS];
+    QAtomicInt bins[HISTOGRAMS][BINS];
+    QAtomicInt systemFrames[SYSTEMS];
+    QAtomicInt systemLost[SYSTEMS];
+    QAtomicInt lastReadUs;
+    QAtomicInt lastFrameUs;
+
+    mutable QMutex sampleMutex;
+    Snapshot totals;                ///< Folded counters
+    quint32 lastCounters[COUNTERS]; ///< Raw counter values at the last sample
+    quint32 lastBins[HISTOGRAMS][BINS];
+    quint32 lastSystemFrames[SYSTEMS];
+    quint32 lastSystemLost[SYSTEMS];
+    QVector<Snapshot> history;      ///< Ring of snapshots
+    int newest;                     ///< Index of the newest snapshot
+    int snapshots;                  ///< Snapshots in the ring
+};
+
+#endif // LINKMETRICS_H
@@ -0,0 +1,506 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Priority-aware, rate-shaped transmit queue for one link
+ */
+
+#include "QsLog.h"
+#include "LinkTxScheduler.h"
+#include "LinkInterface.h"
+#include "QGC.h"
+
+#include <QApplication>
+#include <QMutexLocker>
+#include <QThread>
+#include <qmath.h>
+
+// Links faster than this are not worth shaping, frames are written directly
+#define TX_UNSHAPED_BITRATE 1000000
+// Serial framing 8N1 puts ten bits on the wire for every byte
+#define TX_BITS_PER_BYTE 10
+
+const int LinkTxScheduler::maxQueueDepth[LinkTxScheduler::PRIORITY_COUNT] = {
+    8,      // PRIORITY_CONTROL (coalesced, rarely more than one per id)
+    64,     // PRIORITY_COMMAND
+    16,     // PRIORITY_HIL (coalesced)
+    128,    // PRIORITY_DEFAULT
+    512     // PRIORITY_BULK
+};
+
+namespace
+{
+/** @brief Payload offsets of the target fields per message id, -1 if absent */
+struct TargetOffsets
+{
+    TargetOffsets()
+    {
+        static const mavlink_message_info_t info[256] = MAVLINK_MESSAGE_INFO;
+        for (int msgid = 0; msgid < 256; msgid++)
+        {
+            system[msgid] = -1;
+            component[msgid] = -1;
+            for (unsigned int field = 0; field < info[msgid].num_fields; field++)
+            {
+                const mavlink_field_info_t& fieldInfo = info[msgid].fields[field];
+                if (!fieldInfo.name || fieldInfo.array_length != 0) continue;
+                // MANUAL_CONTROL calls its target system just "target"
+                if (qstrcmp(fieldInfo.name, "target_system") == 0 || qstrcmp(fieldInfo.name, "target") == 0)
+                {
+                    system[msgid] = fieldInfo.wire_offset;
+                }
+                else if (qstrcmp(fieldInfo.name, "target_component") == 0)
+                {
+                    component[msgid] = fieldInfo.wire_offset;
+                }
+            }
+        }
+    }
+    int system[256];
+    int component[256];
+};
+
+// Built during static initialization, before any link can send
+const TargetOffsets targetOffsets;
+}
+
+QMap<LinkInterface*, LinkTxScheduler*> LinkTxScheduler::schedulers;
+QMutex LinkTxScheduler::schedulersMutex;
+QThread* LinkTxScheduler::writerThread = 0;
+
+LinkTxScheduler* LinkTxScheduler::forLink(LinkInterface* link)
+{
+    if (!link) return 0;
+    QMutexLocker locker(&schedulersMutex);
+    LinkTxScheduler* scheduler = schedulers.value(link, 0);
+    if (!scheduler)
+    {
+        scheduler = new LinkTxScheduler(link);
+        schedulers.insert(link, scheduler);
+    }
+    return scheduler;
+}
+
+LinkTxScheduler* LinkTxScheduler::findForLink(LinkInterface* link)
+{
+    QMutexLocker locker(&schedulersMutex);
+    return schedulers.value(link, 0);
+}
+
+QThread* LinkTxScheduler::getWriterThread()
+{
+    if (!writerThread)
+    {
+        writerThread = new QThread();
+        writerThread->setObjectName("LinkTxScheduler");
+        writerThread->start(QThread::HighPriority);
+        qAddPostRoutine(stopWriterThread);
+    }
+    return writerThread;
+}
+
+void LinkTxScheduler::stopWriterThread()
+{
+    QMutexLocker locker(&schedulersMutex);
+    if (!writerThread) return;
+    writerThread->quit();
+    writerThread->wait();
+    delete writerThread;
+    writerThread = 0;
+}
+
+QString LinkTxScheduler::priorityName(Priority priority)
+{
+    static const char* names[PRIORITY_COUNT] = { "control", "command", "hil", "default", "bulk" };
+    if (priority < 0 || priority >= PRIORITY_COUNT) return QString();
+    return names[priority];
+}
+
+LinkTxScheduler::Priority LinkTxScheduler::priorityFor(quint8 msgid)
+{
+    switch (msgid)
+    {
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SETPOINT_6DOF:
+    case MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_THRUST:
+    case MAVLINK_MSG_ID_SET_ROLL_PITCH_YAW_SPEED_THRUST:
+        return PRIORITY_CONTROL;
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_SET_MODE:
+        return PRIORITY_COMMAND;
+    case MAVLINK_MSG_ID_HIL_STATE:
+    case MAVLINK_MSG_ID_HIL_SENSOR:
+    case MAVLINK_MSG_ID_HIL_CONTROLS:
+    case MAVLINK_MSG_ID_HIL_RC_INPUTS_RAW:
+    // Sent by the HIL bridge at the simulation rate, only the latest sample matters
+    case MAVLINK_MSG_ID_HIGHRES_IMU:
+    case MAVLINK_MSG_ID_GPS_RAW_INT:
+        return PRIORITY_HIL;
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ:
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST:
+    case MAVLINK_MSG_ID_PARAM_SET:
+    case MAVLINK_MSG_ID_PARAM_VALUE:
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    case MAVLINK_MSG_ID_MISSION_ACK:
+    case MAVLINK_MSG_ID_MISSION_CLEAR_ALL:
+        return PRIORITY_BULK;
+    default:
+        return PRIORITY_DEFAULT;
+    }
+}
+
+bool LinkTxScheduler::isSupersedable(quint8 msgid)
+{
+    Priority priority = priorityFor(msgid);
+    return priority == PRIORITY_CONTROL || priority == PRIORITY_HIL;
+}
+
+quint16 LinkTxScheduler::targetOf(const char* frame, int length)
+{
+    if (length < MAVLINK_NUM_NON_PAYLOAD_BYTES) return 0xFFFF;
+    quint8 msgid = frame[5];
+    int payloadLength = (quint8)frame[1];
+    const char* payload = frame + MAVLINK_NUM_HEADER_BYTES;
+    quint8 system = 0xFF;
+    quint8 component = 0xFF;
+    int offset = targetOffsets.system[msgid];
+    if (offset >= 0 && offset < payloadLength) system = payload[offset];
+    offset = targetOffsets.component[msgid];
+    if (offset >= 0 && offset < payloadLength) component = payload[offset];
+    return ((quint16)system << 8) | component;
+}
+
+LinkTxScheduler::LinkTxScheduler(LinkInterface* link) :
+    QObject(0),
+    link(link),
+    threadSafe(link->isWriteThreadSafe()),
+    drainScheduled(false),
+    draining(false),
+    byteRate(0),
+    tokens(0),
+    bucketSize(0),
+    lastRefillMs(QGC::groundTimeMilliseconds()),
+    detached(false),
+    users(0)
+{
+    // The drain runs in the transmit thread if the link can be written from
+    // any thread, otherwise in the thread of the link. Both run an event loop.
+    QThread* owner = threadSafe ? getWriterThread() : link->thread();
+    moveToThread(owner);
+    drainTimer.moveToThread(owner);
+    drainTimer.setSingleShot(true);
+    connect(&drainTimer, SIGNAL(timeout()), this, SLOT(drain()));
+    connect(link, SIGNAL(disconnected()), this, SLOT(clear()));
+    // Direct, the link has to be intact until no thread writes to it any more
+    connect(link, SIGNAL(aboutToBeDestroyed(LinkInterface*)), this, SLOT(linkDestroyed()), Qt::DirectConnection);
+    updateRate();
+    tokens = bucketSize;
+}
+
+LinkTxScheduler::~LinkTxScheduler()
+{
+    QMutexLocker locker(&schedulersMutex);
+    if (schedulers.value(link, 0) == this)
+    {
+        schedulers.remove(link);
+    }
+}
+
+void LinkTxScheduler::linkDestroyed()
+{
+    {
+        QMutexLocker locker(&schedulersMutex);
+        schedulers.remove(link);
+    }
+    {
+        QMutexLocker locker(&queueMutex);
+        detached = true;
+        dropQueued();
+        // Woken senders and running writes only need the queue to finish, never this thread
+        while (users > 0)
+        {
+            usersLeft.wait(&queueMutex);
+        }
+    }
+    deleteLater();
+}
+
+void LinkTxScheduler::updateRate()
+{
+    qint64 nominal = link->getNominalDataRate();
+    if (nominal <= 0 || nominal >= TX_UNSHAPED_BITRATE)
+    {
+        byteRate = 0;
+        bucketSize = 0;
+        return;
+    }
+    byteRate = nominal / TX_BITS_PER_BYTE;
+    // Allow bursts of 100 ms, but always at least one full frame
+    bucketSize = qMax((double)byteRate / 10.0, (double)MAVLINK_MAX_PACKET_LEN);
+    tokens = qMin(tokens, bucketSize);
+}
+
+void LinkTxScheduler::refill(quint64 now)
+{
+    if (now > lastRefillMs)
+    {
+        tokens = qMin(bucketSize, tokens + (double)byteRate * (now - lastRefillMs) / 1000.0);
+    }
+    lastRefillMs = now;
+}
+
+LinkTxScheduler::SendResult LinkTxScheduler::send(quint8 msgid, const char* frame, int length, bool wait)
+{
+    QMutexLocker locker(&queueMutex);
+    // The link is gone, the scheduler only waits for its deletion
+    if (detached) return SEND_DROPPED;
+    quint64 now = QGC::groundTimeMilliseconds();
+    Priority priority = priorityFor(msgid);
+
+    // The baud rate can be changed while connected
+    updateRate();
+
+    Frame entry;
+    entry.msgid = msgid;
+    entry.target = 0xFFFF;
+    entry.data = QByteArray(frame, length);
+    entry.queuedMs = now;
+
+    if (byteRate != 0) refill(now);
+
+    bool queued = false;
+    for (int i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        if (!queues[i].isEmpty())
+        {
+            queued = true;
+            break;
+        }
+    }
+
+    // Links that are not thread safe are only written by the thread of the scheduler
+    const bool ownThread = (QThread::currentThread() == thread());
+    // Frames the drain is writing count as queued, they have to go out first
+    if ((threadSafe || ownThread) && !queued && !draining && (byteRate == 0 || tokens >= length))
+    {
+        if (byteRate != 0) tokens -= length;
+        book(priority, entry, now);
+        write(locker, QList<QByteArray>() << entry.data);
+        return SEND_WRITTEN;
+    }
+
+    QList<Frame>& queue = queues[priority];
+    ClassStatistics& stat = stats[priority];
+
+    if (isSupersedable(msgid))
+    {
+        // Streams to different vehicles on the same link must not replace each other
+        entry.target = targetOf(frame, length);
+        for (int i = 0; i < queue.size(); ++i)
+        {
+            if (queue[i].msgid == msgid && queue[i].target == entry.target)
+            {
+                // Keep the queue position (and age) of the superseded frame
+                queue[i].data = entry.data;
+                stat.coalesced++;
+                return SEND_QUEUED;
+            }
+        }
+    }
+
+    if (queue.size() >= maxQueueDepth[priority])
+    {
+        if (isSupersedable(msgid))
+        {
+            // Nothing of this message and target is queued, see above. Evicting
+            // another frame would cut off a different stream or vehicle.
+            stat.dropped++;
+            return SEND_DROPPED;
+        }
+        else if (!wait)
+        {
+            stat.dropped++;
+            return SEND_DROPPED;
+        }
+        else if (ownThread || QThread::currentThread() == qApp->thread())
+        {
+            // Waiting for the drain in its own thread would never end, and the
+            // GUI must not freeze. Park the frame beyond the limit, but only up
+            // to twice the depth.
+            if (queue.size() >= 2 * maxQueueDepth[priority])
+            {
+                stat.dropped++;
+                return SEND_DROPPED;
+            }
+            stat.parked++;
+        }
+        else
+        {
+            // The link may have been destroyed while waiting
+            if (!waitForRoom(priority, now)) return SEND_DROPPED;
+            entry.queuedMs = now;
+        }
+    }
+    queue.append(entry);
+    stat.depth = queue.size();
+    stat.maxDepth = qMax(stat.maxDepth, stat.depth);
+
+    scheduleDrain();
+    return SEND_QUEUED;
+}
+
+void LinkTxScheduler::drain()
+{
+    QMutexLocker locker(&queueMutex);
+    drainScheduled = false;
+    if (detached) return;
+    quint64 now = QGC::groundTimeMilliseconds();
+    refill(now);
+
+    QList<QByteArray> batch;
+    bool blocked = false;
+    for (int i = 0; i < PRIORITY_COUNT && !blocked; ++i)
+    {
+        QList<Frame>& queue = queues[i];
+        while (!queue.isEmpty())
+        {
+            if (byteRate != 0 && tokens < queue.first().data.size())
+            {
+                scheduleDrain();
+                blocked = true;
+                break;
+            }
+            Frame frame = queue.takeFirst();
+            tokens -= frame.data.size();
+            stats[i].depth = queue.size();
+            book((Priority)i, frame, now);
+            batch.append(frame.data);
+        }
+    }
+    if (batch.isEmpty()) return;
+    roomAvailable.wakeAll();
+    draining = true;
+    write(locker, batch);
+    draining = false;
+}
+
+bool LinkTxScheduler::waitForRoom(Priority priority, quint64& now)
+{
+    quint64 start = now;
+    users++;
+    while (!detached && queues[priority].size() >= maxQueueDepth[priority])
+    {
+        scheduleDrain();
+        roomAvailable.wait(&queueMutex);
+        now = QGC::groundTimeMilliseconds();
+    }
+    users--;
+    if (detached)
+    {
+        usersLeft.wakeAll();
+        return false;
+    }
+    stats[priority].blockedMs += now - start;
+    return true;
+}
+
+void LinkTxScheduler::clear()
+{
+    QMutexLocker locker(&queueMutex);
+    dropQueued();
+}
+
+void LinkTxScheduler::dropQueued()
+{
+    for (int i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        stats[i].dropped += queues[i].size();
+        queues[i].clear();
+        stats[i].depth = 0;
+    }
+    roomAvailable.wakeAll();
+}
+
+void LinkTxScheduler::scheduleDrain()
+{
+    if (drainScheduled) return;
+    int needed = 0;
+    for (int i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        if (!queues[i].isEmpty())
+        {
+            needed = queues[i].first().data.size();
+            break;
+        }
+    }
+    if (needed == 0) return;
+    drainScheduled = true;
+
+    if (byteRate == 0 || tokens >= needed)
+    {
+        // Frames of other threads, written as soon as the event loop gets to them
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
+        return;
+    }
+    int delayMs = qMax(1, qCeil((needed - tokens) * 1000.0 / byteRate));
+    // QTimer may only be started from its own thread
+    QMetaObject::invokeMethod(&drainTimer, "start", Qt::AutoConnection, Q_ARG(int, delayMs));
+}
+
+void LinkTxScheduler::book(Priority priority, const Frame& frame, quint64 now)
+{
+    ClassStatistics& stat = stats[priority];
+    quint64 latency = (now > frame.queuedMs) ? now - frame.queuedMs : 0;
+    stat.sent++;
+    stat.latencySumMs += latency;
+    stat.maxLatencyMs = qMax(stat.maxLatencyMs, latency);
+}
+
+void LinkTxScheduler::write(QMutexLocker& locker, const QList<QByteArray>& frames)
+{
+    // A slow write must not hold back the other senders. The link stays
+    // intact meanwhile, linkDestroyed() waits for the users to leave.
+    users++;
+    locker.unlock();
+    if (link->isConnected())
+    {
+        foreach (const QByteArray& data, frames)
+        {
+            link->writeBytes(data.constData(), data.size());
+        }
+    }
+    locker.relock();
+    users--;
+    if (detached) usersLeft.wakeAll();
+}
+
+LinkTxScheduler::ClassStatistics LinkTxScheduler::getStatistics(Priority priority)
+{
+    QMutexLocker locker(&queueMutex);
+    return stats[priority];
+}
@@ -0,0 +1,196 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Priority-aware, rate-shaped transmit queue for one link
+ */
+
+#ifndef LINKTXSCHEDULER_H
+#define LINKTXSCHEDULER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QTimer>
+#include <QWaitCondition>
+#include "QGCMAVLink.h"
+
+class LinkInterface;
+
+/**
+ * Every outgoing MAVLink frame of a link passes through its scheduler. Frames
+ * are sorted into priority classes and drained in class order through a token
+ * bucket sized to the nominal data rate of the link, so a joystick stream is
+ * never stuck behind a parameter or mission transfer on a slow radio.
+ *
+ * Control and HIL streams only care about the latest value: a newer frame of
+ * the same message id to the same target replaces a frame that is still
+ * waiting in the queue. When their queue is full, a frame of a message id
+ * and target that has nothing queued yet is dropped, so the streams already
+ * waiting are never cut off. Commands, parameter and mission frames are not dropped: a
+ * sender thread that finds their queue full waits, without holding the
+ * queue, until the drain has written enough frames to make room. The GUI
+ * thread and the thread of the drain never wait, their frames are parked
+ * beyond the limit instead, up to twice the depth of the queue. Frames beyond that
+ * are dropped so a stalled link cannot grow the queue without bound.
+ *
+ * The drain runs in the thread of the scheduler. For links that may be
+ * written from any thread (serial, UDP) that is one transmit thread shared
+ * by all schedulers, so no sender depends on the GUI event loop. Other link
+ * types are not thread safe, their scheduler lives in the thread of the link
+ * and only that thread writes to them. A frame is written straight through
+ * by its sender when the link allows it, the bucket holds enough tokens and
+ * nothing is queued, so fast links see no added latency.
+ */
+class LinkTxScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        PRIORITY_CONTROL = 0,   ///< Manual control / RC override, coalesced
+        PRIORITY_COMMAND,       ///< Heartbeat, commands, mode changes
+        PRIORITY_HIL,           ///< Simulator state and sensors, coalesced
+        PRIORITY_DEFAULT,       ///< Everything not classified otherwise
+        PRIORITY_BULK,          ///< Parameter and mission transfers
+        PRIORITY_COUNT
+    };
+
+    /** @brief What send() did with a frame */
+    enum SendResult {
+        SEND_WRITTEN = 0,   ///< Written to the link before send() returned
+        SEND_QUEUED,        ///< Queued or coalesced, written later by the drain
+        SEND_DROPPED        ///< Discarded, the queue was full or the link is gone
+    };
+
+    /** @brief Per priority class counters */
+    struct ClassStatistics {
+        ClassStatistics() : depth(0), maxDepth(0), sent(0), coalesced(0),
+            dropped(0), parked(0), blockedMs(0), latencySumMs(0), maxLatencyMs(0) {}
+        int depth;              ///< Frames currently waiting
+        int maxDepth;           ///< Highest number of frames ever waiting
+        quint64 sent;           ///< Frames written to the link
+        quint64 coalesced;      ///< Frames replaced by a newer one while waiting
+        quint64 dropped;        ///< Frames discarded because the queue was full or the link disconnected
+        quint64 parked;         ///< Frames of the GUI thread queued beyond the limit (up to twice the depth)
+        quint64 blockedMs;      ///< Time sender threads waited for room in the full queue
+        quint64 latencySumMs;   ///< Sum of queueing delays of all sent frames
+        quint64 maxLatencyMs;   ///< Largest queueing delay seen
+        /** @brief Mean queueing delay in milliseconds */
+        double meanLatencyMs() const { return sent ? (double)latencySumMs / sent : 0.0; }
+    };
+
+    /** @brief Get (and create on first use) the scheduler of this link */
+    static LinkTxScheduler* forLink(LinkInterface* link);
+    /** @brief Get the scheduler of this link, 0 if nothing was sent over it yet */
+    static LinkTxScheduler* findForLink(LinkInterface* link);
+
+    /** @brief Priority class a message id is sent with */
+    static Priority priorityFor(quint8 msgid);
+    /** @brief True if a newer frame of this id supersedes a queued one */
+    static bool isSupersedable(quint8 msgid);
+    /** @brief Target system and component of a serialized frame as one key, 0xFFFF if it has none */
+    static quint16 targetOf(const char* frame, int length);
+    /** @brief Short name of a priority class */
+    static QString priorityName(Priority priority);
+
+    ~LinkTxScheduler();
+
+    /**
+     * @brief Queue a serialized frame, writing it immediately if the link allows it from this thread and the budget allows
+     * @param wait Wait for room if the queue of the frame is full. Without, the frame is dropped instead,
+     *             e.g. for frames forwarded from another link.
+     */
+    SendResult send(quint8 msgid, const char* frame, int length, bool wait = true);
+
+    /** @brief Snapshot of the counters of one priority class */
+    ClassStatistics getStatistics(Priority priority);
+
+    /** @brief Bytes per second the link is shaped to, 0 if unlimited */
+    qint64 getByteRate() const { return byteRate; }
+
+public slots:
+    /** @brief Write as many queued frames as the token bucket allows */
+    void drain();
+    /** @brief Drop all queued frames, e.g. after a disconnect */
+    void clear();
+
+protected slots:
+    /** @brief Stop using the link before it is destroyed, then delete this scheduler */
+    void linkDestroyed();
+
+protected:
+    explicit LinkTxScheduler(LinkInterface* link);
+
+    struct Frame {
+        quint8 msgid;
+        quint16 target;     ///< Key of targetOf()
+        QByteArray data;
+        quint64 queuedMs;
+    };
+
+    /** @brief Add the tokens accumulated since the last refill */
+    void refill(quint64 now);
+    /** @brief Re-read the nominal data rate of the link */
+    void updateRate();
+    /** @brief Post a drain, delayed until the head frame has its tokens */
+    void scheduleDrain();
+    /** @brief Count a frame as sent and book its latency, called with the queue locked */
+    void book(Priority priority, const Frame& frame, quint64 now);
+    /** @brief Write frames to the link, called with the queue locked, releases it while writing */
+    void write(QMutexLocker& locker, const QList<QByteArray>& frames);
+    /** @brief Wait until the drain made room in the queue of this class, releases the queue meanwhile
+     *  @return false if the link was destroyed while waiting, the scheduler must not be used any more */
+    bool waitForRoom(Priority priority, quint64& now);
+    /** @brief Drop all queued frames and wake waiting senders, called with the queue locked */
+    void dropQueued();
+    /** @brief The transmit thread of the thread safe links, started on first use, called with schedulersMutex locked */
+    static QThread* getWriterThread();
+    /** @brief Stop the transmit thread when the application quits */
+    static void stopWriterThread();
+
+    LinkInterface* link;
+    bool threadSafe;        ///< Any thread may write to the link
+    QList<Frame> queues[PRIORITY_COUNT];
+    ClassStatistics stats[PRIORITY_COUNT];
+    QMutex queueMutex;
+    QWaitCondition roomAvailable;   ///< Signalled by the drain after writing frames
+    QTimer drainTimer;
+    bool drainScheduled;    ///< A drain is posted or its timer runs
+    bool draining;          ///< The drain writes the frames it took off the queue
+    qint64 byteRate;        ///< Shaping rate in bytes/s, 0 = unlimited
+    double tokens;          ///< Bytes that may be written right now
+    double bucketSize;      ///< Largest burst in bytes
+    quint64 lastRefillMs;
+    bool detached;          ///< The link was destroyed, nothing is queued or written any more
+    int users;              ///< Threads waiting for room or writing to the link without holding the queue
+    QWaitCondition usersLeft;       ///< Signalled when a user leaves after the detach
+
+    static const int maxQueueDepth[PRIORITY_COUNT];
+    static QMap<LinkInterface*, LinkTxScheduler*> schedulers;
+    static QMutex schedulersMutex;
+    static QThread* writerThread;
+};
+
+#endif // LINKTXSCHEDULER_H
@@ -0,0 +1,285 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief MAVLink parser running in its own thread, one per link
+ */
+
+#include "MAVLinkDecodeWorker.h"
+#include "MAVLinkProtocol.h"
+#include "LinkInterface.h"
+#include "QGC.h"
+#include "QsLog.h"
+
+#include <QMutexLocker>
+
+const int MAVLinkDecodeWorker::queueCapacity;
+
+MAVLinkDecodeWorker::MAVLinkDecodeWorker(LinkInterface* link, MAVLinkProtocol* protocol) :
+    link(link),
+    protocol(protocol),
+    channel(link->getId()),
+    oldestQueuedNs(0),
+    notified(false),
+    queueCoalesced(0),
+    queueDropped(0),
+    queueLost(0),
+    mavlink09Count(0),
+    nonmavlinkCount(0),
+    skipping(false),
+    decodedFirstPacket(false),
+    warnedUser(false),
+    checkedUserNonMavlink(false),
+    warnedUserNonMavlink(false)
+{
+    clock.start();
+    moveToThread(&thread);
+    // Always queued, also for links that emit from the GUI thread
+    connect(link, SIGNAL(bytesReceived(LinkInterface*,QByteArray)),
+            this, SLOT(receiveBytes(LinkInterface*,QByteArray)), Qt::QueuedConnection);
+    thread.start();
+    QLOG_DEBUG() << "MAVLink decoder thread started for" << link->getName();
+}
+
+MAVLinkDecodeWorker::~MAVLinkDecodeWorker()
+{
+    thread.quit();
+    thread.wait();
+}
+
+bool MAVLinkDecodeWorker::isCoalescable(int msgid)
+{
+    switch (msgid)
+    {
+    case MAVLINK_MSG_ID_ATTITUDE:
+    case MAVLINK_MSG_ID_ATTITUDE_QUATERNION:
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+    case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+    case MAVLINK_MSG_ID_GPS_RAW_INT:
+    case MAVLINK_MSG_ID_VFR_HUD:
+    case MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void MAVLinkDecodeWorker::receiveBytes(LinkInterface* link, QByteArray b)
+{
+    mavlink_message_t message;
+    mavlink_status_t status;
+    QVector<mavlink_message_t> decoded;
+    LinkMetrics& metrics = link->getMetrics();
+    // All frames of these bytes arrived now
+    quint64 received = QGC::groundTimeUsecs();
+    int crcErrors = 0;
+    int framingErrors = 0;
+    int resyncs = 0;
+
+    for (int position = 0; position < b.size(); position++) {
+        // The parser resets its error count on every byte, the state before tells the kind of error
+        uint8_t parseState = mavlink_get_channel_status(channel)->parse_state;
+        unsigned int decodeState = mavlink_parse_char(channel, (uint8_t)(b[position]), &message, &status);
+
+        if (status.packet_rx_drop_count > 0)
+        {
+            if (parseState == MAVLINK_PARSE_STATE_GOT_PAYLOAD || parseState == MAVLINK_PARSE_STATE_GOT_CRC1)
+            {
+                crcErrors++;
+            }
+            else
+            {
+                framingErrors++;
+            }
+        }
+        if ((parseState == MAVLINK_PARSE_STATE_IDLE || parseState == MAVLINK_PARSE_STATE_UNINIT)
+                && (uint8_t)b[position] != MAVLINK_STX)
+        {
+            // Count each run of skipped bytes once
+            if (!skipping) resyncs++;
+            skipping = true;
+        }
+        else
+        {
+            skipping = false;
+        }
+
+        if ((uint8_t)b[position] == 0x55) mavlink09Count++;
+        if ((mavlink09Count > 100) && !decodedFirstPacket && !warnedUser)
+        {
+            warnedUser = true;
+            // Obviously the user tries to use a 0.9 autopilot
+            // with QGroundControl built for version 1.0
+            emit protocolStatusMessage("MAVLink Version or Baud Rate Mismatch", "Your MAVLink device seems to use the deprecated version 0.9, while APM Planner only supports version 1.0+. Please upgrade the MAVLink version of your autopilot. If your autopilot is using version 1.0, check if the baud rates of APM Planner and your autopilot are the same.");
+        }
+
+        if (decodeState == 0 && !decodedFirstPacket)
+        {
+            nonmavlinkCount++;
+            if (nonmavlinkCount > 500 && !warnedUserNonMavlink)
+            {
+                //500 bytes with no mavlink message. Are we connected to a mavlink capable device?
+                if (!checkedUserNonMavlink)
+                {
+                    link->requestReset();
+                    nonmavlinkCount=0;
+                    checkedUserNonMavlink = true;
+                }
+                else
+                {
+                    warnedUserNonMavlink = true;
+                    emit protocolStatusMessage("MAVLink Baud Rate Mismatch", "Please check if the baud rates of APM Planner and your autopilot are the same.");
+                }
+            }
+        }
+        if (decodeState == 1)
+        {
+            decodedFirstPacket = true;
+            protocol->logMessage(message, received);
+            protocol->alignTime(message, received);
+            // Forward before coalescing, other links get every message
+            protocol->routeMessage(link, message);
+            // The instruments read the state from here, before the GUI thread saw the message
+            protocol->updateVehicleState(message);
+            metrics.frame(message.sysid, checkSequence(message));
+            decoded.append(message);
+        }
+    }
+    if (crcErrors) metrics.add(LinkMetrics::CRC_ERRORS, crcErrors);
+    if (framingErrors) metrics.add(LinkMetrics::FRAMING_ERRORS, framingErrors);
+    if (resyncs) metrics.add(LinkMetrics::RESYNCS, resyncs);
+
+    QMutexLocker locker(&queueMutex);
+    stats.bytes += b.size();
+    stats.messages += decoded.size();
+    if (decoded.isEmpty())
+        return;
+
+    if (queue.isEmpty())
+    {
+        oldestQueuedNs = clock.nsecsElapsed();
+    }
+    for (int i = 0; i < decoded.size(); i++)
+    {
+        enqueue(decoded.at(i));
+    }
+    stats.queueDepth = queue.size();
+    stats.maxQueueDepth = qMax(stats.maxQueueDepth, queue.size());
+
+    if (!notified)
+    {
+        notified = true;
+        emit messagesReady();
+    }
+}
+
+void MAVLinkDecodeWorker::enqueue(const mavlink_message_t& message)
+{
+    quint32 key = ((quint32)message.sysid << 16) | ((quint32)message.compid << 8) | message.msgid;
+    QHash<quint32, int>::const_iterator slot = queueSlots.constEnd();
+    if (isCoalescable(message.msgid))
+    {
+        slot = queueSlots.constFind(key);
+    }
+    if (slot != queueSlots.constEnd())
+    {
+        // Keep the place in the order, but deliver the newest state
+        queue[slot.value()] = message;
+        queueCoalesced++;
+        stats.coalesced++;
+        return;
+    }
+
+    if (queue.size() >= queueCapacity)
+    {
+        // The waiting messages keep their order, the newest ones are lost
+        queueDropped++;
+        stats.dropped++;
+        return;
+    }
+    if (isCoalescable(message.msgid))
+    {
+        queueSlots.insert(key, queue.size());
+    }
+    queue.append(message);
+}
+
+int MAVLinkDecodeWorker::checkSequence(const mavlink_message_t& message)
+{
+    quint16 key = ((quint16)message.sysid << 8) | message.compid;
+    QHash<quint16, int>::iterator last = lastSequence.find(key);
+    if (last == lastSequence.end())
+    {
+        lastSequence.insert(key, message.seq);
+        return 0;
+    }
+
+    int lost = 0;
+    // NOTE: Using uint8_t here auto-wraps the number around to 0.
+    uint8_t expectedIndex = last.value() + 1;
+    if (message.seq != expectedIndex)
+    {
+        // Negative means an out of order packet, not a loss
+        int16_t lostMessages = message.seq - expectedIndex;
+        if (lostMessages > 0)
+        {
+            QMutexLocker locker(&queueMutex);
+            queueLost += lostMessages;
+            stats.lost += lostMessages;
+            lost = lostMessages;
+        }
+    }
+    last.value() = message.seq;
+    return lost;
+}
+
+QVector<mavlink_message_t> MAVLinkDecodeWorker::takeMessages(int& coalesced, int& lost)
+{
+    QMutexLocker locker(&queueMutex);
+    QVector<mavlink_message_t> messages;
+    messages.swap(queue);
+    queueSlots.clear();
+    coalesced = queueCoalesced + queueDropped;
+    lost = queueLost;
+    queueCoalesced = 0;
+    queueDropped = 0;
+    queueLost = 0;
+    notified = false;
+
+    if (!messages.isEmpty())
+    {
+        quint64 waitUs = (clock.nsecsElapsed() - oldestQueuedNs) / 1000;
+        stats.batches++;
+        stats.latencySumUs += waitUs;
+        stats.latencyMaxUs = qMax(stats.latencyMaxUs, waitUs);
+        link->getMetrics().record(LinkMetrics::HANDOVER_LATENCY, waitUs);
+    }
+    stats.queueDepth = 0;
+    return messages;
+}
+
+MAVLinkDecodeWorker::Statistics MAVLinkDecodeWorker::getStatistics()
+{
+    QMutexLocker locker(&queueMutex);
+    return stats;
+}
@@ -0,0 +1,148 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief MAVLink parser running in its own thread, one per link
+ */
+
+#ifndef MAVLINKDECODEWORKER_H
+#define MAVLINKDECODEWORKER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include "QGCMAVLink.h"
+
+class LinkInterface;
+class MAVLinkProtocol;
+
+/**
+ * Parses the bytes of one link, writes the packet log, aligns the clocks,
+ * routes, keeps the sequence loss count and writes the VehicleState
+ * snapshot of the sender in a thread of its own, so a busy GUI thread can
+ * no longer hold back the decoding or the state the instruments paint.
+ *
+ * The rest of the message handling stays in the GUI thread: the decoded
+ * messages wait in a queue until the protocol takes them from there, where
+ * handleMessage(), UAS::receiveMessage() and the MAVLinkDecoder process
+ * them. Their signals drive the UAS managers, widgets and plots that live
+ * in the GUI thread, so moving them would only move the queue.
+ *
+ * Only one notification is outstanding at a time, so the handover runs at
+ * the rate the GUI thread can take it. While a message waits, a newer
+ * message of the same type from the same component replaces it if it only
+ * carries the latest vehicle state (attitude, position, VFR_HUD, ...).
+ * Sensor, RC and servo messages are never replaced: calibrations and plots
+ * need every sample. Every other message is delivered in order, up to
+ * queueCapacity messages. Beyond that new messages are dropped and counted
+ * until the protocol takes the queue.
+ */
+class MAVLinkDecodeWorker : public QObject
+{
+    Q_OBJECT
+public:
+    struct Statistics {
+        Statistics() : bytes(0), messages(0), coalesced(0), dropped(0), lost(0), batches(0),
+            queueDepth(0), maxQueueDepth(0), latencySumUs(0), latencyMaxUs(0) {}
+        quint64 bytes;          ///< Bytes received from the link
+        quint64 messages;       ///< Messages decoded
+        quint64 coalesced;      ///< Messages replaced by a newer one while queued
+        quint64 dropped;        ///< Messages dropped because the queue was full
+        quint64 lost;           ///< Messages missing in the sequence numbers
+        quint64 batches;        ///< Handovers to the protocol
+        int queueDepth;         ///< Messages waiting for the protocol now
+        int maxQueueDepth;      ///< Most messages ever waiting
+        quint64 latencySumUs;   ///< Sum of the wait of the oldest message of each batch
+        quint64 latencyMaxUs;   ///< Longest wait of any message
+        double meanLatencyUs() const { return batches ? (double)latencySumUs / batches : 0.0; }
+    };
+
+    /** @brief Most messages waiting for the protocol, about one MB */
+    static const int queueCapacity = 4096;
+
+    /** @brief Start the decoder thread and connect it to the bytes of the link */
+    MAVLinkDecodeWorker(LinkInterface* link, MAVLinkProtocol* protocol);
+    /** @brief Stop the decoder thread, queued bytes are dropped */
+    ~MAVLinkDecodeWorker();
+
+    LinkInterface* getLink() const { return link; }
+
+    /**
+     * @brief Take all waiting messages, called from the thread of the protocol
+     * @param coalesced Set to the number of messages replaced or dropped since the last call
+     * @param lost Set to the number of messages lost since the last call
+     */
+    QVector<mavlink_message_t> takeMessages(int& coalesced, int& lost);
+
+    Statistics getStatistics();
+
+    /** @brief True for messages that only carry the latest state of a component, never for sensor, RC or servo samples */
+    static bool isCoalescable(int msgid);
+
+public slots:
+    /** @brief Decode bytes, runs in the decoder thread */
+    void receiveBytes(LinkInterface* link, QByteArray b);
+
+signals:
+    /** @brief Messages are waiting, emitted once until they were taken */
+    void messagesReady();
+    void protocolStatusMessage(const QString& title, const QString& message);
+
+protected:
+    /** @brief Queue one decoded message unless the queue is full, the queue mutex must be held */
+    void enqueue(const mavlink_message_t& message);
+    /** @brief Count lost messages from the sequence number, returns the number lost right before */
+    int checkSequence(const mavlink_message_t& message);
+
+    LinkInterface* link;
+    MAVLinkProtocol* protocol;
+    int channel;
+    QThread thread;
+    QElapsedTimer clock;
+
+    QMutex queueMutex;
+    QVector<mavlink_message_t> queue;
+    QHash<quint32, int> queueSlots;     ///< Queue index of the coalescable message per component and type
+    qint64 oldestQueuedNs;              ///< Arrival of the oldest waiting message
+    bool notified;
+    int queueCoalesced;
+    int queueDropped;
+    int queueLost;
+    Statistics stats;
+
+    QHash<quint16, int> lastSequence;   ///< Last sequence number per system and component
+
+    int mavlink09Count;
+    int nonmavlinkCount;
+    bool skipping;                      ///< The parser is skipping bytes between frames
+    bool decodedFirstPacket;
+    bool warnedUser;
+    bool checkedUserNonMavlink;
+    bool warnedUserNonMavlink;
+};
+
+#endif // MAVLINKDECODEWORKER_H
@@ -0,0 +1,385 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Link generating synthetic MAVLink telemetry for load tests
+ */
+
+#include "MAVLinkLoadLink.h"
+#include "QsLog.h"
+
+#include <QElapsedTimer>
+#include <string.h>
+
+namespace
+{
+#if MAVLINK_CRC_EXTRA
+const quint8 messageCrcs[256] = MAVLINK_MESSAGE_CRCS;
+#endif
+
+/** @brief Messages generated per call of generate() in the link thread */
+const int BATCH = 64;
+}
+
+MAVLinkLoadLink::MAVLinkLoadLink(int vehicles, int messageRate, quint32 seed, QObject* parent) :
+    LinkInterface(parent),
+    id(getNextLinkId()),
+    vehicles(qBound(1, vehicles, 255)),
+    messageRate(qMax(1, messageRate)),
+    seed(seed),
+    lossProbability(0.0),
+    corruptionProbability(0.0),
+    blockSize(16384),
+    running(false),
+    sequences(this->vehicles, 0),
+    nextVehicle(0),
+    timeUs(0),
+    generated(0),
+    dropped(0),
+    corrupted(0)
+{
+    name = tr("Load generator: %1 vehicles at %2 msg/s").arg(this->vehicles).arg(this->messageRate);
+
+    // Roughly what an ArduPilot vehicle streams at its default rates
+    mix.insert(MAVLINK_MSG_ID_HEARTBEAT, 1);
+    mix.insert(MAVLINK_MSG_ID_SYS_STATUS, 2);
+    mix.insert(MAVLINK_MSG_ID_ATTITUDE, 10);
+    mix.insert(MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 5);
+    mix.insert(MAVLINK_MSG_ID_VFR_HUD, 5);
+    mix.insert(MAVLINK_MSG_ID_RAW_IMU, 10);
+    mix.insert(MAVLINK_MSG_ID_GPS_RAW_INT, 2);
+    mix.insert(MAVLINK_MSG_ID_RC_CHANNELS_RAW, 2);
+    mix.insert(MAVLINK_MSG_ID_SERVO_OUTPUT_RAW, 2);
+    buildTemplates();
+    buildSchedule();
+}
+
+MAVLinkLoadLink::~MAVLinkLoadLink()
+{
+    // The transmit scheduler and the decoder thread stop using the link
+    announceDestruction();
+    running = false;
+    wait();
+}
+
+QList<int> MAVLinkLoadLink::supportedMessages()
+{
+    QList<int> messages;
+    messages << MAVLINK_MSG_ID_HEARTBEAT << MAVLINK_MSG_ID_SYS_STATUS << MAVLINK_MSG_ID_ATTITUDE
+             << MAVLINK_MSG_ID_GLOBAL_POSITION_INT << MAVLINK_MSG_ID_VFR_HUD << MAVLINK_MSG_ID_RAW_IMU
+             << MAVLINK_MSG_ID_GPS_RAW_INT << MAVLINK_MSG_ID_RC_CHANNELS_RAW << MAVLINK_MSG_ID_SERVO_OUTPUT_RAW;
+    return messages;
+}
+
+void MAVLinkLoadLink::setMix(const QMap<int, int>& weights)
+{
+    mix.clear();
+    QList<int> supported = supportedMessages();
+    QMap<int, int>::const_iterator i;
+    for (i = weights.constBegin(); i != weights.constEnd(); ++i)
+    {
+        if (i.value() > 0 && supported.contains(i.key()))
+        {
+            mix.insert(i.key(), i.value());
+        }
+    }
+    buildSchedule();
+}
+
+void MAVLinkLoadLink::buildTemplates()
+{
+    mavlink_message_t msg;
+    QMap<int, int> timeSizes;
+    QMap<int, bool> microseconds;
+    QList<mavlink_message_t> messages;
+
+    // Packed once for system 1, generate() patches the rest
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA,
+                               MAV_MODE_FLAG_SAFETY_ARMED | MAV_MODE_FLAG_CUSTOM_MODE_ENABLED, 5, MAV_STATE_ACTIVE);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 0);
+    mavlink_msg_sys_status_pack(1, 1, &msg, 0x3F, 0x3F, 0x3F, 250, 12400, 1520, 80, 0, 0, 0, 0, 0, 0);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 0);
+    mavlink_msg_attitude_pack(1, 1, &msg, 0, 0.05f, -0.02f, 1.57f, 0.001f, 0.002f, 0.003f);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 4);
+    mavlink_msg_global_position_int_pack(1, 1, &msg, 0, 374803910, -1222828830, 120000, 50000, 120, -30, 5, 9000);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 4);
+    mavlink_msg_vfr_hud_pack(1, 1, &msg, 12.5f, 11.8f, 90, 55, 120.0f, 0.3f);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 0);
+    mavlink_msg_raw_imu_pack(1, 1, &msg, 0, 12, -8, -1000, 3, -2, 1, 210, -45, 380);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 8);
+    microseconds.insert(msg.msgid, true);
+    mavlink_msg_gps_raw_int_pack(1, 1, &msg, 0, 3, 374803910, -1222828830, 120000, 120, 200, 1250, 9000, 11);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 8);
+    microseconds.insert(msg.msgid, true);
+    mavlink_msg_rc_channels_raw_pack(1, 1, &msg, 0, 0, 1500, 1500, 1100, 1500, 1900, 1500, 1500, 1500, 255);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 4);
+    mavlink_msg_servo_output_raw_pack(1, 1, &msg, 0, 0, 1550, 1560, 1540, 1545, 0, 0, 0, 0);
+    messages.append(msg);
+    timeSizes.insert(msg.msgid, 4);
+    microseconds.insert(msg.msgid, true);
+
+    foreach (const mavlink_message_t& message, messages)
+    {
+        Template& t = templates[message.msgid];
+        t.frame = QByteArray(MAVLINK_MAX_PACKET_LEN, 0);
+        t.frame.resize(mavlink_msg_to_send_buffer((uint8_t*)t.frame.data(), &message));
+    }
+    QMap<int, Template>::iterator t;
+    for (t = templates.begin(); t != templates.end(); ++t)
+    {
+        t.value().timeSize = timeSizes.value(t.key());
+        t.value().timeUs = microseconds.value(t.key(), false);
+#if MAVLINK_CRC_EXTRA
+        t.value().crcExtra = messageCrcs[t.key()];
+#else
+        t.value().crcExtra = 0;
+#endif
+    }
+}
+
+void MAVLinkLoadLink::buildSchedule()
+{
+    schedule.clear();
+    QMap<int, int>::const_iterator i;
+    for (i = mix.constBegin(); i != mix.constEnd(); ++i)
+    {
+        const Template* t = &templates[i.key()];
+        for (int w = 0; w < i.value(); ++w)
+        {
+            schedule.append(t);
+        }
+    }
+}
+
+double MAVLinkLoadLink::random()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / double(1 << 24);
+}
+
+int MAVLinkLoadLink::generate(QByteArray& block, int messages)
+{
+    if (schedule.isEmpty()) return 0;
+    const quint64 stepUs = qMax(1, 1000000 / messageRate);
+    int frames = 0;
+    for (int m = 0; m < messages; ++m)
+    {
+        const Template* t = schedule.at((int)(random() * schedule.size()));
+        int vehicle = nextVehicle;
+        nextVehicle = (nextVehicle + 1) % vehicles;
+        quint8 sequence = sequences[vehicle]++;
+        quint64 time = timeUs;
+        timeUs += stepUs;
+        ++generated;
+
+        if (lossProbability > 0.0 && random() < lossProbability)
+        {
+            ++dropped;
+            continue;
+        }
+
+        // Copy the template and patch what differs from message to message
+        const int size = t->frame.size();
+        const int offset = block.size();
+        block.resize(offset + size);
+        uint8_t* frame = reinterpret_cast<uint8_t*>(block.data()) + offset;
+        memcpy(frame, t->frame.constData(), size);
+        frame[2] = sequence;
+        frame[3] = vehicle + 1;
+
+        const int length = frame[1];
+        uint8_t* payload = frame + MAVLINK_NUM_HEADER_BYTES;
+        quint64 stamp = t->timeUs ? time : time / 1000;
+        for (int b = 0; b < t->timeSize; ++b)
+        {
+            // The wire format is little endian
+            payload[b] = (stamp >> (8 * b)) & 0xFF;
+        }
+
+        uint16_t checksum = crc_calculate(frame + 1, MAVLINK_CORE_HEADER_LEN + length);
+#if MAVLINK_CRC_EXTRA
+        crc_accumulate(t->crcExtra, &checksum);
+#endif
+        payload[length] = checksum & 0xFF;
+        payload[length + 1] = checksum >> 8;
+
+        if (corruptionProbability > 0.0 && random() < corruptionProbability && length > 0)
+        {
+            payload[(int)(random() * length)] ^= 0xFF;
+            ++corrupted;
+        }
+        ++frames;
+    }
+    return frames;
+}
+
+void MAVLinkLoadLink::run()
+{
+    QElapsedTimer clock;
+    clock.start();
+    quint64 sent = 0;
+
+    while (running)
+    {
+        quint64 due = (quint64)(clock.nsecsElapsed() / 1000) * messageRate / 1000000;
+        if (due <= sent)
+        {
+            msleep(1);
+            continue;
+        }
+
+        QByteArray block;
+        block.reserve(blockSize + BATCH * MAVLINK_MAX_PACKET_LEN);
+        while (sent < due && block.size() < blockSize)
+        {
+            int messages = qMin((quint64)BATCH, due - sent);
+            generate(block, messages);
+            sent += messages;
+        }
+        if (!block.isEmpty())
+        {
+            metrics.received(block.size());
+            emit bytesReceived(this, block);
+        }
+    }
+}
+
+bool MAVLinkLoadLink::connect()
+{
+    if (running) return true;
+    running = true;
+    start();
+    QLOG_INFO() << "Load generator started:" << vehicles << "vehicles at" << messageRate << "messages/s";
+    emit connected(true);
+    emit connected();
+    emit connected(this);
+    return true;
+}
+
+bool MAVLinkLoadLink::disconnect()
+{
+    if (!running) return true;
+    running = false;
+    wait();
+    QLOG_INFO() << "Load generator stopped after" << generated << "messages," << dropped << "lost,"
+                << corrupted << "corrupted";
+    emit connected(false);
+    emit disconnected();
+    emit disconnected(this);
+    return true;
+}
+
+bool MAVLinkLoadLink::isConnected()
+{
+    return running;
+}
+
+void MAVLinkLoadLink::writeBytes(const char* data, qint64 size)
+{
+    Q_UNUSED(data);
+    metrics.sent(size);
+}
+
+void MAVLinkLoadLink::readBytes()
+{
+    // The link thread delivers on its own
+}
+
+qint64 MAVLinkLoadLink::bytesAvailable()
+{
+    return 0;
+}
+
+int MAVLinkLoadLink::getId()
+{
+    return id;
+}
+
+QString MAVLinkLoadLink::getName()
+{
+    return name;
+}
+
+qint64 MAVLinkLoadLink::getNominalDataRate()
+{
+    // Average frame of the default mix is about 30 bytes
+    return (qint64)messageRate * 30 * 8;
+}
+
+bool MAVLinkLoadLink::isFullDuplex()
+{
+    return true;
+}
+
+int MAVLinkLoadLink::getLinkQuality()
+{
+    return qRound(100.0 * (1.0 - lossProbability - corruptionProbability));
+}
+
+qint64 MAVLinkLoadLink::getTotalUpstream()
+{
+    return metrics.meanRate(LinkMetrics::BYTES_SENT) * 8;
+}
+
+qint64 MAVLinkLoadLink::getCurrentUpstream()
+{
+    return metrics.window(1).rate(LinkMetrics::BYTES_SENT) * 8;
+}
+
+qint64 MAVLinkLoadLink::getMaxUpstream()
+{
+    return metrics.peakRate(LinkMetrics::BYTES_SENT) * 8;
+}
+
+qint64 MAVLinkLoadLink::getTotalDownstream()
+{
+    return metrics.meanRate(LinkMetrics::BYTES_RECEIVED) * 8;
+}
+
+qint64 MAVLinkLoadLink::getCurrentDownstream()
+{
+    return metrics.window(1).rate(LinkMetrics::BYTES_RECEIVED) * 8;
+}
+
+qint64 MAVLinkLoadLink::getMaxDownstream()
+{
+    return metrics.peakRate(LinkMetrics::BYTES_RECEIVED) * 8;
+}
+
+qint64 MAVLinkLoadLink::getBitsSent()
+{
+    return metrics.total(LinkMetrics::BYTES_SENT) * 8;
+}
+
+qint64 MAVLinkLoadLink::getBitsReceived()
+{
+    return metrics.total(LinkMetrics::BYTES_RECEIVED) * 8;
+}
@@ -0,0 +1,157 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Link generating synthetic MAVLink telemetry for load tests
+ */
+
+#ifndef MAVLINKLOADLINK_H
+#define MAVLINKLOADLINK_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include "QGCMAVLink.h"
+#include "LinkInterface.h"
+
+/**
+ * @brief Emits a configurable mix of telemetry for many simulated vehicles.
+ *
+ * Every message type is packed once into a wire frame template. Generating
+ * a message copies its template into the outgoing block and only patches
+ * the sequence number, the system id, the timestamp and the checksum, so
+ * hundreds of thousands of messages per second cost little more than the
+ * copy. The blocks are delivered through bytesReceived() like the bytes of
+ * a real link and run through the whole pipeline from the decoder on.
+ *
+ * The output only depends on the seed and the configuration: the vehicles
+ * take turns, the message types and the injected losses and corruptions
+ * come from a seeded pseudo-random sequence. A lost message still uses up
+ * its sequence number, a corrupted one has a payload byte flipped so it
+ * fails the checksum.
+ */
+class MAVLinkLoadLink : public LinkInterface
+{
+    Q_OBJECT
+public:
+    /**
+     * @param vehicles Number of simulated vehicles, system ids 1 to vehicles
+     * @param messageRate Messages per second of all vehicles together
+     * @param seed Start of the pseudo-random sequence
+     */
+    MAVLinkLoadLink(int vehicles = 1, int messageRate = 1000, quint32 seed = 1, QObject* parent = 0);
+    ~MAVLinkLoadLink();
+
+    /** @brief Relative weight per message id, unsupported ids are ignored */
+    void setMix(const QMap<int, int>& weights);
+    QMap<int, int> getMix() const { return mix; }
+    /** @brief Message ids the generator has templates for */
+    static QList<int> supportedMessages();
+
+    void setLossProbability(double probability) { lossProbability = probability; }
+    void setCorruptionProbability(double probability) { corruptionProbability = probability; }
+    /** @brief Bytes per delivered block at most, plus one frame */
+    void setBlockSize(int bytes) { blockSize = qMax(bytes, (int)MAVLINK_MAX_PACKET_LEN); }
+    int getVehicles() const { return vehicles; }
+    int getMessageRate() const { return messageRate; }
+
+    /**
+     * @brief Append the frames of the next messages to a block
+     *
+     * The link thread calls it while connected, tests call it directly.
+     * @return The number of frames appended, lost messages are not
+     */
+    int generate(QByteArray& block, int messages);
+
+    /** @brief Counts of the generator, only exact while the link is disconnected */
+    quint64 getGenerated() const { return generated; }
+    quint64 getDropped() const { return dropped; }
+    quint64 getCorrupted() const { return corrupted; }
+
+    /* LinkInterface */
+    int getId();
+    QString getName();
+    void requestReset() { }
+    bool isConnected();
+    qint64 getNominalDataRate();
+    bool isFullDuplex();
+    int getLinkQuality();
+    qint64 getTotalUpstream();
+    qint64 getCurrentUpstream();
+    qint64 getMaxUpstream();
+    qint64 getTotalDownstream();
+    qint64 getCurrentDownstream();
+    qint64 getMaxDownstream();
+    qint64 getBitsSent();
+    qint64 getBitsReceived();
+    bool connect();
+    bool disconnect();
+    qint64 bytesAvailable();
+
+    void run();
+
+public slots:
+    /** @brief Commands of the ground station are counted and dropped */
+    void writeBytes(const char* data, qint64 size);
+
+protected slots:
+    void readBytes();
+
+protected:
+    struct Template
+    {
+        QByteArray frame;   ///< Complete wire frame of system 1
+        int timeSize;       ///< Bytes of the timestamp at the start of the payload, 0 for none
+        bool timeUs;        ///< The timestamp is in microseconds, else milliseconds
+        quint8 crcExtra;
+    };
+
+    void buildTemplates();
+    void buildSchedule();
+    /** @brief Deterministic uniform number in 0..1 */
+    double random();
+
+    int id;
+    QString name;
+    int vehicles;
+    int messageRate;
+    quint32 seed;
+    double lossProbability;
+    double corruptionProbability;
+    int blockSize;
+    volatile bool running;
+
+    QMap<int, int> mix;
+    QMap<int, Template> templates;
+    QVector<const Template*> schedule;  ///< Templates repeated by weight, indexed by a random number
+    QVector<quint8> sequences;          ///< Next sequence number per vehicle
+    int nextVehicle;
+    quint64 timeUs;                     ///< Simulated time of the next message
+
+    quint64 generated;
+    quint64 dropped;
+    quint64 corrupted;
+};
+
+#endif // MAVLINKLOADLINK_H
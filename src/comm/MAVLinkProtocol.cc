@@ -19,9 +19,11 @@
 #include "ArduPilotMegaMAV.h"
 #include "configuration.h"
 #include "LinkManager.h"
+#include "LinkTxScheduler.h"
 #include "QGCMAVLink.h"
 #include "QGCMAVLinkUASFactory.h"
 #include "QGC.h"
+#include "QGCTimebase.h"
 
 #include <inttypes.h>
 #include <iostream>
@@ -70,6 +72,7 @@ MAVLinkProtocol::MAVLinkProtocol() :
     totalLossCounter = 0;
     currReceiveCounter = 0;
     currLossCounter = 0;
+    lastDecodeReport = 0;
     for (int i = 0; i < 256; i++)
     {
         for (int j = 0; j < 256; j++)
@@ -78,6 +81,21 @@ MAVLinkProtocol::MAVLinkProtocol() :
         }
     }
 
+    // Messages stamped with the onboard boot time align the clock of the vehicle
+    static const mavlink_message_info_t messageInfo[256] = MAVLINK_MESSAGE_INFO;
+    for (int i = 0; i < 256; i++)
+    {
+        bootTimeOffset[i] = -1;
+        for (unsigned int f = 0; f < messageInfo[i].num_fields; f++)
+        {
+            if (qstrcmp(messageInfo[i].fields[f].name, "time_boot_ms") == 0 && messageInfo[i].fields[f].type == MAVLINK_TYPE_UINT32_T)
+            {
+                bootTimeOffset[i] = messageInfo[i].fields[f].wire_offset;
+                break;
+            }
+        }
+    }
+
     emit versionCheckChanged(m_enable_version_check);
 }
 
@@ -153,6 +171,9 @@ void MAVLinkProtocol::storeSettings()
 MAVLinkProtocol::~MAVLinkProtocol()
 {
     storeSettings();
+    // The decoder threads write to the logfile
+    qDeleteAll(decodeWorkers);
+    decodeWorkers.clear();
     if (m_logfile)
     {
         if (m_logfile->isOpen())
@@ -190,6 +211,7 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 //    receiveMutex.lock();
     mavlink_message_t message;
     mavlink_status_t status;
+    quint64 received = QGC::groundTimeUsecs();
 
     static int mavlink09Count = 0;
     static int nonmavlinkCount = 0;
@@ -313,154 +335,308 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
             }
 #endif
 
-            // Log data
-            if (m_loggingEnabled && m_logfile)
-            {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)] = {0};
-                quint64 time = QGC::groundTimeUsecs();
-                memcpy(buf, (void*)&time, sizeof(quint64));
-                // Write message to buffer
-                mavlink_msg_to_send_buffer(buf+sizeof(quint64), &message);
-                //we need to write the maximum package length for having a
-                //consistent file structure and beeing able to parse it again
-                int len = MAVLINK_MAX_PACKET_LEN + sizeof(quint64);
-                QByteArray b((const char*)buf, len);
-                if(m_logfile->write(b) != len)
-                {
-                    emit protocolStatusMessage(tr("MAVLink Logging failed"), tr("Could not write to file %1, disabling logging.").arg(m_logfile->fileName()));
-                    // Stop logging
-                    enableLogging(false);
-                }
-            }
+            logMessage(message, received);
+            alignTime(message, received);
+            routeMessage(link, message);
+            updateVehicleState(message);
+            handleMessage(link, message, true);
+        }
+    }
+}
 
-            // ORDER MATTERS HERE!
-            // If the matching UAS object does not yet exist, it has to be created
-            // before emitting the packetReceived signal
+void MAVLinkProtocol::handleMessage(LinkInterface* link, const mavlink_message_t& message, bool countSequence)
+{
+    // ORDER MATTERS HERE!
+    // If the matching UAS object does not yet exist, it has to be created
+    // before emitting the packetReceived signal
 
-            UASInterface* uas = UASManager::instance()->getUASForId(message.sysid);
+    UASInterface* uas = UASManager::instance()->getUASForId(message.sysid);
 
-            // Check and (if necessary) create UAS object
-            if (uas == NULL && message.msgid == MAVLINK_MSG_ID_HEARTBEAT)
+    // Check and (if necessary) create UAS object
+    if (uas == NULL && message.msgid == MAVLINK_MSG_ID_HEARTBEAT)
+    {
+        // ORDER MATTERS HERE!
+        // The UAS object has first to be created and connected,
+        // only then the rest of the application can be made aware
+        // of its existence, as it only then can send and receive
+        // it's first messages.
+
+        // Check if the UAS has the same id like this system
+        if (message.sysid == getSystemId())
+        {
+            emit protocolStatusMessage(tr("SYSTEM ID CONFLICT!"), tr("Warning: A second system is using the same system id (%1)").arg(getSystemId()));
+        }
+
+        // Create a new UAS based on the heartbeat received
+        // Todo dynamically load plugin at run-time for MAV
+        // WIKISEARCH:AUTOPILOT_TYPE_INSTANTIATION
+
+        // First create new UAS object
+        // Decode heartbeat message
+        mavlink_heartbeat_t heartbeat;
+        // Reset version field to 0
+        heartbeat.mavlink_version = 0;
+        mavlink_msg_heartbeat_decode(&message, &heartbeat);
+
+        // Check if the UAS has a different protocol version
+        if (m_enable_version_check && (heartbeat.mavlink_version != MAVLINK_VERSION))
+        {
+            // Bring up dialog to inform user
+            if (!versionMismatchIgnore)
             {
-                // ORDER MATTERS HERE!
-                // The UAS object has first to be created and connected,
-                // only then the rest of the application can be made aware
-                // of its existence, as it only then can send and receive
-                // it's first messages.
-
-                // Check if the UAS has the same id like this system
-                if (message.sysid == getSystemId())
-                {
-                    emit protocolStatusMessage(tr("SYSTEM ID CONFLICT!"), tr("Warning: A second system is using the same system id (%1)").arg(getSystemId()));
-                }
+                emit protocolStatusMessage(tr("The MAVLink protocol version on the MAV and APM Planner mismatch!"),
+                                           tr("It is unsafe to use different MAVLink versions. APM Planner therefore refuses to connect to system %1, which sends MAVLink version %2 (APM Planner uses version %3).").arg(message.sysid).arg(heartbeat.mavlink_version).arg(MAVLINK_VERSION));
+                versionMismatchIgnore = true;
+            }
 
-                // Create a new UAS based on the heartbeat received
-                // Todo dynamically load plugin at run-time for MAV
-                // WIKISEARCH:AUTOPILOT_TYPE_INSTANTIATION
+            // Ignore this message and continue gracefully
+            return;
+        }
 
-                // First create new UAS object
-                // Decode heartbeat message
-                mavlink_heartbeat_t heartbeat;
-                // Reset version field to 0
-                heartbeat.mavlink_version = 0;
-                mavlink_msg_heartbeat_decode(&message, &heartbeat);
+        // Create a new UAS object
+        uas = QGCMAVLinkUASFactory::createUAS(this, link, message.sysid, &heartbeat);
 
-                // Check if the UAS has a different protocol version
-                if (m_enable_version_check && (heartbeat.mavlink_version != MAVLINK_VERSION))
-                {
-                    // Bring up dialog to inform user
-                    if (!versionMismatchIgnore)
-                    {
-                        emit protocolStatusMessage(tr("The MAVLink protocol version on the MAV and APM Planner mismatch!"),
-                                                   tr("It is unsafe to use different MAVLink versions. APM Planner therefore refuses to connect to system %1, which sends MAVLink version %2 (APM Planner uses version %3).").arg(message.sysid).arg(heartbeat.mavlink_version).arg(MAVLINK_VERSION));
-                        versionMismatchIgnore = true;
-                    }
+    }
 
-                    // Ignore this message and continue gracefully
-                    continue;
-                }
+    // Only count message if UAS exists for this message
+    if (uas != NULL)
+    {
 
-                // Create a new UAS object
-                uas = QGCMAVLinkUASFactory::createUAS(this, link, message.sysid, &heartbeat);
+        // Increase receive counter
+        totalReceiveCounter++;
+        currReceiveCounter++;
 
+        if (countSequence)
+        {
+            // Update last message sequence ID
+            uint8_t expectedIndex;
+            if (lastIndex[message.sysid][message.compid] == -1)
+            {
+                lastIndex[message.sysid][message.compid] = message.seq;
+                expectedIndex = message.seq;
             }
-
-            // Only count message if UAS exists for this message
-            if (uas != NULL)
+            else
             {
+                // NOTE: Using uint8_t here auto-wraps the number around to 0.
+                expectedIndex = lastIndex[message.sysid][message.compid] + 1;
+            }
 
-                // Increase receive counter
-                totalReceiveCounter++;
-                currReceiveCounter++;
-
-                // Update last message sequence ID
-                uint8_t expectedIndex;
-                if (lastIndex[message.sysid][message.compid] == -1)
+            // Make some noise if a message was skipped
+            //QLOG_DEBUG() << "SYSID" << message.sysid << "COMPID" << message.compid << "MSGID" << message.msgid << "EXPECTED INDEX:" << expectedIndex << "SEQ" << message.seq;
+            if (message.seq != expectedIndex)
+            {
+                // Determine how many messages were skipped accounting for 0-wraparound
+                int16_t lostMessages = message.seq - expectedIndex; 
+                if (lostMessages < 0)
                 {
-                    lastIndex[message.sysid][message.compid] = message.seq;
-                    expectedIndex = message.seq;
+                    // Usually, this happens in the case of an out-of order packet
+                    lostMessages = 0;
                 }
                 else
                 {
-                    // NOTE: Using uint8_t here auto-wraps the number around to 0.
-                    expectedIndex = lastIndex[message.sysid][message.compid] + 1;
+                    // Console generates excessive load at high loss rates, needs better GUI visualization
+                    //QLOG_DEBUG() << QString("Lost %1 messages for comp %4: expected sequence ID %2 but received %3.").arg(lostMessages).arg(expectedIndex).arg(message.seq).arg(message.compid);
                 }
+                totalLossCounter += lostMessages;
+                currLossCounter += lostMessages;
+            }
 
-                // Make some noise if a message was skipped
-                //QLOG_DEBUG() << "SYSID" << message.sysid << "COMPID" << message.compid << "MSGID" << message.msgid << "EXPECTED INDEX:" << expectedIndex << "SEQ" << message.seq;
-                if (message.seq != expectedIndex)
-                {
-                    // Determine how many messages were skipped accounting for 0-wraparound
-                    int16_t lostMessages = message.seq - expectedIndex; 
-                    if (lostMessages < 0)
-                    {
-                        // Usually, this happens in the case of an out-of order packet
-                        lostMessages = 0;
-                    }
-                    else
-                    {
-                        // Console generates excessive load at high loss rates, needs better GUI visualization
-                        //QLOG_DEBUG() << QString("Lost %1 messages for comp %4: expected sequence ID %2 but received %3.").arg(lostMessages).arg(expectedIndex).arg(message.seq).arg(message.compid);
-                    }
-                    totalLossCounter += lostMessages;
-                    currLossCounter += lostMessages;
-                }
+            // Update the last sequence ID
+            lastIndex[message.sysid][message.compid] = message.seq;
+        }
 
-                // Update the last sequence ID
-                lastIndex[message.sysid][message.compid] = message.seq;
+        // Update on every 32th packet
+        if (totalReceiveCounter % 32 == 0)
+        {
+            // Calculate new loss ratio
+            // Receive loss
+            float receiveLoss = (double)currLossCounter/(double)(currReceiveCounter+currLossCounter);
+            receiveLoss *= 100.0f;
+            currLossCounter = 0;
+            currReceiveCounter = 0;
+            emit receiveLossChanged(message.sysid, receiveLoss);
+        }
 
-                // Update on every 32th packet
-                if (totalReceiveCounter % 32 == 0)
-                {
-                    // Calculate new loss ratio
-                    // Receive loss
-                    float receiveLoss = (double)currLossCounter/(double)(currReceiveCounter+currLossCounter);
-                    receiveLoss *= 100.0f;
-                    currLossCounter = 0;
-                    currReceiveCounter = 0;
-                    emit receiveLossChanged(message.sysid, receiveLoss);
-                }
+        // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+        // kind of inefficient, but no issue for a groundstation pc.
+        // It buys as reentrancy for the whole code over all threads
+        emit messageReceived(link, message);
+    }
+}
 
-                // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-                // kind of inefficient, but no issue for a groundstation pc.
-                // It buys as reentrancy for the whole code over all threads
-                emit messageReceived(link, message);
+void MAVLinkProtocol::routeMessage(LinkInterface* link, const mavlink_message_t& message)
+{
+    // Multiplex message if enabled
+    if (!m_multiplexingEnabled)
+        return;
+    router.forward(link, message, getSystemId());
+}
 
-                // Multiplex message if enabled
-                if (m_multiplexingEnabled)
-                {
-                    // Get all links connected to this unit
-                    QList<LinkInterface*> links = LinkManager::instance()->getLinksForProtocol(this);
+void MAVLinkProtocol::addVehicleState(int sysid, VehicleStateBuffer* buffer)
+{
+    QMutexLocker locker(&vehicleStateMutex);
+    vehicleStates.insert(sysid, buffer);
+}
 
-                    // Emit message on all links that are currently connected
-                    foreach (LinkInterface* currLink, links)
-                    {
-                        // Only forward this message to the other links,
-                        // not the link the message was received on
-                        if (currLink != link) sendMessage(currLink, message, message.sysid, message.compid);
-                    }
-                }
-            }
+void MAVLinkProtocol::removeVehicleState(int sysid, VehicleStateBuffer* buffer)
+{
+    QMutexLocker locker(&vehicleStateMutex);
+    if (vehicleStates.value(sysid) == buffer)
+    {
+        vehicleStates.remove(sysid);
+    }
+}
+
+void MAVLinkProtocol::updateVehicleState(const mavlink_message_t& message)
+{
+    // Held while writing, several links can carry the same system
+    QMutexLocker locker(&vehicleStateMutex);
+    VehicleStateBuffer* buffer = vehicleStates.value(message.sysid);
+    if (buffer)
+    {
+        buffer->update(message, QGC::groundTimeMilliseconds());
+    }
+}
+
+void MAVLinkProtocol::forwardMessage(LinkInterface* link, const mavlink_message_t& message)
+{
+    if (!link || !link->isConnected())
+        return;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &message);
+    // Forwarded frames are dropped rather than waiting for room on a slow link
+    LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, len, false);
+}
+
+void MAVLinkProtocol::logMessage(const mavlink_message_t& message, quint64 time)
+{
+    if (!m_loggingEnabled)
+        return;
+
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)] = {0};
+    memcpy(buf, (void*)&time, sizeof(quint64));
+    // Write message to buffer
+    mavlink_msg_to_send_buffer(buf+sizeof(quint64), &message);
+    //we need to write the maximum package length for having a
+    //consistent file structure and beeing able to parse it again
+    int len = MAVLINK_MAX_PACKET_LEN + sizeof(quint64);
+    QByteArray b((const char*)buf, len);
+
+    QString failedFile;
+    {
+        QMutexLocker locker(&logMutex);
+        if (!m_logfile || !m_logfile->isOpen())
+            return;
+        if (m_logfile->write(b) != len)
+            failedFile = m_logfile->fileName();
+    }
+
+    if (!failedFile.isEmpty())
+    {
+        emit protocolStatusMessage(tr("MAVLink Logging failed"), tr("Could not write to file %1, disabling logging.").arg(failedFile));
+        // Stop logging, from the thread of the protocol
+        QMetaObject::invokeMethod(this, "enableLogging", Qt::AutoConnection, Q_ARG(bool, false));
+    }
+}
+
+void MAVLinkProtocol::alignTime(const mavlink_message_t& message, quint64 time)
+{
+    int offset = bootTimeOffset[message.msgid];
+    if (offset >= 0)
+    {
+        QGCTimebase::instance()->addBootTime(message.sysid, _MAV_RETURN_uint32_t(&message, offset), time);
+    }
+    // After the boot time, a reboot also restarts the onboard Unix time
+    if (message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME)
+    {
+        QGCTimebase::instance()->addUnixTime(message.sysid, mavlink_msg_system_time_get_time_unix_usec(&message), time);
+    }
+}
+
+void MAVLinkProtocol::addLink(LinkInterface* link)
+{
+    router.addLink(link);
+#if defined(QGC_PROTOBUF_ENABLED)
+    // Extended messages need the whole datagram, they are decoded in receiveBytes()
+    ProtocolInterface::addLink(link);
+#else
+    if (decodeWorkers.contains(link))
+        return;
+
+    MAVLinkDecodeWorker* worker = new MAVLinkDecodeWorker(link, this);
+    connect(worker, SIGNAL(messagesReady()), this, SLOT(receiveDecodedMessages()), Qt::QueuedConnection);
+    connect(worker, SIGNAL(protocolStatusMessage(QString,QString)), this, SIGNAL(protocolStatusMessage(QString,QString)), Qt::QueuedConnection);
+    // Direct, the decoder thread must stop before the link is torn down
+    connect(link, SIGNAL(aboutToBeDestroyed(LinkInterface*)), this, SLOT(linkDestroyed(LinkInterface*)), Qt::DirectConnection);
+    decodeWorkers.insert(link, worker);
+#endif
+}
+
+void MAVLinkProtocol::removeLink(LinkInterface* link)
+{
+    ProtocolInterface::removeLink(link);
+    router.removeLink(link);
+    MAVLinkDecodeWorker* worker = decodeWorkers.take(link);
+    if (worker)
+    {
+        disconnect(link, SIGNAL(aboutToBeDestroyed(LinkInterface*)), this, SLOT(linkDestroyed(LinkInterface*)));
+        delete worker;
+    }
+}
+
+void MAVLinkProtocol::linkDestroyed(LinkInterface* link)
+{
+    router.removeLink(link);
+    // Joins the decoder thread, it may be using the metrics of the link right now
+    delete decodeWorkers.take(link);
+}
+
+MAVLinkDecodeWorker::Statistics MAVLinkProtocol::getDecodeStatistics(LinkInterface* link)
+{
+    MAVLinkDecodeWorker* worker = decodeWorkers.value(link);
+    if (!worker)
+        return MAVLinkDecodeWorker::Statistics();
+    return worker->getStatistics();
+}
+
+void MAVLinkProtocol::receiveDecodedMessages()
+{
+    // Handling a message can add or remove links, look each one up again
+    foreach (LinkInterface* link, decodeWorkers.keys())
+    {
+        MAVLinkDecodeWorker* worker = decodeWorkers.value(link);
+        if (!worker)
+            continue;
+
+        int coalesced = 0;
+        int lost = 0;
+        QVector<mavlink_message_t> messages = worker->takeMessages(coalesced, lost);
+
+        // Replaced and dropped messages were received, they only were not handed on
+        totalReceiveCounter += coalesced;
+        currReceiveCounter += coalesced;
+        totalLossCounter += lost;
+        currLossCounter += lost;
+
+        for (int i = 0; i < messages.size(); i++)
+        {
+            handleMessage(link, messages.at(i), false);
+            if (!decodeWorkers.contains(link))
+                break;
+        }
+    }
+
+    quint64 now = QGC::groundTimeMilliseconds();
+    if (now - lastDecodeReport > 10000)
+    {
+        lastDecodeReport = now;
+        QMap<LinkInterface*, MAVLinkDecodeWorker*>::const_iterator i;
+        for (i = decodeWorkers.constBegin(); i != decodeWorkers.constEnd(); ++i)
+        {
+            MAVLinkDecodeWorker::Statistics stats = i.value()->getStatistics();
+            QLOG_DEBUG() << "MAVLink decoder" << i.key()->getName() << ":" << stats.messages << "messages,"
+                         << stats.coalesced << "coalesced," << stats.dropped << "dropped, queue max" << stats.maxQueueDepth
+                         << ", handover latency mean" << stats.meanLatencyUs() << "us max" << stats.latencyMaxUs << "us";
         }
     }
 }
@@ -524,7 +700,7 @@ void MAVLinkProtocol::sendMessage(LinkInterface* link, mavlink_message_t message
     if (link->isConnected())
     {
         // Send the portion of the buffer now occupied by the message
-        link->writeBytes((const char*)buffer, len);
+        LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, len);
     }
 }
 
@@ -547,7 +723,7 @@ void MAVLinkProtocol::sendMessage(LinkInterface* link, mavlink_message_t message
     if (link->isConnected())
     {
         // Send the portion of the buffer now occupied by the message
-        link->writeBytes((const char*)buffer, len);
+        LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, len);
     }
 }
 
@@ -588,6 +764,8 @@ void MAVLinkProtocol::enableMultiplexing(bool enabled)
     if (enabled != m_multiplexingEnabled) changed = true;
 
     m_multiplexingEnabled = enabled;
+    // Routes are only learned while multiplexing
+    if (!enabled) router.clearRoutes();
     if (changed) emit multiplexingChanged(m_multiplexingEnabled);
 }
 
@@ -648,15 +826,23 @@ void MAVLinkProtocol::enableLogging(bool enabled)
 
     if (enabled)
     {
-        if (m_logfile && m_logfile->isOpen())
+        bool opened = true;
         {
-            m_logfile->flush();
-            m_logfile->close();
+            QMutexLocker locker(&logMutex);
+            if (m_logfile && m_logfile->isOpen())
+            {
+                m_logfile->flush();
+                m_logfile->close();
+            }
+            if (m_logfile)
+            {
+                opened = m_logfile->open(QIODevice::WriteOnly | QIODevice::Append);
+            }
         }
 
         if (m_logfile)
         {
-            if (!m_logfile->open(QIODevice::WriteOnly | QIODevice::Append))
+            if (!opened)
             {
                 emit protocolStatusMessage(tr("Opening MAVLink logfile for writing failed"), tr("MAVLink cannot log to the file %1, please choose a different file. Stopping logging.").arg(m_logfile->fileName()));
                 m_loggingEnabled = false;
@@ -669,6 +855,7 @@ void MAVLinkProtocol::enableLogging(bool enabled)
     }
     else if (!enabled)
     {
+        QMutexLocker locker(&logMutex);
         if (m_logfile)
         {
             if (m_logfile->isOpen())
@@ -684,16 +871,19 @@ void MAVLinkProtocol::enableLogging(bool enabled)
 
 void MAVLinkProtocol::setLogfileName(const QString& filename)
 {
-    if (!m_logfile)
     {
-        m_logfile = new QFile(filename);
-    }
-    else
-    {
-        m_logfile->flush();
-        m_logfile->close();
+        QMutexLocker locker(&logMutex);
+        if (!m_logfile)
+        {
+            m_logfile = new QFile(filename);
+        }
+        else
+        {
+            m_logfile->flush();
+            m_logfile->close();
+        }
+        m_logfile->setFileName(filename);
     }
-    m_logfile->setFileName(filename);
     enableLogging(m_loggingEnabled);
 }
 
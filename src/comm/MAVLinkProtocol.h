@@ -36,11 +36,15 @@ This file is part of the QGROUNDCONTROL project
 #include <QTimer>
 #include <QFile>
 #include <QMap>
+#include <QHash>
 #include <QByteArray>
 #include "ProtocolInterface.h"
 #include "LinkInterface.h"
 #include "QGCMAVLink.h"
 #include "QGC.h"
+#include "MAVLinkDecodeWorker.h"
+#include "MAVLinkRouter.h"
+#include "VehicleState.h"
 
 #if defined(QGC_PROTOBUF_ENABLED)
 #include <tr1/memory>
@@ -125,6 +129,30 @@ public:
         return m_actionRetransmissionTimeout;
     }
 
+    /** @brief Decode the bytes of this link in a thread of its own */
+    void addLink(LinkInterface* link);
+    /** @brief Stop the decoder thread of this link */
+    void removeLink(LinkInterface* link);
+    /** @brief Statistics of the decoder thread of a link, all zero if it has none */
+    MAVLinkDecodeWorker::Statistics getDecodeStatistics(LinkInterface* link);
+    /** @brief Write a message that arrived at time (ground time in us) to the packet log if logging is enabled, thread safe */
+    void logMessage(const mavlink_message_t& message, quint64 time);
+    /** @brief Align the clock of the sender to the onboard time of a message that arrived at time, thread safe */
+    void alignTime(const mavlink_message_t& message, quint64 time);
+    /** @brief Forward a received message to the links of its target if multiplexing is enabled, thread safe */
+    void routeMessage(LinkInterface* link, const mavlink_message_t& message);
+    /** @brief Let the decoder threads write the state of system sysid into buffer */
+    void addVehicleState(int sysid, VehicleStateBuffer* buffer);
+    /** @brief Stop writing to buffer, returns after a decoder thread that is writing to it finished */
+    void removeVehicleState(int sysid, VehicleStateBuffer* buffer);
+    /** @brief Write the state a message carries into the snapshot of its system, thread safe */
+    void updateVehicleState(const mavlink_message_t& message);
+    /** @brief Send a message to one link unchanged, with the header and checksum it was received with */
+    void forwardMessage(LinkInterface* link, const mavlink_message_t& message);
+    /** @brief Routes learned for multiplexing and their counters */
+    QList<MAVLinkRouter::Route> getRoutes() { return router.getRoutes(); }
+    MAVLinkRouter::Statistics getRouterStatistics() { return router.getStatistics(); }
+
 public slots:
     /** @brief Receive bytes from a communication interface */
     void receiveBytes(LinkInterface* link, QByteArray b);
@@ -185,7 +213,19 @@ public slots:
     /** @brief Store protocol settings */
     void storeSettings();
 
+protected slots:
+    /** @brief Take the decoded messages of all decoder threads and handle them in the GUI thread */
+    void receiveDecodedMessages();
+    /** @brief Stop and join the decoder thread of a link that is being deleted, runs before the link is torn down */
+    void linkDestroyed(LinkInterface* link);
+
 protected:
+    /**
+     * @brief Create the UAS if needed and emit one decoded message
+     * @param countSequence Count lost messages here, false if a decoder thread did
+     */
+    void handleMessage(LinkInterface* link, const mavlink_message_t& message, bool countSequence);
+
     QTimer* heartbeatTimer;    ///< Timer to emit heartbeats
     int heartbeatRate;         ///< Heartbeat rate, controls the timer interval
     bool m_heartbeatsEnabled;  ///< Enabled/disable heartbeat emission
@@ -201,6 +241,13 @@ protected:
     bool m_actionGuardEnabled;       ///< Action request retransmission enabled
     int m_actionRetransmissionTimeout; ///< Timeout for parameter retransmission
     QMutex receiveMutex;       ///< Mutex to protect receiveBytes function
+    QMutex logMutex;           ///< Protects the logfile, decoder threads write to it
+    QMap<LinkInterface*, MAVLinkDecodeWorker*> decodeWorkers;
+    QMutex vehicleStateMutex;  ///< Protects vehicleStates and serializes the writers of each snapshot
+    QHash<int, VehicleStateBuffer*> vehicleStates; ///< Snapshot per system id
+    MAVLinkRouter router;      ///< Forwarding between links when multiplexing is enabled
+    quint64 lastDecodeReport;  ///< Time the decoder statistics were last logged
+    int bootTimeOffset[256];   ///< Wire offset of the time_boot_ms field per message, -1 if it has none
     int lastIndex[256][256];	///< Store the last received sequence ID for each system/componenet pair
     int totalReceiveCounter;
     int totalLossCounter;
@@ -0,0 +1,229 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Learned MAVLink routing between links
+ */
+
+#include "MAVLinkRouter.h"
+#include "LinkInterface.h"
+#include "LinkTxScheduler.h"
+#include "QGC.h"
+
+#include <QMutexLocker>
+#include <QVarLengthArray>
+#include <string.h>
+
+MAVLinkRouter::MAVLinkRouter()
+{
+    // Find the target fields once, the same way the message inspector walks the fields
+    mavlink_message_info_t info[256] = MAVLINK_MESSAGE_INFO;
+    for (int msgid = 0; msgid < 256; msgid++)
+    {
+        targetSystemOffset[msgid] = -1;
+        targetComponentOffset[msgid] = -1;
+        for (unsigned int field = 0; field < info[msgid].num_fields; field++)
+        {
+            const mavlink_field_info_t& fieldInfo = info[msgid].fields[field];
+            if (!fieldInfo.name || fieldInfo.array_length != 0) continue;
+            if (strcmp(fieldInfo.name, "target_system") == 0)
+            {
+                targetSystemOffset[msgid] = fieldInfo.wire_offset;
+            }
+            else if (strcmp(fieldInfo.name, "target_component") == 0)
+            {
+                targetComponentOffset[msgid] = fieldInfo.wire_offset;
+            }
+        }
+    }
+}
+
+MAVLinkRouter::~MAVLinkRouter()
+{
+}
+
+void MAVLinkRouter::addLink(LinkInterface* link)
+{
+    QMutexLocker locker(&mutex);
+    if (!links.contains(link)) links.append(link);
+}
+
+void MAVLinkRouter::removeLink(LinkInterface* link)
+{
+    QMutexLocker locker(&mutex);
+    links.removeAll(link);
+    QHash<quint16, Route>::iterator i = routes.begin();
+    while (i != routes.end())
+    {
+        if (i.value().link == link)
+        {
+            i = routes.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+void MAVLinkRouter::clearRoutes()
+{
+    QMutexLocker locker(&mutex);
+    routes.clear();
+}
+
+void MAVLinkRouter::getTarget(const mavlink_message_t& message, int& systemId, int& componentId) const
+{
+    systemId = -1;
+    componentId = -1;
+    const uint8_t* payload = reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message));
+    int offset = targetSystemOffset[message.msgid];
+    if (offset >= 0 && offset < message.len) systemId = payload[offset];
+    offset = targetComponentOffset[message.msgid];
+    if (offset >= 0 && offset < message.len) componentId = payload[offset];
+}
+
+int MAVLinkRouter::forward(LinkInterface* source, const mavlink_message_t& message, int ownSystemId)
+{
+    int targetSystem;
+    int targetComponent;
+    getTarget(message, targetSystem, targetComponent);
+    // Size of the frame on the wire, it is only serialized if it goes anywhere
+    int length = MAVLINK_NUM_NON_PAYLOAD_BYTES + message.len;
+
+    QVarLengthArray<LinkInterface*, 8> targets;
+    QMutexLocker locker(&mutex);
+    stats.routed++;
+
+    // Learn where the sender lives
+    Route& sender = routes[routeKey(message.sysid, message.compid)];
+    sender.link = source;
+    sender.systemId = message.sysid;
+    sender.componentId = message.compid;
+    sender.received++;
+    sender.lastSeenMs = QGC::groundTimeMilliseconds();
+
+    if (targetSystem <= 0)
+    {
+        stats.broadcasts++;
+        foreach (LinkInterface* link, links)
+        {
+            if (link == source) continue;
+            targets.append(link);
+        }
+        if (targets.isEmpty())
+            return 0;
+    }
+    else if (targetSystem == ownSystemId)
+    {
+        stats.local++;
+        return 0;
+    }
+    else
+    {
+        QHash<quint16, Route>::iterator exact = routes.end();
+        if (targetComponent > 0)
+        {
+            exact = routes.find(routeKey(targetSystem, targetComponent));
+        }
+        if (exact != routes.end())
+        {
+            if (exact.value().link != source)
+            {
+                targets.append(exact.value().link);
+                exact.value().forwarded++;
+                exact.value().forwardedBytes += length;
+            }
+        }
+        else
+        {
+            // Any link the system was heard on, once per link
+            QHash<quint16, Route>::iterator i;
+            for (i = routes.begin(); i != routes.end(); ++i)
+            {
+                Route& route = i.value();
+                if (route.systemId != targetSystem || route.link == source) continue;
+                bool known = false;
+                for (int t = 0; t < targets.size(); t++)
+                {
+                    if (targets[t] == route.link) known = true;
+                }
+                if (known) continue;
+                targets.append(route.link);
+                route.forwarded++;
+                route.forwardedBytes += length;
+            }
+        }
+        if (targets.isEmpty())
+        {
+            stats.unroutable++;
+            return 0;
+        }
+        stats.unicasts++;
+    }
+
+    stats.frames += targets.size();
+    stats.bytes += (quint64)targets.size() * length;
+
+    // A slow target link must not hold up the other decoder threads or getRoutes().
+    // The targets may be removed meanwhile, each is checked again right before
+    // its frame is handed over. sendFrame() never waits, so this stays short.
+    locker.unlock();
+
+    // Serialize once, the header, sequence number and checksum stay as received
+    uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+    mavlink_msg_to_send_buffer(frame, &message);
+    for (int t = 0; t < targets.size(); t++)
+    {
+        locker.relock();
+        if (links.contains(targets[t]))
+        {
+            sendFrame(targets[t], message.msgid, (const char*)frame, length);
+        }
+        locker.unlock();
+    }
+    return targets.size();
+}
+
+void MAVLinkRouter::sendFrame(LinkInterface* link, quint8 msgid, const char* frame, int length)
+{
+    if (link->isConnected())
+    {
+        // Never wait for room, a full queue of a slow link drops forwarded frames
+        // instead of stalling the decoder thread
+        LinkTxScheduler::forLink(link)->send(msgid, frame, length, false);
+    }
+}
+
+QList<MAVLinkRouter::Route> MAVLinkRouter::getRoutes()
+{
+    QMutexLocker locker(&mutex);
+    return routes.values();
+}
+
+MAVLinkRouter::Statistics MAVLinkRouter::getStatistics()
+{
+    QMutexLocker locker(&mutex);
+    return stats;
+}
@@ -0,0 +1,127 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Learned MAVLink routing between links
+ */
+
+#ifndef MAVLINKROUTER_H
+#define MAVLINKROUTER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include "QGCMAVLink.h"
+
+class LinkInterface;
+
+/**
+ * Forwards MAVLink frames between links, replacing the broadcast of every
+ * message to every other link.
+ *
+ * The router learns on which link each system and component is heard. A
+ * message addressed to a system (target_system field) is only forwarded
+ * to the links that system was heard on, a message with a component
+ * target to the link of that component if it is known. Messages without
+ * a target or with target_system 0 are broadcasts and go to all other
+ * links. Messages to unknown systems or to the ground station itself are
+ * not forwarded.
+ *
+ * Once the targets are known, the frame is serialized once with its
+ * original header, sequence number and checksum, and the same bytes are
+ * handed to every target link. Frames that go nowhere are never serialized.
+ * Forwarding runs in the decoder threads, so all methods are thread safe.
+ * The routes are locked while the target links are chosen and the counters
+ * updated, and again per target to check it was not removed meanwhile
+ * while the frame is queued to it. Forwarded frames never wait for room in
+ * the transmit queue of a slow link, they are dropped instead.
+ */
+class MAVLinkRouter
+{
+public:
+    /** @brief Where a component was heard and what was forwarded to it */
+    struct Route {
+        Route() : link(NULL), systemId(0), componentId(0), received(0),
+            forwarded(0), forwardedBytes(0), lastSeenMs(0) {}
+        LinkInterface* link;    ///< Link the component was last heard on
+        int systemId;
+        int componentId;
+        quint64 received;       ///< Messages received from the component
+        quint64 forwarded;      ///< Frames forwarded to the component's link
+        quint64 forwardedBytes;
+        quint64 lastSeenMs;
+    };
+
+    struct Statistics {
+        Statistics() : routed(0), broadcasts(0), unicasts(0), unroutable(0), local(0), frames(0), bytes(0) {}
+        quint64 routed;         ///< Messages passed to forward()
+        quint64 broadcasts;     ///< Messages without a target system
+        quint64 unicasts;       ///< Messages forwarded to the links of their target
+        quint64 unroutable;     ///< Messages to systems not heard on any other link
+        quint64 local;          ///< Messages to this ground station, not forwarded
+        quint64 frames;         ///< Frames written, one per target link
+        quint64 bytes;          ///< Bytes written
+    };
+
+    MAVLinkRouter();
+    virtual ~MAVLinkRouter();
+
+    /** @brief Add a link messages can be forwarded to */
+    void addLink(LinkInterface* link);
+    /** @brief Remove a link and the routes learned on it */
+    void removeLink(LinkInterface* link);
+    /** @brief Forget all learned routes */
+    void clearRoutes();
+
+    /**
+     * @brief Learn the source of a message and forward it
+     * @param source Link the message was received on, never forwarded to
+     * @param ownSystemId System id of this ground station
+     * @return Number of links the frame was forwarded to
+     */
+    int forward(LinkInterface* source, const mavlink_message_t& message, int ownSystemId);
+
+    /** @brief Read the target_system and target_component fields, -1 if the message has none */
+    void getTarget(const mavlink_message_t& message, int& systemId, int& componentId) const;
+
+    QList<Route> getRoutes();
+    Statistics getStatistics();
+
+protected:
+    /** @brief Queue one serialized frame to a link without waiting, called with the routes locked */
+    virtual void sendFrame(LinkInterface* link, quint8 msgid, const char* frame, int length);
+
+    /** @brief Key of a component in the route table */
+    static quint16 routeKey(int systemId, int componentId) { return (systemId << 8) | componentId; }
+
+    QMutex mutex;
+    QList<LinkInterface*> links;
+    QHash<quint16, Route> routes;
+    Statistics stats;
+    /** @brief Payload offset of target_system / target_component per message id, -1 if absent */
+    int targetSystemOffset[256];
+    int targetComponentOffset[256];
+};
+
+#endif // MAVLINKROUTER_H
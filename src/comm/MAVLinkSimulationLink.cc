@@ -111,6 +111,8 @@ MAVLinkSimulationLink::MAVLinkSimulationLink(QString readFile, QString writeFile
 
 MAVLinkSimulationLink::~MAVLinkSimulationLink()
 {
+    // The transmit scheduler and the decoder thread stop using the link
+    announceDestruction();
     //TODO Check destructor
     //    fileStream->flush();
     //    outStream->flush();
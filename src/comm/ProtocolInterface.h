@@ -53,6 +53,23 @@ public:
     //virtual ~ProtocolInterface() {};
     virtual QString getName() = 0;
 
+    /**
+     * @brief Start receiving the bytes of a link
+     *
+     * By default the bytes are queued into the thread of the protocol.
+     */
+    virtual void addLink(LinkInterface* link)
+    {
+        connect(link, SIGNAL(bytesReceived(LinkInterface*, QByteArray)),
+                this, SLOT(receiveBytes(LinkInterface*, QByteArray)), Qt::QueuedConnection);
+    }
+    /** @brief Stop receiving the bytes of a link */
+    virtual void removeLink(LinkInterface* link)
+    {
+        disconnect(link, SIGNAL(bytesReceived(LinkInterface*, QByteArray)),
+                   this, SLOT(receiveBytes(LinkInterface*, QByteArray)));
+    }
+
 public slots:
     virtual void receiveBytes(LinkInterface *link, QByteArray b) = 0;
 
@@ -40,9 +40,10 @@ This file is part of the QGROUNDCONTROL project
 #include <QMutexLocker>
 #include <iostream>
 #include <QHostInfo>
+#include <qmath.h>
 
 QGCFlightGearLink::QGCFlightGearLink(UASInterface* mav, QString startupArguments, QString remoteHost, QHostAddress host, quint16 port) :
-    socket(NULL),
+    bridge(NULL),
     process(NULL),
     terraSync(NULL),
     flightGearVersion(0),
@@ -59,7 +60,7 @@ QGCFlightGearLink::QGCFlightGearLink(UASInterface* mav, QString startupArguments
 
 QGCFlightGearLink::~QGCFlightGearLink()
 {   //do not disconnect unless it is connected.
-    //disconnectSimulation will delete the memory that was allocated for proces, terraSync and socket
+    //disconnectSimulation will delete the memory that was allocated for proces, terraSync and bridge
     if(connectState){
        disconnectSimulation();
     }
@@ -205,90 +206,116 @@ void QGCFlightGearLink::writeBytes(const char* data, qint64 size)
     QLOG_DEBUG() << bytes;
     QLOG_DEBUG() << "ASCII:" << ascii;
 #endif
-    if (connectState && socket) socket->writeDatagram(data, size, currentHost, currentPort);
+    if (connectState && bridge) bridge->writeDatagram(data, size, currentHost, currentPort);
 }
 
-/**
- * @brief Read a number of bytes from the interface.
- *
- * @param data Pointer to the data byte array to write the bytes to
- * @param maxLength The maximum number of bytes to write
- **/
-void QGCFlightGearLink::readBytes()
+bool QGCFlightGearLink::parseDatagram(const char* data, qint64 length, QGCHilState& state)
 {
-    const qint64 maxLength = 65536;
-    char data[maxLength];
-    QHostAddress sender;
-    quint16 senderPort;
-
-    unsigned int s = socket->pendingDatagramSize();
-    if (s > maxLength) std::cerr << __FILE__ << __LINE__ << " UDP datagram overflow, allowed to read less bytes than datagram size" << std::endl;
-    socket->readDatagram(data, maxLength, &sender, &senderPort);
-
-    QByteArray b(data, s);
+    if (!parseGenericLine(data, length, state))
+    {
+        QLOG_DEBUG() << "FG LINK: DATAGRAM OF" << length << "BYTES IS NOT A PROTOCOL LINE";
+        return false;
+    }
+    return true;
+}
 
-    // Print string
-    QString state(b);
-    QLOG_TRACE() << "FG LINK GOT:" << state;
+namespace
+{
+/**
+ * Locale independent replacement for strtod(), the generic protocol
+ * always uses '.' as decimal point.
+ */
+bool parseNumber(const char*& p, const char* end, double& value)
+{
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
 
-    QStringList values = state.split("\t");
+    const char* digits = p;
+    double result = 0.0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        result = result * 10.0 + (*p - '0');
+        p++;
+    }
+    if (p < end && *p == '.')
+    {
+        p++;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            result += (*p - '0') * scale;
+            scale *= 0.1;
+            p++;
+        }
+    }
+    if (p == digits) return false;
 
-    // Check length
-    if (values.size() != 17)
+    if (p < end && (*p == 'e' || *p == 'E'))
     {
-        QLOG_DEBUG() << "RETURN LENGTH MISMATCHING EXPECTED" << 17 << "BUT GOT" << values.size();
-        QLOG_DEBUG() << state;
-        return;
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negativeExponent = (*p == '-');
+            p++;
+        }
+        int exponent = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+        {
+            exponent = exponent * 10 + (*p - '0');
+            p++;
+        }
+        result *= pow(10.0, negativeExponent ? -exponent : exponent);
     }
 
-    // Parse string
-    float roll, pitch, yaw, rollspeed, pitchspeed, yawspeed;
-    double lat, lon, alt;
-    double vx, vy, vz, xacc, yacc, zacc;
-
-    lat = values.at(1).toDouble();
-    lon = values.at(2).toDouble();
-    alt = values.at(3).toDouble();
-    roll = values.at(4).toDouble();
-    pitch = values.at(5).toDouble();
-    yaw = values.at(6).toDouble();
-    rollspeed = values.at(7).toDouble();
-    pitchspeed = values.at(8).toDouble();
-    yawspeed = values.at(9).toDouble();
-
-    xacc = values.at(10).toDouble();
-    yacc = values.at(11).toDouble();
-    zacc = values.at(12).toDouble();
-
-    vx = values.at(13).toDouble();
-    vy = values.at(14).toDouble();
-    vz = values.at(15).toDouble();
-
-    // Send updated state
-    emit hilStateChanged(QGC::groundTimeUsecs(), roll, pitch, yaw, rollspeed,
-                         pitchspeed, yawspeed, lat, lon, alt,
-                         vx, vy, vz, xacc, yacc, zacc);
-
-    //    // Echo data for debugging purposes
-    //    std::cerr << __FILE__ << __LINE__ << "Received datagram:" << std::endl;
-    //    int i;
-    //    for (i=0; i<s; i++)
-    //    {
-    //        unsigned int v=data[i];
-    //        fprintf(stderr,"%02x ", v);
-    //    }
-    //    std::cerr << std::endl;
+    value = negative ? -result : result;
+    return true;
+}
 }
 
-
-/**
- * @brief Get the number of bytes to read.
- *
- * @return The number of bytes to read
- **/
-qint64 QGCFlightGearLink::bytesAvailable()
+bool QGCFlightGearLink::parseGenericLine(const char* data, qint64 length, QGCHilState& state)
 {
-    return socket->pendingDatagramSize();
+    const int fieldCount = 17;
+    double values[fieldCount];
+    const char* p = data;
+    const char* end = data + length;
+
+    for (int i = 0; i < fieldCount; ++i)
+    {
+        if (!parseNumber(p, end, values[i])) return false;
+        // Fields are separated by tabs, the line ends with a newline
+        if (i < fieldCount - 1)
+        {
+            if (p >= end || *p != '\t') return false;
+            p++;
+        }
+    }
+    while (p < end && (*p == '\n' || *p == '\r')) p++;
+    if (p != end) return false;
+
+    // values[0] is the simulation time, values[16] the airspeed
+    state.lat = values[1];
+    state.lon = values[2];
+    state.alt = values[3];
+    state.roll = values[4];
+    state.pitch = values[5];
+    state.yaw = values[6];
+    state.rollspeed = values[7];
+    state.pitchspeed = values[8];
+    state.yawspeed = values[9];
+    state.xacc = values[10];
+    state.yacc = values[11];
+    state.zacc = values[12];
+    state.vx = values[13];
+    state.vy = values[14];
+    state.vz = values[15];
+    state.fields_updated = 0;
+    state.gps = false;
+    return true;
 }
 
 /**
@@ -301,7 +328,6 @@ bool QGCFlightGearLink::disconnectSimulation()
     disconnect(process, SIGNAL(error(QProcess::ProcessError)),
                this, SLOT(processError(QProcess::ProcessError)));
     disconnect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
-    disconnect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
 
     if (process)
     {
@@ -315,11 +341,11 @@ bool QGCFlightGearLink::disconnectSimulation()
         delete terraSync;
         terraSync = NULL;
     }
-    if (socket)
+    if (bridge)
     {
-        socket->close();
-        delete socket;
-        socket = NULL;
+        bridge->close();
+        delete bridge;
+        bridge = NULL;
     }
 
     connectState = false;
@@ -339,19 +365,22 @@ bool QGCFlightGearLink::connectSimulation()
     QLOG_DEBUG() << "STARTING FLIGHTGEAR LINK";
 
     if (!mav) return false;
-    socket = new QUdpSocket(this);
-    connectState = socket->bind(host, port);
-
-    QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(readBytes()));
+    UAS* uas = dynamic_cast<UAS*>(mav);
+    // Simulator packets are parsed and HIL messages sent from the bridge thread
+    bridge = new QGCHilBridge(this, uas);
+    connectState = bridge->open(host, port);
+    if (!connectState)
+    {
+        delete bridge;
+        bridge = NULL;
+        return false;
+    }
 
     process = new QProcess(this);
     terraSync = new QProcess(this);
 
     connect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
-    connect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
 
-
-    UAS* uas = dynamic_cast<UAS*>(mav);
     if (uas)
     {
         uas->startHil();
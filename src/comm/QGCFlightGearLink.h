@@ -42,6 +42,7 @@ This file is part of the QGROUNDCONTROL project
 #include <configuration.h>
 #include "UASInterface.h"
 #include "QGCHilLink.h"
+#include "QGCHilBridge.h"
 
 class QGCFlightGearLink : public QGCHilLink
 {
@@ -53,7 +54,6 @@ public:
     ~QGCFlightGearLink();
 
     bool isConnected();
-    qint64 bytesAvailable();
     int getPort() const {
         return port;
     }
@@ -83,6 +83,16 @@ public:
         return _sensorHilEnabled;
     }
 
+    bool parseDatagram(const char* data, qint64 length, QGCHilState& state);
+
+    /**
+     * @brief Parse one line of the qgroundcontrol generic protocol
+     *
+     * The line holds 17 tab separated numbers, see
+     * files/flightgear/Protocol/qgroundcontrol-*.xml
+     */
+    static bool parseGenericLine(const char* data, qint64 length, QGCHilState& state);
+
     void run();
 
 public slots:
@@ -114,7 +124,6 @@ public slots:
             emit sensorHilChanged(enable);
     }
 
-    void readBytes();
     /**
      * @brief Write a number of bytes to the interface.
      *
@@ -136,7 +145,7 @@ protected:
     quint16 currentPort;
     quint16 port;
     int id;
-    QUdpSocket* socket;
+    QGCHilBridge* bridge;
     bool connectState;
 
     quint64 bitsSentTotal;
@@ -0,0 +1,533 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Fixed rate bridge between a simulator socket and the MAV
+ */
+
+#include "QsLog.h"
+#include "QGCHilBridge.h"
+#include "LinkInterface.h"
+#include "LinkTxScheduler.h"
+#include "UAS.h"
+#include "QGC.h"
+
+#include <QUdpSocket>
+#include <QSettings>
+#include <QMutexLocker>
+#include <qmath.h>
+
+// Simulator frames kept for interpolation
+#define HIL_FRAME_HISTORY 16
+// GPS fixes are sent at 10 Hz, like a real receiver
+#define HIL_GPS_INTERVAL_US 100000
+#define HIL_MODE_REQUEST_INTERVAL_US 1000000
+#define HIL_STATISTICS_INTERVAL_US 1000000
+// Below this the scheduler stops blocking on the socket and polls
+#define HIL_SPIN_THRESHOLD_US 1500
+
+namespace
+{
+const quint64 bucketLimits[QGCHilBridge::Histogram::BUCKETS - 1] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000
+};
+
+float interpolateAngle(float a, float b, float fraction)
+{
+    float delta = b - a;
+    while (delta > M_PI) delta -= 2.0f * M_PI;
+    while (delta < -M_PI) delta += 2.0f * M_PI;
+    return QGC::limitAngleToPMPIf(a + delta * fraction);
+}
+}
+
+void QGCHilBridge::Histogram::add(quint64 us)
+{
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && us >= bucketLimits[bucket]) bucket++;
+    buckets[bucket]++;
+    count++;
+    sumUs += us;
+    maxUs = qMax(maxUs, us);
+}
+
+quint64 QGCHilBridge::Histogram::bucketLimit(int bucket)
+{
+    if (bucket < 0 || bucket >= BUCKETS - 1) return 0;
+    return bucketLimits[bucket];
+}
+
+QGCHilBridge::QGCHilBridge(QGCHilLink* simulation, UAS* uas, QObject* parent) :
+    QThread(parent),
+    simulation(simulation),
+    uas(uas),
+    systemId(0),
+    componentId(0),
+    port(0),
+    socket(NULL),
+    stopRequested(false),
+    bound(false),
+    wallOffsetUs(0),
+    rate(DEFAULT_RATE),
+    hilModeEnabled(0),
+    frames(HIL_FRAME_HISTORY),
+    newestFrame(0),
+    frameCount(0),
+    receiveBuffer(65536, 0),
+    tickDeferred(false),
+    lastGpsUs(0),
+    lastModeRequestUs(0),
+    lastStatisticsUs(0)
+{
+    clock.start();
+    QSettings settings;
+    rate = qBound((int)MIN_RATE, settings.value("HIL_BRIDGE_RATE", (int)DEFAULT_RATE).toInt(), (int)MAX_RATE);
+}
+
+QGCHilBridge::~QGCHilBridge()
+{
+    close();
+}
+
+bool QGCHilBridge::open(const QHostAddress& host, quint16 port)
+{
+    if (isRunning()) return bound;
+
+    this->host = host;
+    this->port = port;
+
+    if (uas)
+    {
+        QMutexLocker locker(&linksMutex);
+        links = *uas->getLinks();
+        foreach (LinkInterface* link, links)
+        {
+            // Direct, the bridge thread may be sending to the link right now
+            connect(link, SIGNAL(aboutToBeDestroyed(LinkInterface*)), this, SLOT(linkDestroyed(LinkInterface*)), Qt::DirectConnection);
+        }
+        systemId = uas->getProtocol()->getSystemId();
+        componentId = uas->getProtocol()->getComponentId();
+        connect(this, SIGNAL(hilModeRequired()), uas, SLOT(requestHilMode()), Qt::QueuedConnection);
+        // The mode changes with the heartbeats handled in the GUI thread
+        connect(uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateHilMode()));
+        updateHilMode();
+    }
+
+    {
+        QMutexLocker locker(&statsMutex);
+        stats = Statistics();
+    }
+    frameCount = 0;
+    lastGpsUs = 0;
+    lastModeRequestUs = 0;
+    lastStatisticsUs = getTimeUs();
+    stopRequested = false;
+    bound = false;
+
+    start(TimeCriticalPriority);
+    // The socket is created and bound in the bridge thread
+    started.acquire();
+    if (!bound)
+    {
+        wait();
+        QLOG_ERROR() << "HIL bridge: could not bind" << host.toString() << port;
+    }
+    return bound;
+}
+
+void QGCHilBridge::close()
+{
+    stopRequested = true;
+    wait();
+    if (uas)
+    {
+        disconnect(this, SIGNAL(hilModeRequired()), uas, SLOT(requestHilMode()));
+        disconnect(uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateHilMode()));
+    }
+    QMutexLocker locker(&linksMutex);
+    links.clear();
+}
+
+void QGCHilBridge::setRate(int hz)
+{
+    rate = qBound((int)MIN_RATE, hz, (int)MAX_RATE);
+    QSettings settings;
+    settings.setValue("HIL_BRIDGE_RATE", (int)rate);
+}
+
+void QGCHilBridge::writeDatagram(const char* data, qint64 size, const QHostAddress& host, quint16 port)
+{
+    Datagram datagram;
+    datagram.data = QByteArray(data, size);
+    datagram.host = host;
+    datagram.port = port;
+    QMutexLocker locker(&outgoingMutex);
+    outgoing.append(datagram);
+}
+
+void QGCHilBridge::linkDestroyed(LinkInterface* link)
+{
+    QMutexLocker locker(&linksMutex);
+    links.removeAll(link);
+}
+
+void QGCHilBridge::updateHilMode()
+{
+    if (uas) hilModeEnabled.fetchAndStoreOrdered(uas->isHilModeEnabled() ? 1 : 0);
+}
+
+void QGCHilBridge::run()
+{
+    socket = new QUdpSocket();
+    bound = socket->bind(host, port);
+    started.release();
+    if (!bound)
+    {
+        delete socket;
+        socket = NULL;
+        return;
+    }
+
+    wallOffsetUs = (qint64)QGC::groundTimeUsecs() - (qint64)getTimeUs();
+
+    quint64 deadline = getTimeUs() + 1000000 / rate;
+    while (!stopRequested)
+    {
+        waitUntil(deadline);
+        if (stopRequested) break;
+        tick(deadline);
+
+        // Absolute deadlines, so the rate does not drift with the tick duration
+        quint64 period = 1000000 / rate;
+        deadline += period;
+        quint64 now = getTimeUs();
+        if (now > deadline)
+        {
+            // More than one period late, start a new schedule instead of bursting
+            QMutexLocker locker(&statsMutex);
+            stats.overruns++;
+            deadline = now + period;
+        }
+    }
+
+    flush();
+    socket->close();
+    delete socket;
+    socket = NULL;
+}
+
+void QGCHilBridge::waitUntil(quint64 timeUs)
+{
+    forever
+    {
+        flush();
+        quint64 now = getTimeUs();
+        if (now >= timeUs || stopRequested) return;
+        quint64 remaining = timeUs - now;
+        if (remaining > HIL_SPIN_THRESHOLD_US)
+        {
+            // Socket waits have millisecond resolution, leave the rest to the loop below
+            socket->waitForReadyRead((int)((remaining - HIL_SPIN_THRESHOLD_US) / 1000) + 1);
+            receive();
+        }
+        else if (socket->hasPendingDatagrams())
+        {
+            receive();
+        }
+        else
+        {
+            usleep(qMin(remaining, (quint64)100));
+        }
+    }
+}
+
+void QGCHilBridge::receive()
+{
+    while (socket->hasPendingDatagrams())
+    {
+        qint64 size = socket->readDatagram(receiveBuffer.data(), receiveBuffer.size());
+        quint64 arrival = getTimeUs();
+        if (size <= 0) break;
+
+        QGCHilState state;
+        if (!parse(receiveBuffer.constData(), size, state))
+        {
+            QMutexLocker locker(&statsMutex);
+            stats.rejected++;
+            continue;
+        }
+        state.timeUs = arrival;
+
+        QMutexLocker locker(&statsMutex);
+        if (frameCount > 0)
+        {
+            quint64 interval = arrival - frames[newestFrame].timeUs;
+            stats.frameIntervalUs = stats.frameIntervalUs ? (stats.frameIntervalUs * 7 + interval) / 8 : interval;
+        }
+        newestFrame = (newestFrame + 1) % frames.size();
+        frames[newestFrame] = state;
+        frameCount = qMin(frameCount + 1, frames.size());
+        stats.frames++;
+    }
+}
+
+void QGCHilBridge::flush()
+{
+    QList<Datagram> pending;
+    {
+        QMutexLocker locker(&outgoingMutex);
+        if (outgoing.isEmpty()) return;
+        pending.swap(outgoing);
+    }
+    foreach (const Datagram& datagram, pending)
+    {
+        socket->writeDatagram(datagram.data, datagram.host, datagram.port);
+    }
+}
+
+bool QGCHilBridge::parse(const char* data, qint64 length, QGCHilState& state)
+{
+    if (!simulation) return false;
+    return simulation->parseDatagram(data, length, state);
+}
+
+QGCHilState QGCHilBridge::interpolate(const QGCHilState& a, const QGCHilState& b, quint64 timeUs)
+{
+    if (b.timeUs <= a.timeUs || timeUs >= b.timeUs) return b;
+    if (timeUs <= a.timeUs) return a;
+
+    float f = (float)(timeUs - a.timeUs) / (float)(b.timeUs - a.timeUs);
+    double fd = (double)(timeUs - a.timeUs) / (double)(b.timeUs - a.timeUs);
+
+    // Flags and sensor availability come from the newer frame
+    QGCHilState state = b;
+    state.timeUs = timeUs;
+    state.roll = interpolateAngle(a.roll, b.roll, f);
+    state.pitch = interpolateAngle(a.pitch, b.pitch, f);
+    state.yaw = interpolateAngle(a.yaw, b.yaw, f);
+    state.rollspeed = a.rollspeed + (b.rollspeed - a.rollspeed) * f;
+    state.pitchspeed = a.pitchspeed + (b.pitchspeed - a.pitchspeed) * f;
+    state.yawspeed = a.yawspeed + (b.yawspeed - a.yawspeed) * f;
+    state.lat = a.lat + (b.lat - a.lat) * fd;
+    state.lon = a.lon + (b.lon - a.lon) * fd;
+    state.alt = a.alt + (b.alt - a.alt) * fd;
+    state.vx = a.vx + (b.vx - a.vx) * f;
+    state.vy = a.vy + (b.vy - a.vy) * f;
+    state.vz = a.vz + (b.vz - a.vz) * f;
+    state.xacc = a.xacc + (b.xacc - a.xacc) * f;
+    state.yacc = a.yacc + (b.yacc - a.yacc) * f;
+    state.zacc = a.zacc + (b.zacc - a.zacc) * f;
+    state.xmag = a.xmag + (b.xmag - a.xmag) * f;
+    state.ymag = a.ymag + (b.ymag - a.ymag) * f;
+    state.zmag = a.zmag + (b.zmag - a.zmag) * f;
+    state.abs_pressure = a.abs_pressure + (b.abs_pressure - a.abs_pressure) * f;
+    state.diff_pressure = a.diff_pressure + (b.diff_pressure - a.diff_pressure) * f;
+    state.pressure_alt = a.pressure_alt + (b.pressure_alt - a.pressure_alt) * f;
+    state.temperature = a.temperature + (b.temperature - a.temperature) * f;
+    return state;
+}
+
+bool QGCHilBridge::sample(quint64 timeUs, QGCHilState& state, quint64& newestUs)
+{
+    if (frameCount == 0) return false;
+
+    const QGCHilState* newer = &frames.at(newestFrame);
+    newestUs = newer->timeUs;
+    if (timeUs >= newer->timeUs)
+    {
+        state = *newer;
+        return true;
+    }
+
+    for (int i = 1; i < frameCount; ++i)
+    {
+        const QGCHilState* older = &frames.at((newestFrame - i + frames.size()) % frames.size());
+        if (older->timeUs <= timeUs)
+        {
+            state = interpolate(*older, *newer, timeUs);
+            return true;
+        }
+        newer = older;
+    }
+
+    // Older than the history, use the oldest frame
+    state = *newer;
+    return true;
+}
+
+void QGCHilBridge::tick(quint64 deadlineUs)
+{
+    quint64 now = getTimeUs();
+    quint64 delay;
+    {
+        QMutexLocker locker(&statsMutex);
+        delay = stats.frameIntervalUs;
+    }
+
+    // Sample one simulator frame in the past, so there is a frame on both sides
+    quint64 sampleUs = (now > delay) ? now - delay : 0;
+    QGCHilState state;
+    quint64 newestUs = 0;
+    bool valid = sample(sampleUs, state, newestUs);
+    tickDeferred = false;
+    if (valid)
+    {
+        publish(state, (quint64)((qint64)now + wallOffsetUs));
+    }
+    // The messages went out while publishing, unless the scheduler queued them
+    quint64 writtenUs = getTimeUs();
+
+    QMutexLocker locker(&statsMutex);
+    stats.ticks++;
+    if (tickDeferred)
+    {
+        stats.deferred++;
+    }
+    else
+    {
+        stats.jitter.add(writtenUs - deadlineUs);
+    }
+    if (valid)
+    {
+        stats.latency.add(now - newestUs);
+        if (sampleUs > newestUs) stats.held++;
+    }
+
+    if (now - lastStatisticsUs >= HIL_STATISTICS_INTERVAL_US)
+    {
+        lastStatisticsUs = now;
+        locker.unlock();
+        QString text = getStatisticsText();
+        QLOG_TRACE() << text;
+        emit statisticsChanged(text);
+    }
+}
+
+void QGCHilBridge::publish(const QGCHilState& state, quint64 timeUs)
+{
+    if (!uas) return;
+
+    if (hilModeEnabled.fetchAndAddOrdered(0) == 0)
+    {
+        if (timeUs - lastModeRequestUs >= HIL_MODE_REQUEST_INTERVAL_US)
+        {
+            lastModeRequestUs = timeUs;
+            emit hilModeRequired();
+        }
+        return;
+    }
+
+    mavlink_message_t msg;
+    if (state.fields_updated)
+    {
+        mavlink_msg_highres_imu_pack(systemId, componentId, &msg, timeUs,
+                                     state.xacc, state.yacc, state.zacc,
+                                     state.rollspeed, state.pitchspeed, state.yawspeed,
+                                     state.xmag, state.ymag, state.zmag,
+                                     state.abs_pressure, state.diff_pressure, state.pressure_alt, state.temperature,
+                                     state.fields_updated);
+    }
+    else
+    {
+        mavlink_msg_hil_state_pack(systemId, componentId, &msg, timeUs,
+                                   state.roll, state.pitch, state.yaw,
+                                   state.rollspeed, state.pitchspeed, state.yawspeed,
+                                   state.lat*1e7, state.lon*1e7, state.alt*1000,
+                                   state.vx*100, state.vy*100, state.vz*100,
+                                   state.xacc*1000/9.81, state.yacc*1000/9.81, state.zacc*1000/9.81);
+    }
+    sendMessage(msg);
+
+    if (state.gps && timeUs - lastGpsUs >= HIL_GPS_INTERVAL_US)
+    {
+        lastGpsUs = timeUs;
+        float vel = sqrt(state.vx*state.vx + state.vy*state.vy + state.vz*state.vz);
+        // Course over ground in degrees, 0..360
+        float course = atan2(state.vy, state.vx);
+        if (course < 0) course += 2.0f * M_PI;
+        course = (course / M_PI) * 180.0f;
+        mavlink_msg_gps_raw_int_pack(systemId, componentId, &msg, timeUs, 3,
+                                     state.lat*1e7, state.lon*1e7, state.alt*1e3,
+                                     0.3f*1e2, 0.6f*1e2, vel*1e2, course*1e2, 8);
+        sendMessage(msg);
+    }
+}
+
+void QGCHilBridge::sendMessage(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &message);
+
+    // Held while sending, a link being deleted waits for the send. The send
+    // never waits for the GUI thread, so the GUI thread can take the lock too.
+    QMutexLocker locker(&linksMutex);
+    foreach (LinkInterface* link, links)
+    {
+        if (link->isConnected())
+        {
+            // Serial and UDP links are written from this thread when their
+            // budget allows. Otherwise the frame is queued and replaces an
+            // older one of the same message, or is dropped if the queue is full.
+            if (LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, len, false) != LinkTxScheduler::SEND_WRITTEN)
+            {
+                tickDeferred = true;
+            }
+        }
+    }
+}
+
+QGCHilBridge::Statistics QGCHilBridge::getStatistics()
+{
+    QMutexLocker locker(&statsMutex);
+    return stats;
+}
+
+QString QGCHilBridge::getStatisticsText()
+{
+    Statistics s = getStatistics();
+    QString text = QString("HIL %1 Hz: %2 ticks, %3 overruns, %4 deferred, %5 frames (%6 ms), %7 rejected, %8 held;")
+            .arg(rate).arg(s.ticks).arg(s.overruns).arg(s.deferred).arg(s.frames)
+            .arg(s.frameIntervalUs / 1000.0, 0, 'f', 1).arg(s.rejected).arg(s.held);
+
+    const Histogram* histograms[2] = { &s.jitter, &s.latency };
+    const char* names[2] = { "jitter", "latency" };
+    for (int h = 0; h < 2; ++h)
+    {
+        const Histogram& histogram = *histograms[h];
+        text += QString(" %1 mean %2 max %3 us [").arg(names[h])
+                .arg(histogram.meanUs(), 0, 'f', 0).arg(histogram.maxUs);
+        for (int i = 0; i < Histogram::BUCKETS; ++i)
+        {
+            if (i < Histogram::BUCKETS - 1)
+            {
+                text += QString("<%1:%2 ").arg(Histogram::bucketLimit(i)).arg(histogram.buckets[i]);
+            }
+            else
+            {
+                text += QString(">=%1:%2]").arg(Histogram::bucketLimit(i - 1)).arg(histogram.buckets[i]);
+            }
+        }
+        text += ";";
+    }
+    return text;
+}
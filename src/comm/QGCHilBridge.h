@@ -0,0 +1,198 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Fixed rate bridge between a simulator socket and the MAV
+ */
+
+#ifndef QGCHILBRIDGE_H
+#define QGCHILBRIDGE_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSemaphore>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include "QGCHilLink.h"
+#include "QGCMAVLink.h"
+
+class QUdpSocket;
+class UAS;
+class LinkInterface;
+
+/**
+ * Receives the simulator datagrams and sends the HIL messages to the MAV
+ * from its own thread, so neither side depends on the load of the GUI.
+ *
+ * Every datagram is stamped on arrival and handed to the parser of the
+ * simulation link. A fixed rate scheduler (50 to 400 Hz) then samples the
+ * simulator state one simulator frame in the past, interpolated between
+ * the two frames around that time, and sends it. The HIL messages are
+ * written to serial and UDP links from the bridge thread itself. How late
+ * after its deadline every tick was written (jitter) and the age of the
+ * newest simulator frame used (latency) are collected in histograms. Ticks
+ * the transmit scheduler had to queue, because the link was busy or is not
+ * thread safe, are counted as deferred; their delay shows up in the HIL
+ * class of the scheduler.
+ */
+class QGCHilBridge : public QThread
+{
+    Q_OBJECT
+public:
+    enum {
+        MIN_RATE = 50,
+        MAX_RATE = 400,
+        DEFAULT_RATE = 100
+    };
+
+    /** @brief Log scaled histogram of durations in microseconds */
+    struct Histogram {
+        enum { BUCKETS = 10 };
+        Histogram() : count(0), sumUs(0), maxUs(0) { for (int i = 0; i < BUCKETS; ++i) buckets[i] = 0; }
+        void add(quint64 us);
+        /** @brief Upper limit of a bucket in microseconds, the last one is open */
+        static quint64 bucketLimit(int bucket);
+        double meanUs() const { return count ? (double)sumUs / count : 0.0; }
+        quint64 buckets[BUCKETS];
+        quint64 count;
+        quint64 sumUs;
+        quint64 maxUs;
+    };
+
+    struct Statistics {
+        Statistics() : ticks(0), overruns(0), deferred(0), frames(0), rejected(0), held(0), frameIntervalUs(0) {}
+        quint64 ticks;          ///< Scheduler ticks, one HIL message set each
+        quint64 overruns;       ///< Ticks more than one period late, schedule was re-phased
+        quint64 deferred;       ///< Ticks with messages queued instead of written, not in the jitter
+        quint64 frames;         ///< Simulator frames parsed
+        quint64 rejected;       ///< Datagrams the parser did not accept
+        quint64 held;           ///< Ticks past the newest frame, state was held
+        quint64 frameIntervalUs;///< Smoothed interval between simulator frames
+        Histogram jitter;       ///< Time from the deadline until the messages of the tick were written
+        Histogram latency;
+    };
+
+    QGCHilBridge(QGCHilLink* simulation, UAS* uas, QObject* parent = 0);
+    ~QGCHilBridge();
+
+    /**
+     * @brief Bind the simulator socket and start the bridge thread
+     * @return false if the socket could not be bound
+     */
+    bool open(const QHostAddress& host, quint16 port);
+    /** @brief Stop the bridge thread and close the socket */
+    void close();
+
+    /** @brief Set the rate HIL messages are sent at, clamped to 50..400 Hz and stored */
+    void setRate(int hz);
+    int getRate() const { return rate; }
+
+    /** @brief Queue a datagram to the simulator, sent from the bridge thread */
+    void writeDatagram(const char* data, qint64 size, const QHostAddress& host, quint16 port);
+
+    Statistics getStatistics();
+    QString getStatisticsText();
+
+    /** @brief Time of the bridge clock in microseconds */
+    quint64 getTimeUs() const { return clock.nsecsElapsed() / 1000; }
+
+    /** @brief Linear interpolation of two frames at timeUs, angles take the short way */
+    static QGCHilState interpolate(const QGCHilState& a, const QGCHilState& b, quint64 timeUs);
+
+signals:
+    /** @brief Summary of the statistics, once per second while running */
+    void statisticsChanged(const QString& text);
+    /** @brief The MAV is not in HIL mode yet, at most once per second */
+    void hilModeRequired();
+
+protected slots:
+    /** @brief Stop sending to a link that is being deleted, returns once no frame is being sent to it */
+    void linkDestroyed(LinkInterface* link);
+    /** @brief Copy the HIL flag of the MAV for the bridge thread, called in the GUI thread */
+    void updateHilMode();
+
+protected:
+    void run();
+    /** @brief Parse one datagram, by default with the parser of the simulation link */
+    virtual bool parse(const char* data, qint64 length, QGCHilState& state);
+    /** @brief Send one tick worth of HIL messages, called from the bridge thread */
+    virtual void publish(const QGCHilState& state, quint64 timeUs);
+
+    /** @brief Read and parse all pending datagrams */
+    void receive();
+    /** @brief Send the datagrams queued by writeDatagram() */
+    void flush();
+    /** @brief State at a bridge clock time, false if no frame was received yet */
+    bool sample(quint64 timeUs, QGCHilState& state, quint64& newestUs);
+    /** @brief Wait until timeUs while receiving datagrams */
+    void waitUntil(quint64 timeUs);
+    /** @brief Sample and publish the state for the tick due at deadlineUs */
+    void tick(quint64 deadlineUs);
+    /** @brief Send a message on all links of the MAV, marks the tick deferred unless it was written on all of them */
+    void sendMessage(const mavlink_message_t& message);
+
+    struct Datagram {
+        QByteArray data;
+        QHostAddress host;
+        quint16 port;
+    };
+
+    QGCHilLink* simulation;
+    UAS* uas;
+    QList<LinkInterface*> links;    ///< Links of the MAV when the bridge was opened
+    QMutex linksMutex;              ///< Held while sending, so a link is not torn down under a send
+    int systemId;
+    int componentId;
+    QHostAddress host;
+    quint16 port;
+    QUdpSocket* socket;             ///< Lives in the bridge thread
+    volatile bool stopRequested;
+    bool bound;
+    QSemaphore started;
+    QElapsedTimer clock;
+    qint64 wallOffsetUs;            ///< Unix time minus bridge clock
+    volatile int rate;
+    QAtomicInt hilModeEnabled;      ///< Copy of UAS::isHilModeEnabled(), read by the bridge thread
+
+    QVector<QGCHilState> frames;    ///< Ring of the latest simulator frames
+    int newestFrame;
+    int frameCount;
+    QByteArray receiveBuffer;
+
+    QList<Datagram> outgoing;
+    QMutex outgoingMutex;
+
+    Statistics stats;
+    QMutex statsMutex;
+
+    bool tickDeferred;              ///< A message of the current tick was queued by the transmit scheduler
+    quint64 lastGpsUs;
+    quint64 lastModeRequestUs;
+    quint64 lastStatisticsUs;
+};
+
+#endif // QGCHILBRIDGE_H
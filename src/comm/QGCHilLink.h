@@ -5,13 +5,33 @@
 #include <QProcess>
 #include "inttypes.h"
 
+/**
+ * @brief One simulator frame, in the units of the HIL_STATE / HIGHRES_IMU messages
+ */
+struct QGCHilState
+{
+    QGCHilState() : timeUs(0), roll(0), pitch(0), yaw(0), rollspeed(0), pitchspeed(0), yawspeed(0),
+        lat(0), lon(0), alt(0), vx(0), vy(0), vz(0), xacc(0), yacc(0), zacc(0),
+        xmag(0), ymag(0), zmag(0), abs_pressure(0), diff_pressure(0), pressure_alt(0), temperature(0),
+        fields_updated(0), gps(false) {}
+    quint64 timeUs;             ///< Bridge clock time the frame arrived, set by the bridge
+    float roll, pitch, yaw;     ///< rad
+    float rollspeed, pitchspeed, yawspeed; ///< rad/s
+    double lat, lon, alt;       ///< deg, deg, m
+    float vx, vy, vz;           ///< m/s, NED
+    float xacc, yacc, zacc;     ///< m/s^2, body frame
+    float xmag, ymag, zmag;     ///< Gauss
+    float abs_pressure, diff_pressure, pressure_alt, temperature;
+    quint16 fields_updated;     ///< HIGHRES_IMU fields the simulator provides, 0 for state level HIL
+    bool gps;                   ///< Position can be sent as GPS fix
+};
+
 class QGCHilLink : public QThread
 {
     Q_OBJECT
 public:
     
     virtual bool isConnected() = 0;
-    virtual qint64 bytesAvailable() = 0;
     virtual int getPort() const = 0;
 
     /**
@@ -43,6 +63,14 @@ public:
      */
     virtual bool sensorHilEnabled() = 0;
 
+    /**
+     * @brief Parse one datagram received from the simulator
+     *
+     * Called from the thread of the HIL bridge, not from the GUI thread.
+     * @return true if the datagram completed a frame and state was filled
+     */
+    virtual bool parseDatagram(const char* data, qint64 length, QGCHilState& state) = 0;
+
 public slots:
     virtual void setPort(int port) = 0;
     /** @brief Add a new host to broadcast messages to */
@@ -58,7 +86,6 @@ public slots:
 
     virtual void selectAirframe(const QString& airframe) = 0;
 
-    virtual void readBytes() = 0;
     /**
      * @brief Write a number of bytes to the interface.
      *
@@ -42,7 +42,7 @@ This file is part of the QGROUNDCONTROL project
 #include <QHostInfo>
 
 QGCJSBSimLink::QGCJSBSimLink(UASInterface* mav, QString startupArguments, QString remoteHost, QHostAddress host, quint16 port) :
-    socket(NULL),
+    bridge(NULL),
     process(NULL),
     startupArguments(startupArguments)
 {
@@ -57,7 +57,7 @@ QGCJSBSimLink::QGCJSBSimLink(UASInterface* mav, QString startupArguments, QStrin
 
 QGCJSBSimLink::~QGCJSBSimLink()
 {   //do not disconnect unless it is connected.
-    //disconnectSimulation will delete the memory that was allocated for proces, terraSync and socket
+    //disconnectSimulation will delete the memory that was allocated for proces, terraSync and bridge
     if(connectState){
        disconnectSimulation();
     }
@@ -203,66 +203,18 @@ void QGCJSBSimLink::writeBytes(const char* data, qint64 size)
     QLOG_TRACE() << bytes;
     QLOG_TRACE() << "ASCII:" << ascii;
 #endif
-    if (connectState && socket) socket->writeDatagram(data, size, currentHost, currentPort);
+    if (connectState && bridge) bridge->writeDatagram(data, size, currentHost, currentPort);
 }
 
-/**
- * @brief Read a number of bytes from the interface.
- *
- * @param data Pointer to the data byte array to write the bytes to
- * @param maxLength The maximum number of bytes to write
- **/
-void QGCJSBSimLink::readBytes()
+bool QGCJSBSimLink::parseDatagram(const char* data, qint64 length, QGCHilState& state)
 {
-    const qint64 maxLength = 65536;
-    char data[maxLength];
-    QHostAddress sender;
-    quint16 senderPort;
-
-    qint64 s = socket->pendingDatagramSize();
-    if (s > maxLength) std::cerr << __FILE__ << __LINE__ << " UDP datagram overflow, allowed to read less bytes than datagram size" << std::endl;
-    socket->readDatagram(data, maxLength, &sender, &senderPort);
-
-    QByteArray b(data, s);
-
-    // Print string
-//    QString state(b);
-
-//    // Parse string
-//    float roll, pitch, yaw, rollspeed, pitchspeed, yawspeed;
-//    double lat, lon, alt;
-//    double vx, vy, vz, xacc, yacc, zacc;
-
-//    // Send updated state
-//    emit hilStateChanged(QGC::groundTimeUsecs(), roll, pitch, yaw, rollspeed,
-//                         pitchspeed, yawspeed, lat, lon, alt,
-//                         vx, vy, vz, xacc, yacc, zacc);
-
-
-
-
-        // Echo data for debugging purposes
-        std::cerr << __FILE__ << __LINE__ << "Received datagram:" << std::endl;
-        int i;
-        for (i=0; i<s; i++)
-        {
-            unsigned int v=data[i];
-            fprintf(stderr,"%02x ", v);
-        }
-        std::cerr << std::endl;
+    Q_UNUSED(state);
+    // The JSBSim output format is not decoded yet, echo data for debugging purposes
+    QLOG_TRACE() << "JSBSim link received datagram:" << QByteArray(data, length).toHex();
+    return false;
 }
 
 
-/**
- * @brief Get the number of bytes to read.
- *
- * @return The number of bytes to read
- **/
-qint64 QGCJSBSimLink::bytesAvailable()
-{
-    return socket->pendingDatagramSize();
-}
-
 /**
  * @brief Disconnect the connection.
  *
@@ -273,7 +225,6 @@ bool QGCJSBSimLink::disconnectSimulation()
     disconnect(process, SIGNAL(error(QProcess::ProcessError)),
                this, SLOT(processError(QProcess::ProcessError)));
     disconnect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
-    disconnect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
 
     if (process)
     {
@@ -281,11 +232,11 @@ bool QGCJSBSimLink::disconnectSimulation()
         delete process;
         process = NULL;
     }
-    if (socket)
+    if (bridge)
     {
-        socket->close();
-        delete socket;
-        socket = NULL;
+        bridge->close();
+        delete bridge;
+        bridge = NULL;
     }
 
     connectState = false;
@@ -305,18 +256,21 @@ bool QGCJSBSimLink::connectSimulation()
     QLOG_DEBUG() << "STARTING FLIGHTGEAR LINK";
 
     if (!mav) return false;
-    socket = new QUdpSocket(this);
-    connectState = socket->bind(host, port);
-
-    QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(readBytes()));
+    UAS* uas = dynamic_cast<UAS*>(mav);
+    // Simulator packets are parsed and HIL messages sent from the bridge thread
+    bridge = new QGCHilBridge(this, uas);
+    connectState = bridge->open(host, port);
+    if (!connectState)
+    {
+        delete bridge;
+        bridge = NULL;
+        return false;
+    }
 
     process = new QProcess(this);
 
     connect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
-    connect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
-
 
-    UAS* uas = dynamic_cast<UAS*>(mav);
     if (uas)
     {
         uas->startHil();
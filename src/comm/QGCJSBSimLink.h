@@ -42,6 +42,7 @@ This file is part of the QGROUNDCONTROL project
 #include <configuration.h>
 #include "UASInterface.h"
 #include "QGCHilLink.h"
+#include "QGCHilBridge.h"
 
 class QGCJSBSimLink : public QGCHilLink
 {
@@ -53,7 +54,6 @@ public:
     ~QGCJSBSimLink();
 
     bool isConnected();
-    qint64 bytesAvailable();
     int getPort() const {
         return port;
     }
@@ -85,6 +85,8 @@ public:
         return _sensorHilEnabled;
     }
 
+    bool parseDatagram(const char* data, qint64 length, QGCHilState& state);
+
 public slots:
 //    void setAddress(QString address);
     void setPort(int port);
@@ -114,7 +116,6 @@ public slots:
             emit sensorHilChanged(enable);
     }
 
-    void readBytes();
     /**
      * @brief Write a number of bytes to the interface.
      *
@@ -134,7 +135,7 @@ protected:
     quint16 currentPort;
     quint16 port;
     int id;
-    QUdpSocket* socket;
+    QGCHilBridge* bridge;
     bool connectState;
 
     quint64 bitsSentTotal;
@@ -47,7 +47,7 @@ QGCXPlaneLink::QGCXPlaneLink(UASInterface* mav, QString remoteHost, QHostAddress
     mav(mav),
     remoteHost(QHostAddress("127.0.0.1")),
     remotePort(49000),
-    socket(NULL),
+    bridge(NULL),
     process(NULL),
     terraSync(NULL),
     airframeID(QGCXPlaneLink::AIRFRAME_UNKNOWN),
@@ -102,6 +102,8 @@ void QGCXPlaneLink::storeSettings()
 
 void QGCXPlaneLink::setVersion(const QString& version)
 {
+    // The version is read by parseDatagram() in the bridge thread
+    QMutexLocker locker(&dataMutex);
     unsigned int oldVersion = xPlaneVersion;
     if (version.contains("9"))
     {
@@ -120,17 +122,31 @@ void QGCXPlaneLink::setVersion(const QString& version)
         xPlaneVersion = 12;
     }
 
-    if (oldVersion != xPlaneVersion)
+    unsigned int newVersion = xPlaneVersion;
+    locker.unlock();
+
+    if (oldVersion != newVersion)
     {
-        emit versionChanged(QString("X-Plane %1").arg(xPlaneVersion));
+        emit versionChanged(QString("X-Plane %1").arg(newVersion));
     }
 }
 
 void QGCXPlaneLink::setVersion(unsigned int version)
 {
+    QMutexLocker locker(&dataMutex);
     bool changed = (xPlaneVersion != version);
     xPlaneVersion = version;
-    if (changed) emit versionChanged(QString("X-Plane %1").arg(xPlaneVersion));
+    locker.unlock();
+    if (changed) emit versionChanged(QString("X-Plane %1").arg(version));
+}
+
+void QGCXPlaneLink::enableSensorHIL(bool enable)
+{
+    {
+        QMutexLocker locker(&dataMutex);
+        _sensorHilEnabled = enable;
+    }
+    emit sensorHilChanged(enable);
 }
 
 
@@ -411,37 +427,23 @@ void QGCXPlaneLink::writeBytes(const char* data, qint64 size)
     QLOG_TRACE() << bytes;
     QLOG_DEBUG() << "ASCII:" << ascii;
 #endif
-    if (connectState && socket) socket->writeDatagram(data, size, remoteHost, remotePort);
+    if (connectState && bridge) bridge->writeDatagram(data, size, remoteHost, remotePort);
 }
 
-/**
- * @brief Read a number of bytes from the interface.
- *
- * @param data Pointer to the data byte array to write the bytes to
- * @param maxLength The maximum number of bytes to write
- **/
-void QGCXPlaneLink::readBytes()
+bool QGCXPlaneLink::parseDatagram(const char* data, qint64 s, QGCHilState& state)
 {
+    // Called from the bridge thread, the settings and the parser state are
+    // guarded by dataMutex. Signals are emitted after unlocking it.
+    QMutexLocker locker(&dataMutex);
+    QStringList messages;
+
     // Only emit updates on attitude message
     bool emitUpdate = false;
     quint16 fields_changed = 0;
 
-    const qint64 maxLength = 1000;
-    char data[maxLength];
-    QHostAddress sender;
-    quint16 senderPort;
-
-    unsigned int s = socket->pendingDatagramSize();
-    if (s > maxLength) std::cerr << __FILE__ << __LINE__ << " UDP datagram overflow, allowed to read less bytes than datagram size" << std::endl;
-    socket->readDatagram(data, maxLength, &sender, &senderPort);
-
-    QByteArray b(data, s);
-
-    /*// Print string
-    QString state(b)*/;
-
     // Calculate the number of data segments a 36 bytes
     // XPlane always has 5 bytes header: 'DATA@'
+    if (s < 5) return false;
     unsigned nsegs = (s-5)/36;
 
     QLOG_TRACE() << "XPLANE:" << "LEN:" << s << "segs:" << nsegs;
@@ -614,18 +616,20 @@ void QGCXPlaneLink::readBytes()
         QLOG_DEBUG() << "UNKNOWN PACKET:" << data;
     }
 
-    // Send updated state
-    if (emitUpdate && (QGC::groundTimeMilliseconds() - simUpdateLast) > 3)
+    // Hand the state to the bridge
+    if (emitUpdate)
     {
-        simUpdateHz = simUpdateHz * 0.9f + 0.1f * (1000.0f / (QGC::groundTimeMilliseconds() - simUpdateLast));
-        if (QGC::groundTimeMilliseconds() - simUpdateLastText > 2000) {
-            emit statusMessage(tr("Receiving from XPlane at %1 Hz").arg(static_cast<int>(simUpdateHz)));
-            // Reset lowpass with current value
-            simUpdateHz = (1000.0f / (QGC::groundTimeMilliseconds() - simUpdateLast));
+        quint64 now = QGC::groundTimeMilliseconds();
+        if (now > simUpdateLast)
+        {
+            simUpdateHz = simUpdateHz * 0.9f + 0.1f * (1000.0f / (now - simUpdateLast));
+        }
+        if (now - simUpdateLastText > 2000) {
+            messages.append(tr("Receiving from XPlane at %1 Hz").arg(static_cast<int>(simUpdateHz)));
             // Set state
-            simUpdateLastText = QGC::groundTimeMilliseconds();
+            simUpdateLastText = now;
         }
-        simUpdateLast = QGC::groundTimeMilliseconds();
+        simUpdateLast = now;
 
         if (_sensorHilEnabled)
         {
@@ -633,51 +637,49 @@ void QGCXPlaneLink::readBytes()
             pressure_alt = alt;
             // set pressure alt to changed
             fields_changed |= (1 << 11);
-
-            emit sensorHilRawImuChanged(QGC::groundTimeUsecs(), xacc, yacc, zacc, rollspeed, pitchspeed, yawspeed,
-                                        xmag, ymag, zmag, abs_pressure, diff_pressure, pressure_alt, temperature, fields_changed);
         }
 
-        int gps_fix_type = 3;
-        float eph = 0.3;
-        float epv = 0.6;
-        float vel = sqrt(vx*vx + vy*vy + vz*vz);
-        float cog = atan2(vy, vx);
-        int satellites = 8;
-
-        emit sensorHilGpsChanged(QGC::groundTimeUsecs(), lat, lon, alt, gps_fix_type, eph, epv, vel, cog, satellites);
-        emit hilStateChanged(QGC::groundTimeUsecs(), roll, pitch, yaw, rollspeed,
-                     pitchspeed, yawspeed, lat, lon, alt,
-                     vx, vy, vz, xacc, yacc, zacc);
+        state.roll = roll;
+        state.pitch = pitch;
+        state.yaw = yaw;
+        state.rollspeed = rollspeed;
+        state.pitchspeed = pitchspeed;
+        state.yawspeed = yawspeed;
+        state.lat = lat;
+        state.lon = lon;
+        state.alt = alt;
+        state.vx = vx;
+        state.vy = vy;
+        state.vz = vz;
+        state.xacc = xacc;
+        state.yacc = yacc;
+        state.zacc = zacc;
+        state.xmag = xmag;
+        state.ymag = ymag;
+        state.zmag = zmag;
+        state.abs_pressure = abs_pressure;
+        state.diff_pressure = diff_pressure;
+        state.pressure_alt = pressure_alt;
+        state.temperature = temperature;
+        state.fields_updated = _sensorHilEnabled ? fields_changed : 0;
+        state.gps = true;
     }
 
     if (!oldConnectionState && xPlaneConnected)
     {
-        emit statusMessage(tr("Receiving from XPlane."));
+        messages.append(tr("Receiving from XPlane."));
     }
+    locker.unlock();
 
-    //    // Echo data for debugging purposes
-    //    std::cerr << __FILE__ << __LINE__ << "Received datagram:" << std::endl;
-    //    int i;
-    //    for (i=0; i<s; i++)
-    //    {
-    //        unsigned int v=data[i];
-    //        fprintf(stderr,"%02x ", v);
-    //    }
-    //    std::cerr << std::endl;
+    // Queued to the GUI thread, the link lives there
+    foreach (const QString& message, messages)
+    {
+        emit statusMessage(message);
+    }
+    return emitUpdate;
 }
 
 
-/**
- * @brief Get the number of bytes to read.
- *
- * @return The number of bytes to read
- **/
-qint64 QGCXPlaneLink::bytesAvailable()
-{
-    return socket->pendingDatagramSize();
-}
-
 /**
  * @brief Disconnect the connection.
  *
@@ -696,10 +698,6 @@ bool QGCXPlaneLink::disconnectSimulation()
         disconnect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
         disconnect(mav, SIGNAL(hilActuatorsChanged(uint64_t, float, float, float, float, float, float, float, float)), this, SLOT(updateActuators(uint64_t,float,float,float,float,float,float,float,float)));
 
-        disconnect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
-        disconnect(this, SIGNAL(sensorHilGpsChanged(quint64,double,double,double,int,float,float,float,float,int)), mav, SLOT(sendHilGps(quint64, double, double, double, int, float, float, float, float, int)));
-        disconnect(this, SIGNAL(sensorHilRawImuChanged(quint64,float,float,float,float,float,float,float,float,float,float,float,float,float,quint16)), mav, SLOT(sendHilSensors(quint64,float,float,float,float,float,float,float,float,float,float,float,float,float,quint16)));
-
         UAS* uas = dynamic_cast<UAS*>(mav);
         if (uas)
         {
@@ -719,11 +717,11 @@ bool QGCXPlaneLink::disconnectSimulation()
         delete terraSync;
         terraSync = NULL;
     }
-    if (socket)
+    if (bridge)
     {
-        socket->close();
-        delete socket;
-        socket = NULL;
+        bridge->close();
+        delete bridge;
+        bridge = NULL;
     }
 
     emit simulationDisconnected();
@@ -871,20 +869,20 @@ bool QGCXPlaneLink::connectSimulation()
     if (!mav) return false;
     if (connectState) return false;
 
-    socket = new QUdpSocket(this);
-    connectState = socket->bind(localHost, localPort);
-    if (!connectState) return false;
-
-    QObject::connect(socket, SIGNAL(readyRead()), this, SLOT(readBytes()));
+    UAS* uas = dynamic_cast<UAS*>(mav);
+    // Simulator packets are parsed and HIL messages sent from the bridge thread
+    bridge = new QGCHilBridge(this, uas);
+    connectState = bridge->open(localHost, localPort);
+    if (!connectState)
+    {
+        delete bridge;
+        bridge = NULL;
+        return false;
+    }
 
     connect(mav, SIGNAL(hilControlsChanged(uint64_t, float, float, float, float, uint8_t, uint8_t)), this, SLOT(updateControls(uint64_t,float,float,float,float,uint8_t,uint8_t)));
     connect(mav, SIGNAL(hilActuatorsChanged(uint64_t, float, float, float, float, float, float, float, float)), this, SLOT(updateActuators(uint64_t,float,float,float,float,float,float,float,float)));
 
-    connect(this, SIGNAL(hilStateChanged(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)), mav, SLOT(sendHilState(quint64,float,float,float,float,float,float,double,double,double,float,float,float,float,float,float)));
-    connect(this, SIGNAL(sensorHilGpsChanged(quint64,double,double,double,int,float,float,float,float,int)), mav, SLOT(sendHilGps(quint64, double, double, double, int, float, float, float, float, int)));
-    connect(this, SIGNAL(sensorHilRawImuChanged(quint64,float,float,float,float,float,float,float,float,float,float,float,float,float,quint16)), mav, SLOT(sendHilSensors(quint64,float,float,float,float,float,float,float,float,float,float,float,float,float,quint16)));
-
-    UAS* uas = dynamic_cast<UAS*>(mav);
     if (uas)
     {
         uas->startHil();
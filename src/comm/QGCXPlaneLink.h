@@ -42,6 +42,7 @@ This file is part of the QGROUNDCONTROL project
 #include <configuration.h>
 #include "UASInterface.h"
 #include "QGCHilLink.h"
+#include "QGCHilBridge.h"
 
 class QGCXPlaneLink : public QGCHilLink
 {
@@ -63,7 +64,6 @@ public:
     void storeSettings();
 
     bool isConnected();
-    qint64 bytesAvailable();
     int getPort() const {
         return localPort;
     }
@@ -105,6 +105,8 @@ public:
         return _sensorHilEnabled;
     }
 
+    bool parseDatagram(const char* data, qint64 length, QGCHilState& state);
+
 public slots:
 //    void setAddress(QString address);
     void setPort(int port);
@@ -119,15 +121,10 @@ public slots:
     /** @brief Set the simulator version as integer */
     void setVersion(unsigned int version);
 
-    void enableSensorHIL(bool enable) {
-        if (enable != _sensorHilEnabled)
-            _sensorHilEnabled = enable;
-            emit sensorHilChanged(enable);
-    }
+    void enableSensorHIL(bool enable);
 
     void processError(QProcess::ProcessError err);
 
-    void readBytes();
     /**
      * @brief Write a number of bytes to the interface.
      *
@@ -171,7 +168,7 @@ protected:
     QHostAddress remoteHost;
     quint16 remotePort;
     int id;
-    QUdpSocket* socket;
+    QGCHilBridge* bridge;
     bool connectState;
 
     quint64 bitsSentTotal;
@@ -182,7 +179,7 @@ protected:
     quint64 bitsReceivedMax;
     quint64 connectionStartTime;
     QMutex statisticsMutex;
-    QMutex dataMutex;
+    QMutex dataMutex;               ///< Guards the parser state and the settings parseDatagram() reads
     QTimer refreshTimer;
     QProcess* process;
     QProcess* terraSync;
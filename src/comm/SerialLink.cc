@@ -63,6 +63,8 @@ void SerialLink::requestReset()
 
 SerialLink::~SerialLink()
 {
+    // The transmit scheduler and the decoder thread stop using the link
+    announceDestruction();
     disconnect();
     writeSettings();
     QLOG_INFO() << "Serial Link destroyed";
@@ -157,8 +159,8 @@ void SerialLink::run()
     }
 
     // Qt way to make clear what a while(1) loop does
-    qint64 msecs = QDateTime::currentMSecsSinceEpoch();
-    qint64 initialmsecs = QDateTime::currentMSecsSinceEpoch();
+    qint64 msecs = static_cast<qint64>(QGC::groundTimeMilliseconds());
+    qint64 initialmsecs = static_cast<qint64>(QGC::groundTimeMilliseconds());
     quint64 bytes = 0;
     bool triedreset = false;
     bool triedDTR = false;
@@ -224,7 +226,7 @@ void SerialLink::run()
                 QLOG_TRACE() << "rx of length " << QString::number(readData.length());
 
                 m_bytesRead += readData.length();
-                m_bitsReceivedTotal += readData.length() * 8;
+                metrics.received(readData.length());
             }
         } else {
             QLOG_TRACE() << "Wait write response timeout %1" << QTime::currentTime().toString();
@@ -233,7 +235,7 @@ void SerialLink::run()
         if (bytes != m_bytesRead) // i.e things are good and data is being read.
         {
             bytes = m_bytesRead;
-            msecs = QDateTime::currentMSecsSinceEpoch();
+            msecs = static_cast<qint64>(QGC::groundTimeMilliseconds());
         }
         else
         {
@@ -245,10 +247,10 @@ void SerialLink::run()
             */
 
 
-            if (QDateTime::currentMSecsSinceEpoch() - msecs > timeout)
+            if (static_cast<qint64>(QGC::groundTimeMilliseconds()) - msecs > timeout)
             {
                 //It's been 10 seconds since the last data came in. Reset and try again
-                msecs = QDateTime::currentMSecsSinceEpoch();
+                msecs = static_cast<qint64>(QGC::groundTimeMilliseconds());
                 if (msecs - initialmsecs > 25000)
                 {
                     //After initial 25 seconds, timeouts are increased to 30 seconds.
@@ -319,12 +321,17 @@ void SerialLink::writeBytes(const char* data, qint64 size)
         }
 
         // Increase write counter
-        m_bitsSentTotal += size * 8;
+        metrics.sent(size);
 
         // Extra debug logging
         QLOG_TRACE() << QByteArray(data,size);
     } else {
-        disconnect();
+        // The transmit scheduler writes from its own thread
+        if (QThread::currentThread() == thread()) {
+            disconnect();
+        } else {
+            QMetaObject::invokeMethod(this, "disconnect", Qt::QueuedConnection);
+        }
         // Error occured
         emit communicationError(getName(), tr("Could not send data - link %1 is disconnected!").arg(getName()));
     }
@@ -361,7 +368,7 @@ void SerialLink::readBytes()
             //                fprintf(stderr,"%02x ", v);
             //            }
             //            fprintf(stderr,"\n");
-            m_bitsReceivedTotal += numBytes * 8;
+            metrics.received(numBytes);
         }
     }
     m_dataMutex.unlock();
@@ -462,7 +469,6 @@ bool SerialLink::hardwareConnect()
     }
 
     QObject::connect(m_port,SIGNAL(aboutToClose()),this,SIGNAL(disconnected()));
-    m_connectionStartTime = MG::TIME::getGroundTimeNow();
 
     if (!m_port->open(QIODevice::ReadWrite))
     {
@@ -560,46 +566,42 @@ qint64 SerialLink::getNominalDataRate()
 
 qint64 SerialLink::getTotalUpstream()
 {
-    m_statisticsMutex.lock();
-    return m_bitsSentTotal / ((MG::TIME::getGroundTimeNow() - m_connectionStartTime) / 1000);
-    m_statisticsMutex.unlock();
+    return metrics.meanRate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 SerialLink::getCurrentUpstream()
 {
-    return 0; // TODO
+    return metrics.window(1).rate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 SerialLink::getMaxUpstream()
 {
-    return 0; // TODO
+    return metrics.peakRate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 SerialLink::getBitsSent()
 {
-    return m_bitsSentTotal;
+    return metrics.total(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 SerialLink::getBitsReceived()
 {
-    return m_bitsReceivedTotal;
+    return metrics.total(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 SerialLink::getTotalDownstream()
 {
-    m_statisticsMutex.lock();
-    return m_bitsReceivedTotal / ((MG::TIME::getGroundTimeNow() - m_connectionStartTime) / 1000);
-    m_statisticsMutex.unlock();
+    return metrics.meanRate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 SerialLink::getCurrentDownstream()
 {
-    return 0; // TODO
+    return metrics.window(1).rate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 SerialLink::getMaxDownstream()
 {
-    return 0; // TODO
+    return metrics.peakRate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 bool SerialLink::isFullDuplex()
@@ -71,6 +71,8 @@ public:
 
     bool isConnected();
     qint64 bytesAvailable();
+    /** @brief writeBytes() only appends to the transmit buffer under its mutex */
+    bool isWriteThreadSafe() const { return true; }
 
     /**
      * @brief The port handle
@@ -162,16 +164,6 @@ protected:
     int m_timeout;
     int m_id;
 
-    quint64 m_bitsSentTotal;
-    quint64 m_bitsSentShortTerm;
-    quint64 m_bitsSentCurrent;
-    quint64 m_bitsSentMax;
-    quint64 m_bitsReceivedTotal;
-    quint64 m_bitsReceivedShortTerm;
-    quint64 m_bitsReceivedCurrent;
-    quint64 m_bitsReceivedMax;
-    quint64 m_connectionStartTime;
-    QMutex m_statisticsMutex;
     QMutex m_dataMutex;
     QMutex m_writeMutex;
     QList<QString> m_ports;
@@ -40,8 +40,24 @@ This file is part of the QGROUNDCONTROL project
 #include <QHostInfo>
 //#include <netinet/in.h>
 
+#ifdef Q_OS_LINUX
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <errno.h>
+// Batched receive and send, see recvmmsg(2) and sendmmsg(2)
+#define UDPLINK_MMSG
+#endif
+
 UDPLink::UDPLink(QHostAddress host, quint16 port)
-	: socket(NULL)
+    : socket(NULL),
+      lastPeerExpiry(0),
+      destinationsRevision(0),
+      socketFamily(0),
+      datagramsReceived(0),
+      deliveries(0),
+      datagramsTruncated(0)
 {
     this->host = host;
     this->port = port;
@@ -56,6 +72,8 @@ UDPLink::UDPLink(QHostAddress host, quint16 port)
 
 UDPLink::~UDPLink()
 {
+    // The transmit scheduler and the decoder thread stop using the link
+    announceDestruction();
     disconnect();
 	this->deleteLater();
 }
@@ -124,10 +142,10 @@ void UDPLink::addHost(const QString& host)
                     address = hostAddresses.at(i);
                 }
             }
-            hosts.append(address);
             QLOG_DEBUG() << "Address:" << address.toString();
             // Set port according to user input
-            ports.append(host.split(":").last().toInt());
+            QMutexLocker locker(&dataMutex);
+            peers.addStatic(address, host.split(":").last().toInt());
         }
     }
     else
@@ -135,10 +153,9 @@ void UDPLink::addHost(const QString& host)
         QHostInfo info = QHostInfo::fromName(host);
         if (info.error() == QHostInfo::NoError)
         {
-            // Add host
-            hosts.append(info.addresses().first());
-            // Set port according to default (this port)
-            ports.append(port);
+            // Add host, port according to default (this port)
+            QMutexLocker locker(&dataMutex);
+            peers.addStatic(info.addresses().first(), port);
         }
     }
 }
@@ -146,7 +163,13 @@ void UDPLink::addHost(const QString& host)
 void UDPLink::removeHost(const QString& hostname)
 {
     QString host = hostname;
-    if (host.contains(":")) host = host.split(":").first();
+    // Without a port all peers of the host are removed
+    int port = -1;
+    if (host.contains(":"))
+    {
+        port = host.split(":").last().toInt();
+        host = host.split(":").first();
+    }
     host = host.trimmed();
     QHostInfo info = QHostInfo::fromName(host);
     QHostAddress address;
@@ -159,95 +182,295 @@ void UDPLink::removeHost(const QString& hostname)
             address = hostAddresses.at(i);
         }
     }
-    for (int i = 0; i < hosts.count(); ++i)
+    QMutexLocker locker(&dataMutex);
+    if (port >= 0)
     {
-        if (hosts.at(i) == address)
-        {
-            hosts.removeAt(i);
-            ports.removeAt(i);
-        }
+        peers.remove(address, port);
+    }
+    else
+    {
+        peers.remove(address);
     }
 }
 
-void UDPLink::writeBytes(const char* data, qint64 size)
+QList<QHostAddress> UDPLink::getHosts()
 {
-    // Broadcast to all connected systems
-    for (int h = 0; h < hosts.size(); h++)
+    QMutexLocker locker(&dataMutex);
+    return peers.getAddresses();
+}
+
+void UDPLink::setPeerIdleTimeout(int ms)
+{
+    QMutexLocker locker(&dataMutex);
+    peers.setIdleTimeout(qMax(0, ms));
+}
+
+void UDPLink::expirePeers(quint64 now)
+{
+    if (now - lastPeerExpiry < PEER_EXPIRY_INTERVAL) return;
+    lastPeerExpiry = now;
+    int expired = peers.expire(now);
+    if (expired > 0)
     {
-        QHostAddress currentHost = hosts.at(h);
-        quint16 currentPort = ports.at(h);
-//#define UDPLINK_DEBUG
-#ifdef UDPLINK_DEBUG
-        QString bytes;
-        QString ascii;
-        for (int i=0; i<size; i++)
+        QLOG_DEBUG() << "UDP:" << expired << "idle peers removed," << peers.size() << "left";
+    }
+}
+
+void UDPLink::updateDestinations()
+{
+    if (destinationsRevision == peers.getRevision() && destinations.size() == peers.size()) return;
+    destinationsRevision = peers.getRevision();
+
+    QList<UDPPeerTable::Peer> list = peers.getPeers();
+    destinations.resize(list.size());
+    for (int i = 0; i < list.size(); ++i)
+    {
+        Destination& destination = destinations[i];
+        destination.address = list.at(i).address;
+        destination.port = list.at(i).port;
+        destination.nativeAddress.clear();
+#ifdef UDPLINK_MMSG
+        if (socketFamily == AF_INET && destination.address.protocol() == QAbstractSocket::IPv4Protocol)
+        {
+            sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_port = htons(destination.port);
+            address.sin_addr.s_addr = htonl(destination.address.toIPv4Address());
+            destination.nativeAddress = QByteArray((const char*)&address, sizeof(address));
+        }
+        else if (socketFamily == AF_INET6)
         {
-            unsigned char v = data[i];
-            bytes.append(QString().sprintf("%02x ", v));
-            if (data[i] > 31 && data[i] < 127)
+            sockaddr_in6 address;
+            memset(&address, 0, sizeof(address));
+            address.sin6_family = AF_INET6;
+            address.sin6_port = htons(destination.port);
+            if (destination.address.protocol() == QAbstractSocket::IPv4Protocol)
             {
-                ascii.append(data[i]);
+                // Dual stack socket, IPv4 as ::ffff:a.b.c.d
+                quint32 ip4 = htonl(destination.address.toIPv4Address());
+                address.sin6_addr.s6_addr[10] = 0xff;
+                address.sin6_addr.s6_addr[11] = 0xff;
+                memcpy(&address.sin6_addr.s6_addr[12], &ip4, 4);
             }
             else
             {
-                ascii.append(219);
+                Q_IPV6ADDR ip6 = destination.address.toIPv6Address();
+                memcpy(&address.sin6_addr, &ip6, 16);
+                address.sin6_scope_id = destination.address.scopeId().toUInt();
             }
+            destination.nativeAddress = QByteArray((const char*)&address, sizeof(address));
+        }
+#endif
+    }
+}
+
+void UDPLink::writeBytes(const char* data, qint64 size)
+{
+    if (!socket) return;
+
+    QMutexLocker locker(&dataMutex);
+    expirePeers(QGC::groundTimeMilliseconds());
+    updateDestinations();
+
+//#define UDPLINK_DEBUG
+#ifdef UDPLINK_DEBUG
+    QString bytes;
+    QString ascii;
+    for (int i=0; i<size; i++)
+    {
+        unsigned char v = data[i];
+        bytes.append(QString().sprintf("%02x ", v));
+        if (data[i] > 31 && data[i] < 127)
+        {
+            ascii.append(data[i]);
+        }
+        else
+        {
+            ascii.append(219);
+        }
+    }
+    QLOG_TRACE() << "Sent" << size << "bytes to" << destinations.size() << "hosts, data:";
+    QLOG_TRACE() << bytes;
+    QLOG_TRACE() << "ASCII:" << ascii;
+#endif
+
+    // Broadcast to all connected systems
+    const int count = destinations.size();
+    metrics.sent(size * count);
+#ifdef UDPLINK_MMSG
+    // One sendmmsg() call for all peers, the payload is shared
+    QVector<mmsghdr> messages(count);
+    iovec payload;
+    payload.iov_base = const_cast<char*>(data);
+    payload.iov_len = size;
+    int native = 0;
+    for (int h = 0; h < count; h++)
+    {
+        QByteArray& address = destinations[h].nativeAddress;
+        if (address.isEmpty()) continue;
+        mmsghdr& message = messages[native++];
+        memset(&message, 0, sizeof(message));
+        message.msg_hdr.msg_name = address.data();
+        message.msg_hdr.msg_namelen = address.size();
+        message.msg_hdr.msg_iov = &payload;
+        message.msg_hdr.msg_iovlen = 1;
+    }
+    int sent = 0;
+    while (sent < native)
+    {
+        int result = ::sendmmsg(socket->socketDescriptor(), messages.data() + sent, native - sent, 0);
+        if (result < 0)
+        {
+            if (errno == EINTR) continue;
+            // Skip the peer that failed, as writeDatagram() would
+            QLOG_TRACE() << "UDP: sendmmsg failed:" << strerror(errno);
+            result = 1;
         }
-        QLOG_TRACE() << "Sent" << size << "bytes to" << currentHost.toString() << ":" << currentPort << "data:";
-        QLOG_TRACE() << bytes;
-        QLOG_TRACE() << "ASCII:" << ascii;
+        sent += result;
+    }
+    if (native == count) return;
 #endif
-        socket->writeDatagram(data, size, currentHost, currentPort);
+    for (int h = 0; h < count; h++)
+    {
+        const Destination& destination = destinations.at(h);
+        if (!destination.nativeAddress.isEmpty()) continue;
+        socket->writeDatagram(data, size, destination.address, destination.port);
     }
 }
 
 /**
- * @brief Read a number of bytes from the interface.
+ * @brief Read all pending datagrams and deliver them in batches.
  *
- * @param data Pointer to the data byte array to write the bytes to
- * @param maxLength The maximum number of bytes to write
+ * The datagrams are appended to one buffer and delivered with a single
+ * bytesReceived signal, MAVLink frames never span datagrams so the stream
+ * parser does not care where one ends.
  **/
 void UDPLink::readBytes()
 {
+    const quint64 now = QGC::groundTimeMilliseconds();
+    QByteArray batch;
+    batch.reserve(MAX_DELIVERY_SIZE);
+
     while (socket->hasPendingDatagrams())
     {
-        QByteArray datagram;
-        datagram.resize(socket->pendingDatagramSize());
+        // The first datagram always goes through QUdpSocket, it re-enables
+        // the read notification of the socket
+        qint64 size = socket->pendingDatagramSize();
+        if (size < 0) break;
+        if (!batch.isEmpty() && batch.size() + size > MAX_DELIVERY_SIZE)
+        {
+            deliver(batch);
+        }
+        int offset = batch.size();
+        batch.resize(offset + size);
 
         QHostAddress sender;
         quint16 senderPort;
-        socket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        size = socket->readDatagram(batch.data() + offset, size, &sender, &senderPort);
+        if (size < 0)
+        {
+            batch.resize(offset);
+            break;
+        }
+        batch.resize(offset + size);
+        datagramsReceived++;
+        {
+            // Add host to broadcast list if not yet present
+            QMutexLocker locker(&dataMutex);
+            peers.seen(sender, senderPort, now);
+        }
+
+        datagramsReceived += readBatch(batch, now);
+
+        if (batch.size() >= MAX_DELIVERY_SIZE)
+        {
+            deliver(batch);
+        }
+    }
+
+    if (!batch.isEmpty())
+    {
+        deliver(batch);
+    }
+
+    QMutexLocker locker(&dataMutex);
+    expirePeers(now);
+}
+
+void UDPLink::deliver(QByteArray& batch)
+{
+    deliveries++;
+    metrics.received(batch.size());
+    emit bytesReceived(this, batch);
+    batch = QByteArray();
+    batch.reserve(MAX_DELIVERY_SIZE);
+}
 
-        // FIXME TODO Check if this method is better than retrieving the data by individual processes
-        emit bytesReceived(this, datagram);
+int UDPLink::readBatch(QByteArray& batch, quint64 now)
+{
+#ifdef UDPLINK_MMSG
+    // Slots of the largest datagram, allocated once (2 MB), so bridges that pack many frames into one are read whole
+    if (receivePool.size() != RECEIVE_BATCH * RECEIVE_SLOT_SIZE)
+    {
+        receivePool.resize(RECEIVE_BATCH * RECEIVE_SLOT_SIZE);
+    }
 
-//        // Echo data for debugging purposes
-//        std::cerr << __FILE__ << __LINE__ << "Received datagram:" << std::endl;
-//        int i;
-//        for (i=0; i<s; i++)
-//        {
-//            unsigned int v=data[i];
-//            fprintf(stderr,"%02x ", v);
-//        }
-//        std::cerr << std::endl;
+    mmsghdr messages[RECEIVE_BATCH];
+    iovec slots[RECEIVE_BATCH];
+    sockaddr_storage senders[RECEIVE_BATCH];
+    memset(messages, 0, sizeof(messages));
+    for (int i = 0; i < RECEIVE_BATCH; i++)
+    {
+        slots[i].iov_base = receivePool.data() + i * RECEIVE_SLOT_SIZE;
+        slots[i].iov_len = RECEIVE_SLOT_SIZE;
+        messages[i].msg_hdr.msg_iov = &slots[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+        messages[i].msg_hdr.msg_name = &senders[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+    }
 
+    int count = ::recvmmsg(socket->socketDescriptor(), messages, RECEIVE_BATCH, MSG_DONTWAIT, NULL);
+    if (count <= 0) return 0;
 
-        // Add host to broadcast list if not yet present
-        if (!hosts.contains(sender))
+    for (int i = 0; i < count; i++)
+    {
+        const msghdr& header = messages[i].msg_hdr;
+        if (header.msg_flags & MSG_TRUNC)
         {
-            hosts.append(sender);
-            ports.append(senderPort);
-            //        ports->insert(sender, senderPort);
+            if (datagramsTruncated++ == 0)
+            {
+                QLOG_WARN() << "UDP: dropped a datagram larger than" << RECEIVE_SLOT_SIZE << "bytes";
+            }
+            continue;
         }
-        else
+        if (!batch.isEmpty() && batch.size() + (int)messages[i].msg_len > MAX_DELIVERY_SIZE)
+        {
+            deliver(batch);
+        }
+        batch.append(static_cast<const char*>(slots[i].iov_base), messages[i].msg_len);
+
+        const sockaddr* address = reinterpret_cast<const sockaddr*>(&senders[i]);
+        quint16 senderPort = 0;
+        if (address->sa_family == AF_INET)
         {
-            int index = hosts.indexOf(sender);
-            ports.replace(index, senderPort);
+            senderPort = ntohs(reinterpret_cast<const sockaddr_in*>(address)->sin_port);
         }
+        else if (address->sa_family == AF_INET6)
+        {
+            senderPort = ntohs(reinterpret_cast<const sockaddr_in6*>(address)->sin6_port);
+        }
+        QMutexLocker locker(&dataMutex);
+        peers.seen(QHostAddress(address), senderPort, now);
     }
+    return count;
+#else
+    Q_UNUSED(batch);
+    Q_UNUSED(now);
+    return 0;
+#endif
 }
 
-
 /**
  * @brief Get the number of bytes to read.
  *
@@ -317,6 +540,24 @@ bool UDPLink::hardwareConnect(void)
     connectState = socket->bind(host, port);
 //    }
 
+    socketFamily = 0;
+#ifdef UDPLINK_MMSG
+    if (connectState)
+    {
+        sockaddr_storage address;
+        socklen_t length = sizeof(address);
+        if (::getsockname(socket->socketDescriptor(), reinterpret_cast<sockaddr*>(&address), &length) == 0)
+        {
+            socketFamily = address.ss_family;
+        }
+    }
+#endif
+    {
+        // The native addresses depend on the socket family
+        QMutexLocker locker(&dataMutex);
+        destinations.clear();
+    }
+
     //Provides Multicast functionality to UdpSocket
     /* not working yet
     if (multicast)
@@ -349,7 +590,6 @@ bool UDPLink::hardwareConnect(void)
     emit connected(this);
     if (connectState) {
         emit connected();
-        connectionStartTime = QGC::groundTimeUsecs()/1000;
     }
 	return connectState;
 }
@@ -389,48 +629,42 @@ qint64 UDPLink::getNominalDataRate()
 
 qint64 UDPLink::getTotalUpstream()
 {
-    statisticsMutex.lock();
-    qint64 totalUpstream = bitsSentTotal / ((QGC::groundTimeUsecs()/1000 - connectionStartTime) / 1000);
-    statisticsMutex.unlock();
-    return totalUpstream;
+    return metrics.meanRate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 UDPLink::getCurrentUpstream()
 {
-    return 0; // TODO
+    return metrics.window(1).rate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 UDPLink::getMaxUpstream()
 {
-    return 0; // TODO
+    return metrics.peakRate(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 UDPLink::getBitsSent()
 {
-    return bitsSentTotal;
+    return metrics.total(LinkMetrics::BYTES_SENT) * 8;
 }
 
 qint64 UDPLink::getBitsReceived()
 {
-    return bitsReceivedTotal;
+    return metrics.total(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 UDPLink::getTotalDownstream()
 {
-    statisticsMutex.lock();
-    qint64 totalDownstream = bitsReceivedTotal / ((QGC::groundTimeUsecs()/1000 - connectionStartTime) / 1000);
-    statisticsMutex.unlock();
-    return totalDownstream;
+    return metrics.meanRate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 UDPLink::getCurrentDownstream()
 {
-    return 0; // TODO
+    return metrics.window(1).rate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 qint64 UDPLink::getMaxDownstream()
 {
-    return 0; // TODO
+    return metrics.peakRate(LinkMetrics::BYTES_RECEIVED) * 8;
 }
 
 bool UDPLink::isFullDuplex()
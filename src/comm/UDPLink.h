@@ -36,8 +36,10 @@ This file is part of the QGROUNDCONTROL project
 #include <QMap>
 #include <QMutex>
 #include <QUdpSocket>
+#include <QVector>
 #include <LinkInterface.h>
 #include <configuration.h>
+#include "UDPPeerTable.h"
 
 class UDPLink : public LinkInterface
 {
@@ -45,6 +47,13 @@ class UDPLink : public LinkInterface
     //Q_INTERFACES(UDPLinkInterface:LinkInterface)
 
 public:
+    enum {
+        RECEIVE_BATCH = 32,             ///< Datagrams read per recvmmsg() call at most
+        RECEIVE_SLOT_SIZE = 65536,      ///< Largest datagram read by recvmmsg(), any UDP payload fits
+        MAX_DELIVERY_SIZE = 65536,      ///< Bytes delivered with one bytesReceived signal at most
+        PEER_EXPIRY_INTERVAL = 1000     ///< ms between checks for idle peers
+    };
+
     UDPLink(QHostAddress host = QHostAddress::Any, quint16 port = 14550);
     //UDPLink(QHostAddress host = "239.255.76.67", quint16 port = 7667);
     ~UDPLink();
@@ -53,6 +62,8 @@ public:
 
     bool isConnected();
     qint64 bytesAvailable();
+    /** @brief writeBytes() sends under the data mutex */
+    bool isWriteThreadSafe() const { return true; }
     int getPort() const {
         return port;
     }
@@ -67,9 +78,14 @@ public:
     int getParityType();
     int getDataBitsType();
     int getStopBitsType();
-    QList<QHostAddress> getHosts() {
-        return hosts;
-    }
+    QList<QHostAddress> getHosts();
+    /** @brief Set after how many ms without datagrams a sender is no longer sent to, 0 keeps it */
+    void setPeerIdleTimeout(int ms);
+
+    /** @brief Datagrams received since the link was created */
+    quint64 getDatagramsReceived() const { return datagramsReceived; }
+    /** @brief Number of bytesReceived signals the datagrams were delivered with */
+    quint64 getDeliveries() const { return deliveries; }
 
     /* Extensive statistics for scientific purposes */
     qint64 getNominalDataRate();
@@ -115,20 +131,38 @@ protected:
     int id;
     QUdpSocket* socket;
     bool connectState;
-    QList<QHostAddress> hosts;
-    QList<quint16> ports;
-
-    quint64 bitsSentTotal;
-    quint64 bitsSentCurrent;
-    quint64 bitsSentMax;
-    quint64 bitsReceivedTotal;
-    quint64 bitsReceivedCurrent;
-    quint64 bitsReceivedMax;
-    quint64 connectionStartTime;
-    QMutex statisticsMutex;
+    UDPPeerTable peers;             ///< Hosts to send to, guarded by dataMutex
+    quint64 lastPeerExpiry;
+
+    /** @brief A peer with its address in the form the socket sends to */
+    struct Destination {
+        QHostAddress address;
+        quint16 port;
+        QByteArray nativeAddress;   ///< sockaddr, empty if the socket cannot send to it natively
+    };
+    QVector<Destination> destinations;  ///< Built from the peers, guarded by dataMutex
+    quint64 destinationsRevision;
+    int socketFamily;               ///< Address family of the bound socket
+    QByteArray receivePool;         ///< RECEIVE_BATCH slots reused by every recvmmsg() call
+    quint64 datagramsReceived;
+    quint64 deliveries;
+    quint64 datagramsTruncated;
+
     QMutex dataMutex;
 
     void setName(QString name);
+    /**
+     * @brief Read the datagrams queued after the first one, appends them and returns their count
+     *
+     * A datagram that would grow the batch beyond MAX_DELIVERY_SIZE delivers the batch first.
+     */
+    int readBatch(QByteArray& batch, quint64 now);
+    /** @brief Emit bytesReceived with the batch and start a new one */
+    void deliver(QByteArray& batch);
+    /** @brief Rebuild the destinations if the peers changed, called with dataMutex locked */
+    void updateDestinations();
+    /** @brief Forget idle peers at most once per PEER_EXPIRY_INTERVAL, called with dataMutex locked */
+    void expirePeers(quint64 now);
 
 private:
 	bool hardwareConnect(void);
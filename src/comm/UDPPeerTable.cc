@@ -0,0 +1,131 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Hash table of the peers a UDP link sends to
+ */
+
+#include "UDPPeerTable.h"
+
+UDPPeerTable::UDPPeerTable(quint64 idleTimeout) :
+    idleTimeout(idleTimeout),
+    revision(0)
+{
+}
+
+void UDPPeerTable::addStatic(const QHostAddress& address, quint16 port)
+{
+    Peer& peer = peers[Endpoint(address, port)];
+    peer.address = address;
+    peer.port = port;
+    peer.isStatic = true;
+    revision++;
+}
+
+bool UDPPeerTable::remove(const QHostAddress& address, quint16 port)
+{
+    if (peers.remove(Endpoint(address, port)) == 0) return false;
+    revision++;
+    return true;
+}
+
+int UDPPeerTable::remove(const QHostAddress& address)
+{
+    int removed = 0;
+    QHash<Endpoint, Peer>::iterator i = peers.begin();
+    while (i != peers.end())
+    {
+        if (i.key().first == address)
+        {
+            i = peers.erase(i);
+            removed++;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (removed > 0) revision++;
+    return removed;
+}
+
+void UDPPeerTable::clear()
+{
+    peers.clear();
+    revision++;
+}
+
+bool UDPPeerTable::seen(const QHostAddress& address, quint16 port, quint64 now)
+{
+    Endpoint endpoint(address, port);
+    QHash<Endpoint, Peer>::iterator i = peers.find(endpoint);
+    if (i == peers.end())
+    {
+        Peer peer;
+        peer.address = address;
+        peer.port = port;
+        peer.lastSeen = now;
+        peer.packets = 1;
+        peers.insert(endpoint, peer);
+        revision++;
+        return true;
+    }
+
+    Peer& peer = i.value();
+    peer.lastSeen = now;
+    peer.packets++;
+    return false;
+}
+
+QList<QHostAddress> UDPPeerTable::getAddresses() const
+{
+    QList<QHostAddress> addresses;
+    foreach (const Endpoint& endpoint, peers.keys())
+    {
+        addresses.append(endpoint.first);
+    }
+    return addresses;
+}
+
+int UDPPeerTable::expire(quint64 now)
+{
+    if (idleTimeout == 0 || now < idleTimeout) return 0;
+
+    int expired = 0;
+    QHash<Endpoint, Peer>::iterator i = peers.begin();
+    while (i != peers.end())
+    {
+        if (!i.value().isStatic && i.value().lastSeen < now - idleTimeout)
+        {
+            i = peers.erase(i);
+            expired++;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    if (expired > 0) revision++;
+    return expired;
+}
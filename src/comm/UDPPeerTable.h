@@ -0,0 +1,102 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Hash table of the peers a UDP link sends to
+ */
+
+#ifndef UDPPEERTABLE_H
+#define UDPPEERTABLE_H
+
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QPair>
+
+/**
+ * Peers are keyed by address and port, so several senders on one host
+ * (e.g. SITL instances on 127.0.0.1) are separate peers and all of them
+ * are sent to. Configured hosts are static, peers learned from
+ * received datagrams are removed by expire() once they were idle for
+ * longer than the idle timeout.
+ *
+ * The revision changes with every change of the destinations, so a sender
+ * can cache what it derives from them (e.g. native socket addresses).
+ */
+class UDPPeerTable
+{
+public:
+    enum {
+        DEFAULT_IDLE_TIMEOUT = 30000    ///< ms
+    };
+
+    /** @brief Key of a peer */
+    typedef QPair<QHostAddress, quint16> Endpoint;
+
+    struct Peer {
+        Peer() : port(0), lastSeen(0), packets(0), isStatic(false) {}
+        QHostAddress address;
+        quint16 port;
+        quint64 lastSeen;   ///< Time of the last datagram in ms
+        quint64 packets;    ///< Datagrams received from this peer
+        bool isStatic;      ///< Configured host, never expires
+    };
+
+    UDPPeerTable(quint64 idleTimeout = DEFAULT_IDLE_TIMEOUT);
+
+    /** @brief Set after how many ms without datagrams a learned peer expires, 0 never expires */
+    void setIdleTimeout(quint64 ms) { idleTimeout = ms; }
+    quint64 getIdleTimeout() const { return idleTimeout; }
+
+    /** @brief Add a configured host or make a learned one static */
+    void addStatic(const QHostAddress& address, quint16 port);
+    /** @brief Remove a peer, static or learned */
+    bool remove(const QHostAddress& address, quint16 port);
+    /** @brief Remove all peers of an address, returns their number */
+    int remove(const QHostAddress& address);
+    void clear();
+
+    /**
+     * @brief Record a datagram from a sender
+     * @return true if the sender was not known before
+     */
+    bool seen(const QHostAddress& address, quint16 port, quint64 now);
+    /** @brief Remove the learned peers idle since before now - idle timeout */
+    int expire(quint64 now);
+
+    int size() const { return peers.size(); }
+    bool contains(const QHostAddress& address, quint16 port) const { return peers.contains(Endpoint(address, port)); }
+    Peer getPeer(const QHostAddress& address, quint16 port) const { return peers.value(Endpoint(address, port)); }
+    QList<Peer> getPeers() const { return peers.values(); }
+    /** @brief Address of every peer, an address with several ports is listed once per port */
+    QList<QHostAddress> getAddresses() const;
+    quint64 getRevision() const { return revision; }
+
+protected:
+    QHash<Endpoint, Peer> peers;
+    quint64 idleTimeout;
+    quint64 revision;
+};
+
+#endif // UDPPEERTABLE_H
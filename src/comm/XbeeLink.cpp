@@ -24,6 +24,8 @@ XbeeLink::XbeeLink(QString portName, int baudRate) :
 
 XbeeLink::~XbeeLink()
 {
+	// The transmit scheduler and the decoder thread stop using the link
+	announceDestruction();
 	if(m_portName)
 	{
 		delete m_portName;
@@ -45,7 +45,9 @@ Freenect::Freenect()
     , pointCloud3D(new QVector<QVector3D>)
     , pointCloud6D(new QVector<Vector6D>)
 {
-
+    // keep the memory of a full frame, clear() would release it
+    pointCloud3D->reserve(FREENECT_FRAME_PIX);
+    pointCloud6D->reserve(FREENECT_FRAME_PIX);
 }
 
 Freenect::~Freenect()
@@ -73,6 +75,14 @@ Freenect::init(int userDeviceNumber)
         gammaTable[i] = static_cast<unsigned short>(v * 6.0f * 256.0f);
     }
 
+    // populate range lookup table, so there is no division per pixel
+    rangeTable[0] = 0.0f;
+    for (int i = 1; i <= 2048; ++i) {
+        double range = baseline * depthCameraParameters.fx
+                       / (1.0 / 8.0 * (disparityOffset - static_cast<double>(i)));
+        rangeTable[i] = (range > 0.0) ? static_cast<float>(range) : 0.0f;
+    }
+
     // populate depth projection matrix
     for (int i = 0; i < FREENECT_FRAME_H; ++i) {
         for (int j = 0; j < FREENECT_FRAME_W; ++j) {
@@ -89,6 +99,7 @@ Freenect::init(int userDeviceNumber)
             rgbRectificationMap[i * FREENECT_FRAME_W + j] = rectifiedPoint;
         }
     }
+    depthProjector.setRays(depthProjectionMatrix, FREENECT_FRAME_PIX);
 
     if (freenect_init(&context, NULL) < 0) {
         return false;
@@ -188,21 +199,18 @@ Freenect::get3DPointCloudData(void)
 {
     QMutexLocker locker(&depthMutex);
 
-    pointCloud3D->clear();
     unsigned short* data = reinterpret_cast<unsigned short*>(depth);
     for (int i = 0; i < FREENECT_FRAME_PIX; ++i) {
-        if (data[i] > 0 && data[i] <= 2048) {
-            double range = baseline * depthCameraParameters.fx
-                           / (1.0 / 8.0 * (disparityOffset
-                                           - static_cast<double>(data[i])));
+        depthRange[i] = (data[i] <= 2048) ? rangeTable[data[i]] : 0.0f;
+    }
 
-            if (range > 0.0f) {
-                QVector3D ray = depthProjectionMatrix[i];
-                ray *= range;
+    int count;
+    const float* points = depthProjector.project(depthRange, count).constData();
 
-                pointCloud3D->push_back(QVector3D(ray.x(), ray.y(), ray.z()));
-            }
-        }
+    pointCloud3D->resize(count);
+    QVector3D* out = pointCloud3D->data();
+    for (int i = 0; i < count; ++i) {
+        out[i] = QVector3D(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
     }
 
     return pointCloud3D;
@@ -213,7 +221,7 @@ Freenect::get6DPointCloudData(void)
 {
     get3DPointCloudData();
 
-    pointCloud6D->clear();
+    pointCloud6D->resize(0);
     for (int i = 0; i < pointCloud3D->size(); ++i) {
         Vector6D point;
 
@@ -42,6 +42,8 @@ This file is part of the QGROUNDCONTROL project
 #include <QVector2D>
 #include <QVector3D>
 
+#include "RGBDKernels.h"
+
 class Freenect
 {
 public:
@@ -140,6 +142,11 @@ private:
     // gamma map
     unsigned short gammaTable[2048];
 
+    // range of each 11 bit disparity, 0 where there is none
+    float rangeTable[2049];
+    float depthRange[FREENECT_FRAME_PIX];
+    RGBD::DepthProjector depthProjector;
+
     QVector3D depthProjectionMatrix[FREENECT_FRAME_PIX];
     QVector2D rgbRectificationMap[FREENECT_FRAME_PIX];
 
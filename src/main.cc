@@ -32,6 +32,9 @@ This file is part of the QGROUNDCONTROL project
 #include "MainWindow.h"
 #include "configuration.h"
 #include "QsLog.h"
+#ifdef QGC_OSG_ENABLED
+#include "OffscreenRenderBenchmark.h"
+#endif
 #include <QtGui/QApplication>
 
 /* SDL does ugly things to main() */
@@ -100,5 +103,24 @@ int main(int argc, char *argv[])
     // This is required to start the logger
     core.initialize();
 
+#ifdef QGC_OSG_ENABLED
+    // Offscreen 3D render benchmark: --benchmark-3d <logfile> [width height]
+    // Runs once the links, the UAS manager and the main window exist, the
+    // log is replayed through them.
+    const QStringList args = core.arguments();
+    int benchmarkIndex = args.indexOf("--benchmark-3d");
+    if (benchmarkIndex >= 0 && benchmarkIndex + 1 < args.size())
+    {
+        int width = 1024;
+        int height = 768;
+        if (benchmarkIndex + 3 < args.size())
+        {
+            width = args.at(benchmarkIndex + 2).toInt();
+            height = args.at(benchmarkIndex + 3).toInt();
+        }
+        return OffscreenRenderBenchmark::exec(args.at(benchmarkIndex + 1), width, height);
+    }
+#endif
+
     return core.exec();
 }
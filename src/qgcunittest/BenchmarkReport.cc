@@ -0,0 +1,160 @@
+#include "BenchmarkReport.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QtTest/QtTest>
+#include <stdio.h>
+
+#include "AutoTest.h"
+#include "configuration.h"
+
+BenchmarkReport::BenchmarkReport() :
+    failures(0)
+{
+}
+
+bool BenchmarkReport::readLog(const QString& test, QIODevice* log)
+{
+    QXmlStreamReader xml(log);
+    QString function;
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+
+        if (xml.name() == QLatin1String("TestFunction"))
+        {
+            function = xml.attributes().value("name").toString();
+        }
+        else if (xml.name() == QLatin1String("BenchmarkResult"))
+        {
+            QXmlStreamAttributes attributes = xml.attributes();
+            Result result;
+            result.test = test;
+            result.function = function;
+            result.tag = attributes.value("tag").toString();
+            result.metric = attributes.value("metric").toString();
+            result.value = attributes.value("value").toString().toDouble();
+            result.iterations = attributes.value("iterations").toString().toInt();
+            results.append(result);
+        }
+    }
+    return !xml.hasError();
+}
+
+QString BenchmarkReport::quote(const QString& text)
+{
+    QString quoted("\"");
+    foreach (QChar c, text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (c.unicode() < 0x20)
+        {
+            quoted += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    return quoted + '"';
+}
+
+bool BenchmarkReport::write(QIODevice* out) const
+{
+    QTextStream json(out);
+    json << "{\n";
+    json << "  \"application\": " << quote(QGC_APPLICATION_NAME) << ",\n";
+    json << "  \"version\": " << quote(QGC_APPLICATION_VERSION) << ",\n";
+    json << "  \"qt\": " << quote(qVersion()) << ",\n";
+    json << "  \"date\": " << quote(QDateTime::currentDateTime().toUTC().toString(Qt::ISODate)) << ",\n";
+    json << "  \"failures\": " << failures << ",\n";
+    json << "  \"results\": [";
+    for (int i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results.at(i);
+        json << (i > 0 ? ",\n" : "\n");
+        json << "    { \"test\": " << quote(result.test)
+             << ", \"function\": " << quote(result.function)
+             << ", \"tag\": " << quote(result.tag)
+             << ", \"metric\": " << quote(result.metric)
+             << ", \"value\": " << QString::number(result.value, 'g', 12)
+             << ", \"iterations\": " << result.iterations
+             << ", \"perIteration\": " << QString::number(result.perIteration(), 'g', 12)
+             << " }";
+    }
+    json << "\n  ]\n}\n";
+    json.flush();
+    return json.status() == QTextStream::Ok;
+}
+
+int BenchmarkReport::run(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QStringList arguments = app.arguments();
+    QString jsonFile;
+    int json = arguments.indexOf("-json");
+    if (json > 0 && json + 1 < arguments.size())
+    {
+        jsonFile = arguments.at(json + 1);
+        arguments.removeAt(json + 1);
+        arguments.removeAt(json);
+    }
+
+    BenchmarkReport report;
+    foreach (QObject* test, AutoTest::testList())
+    {
+        // QTest writes its log into the file given by -o
+        QTemporaryFile log;
+        if (!log.open())
+        {
+            qWarning() << "Cannot create a log file for" << test->objectName();
+            report.addFailures(1);
+            continue;
+        }
+        QString logName = log.fileName();
+        log.close();
+
+        report.addFailures(QTest::qExec(test, QStringList(arguments) << "-xml" << "-o" << logName));
+
+        QFile xml(logName);
+        if (!xml.open(QIODevice::ReadOnly) || !report.readLog(test->objectName(), &xml))
+        {
+            qWarning() << "Cannot read the log of" << test->objectName();
+            report.addFailures(1);
+        }
+    }
+
+    foreach (const Result& result, report.getResults())
+    {
+        qDebug() << qPrintable(QString("%1::%2(%3): %4 %5 per iteration")
+                               .arg(result.test).arg(result.function).arg(result.tag)
+                               .arg(result.perIteration()).arg(result.metric));
+    }
+
+    QFile out;
+    bool opened;
+    if (jsonFile.isEmpty())
+    {
+        opened = out.open(stdout, QIODevice::WriteOnly);
+    }
+    else
+    {
+        out.setFileName(jsonFile);
+        opened = out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened || !report.write(&out))
+    {
+        qWarning() << "Cannot write the results to" << (jsonFile.isEmpty() ? QString("the standard output") : jsonFile);
+        return report.getFailures() + 1;
+    }
+    return report.getFailures();
+}
@@ -0,0 +1,56 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QIODevice>
+
+/**
+ * @brief Runs the benchmarks registered with DECLARE_TEST and collects their results
+ *
+ * Every test object runs with the XML logger of QTest. The BenchmarkResult
+ * entries of the logs are written as one JSON document, so the results of
+ * different releases can be compared by scripts:
+ *
+ *   qgcbenchmark -json results.json [QTest options, e.g. -median 5]
+ *
+ * Without -json the document goes to the standard output.
+ */
+class BenchmarkReport
+{
+public:
+    struct Result
+    {
+        QString test;       ///< Test object, e.g. ProtocolBenchmark
+        QString function;   ///< Test function
+        QString tag;        ///< Data tag, empty for functions without data
+        QString metric;     ///< QTest metric, e.g. WalltimeMilliseconds
+        double value;       ///< Total of all iterations
+        int iterations;
+        double perIteration() const { return iterations > 0 ? value / iterations : value; }
+    };
+
+    BenchmarkReport();
+
+    /** @brief Read the results from the XML log of one test object */
+    bool readLog(const QString& test, QIODevice* log);
+    /** @brief Write all results read so far as JSON */
+    bool write(QIODevice* out) const;
+
+    void addFailures(int count) { failures += count; }
+    int getFailures() const { return failures; }
+    const QList<Result>& getResults() const { return results; }
+
+    /** @brief Run all benchmarks, returns the number of failed test functions */
+    static int run(int argc, char* argv[]);
+
+protected:
+    /** @brief JSON string literal */
+    static QString quote(const QString& text);
+
+    QList<Result> results;
+    int failures;
+};
+
+#endif // BENCHMARKREPORT_H
@@ -0,0 +1,219 @@
+#include "CompassCalibratorTest.h"
+
+#include <QThread>
+#include <QSignalSpy>
+#include <qmath.h>
+
+namespace
+{
+const double center[3] = { 120.0, -80.0, 45.0 };
+const double strength = 400.0;
+// Symmetric soft iron distortion
+const double softIron[3][3] = { { 1.05, 0.03, -0.02 },
+                                { 0.03, 0.95, 0.04 },
+                                { -0.02, 0.04, 1.00 } };
+}
+
+CompassCalibratorTest::CompassCalibratorTest() :
+    seed(1),
+    calibrator(NULL)
+{
+}
+
+void CompassCalibratorTest::init()
+{
+    seed = 1;
+    calibrator = new CompassCalibrator();
+}
+
+void CompassCalibratorTest::cleanup()
+{
+    delete calibrator;
+    calibrator = NULL;
+}
+
+double CompassCalibratorTest::random()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / double(1 << 23) - 1.0;
+}
+
+void CompassCalibratorTest::sample(bool upperOnly, bool distorted, double field[3])
+{
+    // Uniform direction by rejection from the unit cube
+    double d[3];
+    double norm;
+    do
+    {
+        d[0] = random();
+        d[1] = random();
+        d[2] = random();
+        norm = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    } while (norm > 1.0 || norm < 0.1 || (upperOnly && d[2] < 0.0));
+
+    for (int i = 0; i < 3; i++)
+    {
+        double v = 0.0;
+        for (int j = 0; j < 3; j++)
+        {
+            v += (distorted ? softIron[i][j] : (i == j ? 1.0 : 0.0)) * d[j] / norm;
+        }
+        field[i] = v * strength + center[i] + random();
+    }
+}
+
+void CompassCalibratorTest::addSamples(int count, bool upperOnly, bool distorted)
+{
+    double field[3];
+    for (int i = 0; i < count; i++)
+    {
+        sample(upperOnly, distorted, field);
+        calibrator->addSample(field[0], field[1], field[2]);
+    }
+}
+
+void CompassCalibratorTest::sphere_test()
+{
+    addSamples(2000, false, false);
+    calibrator->update();
+    CompassCalibrator::Result result = calibrator->getResult();
+
+    QVERIFY(result.valid);
+    QCOMPARE(result.samples, 2000);
+    for (int i = 0; i < 3; i++)
+    {
+        QVERIFY(qAbs(result.offsets[i] + center[i]) < 1.0);
+        for (int j = 0; j < 3; j++)
+        {
+            QVERIFY(qAbs(result.softIron[i][j] - (i == j ? 1.0 : 0.0)) < 0.01);
+        }
+    }
+    QVERIFY(qAbs(result.radius - strength) < 2.0);
+    QVERIFY(result.residual < 0.01);
+    QVERIFY(result.coverage > 0.95);
+}
+
+void CompassCalibratorTest::ellipsoid_test()
+{
+    addSamples(2000, false, true);
+    calibrator->update();
+    CompassCalibrator::Result result = calibrator->getResult();
+
+    QVERIFY(result.valid);
+    for (int i = 0; i < 3; i++)
+    {
+        QVERIFY(qAbs(result.offsets[i] + center[i]) < 1.0);
+    }
+    QVERIFY(result.residual < 0.01);
+    QVERIFY(result.coverage > 0.95);
+
+    // The correction undoes the distortion up to the scale
+    double product[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            product[i][j] = 0.0;
+            for (int k = 0; k < 3; k++) product[i][j] += result.softIron[i][k] * softIron[k][j];
+        }
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (i == j) QVERIFY(qAbs(product[i][j] / product[0][0] - 1.0) < 0.01);
+            else QVERIFY(qAbs(product[i][j] / product[0][0]) < 0.01);
+        }
+    }
+
+    // Corrected samples lie on a sphere of the fitted radius
+    double raw[3];
+    double corrected[3];
+    for (int i = 0; i < 100; i++)
+    {
+        sample(false, true, raw);
+        CompassCalibrator::correct(result, raw, corrected);
+        double norm = sqrt(corrected[0] * corrected[0] + corrected[1] * corrected[1] + corrected[2] * corrected[2]);
+        QVERIFY(qAbs(norm / result.radius - 1.0) < 0.01);
+    }
+}
+
+void CompassCalibratorTest::hemisphere_test()
+{
+    addSamples(2000, true, true);
+    calibrator->update();
+    CompassCalibrator::Result result = calibrator->getResult();
+
+    QVERIFY(result.valid);
+    QVERIFY(result.coverage > 0.4);
+    QVERIFY(result.coverage < 0.7);
+    // Half the sphere still pins down the center
+    for (int i = 0; i < 3; i++)
+    {
+        QVERIFY(qAbs(result.offsets[i] + center[i]) < 2.0);
+    }
+}
+
+void CompassCalibratorTest::tooFewSamples_test()
+{
+    addSamples(CompassCalibrator::MIN_SAMPLES - 1, false, true);
+    calibrator->update();
+    CompassCalibrator::Result result = calibrator->getResult();
+    QVERIFY(!result.valid);
+    QCOMPARE(result.samples, (int)CompassCalibrator::MIN_SAMPLES - 1);
+
+    // All samples in one plane do not describe an ellipsoid
+    calibrator->reset();
+    for (int i = 0; i < 500; i++)
+    {
+        calibrator->addSample(strength * cos(i * 0.1) + center[0], strength * sin(i * 0.1) + center[1], center[2]);
+    }
+    calibrator->update();
+    QVERIFY(!calibrator->getResult().valid);
+}
+
+void CompassCalibratorTest::reset_test()
+{
+    addSamples(500, false, true);
+    calibrator->update();
+    QVERIFY(calibrator->getResult().valid);
+
+    calibrator->reset();
+    CompassCalibrator::Result result = calibrator->getResult();
+    QVERIFY(!result.valid);
+    QCOMPARE(result.samples, 0);
+    QCOMPARE(result.coverage, 0.0);
+
+    addSamples(2000, false, false);
+    calibrator->update();
+    result = calibrator->getResult();
+    QVERIFY(result.valid);
+    QCOMPARE(result.samples, 2000);
+    QVERIFY(qAbs(result.radius - strength) < 2.0);
+}
+
+void CompassCalibratorTest::thread_test()
+{
+    QThread thread;
+    calibrator->moveToThread(&thread);
+    thread.start();
+
+    QSignalSpy spy(calibrator, SIGNAL(resultChanged(CompassCalibrator::Result)));
+    double field[3];
+    for (int i = 0; i < 1000; i++)
+    {
+        sample(false, true, field);
+        QMetaObject::invokeMethod(calibrator, "addSample", Qt::QueuedConnection,
+                                  Q_ARG(double, field[0]), Q_ARG(double, field[1]), Q_ARG(double, field[2]));
+    }
+    QMetaObject::invokeMethod(calibrator, "update", Qt::BlockingQueuedConnection);
+
+    CompassCalibrator::Result result = calibrator->getResult();
+    QVERIFY(result.valid);
+    QCOMPARE(result.samples, 1000);
+    // One result every SOLVE_INTERVAL samples and the final one
+    QCOMPARE(spy.count(), 1000 / CompassCalibrator::SOLVE_INTERVAL + 1);
+
+    thread.quit();
+    thread.wait();
+}
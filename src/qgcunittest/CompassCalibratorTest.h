@@ -0,0 +1,45 @@
+#ifndef COMPASSCALIBRATORTEST_H
+#define COMPASSCALIBRATORTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "CompassCalibrator.h"
+#include "AutoTest.h"
+
+class CompassCalibratorTest : public QObject
+{
+    Q_OBJECT
+public:
+    CompassCalibratorTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void sphere_test();
+    void ellipsoid_test();
+    void hemisphere_test();
+    void tooFewSamples_test();
+    void reset_test();
+    void thread_test();
+
+private:
+    /**
+     * @brief One sample of a field of 400 seen through the soft iron
+     *        matrix and shifted by the hard iron center, with +-1 noise
+     * @param upperOnly Only directions with a positive z component
+     * @param distorted Apply the soft iron matrix, otherwise a sphere
+     */
+    void sample(bool upperOnly, bool distorted, double field[3]);
+    void addSamples(int count, bool upperOnly, bool distorted);
+    /** @brief Deterministic uniform number in -1..1 */
+    double random();
+
+    quint32 seed;
+    CompassCalibrator* calibrator;
+};
+
+DECLARE_TEST(CompassCalibratorTest)
+
+#endif // COMPASSCALIBRATORTEST_H
@@ -0,0 +1,102 @@
+#include "DataFlashLogBenchmark.h"
+
+#include <QDir>
+#include <QtEndian>
+
+#include "DataFlashLog.h"
+
+namespace
+{
+template <typename T> void appendLE(QByteArray& bytes, T value)
+{
+    uchar buffer[sizeof(T)];
+    qToLittleEndian<T>(value, buffer);
+    bytes.append(reinterpret_cast<const char*>(buffer), sizeof(T));
+}
+
+void appendString(QByteArray& bytes, const char* text, int length)
+{
+    QByteArray field(text);
+    field.resize(length);
+    for (int i = qstrlen(text); i < length; i++) field[i] = 0;
+    bytes.append(field);
+}
+
+void appendHeader(QByteArray& bytes, int type)
+{
+    bytes.append(char(DataFlashLog::HEAD_BYTE1));
+    bytes.append(char(DataFlashLog::HEAD_BYTE2));
+    bytes.append(char(type));
+}
+
+/** @brief ATT message: TimeMS (I), Roll (c), Pitch (c), Yaw (C) */
+enum { ATT_TYPE = 1, ATT_LENGTH = 13 };
+}
+
+DataFlashLogBenchmark::DataFlashLogBenchmark() :
+    file(QDir::tempPath() + "/qgc_dataflash_bench_XXXXXX.bin"),
+    attCount(0)
+{
+}
+
+void DataFlashLogBenchmark::initTestCase()
+{
+    int megabytes = qgetenv("QGC_DATAFLASH_BENCH_MB").toInt();
+    if (megabytes <= 0) megabytes = 4;
+
+    QByteArray formats;
+    appendHeader(formats, DataFlashLog::FMT_TYPE);
+    formats.append(char(DataFlashLog::FMT_TYPE));
+    formats.append(char(DataFlashLog::FMT_LENGTH));
+    appendString(formats, "FMT", 4);
+    appendString(formats, "BBnNZ", 16);
+    appendString(formats, "Type,Length,Name,Format,Columns", 64);
+    appendHeader(formats, DataFlashLog::FMT_TYPE);
+    formats.append(char(ATT_TYPE));
+    formats.append(char(ATT_LENGTH));
+    appendString(formats, "ATT", 4);
+    appendString(formats, "IccC", 16);
+    appendString(formats, "TimeMS,Roll,Pitch,Yaw", 64);
+
+    QVERIFY(file.open());
+    file.write(formats);
+
+    // Attitude at 100 Hz, written in 1 MB blocks
+    QByteArray block;
+    int count = 0;
+    for (int i = 0; block.size() < (1 << 20); i++)
+    {
+        appendHeader(block, ATT_TYPE);
+        appendLE<quint32>(block, i * 10);
+        appendLE<qint16>(block, i % 18000);
+        appendLE<qint16>(block, -(i % 9000));
+        appendLE<quint16>(block, i % 36000);
+        count++;
+    }
+    for (int i = 0; i < megabytes; i++)
+    {
+        file.write(block);
+    }
+    file.close();
+    attCount = count * megabytes;
+}
+
+void DataFlashLogBenchmark::index_benchmark()
+{
+    QBENCHMARK {
+        DataFlashLog reader;
+        QVERIFY(reader.open(file.fileName()));
+        QCOMPARE(reader.getMessageCount("ATT"), attCount);
+    }
+}
+
+void DataFlashLogBenchmark::column_benchmark()
+{
+    DataFlashLog reader;
+    QVERIFY(reader.open(file.fileName()));
+
+    // Only the first request decodes, the later ones are served from the cache
+    QBENCHMARK_ONCE {
+        QCOMPARE(reader.getColumn("ATT", "Roll").size(), attCount);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef DATAFLASHLOGBENCHMARK_H
+#define DATAFLASHLOGBENCHMARK_H
+
+#include <QObject>
+#include <QTemporaryFile>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/**
+ * @brief Indexing a large DataFlash log and decoding one column of it.
+ *        The log is 4 MB, QGC_DATAFLASH_BENCH_MB=1024 for the 1 GB measurement.
+ */
+class DataFlashLogBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    DataFlashLogBenchmark();
+
+private slots:
+    void initTestCase();
+
+    void index_benchmark();
+    void column_benchmark();
+
+private:
+    QTemporaryFile file;
+    int attCount;
+};
+
+DECLARE_TEST(DataFlashLogBenchmark)
+#endif // DATAFLASHLOGBENCHMARK_H
@@ -0,0 +1,277 @@
+#include "DataFlashLogTest.h"
+
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+template <typename T> void appendLE(QByteArray& bytes, T value)
+{
+    uchar buffer[sizeof(T)];
+    qToLittleEndian<T>(value, buffer);
+    bytes.append(reinterpret_cast<const char*>(buffer), sizeof(T));
+}
+
+void appendString(QByteArray& bytes, const char* text, int length)
+{
+    QByteArray field(text);
+    field.resize(length);
+    for (int i = qstrlen(text); i < length; i++) field[i] = 0;
+    bytes.append(field);
+}
+
+QByteArray messageHeader(int type)
+{
+    QByteArray bytes;
+    bytes.append(char(DataFlashLog::HEAD_BYTE1));
+    bytes.append(char(DataFlashLog::HEAD_BYTE2));
+    bytes.append(char(type));
+    return bytes;
+}
+
+enum { ATT_TYPE = 1, GPS_TYPE = 2, ATT_LENGTH = 13, GPS_LENGTH = 23 };
+}
+
+DataFlashLogTest::DataFlashLogTest()
+{
+}
+
+void DataFlashLogTest::cleanup()
+{
+    qDeleteAll(files);
+    files.clear();
+}
+
+QByteArray DataFlashLogTest::fmt(int type, int length, const char* name, const char* format, const char* labels)
+{
+    QByteArray bytes = messageHeader(DataFlashLog::FMT_TYPE);
+    bytes.append(char(type));
+    bytes.append(char(length));
+    appendString(bytes, name, 4);
+    appendString(bytes, format, 16);
+    appendString(bytes, labels, 64);
+    return bytes;
+}
+
+QByteArray DataFlashLogTest::att(quint32 timeMs, qint16 roll, qint16 pitch, quint16 yaw)
+{
+    QByteArray bytes = messageHeader(ATT_TYPE);
+    appendLE<quint32>(bytes, timeMs);
+    appendLE<qint16>(bytes, roll);
+    appendLE<qint16>(bytes, pitch);
+    appendLE<quint16>(bytes, yaw);
+    return bytes;
+}
+
+QByteArray DataFlashLogTest::gps(quint32 timeMs, qint32 lat, qint32 lng, qint32 alt, float speed)
+{
+    QByteArray bytes = messageHeader(GPS_TYPE);
+    appendLE<quint32>(bytes, timeMs);
+    appendLE<qint32>(bytes, lat);
+    appendLE<qint32>(bytes, lng);
+    appendLE<qint32>(bytes, alt);
+    quint32 bits;
+    memcpy(&bits, &speed, sizeof(bits));
+    appendLE<quint32>(bytes, bits);
+    return bytes;
+}
+
+QByteArray DataFlashLogTest::header()
+{
+    QByteArray log;
+    log.append(fmt(DataFlashLog::FMT_TYPE, DataFlashLog::FMT_LENGTH, "FMT", "BBnNZ", "Type,Length,Name,Format,Columns"));
+    log.append(fmt(ATT_TYPE, ATT_LENGTH, "ATT", "IccC", "TimeMS,Roll,Pitch,Yaw"));
+    log.append(fmt(GPS_TYPE, GPS_LENGTH, "GPS", "ILLef", "TimeMS,Lat,Lng,Alt,Spd"));
+    return log;
+}
+
+QString DataFlashLogTest::writeLog(const QByteArray& log)
+{
+    QTemporaryFile* file = new QTemporaryFile(QDir::tempPath() + "/qgc_dataflash_XXXXXX.bin");
+    files.append(file);
+    if (!file->open()) return QString();
+    file->write(log);
+    file->close();
+    return file->fileName();
+}
+
+void DataFlashLogTest::index_test()
+{
+    QByteArray log = header();
+    log.append(att(100, 1050, -200, 35999));
+    // Garbage between messages, including a stray header byte, is skipped
+    log.append("\x01\x02\xA3\x03", 4);
+    log.append(gps(110, 473977420, 85455940, 48812, 12.5f));
+    log.append(att(120, 1060, -210, 100));
+    // Truncated message at the end
+    log.append(att(130, 0, 0, 0).left(5));
+
+    DataFlashLog reader;
+    QVERIFY(reader.open(writeLog(log)));
+    QCOMPARE(reader.getSize(), (qint64)log.size());
+    QCOMPARE(reader.getMessageNames(), QStringList() << "ATT" << "FMT" << "GPS");
+    QCOMPARE(reader.getMessageCount("ATT"), 2);
+    QCOMPARE(reader.getMessageCount("GPS"), 1);
+    QCOMPARE(reader.getMessageCount("FMT"), 3);
+    QCOMPARE(reader.getMessageCount("XYZ"), 0);
+    QCOMPARE(reader.getSkippedBytes(), (qint64)(4 + 5));
+    QCOMPARE(reader.getFieldNames("ATT"), QStringList() << "TimeMS" << "Roll" << "Pitch" << "Yaw");
+    // Text fields are not offered for plotting
+    QCOMPARE(reader.getFieldNames("FMT"), QStringList() << "Type" << "Length");
+
+    QVERIFY(!reader.open(QDir::tempPath() + "/qgc_dataflash_does_not_exist.bin"));
+    QVERIFY(!reader.isOpen());
+    QVERIFY(!reader.getErrorString().isEmpty());
+}
+
+void DataFlashLogTest::columns_test()
+{
+    QByteArray log = header();
+    log.append(att(100, 1050, -200, 35999));
+    log.append(gps(110, 473977420, 85455940, 48812, 12.5f));
+    log.append(att(120, 1060, -210, 100));
+
+    DataFlashLog reader;
+    QVERIFY(reader.open(writeLog(log)));
+
+    QVector<double> roll = reader.getColumn("ATT", "Roll");
+    QCOMPARE(roll.size(), 2);
+    QCOMPARE(roll.at(0), 10.5);
+    QCOMPARE(roll.at(1), 10.6);
+    QCOMPARE(reader.getColumn("ATT", "Pitch").at(0), -2.0);
+    QCOMPARE(reader.getColumn("ATT", "Yaw").at(0), 359.99);
+
+    QCOMPARE(reader.getColumn("GPS", "Lat").at(0), 47.397742);
+    QCOMPARE(reader.getColumn("GPS", "Lng").at(0), 8.545594);
+    QCOMPARE(reader.getColumn("GPS", "Alt").at(0), 488.12);
+    QCOMPARE(reader.getColumn("GPS", "Spd").at(0), 12.5);
+
+    QVector<double> time = reader.getTime("ATT");
+    QCOMPARE(time.size(), 2);
+    QCOMPARE(time.at(0), 0.1);
+    QCOMPARE(time.at(1), 0.12);
+
+    QVERIFY(reader.getColumn("ATT", "Nothing").isEmpty());
+    QVERIFY(reader.getColumn("XYZ", "Roll").isEmpty());
+    // Text columns decode as NaN
+    QVERIFY(isnan(reader.getColumn("FMT", "Name").at(0)));
+}
+
+void DataFlashLogTest::exportCsv_test()
+{
+    QByteArray log = header();
+    log.append(att(100, 1050, -200, 35999));
+    log.append(att(120, 1060, -210, 100));
+
+    DataFlashLog reader;
+    QVERIFY(reader.open(writeLog(log)));
+
+    QTemporaryFile csv;
+    QVERIFY(csv.open());
+    csv.close();
+    QVERIFY(reader.exportCsv(csv.fileName(), "ATT", QStringList() << "TimeMS" << "Roll", ","));
+    QVERIFY(csv.open());
+    QCOMPARE(QString(csv.readAll()), QString("TimeMS,Roll\n100,10.5\n120,10.6\n"));
+    csv.close();
+
+    QVERIFY(reader.exportCsv(csv.fileName(), "FMT", QStringList() << "Name" << "Columns"));
+    QVERIFY(csv.open());
+    QList<QByteArray> lines = csv.readAll().split('\n');
+    QCOMPARE(QString(lines.at(2)), QString("ATT\tTimeMS,Roll,Pitch,Yaw"));
+    csv.close();
+
+    QVERIFY(!reader.exportCsv(csv.fileName(), "ATT", QStringList() << "Nothing"));
+    QVERIFY(!reader.exportCsv(csv.fileName(), "XYZ"));
+}
+
+void DataFlashLogTest::redefinition_test()
+{
+    QByteArray log = header();
+    log.append(att(100, 1050, -200, 35999));
+    // A repeated format continues the layout in force
+    log.append(fmt(ATT_TYPE, ATT_LENGTH, "ATT", "IccC", "TimeMS,Roll,Pitch,Yaw"));
+    log.append(att(120, 1060, -210, 100));
+    // ATT changes to microseconds and drops Yaw
+    log.append(fmt(ATT_TYPE, 15, "ATT", "Qcc", "TimeUS,Roll,Pitch"));
+    QByteArray redefined = messageHeader(ATT_TYPE);
+    appendLE<quint64>(redefined, Q_UINT64_C(140000));
+    appendLE<qint16>(redefined, 1070);
+    appendLE<qint16>(redefined, -220);
+    log.append(redefined);
+    log.append(gps(150, 473977420, 85455940, 48812, 12.5f));
+
+    DataFlashLog reader;
+    QVERIFY(reader.open(writeLog(log)));
+    QCOMPARE(reader.getSkippedBytes(), (qint64)0);
+    QCOMPARE(reader.getMessageCount("ATT"), 3);
+    QCOMPARE(reader.getMessageCount("FMT"), 5);
+    QCOMPARE(reader.getFormat("ATT")->length, 15);
+    QCOMPARE(reader.getFieldNames("ATT"), QStringList() << "TimeMS" << "Roll" << "Pitch" << "Yaw" << "TimeUS");
+
+    // Every message is decoded with the layout it was written with
+    QVector<double> roll = reader.getColumn("ATT", "Roll");
+    QCOMPARE(roll.size(), 3);
+    QCOMPARE(roll.at(0), 10.5);
+    QCOMPARE(roll.at(1), 10.6);
+    QCOMPARE(roll.at(2), 10.7);
+    QVector<double> yaw = reader.getColumn("ATT", "Yaw");
+    QCOMPARE(yaw.at(0), 359.99);
+    QVERIFY(isnan(yaw.at(2)));
+    QVector<double> time = reader.getTime("ATT");
+    QCOMPARE(time.size(), 3);
+    QCOMPARE(time.at(1), 0.12);
+    QCOMPARE(time.at(2), 0.14);
+
+    QTemporaryFile csv;
+    QVERIFY(csv.open());
+    csv.close();
+    QVERIFY(reader.exportCsv(csv.fileName(), "ATT", QStringList() << "Roll" << "Yaw", ","));
+    QVERIFY(csv.open());
+    QCOMPARE(QString(csv.readAll()), QString("Roll,Yaw\n10.5,359.99\n10.6,1\n10.7,\n"));
+    csv.close();
+}
+
+void DataFlashLogTest::largeLog_test()
+{
+    const int megabytes = 4;
+
+    QTemporaryFile file(QDir::tempPath() + "/qgc_dataflash_large_XXXXXX.bin");
+    QVERIFY(file.open());
+    file.write(header());
+
+    // One GPS message per ten ATT messages, written in 1 MB blocks
+    QByteArray block;
+    quint32 time = 0;
+    int attCount = 0;
+    int gpsCount = 0;
+    for (int i = 0; block.size() < (1 << 20); i++)
+    {
+        block.append(att(time, i % 18000, -(i % 9000), i % 36000));
+        attCount++;
+        if (i % 10 == 0)
+        {
+            block.append(gps(time, 473977420 + i, 85455940 - i, 48812, i * 0.01f));
+            gpsCount++;
+        }
+        time += 10;
+    }
+    for (int i = 0; i < megabytes; i++)
+    {
+        file.write(block);
+    }
+    file.close();
+
+    DataFlashLog reader;
+    QVERIFY(reader.open(file.fileName()));
+    QCOMPARE(reader.getMessageCount("ATT"), attCount * megabytes);
+    QCOMPARE(reader.getMessageCount("GPS"), gpsCount * megabytes);
+    QCOMPARE(reader.getSkippedBytes(), (qint64)0);
+
+    QVector<double> roll = reader.getColumn("ATT", "Roll");
+    QCOMPARE(roll.size(), attCount * megabytes);
+    QCOMPARE(roll.at(1), 0.01);
+
+    // The second request is served from the cache, it shares the decoded column
+    QVERIFY(reader.getColumn("ATT", "Roll").constData() == roll.constData());
+}
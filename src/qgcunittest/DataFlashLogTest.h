@@ -0,0 +1,42 @@
+#ifndef DATAFLASHLOGTEST_H
+#define DATAFLASHLOGTEST_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QtTest/QtTest>
+
+#include "DataFlashLog.h"
+#include "AutoTest.h"
+
+class DataFlashLogTest : public QObject
+{
+    Q_OBJECT
+public:
+    DataFlashLogTest();
+
+private slots:
+    void cleanup();
+
+    void index_test();
+    void columns_test();
+    void exportCsv_test();
+    void redefinition_test();
+    void largeLog_test();
+
+private:
+    /** @brief FMT message defining a type */
+    static QByteArray fmt(int type, int length, const char* name, const char* format, const char* labels);
+    /** @brief ATT message: TimeMS (I), Roll (c), Pitch (c), Yaw (C) */
+    static QByteArray att(quint32 timeMs, qint16 roll, qint16 pitch, quint16 yaw);
+    /** @brief GPS message: TimeMS (I), Lat (L), Lng (L), Alt (e), Spd (f) */
+    static QByteArray gps(quint32 timeMs, qint32 lat, qint32 lng, qint32 alt, float speed);
+    /** @brief Formats of the synthetic logs */
+    static QByteArray header();
+    /** @brief Write a log to a temporary file and return its name */
+    QString writeLog(const QByteArray& log);
+
+    QList<QTemporaryFile*> files;
+};
+
+DECLARE_TEST(DataFlashLogTest)
+#endif // DATAFLASHLOGTEST_H
@@ -0,0 +1,178 @@
+#include "GAudioSpeechWorkerTest.h"
+
+#include <QSemaphore>
+
+namespace
+{
+/** Synthesizes silence and records what was played, instead of using the sound card */
+class TestSpeechWorker : public GAudioSpeechWorker
+{
+public:
+    TestSpeechWorker() : gatedSynthesis(false), gated(false) {}
+
+    QStringList getPlayed()
+    {
+        QMutexLocker locker(&playedMutex);
+        return played;
+    }
+
+    /** @brief Wait until count phrases were played */
+    bool waitForPlayed(int count)
+    {
+        for (int i = 0; i < 500 && getPlayed().size() < count; i++)
+        {
+            QTest::qWait(10);
+        }
+        return getPlayed().size() >= count;
+    }
+
+    bool gatedSynthesis;        ///< Block in synthesize() until the gate is released
+    bool gated;                 ///< Block in play() until the gate is released
+    QSemaphore gate;
+    QSemaphore synthesizing;
+    QSemaphore playing;
+
+protected:
+    bool synthesize(const QString& text, Waveform& wave)
+    {
+        synthesizing.release();
+        if (gatedSynthesis) gate.acquire();
+        wave.sampleRate = 8000;
+        wave.samples = QByteArray(text.size() * 1024, 0);
+        return true;
+    }
+
+    void play(const QString& text, const Waveform& wave)
+    {
+        Q_UNUSED(wave);
+        playing.release();
+        if (gated) gate.acquire();
+        QMutexLocker locker(&playedMutex);
+        played.append(text);
+    }
+
+    QMutex playedMutex;
+    QStringList played;
+};
+}
+
+GAudioSpeechWorkerTest::GAudioSpeechWorkerTest()
+{
+}
+
+void GAudioSpeechWorkerTest::priority_test()
+{
+    TestSpeechWorker worker;
+    worker.gated = true;
+    worker.start();
+
+    // Hold the worker in the first phrase while the others are queued
+    worker.enqueue("first");
+    QVERIFY(worker.playing.tryAcquire(1, 5000));
+    worker.enqueue("normal one");
+    worker.enqueue("normal two");
+    worker.enqueue("alert", GAudioSpeechWorker::PRIORITY_ALERT);
+    worker.enqueue("emergency", GAudioSpeechWorker::PRIORITY_EMERGENCY);
+    // Already waiting, raised to alert instead of queued twice
+    worker.enqueue("normal two", GAudioSpeechWorker::PRIORITY_ALERT);
+    QCOMPARE(worker.getQueueLength(), 4);
+
+    worker.gate.release(5);
+    QVERIFY(worker.waitForPlayed(5));
+    QCOMPARE(worker.getPlayed(), QStringList() << "first" << "emergency" << "alert" << "normal two" << "normal one");
+}
+
+void GAudioSpeechWorkerTest::cache_test()
+{
+    TestSpeechWorker worker;
+    worker.setCacheSize(32);
+    worker.start();
+
+    worker.enqueue("battery low");
+    QVERIFY(worker.waitForPlayed(1));
+    worker.enqueue("battery low");
+    QVERIFY(worker.waitForPlayed(2));
+
+    GAudioSpeechWorker::Statistics stats = worker.getStatistics();
+    QCOMPARE(stats.spoken, (quint64)2);
+    QCOMPARE(stats.synthesized, (quint64)1);
+    QCOMPARE(stats.cacheHits, (quint64)1);
+    QVERIFY(worker.isCached("battery low"));
+
+    // 11 + 14 + 18 kB are more than the cache holds, the least
+    // recently used phrase is dropped
+    worker.enqueue("mode stabilize");
+    worker.enqueue("mode altitude hold");
+    QVERIFY(worker.waitForPlayed(4));
+    worker.enqueue("mode stabilize");
+    QVERIFY(worker.waitForPlayed(5));
+    QVERIFY(!worker.isCached("battery low"));
+    QCOMPARE(worker.getStatistics().cacheHits, (quint64)2);
+}
+
+void GAudioSpeechWorkerTest::prewarm_test()
+{
+    TestSpeechWorker worker;
+    worker.start();
+
+    worker.prewarm(QStringList() << "armed" << "disarmed" << "manual mode");
+    for (int i = 0; i < 500 && !worker.isCached("manual mode"); i++)
+    {
+        QTest::qWait(10);
+    }
+    QVERIFY(worker.isCached("armed"));
+    QVERIFY(worker.isCached("disarmed"));
+    QVERIFY(worker.isCached("manual mode"));
+    // Warming the cache does not speak
+    QVERIFY(worker.getPlayed().isEmpty());
+    QCOMPARE(worker.getStatistics().synthesized, (quint64)3);
+
+    worker.enqueue("armed");
+    QVERIFY(worker.waitForPlayed(1));
+    QCOMPARE(worker.getStatistics().synthesized, (quint64)3);
+    QCOMPARE(worker.getStatistics().cacheHits, (quint64)1);
+}
+
+void GAudioSpeechWorkerTest::queueLimit_test()
+{
+    TestSpeechWorker worker;
+    worker.gated = true;
+    worker.start();
+
+    worker.enqueue("first");
+    QVERIFY(worker.playing.tryAcquire(1, 5000));
+    worker.enqueue("alert", GAudioSpeechWorker::PRIORITY_ALERT);
+    for (int i = 0; i < GAudioSpeechWorker::MAX_QUEUE_LENGTH + 4; i++)
+    {
+        worker.enqueue(QString("message %1").arg(i));
+    }
+    QCOMPARE(worker.getQueueLength(), (int)GAudioSpeechWorker::MAX_QUEUE_LENGTH);
+    QCOMPARE(worker.getStatistics().dropped, (quint64)5);
+
+    worker.clear();
+    QCOMPARE(worker.getQueueLength(), 0);
+    worker.gate.release();
+}
+
+void GAudioSpeechWorkerTest::nonBlocking_test()
+{
+    TestSpeechWorker worker;
+    worker.gatedSynthesis = true;
+    worker.start();
+
+    // Hold the worker in the synthesis of the first phrase
+    worker.enqueue("first");
+    QVERIFY(worker.synthesizing.tryAcquire(1, 5000));
+
+    // The caller (the GUI thread) only queues, it returns while the synthesis is still running
+    for (int i = 0; i < 5; i++)
+    {
+        worker.enqueue(QString("waypoint %1 reached").arg(i));
+    }
+    QCOMPARE(worker.getQueueLength(), 5);
+    QVERIFY(worker.getPlayed().isEmpty());
+
+    worker.gate.release(6);
+    QVERIFY(worker.waitForPlayed(6));
+    QCOMPARE(worker.getPlayed().first(), QString("first"));
+}
@@ -0,0 +1,25 @@
+#ifndef GAUDIOSPEECHWORKERTEST_H
+#define GAUDIOSPEECHWORKERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "GAudioSpeechWorker.h"
+#include "AutoTest.h"
+
+class GAudioSpeechWorkerTest : public QObject
+{
+    Q_OBJECT
+public:
+    GAudioSpeechWorkerTest();
+
+private slots:
+    void priority_test();
+    void cache_test();
+    void prewarm_test();
+    void queueLimit_test();
+    void nonBlocking_test();
+};
+
+DECLARE_TEST(GAudioSpeechWorkerTest)
+#endif // GAUDIOSPEECHWORKERTEST_H
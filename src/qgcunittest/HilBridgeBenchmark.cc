@@ -0,0 +1,62 @@
+#include "HilBridgeBenchmark.h"
+
+#include "HilStandIn.h"
+#include "QGCFlightGearLink.h"
+
+namespace
+{
+const quint16 STANDIN_PORT = 49556;
+/** @brief Simulator frames parsed per iteration, one second of FlightGear at 50 Hz */
+const int FRAMES = 50;
+}
+
+HilBridgeBenchmark::HilBridgeBenchmark()
+{
+}
+
+void HilBridgeBenchmark::parse_benchmark()
+{
+    QList<QByteArray> lines;
+    for (int i = 0; i < FRAMES; i++)
+    {
+        lines.append(HilStandInSimulator::createLine(i / 50.0));
+    }
+
+    QGCHilState state;
+    int parsed = 0;
+    QBENCHMARK {
+        parsed = 0;
+        foreach (const QByteArray& line, lines)
+        {
+            if (QGCFlightGearLink::parseGenericLine(line.constData(), line.size(), state)) parsed++;
+        }
+    }
+    QCOMPARE(parsed, FRAMES);
+}
+
+void HilBridgeBenchmark::jitter_benchmark_data()
+{
+    QTest::addColumn<int>("rate");
+    QTest::newRow("50 Hz") << 50;
+    QTest::newRow("200 Hz") << 200;
+    QTest::newRow("400 Hz") << 400;
+}
+
+void HilBridgeBenchmark::jitter_benchmark()
+{
+    QFETCH(int, rate);
+    RecordingHilBridge bridge;
+    bridge.setRate(rate);
+    QVERIFY(bridge.open(QHostAddress::LocalHost, STANDIN_PORT));
+
+    HilStandInSimulator simulator(STANDIN_PORT, 50);
+    simulator.start();
+    QTest::qWait(2000);
+    simulator.stop();
+    bridge.close();
+
+    QGCHilBridge::Statistics stats = bridge.getStatistics();
+    QVERIFY(stats.jitter.count > 0);
+    // The mean time from the deadline of a tick until its messages were written
+    QTest::setBenchmarkResult(stats.jitter.meanUs() / 1000.0, QTest::WalltimeMilliseconds);
+}
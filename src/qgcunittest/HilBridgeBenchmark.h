@@ -0,0 +1,26 @@
+#ifndef HILBRIDGEBENCHMARK_H
+#define HILBRIDGEBENCHMARK_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/**
+ * @brief Parsing the simulator datagrams, and the jitter of the HIL bridge
+ *        ticks against the stand-in simulator at 50 Hz
+ */
+class HilBridgeBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    HilBridgeBenchmark();
+
+private slots:
+    void parse_benchmark();
+    void jitter_benchmark_data();
+    void jitter_benchmark();
+};
+
+DECLARE_TEST(HilBridgeBenchmark)
+#endif // HILBRIDGEBENCHMARK_H
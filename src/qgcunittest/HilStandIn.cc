@@ -0,0 +1,63 @@
+#include "HilStandIn.h"
+#include "QGCFlightGearLink.h"
+
+#include <QTime>
+#include <qmath.h>
+
+QByteArray HilStandInSimulator::createLine(double time)
+{
+    // 100 m circle in 20 s around Zurich airport
+    double angle = 2.0 * M_PI * time / 20.0;
+    double yaw = angle + M_PI / 2.0;
+    while (yaw > 2.0 * M_PI) yaw -= 2.0 * M_PI;
+    QString line = QString("%1\t%2\t%3\t%4\t%5\t%6\t%7\t%8\t%9\t%10\t%11\t%12\t%13\t%14\t%15\t%16\t%17\n")
+            .arg(time, 0, 'f', 4)
+            .arg(47.458 + 0.0009 * cos(angle), 0, 'f', 12)
+            .arg(8.548 + 0.0013 * sin(angle), 0, 'f', 12)
+            .arg(500.0, 0, 'f', 5)
+            .arg(0.3, 0, 'f', 5)
+            .arg(0.0, 0, 'f', 5)
+            .arg(yaw, 0, 'f', 5)
+            .arg(0.0, 0, 'f', 6)
+            .arg(0.0, 0, 'f', 6)
+            .arg(2.0 * M_PI / 20.0, 0, 'f', 6)
+            .arg(0.0, 0, 'f', 5)
+            .arg(0.0, 0, 'f', 5)
+            .arg(-9.81, 0, 'f', 5)
+            .arg(-31.4 * sin(angle), 0, 'f', 8)
+            .arg(31.4 * cos(angle), 0, 'f', 8)
+            .arg(0.0, 0, 'f', 8)
+            .arg(31.4, 0, 'f', 8);
+    return line.toLatin1();
+}
+
+void HilStandInSimulator::run()
+{
+    QUdpSocket socket;
+    QTime time;
+    time.start();
+    int frame = 0;
+    while (!stopRequested)
+    {
+        QByteArray line = createLine(frame / (double)rate);
+        socket.writeDatagram(line, QHostAddress::LocalHost, port);
+        sent++;
+        frame++;
+        // Sleep to the next frame, like a simulator paced by its frame rate
+        int next = frame * 1000 / rate;
+        int now = time.elapsed();
+        if (next > now) msleep(next - now);
+    }
+}
+
+bool RecordingHilBridge::parse(const char* data, qint64 length, QGCHilState& state)
+{
+    return QGCFlightGearLink::parseGenericLine(data, length, state);
+}
+
+void RecordingHilBridge::publish(const QGCHilState& state, quint64 timeUs)
+{
+    Q_UNUSED(timeUs);
+    lastYaw = state.yaw;
+    published++;
+}
@@ -0,0 +1,44 @@
+#ifndef HILSTANDIN_H
+#define HILSTANDIN_H
+
+#include <QThread>
+#include <QUdpSocket>
+
+#include "QGCHilBridge.h"
+
+/**
+ * Local stand-in for FlightGear: sends lines of the qgroundcontrol generic
+ * protocol for a vehicle flying a circle, at a fixed rate, over UDP.
+ */
+class HilStandInSimulator : public QThread
+{
+public:
+    HilStandInSimulator(quint16 port, int rate) : port(port), rate(rate), stopRequested(false), sent(0) {}
+    void stop() { stopRequested = true; wait(); }
+    int getSent() const { return sent; }
+    /** @brief The generic protocol line for a simulation time */
+    static QByteArray createLine(double time);
+
+protected:
+    void run();
+
+    quint16 port;
+    int rate;
+    volatile bool stopRequested;
+    volatile int sent;
+};
+
+/** @brief Parses the stand-in simulator lines and records instead of sending */
+class RecordingHilBridge : public QGCHilBridge
+{
+public:
+    RecordingHilBridge() : QGCHilBridge(NULL, NULL), published(0), lastYaw(0) {}
+    volatile int published;
+    volatile float lastYaw;
+
+protected:
+    bool parse(const char* data, qint64 length, QGCHilState& state);
+    void publish(const QGCHilState& state, quint64 timeUs);
+};
+
+#endif // HILSTANDIN_H
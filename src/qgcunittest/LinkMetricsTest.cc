@@ -0,0 +1,213 @@
+#include "LinkMetricsTest.h"
+
+#include <QThread>
+#include <limits>
+
+namespace
+{
+/** @brief Counts bytes like the I/O thread of a link */
+class ReceiveThread : public QThread
+{
+public:
+    ReceiveThread(LinkMetrics& metrics, int chunks) : metrics(metrics), chunks(chunks) {}
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < chunks; ++i)
+        {
+            metrics.received(1);
+        }
+    }
+
+    LinkMetrics& metrics;
+    int chunks;
+};
+}
+
+LinkMetricsTest::LinkMetricsTest()
+{
+}
+
+void LinkMetricsTest::counters_test()
+{
+    LinkMetrics metrics;
+    metrics.received(100);
+    metrics.received(28);
+    metrics.sent(64);
+    metrics.add(LinkMetrics::CRC_ERRORS);
+    metrics.add(LinkMetrics::RESYNCS, 3);
+
+    // Totals include what was not sampled yet
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_RECEIVED), Q_UINT64_C(128));
+    QCOMPARE(metrics.total(LinkMetrics::READS), Q_UINT64_C(2));
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_SENT), Q_UINT64_C(64));
+    QCOMPARE(metrics.total(LinkMetrics::WRITES), Q_UINT64_C(1));
+    QCOMPARE(metrics.total(LinkMetrics::CRC_ERRORS), Q_UINT64_C(1));
+    QCOMPARE(metrics.total(LinkMetrics::RESYNCS), Q_UINT64_C(3));
+    QCOMPARE(metrics.total(LinkMetrics::FRAMES), Q_UINT64_C(0));
+
+    metrics.sample();
+    metrics.received(2);
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_RECEIVED), Q_UINT64_C(130));
+
+    // Without two snapshots there is no window yet
+    LinkMetrics::Window window = metrics.window(1);
+    QCOMPARE(window.seconds, 0.0);
+    QCOMPARE(window.rate(LinkMetrics::BYTES_RECEIVED), 0.0);
+}
+
+void LinkMetricsTest::wrapAround_test()
+{
+    const int max = std::numeric_limits<int>::max();
+    LinkMetrics metrics;
+    metrics.sample(0);
+    metrics.add(LinkMetrics::BYTES_RECEIVED, max);
+    metrics.sample(1000);
+    metrics.add(LinkMetrics::BYTES_RECEIVED, max);
+    metrics.sample(2000);
+    // The 32 bit counter wraps to 1 here
+    metrics.add(LinkMetrics::BYTES_RECEIVED, 3);
+    metrics.sample(3000);
+
+    quint64 expected = 2 * (quint64)max + 3;
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_RECEIVED), expected);
+    QCOMPARE(metrics.window(1).counts[LinkMetrics::BYTES_RECEIVED], Q_UINT64_C(3));
+    QCOMPARE(metrics.window(2).counts[LinkMetrics::BYTES_RECEIVED], (quint64)max + 3);
+    QCOMPARE(metrics.peakRate(LinkMetrics::BYTES_RECEIVED), (double)max);
+}
+
+void LinkMetricsTest::window_test()
+{
+    LinkMetrics metrics;
+    metrics.sample(0);
+    metrics.add(LinkMetrics::BYTES_SENT, 100);
+    metrics.sample(1000);
+    metrics.add(LinkMetrics::BYTES_SENT, 300);
+    metrics.sample(2000);
+
+    LinkMetrics::Window last = metrics.window(1);
+    QCOMPARE(last.seconds, 1.0);
+    QCOMPARE(last.rate(LinkMetrics::BYTES_SENT), 300.0);
+
+    LinkMetrics::Window both = metrics.window(2);
+    QCOMPARE(both.seconds, 2.0);
+    QCOMPARE(both.rate(LinkMetrics::BYTES_SENT), 200.0);
+
+    // Not enough history, the window is shorter
+    LinkMetrics::Window longer = metrics.window(60);
+    QCOMPARE(longer.seconds, 2.0);
+    QCOMPARE(longer.counts[LinkMetrics::BYTES_SENT], Q_UINT64_C(400));
+
+    QCOMPARE(metrics.peakRate(LinkMetrics::BYTES_SENT), 300.0);
+
+    // The ring keeps the last HISTORY snapshots only
+    for (int i = 3; i < 3 + LinkMetrics::HISTORY; ++i)
+    {
+        metrics.add(LinkMetrics::BYTES_SENT, 10);
+        metrics.sample(i * 1000);
+    }
+    QCOMPARE(metrics.peakRate(LinkMetrics::BYTES_SENT), 10.0);
+    QCOMPARE(metrics.window(1000).seconds, (double)(LinkMetrics::HISTORY - 1));
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_SENT), Q_UINT64_C(400) + 10 * LinkMetrics::HISTORY);
+}
+
+void LinkMetricsTest::histogram_test()
+{
+    QCOMPARE(LinkMetrics::binLimit(0), 1u);
+    QCOMPARE(LinkMetrics::binLimit(10), 1024u);
+
+    LinkMetrics metrics;
+    metrics.sample(0);
+    for (int i = 0; i < 100; ++i)
+    {
+        metrics.record(LinkMetrics::HANDOVER_LATENCY, 10);
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        metrics.record(LinkMetrics::HANDOVER_LATENCY, 1000);
+    }
+    // Beyond the last bin
+    metrics.record(LinkMetrics::HANDOVER_LATENCY, 10000000);
+    metrics.sample(1000);
+
+    LinkMetrics::Window window = metrics.window(1);
+    QCOMPARE(window.count(LinkMetrics::HANDOVER_LATENCY), Q_UINT64_C(111));
+    QCOMPARE(window.count(LinkMetrics::READ_INTERVAL), Q_UINT64_C(0));
+    QCOMPARE(window.percentile(LinkMetrics::READ_INTERVAL, 0.5), 0u);
+    QCOMPARE(window.percentile(LinkMetrics::HANDOVER_LATENCY, 0.5), 16u);
+    QCOMPARE(window.percentile(LinkMetrics::HANDOVER_LATENCY, 0.95), 1024u);
+    QCOMPARE(window.percentile(LinkMetrics::HANDOVER_LATENCY, 0.999), LinkMetrics::binLimit(LinkMetrics::BINS - 1));
+}
+
+void LinkMetricsTest::systems_test()
+{
+    LinkMetrics metrics;
+    metrics.sample(0);
+    for (int i = 0; i < 10; ++i)
+    {
+        metrics.frame(1, 0);
+    }
+    metrics.frame(1, 5);
+    for (int i = 0; i < 4; ++i)
+    {
+        metrics.frame(2, 0);
+    }
+    metrics.sample(1000);
+
+    LinkMetrics::Window window = metrics.window(1);
+    QCOMPARE(window.counts[LinkMetrics::FRAMES], Q_UINT64_C(15));
+    QCOMPARE(window.counts[LinkMetrics::SEQUENCE_GAPS], Q_UINT64_C(1));
+    QCOMPARE(window.counts[LinkMetrics::MESSAGES_LOST], Q_UINT64_C(5));
+    QCOMPARE(window.systems.size(), 2);
+    QCOMPARE(window.systems.value(1).frames, Q_UINT64_C(11));
+    QCOMPARE(window.systems.value(1).lost, Q_UINT64_C(5));
+    QCOMPARE(window.systems.value(1).loss(), 31.25);
+    QCOMPARE(window.systems.value(2).loss(), 0.0);
+    // Every frame after the first one has an interval
+    QVERIFY(window.count(LinkMetrics::FRAME_INTERVAL) >= 13);
+    QVERIFY(window.count(LinkMetrics::FRAME_INTERVAL) <= 14);
+
+    // Systems without traffic in the window show no frames
+    metrics.frame(2, 0);
+    metrics.sample(2000);
+    window = metrics.window(1);
+    QCOMPARE(window.systems.value(1).frames, Q_UINT64_C(0));
+    QCOMPARE(window.systems.value(2).frames, Q_UINT64_C(1));
+}
+
+void LinkMetricsTest::threads_test()
+{
+    const int threads = 4;
+    const int chunks = 200000;
+    LinkMetrics metrics;
+    QList<ReceiveThread*> receivers;
+    for (int i = 0; i < threads; ++i)
+    {
+        receivers.append(new ReceiveThread(metrics, chunks));
+    }
+    foreach (ReceiveThread* receiver, receivers)
+    {
+        receiver->start();
+    }
+    // Sample while the counters move
+    bool running = true;
+    while (running)
+    {
+        metrics.sample();
+        running = false;
+        foreach (ReceiveThread* receiver, receivers)
+        {
+            if (!receiver->isFinished()) running = true;
+        }
+    }
+    foreach (ReceiveThread* receiver, receivers)
+    {
+        receiver->wait();
+        delete receiver;
+    }
+    metrics.sample();
+
+    QCOMPARE(metrics.total(LinkMetrics::BYTES_RECEIVED), (quint64)threads * chunks);
+    QCOMPARE(metrics.total(LinkMetrics::READS), (quint64)threads * chunks);
+}
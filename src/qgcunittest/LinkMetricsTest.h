@@ -0,0 +1,27 @@
+#ifndef LINKMETRICSTEST_H
+#define LINKMETRICSTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "LinkMetrics.h"
+#include "AutoTest.h"
+
+class LinkMetricsTest : public QObject
+{
+    Q_OBJECT
+public:
+    LinkMetricsTest();
+
+private slots:
+    void counters_test();
+    void wrapAround_test();
+    void window_test();
+    void histogram_test();
+    void systems_test();
+    void threads_test();
+};
+
+DECLARE_TEST(LinkMetricsTest)
+
+#endif // LINKMETRICSTEST_H
@@ -0,0 +1,330 @@
+#include "LinkTxSchedulerTest.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+
+namespace
+{
+// 8N1 at 9600 baud: 960 bytes/s, bursts of one frame (263 bytes)
+const qint64 SLOW_RATE = 9600;
+// 11520 bytes/s, bursts of 1152 bytes
+const qint64 FAST_RATE = 115200;
+// Depth of the bulk queue in LinkTxScheduler
+const int BULK_DEPTH = 512;
+
+/** @brief Sends PARAM_SET frames with increasing values from its own thread */
+class ParamSetSender : public QThread
+{
+public:
+    ParamSetSender(LinkInterface* link, int count, bool wait = true) : link(link), count(count), waitForRoom(wait) { }
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < count; i++)
+        {
+            mavlink_message_t message;
+            mavlink_msg_param_set_pack(255, 0, &message, 1, 1, "RATE_RLL_P", i, MAV_PARAM_TYPE_REAL32);
+            uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+            int length = mavlink_msg_to_send_buffer(buffer, &message);
+            LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, length, waitForRoom);
+        }
+    }
+
+    LinkInterface* link;
+    int count;
+    bool waitForRoom;
+};
+
+/** @brief Sends one HIGHRES_IMU frame from its own thread, like the HIL bridge */
+class HilSender : public QThread
+{
+public:
+    explicit HilSender(LinkInterface* link) : link(link), result(LinkTxScheduler::SEND_DROPPED) { }
+    LinkTxScheduler::SendResult result;
+
+protected:
+    void run()
+    {
+        mavlink_message_t message;
+        mavlink_msg_highres_imu_pack(255, 0, &message, 0, 0, 0, -9.81f, 0, 0, 0, 0, 0, 0, 1013, 0, 0, 20, 0x1ff);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int length = mavlink_msg_to_send_buffer(buffer, &message);
+        result = LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, length);
+    }
+
+    LinkInterface* link;
+};
+}
+
+void ShapedRecordingLink::writeBytes(const char* data, qint64 size)
+{
+    QMutexLocker locker(&writeMutex);
+    // The scheduler writes one whole frame per call
+    const uint8_t channel = MAVLINK_COMM_3;
+    mavlink_message_t message;
+    mavlink_status_t status;
+    for (qint64 i = 0; i < size; i++)
+    {
+        if (mavlink_parse_char(channel, (uint8_t)data[i], &message, &status))
+        {
+            written.append(message);
+        }
+    }
+    writtenBytes += size;
+    if (QThread::currentThread() != QCoreApplication::instance()->thread())
+    {
+        writtenFromOtherThread = true;
+    }
+}
+
+bool ShapedRecordingLink::waitForFrames(int count, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    forever
+    {
+        {
+            QMutexLocker locker(&writeMutex);
+            if (written.size() >= count) return true;
+        }
+        if (timer.elapsed() >= timeoutMs) return false;
+        QTest::qWait(10);
+    }
+}
+
+LinkTxSchedulerTest::LinkTxSchedulerTest()
+{
+}
+
+void LinkTxSchedulerTest::send(LinkInterface* link, const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int length = mavlink_msg_to_send_buffer(buffer, &message);
+    LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, length);
+}
+
+void LinkTxSchedulerTest::sendParamSet(LinkInterface* link, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        mavlink_message_t message;
+        mavlink_msg_param_set_pack(255, 0, &message, 1, 1, "RATE_RLL_P", i, MAV_PARAM_TYPE_REAL32);
+        send(link, message);
+    }
+}
+
+void LinkTxSchedulerTest::sendManualControl(LinkInterface* link, int target, int x)
+{
+    mavlink_message_t message;
+    mavlink_msg_manual_control_pack(255, 0, &message, target, x, 0, 0, 0, 0);
+    send(link, message);
+}
+
+void LinkTxSchedulerTest::priority_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    sendParamSet(&link, 30);
+    int direct = link.written.size();
+    QVERIFY(direct > 0 && direct < 30);
+
+    mavlink_message_t heartbeat;
+    mavlink_msg_heartbeat_pack(255, 0, &heartbeat, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, 0);
+    send(&link, heartbeat);
+    sendManualControl(&link, 1, 100);
+    QCOMPARE(link.written.size(), direct);
+
+    QVERIFY(link.waitForFrames(32, 5000));
+    // Control before commands before the waiting parameters
+    QCOMPARE((int)link.written.at(direct).msgid, (int)MAVLINK_MSG_ID_MANUAL_CONTROL);
+    QCOMPARE((int)link.written.at(direct + 1).msgid, (int)MAVLINK_MSG_ID_HEARTBEAT);
+    for (int i = direct + 2; i < link.written.size(); i++)
+    {
+        QCOMPARE((int)link.written.at(i).msgid, (int)MAVLINK_MSG_ID_PARAM_SET);
+    }
+}
+
+void LinkTxSchedulerTest::rateShaping_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    sendParamSet(&link, 40);
+    LinkTxScheduler* scheduler = LinkTxScheduler::forLink(&link);
+    QCOMPARE(scheduler->getByteRate(), SLOW_RATE / 10);
+    // No more than one burst goes out at once
+    QVERIFY(link.writtenBytes <= MAVLINK_MAX_PACKET_LEN);
+    qint64 burst = link.writtenBytes;
+
+    QVERIFY(link.waitForFrames(40, 10000));
+    LinkTxScheduler::ClassStatistics stats = scheduler->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QCOMPARE(stats.sent, (quint64)40);
+    QCOMPARE(stats.dropped, (quint64)0);
+    // The last frame could not go out before the bucket had refilled for
+    // everything beyond the first burst. The scheduler books that delay with
+    // its own clock, a slow machine only makes it longer.
+    qint64 shapedMs = (link.writtenBytes - burst) * 1000 / scheduler->getByteRate();
+    QVERIFY(stats.maxLatencyMs >= (quint64)(shapedMs * 9 / 10));
+}
+
+void LinkTxSchedulerTest::coalescing_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    sendParamSet(&link, 10);
+    int direct = link.written.size();
+
+    // Two vehicles controlled over the same link
+    sendManualControl(&link, 1, 10);
+    sendManualControl(&link, 2, 20);
+    sendManualControl(&link, 1, 30);
+
+    QVERIFY(link.waitForFrames(direct + 2, 5000));
+    QCOMPARE((int)link.written.at(direct).msgid, (int)MAVLINK_MSG_ID_MANUAL_CONTROL);
+    QCOMPARE((int)mavlink_msg_manual_control_get_target(&link.written.at(direct)), 1);
+    QCOMPARE((int)mavlink_msg_manual_control_get_x(&link.written.at(direct)), 30);
+    QCOMPARE((int)link.written.at(direct + 1).msgid, (int)MAVLINK_MSG_ID_MANUAL_CONTROL);
+    QCOMPARE((int)mavlink_msg_manual_control_get_target(&link.written.at(direct + 1)), 2);
+    QCOMPARE((int)mavlink_msg_manual_control_get_x(&link.written.at(direct + 1)), 20);
+
+    LinkTxScheduler::ClassStatistics stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_CONTROL);
+    QCOMPARE(stats.coalesced, (quint64)1);
+    QCOMPARE(stats.sent, (quint64)2);
+}
+
+void LinkTxSchedulerTest::controlQueueFull_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    sendParamSet(&link, 10);
+    int direct = link.written.size();
+
+    // More targets than the control queue holds, the queued streams are kept
+    for (int target = 1; target <= 10; target++)
+    {
+        sendManualControl(&link, target, target);
+    }
+    // Still coalesced into its queued frame while the queue is full
+    sendManualControl(&link, 1, 100);
+
+    QVERIFY(link.waitForFrames(direct + 8, 5000));
+    QCOMPARE((int)mavlink_msg_manual_control_get_target(&link.written.at(direct)), 1);
+    QCOMPARE((int)mavlink_msg_manual_control_get_x(&link.written.at(direct)), 100);
+    QCOMPARE((int)mavlink_msg_manual_control_get_target(&link.written.at(direct + 7)), 8);
+    LinkTxScheduler::ClassStatistics stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_CONTROL);
+    QCOMPARE(stats.dropped, (quint64)2);
+    QCOMPARE(stats.coalesced, (quint64)1);
+}
+
+void LinkTxSchedulerTest::hilStreams_test()
+{
+    // The HIL bridge streams at up to 400 Hz and must never wait for room
+    QCOMPARE(LinkTxScheduler::priorityFor(MAVLINK_MSG_ID_HIGHRES_IMU), LinkTxScheduler::PRIORITY_HIL);
+    QCOMPARE(LinkTxScheduler::priorityFor(MAVLINK_MSG_ID_GPS_RAW_INT), LinkTxScheduler::PRIORITY_HIL);
+    QVERIFY(LinkTxScheduler::isSupersedable(MAVLINK_MSG_ID_HIGHRES_IMU));
+    QVERIFY(LinkTxScheduler::isSupersedable(MAVLINK_MSG_ID_GPS_RAW_INT));
+
+    // Written by the bridge thread itself, without the GUI event loop
+    ShapedRecordingLink link(SLOW_RATE, true);
+    HilSender sender(&link);
+    sender.start();
+    QVERIFY(sender.wait(1000));
+    QCOMPARE(sender.result, LinkTxScheduler::SEND_WRITTEN);
+    QCOMPARE(link.written.size(), 1);
+    QVERIFY(link.writtenFromOtherThread);
+}
+
+void LinkTxSchedulerTest::bulkNotDropped_test()
+{
+    ShapedRecordingLink link(FAST_RATE);
+    int count = BULK_DEPTH + 60;
+    sendParamSet(&link, count);
+
+    LinkTxScheduler::ClassStatistics stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    // The main thread runs the drain, its frames are parked instead of waiting
+    QCOMPARE(stats.blockedMs, (quint64)0);
+    QVERIFY(stats.parked > 0);
+    QVERIFY(stats.depth > BULK_DEPTH);
+
+    QVERIFY(link.waitForFrames(count, 10000));
+    for (int i = 0; i < count; i++)
+    {
+        QCOMPARE((int)mavlink_msg_param_set_get_param_value(&link.written.at(i)), i);
+    }
+    stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QCOMPARE(stats.dropped, (quint64)0);
+    QCOMPARE(stats.sent, (quint64)count);
+}
+
+void LinkTxSchedulerTest::parkingCapped_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    int count = 3 * BULK_DEPTH;
+    sendParamSet(&link, count);
+
+    // The main thread parks up to twice the depth, the rest is dropped
+    LinkTxScheduler::ClassStatistics stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QCOMPARE(stats.depth, 2 * BULK_DEPTH);
+    QCOMPARE(stats.parked, (quint64)BULK_DEPTH);
+    QCOMPARE(stats.dropped + stats.depth + link.written.size(), (quint64)count);
+}
+
+void LinkTxSchedulerTest::bulkSenderWaits_test()
+{
+    ShapedRecordingLink link(FAST_RATE);
+    LinkTxScheduler* scheduler = LinkTxScheduler::forLink(&link);
+    int count = BULK_DEPTH + 60;
+    ParamSetSender sender(&link, count);
+    sender.start();
+
+    QVERIFY(link.waitForFrames(count, 10000));
+    QVERIFY(sender.wait(1000));
+    // The frames of the sender thread were written by the main thread
+    QVERIFY(!link.writtenFromOtherThread);
+    for (int i = 0; i < count; i++)
+    {
+        QCOMPARE((int)mavlink_msg_param_set_get_param_value(&link.written.at(i)), i);
+    }
+
+    // The sender was held back instead of losing frames
+    LinkTxScheduler::ClassStatistics stats = scheduler->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QVERIFY(stats.blockedMs > 0);
+    QCOMPARE(stats.parked, (quint64)0);
+    QVERIFY(stats.maxDepth <= BULK_DEPTH);
+    QCOMPARE(stats.dropped, (quint64)0);
+    QCOMPARE(stats.sent, (quint64)count);
+}
+
+void LinkTxSchedulerTest::forwardedNotWaiting_test()
+{
+    ShapedRecordingLink link(SLOW_RATE);
+    LinkTxScheduler* scheduler = LinkTxScheduler::forLink(&link);
+    // Forwarded frames, the main thread does not drain while the sender runs
+    ParamSetSender sender(&link, BULK_DEPTH + 60, false);
+    sender.start();
+    QVERIFY(sender.wait(5000));
+
+    LinkTxScheduler::ClassStatistics stats = scheduler->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QCOMPARE(stats.blockedMs, (quint64)0);
+    QCOMPARE(stats.depth, BULK_DEPTH);
+    QCOMPARE(stats.dropped, (quint64)60);
+}
+
+void LinkTxSchedulerTest::writerThread_test()
+{
+    // Thread safe links are drained by the transmit thread, not the GUI
+    ShapedRecordingLink link(FAST_RATE, true);
+    int count = BULK_DEPTH + 60;
+    ParamSetSender sender(&link, count);
+    sender.start();
+    // The main thread does not process events until the sender is done
+    QVERIFY(sender.wait(10000));
+
+    QVERIFY(link.waitForFrames(count, 10000));
+    QVERIFY(link.writtenFromOtherThread);
+    for (int i = 0; i < count; i++)
+    {
+        QCOMPARE((int)mavlink_msg_param_set_get_param_value(&link.written.at(i)), i);
+    }
+    LinkTxScheduler::ClassStatistics stats = LinkTxScheduler::forLink(&link)->getStatistics(LinkTxScheduler::PRIORITY_BULK);
+    QCOMPARE(stats.parked, (quint64)0);
+    QCOMPARE(stats.dropped, (quint64)0);
+    QCOMPARE(stats.sent, (quint64)count);
+}
@@ -0,0 +1,64 @@
+#ifndef LINKTXSCHEDULERTEST_H
+#define LINKTXSCHEDULERTEST_H
+
+#include <QObject>
+#include <QList>
+#include <QMutex>
+#include <QtTest/QtTest>
+
+#include "LinkTxScheduler.h"
+#include "MAVLinkLoadLink.h"
+#include "AutoTest.h"
+
+/** @brief Link of a fixed nominal rate that keeps every frame the scheduler writes */
+class ShapedRecordingLink : public MAVLinkLoadLink
+{
+public:
+    ShapedRecordingLink(qint64 bitRate, bool threadSafe = false) :
+        writtenBytes(0), writtenFromOtherThread(false), bitRate(bitRate), threadSafe(threadSafe) { }
+
+    bool isConnected() { return true; }
+    qint64 getNominalDataRate() { return bitRate; }
+    bool isWriteThreadSafe() const { return threadSafe; }
+    void writeBytes(const char* data, qint64 size);
+
+    /** @brief Process events until this many frames were written, false on timeout */
+    bool waitForFrames(int count, int timeoutMs);
+
+    QList<mavlink_message_t> written;
+    qint64 writtenBytes;
+    bool writtenFromOtherThread;    ///< writeBytes() was called outside the main thread
+
+protected:
+    qint64 bitRate;
+    bool threadSafe;
+    QMutex writeMutex;
+};
+
+class LinkTxSchedulerTest : public QObject
+{
+    Q_OBJECT
+public:
+    LinkTxSchedulerTest();
+
+private slots:
+    void priority_test();
+    void rateShaping_test();
+    void coalescing_test();
+    void controlQueueFull_test();
+    void hilStreams_test();
+    void bulkNotDropped_test();
+    void parkingCapped_test();
+    void bulkSenderWaits_test();
+    void writerThread_test();
+    void forwardedNotWaiting_test();
+
+private:
+    static void send(LinkInterface* link, const mavlink_message_t& message);
+    static void sendParamSet(LinkInterface* link, int count);
+    static void sendManualControl(LinkInterface* link, int target, int x);
+};
+
+DECLARE_TEST(LinkTxSchedulerTest)
+
+#endif // LINKTXSCHEDULERTEST_H
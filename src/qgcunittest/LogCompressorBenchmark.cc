@@ -0,0 +1,92 @@
+#include "LogCompressorBenchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <qmath.h>
+
+#include "LogCompressor.h"
+
+namespace
+{
+/** @brief Values recorded per time stamp */
+const char* const CURVES[] = {
+    "M1:ATTITUDE.roll", "M1:ATTITUDE.pitch", "M1:ATTITUDE.yaw",
+    "M1:VFR_HUD.airspeed", "M1:VFR_HUD.groundspeed", "M1:VFR_HUD.alt",
+    "M1:RAW_IMU.xacc", "M1:RAW_IMU.yacc", "M1:RAW_IMU.zacc",
+    "M1:SYS_STATUS.voltage_battery"
+};
+const int CURVE_COUNT = sizeof(CURVES) / sizeof(CURVES[0]);
+}
+
+LogCompressorBenchmark::LogCompressorBenchmark()
+{
+}
+
+void LogCompressorBenchmark::initTestCase()
+{
+    dir = QDir::tempPath() + QString("/LogCompressorBenchmark%1/").arg(QCoreApplication::applicationPid());
+    QVERIFY(QDir().mkpath(dir));
+}
+
+void LogCompressorBenchmark::cleanupTestCase()
+{
+    foreach (const QString& file, QDir(dir).entryList(QDir::Files))
+    {
+        QFile::remove(dir + file);
+    }
+    QDir().rmdir(dir);
+}
+
+int LogCompressorBenchmark::writeLog(const QString& file, int lines)
+{
+    QFile log(file);
+    if (!log.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return 0;
+    QTextStream out(&log);
+    int stamps = 0;
+    for (int i = 0; i < lines; i++)
+    {
+        // 50 Hz, every curve once per time stamp
+        int stamp = i / CURVE_COUNT;
+        out << 1000000 + stamp * 20 << "\t1\t" << CURVES[i % CURVE_COUNT] << "\t" << qSin(i * 0.001) << "\n";
+        stamps = stamp + 1;
+    }
+    return stamps;
+}
+
+int LogCompressorBenchmark::lineCount(const QString& file)
+{
+    QFile csv(file);
+    if (!csv.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    int lines = 0;
+    while (!csv.atEnd())
+    {
+        csv.readLine();
+        lines++;
+    }
+    return lines;
+}
+
+void LogCompressorBenchmark::compress_benchmark_data()
+{
+    QTest::addColumn<int>("lines");
+    QTest::newRow("10000 lines") << 10000;
+    QTest::newRow("50000 lines") << 50000;
+}
+
+void LogCompressorBenchmark::compress_benchmark()
+{
+    QFETCH(int, lines);
+    QString log = dir + "log.txt";
+    int stamps = writeLog(log, lines);
+    QVERIFY(stamps > 2);
+
+    QBENCHMARK {
+        LogCompressor compressor(log);
+        compressor.startCompression(true);
+        compressor.wait();
+    }
+
+    // The header and all time stamps but the first two, which may be incomplete
+    QCOMPARE(lineCount(dir + "log_compressed.txt"), stamps - 1);
+}
@@ -0,0 +1,32 @@
+#ifndef LOGCOMPRESSORBENCHMARK_H
+#define LOGCOMPRESSORBENCHMARK_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/** @brief Turning a linechart log into a CSV table with LogCompressor */
+class LogCompressorBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    LogCompressorBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void compress_benchmark_data();
+    void compress_benchmark();
+
+private:
+    /** @brief Write a log like the linechart records it, returns the number of time stamps */
+    static int writeLog(const QString& file, int lines);
+    static int lineCount(const QString& file);
+
+    QString dir;
+};
+
+DECLARE_TEST(LogCompressorBenchmark)
+#endif // LOGCOMPRESSORBENCHMARK_H
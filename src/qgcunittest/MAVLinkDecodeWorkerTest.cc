@@ -0,0 +1,299 @@
+#include "MAVLinkDecodeWorkerTest.h"
+
+#include <QElapsedTimer>
+
+MAVLinkDecodeWorkerTest::MAVLinkDecodeWorkerTest() :
+    protocol(NULL),
+    link(NULL),
+    worker(NULL)
+{
+    qRegisterMetaType<LinkInterface*>("LinkInterface*");
+}
+
+void MAVLinkDecodeWorkerTest::init()
+{
+    protocol = new MAVLinkProtocol();
+    link = new SerialLink();
+    worker = new MAVLinkDecodeWorker(link, protocol);
+}
+
+void MAVLinkDecodeWorkerTest::cleanup()
+{
+    delete worker;
+    worker = NULL;
+    delete link;
+    link = NULL;
+    delete protocol;
+    protocol = NULL;
+}
+
+void MAVLinkDecodeWorkerTest::append(QByteArray& bytes, const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &message);
+    bytes.append((const char*)buffer, len);
+}
+
+void MAVLinkDecodeWorkerTest::post(const QByteArray& bytes)
+{
+    QMetaObject::invokeMethod(worker, "receiveBytes", Qt::QueuedConnection,
+                              Q_ARG(LinkInterface*, link), Q_ARG(QByteArray, bytes));
+}
+
+bool MAVLinkDecodeWorkerTest::waitForMessages(QSignalSpy& spy)
+{
+    for (int i = 0; i < 200 && spy.count() == 0; i++)
+    {
+        QTest::qWait(10);
+    }
+    return spy.count() > 0;
+}
+
+void MAVLinkDecodeWorkerTest::coalescing_test()
+{
+    QSignalSpy ready(worker, SIGNAL(messagesReady()));
+    mavlink_message_t msg;
+    QByteArray bytes;
+
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    append(bytes, msg);
+    for (int i = 0; i < 50; i++)
+    {
+        mavlink_msg_attitude_pack(1, 1, &msg, i, 0.01f * i, 0, 0, 0, 0, 0);
+        append(bytes, msg);
+        if (i % 20 == 0)
+        {
+            mavlink_msg_param_value_pack(1, 1, &msg, "TEST", i, MAV_PARAM_TYPE_REAL32, 3, i / 20);
+            append(bytes, msg);
+        }
+    }
+    post(bytes);
+    QVERIFY(waitForMessages(ready));
+
+    int coalesced = 0;
+    int lost = 0;
+    QVector<mavlink_message_t> messages = worker->takeMessages(coalesced, lost);
+
+    // The heartbeat, one attitude with the latest state and all parameters in order
+    QCOMPARE(messages.size(), 5);
+    QCOMPARE((int)messages.at(0).msgid, (int)MAVLINK_MSG_ID_HEARTBEAT);
+    QCOMPARE((int)messages.at(1).msgid, (int)MAVLINK_MSG_ID_ATTITUDE);
+    QCOMPARE(mavlink_msg_attitude_get_time_boot_ms(&messages.at(1)), (uint32_t)49);
+    for (int i = 0; i < 3; i++)
+    {
+        QCOMPARE((int)messages.at(2 + i).msgid, (int)MAVLINK_MSG_ID_PARAM_VALUE);
+        QCOMPARE((int)mavlink_msg_param_value_get_param_index(&messages.at(2 + i)), i);
+    }
+    QCOMPARE(coalesced, 49);
+    QCOMPARE(lost, 0);
+
+    MAVLinkDecodeWorker::Statistics stats = worker->getStatistics();
+    QCOMPARE(stats.messages, (quint64)54);
+    QCOMPARE(stats.bytes, (quint64)bytes.size());
+    QCOMPARE(stats.queueDepth, 0);
+    QCOMPARE(stats.maxQueueDepth, 5);
+}
+
+void MAVLinkDecodeWorkerTest::samplesNotCoalesced_test()
+{
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_RAW_IMU));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_SCALED_IMU));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_HIGHRES_IMU));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_SCALED_PRESSURE));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_RC_CHANNELS_RAW));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_RC_CHANNELS_SCALED));
+    QVERIFY(!MAVLinkDecodeWorker::isCoalescable(MAVLINK_MSG_ID_SERVO_OUTPUT_RAW));
+
+    QSignalSpy ready(worker, SIGNAL(messagesReady()));
+    mavlink_message_t msg;
+    QByteArray bytes;
+    const int samples = 10;
+    for (int i = 0; i < samples; i++)
+    {
+        mavlink_msg_raw_imu_pack(1, 1, &msg, i, i, 0, 0, 0, 0, 0, 0, 0, 0);
+        append(bytes, msg);
+        mavlink_msg_rc_channels_raw_pack(1, 1, &msg, i, 0, 1000 + i, 0, 0, 0, 0, 0, 0, 0, 255);
+        append(bytes, msg);
+        mavlink_msg_servo_output_raw_pack(1, 1, &msg, i, 0, 1500 + i, 0, 0, 0, 0, 0, 0, 0);
+        append(bytes, msg);
+    }
+    post(bytes);
+    QVERIFY(waitForMessages(ready));
+
+    int coalesced = 0;
+    int lost = 0;
+    QVector<mavlink_message_t> messages = worker->takeMessages(coalesced, lost);
+
+    // Every sample arrives, in order
+    QCOMPARE(coalesced, 0);
+    QCOMPARE(messages.size(), 3 * samples);
+    for (int i = 0; i < samples; i++)
+    {
+        QCOMPARE((int)mavlink_msg_raw_imu_get_xacc(&messages.at(3 * i)), i);
+        QCOMPARE((int)mavlink_msg_rc_channels_raw_get_chan1_raw(&messages.at(3 * i + 1)), 1000 + i);
+        QCOMPARE((int)mavlink_msg_servo_output_raw_get_servo1_raw(&messages.at(3 * i + 2)), 1500 + i);
+    }
+}
+
+void MAVLinkDecodeWorkerTest::guiStall_test()
+{
+    const int chunks = 200;
+    const int attitudesPerChunk = 10;
+    QSignalSpy ready(worker, SIGNAL(messagesReady()));
+    VehicleStateBuffer vehicleState;
+    protocol->addVehicleState(1, &vehicleState);
+
+    // Pack everything first, packing and parsing share the channel state
+    QList<QByteArray> data;
+    mavlink_message_t msg;
+    for (int c = 0; c < chunks; c++)
+    {
+        QByteArray bytes;
+        for (int i = 0; i < attitudesPerChunk; i++)
+        {
+            mavlink_msg_attitude_pack(1, 1, &msg, c * attitudesPerChunk + i, 0.001f * i, 0, 0, 0, 0, 0);
+            append(bytes, msg);
+        }
+        mavlink_msg_statustext_pack(1, 1, &msg, MAV_SEVERITY_INFO, "chunk");
+        append(bytes, msg);
+        data.append(bytes);
+    }
+
+    foreach (const QByteArray& bytes, data)
+    {
+        post(bytes);
+    }
+
+    // Stall this thread like a long paint would, the decoder keeps going
+    QElapsedTimer stall;
+    stall.start();
+    quint64 total = chunks * (attitudesPerChunk + 1);
+    while (worker->getStatistics().messages < total && stall.elapsed() < 5000)
+    {
+        QThread::yieldCurrentThread();
+    }
+    QCOMPARE(worker->getStatistics().messages, total);
+    // The snapshot saw every attitude although this thread took none of them
+    VehicleState state = vehicleState.read();
+    QCOMPARE(state.version, (quint64)(chunks * attitudesPerChunk));
+    QCOMPARE((float)state.roll, 0.001f * (attitudesPerChunk - 1));
+    protocol->removeVehicleState(1, &vehicleState);
+
+    QVERIFY(waitForMessages(ready));
+    int coalesced = 0;
+    int lost = 0;
+    QVector<mavlink_message_t> messages = worker->takeMessages(coalesced, lost);
+
+    // All status texts survive, the attitudes collapse into the newest one
+    QCOMPARE(messages.size(), chunks + 1);
+    QCOMPARE(coalesced, chunks * attitudesPerChunk - 1);
+    QCOMPARE(mavlink_msg_attitude_get_time_boot_ms(&messages.at(0)), (uint32_t)(chunks * attitudesPerChunk - 1));
+    QCOMPARE(lost, 0);
+
+    MAVLinkDecodeWorker::Statistics stats = worker->getStatistics();
+    QVERIFY(stats.maxQueueDepth <= chunks + 1);
+}
+
+void MAVLinkDecodeWorkerTest::queueFull_test()
+{
+    const int extra = 10;
+    const int total = MAVLinkDecodeWorker::queueCapacity + extra;
+    mavlink_message_t msg;
+    QByteArray bytes;
+    mavlink_msg_attitude_pack(1, 1, &msg, 1, 0, 0, 0, 0, 0, 0);
+    append(bytes, msg);
+    for (int i = 0; i < total; i++)
+    {
+        mavlink_msg_param_value_pack(1, 1, &msg, "PARAM", i, MAV_PARAM_TYPE_REAL32, total, i);
+        append(bytes, msg);
+    }
+    // An attitude still replaces its queued state when the queue is full
+    mavlink_msg_attitude_pack(1, 1, &msg, 2, 0, 0, 0, 0, 0, 0);
+    append(bytes, msg);
+    post(bytes);
+
+    QElapsedTimer wait;
+    wait.start();
+    while (worker->getStatistics().messages < (quint64)total + 2 && wait.elapsed() < 5000)
+    {
+        QTest::qWait(10);
+    }
+
+    MAVLinkDecodeWorker::Statistics stats = worker->getStatistics();
+    QCOMPARE(stats.messages, (quint64)total + 2);
+    // The attitude took one place
+    QCOMPARE(stats.dropped, (quint64)extra + 1);
+    QCOMPARE(stats.coalesced, (quint64)1);
+    QCOMPARE(stats.maxQueueDepth, MAVLinkDecodeWorker::queueCapacity);
+
+    int coalesced = 0;
+    int lost = 0;
+    QVector<mavlink_message_t> messages = worker->takeMessages(coalesced, lost);
+    QCOMPARE(messages.size(), MAVLinkDecodeWorker::queueCapacity);
+    QCOMPARE(coalesced, extra + 2);
+    QCOMPARE(lost, 0);
+    // The oldest messages are kept in order, the newest parameters are lost
+    QCOMPARE(messages.at(0).msgid, (uint8_t)MAVLINK_MSG_ID_ATTITUDE);
+    QCOMPARE(mavlink_msg_attitude_get_time_boot_ms(&messages.at(0)), (uint32_t)2);
+    QCOMPARE(mavlink_msg_param_value_get_param_index(&messages.at(1)), (uint16_t)0);
+    QCOMPARE(mavlink_msg_param_value_get_param_index(&messages.last()), (uint16_t)(MAVLinkDecodeWorker::queueCapacity - 2));
+
+    // There is room again once the protocol took the queue
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    bytes.clear();
+    append(bytes, msg);
+    post(bytes);
+    while (worker->getStatistics().messages < (quint64)total + 3 && wait.elapsed() < 5000)
+    {
+        QTest::qWait(10);
+    }
+    messages = worker->takeMessages(coalesced, lost);
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(coalesced, 0);
+    QCOMPARE(worker->getStatistics().dropped, (quint64)extra + 1);
+}
+
+void MAVLinkDecodeWorkerTest::metrics_test()
+{
+    mavlink_message_t msg;
+    QByteArray bytes;
+
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    append(bytes, msg);
+    // Noise between frames
+    bytes.append("abc");
+    // A frame with a broken checksum, never the start byte so the parser does not resync on it
+    mavlink_msg_attitude_pack(1, 1, &msg, 0, 0, 0, 0, 0, 0, 0);
+    append(bytes, msg);
+    int last = bytes.size() - 1;
+    bytes[last] = (bytes.at(last) == 0) ? 1 : 0;
+    // Three frames that never arrive
+    for (int i = 0; i < 3; i++)
+    {
+        mavlink_msg_attitude_pack(1, 1, &msg, i, 0, 0, 0, 0, 0, 0);
+    }
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    append(bytes, msg);
+
+    LinkMetrics& metrics = link->getMetrics();
+    metrics.sample(0);
+    post(bytes);
+
+    QElapsedTimer wait;
+    wait.start();
+    while (worker->getStatistics().messages < 2 && wait.elapsed() < 2000)
+    {
+        QTest::qWait(10);
+    }
+
+    QCOMPARE(metrics.total(LinkMetrics::FRAMES), (quint64)2);
+    QCOMPARE(metrics.total(LinkMetrics::CRC_ERRORS), (quint64)1);
+    QCOMPARE(metrics.total(LinkMetrics::FRAMING_ERRORS), (quint64)0);
+    QCOMPARE(metrics.total(LinkMetrics::RESYNCS), (quint64)1);
+    // The broken frame and the three missing ones
+    QCOMPARE(metrics.total(LinkMetrics::MESSAGES_LOST), (quint64)4);
+    QCOMPARE(metrics.total(LinkMetrics::SEQUENCE_GAPS), (quint64)1);
+
+    metrics.sample(1000);
+    QCOMPARE(metrics.window(1).systems.value(1).loss(), 200.0 / 3);
+}
@@ -0,0 +1,43 @@
+#ifndef MAVLINKDECODEWORKERTEST_H
+#define MAVLINKDECODEWORKERTEST_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QtTest/QtTest>
+
+#include "MAVLinkProtocol.h"
+#include "MAVLinkDecodeWorker.h"
+#include "SerialLink.h"
+#include "AutoTest.h"
+
+class MAVLinkDecodeWorkerTest : public QObject
+{
+    Q_OBJECT
+public:
+    MAVLinkDecodeWorkerTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void coalescing_test();
+    void samplesNotCoalesced_test();
+    void guiStall_test();
+    void queueFull_test();
+    void metrics_test();
+
+private:
+    /** @brief Append one message in wire format */
+    static void append(QByteArray& bytes, const mavlink_message_t& message);
+    /** @brief Hand bytes to the worker as the link would */
+    void post(const QByteArray& bytes);
+    /** @brief Process events until the worker reported messages */
+    bool waitForMessages(QSignalSpy& spy);
+
+    MAVLinkProtocol* protocol;
+    SerialLink* link;
+    MAVLinkDecodeWorker* worker;
+};
+
+DECLARE_TEST(MAVLinkDecodeWorkerTest)
+#endif // MAVLINKDECODEWORKERTEST_H
@@ -0,0 +1,140 @@
+#include "MAVLinkDecoderTest.h"
+
+MAVLinkDecoderRecorder::MAVLinkDecoderRecorder(MAVLinkDecoder* decoder) : QObject(decoder)
+{
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,quint8,quint64)), this, SLOT(record(int,QString,QString,quint8,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,qint8,quint64)), this, SLOT(record(int,QString,QString,qint8,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,quint16,quint64)), this, SLOT(record(int,QString,QString,quint16,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,qint16,quint64)), this, SLOT(record(int,QString,QString,qint16,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,quint32,quint64)), this, SLOT(record(int,QString,QString,quint32,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,qint32,quint64)), this, SLOT(record(int,QString,QString,qint32,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,quint64,quint64)), this, SLOT(record(int,QString,QString,quint64,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,qint64,quint64)), this, SLOT(record(int,QString,QString,qint64,quint64)));
+    connect(decoder, SIGNAL(valueChanged(int,QString,QString,double,quint64)), this, SLOT(record(int,QString,QString,double,quint64)));
+    connect(decoder, SIGNAL(textMessageReceived(int,int,int,QString)), this, SLOT(recordText(int,int,int,QString)));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, quint8 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, qint8 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, quint16 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, qint16 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, quint32 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, qint32 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, quint64 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, qint64 value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::record(int uasId, const QString& name, const QString& unit, double value, quint64 msec)
+{
+    Q_UNUSED(uasId); Q_UNUSED(msec);
+    values.append(QString("%1 %2 %3").arg(name).arg(unit).arg(value));
+}
+
+void MAVLinkDecoderRecorder::recordText(int uasId, int componentId, int severity, const QString& text)
+{
+    Q_UNUSED(uasId); Q_UNUSED(componentId); Q_UNUSED(severity);
+    values.append(text);
+}
+
+MAVLinkDecoderTest::MAVLinkDecoderTest()
+{
+}
+
+void MAVLinkDecoderTest::init()
+{
+    protocol = new MAVLinkProtocol();
+}
+
+void MAVLinkDecoderTest::cleanup()
+{
+    delete protocol;
+    protocol = NULL;
+}
+
+QList<mavlink_message_t> MAVLinkDecoderTest::createMessages()
+{
+    QList<mavlink_message_t> messages;
+    mavlink_message_t msg;
+
+    mavlink_msg_heartbeat_pack(1, 1, &msg, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    messages.append(msg);
+    mavlink_msg_sys_status_pack(1, 1, &msg, 0x3f, 0x3f, 0x3f, 450, 12400, 1250, 87, 0, 0, 0, 0, 0, 0);
+    messages.append(msg);
+    mavlink_msg_attitude_pack(1, 1, &msg, 123456, 0.1f, -0.2f, 1.5f, 0.01f, 0.02f, -0.03f);
+    messages.append(msg);
+    mavlink_msg_global_position_int_pack(1, 1, &msg, 123460, 473977420, 85455940, 512000, 12000, 120, -40, 5, 27000);
+    messages.append(msg);
+    mavlink_msg_raw_imu_pack(1, 1, &msg, 123470000ULL, 10, -20, -1000, 1, 2, 3, 200, -150, 400);
+    messages.append(msg);
+    mavlink_msg_servo_output_raw_pack(1, 1, &msg, 123480, 0, 1100, 1200, 1300, 1400, 1500, 1600, 1700, 1800);
+    messages.append(msg);
+    mavlink_msg_vfr_hud_pack(1, 1, &msg, 12.5f, 13.0f, 270, 55, 120.0f, 1.5f);
+    messages.append(msg);
+    int8_t memory[32];
+    for (int i = 0; i < 32; ++i) memory[i] = i - 16;
+    mavlink_msg_memory_vect_pack(1, 1, &msg, 0x1000, 1, 0, memory);
+    messages.append(msg);
+    mavlink_msg_param_request_read_pack(1, 1, &msg, 1, 1, "RATE_RLL_P", -1);
+    messages.append(msg);
+
+    return messages;
+}
+
+void MAVLinkDecoderTest::typedMatchesGeneric_test()
+{
+    MAVLinkDecoderProbe typed(protocol);
+    MAVLinkDecoderProbe generic(protocol);
+    MAVLinkDecoderRecorder typedValues(&typed);
+    MAVLinkDecoderRecorder genericValues(&generic);
+
+    QList<mavlink_message_t> messages = createMessages();
+    foreach (const mavlink_message_t& msg, messages)
+    {
+        typed.receiveMessage(NULL, msg);
+        generic.receiveMessageGeneric(msg);
+    }
+
+    QVERIFY(!typedValues.values.isEmpty());
+    QCOMPARE(typedValues.values, genericValues.values);
+    QVERIFY(typedValues.values.contains("M1:ATTITUDE.roll float 0.1"));
+    QVERIFY(typedValues.values.contains("M1:MEMORY_VECT.value.31 int8_t[32] 15"));
+    QVERIFY(typedValues.values.contains("M1:PARAM_REQUEST_READ.param_id: RATE_RLL_P"));
+}
@@ -0,0 +1,69 @@
+#ifndef MAVLINKDECODERTEST_H
+#define MAVLINKDECODERTEST_H
+
+#include <QObject>
+#include <QStringList>
+#include <QtTest/QtTest>
+
+#include "MAVLinkProtocol.h"
+#include "MAVLinkDecoder.h"
+#include "AutoTest.h"
+
+/**
+ * Gives the tests access to the MAVLINK_MESSAGE_INFO based decoder, which
+ * is otherwise only used for the debug messages.
+ */
+class MAVLinkDecoderProbe : public MAVLinkDecoder
+{
+public:
+    MAVLinkDecoderProbe(MAVLinkProtocol* protocol) : MAVLinkDecoder(protocol) {}
+
+    void receiveMessageGeneric(mavlink_message_t message)
+    {
+        memcpy(receivedMessages+message.msgid, &message, sizeof(mavlink_message_t));
+        decodeFieldsGeneric(&message);
+    }
+};
+
+/** @brief Records all values emitted by a decoder as "name unit value" */
+class MAVLinkDecoderRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MAVLinkDecoderRecorder(MAVLinkDecoder* decoder);
+    QStringList values;
+
+public slots:
+    void record(int uasId, const QString& name, const QString& unit, quint8 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, qint8 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, quint16 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, qint16 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, quint32 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, qint32 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, quint64 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, qint64 value, quint64 msec);
+    void record(int uasId, const QString& name, const QString& unit, double value, quint64 msec);
+    void recordText(int uasId, int componentId, int severity, const QString& text);
+};
+
+class MAVLinkDecoderTest : public QObject
+{
+    Q_OBJECT
+public:
+    MAVLinkDecoderTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void typedMatchesGeneric_test();
+
+private:
+    /** @brief A typical telemetry mix, plus an array and a string message */
+    QList<mavlink_message_t> createMessages();
+
+    MAVLinkProtocol* protocol;
+};
+
+DECLARE_TEST(MAVLinkDecoderTest)
+#endif // MAVLINKDECODERTEST_H
@@ -0,0 +1,134 @@
+#include "MAVLinkLoadLinkTest.h"
+
+#include <string.h>
+
+MAVLinkLoadLinkTest::MAVLinkLoadLinkTest()
+{
+}
+
+QMap<int, int> MAVLinkLoadLinkTest::parse(const QByteArray& block, QList<mavlink_message_t>* messages)
+{
+    const uint8_t channel = MAVLINK_COMM_1;
+    memset(mavlink_get_channel_status(channel), 0, sizeof(mavlink_status_t));
+    QMap<int, int> frames;
+    mavlink_message_t message;
+    mavlink_status_t status;
+    for (int i = 0; i < block.size(); i++)
+    {
+        if (mavlink_parse_char(channel, (uint8_t)block.at(i), &message, &status))
+        {
+            frames[message.sysid]++;
+            if (messages) messages->append(message);
+        }
+    }
+    return frames;
+}
+
+void MAVLinkLoadLinkTest::deterministic_test()
+{
+    MAVLinkLoadLink first(4, 10000, 7);
+    MAVLinkLoadLink second(4, 10000, 7);
+    MAVLinkLoadLink other(4, 10000, 8);
+    first.setLossProbability(0.05);
+    second.setLossProbability(0.05);
+    other.setLossProbability(0.05);
+
+    QByteArray a;
+    QByteArray b;
+    QByteArray c;
+    // Different batch sizes, the output only depends on the number of messages
+    first.generate(a, 1000);
+    second.generate(b, 400);
+    second.generate(b, 600);
+    other.generate(c, 1000);
+    QVERIFY(!a.isEmpty());
+    QVERIFY(a == b);
+    QVERIFY(a != c);
+    QCOMPARE(first.getDropped(), second.getDropped());
+}
+
+void MAVLinkLoadLinkTest::frames_test()
+{
+    const int vehicles = 3;
+    const int messages = 3000;
+    MAVLinkLoadLink link(vehicles, 50000);
+    QByteArray block;
+    QCOMPARE(link.generate(block, messages), messages);
+    QCOMPARE(link.getGenerated(), (quint64)messages);
+
+    // Every frame passes the checksum, the vehicles take turns
+    QList<mavlink_message_t> parsed;
+    QMap<int, int> frames = parse(block, &parsed);
+    QCOMPARE(frames.size(), vehicles);
+    for (int v = 1; v <= vehicles; v++)
+    {
+        QCOMPARE(frames.value(v), messages / vehicles);
+    }
+
+    // Sequence numbers count up per vehicle and wrap around, the timestamps grow
+    QMap<int, int> lastSequence;
+    quint32 lastAttitudeMs = 0;
+    foreach (const mavlink_message_t& message, parsed)
+    {
+        if (lastSequence.contains(message.sysid))
+        {
+            QCOMPARE((int)message.seq, (lastSequence.value(message.sysid) + 1) & 0xFF);
+        }
+        lastSequence[message.sysid] = message.seq;
+        if (message.msgid == MAVLINK_MSG_ID_ATTITUDE)
+        {
+            quint32 ms = mavlink_msg_attitude_get_time_boot_ms(&message);
+            QVERIFY(ms >= lastAttitudeMs);
+            lastAttitudeMs = ms;
+        }
+    }
+    // 3000 messages at 50000 per second take 60 ms
+    QVERIFY(lastAttitudeMs >= 55 && lastAttitudeMs < 60);
+}
+
+void MAVLinkLoadLinkTest::mix_test()
+{
+    MAVLinkLoadLink link(1, 1000);
+    QMap<int, int> weights;
+    weights.insert(MAVLINK_MSG_ID_ATTITUDE, 3);
+    weights.insert(MAVLINK_MSG_ID_HEARTBEAT, 1);
+    // Not supported, ignored
+    weights.insert(MAVLINK_MSG_ID_PARAM_VALUE, 5);
+    link.setMix(weights);
+    QCOMPARE(link.getMix().size(), 2);
+
+    QByteArray block;
+    link.generate(block, 4000);
+    QList<mavlink_message_t> parsed;
+    parse(block, &parsed);
+    QCOMPARE(parsed.size(), 4000);
+    int attitudes = 0;
+    foreach (const mavlink_message_t& message, parsed)
+    {
+        QVERIFY(message.msgid == MAVLINK_MSG_ID_ATTITUDE || message.msgid == MAVLINK_MSG_ID_HEARTBEAT);
+        if (message.msgid == MAVLINK_MSG_ID_ATTITUDE) attitudes++;
+    }
+    QVERIFY(attitudes > 2850 && attitudes < 3150);
+}
+
+void MAVLinkLoadLinkTest::injection_test()
+{
+    const int messages = 20000;
+    MAVLinkLoadLink link(2, 100000);
+    link.setLossProbability(0.1);
+    link.setCorruptionProbability(0.02);
+    QByteArray block;
+    int frames = link.generate(block, messages);
+
+    quint64 dropped = link.getDropped();
+    quint64 corrupted = link.getCorrupted();
+    QCOMPARE((quint64)frames + dropped, (quint64)messages);
+    QVERIFY(dropped > 1800 && dropped < 2200);
+    QVERIFY(corrupted > 300 && corrupted < 420);
+
+    // A corrupted frame fails the checksum, resyncing may cost the next one as well
+    QMap<int, int> parsed = parse(block);
+    int total = parsed.value(1) + parsed.value(2);
+    QVERIFY(total <= frames - (int)corrupted);
+    QVERIFY(total >= frames - 2 * (int)corrupted);
+}
@@ -0,0 +1,29 @@
+#ifndef MAVLINKLOADLINKTEST_H
+#define MAVLINKLOADLINKTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "MAVLinkLoadLink.h"
+#include "AutoTest.h"
+
+class MAVLinkLoadLinkTest : public QObject
+{
+    Q_OBJECT
+public:
+    MAVLinkLoadLinkTest();
+
+private slots:
+    void deterministic_test();
+    void frames_test();
+    void mix_test();
+    void injection_test();
+
+private:
+    /** @brief Parse a block from a reset parser, returns the number of frames per system id */
+    static QMap<int, int> parse(const QByteArray& block, QList<mavlink_message_t>* messages = NULL);
+};
+
+DECLARE_TEST(MAVLinkLoadLinkTest)
+
+#endif // MAVLINKLOADLINKTEST_H
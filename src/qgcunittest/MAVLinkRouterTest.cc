@@ -0,0 +1,282 @@
+#include "MAVLinkRouterTest.h"
+
+namespace
+{
+const int ownSystemId = 255;
+
+mavlink_message_t attitude(int sysid, int compid)
+{
+    mavlink_message_t message;
+    mavlink_msg_attitude_pack(sysid, compid, &message, 1000, 0.1f, 0.2f, 0.3f, 0.0f, 0.0f, 0.0f);
+    return message;
+}
+
+mavlink_message_t command(int sysid, int targetSystem, int targetComponent)
+{
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(sysid, 0, &message, targetSystem, targetComponent, MAV_CMD_COMPONENT_ARM_DISARM, 0, 1, 0, 0, 0, 0, 0, 0);
+    return message;
+}
+}
+
+MAVLinkRouterTest::MAVLinkRouterTest() :
+    router(NULL)
+{
+    qRegisterMetaType<LinkInterface*>("LinkInterface*");
+    for (int i = 0; i < 3; i++) links[i] = NULL;
+}
+
+void MAVLinkRouterTest::init()
+{
+    router = new RecordingRouter();
+    for (int i = 0; i < 3; i++)
+    {
+        links[i] = new SerialLink();
+        router->addLink(links[i]);
+    }
+}
+
+void MAVLinkRouterTest::cleanup()
+{
+    delete router;
+    router = NULL;
+    for (int i = 0; i < 3; i++)
+    {
+        delete links[i];
+        links[i] = NULL;
+    }
+}
+
+QByteArray MAVLinkRouterTest::frame(const mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int len = mavlink_msg_to_send_buffer(buffer, &message);
+    return QByteArray((const char*)buffer, len);
+}
+
+QByteArray MAVLinkRouterTest::waitForDatagram(QUdpSocket& socket, int timeout)
+{
+    for (int wait = 0; wait < timeout / 10 && !socket.hasPendingDatagrams(); wait++)
+    {
+        QTest::qWait(10);
+    }
+    if (!socket.hasPendingDatagrams())
+        return QByteArray();
+    QByteArray datagram(socket.pendingDatagramSize(), 0);
+    socket.readDatagram(datagram.data(), datagram.size());
+    return datagram;
+}
+
+void MAVLinkRouterTest::target_test()
+{
+    int system;
+    int component;
+    router->getTarget(command(1, 7, 190), system, component);
+    QCOMPARE(system, 7);
+    QCOMPARE(component, 190);
+
+    router->getTarget(attitude(1, 1), system, component);
+    QCOMPARE(system, -1);
+    QCOMPARE(component, -1);
+
+    mavlink_message_t message;
+    mavlink_msg_param_request_list_pack(255, 0, &message, 3, 0);
+    router->getTarget(message, system, component);
+    QCOMPARE(system, 3);
+    QCOMPARE(component, 0);
+}
+
+void MAVLinkRouterTest::broadcast_test()
+{
+    mavlink_message_t message = attitude(1, 1);
+    QCOMPARE(router->forward(links[0], message, ownSystemId), 2);
+    QCOMPARE(router->sent.size(), 2);
+    QVERIFY(router->sent.at(0).link != links[0]);
+    QVERIFY(router->sent.at(1).link != links[0]);
+    // Forwarded unchanged, same sequence number and checksum
+    QCOMPARE(router->sent.at(0).frame, frame(message));
+
+    MAVLinkRouter::Statistics stats = router->getStatistics();
+    QCOMPARE(stats.broadcasts, Q_UINT64_C(1));
+    QCOMPARE(stats.frames, Q_UINT64_C(2));
+}
+
+void MAVLinkRouterTest::unicast_test()
+{
+    // System 1 lives behind link 0, system 2 behind link 1
+    router->forward(links[0], attitude(1, 1), ownSystemId);
+    router->forward(links[1], attitude(2, 1), ownSystemId);
+    router->sent.clear();
+
+    // A command from link 2 only goes to the link of its target
+    QCOMPARE(router->forward(links[2], command(200, 1, 0), ownSystemId), 1);
+    QCOMPARE(router->sent.size(), 1);
+    QCOMPARE(router->sent.at(0).link, (LinkInterface*)links[0]);
+
+    // Unknown targets and messages for this ground station stay here
+    QCOMPARE(router->forward(links[2], command(200, 9, 0), ownSystemId), 0);
+    QCOMPARE(router->forward(links[1], command(2, ownSystemId, 0), ownSystemId), 0);
+    // Never back to the link the message came from
+    QCOMPARE(router->forward(links[0], command(1, 1, 0), ownSystemId), 0);
+
+    MAVLinkRouter::Statistics stats = router->getStatistics();
+    QCOMPARE(stats.unicasts, Q_UINT64_C(1));
+    QCOMPARE(stats.unroutable, Q_UINT64_C(2));
+    QCOMPARE(stats.local, Q_UINT64_C(1));
+
+    bool found = false;
+    foreach (const MAVLinkRouter::Route& route, router->getRoutes())
+    {
+        if (route.systemId == 1 && route.componentId == 1)
+        {
+            found = true;
+            QCOMPARE(route.link, (LinkInterface*)links[0]);
+            QCOMPARE(route.forwarded, Q_UINT64_C(1));
+            QCOMPARE(route.forwardedBytes, (quint64)frame(command(200, 1, 0)).size());
+        }
+    }
+    QVERIFY(found);
+}
+
+void MAVLinkRouterTest::component_test()
+{
+    // System 1 has its autopilot on link 0 and a camera on link 1
+    router->forward(links[0], attitude(1, 1), ownSystemId);
+    router->forward(links[1], attitude(1, 100), ownSystemId);
+    router->sent.clear();
+
+    QCOMPARE(router->forward(links[2], command(200, 1, 100), ownSystemId), 1);
+    QCOMPARE(router->sent.at(0).link, (LinkInterface*)links[1]);
+
+    // Any component of the system: every link it was heard on, once each
+    router->sent.clear();
+    QCOMPARE(router->forward(links[2], command(200, 1, 0), ownSystemId), 2);
+}
+
+void MAVLinkRouterTest::removeLink_test()
+{
+    router->forward(links[0], attitude(1, 1), ownSystemId);
+    QCOMPARE(router->getRoutes().size(), 1);
+    router->removeLink(links[0]);
+    QCOMPARE(router->getRoutes().size(), 0);
+
+    router->sent.clear();
+    QCOMPARE(router->forward(links[1], attitude(2, 1), ownSystemId), 1);
+    QCOMPARE(router->sent.at(0).link, (LinkInterface*)links[2]);
+}
+
+void MAVLinkRouterTest::udpLoopback_test()
+{
+    // Two vehicles and one other ground station, each behind a UDP link of its own
+    MAVLinkProtocol protocol;
+    protocol.enableMultiplexing(true);
+    const quint16 ports[3] = {14611, 14612, 14613};
+    QUdpSocket peers[3];
+    UDPLink* udp[3];
+    for (int i = 0; i < 3; i++)
+    {
+        udp[i] = new UDPLink(QHostAddress::LocalHost, ports[i]);
+        QVERIFY(udp[i]->connect());
+        protocol.addLink(udp[i]);
+        QVERIFY(peers[i].bind(QHostAddress::LocalHost, 0));
+    }
+    const int gcs = (protocol.getSystemId() == 200) ? 201 : 200;
+
+    // Every peer sends once, so the links know where to send and the router where everyone lives
+    const int sysids[3] = {1, 2, gcs};
+    for (int i = 0; i < 3; i++)
+    {
+        peers[i].writeDatagram(frame(attitude(sysids[i], 1)), QHostAddress::LocalHost, ports[i]);
+        QTest::qWait(50);
+    }
+    QTest::qWait(200);
+    for (int i = 0; i < 3; i++)
+    {
+        while (peers[i].hasPendingDatagrams()) waitForDatagram(peers[i], 0);
+    }
+
+    // A broadcast of vehicle 1 reaches the other vehicle and the ground station
+    QByteArray bytes = frame(attitude(1, 1));
+    peers[0].writeDatagram(bytes, QHostAddress::LocalHost, ports[0]);
+    QCOMPARE(waitForDatagram(peers[1], 2000), bytes);
+    QCOMPARE(waitForDatagram(peers[2], 2000), bytes);
+
+    // A command for vehicle 1 only reaches vehicle 1
+    bytes = frame(command(gcs, 1, 1));
+    peers[2].writeDatagram(bytes, QHostAddress::LocalHost, ports[2]);
+    QCOMPARE(waitForDatagram(peers[0], 2000), bytes);
+    QCOMPARE(waitForDatagram(peers[1], 200), QByteArray());
+
+    MAVLinkRouter::Statistics stats = protocol.getRouterStatistics();
+    QCOMPARE(stats.unicasts, Q_UINT64_C(1));
+    QCOMPARE(stats.broadcasts, Q_UINT64_C(4));
+
+    protocol.enableMultiplexing(false);
+    for (int i = 0; i < 3; i++)
+    {
+        protocol.removeLink(udp[i]);
+        udp[i]->disconnect();
+        delete udp[i];
+    }
+}
+
+void MAVLinkRouterTest::udpComponents_test()
+{
+    // One vehicle with a component behind each of two links, and another ground station
+    MAVLinkProtocol protocol;
+    protocol.enableMultiplexing(true);
+    const quint16 ports[3] = {14614, 14615, 14616};
+    QUdpSocket peers[3];
+    UDPLink* udp[3];
+    for (int i = 0; i < 3; i++)
+    {
+        udp[i] = new UDPLink(QHostAddress::LocalHost, ports[i]);
+        QVERIFY(udp[i]->connect());
+        protocol.addLink(udp[i]);
+        QVERIFY(peers[i].bind(QHostAddress::LocalHost, 0));
+    }
+    const int gcs = (protocol.getSystemId() == 200) ? 201 : 200;
+
+    const int sysids[3] = {1, 1, gcs};
+    const int compids[3] = {1, 2, 1};
+    for (int i = 0; i < 3; i++)
+    {
+        peers[i].writeDatagram(frame(attitude(sysids[i], compids[i])), QHostAddress::LocalHost, ports[i]);
+        QTest::qWait(50);
+    }
+    QTest::qWait(200);
+    for (int i = 0; i < 3; i++)
+    {
+        while (peers[i].hasPendingDatagrams()) waitForDatagram(peers[i], 0);
+    }
+
+    // A command for component 2 only reaches the link of component 2, byte for byte
+    QByteArray bytes = frame(command(gcs, 1, 2));
+    peers[2].writeDatagram(bytes, QHostAddress::LocalHost, ports[2]);
+    QCOMPARE(waitForDatagram(peers[1], 2000), bytes);
+    QCOMPARE(waitForDatagram(peers[0], 200), QByteArray());
+
+    // A command for any component of the vehicle reaches both of its links
+    bytes = frame(command(gcs, 1, 0));
+    peers[2].writeDatagram(bytes, QHostAddress::LocalHost, ports[2]);
+    QCOMPARE(waitForDatagram(peers[0], 2000), bytes);
+    QCOMPARE(waitForDatagram(peers[1], 2000), bytes);
+
+    // Nobody gets a command for a vehicle that was never heard
+    bytes = frame(command(gcs, 7, 1));
+    peers[2].writeDatagram(bytes, QHostAddress::LocalHost, ports[2]);
+    QCOMPARE(waitForDatagram(peers[0], 200), QByteArray());
+    QCOMPARE(waitForDatagram(peers[1], 200), QByteArray());
+
+    MAVLinkRouter::Statistics stats = protocol.getRouterStatistics();
+    QCOMPARE(stats.unicasts, Q_UINT64_C(2));
+    QCOMPARE(stats.unroutable, Q_UINT64_C(1));
+
+    protocol.enableMultiplexing(false);
+    for (int i = 0; i < 3; i++)
+    {
+        protocol.removeLink(udp[i]);
+        udp[i]->disconnect();
+        delete udp[i];
+    }
+}
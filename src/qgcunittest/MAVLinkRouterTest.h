@@ -0,0 +1,67 @@
+#ifndef MAVLINKROUTERTEST_H
+#define MAVLINKROUTERTEST_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QUdpSocket>
+#include <QtTest/QtTest>
+
+#include "MAVLinkRouter.h"
+#include "MAVLinkProtocol.h"
+#include "SerialLink.h"
+#include "UDPLink.h"
+#include "AutoTest.h"
+
+/** @brief Router that records the frames instead of writing them */
+class RecordingRouter : public MAVLinkRouter
+{
+public:
+    struct Sent {
+        LinkInterface* link;
+        QByteArray frame;
+    };
+    QList<Sent> sent;
+
+protected:
+    void sendFrame(LinkInterface* link, quint8 msgid, const char* frame, int length)
+    {
+        Q_UNUSED(msgid);
+        Sent s;
+        s.link = link;
+        s.frame = QByteArray(frame, length);
+        sent.append(s);
+    }
+};
+
+class MAVLinkRouterTest : public QObject
+{
+    Q_OBJECT
+public:
+    MAVLinkRouterTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void target_test();
+    void broadcast_test();
+    void unicast_test();
+    void component_test();
+    void removeLink_test();
+    void udpLoopback_test();
+    void udpComponents_test();
+
+private:
+    /** @brief Wire format of a message */
+    static QByteArray frame(const mavlink_message_t& message);
+    /** @brief Process events until the socket received a datagram or the timeout passed */
+    static QByteArray waitForDatagram(QUdpSocket& socket, int timeout);
+
+    RecordingRouter* router;
+    SerialLink* links[3];
+};
+
+DECLARE_TEST(MAVLinkRouterTest)
+
+#endif // MAVLINKROUTERTEST_H
@@ -0,0 +1,184 @@
+#include "MapRipperTest.h"
+
+#include <QDir>
+#include <QFile>
+
+using namespace core;
+using namespace mapcontrol;
+
+MapRipperTest::MapRipperTest() :
+    server(NULL),
+    fetcher(NULL),
+    ripper(NULL)
+{
+}
+
+void MapRipperTest::initTestCase()
+{
+    oldCacheLocation = Cache::Instance()->CacheLocation();
+    cacheLocation = QDir::tempPath() + QString("/MapRipperTest%1/").arg(QCoreApplication::applicationPid());
+    manifest = cacheLocation + "MapRipper.ini";
+}
+
+void MapRipperTest::init()
+{
+    // A fresh tile database for every test
+    QFile::remove(cacheLocation + "Data.qmdb");
+    QFile::remove(manifest);
+    Cache::Instance()->setCacheLocation(cacheLocation);
+}
+
+void MapRipperTest::cleanup()
+{
+    delete ripper;
+    ripper = NULL;
+    delete fetcher;
+    fetcher = NULL;
+    delete server;
+    server = NULL;
+}
+
+void MapRipperTest::cleanupTestCase()
+{
+    Cache::Instance()->setCacheLocation(oldCacheLocation);
+    QFile::remove(cacheLocation + "Data.qmdb");
+    QFile::remove(manifest);
+    QDir().rmdir(cacheLocation);
+}
+
+MapRipper::Job MapRipperTest::makeJob(int zoom, int maxzoom)
+{
+    MapRipper::Job job;
+    job.type = MapType::OpenStreetMap;
+    job.area = internals::RectLatLng(47.40, 8.50, 0.03, 0.02);
+    job.zoom = zoom;
+    job.maxzoom = maxzoom;
+    return job;
+}
+
+int MapRipperTest::tileCount(const MapRipper::Job& job)
+{
+    int count = 0;
+    for (int zoom = job.zoom; zoom <= job.maxzoom; zoom++)
+    {
+        count += projection.GetAreaTileList(job.area, zoom, 0).count();
+    }
+    return count;
+}
+
+int MapRipperTest::uncachedCount(const MapRipper::Job& job)
+{
+    int count = 0;
+    for (int zoom = job.zoom; zoom <= job.maxzoom; zoom++)
+    {
+        QList<Point> tiles = projection.GetAreaTileList(job.area, zoom, 0);
+        count += tiles.count() - Cache::Instance()->ImageCache.GetCachedTiles(job.type, tiles, zoom).count();
+    }
+    return count;
+}
+
+void MapRipperTest::start(int delay, const MapRipper::Job& job)
+{
+    server = new TileServer(delay);
+    QVERIFY(server->getPort() != 0);
+    fetcher = new CachingTileFetcher(server->getPort());
+    fetcher->SetTimeout(2000);
+    ripper = new MapRipper(fetcher, &projection, job, manifest);
+    ripper->SetRateLimit(job.type, 0);
+}
+
+void MapRipperTest::download_test()
+{
+    MapRipper::Job job = makeJob(14, 16);
+    int total = tileCount(job);
+    QVERIFY(total > 10);
+    start(0, job);
+    ripper->start();
+    QVERIFY(ripper->wait(20000));
+
+    QCOMPARE(ripper->Downloaded(), total);
+    QCOMPARE(ripper->Skipped(), 0);
+    QCOMPARE(ripper->Failed(), 0);
+    QCOMPARE(server->getRequests().size(), total);
+    QCOMPARE(uncachedCount(job), 0);
+    // A finished job leaves no manifest behind
+    QVERIFY(!QFile::exists(manifest));
+}
+
+void MapRipperTest::skipCached_test()
+{
+    MapRipper::Job job = makeJob(15, 15);
+    QList<Point> tiles = projection.GetAreaTileList(job.area, job.zoom, 0);
+    for (int i = 0; i < tiles.count(); i += 2)
+    {
+        Cache::Instance()->ImageCache.PutImageToCache(QByteArray("cached"), job.type, tiles.at(i), job.zoom);
+    }
+    int cached = (tiles.count() + 1) / 2;
+
+    start(0, job);
+    ripper->start();
+    QVERIFY(ripper->wait(20000));
+
+    QCOMPARE(ripper->Skipped(), cached);
+    QCOMPARE(ripper->Downloaded(), tiles.count() - cached);
+    QCOMPARE(server->getRequests().size(), tiles.count() - cached);
+    QCOMPARE(uncachedCount(job), 0);
+}
+
+void MapRipperTest::resume_test()
+{
+    MapRipper::Job job = makeJob(14, 16);
+    int total = tileCount(job);
+    start(30, job);
+    ripper->start();
+    for (int wait = 0; wait < 400 && server->getRequests().size() < total / 2; wait++)
+    {
+        QTest::qWait(5);
+    }
+    ripper->Cancel();
+    QVERIFY(ripper->wait(5000));
+    int firstRun = server->getRequests().size();
+    QVERIFY(firstRun < total);
+
+    // The manifest points at the tiles not done yet
+    MapRipper::Job resumed;
+    QVERIFY(MapRipper::LoadJob(manifest, resumed));
+    QVERIFY(resumed.zoom >= job.zoom);
+    QCOMPARE(resumed.maxzoom, job.maxzoom);
+    QVERIFY(resumed.area == job.area);
+
+    delete ripper;
+    ripper = new MapRipper(fetcher, &projection, resumed, manifest);
+    ripper->SetRateLimit(job.type, 0);
+    ripper->start();
+    QVERIFY(ripper->wait(20000));
+
+    QCOMPARE(ripper->Failed(), 0);
+    QCOMPARE(uncachedCount(job), 0);
+    // Only the requests aborted by the cancel are sent twice
+    QVERIFY(server->getRequests().size() <= total + MapRipper::MAX_IN_FLIGHT);
+    QVERIFY(!QFile::exists(manifest));
+}
+
+void MapRipperTest::rateLimit_test()
+{
+    MapRipper::Job job = makeJob(15, 15);
+    int total = tileCount(job);
+    QVERIFY(total > 2);
+    start(0, job);
+    // One tile per second, the ripper waits for its second request
+    ripper->SetRateLimit(job.type, 1);
+    ripper->start();
+    for (int wait = 0; wait < 400 && server->getRequests().isEmpty(); wait++)
+    {
+        QTest::qWait(5);
+    }
+    QVERIFY(!server->getRequests().isEmpty());
+
+    // The wait for the next request ends with the cancel, the rest stays in the manifest
+    ripper->Cancel();
+    QVERIFY(ripper->wait(5000));
+    QVERIFY(server->getRequests().size() < total);
+    QVERIFY(ripper->Downloaded() < total);
+    QVERIFY(QFile::exists(manifest));
+}
@@ -0,0 +1,63 @@
+#ifndef MAPRIPPERTEST_H
+#define MAPRIPPERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "TileServer.h"
+#include "mapripper.h"
+#include "mercatorprojection.h"
+#include "cache.h"
+#include "AutoTest.h"
+
+/** @brief Fetcher that stores the tiles of the TileServer in the database cache */
+class CachingTileFetcher : public LocalTileFetcher
+{
+public:
+    CachingTileFetcher(quint16 port) : LocalTileFetcher(port) {}
+
+protected:
+    void Store(const core::MapType::Types& type, const core::Point& pos, const int& zoom, const QByteArray& data)
+    {
+        core::Cache::Instance()->ImageCache.PutImageToCache(data, type, pos, zoom);
+    }
+};
+
+class MapRipperTest : public QObject
+{
+    Q_OBJECT
+public:
+    MapRipperTest();
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void cleanupTestCase();
+
+    void download_test();
+    void skipCached_test();
+    void resume_test();
+    void rateLimit_test();
+
+private:
+    /** @brief Start a server, a fetcher and a ripper for the job */
+    void start(int delay, const mapcontrol::MapRipper::Job& job);
+    mapcontrol::MapRipper::Job makeJob(int zoom, int maxzoom);
+    /** @brief Tiles of the job at all its zoom levels */
+    int tileCount(const mapcontrol::MapRipper::Job& job);
+    /** @brief Tiles of the job not in the cache */
+    int uncachedCount(const mapcontrol::MapRipper::Job& job);
+
+    QString oldCacheLocation;
+    QString cacheLocation;
+    QString manifest;
+    projections::MercatorProjection projection;
+    TileServer* server;
+    CachingTileFetcher* fetcher;
+    mapcontrol::MapRipper* ripper;
+};
+
+DECLARE_TEST(MapRipperTest)
+
+#endif // MAPRIPPERTEST_H
@@ -0,0 +1,152 @@
+#include "MissionTransferBenchmark.h"
+
+#include "LinkManager.h"
+#include "UASWaypointManager.h"
+#include "Waypoint.h"
+
+namespace
+{
+const int SYSTEM_ID = 1;
+}
+
+MissionVehicleLink::MissionVehicleLink(int systemId) :
+    MAVLinkLoadLink(1, 1000),
+    systemId(systemId),
+    count(0)
+{
+}
+
+void MissionVehicleLink::writeBytes(const char* data, qint64 size)
+{
+    MAVLinkLoadLink::writeBytes(data, size);
+    // The ground station writes whole frames, so one channel serves all calls
+    const uint8_t channel = MAVLINK_COMM_2;
+    mavlink_message_t message;
+    mavlink_status_t status;
+    for (qint64 i = 0; i < size; i++)
+    {
+        if (mavlink_parse_char(channel, (uint8_t)data[i], &message, &status))
+        {
+            handle(message);
+        }
+    }
+}
+
+void MissionVehicleLink::handle(const mavlink_message_t& message)
+{
+    mavlink_message_t answer;
+    switch (message.msgid)
+    {
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+    {
+        count = mavlink_msg_mission_count_get_count(&message);
+        mission.clear();
+        mavlink_msg_mission_request_pack(systemId, MAV_COMP_ID_MISSIONPLANNER, &answer, message.sysid, message.compid, 0);
+        answers.append(answer);
+    }
+        break;
+    case MAVLINK_MSG_ID_MISSION_ITEM:
+    {
+        mavlink_mission_item_t item;
+        mavlink_msg_mission_item_decode(&message, &item);
+        if (item.seq == (uint16_t)mission.size())
+        {
+            mission.append(item);
+        }
+        if (mission.size() < count)
+        {
+            mavlink_msg_mission_request_pack(systemId, MAV_COMP_ID_MISSIONPLANNER, &answer, message.sysid, message.compid, mission.size());
+        }
+        else
+        {
+            mavlink_msg_mission_ack_pack(systemId, MAV_COMP_ID_MISSIONPLANNER, &answer, message.sysid, message.compid, MAV_MISSION_ACCEPTED);
+        }
+        answers.append(answer);
+    }
+        break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+        mavlink_msg_mission_count_pack(systemId, MAV_COMP_ID_MISSIONPLANNER, &answer, message.sysid, message.compid, mission.size());
+        answers.append(answer);
+        break;
+    case MAVLINK_MSG_ID_MISSION_REQUEST:
+    {
+        int seq = mavlink_msg_mission_request_get_seq(&message);
+        if (seq < mission.size())
+        {
+            mavlink_mission_item_t item = mission.at(seq);
+            item.target_system = message.sysid;
+            item.target_component = message.compid;
+            mavlink_msg_mission_item_encode(systemId, MAV_COMP_ID_MISSIONPLANNER, &answer, &item);
+            answers.append(answer);
+        }
+    }
+        break;
+    default:
+        break;
+    }
+}
+
+int MissionVehicleLink::deliver(UAS* uas)
+{
+    int delivered = 0;
+    // Answering can make the ground station write again
+    while (!answers.isEmpty())
+    {
+        uas->receiveMessage(this, answers.takeFirst());
+        delivered++;
+    }
+    return delivered;
+}
+
+MissionTransferBenchmark::MissionTransferBenchmark() :
+    protocol(NULL)
+{
+}
+
+void MissionTransferBenchmark::initTestCase()
+{
+    protocol = new MAVLinkProtocol();
+}
+
+void MissionTransferBenchmark::cleanupTestCase()
+{
+    delete protocol;
+    protocol = NULL;
+}
+
+void MissionTransferBenchmark::transfer_benchmark_data()
+{
+    QTest::addColumn<int>("waypoints");
+    QTest::newRow("10 waypoints") << 10;
+    QTest::newRow("50 waypoints") << 50;
+}
+
+/**
+ * One iteration writes the mission and, as after every write, reads it
+ * back. The waypoint manager pauses after each message it sends, which
+ * is most of the time measured here.
+ */
+void MissionTransferBenchmark::transfer_benchmark()
+{
+    QFETCH(int, waypoints);
+    UAS uas(protocol, SYSTEM_ID);
+    MissionVehicleLink vehicle(SYSTEM_ID);
+    // The UAS only writes to links the link manager knows
+    LinkManager::instance()->add(&vehicle);
+    uas.addLink(&vehicle);
+
+    UASWaypointManager* manager = uas.getWaypointManager();
+    for (int i = 0; i < waypoints; i++)
+    {
+        manager->addWaypointEditable(new Waypoint(i, 47.3977 + i * 0.0001, 8.5456, 50.0, 0.0, 0.0, 0.0, 0.0,
+                                                  true, i == 0, MAV_FRAME_GLOBAL_RELATIVE_ALT, MAV_CMD_NAV_WAYPOINT), false);
+    }
+
+    QBENCHMARK {
+        manager->writeWaypoints();
+        vehicle.deliver(&uas);
+    }
+
+    QCOMPARE(vehicle.getMissionCount(), waypoints);
+    QCOMPARE(manager->getWaypointViewOnlyList().size(), waypoints);
+}
@@ -0,0 +1,62 @@
+#ifndef MISSIONTRANSFERBENCHMARK_H
+#define MISSIONTRANSFERBENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QtTest/QtTest>
+
+#include "MAVLinkProtocol.h"
+#include "MAVLinkLoadLink.h"
+#include "UAS.h"
+#include "AutoTest.h"
+
+/**
+ * @brief Vehicle side of the mission protocol on a simulated link
+ *
+ * Decodes what the ground station writes and queues the answers of an
+ * autopilot, deliver() hands them to the UAS. Nothing is paced or lost,
+ * so a transfer only takes the time the ground station needs.
+ */
+class MissionVehicleLink : public MAVLinkLoadLink
+{
+public:
+    explicit MissionVehicleLink(int systemId);
+
+    /** @brief Always writable and not shaped by the transmit scheduler */
+    bool isConnected() { return true; }
+    qint64 getNominalDataRate() { return 0; }
+    void writeBytes(const char* data, qint64 size);
+
+    /** @brief Deliver the answers until the ground station stops asking, returns their number */
+    int deliver(UAS* uas);
+    int getMissionCount() const { return mission.size(); }
+
+protected:
+    void handle(const mavlink_message_t& message);
+
+    int systemId;
+    int count;                              ///< Items of the mission being written
+    QList<mavlink_mission_item_t> mission;  ///< Mission stored on the vehicle
+    QList<mavlink_message_t> answers;
+};
+
+/** @brief Writing a mission with UASWaypointManager and reading it back */
+class MissionTransferBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    MissionTransferBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void transfer_benchmark_data();
+    void transfer_benchmark();
+
+private:
+    MAVLinkProtocol* protocol;
+};
+
+DECLARE_TEST(MissionTransferBenchmark)
+#endif // MISSIONTRANSFERBENCHMARK_H
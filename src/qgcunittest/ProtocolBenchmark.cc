@@ -0,0 +1,161 @@
+#include "ProtocolBenchmark.h"
+
+#include <string.h>
+
+#include "MAVLinkLoadLink.h"
+#include "MAVLinkDecoder.h"
+#include "MAVLinkDecodeWorker.h"
+#include "UASManager.h"
+
+namespace
+{
+/** @brief Messages handed to the protocol per iteration */
+const int MESSAGES = 10000;
+
+/** @brief Gives access to the MAVLINK_MESSAGE_INFO based decoder the generated visitors replaced */
+class GenericDecoder : public MAVLinkDecoder
+{
+public:
+    GenericDecoder(MAVLinkProtocol* protocol) : MAVLinkDecoder(protocol) {}
+
+    void decode(mavlink_message_t message, bool generic)
+    {
+        if (!generic)
+        {
+            receiveMessage(NULL, message);
+            return;
+        }
+        memcpy(receivedMessages+message.msgid, &message, sizeof(mavlink_message_t));
+        decodeFieldsGeneric(&message);
+    }
+};
+}
+
+ProtocolBenchmark::ProtocolBenchmark() :
+    protocol(NULL)
+{
+    qRegisterMetaType<LinkInterface*>("LinkInterface*");
+}
+
+void ProtocolBenchmark::initTestCase()
+{
+    protocol = new MAVLinkProtocol();
+}
+
+void ProtocolBenchmark::cleanupTestCase()
+{
+    // The vehicles created from the heartbeats refer to the protocol
+    foreach (UASInterface* uas, UASManager::instance()->getUASList())
+    {
+        UASManager::instance()->removeUAS(uas);
+        delete uas;
+    }
+    delete protocol;
+    protocol = NULL;
+}
+
+QList<mavlink_message_t> ProtocolBenchmark::parse(const QByteArray& block)
+{
+    const uint8_t channel = MAVLINK_COMM_1;
+    memset(mavlink_get_channel_status(channel), 0, sizeof(mavlink_status_t));
+    QList<mavlink_message_t> messages;
+    mavlink_message_t message;
+    mavlink_status_t status;
+    for (int i = 0; i < block.size(); i++)
+    {
+        if (mavlink_parse_char(channel, (uint8_t)block.at(i), &message, &status))
+        {
+            messages.append(message);
+        }
+    }
+    return messages;
+}
+
+void ProtocolBenchmark::generate_benchmark()
+{
+    // Ten vehicles, the mix of a busy field, the load the other benchmarks are fed with
+    MAVLinkLoadLink link(10, 1000000);
+    QByteArray block;
+    block.reserve(MESSAGES * 40);
+    QBENCHMARK {
+        block.clear();
+        link.generate(block, MESSAGES);
+    }
+    QVERIFY(!block.isEmpty());
+}
+
+void ProtocolBenchmark::receiveBytes_benchmark_data()
+{
+    QTest::addColumn<int>("vehicles");
+    QTest::newRow("1 vehicle") << 1;
+    QTest::newRow("10 vehicles") << 10;
+}
+
+void ProtocolBenchmark::receiveBytes_benchmark()
+{
+    QFETCH(int, vehicles);
+    // The generator is the link the bytes arrive on as well
+    MAVLinkLoadLink link(vehicles, 50000);
+    QByteArray bytes;
+    QCOMPARE(link.generate(bytes, MESSAGES), MESSAGES);
+
+    // The first pass creates the vehicles from their heartbeats, like a live link
+    protocol->receiveBytes(&link, bytes);
+    QVERIFY(UASManager::instance()->getUASForId(vehicles) != NULL);
+
+    QBENCHMARK {
+        protocol->receiveBytes(&link, bytes);
+    }
+}
+
+void ProtocolBenchmark::decodeFields_benchmark_data()
+{
+    QTest::addColumn<bool>("generic");
+    QTest::newRow("MESSAGE_INFO") << true;
+    QTest::newRow("generated visitor") << false;
+}
+
+void ProtocolBenchmark::decodeFields_benchmark()
+{
+    QFETCH(bool, generic);
+    MAVLinkLoadLink link(1, 50000);
+    QByteArray bytes;
+    link.generate(bytes, 1000);
+    QList<mavlink_message_t> messages = parse(bytes);
+    QCOMPARE(messages.size(), 1000);
+
+    // Nothing is connected to the decoder, only the decoding is measured
+    GenericDecoder decoder(protocol);
+    QBENCHMARK {
+        foreach (const mavlink_message_t& message, messages)
+        {
+            decoder.decode(message, generic);
+        }
+    }
+}
+
+void ProtocolBenchmark::decodeWorker_benchmark()
+{
+    // Fewer messages than the worker queues, nothing is dropped while the benchmark waits
+    const int messages = 2000;
+    MAVLinkLoadLink link(1, 50000);
+    QByteArray bytes;
+    QCOMPARE(link.generate(bytes, messages), messages);
+
+    // From the GUI thread to the decoder thread and back, as a blocked GUI takes them
+    MAVLinkDecodeWorker worker(&link, protocol);
+    int coalesced = 0;
+    int lost = 0;
+    int taken = 0;
+    QBENCHMARK {
+        quint64 target = worker.getStatistics().messages + messages;
+        QMetaObject::invokeMethod(&worker, "receiveBytes", Qt::QueuedConnection,
+                                  Q_ARG(LinkInterface*, &link), Q_ARG(QByteArray, bytes));
+        while (worker.getStatistics().messages < target)
+        {
+            QThread::yieldCurrentThread();
+        }
+        taken = worker.takeMessages(coalesced, lost).size();
+    }
+    QVERIFY(taken > 0);
+}
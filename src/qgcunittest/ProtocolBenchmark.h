@@ -0,0 +1,43 @@
+#ifndef PROTOCOLBENCHMARK_H
+#define PROTOCOLBENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QtTest/QtTest>
+
+#include "MAVLinkProtocol.h"
+#include "AutoTest.h"
+
+/**
+ * @brief Receive path of the telemetry: parsing and dispatch in
+ *        MAVLinkProtocol::receiveBytes() and the field extraction of
+ *        MAVLinkDecoder, generated visitors against the MAVLINK_MESSAGE_INFO
+ *        walk, and the handover through the decoder thread, fed by the
+ *        load generator link, whose own cost is measured as well
+ */
+class ProtocolBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    ProtocolBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void generate_benchmark();
+    void receiveBytes_benchmark_data();
+    void receiveBytes_benchmark();
+    void decodeFields_benchmark_data();
+    void decodeFields_benchmark();
+    void decodeWorker_benchmark();
+
+private:
+    /** @brief Decode the frames of a block */
+    static QList<mavlink_message_t> parse(const QByteArray& block);
+
+    MAVLinkProtocol* protocol;
+};
+
+DECLARE_TEST(ProtocolBenchmark)
+#endif // PROTOCOLBENCHMARK_H
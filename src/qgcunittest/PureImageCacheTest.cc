@@ -0,0 +1,235 @@
+#include "PureImageCacheTest.h"
+
+#include <QDir>
+#include <QFile>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+using namespace core;
+
+PureImageCacheTest::PureImageCacheTest()
+{
+}
+
+void PureImageCacheTest::initTestCase()
+{
+    dir = QDir::tempPath() + QString("/PureImageCacheTest%1/").arg(QCoreApplication::applicationPid());
+    QVERIFY(QDir().mkpath(dir));
+}
+
+void PureImageCacheTest::cleanup()
+{
+    foreach (const QString& file, QDir(dir).entryList(QDir::Files))
+    {
+        QFile::remove(dir + file);
+    }
+}
+
+void PureImageCacheTest::cleanupTestCase()
+{
+    QDir().rmdir(dir);
+}
+
+QByteArray PureImageCacheTest::tileData(MapType::Types type, int zoom, int x, int y)
+{
+    return QString("%1/%2/%3/%4").arg((int)type).arg(zoom).arg(x).arg(y).toLatin1();
+}
+
+bool PureImageCacheTest::addTiles(const QString& file, MapType::Types type, int zoom, int count, int firstX)
+{
+    if (!QFile::exists(file) && !PureImageCache::CreateEmptyDB(file)) return false;
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "addTiles");
+        db.setDatabaseName(file);
+        if (db.open())
+        {
+            db.transaction();
+            QSqlQuery tiles(db);
+            tiles.prepare("INSERT INTO Tiles(X, Y, Zoom, Type, Date) VALUES(?, ?, ?, ?, ?)");
+            QSqlQuery data(db);
+            data.prepare("INSERT INTO TilesData(id, Tile) VALUES(?, ?)");
+            ok = true;
+            for (int i = 0; ok && i < count; i++)
+            {
+                // Rows of 1000 tiles
+                int x = firstX + i % 1000;
+                int y = i / 1000;
+                tiles.addBindValue(x);
+                tiles.addBindValue(y);
+                tiles.addBindValue(zoom);
+                tiles.addBindValue((int)type);
+                tiles.addBindValue(QString("date"));
+                ok = tiles.exec();
+                data.addBindValue(tiles.lastInsertId());
+                data.addBindValue(tileData(type, zoom, x, y));
+                ok = ok && data.exec();
+            }
+            ok = db.commit() && ok;
+            tiles.clear();
+            data.clear();
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("addTiles");
+    return ok;
+}
+
+int PureImageCacheTest::tileCount(const QString& file)
+{
+    int count = -1;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "tileCount");
+        db.setDatabaseName(file);
+        if (db.open())
+        {
+            QSqlQuery query(db);
+            if (query.exec("SELECT COUNT(*) FROM Tiles t JOIN TilesData d ON d.id = t.id") && query.next())
+            {
+                count = query.value(0).toInt();
+            }
+            query.clear();
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("tileCount");
+    return count;
+}
+
+bool PureImageCacheTest::createMBTiles(const QString& file, int zoom)
+{
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "createMBTiles");
+        db.setDatabaseName(file);
+        if (db.open())
+        {
+            QSqlQuery query(db);
+            ok = query.exec("CREATE TABLE metadata (name TEXT, value TEXT)")
+                    && query.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)")
+                    && query.exec("INSERT INTO metadata VALUES ('name', 'test')")
+                    && query.exec("INSERT INTO metadata VALUES ('format', 'png')");
+            db.transaction();
+            query.prepare("INSERT INTO tiles VALUES (?, ?, ?, ?)");
+            for (int x = 0; ok && x < (1 << zoom); x++)
+            {
+                // The top row is missing, the pack only covers part of the world
+                for (int y = 1; ok && y < (1 << zoom); y++)
+                {
+                    query.addBindValue(zoom);
+                    query.addBindValue(x);
+                    query.addBindValue((1 << zoom) - 1 - y);
+                    query.addBindValue(tileData(MapType::OpenStreetMap, zoom, x, y));
+                    ok = query.exec();
+                }
+            }
+            ok = db.commit() && ok;
+            query.clear();
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("createMBTiles");
+    return ok;
+}
+
+void PureImageCacheTest::export_test()
+{
+    QString source = dir + "source.qmdb";
+    QString dest = dir + "dest.qmdb";
+    QVERIFY(addTiles(source, MapType::GoogleSatellite, 10, 500));
+    QVERIFY(addTiles(source, MapType::GoogleLabels, 10, 100));
+    // The destination has some of the tiles already
+    QVERIFY(addTiles(dest, MapType::GoogleSatellite, 10, 50, 450));
+
+    QVERIFY(PureImageCache::ExportMapDataToDB(source, dest));
+    QCOMPARE(tileCount(dest), 600);
+
+    // Tiles and data stay together
+    QVERIFY(QFile::rename(dest, dir + "Data.qmdb"));
+    PureImageCache cache;
+    cache.setGtileCache(dir);
+    QCOMPARE(cache.GetImageFromCache(MapType::GoogleSatellite, Point(7, 0), 10), tileData(MapType::GoogleSatellite, 10, 7, 0));
+    QCOMPARE(cache.GetImageFromCache(MapType::GoogleLabels, Point(99, 0), 10), tileData(MapType::GoogleLabels, 10, 99, 0));
+    QCOMPARE(cache.GetImageFromCache(MapType::GoogleSatellite, Point(499, 0), 10), tileData(MapType::GoogleSatellite, 10, 499, 0));
+
+    // Nothing new the second time
+    QVERIFY(PureImageCache::ExportMapDataToDB(source, dir + "Data.qmdb"));
+    QCOMPARE(tileCount(dir + "Data.qmdb"), 600);
+    QVERIFY(!PureImageCache::ExportMapDataToDB(dir + "missing.qmdb", dir + "Data.qmdb"));
+}
+
+void PureImageCacheTest::exportIndex_test()
+{
+    // New databases are indexed on the tile position
+    QString file = dir + "index.qmdb";
+    QVERIFY(PureImageCache::CreateEmptyDB(file));
+    bool indexed = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "index");
+        db.setDatabaseName(file);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec("SELECT name FROM sqlite_master WHERE type='index' AND name='IndexOfTiles'"));
+        indexed = query.next();
+        query.clear();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("index");
+    QVERIFY(indexed);
+}
+
+void PureImageCacheTest::mbtiles_test()
+{
+    QString file = dir + "pack.mbtiles";
+    QVERIFY(createMBTiles(file, 3));
+
+    MBTilesCache pack;
+    QVERIFY(!pack.IsOpen());
+    QVERIFY(pack.Open(file, MapType::OpenStreetMap));
+    QVERIFY(pack.Serves(MapType::OpenStreetMap));
+    QVERIFY(!pack.Serves(MapType::GoogleMap));
+    QCOMPARE(pack.Metadata().value("name"), QString("test"));
+
+    // Rows are flipped from TMS to the XYZ numbering of the map
+    QCOMPARE(pack.GetImageFromCache(MapType::OpenStreetMap, Point(2, 5), 3), tileData(MapType::OpenStreetMap, 3, 2, 5));
+    QVERIFY(pack.GetImageFromCache(MapType::OpenStreetMap, Point(2, 0), 3).isEmpty());
+    QVERIFY(pack.GetImageFromCache(MapType::OpenStreetMap, Point(2, 5), 4).isEmpty());
+    QVERIFY(pack.GetImageFromCache(MapType::GoogleMap, Point(2, 5), 3).isEmpty());
+
+    // Every thread reads through its own connection
+    MBTilesReader first(&pack, 3);
+    MBTilesReader second(&pack, 3);
+    first.start();
+    second.start();
+    QVERIFY(first.wait(5000));
+    QVERIFY(second.wait(5000));
+    QCOMPARE(first.found, 8 * 7);
+    QCOMPARE(second.found, 8 * 7);
+
+    pack.Close();
+    QVERIFY(!pack.IsOpen());
+    QVERIFY(pack.GetImageFromCache(MapType::OpenStreetMap, Point(2, 5), 3).isEmpty());
+}
+
+void PureImageCacheTest::mbtilesInvalid_test()
+{
+    MBTilesCache pack;
+    QVERIFY(!pack.Open(dir + "missing.mbtiles", MapType::OpenStreetMap));
+    // A tile cache is not a pack
+    QVERIFY(PureImageCache::CreateEmptyDB(dir + "cache.qmdb"));
+    QVERIFY(!pack.Open(dir + "cache.qmdb", MapType::OpenStreetMap));
+    QVERIFY(!pack.IsOpen());
+}
+
+void PureImageCacheTest::export_test()
+{
+    // The first row is in both, it is not imported twice
+    const int count = 10000;
+    QString source = dir + "office.qmdb";
+    QString dest = dir + "field.qmdb";
+    QVERIFY(addTiles(source, MapType::GoogleSatellite, 17, count));
+    QVERIFY(addTiles(dest, MapType::GoogleSatellite, 17, 1000));
+
+    QVERIFY(PureImageCache::ExportMapDataToDB(source, dest));
+    QCOMPARE(tileCount(dest), count);
+}
@@ -0,0 +1,61 @@
+#ifndef PUREIMAGECACHETEST_H
+#define PUREIMAGECACHETEST_H
+
+#include <QObject>
+#include <QThread>
+#include <QtTest/QtTest>
+
+#include "pureimagecache.h"
+#include "mbtilescache.h"
+#include "AutoTest.h"
+
+/** @brief Reads tiles of an MBTiles pack in its own thread */
+class MBTilesReader : public QThread
+{
+public:
+    MBTilesReader(core::MBTilesCache* pack, int zoom) : pack(pack), zoom(zoom), found(0) {}
+    void run()
+    {
+        for (int x = 0; x < (1 << zoom); x++)
+        {
+            for (int y = 0; y < (1 << zoom); y++)
+            {
+                if (!pack->GetImageFromCache(core::MapType::OpenStreetMap, core::Point(x, y), zoom).isEmpty()) found++;
+            }
+        }
+    }
+    core::MBTilesCache* pack;
+    int zoom;
+    int found;
+};
+
+class PureImageCacheTest : public QObject
+{
+    Q_OBJECT
+public:
+    PureImageCacheTest();
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void cleanupTestCase();
+
+    void export_test();
+    void exportIndex_test();
+    void mbtiles_test();
+    void mbtilesInvalid_test();
+    void export_test();
+
+private:
+    /** @brief Add tiles to a cache database in one transaction, their data is "type/zoom/x/y" */
+    static bool addTiles(const QString& file, core::MapType::Types type, int zoom, int count, int firstX = 0);
+    static int tileCount(const QString& file);
+    static QByteArray tileData(core::MapType::Types type, int zoom, int x, int y);
+    static bool createMBTiles(const QString& file, int zoom);
+
+    QString dir;
+};
+
+DECLARE_TEST(PureImageCacheTest)
+
+#endif // PUREIMAGECACHETEST_H
@@ -0,0 +1,114 @@
+#include "QGCHilBridgeTest.h"
+#include "QGCFlightGearLink.h"
+
+#define STANDIN_PORT 49555
+
+QGCHilBridgeTest::QGCHilBridgeTest()
+{
+}
+
+void QGCHilBridgeTest::parseGenericLine_test()
+{
+    QByteArray line = HilStandInSimulator::createLine(0.0);
+    QGCHilState state;
+    QVERIFY(QGCFlightGearLink::parseGenericLine(line.constData(), line.size(), state));
+    QVERIFY(qAbs(state.lat - 47.4589) < 1e-9);
+    QVERIFY(qAbs(state.lon - 8.548) < 1e-9);
+    QCOMPARE(state.alt, 500.0);
+    QVERIFY(qAbs(state.roll - 0.3f) < 1e-6);
+    QVERIFY(qAbs(state.zacc + 9.81f) < 1e-5);
+    QVERIFY(qAbs(state.vy - 31.4f) < 1e-5);
+    QCOMPARE(state.fields_updated, (quint16)0);
+
+    // Exponents and signs
+    QByteArray exponent("1\t-1.5e1\t+2E-2\t0\t0\t0\t0\t0\t0\t0\t0\t0\t0\t0\t0\t0\t0");
+    QVERIFY(QGCFlightGearLink::parseGenericLine(exponent.constData(), exponent.size(), state));
+    QCOMPARE(state.lat, -15.0);
+    QVERIFY(qAbs(state.lon - 0.02) < 1e-12);
+
+    // One field missing
+    QByteArray shortLine = line.left(line.lastIndexOf('\t'));
+    QVERIFY(!QGCFlightGearLink::parseGenericLine(shortLine.constData(), shortLine.size(), state));
+    // Garbage
+    QByteArray garbage("DATA@\x01\x02\x03");
+    QVERIFY(!QGCFlightGearLink::parseGenericLine(garbage.constData(), garbage.size(), state));
+}
+
+void QGCHilBridgeTest::interpolate_test()
+{
+    QGCHilState a;
+    a.timeUs = 1000;
+    a.roll = 0.0f;
+    a.yaw = 3.0f;
+    a.lat = 47.0;
+    a.vx = 10.0f;
+    QGCHilState b = a;
+    b.timeUs = 2000;
+    b.roll = 0.2f;
+    b.yaw = -3.0f;
+    b.lat = 47.001;
+    b.vx = 20.0f;
+    b.fields_updated = 0x1ff;
+
+    QGCHilState mid = QGCHilBridge::interpolate(a, b, 1500);
+    QCOMPARE(mid.timeUs, (quint64)1500);
+    QVERIFY(qAbs(mid.roll - 0.1f) < 1e-6);
+    QVERIFY(qAbs(mid.vx - 15.0f) < 1e-5);
+    QVERIFY(qAbs(mid.lat - 47.0005) < 1e-12);
+    // Yaw takes the short way across +-pi, not through zero
+    QVERIFY(qAbs(mid.yaw) > 3.1f);
+    QCOMPARE(mid.fields_updated, (quint16)0x1ff);
+
+    // Outside of the interval the frames are held, never extrapolated
+    QCOMPARE(QGCHilBridge::interpolate(a, b, 500).roll, a.roll);
+    QCOMPARE(QGCHilBridge::interpolate(a, b, 2500).roll, b.roll);
+}
+
+void QGCHilBridgeTest::histogram_test()
+{
+    QGCHilBridge::Histogram histogram;
+    histogram.add(10);
+    histogram.add(120);
+    histogram.add(120);
+    histogram.add(1000000);
+    QCOMPARE(histogram.count, (quint64)4);
+    QCOMPARE(histogram.buckets[0], (quint64)1);
+    QCOMPARE(histogram.buckets[2], (quint64)2);
+    QCOMPARE(histogram.buckets[QGCHilBridge::Histogram::BUCKETS - 1], (quint64)1);
+    QCOMPARE(histogram.maxUs, (quint64)1000000);
+}
+
+/**
+ * Runs the bridge at 200 Hz against the stand-in simulator at 50 Hz for two
+ * seconds, the jitter itself is measured by HilBridgeBenchmark.
+ */
+void QGCHilBridgeTest::fixedRate_test()
+{
+    RecordingHilBridge bridge;
+    bridge.setRate(200);
+    QVERIFY(bridge.open(QHostAddress::LocalHost, STANDIN_PORT));
+
+    HilStandInSimulator simulator(STANDIN_PORT, 50);
+    simulator.start();
+    QTest::qWait(2000);
+    simulator.stop();
+    bridge.close();
+
+    QGCHilBridge::Statistics stats = bridge.getStatistics();
+
+    // Every datagram the simulator sent on localhost has been parsed
+    QVERIFY(stats.frames > 0);
+    QVERIFY(stats.frames + 2 >= (quint64)simulator.getSent());
+    QCOMPARE(stats.rejected, (quint64)0);
+    // 200 Hz for two seconds, regardless of the 50 Hz input
+    QVERIFY(stats.ticks >= 360 && stats.ticks <= 440);
+    // Recording instead of sending, every tick counts as written
+    QCOMPARE(stats.deferred, (quint64)0);
+    QCOMPARE(stats.jitter.count, stats.ticks);
+    QVERIFY(stats.latency.count > 0);
+    QVERIFY(bridge.published > 300);
+    // Interpolated between the simulator frames, the bridge runs four times faster
+    QVERIFY(stats.held < stats.ticks / 4);
+
+    QCOMPARE(stats.frameIntervalUs > 15000 && stats.frameIntervalUs < 25000, true);
+}
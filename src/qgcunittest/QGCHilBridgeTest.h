@@ -0,0 +1,24 @@
+#ifndef QGCHILBRIDGETEST_H
+#define QGCHILBRIDGETEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "HilStandIn.h"
+#include "AutoTest.h"
+
+class QGCHilBridgeTest : public QObject
+{
+    Q_OBJECT
+public:
+    QGCHilBridgeTest();
+
+private slots:
+    void parseGenericLine_test();
+    void interpolate_test();
+    void histogram_test();
+    void fixedRate_test();
+};
+
+DECLARE_TEST(QGCHilBridgeTest)
+#endif // QGCHILBRIDGETEST_H
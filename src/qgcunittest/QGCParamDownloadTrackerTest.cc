@@ -0,0 +1,221 @@
+#include "QGCParamDownloadTrackerTest.h"
+
+namespace
+{
+/**
+ * The vehicle end of a 57600 baud radio which loses 10% of the frames in
+ * each direction. It streams its whole list once, then answers every
+ * PARAM_REQUEST_READ that gets through. Times are in milliseconds.
+ */
+class SimulatedParamVehicle
+{
+public:
+    SimulatedParamVehicle(int count) :
+        count(count),
+        now(0.0)
+    {
+    }
+
+    /** @brief Indices of the list stream that arrived, in order, and the time each arrived */
+    QList<QPair<int, double> > streamList()
+    {
+        QList<QPair<int, double> > arrived;
+        for (int index = 0; index < count; ++index)
+        {
+            now += VALUE_FRAME_MS;
+            if (!lost()) arrived.append(qMakePair(index, now));
+        }
+        return arrived;
+    }
+
+    /** @brief Send one PARAM_REQUEST_READ, true and the arrival time if the answer came back */
+    bool request(int index, double& arrival)
+    {
+        Q_ASSERT(index >= 0 && index < count);
+        now += REQUEST_FRAME_MS;
+        if (lost()) return false;
+        now += VALUE_FRAME_MS;
+        if (lost()) return false;
+        arrival = now;
+        return true;
+    }
+
+    /** @brief Let time pass without traffic */
+    void waitUntil(double time) { now = qMax(now, time); }
+
+    static const double VALUE_FRAME_MS;
+    static const double REQUEST_FRAME_MS;
+
+    const int count;
+    double now;
+
+protected:
+    bool lost() const { return qrand() < 0.1 * RAND_MAX; }
+};
+
+// 10 bits per byte, header and checksum of 8 bytes around the payload
+const double SimulatedParamVehicle::VALUE_FRAME_MS = (6 + 25 + 2) / 5.76;     // PARAM_VALUE
+const double SimulatedParamVehicle::REQUEST_FRAME_MS = (6 + 20 + 2) / 5.76;   // PARAM_REQUEST_READ
+}
+
+QGCParamDownloadTrackerTest::QGCParamDownloadTrackerTest()
+{
+}
+
+void QGCParamDownloadTrackerTest::markReceived_test()
+{
+    QGCParamDownloadTracker tracker;
+    QVERIFY(!tracker.isCountKnown(1));
+    // Unknown component, nothing to mark
+    QVERIFY(!tracker.markReceived(1, 0));
+
+    tracker.setCount(1, 10);
+    QVERIFY(tracker.isCountKnown(1));
+    QCOMPARE(tracker.getCount(1), 10);
+    QCOMPARE(tracker.getMissingCount(1), 10);
+
+    QVERIFY(tracker.markReceived(1, 0));
+    QVERIFY(tracker.isReceived(1, 0));
+    // Duplicates and out of range indices do not change the count
+    QVERIFY(!tracker.markReceived(1, 0));
+    QVERIFY(!tracker.markReceived(1, 10));
+    QVERIFY(!tracker.markReceived(1, -1));
+    QCOMPARE(tracker.getMissingCount(1), 9);
+
+    tracker.setCount(2, 5);
+    QCOMPARE(tracker.getMissingCount(), 14);
+
+    // The first parameter of a list announces its size
+    QVERIFY(tracker.addListParameter(3, 4, 2));
+    QVERIFY(!tracker.addListParameter(3, 8, 3));
+    QCOMPARE(tracker.getCount(3), 4);
+    QCOMPARE(tracker.getMissingCount(3), 2);
+
+    tracker.clear();
+    QVERIFY(!tracker.isCountKnown(1));
+}
+
+void QGCParamDownloadTrackerTest::missingRanges_test()
+{
+    QGCParamDownloadTracker tracker;
+    tracker.setCount(1, 10);
+    QList<QGCParamDownloadTracker::Range> ranges = tracker.getMissingRanges(1);
+    QCOMPARE(ranges.size(), 1);
+    QCOMPARE(ranges.at(0).first, 0);
+    QCOMPARE(ranges.at(0).last, 9);
+
+    // Received: 0, 3, 4, 9 -> missing 1-2, 5-8
+    tracker.markReceived(1, 0);
+    tracker.markReceived(1, 3);
+    tracker.markReceived(1, 4);
+    tracker.markReceived(1, 9);
+    ranges = tracker.getMissingRanges(1);
+    QCOMPARE(ranges.size(), 2);
+    QCOMPARE(ranges.at(0).first, 1);
+    QCOMPARE(ranges.at(0).last, 2);
+    QCOMPARE(ranges.at(1).first, 5);
+    QCOMPARE(ranges.at(1).last, 8);
+    QCOMPARE(ranges.at(1).count(), 4);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        tracker.markReceived(1, i);
+    }
+    QVERIFY(tracker.getMissingRanges(1).isEmpty());
+}
+
+void QGCParamDownloadTrackerTest::missingIndices_test()
+{
+    QGCParamDownloadTracker tracker;
+    tracker.setCount(1, 20);
+    for (int i = 0; i < 20; i += 2)
+    {
+        tracker.markReceived(1, i);
+    }
+    QList<int> indices = tracker.getMissingIndices(1, 5);
+    QCOMPARE(indices.size(), 5);
+    QCOMPARE(indices.at(0), 1);
+    QCOMPARE(indices.at(4), 9);
+    QCOMPARE(tracker.getMissingIndices(1, 100).size(), 10);
+
+    // Up to the burst size per component
+    tracker.setCount(2, 3);
+    QList<QPair<int, int> > requests = tracker.getRetransmissionRequests(5);
+    QCOMPARE(requests.size(), 8);
+    QCOMPARE(requests.at(0), qMakePair(1, 1));
+    QCOMPARE(requests.at(4), qMakePair(1, 9));
+    QCOMPARE(requests.at(5), qMakePair(2, 0));
+    QCOMPARE(requests.at(7), qMakePair(2, 2));
+}
+
+/**
+ * Downloads 800 parameters from a simulated vehicle over a lossy radio. The
+ * ground side is what QGCParamWidget does with the tracker: every received
+ * PARAM_VALUE goes to addListParameter(), and the retransmission guard fires
+ * 350 ms after the last parameter and requests getRetransmissionRequests(5).
+ */
+void QGCParamDownloadTrackerTest::simulatedLossDownload_test()
+{
+    const int paramCount = 800;
+    const int component = 1;
+    const double retransmissionTimeout = 350.0;
+    const int burstSize = 5;
+
+    qsrand(42);
+    SimulatedParamVehicle vehicle(paramCount);
+    QGCParamDownloadTracker tracker;
+
+    // Initial stream of the whole list
+    double lastReceived = 0.0;
+    QList<QPair<int, double> > stream = vehicle.streamList();
+    for (int i = 0; i < stream.size(); ++i)
+    {
+        bool first = tracker.addListParameter(component, paramCount, stream.at(i).first);
+        QCOMPARE(first, i == 0);
+        lastReceived = stream.at(i).second;
+    }
+    const int lostInStream = paramCount - stream.size();
+    QVERIFY(lostInStream > 0);
+    QCOMPARE(tracker.getMissingCount(), lostInStream);
+
+    // Retransmission guard ticks
+    int requests = 0;
+    int rounds = 0;
+    while (tracker.getMissingCount() > 0 && rounds < 1000)
+    {
+        vehicle.waitUntil(lastReceived + retransmissionTimeout);
+        rounds++;
+        QList<QPair<int, int> > burst = tracker.getRetransmissionRequests(burstSize);
+        QVERIFY(!burst.isEmpty());
+        QVERIFY(burst.size() <= burstSize);
+        for (int i = 0; i < burst.size(); ++i)
+        {
+            QCOMPARE(burst.at(i).first, component);
+            // Only indices still missing are requested
+            QVERIFY(!tracker.isReceived(component, burst.at(i).second));
+            requests++;
+            double arrival;
+            if (vehicle.request(burst.at(i).second, arrival))
+            {
+                QVERIFY(!tracker.addListParameter(component, paramCount, burst.at(i).second));
+                lastReceived = arrival;
+            }
+        }
+    }
+
+    QCOMPARE(tracker.getMissingCount(), 0);
+    QVERIFY(tracker.getRetransmissionRequests(burstSize).isEmpty());
+
+    const double valueFrameMs = SimulatedParamVehicle::VALUE_FRAME_MS;
+    const double requestFrameMs = SimulatedParamVehicle::REQUEST_FRAME_MS;
+    const double losslessMs = paramCount * valueFrameMs;
+
+    // Every lost parameter needs at least one request. Retries are only
+    // needed for lost requests and answers, about a fifth of all requests.
+    QVERIFY(requests >= lostInStream);
+    QVERIFY(requests < lostInStream * 2);
+    // Full bursts until only the last few stragglers are left
+    QVERIFY(rounds < requests / burstSize + 10);
+    // Each round waits one guard timeout for at most five parameters
+    QVERIFY(vehicle.now <= losslessMs + rounds * (retransmissionTimeout + burstSize * (requestFrameMs + valueFrameMs)));
+}
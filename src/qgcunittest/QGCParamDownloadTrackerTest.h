@@ -0,0 +1,24 @@
+#ifndef QGCPARAMDOWNLOADTRACKERTEST_H
+#define QGCPARAMDOWNLOADTRACKERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "QGCParamDownloadTracker.h"
+#include "AutoTest.h"
+
+class QGCParamDownloadTrackerTest : public QObject
+{
+    Q_OBJECT
+public:
+    QGCParamDownloadTrackerTest();
+
+private slots:
+    void markReceived_test();
+    void missingRanges_test();
+    void missingIndices_test();
+    void simulatedLossDownload_test();
+};
+
+DECLARE_TEST(QGCParamDownloadTrackerTest)
+#endif // QGCPARAMDOWNLOADTRACKERTEST_H
@@ -0,0 +1,71 @@
+#include "QGCStartupTimerTest.h"
+
+#include <QThread>
+
+namespace
+{
+class Sleeper : public QThread
+{
+public:
+    static void sleep(unsigned long ms) { QThread::msleep(ms); }
+};
+}
+
+void QGCStartupTimerTest::nested_test()
+{
+    QGCStartupTimer timer;
+    {
+        QGCStartupTimer::Scope view("VIEW_FLIGHT", &timer);
+        {
+            QGCStartupTimer::Scope center("VIEW_FLIGHT center widget", &timer);
+            Sleeper::sleep(20);
+        }
+        {
+            QGCStartupTimer::Scope docks("VIEW_FLIGHT dock widgets", &timer);
+        }
+    }
+    {
+        QGCStartupTimer::Scope view("VIEW_MISSION", &timer);
+    }
+
+    QList<QGCStartupTimer::Entry> entries = timer.getEntries();
+    QCOMPARE(entries.size(), 4);
+    QCOMPARE(entries.at(0).name, QString("VIEW_FLIGHT"));
+    QCOMPARE(entries.at(0).depth, 0);
+    QCOMPARE(entries.at(1).depth, 1);
+    QCOMPARE(entries.at(2).depth, 1);
+    QCOMPARE(entries.at(3).depth, 0);
+
+    // The enclosing scope includes the nested ones
+    QVERIFY(entries.at(1).durationUs >= 15000);
+    QVERIFY(entries.at(0).durationUs >= entries.at(1).durationUs + entries.at(2).durationUs);
+    QVERIFY(entries.at(3).startUs >= entries.at(0).startUs + entries.at(0).durationUs);
+}
+
+void QGCStartupTimerTest::endTwice_test()
+{
+    QGCStartupTimer timer;
+    int index = timer.begin("ApmSoftwareConfig");
+    timer.end(index);
+    qint64 duration = timer.getEntries().at(0).durationUs;
+    Sleeper::sleep(5);
+    timer.end(index);
+    timer.end(42);
+    QCOMPARE(timer.getEntries().at(0).durationUs, duration);
+}
+
+void QGCStartupTimerTest::report_test()
+{
+    QGCStartupTimer timer;
+    {
+        QGCStartupTimer::Scope view("VIEW_ENGINEER", &timer);
+        QGCStartupTimer::Scope center("VIEW_ENGINEER center widget", &timer);
+    }
+    timer.begin("Unfinished");
+
+    QStringList lines = timer.getReport().split("\n");
+    QCOMPARE(lines.size(), 4);
+    QVERIFY(lines.at(1).endsWith("  VIEW_ENGINEER"));
+    QVERIFY(lines.at(2).endsWith("    VIEW_ENGINEER center widget"));
+    QVERIFY(lines.at(3).contains(" -  "));
+}
@@ -0,0 +1,22 @@
+#ifndef QGCSTARTUPTIMERTEST_H
+#define QGCSTARTUPTIMERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "QGCStartupTimer.h"
+#include "AutoTest.h"
+
+class QGCStartupTimerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void nested_test();
+    void endTwice_test();
+    void report_test();
+};
+
+DECLARE_TEST(QGCStartupTimerTest)
+
+#endif // QGCSTARTUPTIMERTEST_H
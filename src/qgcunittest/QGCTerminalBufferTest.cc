@@ -0,0 +1,128 @@
+#include "QGCTerminalBufferTest.h"
+
+void QGCTerminalBufferTest::lines_test()
+{
+    QGCTerminalBuffer buffer;
+    QCOMPARE(buffer.getLineCount(), 0);
+
+    buffer.append(QByteArray("first\r\nsec"));
+    QCOMPARE(buffer.getLineCount(), 2);
+    QCOMPARE(buffer.getLineBytes(0), QByteArray("first\r\n"));
+    QCOMPARE(buffer.getLine(0), QString("first"));
+    QCOMPARE(buffer.getLine(1), QString("sec"));
+
+    // A line split over two blocks is one line
+    buffer.append(QByteArray("ond\n"));
+    QCOMPARE(buffer.getLineCount(), 2);
+    QCOMPARE(buffer.getLine(1), QString("second"));
+
+    QCOMPARE(buffer.getLine(2), QString());
+    buffer.clear();
+    QCOMPARE(buffer.getLineCount(), 0);
+    QCOMPARE(buffer.getBytesWritten(), Q_UINT64_C(0));
+}
+
+void QGCTerminalBufferTest::longLine_test()
+{
+    QGCTerminalBuffer buffer;
+    QByteArray line(QGCTerminalBuffer::MAX_LINE_LENGTH * 2 + 10, 'x');
+    buffer.append(line);
+    QCOMPARE(buffer.getLineCount(), 3);
+    QCOMPARE(buffer.getLineBytes(0).size(), (int)QGCTerminalBuffer::MAX_LINE_LENGTH);
+    QCOMPARE(buffer.getLineBytes(2).size(), 10);
+}
+
+void QGCTerminalBufferTest::wrap_test()
+{
+    QGCTerminalBuffer buffer(QGCTerminalBuffer::MIN_CAPACITY);
+    for (int i = 0; i < 1000; ++i)
+    {
+        buffer.append(QString("line %1\n").arg(i, 4, 10, QLatin1Char('0')).toLatin1());
+    }
+    // 10 bytes per line, only the lines starting in the last 4096 bytes are kept
+    QCOMPARE(buffer.getBytesWritten(), Q_UINT64_C(10000));
+    QCOMPARE(buffer.getFirstOffset(), Q_UINT64_C(10000 - 4096));
+    QCOMPARE(buffer.getFirstLine(), Q_UINT64_C(591));
+    QCOMPARE(buffer.getLineCount(), 409);
+    QCOMPARE(buffer.getLine(buffer.getFirstLine()), QString("line 0591"));
+    QCOMPARE(buffer.getLine(999), QString("line 0999"));
+    QCOMPARE(buffer.getLine(590), QString());
+
+    // A block larger than the ring keeps its end
+    QByteArray block(QGCTerminalBuffer::MIN_CAPACITY * 2, 'a');
+    block.append("end\n");
+    buffer.append(block);
+    QCOMPARE(buffer.getFirstOffset(), buffer.getBytesWritten() - QGCTerminalBuffer::MIN_CAPACITY);
+    QCOMPARE(buffer.getLine(buffer.getFirstLine() + buffer.getLineCount() - 1).right(3), QString("end"));
+}
+
+void QGCTerminalBufferTest::hexRows_test()
+{
+    QGCTerminalBuffer buffer;
+    QByteArray bytes;
+    for (int i = 0; i < 20; ++i) bytes.append(char(0x41 + i));
+    bytes[1] = 0x00;
+    buffer.append(bytes);
+
+    QCOMPARE(buffer.getFirstHexRow(), Q_UINT64_C(0));
+    QCOMPARE(buffer.getHexRowCount(), 2);
+    QCOMPARE(buffer.getHexRow(0), QString("00000000  41 00 43 44 45 46 47 48  49 4a 4b 4c 4d 4e 4f 50  |A.CDEFGHIJKLMNOP|"));
+    QCOMPARE(buffer.getHexRow(1), QString("00000010  51 52 53 54                                       |QRST            |"));
+}
+
+void QGCTerminalBufferTest::messages_test()
+{
+    QGCTerminalBuffer buffer;
+    buffer.append(QByteArray("partial"));
+    buffer.appendMessage("Link connected.\nnow", Qt::green);
+    buffer.append(QByteArray("data\n"));
+
+    QCOMPARE(buffer.getLineCount(), 3);
+    QCOMPARE(buffer.getLine(0), QString("partial"));
+    QCOMPARE(buffer.getLine(1), QString("Link connected. now"));
+    QCOMPARE(buffer.getLine(2), QString("data"));
+    QVERIFY(!buffer.getLineColor(0).isValid());
+    QCOMPARE(buffer.getLineColor(1), QColor(Qt::green));
+    QVERIFY(!buffer.getLineColor(2).isValid());
+
+    // Colors of dropped lines are forgotten
+    buffer.append(QByteArray(QGCTerminalBuffer::DEFAULT_CAPACITY, '\n'));
+    QVERIFY(!buffer.getLineColor(1).isValid());
+}
+
+void QGCTerminalBufferTest::printable_test()
+{
+    QCOMPARE(QGCTerminalBuffer::toPrintable("ab\tc\r\n"), QString("ab      c"));
+    QCOMPARE(QGCTerminalBuffer::toPrintable("\x1b[2Jclear\x1b[1;31mred"), QString("clearred"));
+    QCOMPARE(QGCTerminalBuffer::toPrintable(QByteArray("a\x01" "b")), QString("a 0x01 b"));
+}
+
+void QGCTerminalBufferTest::fullStream_test()
+{
+    // One second of a 921600 baud link, in blocks as a serial port delivers them,
+    // into a buffer that only keeps a fraction of it. TerminalBenchmark times this.
+    const QByteArray text("APM:Copter V3.0.1 ready, GPS fix 3D, sats 9, hdop 1.2");
+    QByteArray block;
+    while (block.size() < 512)
+    {
+        block.append(text + "\r\n");
+    }
+    const int blocks = (921600 / 10) / block.size() + 1;
+    const int capacity = 4 * QGCTerminalBuffer::MIN_CAPACITY;
+
+    QGCTerminalBuffer buffer(capacity);
+    for (int i = 0; i < blocks; ++i)
+    {
+        buffer.append(block);
+    }
+    QCOMPARE(buffer.getBytesWritten(), (quint64)blocks * block.size());
+    QCOMPARE(buffer.getFirstOffset(), buffer.getBytesWritten() - capacity);
+
+    // Only the lines still in the ring are kept, the newest one is complete
+    int lineLength = text.size() + 2;
+    QVERIFY(buffer.getLineCount() <= capacity / lineLength + 1);
+    QVERIFY(buffer.getLineCount() >= capacity / lineLength - 1);
+    quint64 last = buffer.getFirstLine() + buffer.getLineCount() - 1;
+    QCOMPARE(buffer.getLine(last), QString(text));
+    QCOMPARE(buffer.getLineBytes(last), text + "\r\n");
+}
@@ -0,0 +1,26 @@
+#ifndef QGCTERMINALBUFFERTEST_H
+#define QGCTERMINALBUFFERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "QGCTerminalBuffer.h"
+#include "AutoTest.h"
+
+class QGCTerminalBufferTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lines_test();
+    void longLine_test();
+    void wrap_test();
+    void hexRows_test();
+    void messages_test();
+    void printable_test();
+    void fullStream_test();
+};
+
+DECLARE_TEST(QGCTerminalBufferTest)
+
+#endif // QGCTERMINALBUFFERTEST_H
@@ -0,0 +1,172 @@
+#include "QGCTimebaseTest.h"
+
+#include <QDateTime>
+#include <QThread>
+
+#include "QGC.h"
+
+namespace
+{
+// Ground time of the first sample in the tests, in microseconds
+const quint64 GROUND_US = Q_UINT64_C(1380000000000000);
+
+/** Lowers the offset of vehicle 1 by 1 ms per sample, within one drift window */
+class AlignmentWriter : public QThread
+{
+public:
+    enum { SAMPLES = 5000 };
+    AlignmentWriter(QGCTimebase& timebase) : timebase(timebase) {}
+
+protected:
+    void run()
+    {
+        for (int i = 1; i <= SAMPLES; i++)
+        {
+            timebase.addBootTime(1, 1000 + i, GROUND_US + (quint64)(1000 + SAMPLES) * 1000);
+        }
+    }
+
+    QGCTimebase& timebase;
+};
+}
+
+void QGCTimebaseTest::groundTime_test()
+{
+    QGCTimebase timebase;
+    quint64 first = timebase.groundTimeUsecs();
+    quint64 wallClock = QDateTime::currentMSecsSinceEpoch();
+    QVERIFY(qAbs((qint64)(first / 1000) - (qint64)wallClock) < 1000);
+
+    quint64 last = first;
+    for (int i = 0; i < 1000; i++)
+    {
+        quint64 now = timebase.groundTimeUsecs();
+        QVERIFY(now >= last);
+        last = now;
+    }
+
+    // The QGC helpers read the shared timebase
+    quint64 before = QGCTimebase::instance()->groundTimeMilliseconds();
+    quint64 helper = QGC::groundTimeMilliseconds();
+    QVERIFY(helper >= before);
+    QVERIFY(QGCTimebase::instance()->groundTimeMilliseconds() >= helper);
+}
+
+void QGCTimebaseTest::bootTime_test()
+{
+    QGCTimebase timebase;
+    timebase.addBootTime(1, 5000, GROUND_US + 30000);
+    QGCTimebase::Alignment alignment = timebase.getAlignment(1);
+    QVERIFY(alignment.valid);
+    QCOMPARE(timebase.toGroundMilliseconds(1, 5000), GROUND_US / 1000 + 30);
+
+    // A frame that was delayed less moves the offset
+    timebase.addBootTime(1, 5100, GROUND_US + 110000);
+    QCOMPARE(timebase.toGroundMilliseconds(1, 5000), GROUND_US / 1000 + 10);
+    // One that was delayed more does not
+    timebase.addBootTime(1, 5200, GROUND_US + 250000);
+    QCOMPARE(timebase.toGroundMilliseconds(1, 5200), GROUND_US / 1000 + 210);
+
+    // Other vehicles have their own clock
+    QVERIFY(!timebase.getAlignment(2).valid);
+    QCOMPARE(timebase.getAlignment(1).samples, Q_UINT64_C(3));
+}
+
+void QGCTimebaseTest::drift_test()
+{
+    QGCTimebase timebase;
+    // The onboard clock runs 100 ppm slow, the frames arrive 5 to 54 ms late
+    const double drift = 0.0001;
+    for (int i = 0; i < 3000; i++)
+    {
+        quint64 bootMs = 1000 + i * 100;
+        double sentMs = bootMs * (1.0 + drift);
+        quint64 delayMs = 5 + (i * 37) % 50;
+        timebase.addBootTime(1, bootMs, GROUND_US + (quint64)((sentMs + delayMs) * 1000.0));
+    }
+
+    QGCTimebase::Alignment alignment = timebase.getAlignment(1);
+    QVERIFY(qAbs(alignment.drift - drift) < 0.00001);
+    QCOMPARE(alignment.reboots, 0);
+
+    // The least delay stays in the offset, it cannot be told from the clock offset
+    quint64 bootMs = 1000 + 3100 * 100;
+    quint64 expected = GROUND_US / 1000 + (quint64)(bootMs * (1.0 + drift)) + 5;
+    QVERIFY(qAbs((qint64)timebase.toGroundMilliseconds(1, bootMs) - (qint64)expected) <= 2);
+}
+
+void QGCTimebaseTest::reboot_test()
+{
+    QGCTimebase timebase;
+    timebase.addBootTime(1, 60000, GROUND_US);
+    timebase.addUnixTime(1, GROUND_US + 2000000, GROUND_US);
+    // Slightly out of order is not a reboot
+    timebase.addBootTime(1, 59950, GROUND_US + 1000);
+    QCOMPARE(timebase.getAlignment(1).reboots, 0);
+
+    timebase.addBootTime(1, 200, GROUND_US + 5000000);
+    QGCTimebase::Alignment alignment = timebase.getAlignment(1);
+    QCOMPARE(alignment.reboots, 1);
+    QVERIFY(!alignment.hasUnixTime);
+    QCOMPARE(timebase.toGroundMilliseconds(1, 200), GROUND_US / 1000 + 5000);
+}
+
+void QGCTimebaseTest::unixTime_test()
+{
+    QGCTimebase timebase;
+    quint64 unixMs = GROUND_US / 1000 + 2000;
+    // Without SYSTEM_TIME onboard Unix time is taken as it is
+    QCOMPARE(timebase.toGroundMilliseconds(1, unixMs), unixMs);
+
+    // No GPS time onboard yet
+    timebase.addUnixTime(1, 0, GROUND_US);
+    QVERIFY(!timebase.getAlignment(1).hasUnixTime);
+
+    // The onboard clock is 2 s ahead, the least delayed frame tells
+    timebase.addUnixTime(1, GROUND_US + 2000000, GROUND_US + 40000);
+    timebase.addUnixTime(1, GROUND_US + 2100000, GROUND_US + 110000);
+    QCOMPARE(timebase.getAlignment(1).unixOffsetMs, Q_INT64_C(1990));
+    QCOMPARE(timebase.toGroundMilliseconds(1, unixMs), GROUND_US / 1000 + 10);
+
+    // The onboard time was set again
+    timebase.addUnixTime(1, GROUND_US + 200000, GROUND_US + 200000);
+    QCOMPARE(timebase.getAlignment(1).unixOffsetMs, Q_INT64_C(0));
+}
+
+void QGCTimebaseTest::unaligned_test()
+{
+    QGCTimebase timebase;
+    quint64 before = timebase.groundTimeMilliseconds();
+    quint64 aligned = timebase.toGroundMilliseconds(3, 12000);
+    quint64 after = timebase.groundTimeMilliseconds();
+    // Taken as arrived now, later times follow the onboard clock
+    QVERIFY(aligned >= before && aligned <= after);
+    QCOMPARE(timebase.toGroundMilliseconds(3, 13000), aligned + 1000);
+
+    // Zero is the ground time now
+    quint64 now = timebase.toGroundMilliseconds(3, 0);
+    QVERIFY(now >= after && now <= timebase.groundTimeMilliseconds());
+}
+
+void QGCTimebaseTest::concurrentRead_test()
+{
+    QGCTimebase timebase;
+    timebase.addBootTime(1, 1000, GROUND_US + (quint64)(1000 + AlignmentWriter::SAMPLES) * 1000);
+    const quint64 first = GROUND_US / 1000 + AlignmentWriter::SAMPLES + 1000;
+    QCOMPARE(timebase.toGroundMilliseconds(1, 1000), first);
+
+    // The readers do not lock, every value they see was published by the writer
+    AlignmentWriter writer(timebase);
+    writer.start();
+    quint64 last = first;
+    while (!writer.isFinished())
+    {
+        quint64 ground = timebase.toGroundMilliseconds(1, 1000);
+        QVERIFY(ground <= last);
+        QVERIFY(ground >= first - AlignmentWriter::SAMPLES);
+        last = ground;
+    }
+    writer.wait();
+    QCOMPARE(timebase.toGroundMilliseconds(1, 1000), first - AlignmentWriter::SAMPLES);
+    QCOMPARE(timebase.getAlignment(1).samples, (quint64)AlignmentWriter::SAMPLES + 1);
+}
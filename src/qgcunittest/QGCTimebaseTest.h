@@ -0,0 +1,26 @@
+#ifndef QGCTIMEBASETEST_H
+#define QGCTIMEBASETEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "QGCTimebase.h"
+#include "AutoTest.h"
+
+class QGCTimebaseTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void groundTime_test();
+    void bootTime_test();
+    void drift_test();
+    void reboot_test();
+    void unixTime_test();
+    void unaligned_test();
+    void concurrentRead_test();
+};
+
+DECLARE_TEST(QGCTimebaseTest)
+
+#endif // QGCTIMEBASETEST_H
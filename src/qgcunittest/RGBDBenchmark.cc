@@ -0,0 +1,114 @@
+#include "RGBDBenchmark.h"
+
+#include <cmath>
+#include <string.h>
+
+#include "RGBDKernels.h"
+
+using namespace RGBD;
+
+RGBDBenchmark::RGBDBenchmark()
+{
+}
+
+void RGBDBenchmark::initTestCase()
+{
+    qDebug() << "RGBD kernels:" << RGBD::instructionSet();
+
+    // A slanted plane with the invalid pixels of a Kinect, about one in
+    // twenty without a reading and a few NaN and negative ones
+    quint32 seed = 1;
+    frame.resize(COLS * ROWS);
+    for (int r = 0; r < ROWS; ++r)
+    {
+        for (int c = 0; c < COLS; ++c)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            float depth = 0.5f + 11.5f * (r + c) / (ROWS + COLS) + 0.1f * ((seed >> 8) / float(1 << 24));
+            seed = seed * 1664525u + 1013904223u;
+            float special = (seed >> 8) / float(1 << 24);
+            if (special < 0.05f)
+            {
+                depth = 0.0f;
+            }
+            else if (special < 0.06f)
+            {
+                depth = NAN;
+            }
+            else if (special < 0.07f)
+            {
+                depth = -1.0f;
+            }
+            frame[r * COLS + c] = depth;
+        }
+    }
+}
+
+void RGBDBenchmark::colorize_benchmark_data()
+{
+    QTest::addColumn<bool>("scalar");
+    QTest::newRow("scalar") << true;
+    QTest::newRow("SIMD") << false;
+}
+
+void RGBDBenchmark::colorize_benchmark()
+{
+    QFETCH(bool, scalar);
+    QByteArray colored(COLS * ROWS * 3, 0);
+    unsigned char* rgb = reinterpret_cast<unsigned char*>(colored.data());
+    DepthColormap colormap;
+    QBENCHMARK {
+        if (scalar)
+        {
+            colormap.colorizeScalar(frame.constData(), COLS, ROWS, COLS * sizeof(float), rgb, COLS * 3);
+        }
+        else
+        {
+            colormap.colorize(frame.constData(), COLS, ROWS, COLS * sizeof(float), rgb, COLS * 3);
+        }
+    }
+}
+
+void RGBDBenchmark::project_benchmark_data()
+{
+    QTest::addColumn<bool>("scalar");
+    QTest::newRow("scalar") << true;
+    QTest::newRow("SIMD") << false;
+}
+
+void RGBDBenchmark::project_benchmark()
+{
+    QFETCH(bool, scalar);
+    DepthProjector projector;
+    projector.setIntrinsics(COLS, ROWS, 525.0f, 525.0f, 319.5f, 239.5f);
+    int count = 0;
+    QBENCHMARK {
+        if (scalar)
+        {
+            projector.projectScalar(frame.constData(), count);
+        }
+        else
+        {
+            projector.project(frame.constData(), count);
+        }
+    }
+    QVERIFY(count > 0);
+}
+
+void RGBDBenchmark::voxelGrid_benchmark()
+{
+    DepthProjector projector;
+    projector.setIntrinsics(COLS, ROWS, 525.0f, 525.0f, 319.5f, 239.5f);
+    int count = 0;
+    QVector<float> cloud = projector.project(frame.constData(), count);
+    QVector<float> points(cloud.size());
+    VoxelGrid grid(0.05f);
+
+    // The filter works in place, every frame starts from a copy of the cloud
+    int voxels = 0;
+    QBENCHMARK {
+        memcpy(points.data(), cloud.constData(), count * 3 * sizeof(float));
+        voxels = grid.filter(points.data(), NULL, count);
+    }
+    QVERIFY(voxels > 0 && voxels < count);
+}
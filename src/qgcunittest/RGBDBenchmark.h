@@ -0,0 +1,36 @@
+#ifndef RGBDBENCHMARK_H
+#define RGBDBENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/**
+ * @brief Per frame work of the RGBD view on a 640x480 depth image: colorize,
+ *        project to points and voxel grid downsampling, SIMD against scalar
+ */
+class RGBDBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    RGBDBenchmark();
+
+private slots:
+    void initTestCase();
+
+    void colorize_benchmark_data();
+    void colorize_benchmark();
+    void project_benchmark_data();
+    void project_benchmark();
+    void voxelGrid_benchmark();
+
+private:
+    enum { COLS = 640, ROWS = 480 };
+
+    QVector<float> frame;
+};
+
+DECLARE_TEST(RGBDBenchmark)
+#endif // RGBDBENCHMARK_H
@@ -0,0 +1,220 @@
+#include "RGBDKernelsTest.h"
+
+#include <cmath>
+#include <string.h>
+
+using namespace RGBD;
+
+RGBDKernelsTest::RGBDKernelsTest() :
+    seed(1)
+{
+}
+
+void RGBDKernelsTest::init()
+{
+    seed = 1;
+    makeFrame();
+}
+
+float RGBDKernelsTest::random()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / float(1 << 24);
+}
+
+void RGBDKernelsTest::makeFrame()
+{
+    frame.resize(COLS * ROWS);
+    for (int r = 0; r < ROWS; ++r)
+    {
+        for (int c = 0; c < COLS; ++c)
+        {
+            float depth = 0.5f + 11.5f * (r + c) / (ROWS + COLS) + 0.1f * random();
+            float special = random();
+            if (special < 0.05f)
+            {
+                depth = 0.0f;
+            }
+            else if (special < 0.06f)
+            {
+                depth = NAN;
+            }
+            else if (special < 0.07f)
+            {
+                depth = -1.0f;
+            }
+            frame[r * COLS + c] = depth;
+        }
+    }
+}
+
+void RGBDKernelsTest::colorize_test()
+{
+    QByteArray scalar(COLS * ROWS * 3, 0);
+    QByteArray simd(COLS * ROWS * 3, 0);
+
+    // The views use both orders and both directions
+    DepthColormap view(10.0f, true, DepthColormap::BGR);
+    view.colorizeScalar(frame.constData(), COLS, ROWS, COLS * sizeof(float),
+                        reinterpret_cast<unsigned char*>(scalar.data()), COLS * 3);
+    view.colorize(frame.constData(), COLS, ROWS, COLS * sizeof(float),
+                  reinterpret_cast<unsigned char*>(simd.data()), COLS * 3);
+    QVERIFY(scalar == simd);
+
+    DepthColormap distance(7.0f, false, DepthColormap::RGB);
+    distance.colorizeScalar(frame.constData(), COLS, ROWS, COLS * sizeof(float),
+                            reinterpret_cast<unsigned char*>(scalar.data()), COLS * 3);
+    distance.colorize(frame.constData(), COLS, ROWS, COLS * sizeof(float),
+                      reinterpret_cast<unsigned char*>(simd.data()), COLS * 3);
+    QVERIFY(scalar == simd);
+}
+
+void RGBDKernelsTest::colorizeStep_test()
+{
+    // Odd width leaves a tail after the SIMD loop, both images have padded rows
+    const int cols = 37;
+    const int rows = 5;
+    const int rgbStep = 120;
+    QByteArray scalar(rows * rgbStep, 'x');
+    QByteArray simd(rows * rgbStep, 'x');
+
+    DepthColormap colormap;
+    colormap.colorizeScalar(frame.constData(), cols, rows, COLS * sizeof(float),
+                            reinterpret_cast<unsigned char*>(scalar.data()), rgbStep);
+    colormap.colorize(frame.constData(), cols, rows, COLS * sizeof(float),
+                      reinterpret_cast<unsigned char*>(simd.data()), rgbStep);
+    QVERIFY(scalar == simd);
+    for (int r = 0; r < rows; ++r)
+    {
+        QCOMPARE(simd.at(r * rgbStep + cols * 3), 'x');
+        QCOMPARE(simd.at(r * rgbStep + rgbStep - 1), 'x');
+    }
+}
+
+void RGBDKernelsTest::color_test()
+{
+    DepthColormap colormap(10.0f, true, DepthColormap::RGB);
+    float depth[4] = { 0.0f, 0.01f, 10.0f, 50.0f };
+    unsigned char rgb[4 * 3];
+    colormap.colorize(depth, 4, 1, sizeof(depth), rgb, sizeof(rgb));
+
+    // No depth is black, near is dark red, far and beyond is dark blue
+    QCOMPARE((int)rgb[0], 0);
+    QCOMPARE((int)rgb[1], 0);
+    QCOMPARE((int)rgb[2], 0);
+    QCOMPARE((int)rgb[3], 127);
+    QCOMPARE((int)rgb[5], 0);
+    QCOMPARE((int)rgb[6], 0);
+    QCOMPARE((int)rgb[8], 135);
+    QCOMPARE(memcmp(rgb + 6, rgb + 9, 3), 0);
+
+    float r, g, b;
+    colormap.color(0.01f, r, g, b);
+    QCOMPARE(r, 0.5f);
+    QCOMPARE(g, 0.0f);
+    QCOMPARE(b, 0.0f);
+
+    DepthColormap bgr(10.0f, true, DepthColormap::BGR);
+    unsigned char swapped[4 * 3];
+    bgr.colorize(depth, 4, 1, sizeof(depth), swapped, sizeof(swapped));
+    QCOMPARE((int)swapped[3], 0);
+    QCOMPARE((int)swapped[5], 127);
+}
+
+void RGBDKernelsTest::project_test()
+{
+    const float fx = 525.0f;
+    const float fy = 520.0f;
+    const float cx = 319.5f;
+    const float cy = 239.5f;
+    DepthProjector projector;
+    projector.setIntrinsics(COLS, ROWS, fx, fy, cx, cy);
+    QCOMPARE(projector.size(), COLS * ROWS);
+
+    int scalarCount;
+    QVector<float> scalar = projector.projectScalar(frame.constData(), scalarCount);
+    int count;
+    const QVector<float>& simd = projector.project(frame.constData(), count);
+    QCOMPARE(count, scalarCount);
+    QVERIFY(memcmp(scalar.constData(), simd.constData(), count * 3 * sizeof(float)) == 0);
+
+    // Every point is on the ray of its pixel
+    int skipped = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        while (!(frame.at(i + skipped) > 0.0f))
+        {
+            ++skipped;
+        }
+        int pixel = i + skipped;
+        float depth = frame.at(pixel);
+        QVERIFY(qAbs(simd.at(i * 3) - ((pixel % COLS) - cx) / fx * depth) < 1e-4f);
+        QVERIFY(qAbs(simd.at(i * 3 + 1) - ((pixel / COLS) - cy) / fy * depth) < 1e-4f);
+        QCOMPARE(simd.at(i * 3 + 2), depth);
+    }
+}
+
+void RGBDKernelsTest::projectRays_test()
+{
+    QVector<QVector3D> rays;
+    rays.append(QVector3D(0.0f, 0.0f, 1.0f));
+    rays.append(QVector3D(0.5f, -0.5f, 1.0f));
+    rays.append(QVector3D(1.0f, 1.0f, 1.0f));
+    rays.append(QVector3D(-1.0f, 0.0f, 1.0f));
+    rays.append(QVector3D(0.0f, 2.0f, 1.0f));
+    DepthProjector projector;
+    projector.setRays(rays.constData(), rays.size());
+
+    float range[5] = { 2.0f, 0.0f, 4.0f, -3.0f, 1.0f };
+    int count;
+    const QVector<float>& points = projector.project(range, count);
+    QCOMPARE(count, 3);
+    QCOMPARE(points.at(0), 0.0f);
+    QCOMPARE(points.at(2), 2.0f);
+    QCOMPARE(points.at(3), 4.0f);
+    QCOMPARE(points.at(4), 4.0f);
+    QCOMPARE(points.at(7), 2.0f);
+    QCOMPARE(points.at(8), 1.0f);
+}
+
+void RGBDKernelsTest::voxelGrid_test()
+{
+    // Two clusters inside two voxels of 1 m, and a single point in the voxel left of the first
+    float xyz[5 * 3] = {
+        0.1f, 0.1f, 0.1f,
+        5.5f, 5.5f, 5.5f,
+        0.3f, 0.5f, 0.7f,
+        5.7f, 5.3f, 5.5f,
+        -0.5f, 0.5f, 0.5f
+    };
+    float rgba[5 * 4] = {
+        1.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 1.0f,
+        0.0f, 0.0f, 1.0f, 1.0f,
+        0.0f, 1.0f, 1.0f, 1.0f,
+        1.0f, 1.0f, 1.0f, 1.0f
+    };
+
+    VoxelGrid off(0.0f);
+    QCOMPARE(off.filter(xyz, rgba, 5), 5);
+
+    VoxelGrid grid(1.0f);
+    int count = grid.filter(xyz, rgba, 5);
+    QCOMPARE(count, 3);
+
+    // In the order the voxels were first seen
+    QVERIFY(qAbs(xyz[0] - 0.2f) < 1e-6f);
+    QVERIFY(qAbs(xyz[1] - 0.3f) < 1e-6f);
+    QVERIFY(qAbs(xyz[2] - 0.4f) < 1e-6f);
+    QCOMPARE(rgba[0], 0.5f);
+    QCOMPARE(rgba[2], 0.5f);
+    QVERIFY(qAbs(xyz[3] - 5.6f) < 1e-5f);
+    QVERIFY(qAbs(xyz[4] - 5.4f) < 1e-5f);
+    QCOMPARE(rgba[5], 1.0f);
+    QCOMPARE(rgba[6], 0.5f);
+    QCOMPARE(xyz[6], -0.5f);
+    QCOMPARE(rgba[8], 1.0f);
+
+    // The buffers are reused for the next frame
+    QCOMPARE(grid.filter(xyz, NULL, count), 3);
+}
@@ -0,0 +1,43 @@
+#ifndef RGBDKERNELSTEST_H
+#define RGBDKERNELSTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "RGBDKernels.h"
+#include "AutoTest.h"
+
+class RGBDKernelsTest : public QObject
+{
+    Q_OBJECT
+public:
+    RGBDKernelsTest();
+
+private slots:
+    void init();
+
+    void colorize_test();
+    void colorizeStep_test();
+    void color_test();
+    void project_test();
+    void projectRays_test();
+    void voxelGrid_test();
+
+private:
+    enum { COLS = 640, ROWS = 480 };
+
+    /**
+     * @brief Synthetic 640x480 depth frame: a slanted plane from 0.5 to 12 m
+     *        with holes, NaNs and negative values mixed in
+     */
+    void makeFrame();
+    /** @brief Deterministic uniform number in 0..1 */
+    float random();
+
+    quint32 seed;
+    QVector<float> frame;
+};
+
+DECLARE_TEST(RGBDKernelsTest)
+
+#endif // RGBDKERNELSTEST_H
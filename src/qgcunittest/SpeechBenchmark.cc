@@ -0,0 +1,80 @@
+#include "SpeechBenchmark.h"
+
+#include <QSemaphore>
+
+#include "GAudioSpeechWorker.h"
+
+namespace
+{
+/** Synthesizes silence instead of using flite and the sound card */
+class SilentSpeechWorker : public GAudioSpeechWorker
+{
+public:
+    SilentSpeechWorker() : speaking(false) {}
+
+    bool speaking;              ///< Block in play() until the gate is released
+    QSemaphore gate;
+    QSemaphore playing;
+
+protected:
+    bool synthesize(const QString& text, Waveform& wave)
+    {
+        wave.sampleRate = 8000;
+        wave.samples = QByteArray(text.size() * 1024, 0);
+        return true;
+    }
+
+    void play(const QString& text, const Waveform& wave)
+    {
+        Q_UNUSED(text);
+        Q_UNUSED(wave);
+        playing.release();
+        if (speaking) gate.acquire();
+    }
+};
+}
+
+SpeechBenchmark::SpeechBenchmark()
+{
+}
+
+void SpeechBenchmark::initTestCase()
+{
+    for (int i = 0; i < 5; i++)
+    {
+        phrases << QString("waypoint %1 reached").arg(i);
+    }
+}
+
+void SpeechBenchmark::enqueue_benchmark_data()
+{
+    QTest::addColumn<bool>("speaking");
+    QTest::newRow("idle worker") << false;
+    QTest::newRow("speaking worker") << true;
+}
+
+void SpeechBenchmark::enqueue_benchmark()
+{
+    QFETCH(bool, speaking);
+    SilentSpeechWorker worker;
+    worker.speaking = speaking;
+    worker.start();
+    if (speaking)
+    {
+        // Hold the worker in the playback of a phrase
+        worker.enqueue("first");
+        QVERIFY(worker.playing.tryAcquire(1, 5000));
+    }
+
+    QBENCHMARK {
+        foreach (const QString& phrase, phrases)
+        {
+            worker.enqueue(phrase);
+        }
+        worker.clear();
+    }
+
+    worker.stop();
+    worker.gate.release();
+    worker.wait();
+}
@@ -0,0 +1,28 @@
+#ifndef SPEECHBENCHMARK_H
+#define SPEECHBENCHMARK_H
+
+#include <QObject>
+#include <QStringList>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/** @brief Queueing announcements from the GUI thread, while the speech worker is idle or speaking */
+class SpeechBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    SpeechBenchmark();
+
+private slots:
+    void initTestCase();
+
+    void enqueue_benchmark_data();
+    void enqueue_benchmark();
+
+private:
+    QStringList phrases;
+};
+
+DECLARE_TEST(SpeechBenchmark)
+#endif // SPEECHBENCHMARK_H
@@ -0,0 +1,83 @@
+#include "TerminalBenchmark.h"
+
+#include "QGCTerminalBuffer.h"
+
+namespace
+{
+/** @brief Bytes per second of a 921600 baud link */
+const int BYTES_PER_SECOND = 921600 / 10;
+/** @brief Lines a console view shows at once */
+const int VISIBLE_LINES = 50;
+}
+
+TerminalBenchmark::TerminalBenchmark()
+{
+}
+
+void TerminalBenchmark::initTestCase()
+{
+    // One second of boot messages and status text
+    while (stream.size() < BYTES_PER_SECOND)
+    {
+        stream.append("APM:Copter V3.0.1 ready, GPS fix 3D, sats 9, hdop 1.2\r\n");
+    }
+    stream.resize(BYTES_PER_SECOND);
+}
+
+void TerminalBenchmark::append_benchmark_data()
+{
+    QTest::addColumn<int>("blockSize");
+    QTest::newRow("64 byte blocks") << 64;
+    QTest::newRow("512 byte blocks") << 512;
+    QTest::newRow("4096 byte blocks") << 4096;
+}
+
+void TerminalBenchmark::append_benchmark()
+{
+    QFETCH(int, blockSize);
+    QGCTerminalBuffer buffer;
+    QBENCHMARK {
+        for (int offset = 0; offset < stream.size(); offset += blockSize)
+        {
+            buffer.append(stream.constData() + offset, qMin(blockSize, stream.size() - offset));
+        }
+    }
+    QVERIFY(buffer.getBytesWritten() >= (quint64)stream.size());
+}
+
+void TerminalBenchmark::viewport_benchmark_data()
+{
+    QTest::addColumn<bool>("hex");
+    QTest::newRow("ASCII") << false;
+    QTest::newRow("HEX") << true;
+}
+
+void TerminalBenchmark::viewport_benchmark()
+{
+    QFETCH(bool, hex);
+    QGCTerminalBuffer buffer;
+    buffer.append(stream);
+
+    // The last screen of lines or rows, as painted after each received block
+    int length = 0;
+    QBENCHMARK {
+        length = 0;
+        if (hex)
+        {
+            quint64 last = buffer.getFirstHexRow() + buffer.getHexRowCount();
+            for (quint64 row = last - VISIBLE_LINES; row < last; ++row)
+            {
+                length += buffer.getHexRow(row).size();
+            }
+        }
+        else
+        {
+            quint64 last = buffer.getFirstLine() + buffer.getLineCount();
+            for (quint64 line = last - VISIBLE_LINES; line < last; ++line)
+            {
+                length += buffer.getLine(line).size();
+            }
+        }
+    }
+    QVERIFY(length > 0);
+}
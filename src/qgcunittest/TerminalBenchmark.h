@@ -0,0 +1,30 @@
+#ifndef TERMINALBENCHMARK_H
+#define TERMINALBENCHMARK_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/** @brief Storing a full rate serial stream in the terminal buffer, and formatting the lines a view shows */
+class TerminalBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    TerminalBenchmark();
+
+private slots:
+    void initTestCase();
+
+    void append_benchmark_data();
+    void append_benchmark();
+    void viewport_benchmark_data();
+    void viewport_benchmark();
+
+private:
+    QByteArray stream;
+};
+
+DECLARE_TEST(TerminalBenchmark)
+#endif // TERMINALBENCHMARK_H
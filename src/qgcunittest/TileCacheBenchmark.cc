@@ -0,0 +1,133 @@
+#include "TileCacheBenchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+using namespace core;
+
+namespace
+{
+/** @brief Tiles stored or read per iteration */
+const int TILES = 100;
+const int ZOOM = 17;
+/** @brief Tiles of the prefetched cache imported into the field cache */
+const int EXPORT_TILES = 1000000;
+}
+
+TileCacheBenchmark::TileCacheBenchmark() :
+    nextX(0)
+{
+}
+
+void TileCacheBenchmark::initTestCase()
+{
+    dir = QDir::tempPath() + QString("/TileCacheBenchmark%1/").arg(QCoreApplication::applicationPid());
+    QVERIFY(QDir().mkpath(dir));
+    cache.setGtileCache(dir);
+
+    // About the size of a satellite tile
+    tile.resize(20000);
+    for (int i = 0; i < tile.size(); i++)
+    {
+        tile[i] = (char)(i * 7);
+    }
+
+    // The tiles read by get_benchmark are in row 0
+    for (int x = 0; x < TILES; x++)
+    {
+        QVERIFY(cache.PutImageToCache(tile, MapType::GoogleSatellite, Point(x, 0), ZOOM));
+    }
+}
+
+void TileCacheBenchmark::cleanupTestCase()
+{
+    foreach (const QString& file, QDir(dir).entryList(QDir::Files))
+    {
+        QFile::remove(dir + file);
+    }
+    QDir().rmdir(dir);
+}
+
+bool TileCacheBenchmark::writeTiles(const QString& file, int count)
+{
+    if (!PureImageCache::CreateEmptyDB(file)) return false;
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "writeTiles");
+        db.setDatabaseName(file);
+        if (db.open())
+        {
+            db.transaction();
+            QSqlQuery tiles(db);
+            tiles.prepare("INSERT INTO Tiles(X, Y, Zoom, Type, Date) VALUES(?, ?, ?, ?, ?)");
+            QSqlQuery data(db);
+            data.prepare("INSERT INTO TilesData(id, Tile) VALUES(?, ?)");
+            ok = true;
+            for (int i = 0; ok && i < count; i++)
+            {
+                tiles.addBindValue(i % 1000);
+                tiles.addBindValue(i / 1000);
+                tiles.addBindValue(ZOOM);
+                tiles.addBindValue((int)MapType::GoogleSatellite);
+                tiles.addBindValue(QString("date"));
+                ok = tiles.exec();
+                data.addBindValue(tiles.lastInsertId());
+                data.addBindValue(QString::number(i).toLatin1());
+                ok = ok && data.exec();
+            }
+            ok = db.commit() && ok;
+            tiles.clear();
+            data.clear();
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase("writeTiles");
+    return ok;
+}
+
+void TileCacheBenchmark::put_benchmark()
+{
+    QBENCHMARK {
+        for (int i = 0; i < TILES; i++)
+        {
+            cache.PutImageToCache(tile, MapType::GoogleSatellite, Point(nextX++, 1), ZOOM);
+        }
+    }
+    QCOMPARE(cache.GetImageFromCache(MapType::GoogleSatellite, Point(nextX - 1, 1), ZOOM).size(), tile.size());
+}
+
+void TileCacheBenchmark::get_benchmark_data()
+{
+    QTest::addColumn<int>("row");
+    QTest::newRow("cached") << 0;
+    QTest::newRow("missing") << 2;
+}
+
+void TileCacheBenchmark::get_benchmark()
+{
+    QFETCH(int, row);
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int x = 0; x < TILES; x++)
+        {
+            if (!cache.GetImageFromCache(MapType::GoogleSatellite, Point(x, row), ZOOM).isEmpty()) found++;
+        }
+    }
+    QCOMPARE(found, row == 0 ? TILES : 0);
+}
+
+void TileCacheBenchmark::export_benchmark()
+{
+    // A cache prefetched in the office, imported once into the one of the field laptop
+    QString source = dir + "office.qmdb";
+    QString dest = dir + "field.qmdb";
+    QVERIFY(writeTiles(source, EXPORT_TILES));
+    QVERIFY(PureImageCache::CreateEmptyDB(dest));
+
+    QBENCHMARK_ONCE {
+        QVERIFY(PureImageCache::ExportMapDataToDB(source, dest));
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef TILECACHEBENCHMARK_H
+#define TILECACHEBENCHMARK_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QtTest/QtTest>
+
+#include "pureimagecache.h"
+#include "AutoTest.h"
+
+/** @brief Storing and reading map tiles in the SQLite tile cache, and importing a prefetched cache */
+class TileCacheBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    TileCacheBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void put_benchmark();
+    void get_benchmark_data();
+    void get_benchmark();
+    void export_benchmark();
+
+private:
+    /** @brief Write count tiles in rows of 1000 to a new tile cache database */
+    static bool writeTiles(const QString& file, int count);
+
+    QString dir;
+    core::PureImageCache cache;
+    QByteArray tile;
+    int nextX;          ///< Column of the next new tile, every put stores new tiles
+};
+
+DECLARE_TEST(TileCacheBenchmark)
+#endif // TILECACHEBENCHMARK_H
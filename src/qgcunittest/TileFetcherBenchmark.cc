@@ -0,0 +1,72 @@
+#include "TileFetcherBenchmark.h"
+
+using namespace core;
+
+TileFetcherBenchmark::TileFetcherBenchmark() :
+    fetched(0),
+    failed(0)
+{
+}
+
+void TileFetcherBenchmark::tileFetched(int type, int x, int y, int zoom, QByteArray data)
+{
+    Q_UNUSED(type); Q_UNUSED(x); Q_UNUSED(y); Q_UNUSED(zoom); Q_UNUSED(data);
+    fetched++;
+}
+
+void TileFetcherBenchmark::tileFailed(int type, int x, int y, int zoom)
+{
+    Q_UNUSED(type); Q_UNUSED(x); Q_UNUSED(y); Q_UNUSED(zoom);
+    failed++;
+}
+
+void TileFetcherBenchmark::viewport_benchmark_data()
+{
+    QTest::addColumn<int>("delay");
+    QTest::newRow("immediate") << 0;
+    QTest::newRow("20 ms per tile") << 20;
+}
+
+void TileFetcherBenchmark::viewport_benchmark()
+{
+    QFETCH(int, delay);
+    TileServer server(delay);
+    QVERIFY(server.getPort() != 0);
+    LocalTileFetcher fetcher(server.getPort());
+    fetcher.SetTimeout(2000);
+    connect(&fetcher, SIGNAL(TileFetched(int,int,int,int,QByteArray)),
+            this, SLOT(tileFetched(int,int,int,int,QByteArray)), Qt::QueuedConnection);
+    connect(&fetcher, SIGNAL(TileFailed(int,int,int,int)),
+            this, SLOT(tileFailed(int,int,int,int)), Qt::QueuedConnection);
+
+    // A 1920x1080 map shows up to 9x7 tiles of 256 pixels
+    Point center(100, 100);
+    QList<Point> tiles;
+    for (int x = -4; x <= 4; x++)
+    {
+        for (int y = -3; y <= 3; y++)
+        {
+            tiles.append(Point(center.X() + x, center.Y() + y));
+        }
+    }
+
+    fetched = 0;
+    failed = 0;
+    int target = 0;
+    QBENCHMARK {
+        target += tiles.size();
+        fetcher.SetViewport(this, 12, center, tiles);
+        foreach (const Point& tile, tiles)
+        {
+            fetcher.Fetch(this, MapType::OpenStreetMap, tile, 12);
+        }
+        for (int wait = 0; wait < 10000 && fetched + failed < target; wait++)
+        {
+            QTest::qWait(1);
+        }
+    }
+    QCOMPARE(fetched, target);
+    QCOMPARE(failed, 0);
+    // Keep-alive: the connections are reused across the viewports
+    QVERIFY(server.getConnections() <= TileFetcher::MAX_IN_FLIGHT);
+}
@@ -0,0 +1,30 @@
+#ifndef TILEFETCHERBENCHMARK_H
+#define TILEFETCHERBENCHMARK_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "TileServer.h"
+#include "AutoTest.h"
+
+/** @brief Time to a full 1920x1080 map viewport, fetched from the local tile server */
+class TileFetcherBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    TileFetcherBenchmark();
+
+private slots:
+    void viewport_benchmark_data();
+    void viewport_benchmark();
+
+    void tileFetched(int type, int x, int y, int zoom, QByteArray data);
+    void tileFailed(int type, int x, int y, int zoom);
+
+private:
+    int fetched;
+    int failed;
+};
+
+DECLARE_TEST(TileFetcherBenchmark)
+#endif // TILEFETCHERBENCHMARK_H
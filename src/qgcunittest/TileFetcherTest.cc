@@ -0,0 +1,232 @@
+#include "TileFetcherTest.h"
+
+using namespace core;
+
+TileFetcherTest::TileFetcherTest() :
+    server(NULL),
+    fetcher(NULL)
+{
+}
+
+void TileFetcherTest::cleanup()
+{
+    if (fetcher)
+    {
+        fetcher->Cancel(this);
+        for (int wait = 0; wait < 100 && fetcher->Pending() > 0; wait++)
+        {
+            QTest::qWait(10);
+        }
+    }
+    delete fetcher;
+    fetcher = NULL;
+    delete server;
+    server = NULL;
+    fetched.clear();
+    data.clear();
+    failed.clear();
+}
+
+void TileFetcherTest::start(int delay)
+{
+    server = new TileServer(delay);
+    QVERIFY(server->getPort() != 0);
+    fetcher = new LocalTileFetcher(server->getPort());
+    fetcher->SetTimeout(2000);
+    connect(fetcher, SIGNAL(TileFetched(int,int,int,int,QByteArray)),
+            this, SLOT(tileFetched(int,int,int,int,QByteArray)), Qt::QueuedConnection);
+    connect(fetcher, SIGNAL(TileFailed(int,int,int,int)),
+            this, SLOT(tileFailed(int,int,int,int)), Qt::QueuedConnection);
+}
+
+void TileFetcherTest::tileFetched(int type, int x, int y, int zoom, QByteArray tile)
+{
+    fetched.append(RawTile((MapType::Types)type, Point(x, y), zoom));
+    data.append(tile);
+}
+
+void TileFetcherTest::tileFailed(int type, int x, int y, int zoom)
+{
+    failed.append(RawTile((MapType::Types)type, Point(x, y), zoom));
+}
+
+bool TileFetcherTest::waitForTiles(int count, int timeout)
+{
+    for (int wait = 0; wait < timeout / 5 && fetched.size() + failed.size() < count; wait++)
+    {
+        QTest::qWait(5);
+    }
+    return fetched.size() + failed.size() >= count;
+}
+
+QList<Point> TileFetcherTest::square(const Point& center, int radius)
+{
+    QList<Point> tiles;
+    for (int x = center.X() - radius; x <= center.X() + radius; x++)
+    {
+        for (int y = center.Y() - radius; y <= center.Y() + radius; y++)
+        {
+            tiles.append(Point(x, y));
+        }
+    }
+    return tiles;
+}
+
+void TileFetcherTest::fetch_test()
+{
+    start(0);
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(3, 4), 5);
+    QVERIFY(waitForTiles(1, 2000));
+
+    QCOMPARE(fetched.size(), 1);
+    QVERIFY(fetched.first() == RawTile(MapType::OpenStreetMap, Point(3, 4), 5));
+    QCOMPARE(data.first(), QString("/tile/%1/5/3/4").arg((int)MapType::OpenStreetMap).toLatin1());
+    QCOMPARE(fetcher->GetStatistics().fetched, 1);
+    QCOMPARE(fetcher->Pending(), 0);
+}
+
+void TileFetcherTest::deduplicate_test()
+{
+    start(100);
+    int other;
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(1, 1), 5);
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(1, 1), 5);
+    fetcher->Fetch(&other, MapType::OpenStreetMap, Point(1, 1), 5);
+    QVERIFY(waitForTiles(1, 2000));
+    // Asked for again while downloading
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(2, 2), 5);
+    QTest::qWait(20);
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(2, 2), 5);
+    QVERIFY(waitForTiles(2, 2000));
+    QTest::qWait(200);
+
+    QCOMPARE(fetched.size(), 2);
+    QCOMPARE(server->getRequests().size(), 2);
+    QCOMPARE(fetcher->GetStatistics().deduplicated, 3);
+    fetcher->Cancel(&other);
+}
+
+void TileFetcherTest::priority_test()
+{
+    start(50);
+    Point center(10, 10);
+    QList<Point> tiles = square(center, 2);
+    fetcher->SetViewport(this, 5, center, tiles);
+
+    // Occupy all connections, so the viewport is queued completely before it is sent
+    for (int i = 0; i < TileFetcher::MAX_IN_FLIGHT; i++)
+    {
+        fetcher->Fetch(this, MapType::OpenStreetMap, Point(i, 0), 4);
+    }
+    QTest::qWait(10);
+    // Queued corner first, the fetcher still starts at the center
+    for (int i = tiles.size() - 1; i >= 0; i--)
+    {
+        fetcher->Fetch(this, MapType::OpenStreetMap, tiles.at(i), 5);
+    }
+    QVERIFY(waitForTiles(tiles.size() + TileFetcher::MAX_IN_FLIGHT, 5000));
+    QCOMPARE(failed.size(), 0);
+
+    QStringList requests = server->getRequests();
+    QCOMPARE(requests.size(), tiles.size() + TileFetcher::MAX_IN_FLIGHT);
+    requests = requests.mid(TileFetcher::MAX_IN_FLIGHT);
+    for (int i = 0; i < requests.size(); i++)
+    {
+        QStringList parts = requests.at(i).split('/');
+        QCOMPARE(parts.at(3), QString("5"));
+        int dx = parts.at(4).toInt() - center.X();
+        int dy = parts.at(5).toInt() - center.Y();
+        // The first requests are the center and its neighbours, the corners come last
+        if (i < TileFetcher::MAX_IN_FLIGHT) QVERIFY(dx * dx + dy * dy <= 2);
+        if (i >= requests.size() - 4) QVERIFY(dx * dx + dy * dy >= 5);
+    }
+}
+
+void TileFetcherTest::cancel_test()
+{
+    start(100);
+    Point center(10, 10);
+    QList<Point> tiles = square(center, 3);
+    fetcher->SetViewport(this, 5, center, tiles);
+    foreach (const Point& tile, tiles)
+    {
+        fetcher->Fetch(this, MapType::OpenStreetMap, tile, 5);
+    }
+    QTest::qWait(30);
+
+    // Zoomed in, only one tile is shown now
+    QList<Point> zoomed;
+    zoomed.append(Point(20, 20));
+    fetcher->SetViewport(this, 6, Point(20, 20), zoomed);
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(20, 20), 6);
+
+    for (int wait = 0; wait < 400 && fetcher->Pending() > 0; wait++)
+    {
+        QTest::qWait(5);
+    }
+    QTest::qWait(150);
+
+    QVERIFY(fetched.contains(RawTile(MapType::OpenStreetMap, Point(20, 20), 6)));
+    // Only the first requests were on the wire, they were aborted
+    QVERIFY(server->getRequests().size() <= TileFetcher::MAX_IN_FLIGHT + 1);
+    QVERIFY(fetched.size() <= 1);
+    QVERIFY(fetcher->GetStatistics().cancelled >= tiles.size() - TileFetcher::MAX_IN_FLIGHT);
+    QCOMPARE(failed.size(), 0);
+}
+
+void TileFetcherTest::failure_test()
+{
+    start(0);
+    fetcher->SetRetries(3);
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(1, 1), LocalTileFetcher::ERROR_ZOOM);
+    QVERIFY(waitForTiles(1, 5000));
+
+    QCOMPARE(failed.size(), 1);
+    QCOMPARE(fetched.size(), 0);
+    QCOMPARE(server->getRequests().size(), 3);
+    TileFetcher::Statistics stats = fetcher->GetStatistics();
+    QCOMPARE(stats.networkerrors, 3);
+    QCOMPARE(stats.retries, 2);
+}
+
+void TileFetcherTest::fetchAndWait_test()
+{
+    start(20);
+    QByteArray tile = fetcher->FetchAndWait(MapType::OpenStreetMap, Point(7, 8), 9);
+    QCOMPARE(tile, QString("/tile/%1/9/7/8").arg((int)MapType::OpenStreetMap).toLatin1());
+
+    // A tile the map gave up on can still be waited for
+    fetcher->Fetch(this, MapType::OpenStreetMap, Point(1, 2), 9);
+    fetcher->SetViewport(this, 10, Point(0, 0), QList<Point>());
+    tile = fetcher->FetchAndWait(MapType::OpenStreetMap, Point(1, 2), 9);
+    QVERIFY(!tile.isEmpty());
+
+    tile = fetcher->FetchAndWait(MapType::OpenStreetMap, Point(1, 2), LocalTileFetcher::ERROR_ZOOM);
+    QVERIFY(tile.isEmpty());
+}
+
+void TileFetcherTest::fullViewport_test()
+{
+    // A 1920x1080 map shows up to 9x7 tiles of 256 pixels
+    start(20);
+    Point center(100, 100);
+    QList<Point> tiles;
+    for (int x = -4; x <= 4; x++)
+    {
+        for (int y = -3; y <= 3; y++)
+        {
+            tiles.append(Point(center.X() + x, center.Y() + y));
+        }
+    }
+
+    fetcher->SetViewport(this, 12, center, tiles);
+    foreach (const Point& tile, tiles)
+    {
+        fetcher->Fetch(this, MapType::OpenStreetMap, tile, 12);
+    }
+    QVERIFY(waitForTiles(tiles.size(), 10000));
+
+    QCOMPARE(fetched.size(), tiles.size());
+    // Keep-alive: the connections are reused instead of opened per tile
+    QVERIFY(server->getConnections() <= TileFetcher::MAX_IN_FLIGHT);
+}
@@ -0,0 +1,47 @@
+#ifndef TILEFETCHERTEST_H
+#define TILEFETCHERTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "TileServer.h"
+#include "AutoTest.h"
+
+class TileFetcherTest : public QObject
+{
+    Q_OBJECT
+public:
+    TileFetcherTest();
+
+private slots:
+    void cleanup();
+
+    void fetch_test();
+    void deduplicate_test();
+    void priority_test();
+    void cancel_test();
+    void failure_test();
+    void fetchAndWait_test();
+    void fullViewport_test();
+
+    void tileFetched(int type, int x, int y, int zoom, QByteArray data);
+    void tileFailed(int type, int x, int y, int zoom);
+
+private:
+    /** @brief Start a server and a fetcher connected to this test */
+    void start(int delay);
+    /** @brief Process events until count tiles arrived or failed, or the timeout passed */
+    bool waitForTiles(int count, int timeout);
+    /** @brief Square of tiles around the center */
+    static QList<core::Point> square(const core::Point& center, int radius);
+
+    TileServer* server;
+    LocalTileFetcher* fetcher;
+    QList<core::RawTile> fetched;
+    QList<QByteArray> data;
+    QList<core::RawTile> failed;
+};
+
+DECLARE_TEST(TileFetcherTest)
+
+#endif // TILEFETCHERTEST_H
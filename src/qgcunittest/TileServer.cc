@@ -0,0 +1,104 @@
+#include "TileServer.h"
+
+#include <QTimer>
+
+TileServer::TileServer(int delay) :
+    server(NULL),
+    port(0),
+    delay(delay),
+    connections(0)
+{
+    moveToThread(&thread);
+    thread.start();
+    QMetaObject::invokeMethod(this, "listen", Qt::BlockingQueuedConnection);
+}
+
+TileServer::~TileServer()
+{
+    QMetaObject::invokeMethod(this, "close", Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+
+QStringList TileServer::getRequests()
+{
+    QMutexLocker locker(&mutex);
+    return requests;
+}
+
+int TileServer::getConnections()
+{
+    QMutexLocker locker(&mutex);
+    return connections;
+}
+
+void TileServer::listen()
+{
+    server = new QTcpServer(this);
+    connect(server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+    server->listen(QHostAddress::LocalHost, 0);
+    port = server->serverPort();
+}
+
+void TileServer::close()
+{
+    delete server;
+    server = NULL;
+}
+
+void TileServer::newConnection()
+{
+    while (server->hasPendingConnections())
+    {
+        QTcpSocket* socket = server->nextPendingConnection();
+        connect(socket, SIGNAL(readyRead()), this, SLOT(readyRead()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        QMutexLocker locker(&mutex);
+        connections++;
+    }
+}
+
+void TileServer::readyRead()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+    QByteArray& buffer = buffers[socket];
+    buffer.append(socket->readAll());
+
+    int end;
+    while ((end = buffer.indexOf("\r\n\r\n")) >= 0)
+    {
+        QByteArray header = buffer.left(end);
+        buffer.remove(0, end + 4);
+        QList<QByteArray> requestLine = header.left(header.indexOf("\r\n")).split(' ');
+        if (requestLine.size() < 2) continue;
+
+        QByteArray path = requestLine.at(1);
+        {
+            QMutexLocker locker(&mutex);
+            requests.append(QString(path));
+        }
+        // All responses wait the same time, so the timers fire in request order
+        responses.append(qMakePair(QPointer<QTcpSocket>(socket), path));
+        QTimer::singleShot(delay, this, SLOT(respondNext()));
+    }
+}
+
+void TileServer::respondNext()
+{
+    if (responses.isEmpty()) return;
+    QPair<QPointer<QTcpSocket>, QByteArray> response = responses.takeFirst();
+    if (!response.first) return;
+
+    QByteArray reply;
+    if (response.second.startsWith("/error"))
+    {
+        reply = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+    }
+    else
+    {
+        reply = "HTTP/1.1 200 OK\r\nContent-Type: image/png\r\nContent-Length: "
+                + QByteArray::number(response.second.size()) + "\r\n\r\n" + response.second;
+    }
+    response.first->write(reply);
+}
@@ -0,0 +1,80 @@
+#ifndef TILESERVER_H
+#define TILESERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QPair>
+#include <QPointer>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "tilefetcher.h"
+
+/**
+ * @brief HTTP/1.1 stand-in for a tile server, answers every GET after a
+ *        fixed delay with the path as body, or 500 for paths under /error.
+ *        Runs in its own thread so FetchAndWait() can block the test.
+ */
+class TileServer : public QObject
+{
+    Q_OBJECT
+public:
+    TileServer(int delay);
+    ~TileServer();
+
+    quint16 getPort() const { return port; }
+    /** @brief Paths in the order they were requested */
+    QStringList getRequests();
+    int getConnections();
+
+protected slots:
+    void listen();
+    void close();
+    void newConnection();
+    void readyRead();
+    void respondNext();
+
+protected:
+    QThread thread;
+    QTcpServer* server;
+    quint16 port;
+    int delay;
+    QMutex mutex;
+    QStringList requests;
+    int connections;
+    QMap<QTcpSocket*, QByteArray> buffers;
+    QList<QPair<QPointer<QTcpSocket>, QByteArray> > responses;
+};
+
+/** @brief Fetcher that downloads from the TileServer and does not cache */
+class LocalTileFetcher : public core::TileFetcher
+{
+public:
+    LocalTileFetcher(quint16 port) : port(port) {}
+
+protected:
+    QNetworkRequest MakeRequest(const core::MapType::Types& type, const core::Point& pos, const int& zoom)
+    {
+        QString path = (zoom == ERROR_ZOOM) ? "error" : "tile";
+        return QNetworkRequest(QUrl(QString("http://127.0.0.1:%1/%2/%3/%4/%5/%6")
+                                    .arg(port).arg(path).arg(type).arg(zoom).arg(pos.X()).arg(pos.Y())));
+    }
+    QNetworkProxy GetProxy() { return QNetworkProxy(QNetworkProxy::NoProxy); }
+    void Store(const core::MapType::Types& type, const core::Point& pos, const int& zoom, const QByteArray& data)
+    {
+        Q_UNUSED(type);
+        Q_UNUSED(pos);
+        Q_UNUSED(zoom);
+        Q_UNUSED(data);
+    }
+
+public:
+    enum { ERROR_ZOOM = 99 };
+
+private:
+    quint16 port;
+};
+
+#endif // TILESERVER_H
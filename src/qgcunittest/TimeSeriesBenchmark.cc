@@ -0,0 +1,97 @@
+#include "TimeSeriesBenchmark.h"
+
+#include <qmath.h>
+
+#include "LinechartPlot.h"
+#include "TimeSeriesStore.h"
+
+namespace
+{
+/** @brief Telemetry rate of the samples */
+const quint64 INTERVAL_MS = 20;
+const int MAX_SAMPLES = 100000;
+}
+
+TimeSeriesBenchmark::TimeSeriesBenchmark()
+{
+}
+
+void TimeSeriesBenchmark::initTestCase()
+{
+    // A slow sine with a little noise, compresses like real attitude data
+    values.resize(MAX_SAMPLES);
+    quint32 seed = 1;
+    for (int i = 0; i < MAX_SAMPLES; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        values[i] = qSin(i * 0.01) + (seed >> 8) / 16777216.0 * 0.01;
+    }
+}
+
+void TimeSeriesBenchmark::append_benchmark_data()
+{
+    QTest::addColumn<int>("samples");
+    QTest::addColumn<quint64>("maxInterval");
+    QTest::newRow("10000 samples") << 10000 << Q_UINT64_C(0);
+    QTest::newRow("100000 samples") << MAX_SAMPLES << Q_UINT64_C(0);
+    QTest::newRow("100000 samples, 5 min kept") << MAX_SAMPLES << Q_UINT64_C(300000);
+}
+
+void TimeSeriesBenchmark::append_benchmark()
+{
+    QFETCH(int, samples);
+    QFETCH(quint64, maxInterval);
+
+    {
+        TimeSeriesData data(NULL, "benchmark", 10000, maxInterval);
+        for (int i = 0; i < samples; i++)
+        {
+            data.append(i * INTERVAL_MS, values.at(i));
+        }
+        if (maxInterval == 0)
+        {
+            QCOMPARE(data.getCount(), samples);
+        }
+        else
+        {
+            QVERIFY(data.getCount() < samples);
+        }
+    }
+
+    QBENCHMARK {
+        TimeSeriesData data(NULL, "benchmark", 10000, maxInterval);
+        for (int i = 0; i < samples; i++)
+        {
+            data.append(i * INTERVAL_MS, values.at(i));
+        }
+    }
+}
+
+void TimeSeriesBenchmark::storeAppend_benchmark()
+{
+    QBENCHMARK {
+        TimeSeriesStore store;
+        for (int i = 0; i < MAX_SAMPLES; i++)
+        {
+            store.append(i * INTERVAL_MS, values.at(i));
+        }
+    }
+}
+
+void TimeSeriesBenchmark::storeRead_benchmark()
+{
+    TimeSeriesStore store;
+    for (int i = 0; i < MAX_SAMPLES; i++)
+    {
+        store.append(i * INTERVAL_MS, values.at(i));
+    }
+    QVERIFY(store.blockCount() > 0);
+
+    // Scrolling back one plot window of 8 seconds into the compressed history
+    QVector<double> ms;
+    QVector<double> read;
+    QBENCHMARK {
+        store.read(1000 * INTERVAL_MS, 1000 * INTERVAL_MS + 8000, ms, read);
+    }
+    QCOMPARE(read.size(), 8000 / (int)INTERVAL_MS + 1);
+}
@@ -0,0 +1,33 @@
+#ifndef TIMESERIESBENCHMARK_H
+#define TIMESERIESBENCHMARK_H
+
+#include <QObject>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/**
+ * @brief Appending to the linechart data sets, including the running statistics
+ *        and trimming, and to the compressed history of TimeSeriesStore
+ */
+class TimeSeriesBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    TimeSeriesBenchmark();
+
+private slots:
+    void initTestCase();
+
+    void append_benchmark_data();
+    void append_benchmark();
+    void storeAppend_benchmark();
+    void storeRead_benchmark();
+
+private:
+    QVector<double> values;
+};
+
+DECLARE_TEST(TimeSeriesBenchmark)
+#endif // TIMESERIESBENCHMARK_H
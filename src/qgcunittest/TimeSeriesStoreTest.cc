@@ -0,0 +1,220 @@
+#include "TimeSeriesStoreTest.h"
+
+#include <cmath>
+#include <limits>
+#include <string.h>
+
+TimeSeriesStoreTest::TimeSeriesStoreTest() :
+    seed(1)
+{
+}
+
+void TimeSeriesStoreTest::init()
+{
+    seed = 1;
+    ms.resize(0);
+    values.resize(0);
+}
+
+double TimeSeriesStoreTest::random()
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / double(1 << 24);
+}
+
+bool TimeSeriesStoreTest::sameValue(double a, double b)
+{
+    return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void TimeSeriesStoreTest::makeSeries(int count)
+{
+    quint64 time = Q_UINT64_C(1370000000000);
+    for (int i = 0; i < count; ++i)
+    {
+        double special = random();
+        if (special < 0.002)
+        {
+            // Link dropout
+            time += 1000 + static_cast<quint64>(random() * 100000);
+        }
+        else
+        {
+            time += 15 + static_cast<quint64>(random() * 10);
+        }
+        // MAVLink telemetry arrives as float
+        double value = static_cast<float>(10.0 * sin(i / 500.0) + 0.01 * random());
+        if ((i / 3000) % 4 == 1)
+        {
+            value = 42.0;
+        }
+        else if (special > 0.999)
+        {
+            value = std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (special > 0.998)
+        {
+            value = -std::numeric_limits<double>::infinity();
+        }
+        ms.append(time);
+        values.append(value);
+    }
+}
+
+void TimeSeriesStoreTest::roundTrip_test()
+{
+    makeSeries(50000);
+    TimeSeriesStore store;
+    int compressed = 0;
+    for (int i = 0; i < ms.size(); ++i)
+    {
+        if (store.append(ms.at(i), values.at(i))) ++compressed;
+    }
+    QCOMPARE(store.count(), ms.size());
+    QCOMPARE(store.blockCount(), compressed);
+    QCOMPARE(store.count(), store.blockCount() * TimeSeriesStore::BLOCK_SIZE + store.rawCount());
+    QVERIFY(store.rawCount() > TimeSeriesStore::RAW_BLOCKS * TimeSeriesStore::BLOCK_SIZE);
+    QCOMPARE(store.firstTime(), static_cast<quint64>(ms.first()));
+
+    QVector<double> readMs;
+    QVector<double> readValues;
+    QCOMPARE(store.read(0, Q_UINT64_C(0xFFFFFFFFFFFFFFFF), readMs, readValues), ms.size());
+    for (int i = 0; i < ms.size(); ++i)
+    {
+        QCOMPARE(readMs.at(i), ms.at(i));
+        QVERIFY(sameValue(readValues.at(i), values.at(i)));
+    }
+}
+
+void TimeSeriesStoreTest::window_test()
+{
+    makeSeries(20000);
+    TimeSeriesStore store;
+    for (int i = 0; i < ms.size(); ++i)
+    {
+        store.append(ms.at(i), values.at(i));
+    }
+
+    // Windows inside a block, across blocks, across the tiers and inside the ring
+    const int windows[][2] = { { 100, 900 }, { 1000, 3100 }, { 8000, 12500 }, { 15000, 19999 } };
+    QVector<double> readMs;
+    QVector<double> readValues;
+    for (int w = 0; w < 4; ++w)
+    {
+        int first = windows[w][0];
+        int last = windows[w][1];
+        int count = store.read(ms.at(first), ms.at(last), readMs, readValues);
+        QCOMPARE(count, last - first + 1);
+        QCOMPARE(readMs.first(), ms.at(first));
+        QCOMPARE(readMs.last(), ms.at(last));
+        QVERIFY(sameValue(readValues.at(count / 2), values.at(first + count / 2)));
+    }
+
+    // Windows between two samples and outside the series
+    QCOMPARE(store.read(ms.at(5) + 1, ms.at(6) - 1, readMs, readValues), 0);
+    QCOMPARE(store.read(0, ms.first() - 1, readMs, readValues), 0);
+    QCOMPARE(store.read(ms.last() + 1, ms.last() + 1000, readMs, readValues), 0);
+    QCOMPARE(store.read(ms.last(), ms.first(), readMs, readValues), 0);
+}
+
+void TimeSeriesStoreTest::recent_test()
+{
+    TimeSeriesStore store;
+    for (int i = 0; i < 30000; ++i)
+    {
+        store.append(1000 + i * 20, i);
+    }
+    QCOMPARE(store.recentValue(0), 29999.0);
+    QCOMPARE(store.recentTime(0), static_cast<quint64>(1000 + 29999 * 20));
+    QCOMPARE(store.recentValue(store.rawCount() - 1), 30000.0 - store.rawCount());
+
+    store.clear();
+    QCOMPARE(store.count(), 0);
+    QCOMPARE(store.firstTime(), static_cast<quint64>(0));
+    store.append(5, 1.5);
+    QCOMPARE(store.recentValue(0), 1.5);
+}
+
+void TimeSeriesStoreTest::dropOldestBlock_test()
+{
+    makeSeries(20000);
+    TimeSeriesStore store;
+    for (int i = 0; i < ms.size(); ++i)
+    {
+        store.append(ms.at(i), values.at(i));
+    }
+    int blocks = store.blockCount();
+    QVERIFY(blocks > 1);
+    quint64 end = store.oldestBlockEnd();
+    QCOMPARE(end, static_cast<quint64>(ms.at(TimeSeriesStore::BLOCK_SIZE - 1)));
+
+    qint64 usage = store.memoryUsage();
+    QCOMPARE(store.dropOldestBlock(), static_cast<int>(TimeSeriesStore::BLOCK_SIZE));
+    QCOMPARE(store.blockCount(), blocks - 1);
+    QVERIFY(store.memoryUsage() < usage);
+    QCOMPARE(store.firstTime(), static_cast<quint64>(ms.at(TimeSeriesStore::BLOCK_SIZE)));
+
+    // The dropped samples are gone, the rest is still there
+    QVector<double> readMs;
+    QVector<double> readValues;
+    QCOMPARE(store.read(0, end, readMs, readValues), 0);
+    QCOMPARE(store.read(0, ms.last(), readMs, readValues), ms.size() - TimeSeriesStore::BLOCK_SIZE);
+
+    while (store.dropOldestBlock() > 0) {}
+    QCOMPARE(store.count(), store.rawCount());
+    QCOMPARE(store.oldestBlockEnd(), static_cast<quint64>(0));
+}
+
+void TimeSeriesStoreTest::timeBackwards_test()
+{
+    TimeSeriesStore store;
+    for (int i = 0; i < 20000; ++i)
+    {
+        // The clock jumps back by a second every 3000 samples
+        quint64 time = 100000 + i * 20 - (i / 3000) * 1000;
+        store.append(time, i);
+    }
+    QCOMPARE(store.count(), 20000);
+    QVERIFY(store.blockCount() > 1);
+
+    // Every sample is still read, in ascending order of time
+    QVector<double> readMs;
+    QVector<double> readValues;
+    QCOMPARE(store.read(0, Q_UINT64_C(0xFFFFFFFFFFFFFFFF), readMs, readValues), 20000);
+    for (int i = 1; i < readMs.size(); ++i)
+    {
+        QVERIFY(readMs.at(i) >= readMs.at(i - 1));
+        QCOMPARE(readValues.at(i), static_cast<double>(i));
+    }
+    // The first sample after a jump takes the time of the one before
+    QCOMPARE(readMs.at(3000), readMs.at(2999));
+
+    // A window in the raw tier finds its first sample
+    quint64 start = store.recentTime(100);
+    QCOMPARE(store.read(start, store.recentTime(0), readMs, readValues), 101);
+    QCOMPARE(readValues.first(), 19899.0);
+}
+
+void TimeSeriesStoreTest::compression_test()
+{
+    const int count = 200000;
+    makeSeries(count);
+    TimeSeriesStore store;
+
+    for (int i = 0; i < count; ++i)
+    {
+        store.append(ms.at(i), values.at(i));
+    }
+
+    // Scrolling back one plot window of 8 seconds into the compressed history
+    QVector<double> readMs;
+    QVector<double> readValues;
+    int read = store.read(ms.at(1000), ms.at(1000) + 8000, readMs, readValues);
+    QVERIFY(read > 0);
+
+    int compressed = store.blockCount() * TimeSeriesStore::BLOCK_SIZE;
+    double bitsPerSample = store.compressedBytes() * 8.0 / compressed;
+    // Raw samples take 128 bits
+    QVERIFY(bitsPerSample < 40.0);
+    QVERIFY(store.memoryUsage() < static_cast<qint64>(count) * 16 / 3);
+}
@@ -0,0 +1,44 @@
+#ifndef TIMESERIESSTORETEST_H
+#define TIMESERIESSTORETEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "TimeSeriesStore.h"
+#include "AutoTest.h"
+
+class TimeSeriesStoreTest : public QObject
+{
+    Q_OBJECT
+public:
+    TimeSeriesStoreTest();
+
+private slots:
+    void init();
+
+    void roundTrip_test();
+    void window_test();
+    void recent_test();
+    void dropOldestBlock_test();
+    void timeBackwards_test();
+    void compression_test();
+
+private:
+    /**
+     * @brief Telemetry like series: 50 Hz with jitter and gaps, a slow sine
+     *        with noise, constant runs, NaN and infinite values mixed in
+     */
+    void makeSeries(int count);
+    /** @brief Deterministic uniform number in 0..1 */
+    double random();
+    /** @brief Same value, comparing the bits so NaN equals NaN */
+    static bool sameValue(double a, double b);
+
+    quint32 seed;
+    QVector<double> ms;
+    QVector<double> values;
+};
+
+DECLARE_TEST(TimeSeriesStoreTest)
+
+#endif // TIMESERIESSTORETEST_H
@@ -0,0 +1,48 @@
+#include "UDPLinkBenchmark.h"
+
+#include <QUdpSocket>
+
+#include "UDPLink.h"
+#include "QGCMAVLink.h"
+
+namespace
+{
+const quint16 PORT = 14596;
+/** @brief Datagrams per iteration, small enough for the receive buffer of the socket */
+const int BURST = 200;
+}
+
+UDPLinkBenchmark::UDPLinkBenchmark()
+{
+    qRegisterMetaType<LinkInterface*>("LinkInterface*");
+}
+
+void UDPLinkBenchmark::receive_benchmark()
+{
+    UDPLink link(QHostAddress::LocalHost, PORT);
+    QVERIFY(link.connect());
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+    mavlink_message_t message;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    mavlink_msg_heartbeat_pack(1, 1, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    const int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+    quint64 target = 0;
+    QBENCHMARK {
+        target += BURST;
+        for (int i = 0; i < BURST; i++)
+        {
+            sender.writeDatagram((const char*)buffer, length, QHostAddress::LocalHost, PORT);
+        }
+        for (int wait = 0; wait < 1000 && link.getDatagramsReceived() < target; wait++)
+        {
+            QTest::qWait(1);
+        }
+    }
+    QCOMPARE(link.getDatagramsReceived(), target);
+    // Datagrams are delivered in batches, not one signal each
+    QVERIFY(link.getDeliveries() < link.getDatagramsReceived());
+    link.disconnect();
+}
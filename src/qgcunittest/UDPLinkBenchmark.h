@@ -0,0 +1,21 @@
+#ifndef UDPLINKBENCHMARK_H
+#define UDPLINKBENCHMARK_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "AutoTest.h"
+
+/** @brief Receiving bursts of MAVLink datagrams on a UDP link over loopback */
+class UDPLinkBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    UDPLinkBenchmark();
+
+private slots:
+    void receive_benchmark();
+};
+
+DECLARE_TEST(UDPLinkBenchmark)
+#endif // UDPLINKBENCHMARK_H
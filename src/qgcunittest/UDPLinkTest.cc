@@ -0,0 +1,209 @@
+#include "UDPLinkTest.h"
+#include "QGCMAVLink.h"
+
+#include <QUdpSocket>
+
+UDPLinkTest::UDPLinkTest()
+{
+    qRegisterMetaType<LinkInterface*>("LinkInterface*");
+}
+
+void UDPLinkTest::peerTable_test()
+{
+    UDPPeerTable table;
+    QHostAddress vehicle("192.168.1.10");
+    QHostAddress companion("192.168.1.20");
+
+    QVERIFY(table.seen(vehicle, 14555, 1000));
+    QVERIFY(!table.seen(vehicle, 14555, 1100));
+    QCOMPARE(table.getPeer(vehicle, 14555).packets, Q_UINT64_C(2));
+    QCOMPARE(table.getPeer(vehicle, 14555).lastSeen, Q_UINT64_C(1100));
+
+    // Updating a known peer does not invalidate cached destinations
+    quint64 revision = table.getRevision();
+    table.seen(vehicle, 14555, 1200);
+    QCOMPARE(table.getRevision(), revision);
+
+    table.addStatic(companion, 14550);
+    QCOMPARE(table.size(), 2);
+    QVERIFY(table.getPeer(companion, 14550).isStatic);
+    QVERIFY(table.getAddresses().contains(companion));
+
+    QVERIFY(table.remove(vehicle, 14555));
+    QVERIFY(!table.remove(vehicle, 14555));
+    QCOMPARE(table.size(), 1);
+}
+
+void UDPLinkTest::peerPorts_test()
+{
+    // Several SITL instances on one host are told apart by their port
+    UDPPeerTable table;
+    QHostAddress localhost(QHostAddress::LocalHost);
+
+    QVERIFY(table.seen(localhost, 14550, 1000));
+    QVERIFY(table.seen(localhost, 14560, 1000));
+    QCOMPARE(table.size(), 2);
+
+    // Alternating datagrams neither flip a port nor change the revision
+    quint64 revision = table.getRevision();
+    for (int i = 0; i < 10; i++)
+    {
+        QVERIFY(!table.seen(localhost, 14550, 1100 + i));
+        QVERIFY(!table.seen(localhost, 14560, 1100 + i));
+    }
+    QCOMPARE(table.getRevision(), revision);
+    QCOMPARE(table.getPeer(localhost, 14550).packets, Q_UINT64_C(11));
+    QCOMPARE(table.getPeer(localhost, 14560).packets, Q_UINT64_C(11));
+    QCOMPARE(table.getAddresses().count(localhost), 2);
+
+    // Without a port all peers of the address go
+    table.addStatic(QHostAddress("192.168.1.10"), 14550);
+    QCOMPARE(table.remove(localhost), 2);
+    QCOMPARE(table.size(), 1);
+    QVERIFY(table.getRevision() != revision);
+}
+
+void UDPLinkTest::peerExpiry_test()
+{
+    UDPPeerTable table(5000);
+    QHostAddress learned("10.0.0.1");
+    QHostAddress configured("10.0.0.2");
+    table.seen(learned, 14550, 1000);
+    table.addStatic(configured, 14550);
+
+    QCOMPARE(table.expire(6000), 0);
+    QCOMPARE(table.expire(6001), 1);
+    QVERIFY(!table.contains(learned, 14550));
+    // Configured hosts stay even if nothing is received from them
+    QVERIFY(table.contains(configured, 14550));
+
+    table.setIdleTimeout(0);
+    table.seen(learned, 14550, 1000);
+    QCOMPARE(table.expire(1000000), 0);
+}
+
+void UDPLinkTest::loopback_test()
+{
+    const quint16 port = 14598;
+    UDPLink link(QHostAddress::LocalHost, port);
+    QVERIFY(link.connect());
+    QSignalSpy received(&link, SIGNAL(bytesReceived(LinkInterface*,QByteArray)));
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    mavlink_message_t message;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    mavlink_msg_heartbeat_pack(1, 1, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_ARDUPILOTMEGA, 81, 5, MAV_STATE_ACTIVE);
+    const int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+    // Bursts small enough for the receive buffer of the socket, so loopback drops nothing
+    const int bursts = 100;
+    const int burstSize = 200;
+    const qint64 expectedBytes = (qint64)bursts * burstSize * length;
+    qint64 bytes = 0;
+    for (int b = 0; b < bursts; b++)
+    {
+        for (int i = 0; i < burstSize; i++)
+        {
+            QCOMPARE(sender.writeDatagram((const char*)buffer, length, QHostAddress::LocalHost, port), (qint64)length);
+        }
+        for (int wait = 0; wait < 100 && (qint64)link.getDatagramsReceived() < (qint64)(b + 1) * burstSize; wait++)
+        {
+            QTest::qWait(1);
+        }
+    }
+
+    for (int i = 0; i < received.count(); i++)
+    {
+        bytes += received.at(i).at(1).toByteArray().size();
+    }
+    QCOMPARE(bytes, expectedBytes);
+    QCOMPARE(link.getDatagramsReceived(), (quint64)bursts * burstSize);
+    QCOMPARE(link.getDeliveries(), (quint64)received.count());
+    // Datagrams are delivered in batches, not one signal each
+    QVERIFY(link.getDeliveries() < link.getDatagramsReceived());
+
+    // The sender was learned as a peer and gets the replies
+    QVERIFY(link.getHosts().contains(QHostAddress(QHostAddress::LocalHost)));
+    link.writeBytes((const char*)buffer, length);
+    for (int wait = 0; wait < 100 && !sender.hasPendingDatagrams(); wait++)
+    {
+        QTest::qWait(10);
+    }
+    QVERIFY(sender.hasPendingDatagrams());
+    QByteArray reply(sender.pendingDatagramSize(), 0);
+    sender.readDatagram(reply.data(), reply.size());
+    QCOMPARE(reply, QByteArray((const char*)buffer, length));
+
+    link.disconnect();
+}
+
+void UDPLinkTest::deliverySize_test()
+{
+    const quint16 port = 14599;
+    UDPLink link(QHostAddress::LocalHost, port);
+    QVERIFY(link.connect());
+    QSignalSpy received(&link, SIGNAL(bytesReceived(LinkInterface*,QByteArray)));
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    // More than one delivery queued at once, in datagrams that do not divide it
+    const int count = 120;
+    const QByteArray datagram(1500, 'x');
+    for (int i = 0; i < count; i++)
+    {
+        QCOMPARE(sender.writeDatagram(datagram, QHostAddress::LocalHost, port), (qint64)datagram.size());
+    }
+    for (int wait = 0; wait < 100 && link.getDatagramsReceived() < (quint64)count; wait++)
+    {
+        QTest::qWait(10);
+    }
+    QCOMPARE(link.getDatagramsReceived(), (quint64)count);
+
+    qint64 bytes = 0;
+    for (int i = 0; i < received.count(); i++)
+    {
+        int size = received.at(i).at(1).toByteArray().size();
+        QVERIFY(size <= UDPLink::MAX_DELIVERY_SIZE);
+        bytes += size;
+    }
+    QCOMPARE(bytes, (qint64)count * datagram.size());
+
+    link.disconnect();
+}
+
+void UDPLinkTest::largeDatagram_test()
+{
+    const quint16 port = 14597;
+    UDPLink link(QHostAddress::LocalHost, port);
+    QVERIFY(link.connect());
+    QSignalSpy received(&link, SIGNAL(bytesReceived(LinkInterface*,QByteArray)));
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    // Bridges pack many frames into one datagram, the queued ones are read in batches
+    QByteArray expected;
+    for (int i = 0; i < 4; i++)
+    {
+        const QByteArray datagram(i == 0 ? 100 : 20000, 'a' + i);
+        QCOMPARE(sender.writeDatagram(datagram, QHostAddress::LocalHost, port), (qint64)datagram.size());
+        expected.append(datagram);
+    }
+    for (int wait = 0; wait < 100 && link.getDatagramsReceived() < 4; wait++)
+    {
+        QTest::qWait(10);
+    }
+    QCOMPARE(link.getDatagramsReceived(), (quint64)4);
+
+    QByteArray bytes;
+    for (int i = 0; i < received.count(); i++)
+    {
+        bytes.append(received.at(i).at(1).toByteArray());
+    }
+    QCOMPARE(bytes, expected);
+
+    link.disconnect();
+}
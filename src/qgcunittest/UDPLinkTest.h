@@ -0,0 +1,28 @@
+#ifndef UDPLINKTEST_H
+#define UDPLINKTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "UDPLink.h"
+#include "UDPPeerTable.h"
+#include "AutoTest.h"
+
+class UDPLinkTest : public QObject
+{
+    Q_OBJECT
+public:
+    UDPLinkTest();
+
+private slots:
+    void peerTable_test();
+    void peerPorts_test();
+    void peerExpiry_test();
+    void loopback_test();
+    void deliverySize_test();
+    void largeDatagram_test();
+};
+
+DECLARE_TEST(UDPLinkTest)
+
+#endif // UDPLINKTEST_H
@@ -0,0 +1,116 @@
+#include "VehicleStateBenchmark.h"
+
+#include <string.h>
+
+#include "MAVLinkLoadLink.h"
+
+namespace
+{
+/** @brief Messages of the telemetry mix handed to the vehicle per iteration */
+const int MESSAGES = 10000;
+/** @brief 1000 messages per second against a 25 Hz display */
+const int MESSAGES_PER_FRAME = 40;
+}
+
+VehicleStateBenchmark::VehicleStateBenchmark() :
+    protocol(NULL)
+{
+    qRegisterMetaType<UASInterface*>("UASInterface*");
+}
+
+void VehicleStateBenchmark::initTestCase()
+{
+    protocol = new MAVLinkProtocol();
+
+    MAVLinkLoadLink link(1, 50000);
+    QByteArray block;
+    QCOMPARE(link.generate(block, MESSAGES), MESSAGES);
+
+    const uint8_t channel = MAVLINK_COMM_1;
+    memset(mavlink_get_channel_status(channel), 0, sizeof(mavlink_status_t));
+    mavlink_message_t message;
+    mavlink_status_t status;
+    for (int i = 0; i < block.size(); i++)
+    {
+        if (mavlink_parse_char(channel, (uint8_t)block.at(i), &message, &status))
+        {
+            messages.append(message);
+        }
+    }
+    QCOMPARE(messages.size(), MESSAGES);
+}
+
+void VehicleStateBenchmark::cleanupTestCase()
+{
+    messages.clear();
+    delete protocol;
+    protocol = NULL;
+}
+
+void VehicleStateBenchmark::connectInstruments(UASInterface* uas, InstrumentReceiver* receiver)
+{
+    connect(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)), receiver, SLOT(attitude(UASInterface*,double,double,double,quint64)));
+    connect(uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)), receiver, SLOT(position(UASInterface*,double,double,double,quint64)));
+    connect(uas, SIGNAL(globalPositionChanged(UASInterface*,double,double,double,quint64)), receiver, SLOT(position(UASInterface*,double,double,double,quint64)));
+    connect(uas, SIGNAL(velocityChanged_NED(UASInterface*,double,double,double,quint64)), receiver, SLOT(position(UASInterface*,double,double,double,quint64)));
+    connect(uas, SIGNAL(primarySpeedChanged(UASInterface*,double,quint64)), receiver, SLOT(value(UASInterface*,double,quint64)));
+    connect(uas, SIGNAL(gpsSpeedChanged(UASInterface*,double,quint64)), receiver, SLOT(value(UASInterface*,double,quint64)));
+    connect(uas, SIGNAL(climbRateChanged(UASInterface*,double,quint64)), receiver, SLOT(value(UASInterface*,double,quint64)));
+    connect(uas, SIGNAL(primaryAltitudeChanged(UASInterface*,double,quint64)), receiver, SLOT(value(UASInterface*,double,quint64)));
+    connect(uas, SIGNAL(gpsAltitudeChanged(UASInterface*,double,quint64)), receiver, SLOT(value(UASInterface*,double,quint64)));
+    connect(uas, SIGNAL(navigationControllerErrorsChanged(UASInterface*,double,double,double)), receiver, SLOT(errors(UASInterface*,double,double,double)));
+}
+
+void VehicleStateBenchmark::instruments_benchmark_data()
+{
+    QTest::addColumn<bool>("polling");
+    QTest::newRow("signals") << false;
+    QTest::newRow("snapshot") << true;
+}
+
+void VehicleStateBenchmark::instruments_benchmark()
+{
+    QFETCH(bool, polling);
+    MAVLinkLoadLink link(1, 50000);
+    UAS uas(protocol, 1);
+    InstrumentReceiver receiver;
+    if (!polling)
+    {
+        connectInstruments(&uas, &receiver);
+    }
+
+    const VehicleStateBuffer* buffer = uas.getVehicleState();
+    quint64 version = 0;
+    int reads = 0;
+    VehicleState state;
+    QBENCHMARK {
+        receiver.deliveries = 0;
+        reads = 0;
+        for (int i = 0; i < messages.size(); i++)
+        {
+            uas.receiveMessage(&link, messages.at(i));
+            if (polling)
+            {
+                // The decoder thread writes the snapshot
+                protocol->updateVehicleState(messages.at(i));
+            }
+            if (polling && (i + 1) % MESSAGES_PER_FRAME == 0 && buffer->readIfNewer(version, state))
+            {
+                reads++;
+                receiver.sum += state.roll + state.pitch + state.yaw;
+            }
+        }
+    }
+
+    if (polling)
+    {
+        QCOMPARE(receiver.deliveries, 0);
+        QVERIFY(reads > 0 && reads <= MESSAGES / MESSAGES_PER_FRAME);
+    }
+    else
+    {
+        QVERIFY(receiver.deliveries > MESSAGES / 2);
+    }
+    qDebug() << "Instruments:" << messages.size() << "messages," << receiver.deliveries
+             << "slot calls," << reads << "snapshot reads";
+}
@@ -0,0 +1,58 @@
+#ifndef VEHICLESTATEBENCHMARK_H
+#define VEHICLESTATEBENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QtTest/QtTest>
+
+#include "UAS.h"
+#include "MAVLinkProtocol.h"
+#include "AutoTest.h"
+
+/**
+ * @brief Stands in for the instruments which were fed by per-value signals:
+ *        every slot stores its values like the PFD and HUD slots did
+ */
+class InstrumentReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    InstrumentReceiver() : deliveries(0), sum(0) {}
+
+    int deliveries;
+    double sum;
+
+public slots:
+    void attitude(UASInterface*, double roll, double pitch, double yaw, quint64) { deliveries++; sum += roll + pitch + yaw; }
+    void position(UASInterface*, double x, double y, double z, quint64) { deliveries++; sum += x + y + z; }
+    void value(UASInterface*, double value, quint64) { deliveries++; sum += value; }
+    void errors(UASInterface*, double altitude, double speed, double xtrack) { deliveries++; sum += altitude + speed + xtrack; }
+};
+
+/**
+ * @brief Cost of feeding the instruments from the telemetry: per-value
+ *        signals against polling the VehicleState snapshot once per frame
+ */
+class VehicleStateBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    VehicleStateBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void instruments_benchmark_data();
+    void instruments_benchmark();
+
+private:
+    /** @brief Connect the receiver to the signals the PFD and the HUD were connected to */
+    static void connectInstruments(UASInterface* uas, InstrumentReceiver* receiver);
+
+    MAVLinkProtocol* protocol;
+    QList<mavlink_message_t> messages;
+};
+
+DECLARE_TEST(VehicleStateBenchmark)
+#endif // VEHICLESTATEBENCHMARK_H
@@ -0,0 +1,216 @@
+#include "VehicleStateTest.h"
+
+namespace
+{
+/** Publishes states with all attitude fields set to the same counter */
+class WriterThread : public QThread
+{
+public:
+    WriterThread(VehicleStateBuffer* buffer, int count) : buffer(buffer), count(count) {}
+
+protected:
+    void run()
+    {
+        for (int i = 1; i <= count; i++)
+        {
+            VehicleState& state = buffer->edit();
+            state.roll = i;
+            state.pitch = i;
+            state.yaw = i;
+            state.airSpeed = i;
+            buffer->publish(i);
+        }
+    }
+
+    VehicleStateBuffer* buffer;
+    int count;
+};
+}
+
+VehicleStateTest::VehicleStateTest() :
+    mav(NULL),
+    link(NULL),
+    uas(NULL)
+{
+    qRegisterMetaType<UASInterface*>("UASInterface*");
+}
+
+void VehicleStateTest::init()
+{
+    mav = new MAVLinkProtocol();
+    link = new SerialLink();
+    uas = new UAS(mav, 1);
+    uas->deleteSettings();
+}
+
+void VehicleStateTest::cleanup()
+{
+    delete uas;
+    uas = NULL;
+    delete link;
+    link = NULL;
+    delete mav;
+    mav = NULL;
+}
+
+void VehicleStateTest::publish_test()
+{
+    VehicleStateBuffer buffer;
+    QCOMPARE(buffer.getVersion(), (quint64)0);
+    QVERIFY(!buffer.isModified());
+
+    buffer.edit().roll = 1.0;
+    QVERIFY(buffer.isModified());
+    // Not visible to readers before it is published
+    QCOMPARE(buffer.read().roll, 0.0);
+    QCOMPARE(buffer.getVersion(), (quint64)0);
+
+    QCOMPARE(buffer.publish(10), (quint64)1);
+    QVERIFY(!buffer.isModified());
+    QCOMPARE(buffer.read().roll, 1.0);
+    QCOMPARE(buffer.read().timestamp, (quint64)10);
+
+    quint64 version = 0;
+    VehicleState state;
+    QVERIFY(buffer.readIfNewer(version, state));
+    QCOMPARE(version, (quint64)1);
+    QCOMPARE(state.roll, 1.0);
+    // Nothing new, the caller can skip its repaint
+    QVERIFY(!buffer.readIfNewer(version, state));
+
+    // Fields not written again keep their value
+    buffer.edit().pitch = 2.0;
+    QCOMPARE(buffer.publish(20), (quint64)2);
+    QVERIFY(buffer.readIfNewer(version, state));
+    QCOMPARE(state.roll, 1.0);
+    QCOMPARE(state.pitch, 2.0);
+}
+
+void VehicleStateTest::concurrentRead_test()
+{
+    const int count = 200000;
+    VehicleStateBuffer buffer;
+    WriterThread writer(&buffer, count);
+    writer.start();
+
+    quint64 version = 0;
+    int reads = 0;
+    VehicleState state;
+    while (!writer.isFinished() || version < (quint64)count)
+    {
+        quint64 previous = version;
+        if (!buffer.readIfNewer(version, state)) continue;
+        reads++;
+        // A snapshot is always one complete publish()
+        QVERIFY(version > previous);
+        QCOMPARE(state.version, version);
+        QCOMPARE(state.timestamp, version);
+        QCOMPARE(state.roll, (double)version);
+        QCOMPARE(state.pitch, state.roll);
+        QCOMPARE(state.yaw, state.roll);
+        QCOMPARE(state.airSpeed, state.roll);
+    }
+    writer.wait();
+    QCOMPARE(version, (quint64)count);
+    QVERIFY(reads > 0);
+}
+
+void VehicleStateTest::uasSnapshot_test()
+{
+    const VehicleStateBuffer* buffer = uas->getVehicleState();
+    QCOMPARE(buffer->getVersion(), (quint64)0);
+
+    // The decoder threads write the snapshot through the protocol, not the UAS
+    mavlink_message_t msg;
+    mavlink_msg_attitude_pack(1, 1, &msg, 1000, 0.1f, -0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+    uas->receiveMessage(link, msg);
+    QCOMPARE(buffer->getVersion(), (quint64)0);
+    mav->updateVehicleState(msg);
+    QCOMPARE(buffer->getVersion(), (quint64)1);
+    VehicleState state = buffer->read();
+    QVERIFY(state.attitudeKnown);
+    QCOMPARE((float)state.roll, 0.1f);
+    QCOMPARE((float)state.pitch, -0.2f);
+    QCOMPARE((float)state.yaw, 0.3f);
+    QCOMPARE((float)state.yawSpeed, 0.03f);
+    QVERIFY(!state.airSpeedKnown);
+
+    mavlink_msg_vfr_hud_pack(1, 1, &msg, 12.0f, 10.0f, 30, 55, 100.0f, 1.5f);
+    mav->updateVehicleState(msg);
+    QCOMPARE(buffer->getVersion(), (quint64)2);
+    state = buffer->read();
+    QVERIFY(state.airSpeedKnown);
+    QCOMPARE(state.airSpeed, 12.0);
+    QCOMPARE(state.groundSpeed, 10.0);
+    QCOMPARE(state.primaryAltitude, 100.0);
+    QCOMPARE(state.climbRate, 1.5);
+    QCOMPARE(state.throttle, 0.55);
+    // The attitude of the previous message is still there
+    QCOMPARE((float)state.roll, 0.1f);
+
+    // Messages of other systems and other components do not touch the snapshot
+    mavlink_msg_attitude_pack(2, 1, &msg, 2000, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+    mav->updateVehicleState(msg);
+    mavlink_msg_attitude_pack(1, 2, &msg, 2000, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+    mav->updateVehicleState(msg);
+    QCOMPARE(buffer->getVersion(), (quint64)2);
+
+    // Without an estimate the raw GPS position stands in, the estimate replaces it for good
+    mavlink_msg_gps_raw_int_pack(1, 1, &msg, 0, 3, 473000000, 85000000, 500000, 100, 100, 250, 0, 8);
+    mav->updateVehicleState(msg);
+    state = buffer->read();
+    QVERIFY(state.globalPositionKnown);
+    QCOMPARE(state.latitude, 47.3);
+    QCOMPARE(state.satelliteCount, 8);
+    mavlink_msg_global_position_int_pack(1, 1, &msg, 0, 473500000, 85500000, 510000, 10000, 300, 400, 0, 0);
+    mav->updateVehicleState(msg);
+    mavlink_msg_gps_raw_int_pack(1, 1, &msg, 0, 3, 473000000, 85000000, 500000, 100, 100, 250, 0, 9);
+    mav->updateVehicleState(msg);
+    state = buffer->read();
+    QCOMPARE(state.latitude, 47.35);
+    QCOMPARE(state.relativeAltitude, 10.0);
+    QCOMPARE(state.groundSpeed, 5.0);
+    QCOMPARE(state.satelliteCount, 9);
+}
+
+void VehicleStateTest::frameRate_test()
+{
+    // 2000 messages per second telemetry against a 25 Hz display
+    const int messages = 2000;
+    const int messagesPerFrame = messages / 25;
+
+    QSignalSpy attitudeSpy(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)));
+    QSignalSpy speedSpy(uas, SIGNAL(primarySpeedChanged(UASInterface*,double,quint64)));
+
+    const VehicleStateBuffer* buffer = uas->getVehicleState();
+    quint64 version = 0;
+    int repaints = 0;
+    VehicleState state;
+    mavlink_message_t msg;
+    for (int i = 0; i < messages; i++)
+    {
+        if (i % 2 == 0)
+        {
+            mavlink_msg_attitude_pack(1, 1, &msg, i, 0.001f * i, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+        else
+        {
+            mavlink_msg_vfr_hud_pack(1, 1, &msg, 0.01f * i, 0.0f, 0, 50, 100.0f, 0.0f);
+        }
+        uas->receiveMessage(link, msg);
+        mav->updateVehicleState(msg);
+
+        if ((i + 1) % messagesPerFrame == 0 && buffer->readIfNewer(version, state))
+        {
+            repaints++;
+        }
+    }
+    // A frame without new messages does not repaint
+    QVERIFY(!buffer->readIfNewer(version, state));
+
+    QCOMPARE(version, (quint64)messages);
+    QCOMPARE(repaints, messages / messagesPerFrame);
+    QCOMPARE(state.airSpeed, (double)(0.01f * (messages - 1)));
+    // The signals fire per message, the snapshot is read once per frame
+    QVERIFY(attitudeSpy.count() + speedSpy.count() > repaints);
+}
@@ -0,0 +1,35 @@
+#ifndef VEHICLESTATETEST_H
+#define VEHICLESTATETEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "UAS.h"
+#include "MAVLinkProtocol.h"
+#include "SerialLink.h"
+#include "VehicleState.h"
+#include "AutoTest.h"
+
+class VehicleStateTest : public QObject
+{
+    Q_OBJECT
+public:
+    VehicleStateTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void publish_test();
+    void concurrentRead_test();
+    void uasSnapshot_test();
+    void frameRate_test();
+
+private:
+    MAVLinkProtocol* mav;
+    SerialLink* link;
+    UAS* uas;
+};
+
+DECLARE_TEST(VehicleStateTest)
+#endif // VEHICLESTATETEST_H
@@ -0,0 +1,133 @@
+#include "WaypointTableBenchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+namespace
+{
+/** @brief Cell edits per iteration */
+const int EDITS = 200;
+/** @brief Rows a table view shows */
+const int VISIBLE_ROWS = 30;
+}
+
+WaypointTableBenchmark::WaypointTableBenchmark() :
+    wpm(NULL),
+    model(NULL)
+{
+    fileName = QDir::temp().filePath("WaypointTableBenchmark.txt");
+}
+
+void WaypointTableBenchmark::init()
+{
+    wpm = new UASWaypointManager(NULL);
+    model = new WaypointTableModel(WaypointTableModel::EDITABLE);
+    model->setWaypointManager(wpm);
+}
+
+void WaypointTableBenchmark::cleanup()
+{
+    delete model;
+    model = NULL;
+    delete wpm;
+    wpm = NULL;
+    QFile::remove(fileName);
+}
+
+void WaypointTableBenchmark::addRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("100 waypoints") << 100;
+    QTest::newRow("1000 waypoints") << 1000;
+    QTest::newRow("5000 waypoints") << 5000;
+}
+
+void WaypointTableBenchmark::loadMission(int count)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "QGC WPL 120\r\n";
+    for (int i = 0; i < count; i++)
+    {
+        // A lawnmower pattern, like a survey mission
+        Waypoint wp(i, 47.0 + (i / 20) * 0.0001, 8.0 + (i % 20) * 0.0001, 50.0, 0, 5.0, 0, 0,
+                    true, i == 0, MAV_FRAME_GLOBAL_RELATIVE_ALT, MAV_CMD_NAV_WAYPOINT);
+        wp.save(out);
+    }
+    file.close();
+    wpm->loadWaypoints(fileName);
+    QCOMPARE(model->rowCount(), count);
+}
+
+void WaypointTableBenchmark::paintRows(int row)
+{
+    int first = qMax(0, row - VISIBLE_ROWS / 2);
+    int last = qMin(model->rowCount(), first + VISIBLE_ROWS);
+    for (int r = first; r < last; r++)
+    {
+        for (int c = 0; c < model->columnCount(); c++)
+        {
+            model->data(model->index(r, c), Qt::DisplayRole);
+        }
+    }
+}
+
+void WaypointTableBenchmark::load_benchmark_data()
+{
+    addRows();
+}
+
+void WaypointTableBenchmark::load_benchmark()
+{
+    QFETCH(int, count);
+    loadMission(count);
+    QBENCHMARK {
+        wpm->loadWaypoints(fileName);
+        paintRows(0);
+    }
+    QCOMPARE(model->rowCount(), count);
+}
+
+void WaypointTableBenchmark::edit_benchmark_data()
+{
+    addRows();
+}
+
+void WaypointTableBenchmark::edit_benchmark()
+{
+    QFETCH(int, count);
+    loadMission(count);
+
+    // Spread over the whole list
+    QBENCHMARK {
+        for (int i = 0; i < EDITS; i++)
+        {
+            int row = (i * 7919) % count;
+            model->setData(model->index(row, WaypointTableModel::COLUMN_Z), 60.0 + i);
+            paintRows(row);
+        }
+    }
+}
+
+void WaypointTableBenchmark::move_benchmark_data()
+{
+    addRows();
+}
+
+void WaypointTableBenchmark::move_benchmark()
+{
+    QFETCH(int, count);
+    loadMission(count);
+
+    // Structural edits in the middle of the list
+    QBENCHMARK {
+        for (int i = 0; i < EDITS / 2; i++)
+        {
+            wpm->moveWaypoint(count / 2, count / 4);
+            paintRows(count / 4);
+        }
+    }
+    QCOMPARE(model->rowCount(), count);
+}
@@ -0,0 +1,46 @@
+#ifndef WAYPOINTTABLEBENCHMARK_H
+#define WAYPOINTTABLEBENCHMARK_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "UASWaypointManager.h"
+#include "WaypointTableModel.h"
+#include "AutoTest.h"
+
+/**
+ * @brief Loading and editing large missions in the waypoint table, each
+ *        change repaints the rows a table view shows
+ */
+class WaypointTableBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    WaypointTableBenchmark();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void load_benchmark_data();
+    void load_benchmark();
+    void edit_benchmark_data();
+    void edit_benchmark();
+    void move_benchmark_data();
+    void move_benchmark();
+
+private:
+    /** @brief Data rows with the mission sizes */
+    static void addRows();
+    /** @brief Write a mission with count waypoints and load it */
+    void loadMission(int count);
+    /** @brief Read all cells of the rows a table view would show around row */
+    void paintRows(int row);
+
+    UASWaypointManager* wpm;
+    WaypointTableModel* model;
+    QString fileName;
+};
+
+DECLARE_TEST(WaypointTableBenchmark)
+#endif // WAYPOINTTABLEBENCHMARK_H
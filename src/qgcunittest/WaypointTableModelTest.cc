@@ -0,0 +1,163 @@
+#include "WaypointTableModelTest.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+
+WaypointTableModelTest::WaypointTableModelTest() :
+    wpm(NULL),
+    model(NULL)
+{
+    fileName = QDir::temp().filePath("WaypointTableModelTest.txt");
+    qRegisterMetaType<QModelIndex>("QModelIndex");
+}
+
+void WaypointTableModelTest::init()
+{
+    wpm = new UASWaypointManager(NULL);
+    model = new WaypointTableModel(WaypointTableModel::EDITABLE);
+    model->setWaypointManager(wpm);
+}
+
+void WaypointTableModelTest::cleanup()
+{
+    delete model;
+    model = NULL;
+    delete wpm;
+    wpm = NULL;
+    QFile::remove(fileName);
+}
+
+void WaypointTableModelTest::writeMission(const QString& fileName, int count)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    QTextStream out(&file);
+    out << "QGC WPL 120\r\n";
+    for (int i = 0; i < count; i++)
+    {
+        // A lawnmower pattern, like a survey mission
+        Waypoint wp(i, 47.0 + (i / 20) * 0.0001, 8.0 + (i % 20) * 0.0001, 50.0, 0, 5.0, 0, 0,
+                    true, i == 0, MAV_FRAME_GLOBAL_RELATIVE_ALT, MAV_CMD_NAV_WAYPOINT);
+        wp.save(out);
+    }
+}
+
+bool WaypointTableModelTest::inSync()
+{
+    const QList<Waypoint*>& list = wpm->getWaypointEditableList();
+    if (model->rowCount() != list.size())
+        return false;
+    for (int i = 0; i < list.size(); i++)
+    {
+        if (model->getWaypoint(i) != list.at(i) || list.at(i)->getId() != i)
+            return false;
+    }
+    return true;
+}
+
+void WaypointTableModelTest::paintRows(int row)
+{
+    const int visibleRows = 30;
+    int first = qMax(0, row - visibleRows / 2);
+    int last = qMin(model->rowCount(), first + visibleRows);
+    for (int r = first; r < last; r++)
+    {
+        for (int c = 0; c < model->columnCount(); c++)
+        {
+            model->data(model->index(r, c), Qt::DisplayRole);
+        }
+    }
+}
+
+void WaypointTableModelTest::incrementalRows_test()
+{
+    writeMission(fileName, 10);
+    wpm->loadWaypoints(fileName);
+    QCOMPARE(model->rowCount(), 10);
+    QVERIFY(inSync());
+
+    QSignalSpy resets(model, SIGNAL(modelReset()));
+    QSignalSpy inserted(model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removed(model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy moved(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+    QSignalSpy changed(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+
+    Waypoint* wp = wpm->createWaypoint();
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.at(0).at(1).toInt(), 10);
+    QCOMPARE(model->getWaypoint(10), wp);
+
+    wpm->moveWaypoint(2, 7);
+    wpm->moveWaypoint(7, 2);
+    wpm->moveWaypoint(9, 0);
+    QCOMPARE(moved.count(), 3);
+    QVERIFY(inSync());
+
+    wpm->removeWaypoint(4);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(removed.at(0).at(1).toInt(), 4);
+    QVERIFY(inSync());
+
+    // Editing through the model changes the waypoint, the waypoint reports back
+    changed.clear();
+    QModelIndex x = model->index(3, WaypointTableModel::COLUMN_X);
+    QVERIFY(model->setData(x, 47.5));
+    QCOMPARE(wpm->getWaypointEditableList().at(3)->getX(), 47.5);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 3);
+
+    QVERIFY(model->setData(model->index(5, WaypointTableModel::COLUMN_CURRENT), Qt::Checked, Qt::CheckStateRole));
+    QCOMPARE(model->data(model->index(5, WaypointTableModel::COLUMN_CURRENT), Qt::CheckStateRole).toInt(), (int)Qt::Checked);
+    QCOMPARE(model->data(model->index(0, WaypointTableModel::COLUMN_CURRENT), Qt::CheckStateRole).toInt(), (int)Qt::Unchecked);
+
+    QCOMPARE(resets.count(), 0);
+
+    // A reload replaces the whole list, that is a single reset
+    writeMission(fileName, 3);
+    wpm->loadWaypoints(fileName);
+    QCOMPARE(resets.count(), 1);
+    QVERIFY(inSync());
+}
+
+void WaypointTableModelTest::largeMission_test_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("5000") << 5000;
+}
+
+void WaypointTableModelTest::largeMission_test()
+{
+    QFETCH(int, count);
+    const int edits = 200;
+
+    writeMission(fileName, count);
+    wpm->loadWaypoints(fileName);
+    paintRows(0);
+    QCOMPARE(model->rowCount(), count);
+
+    // Spread the edits over the whole list, every edit repaints the visible rows
+    int row = 0;
+    for (int i = 0; i < edits; i++)
+    {
+        row = (i * 7919) % count;
+        QVERIFY(model->setData(model->index(row, WaypointTableModel::COLUMN_Z), 60.0 + i));
+        paintRows(row);
+    }
+    QCOMPARE(model->getWaypoint(row)->getZ(), 60.0 + edits - 1);
+
+    // Structural edits in the middle of the list
+    for (int i = 0; i < edits / 2; i++)
+    {
+        wpm->moveWaypoint(count / 2, count / 4);
+        paintRows(count / 4);
+    }
+    QVERIFY(inSync());
+
+    wpm->removeWaypoint(count / 2);
+    wpm->createWaypoint();
+    QCOMPARE(model->rowCount(), count);
+    QVERIFY(inSync());
+}
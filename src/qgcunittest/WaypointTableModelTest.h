@@ -0,0 +1,39 @@
+#ifndef WAYPOINTTABLEMODELTEST_H
+#define WAYPOINTTABLEMODELTEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+#include "UASWaypointManager.h"
+#include "WaypointTableModel.h"
+#include "AutoTest.h"
+
+class WaypointTableModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    WaypointTableModelTest();
+
+private slots:
+    void init();
+    void cleanup();
+
+    void incrementalRows_test();
+    void largeMission_test_data();
+    void largeMission_test();
+
+private:
+    /** @brief Write a mission file with count waypoints */
+    void writeMission(const QString& fileName, int count);
+    /** @brief True if the model shows exactly the list of the manager */
+    bool inSync();
+    /** @brief Read all cells of the rows a table view would show around row */
+    void paintRows(int row);
+
+    UASWaypointManager* wpm;
+    WaypointTableModel* model;
+    QString fileName;
+};
+
+DECLARE_TEST(WaypointTableModelTest)
+#endif // WAYPOINTTABLEMODELTEST_H
@@ -0,0 +1,97 @@
+#include "WebImageCacheBenchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+
+namespace
+{
+/** @brief Tiles the 3D view keeps */
+const int CACHE_SIZE = 1000;
+/** @brief Tiles looked up per frame */
+const int VISIBLE = 200;
+}
+
+WebImageCacheBenchmark::WebImageCacheBenchmark() :
+    cache(NULL)
+{
+}
+
+void WebImageCacheBenchmark::initTestCase()
+{
+    dir = QDir::tempPath() + QString("/WebImageCacheBenchmark%1/").arg(QCoreApplication::applicationPid());
+    QVERIFY(QDir().mkpath(dir));
+    for (int i = 0; i < CACHE_SIZE; i++)
+    {
+        QImage image(8, 8, QImage::Format_RGB32);
+        image.fill(qRgb(i % 256, i / 256, 0));
+        QString file = dir + QString("tile%1.png").arg(i);
+        QVERIFY(image.save(file));
+        tiles.append(file);
+    }
+
+    cache = new WebImageCache(0, CACHE_SIZE);
+    foreach (const QString& tile, tiles)
+    {
+        cache->lookup(tile);
+    }
+    for (int wait = 0; wait < 4000 && cache->hasPendingRequests(); wait++)
+    {
+        QTest::qWait(5);
+    }
+    QVERIFY(!cache->hasPendingRequests());
+}
+
+void WebImageCacheBenchmark::cleanupTestCase()
+{
+    delete cache;
+    cache = NULL;
+    foreach (const QString& file, tiles)
+    {
+        QFile::remove(file);
+    }
+    QDir().rmdir(dir);
+}
+
+void WebImageCacheBenchmark::lookup_benchmark_data()
+{
+    QTest::addColumn<bool>("scan");
+    QTest::newRow("hash") << false;
+    QTest::newRow("URL scan") << true;
+}
+
+void WebImageCacheBenchmark::lookup_benchmark()
+{
+    QFETCH(bool, scan);
+    QVector<WebImagePtr> images;
+    for (int i = 0; i < CACHE_SIZE; i++)
+    {
+        images.append(cache->at(i));
+    }
+
+    // One frame of Imagery::draw3D(), the scan is what lookup() did before the hash
+    int frame = 0;
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int i = 0; i < VISIBLE; i++)
+        {
+            const QString& url = tiles.at((frame + i * 5) % CACHE_SIZE);
+            if (!scan)
+            {
+                if (!cache->lookup(url).first.isNull()) found++;
+                continue;
+            }
+            for (int j = 0; j < images.size(); j++)
+            {
+                if (images[j]->getSourceURL() == url)
+                {
+                    found++;
+                    break;
+                }
+            }
+        }
+        frame++;
+    }
+    QCOMPARE(found, VISIBLE);
+}
@@ -0,0 +1,32 @@
+#ifndef WEBIMAGECACHEBENCHMARK_H
+#define WEBIMAGECACHEBENCHMARK_H
+
+#include <QObject>
+#include <QStringList>
+#include <QtTest/QtTest>
+
+#include "WebImageCache.h"
+#include "AutoTest.h"
+
+/** @brief Looking up the visible imagery tiles of a 3D view frame, by hash and by the URL scan it replaced */
+class WebImageCacheBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    WebImageCacheBenchmark();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void lookup_benchmark_data();
+    void lookup_benchmark();
+
+private:
+    QString dir;
+    QStringList tiles;
+    WebImageCache* cache;
+};
+
+DECLARE_TEST(WebImageCacheBenchmark)
+#endif // WEBIMAGECACHEBENCHMARK_H
@@ -0,0 +1,155 @@
+#include "WebImageCacheTest.h"
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+
+WebImageCacheTest::WebImageCacheTest()
+{
+}
+
+void WebImageCacheTest::initTestCase()
+{
+    dir = QDir::tempPath() + QString("/WebImageCacheTest%1/").arg(QCoreApplication::applicationPid());
+    QVERIFY(QDir().mkpath(dir));
+    // As many tiles as the 3D view keeps
+    for (int i = 0; i < 1000; i++)
+    {
+        QImage image(8, 8, QImage::Format_RGB32);
+        image.fill(qRgb(i % 256, i / 256, 0));
+        QString file = dir + QString("tile%1.png").arg(i);
+        QVERIFY(image.save(file));
+        tiles.append(file);
+    }
+}
+
+void WebImageCacheTest::cleanupTestCase()
+{
+    foreach (const QString& file, tiles)
+    {
+        QFile::remove(file);
+    }
+    QDir().rmdir(dir);
+}
+
+bool WebImageCacheTest::waitLoaded(WebImageCache& cache, int timeout)
+{
+    for (int wait = 0; wait < timeout / 5 && cache.hasPendingRequests(); wait++)
+    {
+        QTest::qWait(5);
+    }
+    return !cache.hasPendingRequests();
+}
+
+void WebImageCacheTest::load_test()
+{
+    WebImageCache cache(0, 8);
+    // Local tiles are read in the loader thread, not by lookup()
+    QPair<WebImagePtr, int> entry = cache.lookup(tiles.at(0));
+    QVERIFY(!entry.first.isNull());
+    QCOMPARE(entry.first->getState(), WebImage::REQUESTED);
+    QVERIFY(cache.hasPendingRequests());
+    QCOMPARE(cache.lookup(tiles.at(0)).second, -1);
+
+    QVERIFY(waitLoaded(cache));
+    QCOMPARE(cache.at(entry.second)->getState(), WebImage::READY);
+    QCOMPARE(cache.at(entry.second)->getWidth(), 8);
+    QVERIFY(cache.at(entry.second)->getSyncFlag());
+    QCOMPARE(cache.takeChanged(), QVector<int>() << entry.second);
+    QVERIFY(cache.takeChanged().isEmpty());
+
+    QPair<WebImagePtr, int> again = cache.lookup(tiles.at(0));
+    QCOMPARE(again.second, entry.second);
+    QCOMPARE(cache.indexOf(tiles.at(0)), entry.second);
+}
+
+void WebImageCacheTest::fileUrl_test()
+{
+    WebImageCache cache(0, 8);
+    QString url = QUrl::fromLocalFile(tiles.at(1)).toString();
+    int index = cache.lookup(url).second;
+    QVERIFY(index >= 0);
+    QVERIFY(waitLoaded(cache));
+    QCOMPARE(cache.at(index)->getState(), WebImage::READY);
+}
+
+void WebImageCacheTest::lru_test()
+{
+    WebImageCache cache(0, 4);
+    for (int i = 0; i < 4; i++)
+    {
+        cache.lookup(tiles.at(i));
+    }
+    QVERIFY(waitLoaded(cache));
+
+    // Tile 0 is used again, tile 1 is now the least recently used
+    QVERIFY(!cache.lookup(tiles.at(0)).first.isNull());
+    int evicted = cache.indexOf(tiles.at(1));
+    QCOMPARE(cache.lookup(tiles.at(4)).second, evicted);
+    QCOMPARE(cache.indexOf(tiles.at(1)), -1);
+    QVERIFY(cache.indexOf(tiles.at(0)) >= 0);
+    QVERIFY(waitLoaded(cache));
+
+    QCOMPARE(cache.lookup(tiles.at(5)).second, cache.indexOf(tiles.at(5)));
+    QCOMPARE(cache.indexOf(tiles.at(2)), -1);
+    QVERIFY(cache.indexOf(tiles.at(3)) >= 0);
+    QVERIFY(waitLoaded(cache));
+}
+
+void WebImageCacheTest::missing_test()
+{
+    WebImageCache cache(0, 2);
+    int index = cache.lookup(dir + "missing.png").second;
+    QVERIFY(index >= 0);
+    QVERIFY(waitLoaded(cache));
+
+    // The slot is free again and the tile is requested again next time
+    QCOMPARE(cache.indexOf(dir + "missing.png"), -1);
+    QCOMPARE(cache.takeChanged(), QVector<int>() << index);
+    QCOMPARE(cache.at(index)->getState(), WebImage::UNINITIALIZED);
+    QVERIFY(cache.lookup(tiles.at(0)).second >= 0);
+    QVERIFY(cache.lookup(tiles.at(1)).second >= 0);
+    QVERIFY(waitLoaded(cache));
+}
+
+void WebImageCacheTest::full_test()
+{
+    WebImageCache cache(0, 2);
+    cache.lookup(tiles.at(0));
+    cache.lookup(tiles.at(1));
+    // Tiles still loading are not replaced
+    QCOMPARE(cache.lookup(tiles.at(2)).second, -1);
+    QVERIFY(waitLoaded(cache));
+    QVERIFY(cache.lookup(tiles.at(2)).second >= 0);
+    QVERIFY(waitLoaded(cache));
+}
+
+void WebImageCacheTest::frameLookup_test()
+{
+    const int cacheSize = 1000;
+    const int visible = 200;
+    const int frames = 500;
+    WebImageCache cache(0, cacheSize);
+    foreach (const QString& tile, tiles)
+    {
+        cache.lookup(tile);
+    }
+    QVERIFY(waitLoaded(cache, 20000));
+    for (int i = 0; i < cacheSize; i++)
+    {
+        QCOMPARE(cache.at(i)->getState(), WebImage::READY);
+    }
+
+    // Every frame looks up the visible tiles, like Imagery::draw3D()
+    int found = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (int i = 0; i < visible; i++)
+        {
+            if (!cache.lookup(tiles.at((frame + i * 5) % cacheSize)).first.isNull()) found++;
+        }
+    }
+    QCOMPARE(found, frames * visible);
+    // Lookups of cached tiles request nothing
+    QVERIFY(!cache.hasPendingRequests());
+}
@@ -0,0 +1,38 @@
+#ifndef WEBIMAGECACHETEST_H
+#define WEBIMAGECACHETEST_H
+
+#include <QObject>
+#include <QStringList>
+#include <QtTest/QtTest>
+
+#include "WebImageCache.h"
+#include "AutoTest.h"
+
+class WebImageCacheTest : public QObject
+{
+    Q_OBJECT
+public:
+    WebImageCacheTest();
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void load_test();
+    void fileUrl_test();
+    void lru_test();
+    void missing_test();
+    void full_test();
+    void frameLookup_test();
+
+private:
+    /** @brief Process events until the cache has loaded all requested tiles */
+    static bool waitLoaded(WebImageCache& cache, int timeout = 5000);
+
+    QString dir;
+    QStringList tiles;
+};
+
+DECLARE_TEST(WebImageCacheTest)
+
+#endif // WEBIMAGECACHETEST_H
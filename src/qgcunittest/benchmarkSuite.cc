@@ -0,0 +1,11 @@
+/**
+ * @file
+ *   @brief Main of the benchmark target, see qgcbenchmark.pro
+ */
+
+#include "BenchmarkReport.h"
+
+int main(int argc, char *argv[])
+{
+    return BenchmarkReport::run(argc, argv);
+}
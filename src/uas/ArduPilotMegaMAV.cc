@@ -232,6 +232,7 @@ ArduPilotMegaMAV::ArduPilotMegaMAV(MAVLinkProtocol* mavlink, int id) :
 
     connect(this, SIGNAL(armed()), this, SLOT(systemArmed()));
     connect(this, SIGNAL(disarmed()), this, SLOT(systemDisarmed()));
+    GAudioOutput::instance()->prewarm(QStringList() << "Armed!" << "Disarmed!");
 
     // checking for customeMode changes for Audio.
     connect(this, SIGNAL(navModeChanged(int,int,QString)),
@@ -421,7 +422,7 @@ void ArduPilotMegaMAV::textMessageReceived(int uasid, int componentid, int sever
     if (text.startsWith("PreArm:")) {
         // Speak the PreArm warning
         QString audioString = "Pre-arm check:" + text.remove("PreArm:");
-        GAudioOutput::instance()->say(audioString, severity);
+        GAudioOutput::instance()->say(audioString, (severity <= MAV_SEVERITY_CRITICAL) ? GAudioOutput::SEVERITY_ALERT : GAudioOutput::SEVERITY_NORMAL);
     }
 
 
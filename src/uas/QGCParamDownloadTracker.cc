@@ -0,0 +1,151 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Bookkeeping of received parameter indices during a list download
+ */
+
+#include "QGCParamDownloadTracker.h"
+
+QGCParamDownloadTracker::QGCParamDownloadTracker()
+{
+}
+
+void QGCParamDownloadTracker::clear()
+{
+    components.clear();
+}
+
+void QGCParamDownloadTracker::setCount(int component, int count)
+{
+    ComponentState state;
+    state.received = QBitArray(qMax(0, count), false);
+    state.missing = state.received.size();
+    components.insert(component, state);
+}
+
+int QGCParamDownloadTracker::getCount(int component) const
+{
+    return components.value(component).received.size();
+}
+
+bool QGCParamDownloadTracker::markReceived(int component, int index)
+{
+    QMap<int, ComponentState>::iterator i = components.find(component);
+    if (i == components.end()) return false;
+    ComponentState& state = i.value();
+    if (index < 0 || index >= state.received.size()) return false;
+    if (state.received.testBit(index)) return false;
+    state.received.setBit(index);
+    state.missing--;
+    return true;
+}
+
+bool QGCParamDownloadTracker::isReceived(int component, int index) const
+{
+    QMap<int, ComponentState>::const_iterator i = components.constFind(component);
+    if (i == components.constEnd()) return false;
+    if (index < 0 || index >= i.value().received.size()) return false;
+    return i.value().received.testBit(index);
+}
+
+bool QGCParamDownloadTracker::addListParameter(int component, int count, int index)
+{
+    bool first = !isCountKnown(component);
+    if (first)
+    {
+        setCount(component, count);
+    }
+    markReceived(component, index);
+    return first;
+}
+
+int QGCParamDownloadTracker::getMissingCount(int component) const
+{
+    return components.value(component).missing;
+}
+
+int QGCParamDownloadTracker::getMissingCount() const
+{
+    int missing = 0;
+    QMap<int, ComponentState>::const_iterator i;
+    for (i = components.constBegin(); i != components.constEnd(); ++i)
+    {
+        missing += i.value().missing;
+    }
+    return missing;
+}
+
+QList<QGCParamDownloadTracker::Range> QGCParamDownloadTracker::getMissingRanges(int component) const
+{
+    QList<Range> ranges;
+    QMap<int, ComponentState>::const_iterator i = components.constFind(component);
+    if (i == components.constEnd() || i.value().missing == 0) return ranges;
+
+    const QBitArray& received = i.value().received;
+    int first = -1;
+    for (int index = 0; index < received.size(); ++index)
+    {
+        if (!received.testBit(index))
+        {
+            if (first < 0) first = index;
+        }
+        else if (first >= 0)
+        {
+            ranges.append(Range(first, index - 1));
+            first = -1;
+        }
+    }
+    if (first >= 0)
+    {
+        ranges.append(Range(first, received.size() - 1));
+    }
+    return ranges;
+}
+
+QList<int> QGCParamDownloadTracker::getMissingIndices(int component, int maxCount) const
+{
+    QList<int> indices;
+    foreach (const Range& range, getMissingRanges(component))
+    {
+        for (int index = range.first; index <= range.last; ++index)
+        {
+            if (indices.size() >= maxCount) return indices;
+            indices.append(index);
+        }
+    }
+    return indices;
+}
+
+QList<QPair<int, int> > QGCParamDownloadTracker::getRetransmissionRequests(int burstSize) const
+{
+    QList<QPair<int, int> > requests;
+    foreach (int component, components.keys())
+    {
+        foreach (int index, getMissingIndices(component, burstSize))
+        {
+            requests.append(qMakePair(component, index));
+        }
+    }
+    return requests;
+}
@@ -0,0 +1,104 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Bookkeeping of received parameter indices during a list download
+ */
+
+#ifndef QGCPARAMDOWNLOADTRACKER_H
+#define QGCPARAMDOWNLOADTRACKER_H
+
+#include <QBitArray>
+#include <QList>
+#include <QMap>
+#include <QPair>
+
+/**
+ * Keeps one bit per param_index and component. Marking a parameter as
+ * received and asking for the missing count are constant time, the missing
+ * indices are reported as contiguous ranges so the retransmission guard
+ * re-requests exactly what was lost.
+ */
+class QGCParamDownloadTracker
+{
+public:
+    /** @brief Inclusive range of missing parameter indices */
+    struct Range {
+        Range(int first = 0, int last = 0) : first(first), last(last) {}
+        int first;
+        int last;
+        int count() const { return last - first + 1; }
+    };
+
+    QGCParamDownloadTracker();
+
+    /** @brief Forget all components and their state */
+    void clear();
+
+    /** @brief Set the list size announced by the component, all indices start as missing */
+    void setCount(int component, int count);
+    /** @brief True once the list size of this component is known */
+    bool isCountKnown(int component) const { return components.contains(component); }
+    /** @brief Announced list size of this component, 0 if unknown */
+    int getCount(int component) const;
+
+    /**
+     * @brief Mark one index as received
+     * @return true if the index was missing before, false for duplicates,
+     *         unknown components and out of range indices
+     */
+    bool markReceived(int component, int index);
+    /** @brief True if the index has been received */
+    bool isReceived(int component, int index) const;
+    /**
+     * @brief Account a parameter received while the list is downloaded
+     * The first one of a component announces the list size, see setCount()
+     * @return true if it was the first parameter of this component
+     */
+    bool addListParameter(int component, int count, int index);
+
+    /** @brief Number of missing indices of one component */
+    int getMissingCount(int component) const;
+    /** @brief Number of missing indices of all components */
+    int getMissingCount() const;
+    /** @brief Components with a known list size */
+    QList<int> getComponents() const { return components.keys(); }
+
+    /** @brief Missing indices of one component, merged into ranges */
+    QList<Range> getMissingRanges(int component) const;
+    /** @brief The first maxCount missing indices of one component, in ascending order */
+    QList<int> getMissingIndices(int component, int maxCount) const;
+    /** @brief (component, index) of up to burstSize missing parameters per component to request again */
+    QList<QPair<int, int> > getRetransmissionRequests(int burstSize) const;
+
+protected:
+    struct ComponentState {
+        ComponentState() : missing(0) {}
+        QBitArray received;
+        int missing;
+    };
+
+    QMap<int, ComponentState> components;
+};
+
+#endif // QGCPARAMDOWNLOADTRACKER_H
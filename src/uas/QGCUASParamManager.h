@@ -6,6 +6,8 @@
 #include <QTimer>
 #include <QVariant>
 
+#include "QGCParamDownloadTracker.h"
+
 class UASInterface;
 
 class QGCUASParamManager : public QWidget
@@ -71,10 +73,9 @@ protected:
     QMap<int, QMap<QString, QVariant>* > changedValues; ///< Changed values
     QMap<int, QMap<QString, QVariant>* > parameters; ///< All parameters
     QVector<bool> received; ///< Successfully received parameters
-    QMap<int, QList<int>* > transmissionMissingPackets; ///< Missing packets
+    QGCParamDownloadTracker transmissionMissingPackets; ///< Received / missing parameter indices
     QMap<int, QMap<QString, QVariant>* > transmissionMissingWriteAckPackets; ///< Missing write ACK packets
     bool transmissionListMode;       ///< Currently requesting list
-    QMap<int, bool> transmissionListSizeKnown;  ///< List size initialized?
     bool transmissionActive;         ///< Missing packets, working on list?
     quint64 transmissionTimeout;     ///< Timeout
     QTimer retransmissionTimer;      ///< Timer handling parameter retransmission
@@ -14,11 +14,13 @@
 #include "LinkInterface.h"
 #include "UASManager.h"
 #include "QGC.h"
+#include "QGCTimebase.h"
 #include "GAudioOutput.h"
 #include "MAVLinkProtocol.h"
 #include "QGCMAVLink.h"
 #include "LinkManager.h"
 #include "SerialLink.h"
+#include "LinkTxScheduler.h"
 
 #include <QList>
 #include <QMessageBox>
@@ -87,7 +89,6 @@ UAS::UAS(MAVLinkProtocol* protocol, int id) : UASInterface(),
     lowBattAlarm(false),
 
     startTime(QGC::groundTimeMilliseconds()),
-    onboardTimeOffset(0),
 
     controlRollManual(true),
     controlPitchManual(true),
@@ -135,7 +136,6 @@ UAS::UAS(MAVLinkProtocol* protocol, int id) : UASInterface(),
     // The protected members.
     connectionLost(false),
     lastVoltageWarning(0),
-    lastNonNullTime(0),
     onboardTimeOffsetInvalidCount(0),
     hilEnabled(false),
     sensorHil(false),
@@ -154,9 +154,20 @@ UAS::UAS(MAVLinkProtocol* protocol, int id) : UASInterface(),
     connect(this, SIGNAL(systemSpecsChanged(int)), this, SLOT(writeSettings()));
     statusTimeout->start(500);
     readSettings(); 
+    // The decoder threads of the protocol write the snapshot
+    if (mavlink) mavlink->addVehicleState(uasId, &vehicleState);
     // Initial signals
     emit disarmed();
     emit armingChanged(false);  
+
+    // These announcements recur all flight long, synthesize them while idle.
+    // The cache matches the exact text, so compose them like the heartbeat does.
+    QStringList phrases;
+    phrases << getStateAnnouncement(getArmedAudioText(true), "", "");
+    phrases << getStateAnnouncement(getArmedAudioText(false), "", "");
+    phrases << QString("Link lost to system %1").arg(uasId).toLower();
+    phrases << QString("emergency for system %1").arg(uasId);
+    GAudioOutput::instance()->prewarm(phrases);
 }
 
 /**
@@ -165,6 +176,7 @@ UAS::UAS(MAVLinkProtocol* protocol, int id) : UASInterface(),
 */
 UAS::~UAS()
 {
+    if (mavlink) mavlink->removeVehicleState(uasId, &vehicleState);
     writeSettings();
     delete links;
     delete statusTimeout;
@@ -468,15 +480,12 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
                 }
             }
 
-            QString audiostring = QString("System %1").arg(uasId);
             QString stateAudio = "";
             QString modeAudio = "";
             QString customModeAudio = "";
             bool statechanged = false;
             bool modechanged = false;
 
-            QString audiomodeText = getAudioModeTextFor(static_cast<int>(state.base_mode));
-
             if ((state.system_status != this->status) && state.system_status != MAV_STATE_UNINIT)
             {
                 statechanged = true;
@@ -504,18 +513,8 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
 
                 emit modeChanged(this->getUASID(), shortModeText, "");
 
-                QString armedAudio;
                 // ARMED STATE DECODING
-                if (mode & (uint8_t)MAV_MODE_FLAG_DECODE_POSITION_SAFETY)
-                {
-                    armedAudio.append("is armed");
-                }
-                else
-                {
-                    armedAudio.append("is disarmed");
-                }
-
-                modeAudio = armedAudio;
+                modeAudio = getArmedAudioText(mode & (uint8_t)MAV_MODE_FLAG_DECODE_POSITION_SAFETY);
             }
 
             if (custom_mode != state.custom_mode)
@@ -525,58 +524,15 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
                 customModeAudio = getCustomModeAudioText();
             }
 
-            // AUDIO
-            if (modechanged && statechanged)
-            {
-                // Output the one message
-                switch (getAutopilotType()) {
-                    // [ToDo] temp fix, need to refactor audio to UAS specialization classes.
-                    case MAV_AUTOPILOT_ARDUPILOTMEGA: {
-                        if (isFixedWing()) {
-                            // Output both messages
-                            audiostring += /*modeAudio + " and " +*/ " is " + customModeAudio ;
-                        } else {
-                            // Output both messages
-                            audiostring += modeAudio + " and " + stateAudio;
-                        }
-                    } break;
-
-                    case MAV_AUTOPILOT_PIXHAWK:
-                    default: {
-                    // Output both messages
-                        audiostring += modeAudio + " and " + stateAudio;
-                    }
-                }
-            }
-            else if (modechanged || statechanged)
-            {
-                // Output the one message
-                switch (getAutopilotType()) {
-                    // [ToDo] temp fix, need to refactor audio to UAS specialization classes.
-                    case MAV_AUTOPILOT_ARDUPILOTMEGA: {
-                        if (isFixedWing()) {
-                            audiostring += /*modeAudio + stateAudio +*/ customModeAudio;
-                        } else {
-                            audiostring += modeAudio /*+ stateAudio*/ + customModeAudio;
-                        }
-                    } break;
-
-                    case MAV_AUTOPILOT_PIXHAWK:
-                    default: {
-                         audiostring += modeAudio + stateAudio + customModeAudio;
-                    }
-                }
-            }
-
             if (statechanged && ((int)state.system_status == (int)MAV_STATE_CRITICAL || state.system_status == (int)MAV_STATE_EMERGENCY))
             {
-                GAudioOutput::instance()->say(QString("emergency for system %1").arg(this->getUASID()));
+                GAudioOutput::instance()->say(QString("emergency for system %1").arg(this->getUASID()), GAudioOutput::SEVERITY_EMERGENCY);
                 QTimer::singleShot(3000, GAudioOutput::instance(), SLOT(startEmergency()));
             }
             else if (modechanged || statechanged)
             {
                 GAudioOutput::instance()->stopEmergency();
-                GAudioOutput::instance()->say(audiostring.toLower());
+                GAudioOutput::instance()->say(getStateAnnouncement(modeAudio, stateAudio, customModeAudio));
             }
         }
 
@@ -684,7 +640,7 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
         {
             mavlink_attitude_t attitude;
             mavlink_msg_attitude_decode(&message, &attitude);
-            quint64 time = getUnixReferenceTime(attitude.time_boot_ms);
+            quint64 time = getUnixReferenceTime(static_cast<quint64>(attitude.time_boot_ms) * 1000);
 
             emit attitudeChanged(this, message.compid, QGC::limitAngleToPMPIf(attitude.roll), QGC::limitAngleToPMPIf(attitude.pitch), QGC::limitAngleToPMPIf(attitude.yaw), time);
 
@@ -770,7 +726,7 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
         {
             mavlink_local_position_ned_t pos;
             mavlink_msg_local_position_ned_decode(&message, &pos);
-            quint64 time = getUnixTime(pos.time_boot_ms);
+            quint64 time = getUnixTimeFromMs(pos.time_boot_ms);
 
             // Emit position always with component ID
             emit localPositionChanged(this, message.compid, pos.x, pos.y, pos.z, time);
@@ -1251,7 +1207,7 @@ void UAS::receiveMessage(LinkInterface* link, mavlink_message_t message)
             {
                 text.remove("#audio:");
                 emit textMessageReceived(uasId, message.compid, severity, QString("Audio message: ") + text);
-                GAudioOutput::instance()->say(text, severity);
+                GAudioOutput::instance()->say(text, (severity <= MAV_SEVERITY_CRITICAL) ? GAudioOutput::SEVERITY_ALERT : GAudioOutput::SEVERITY_NORMAL);
             }
             else
             {
@@ -1750,46 +1706,7 @@ void UAS::startPressureCalibration()
 quint64 UAS::getUnixReferenceTime(quint64 time)
 {
     // Same as getUnixTime, but does not react to attitudeStamped mode
-    if (time == 0)
-    {
-        //        QLOG_DEBUG() << "XNEW time:" <<QGC::groundTimeMilliseconds();
-        return QGC::groundTimeMilliseconds();
-    }
-    // Check if time is smaller than 40 years,
-    // assuming no system without Unix timestamp
-    // runs longer than 40 years continuously without
-    // reboot. In worst case this will add/subtract the
-    // communication delay between GCS and MAV,
-    // it will never alter the timestamp in a safety
-    // critical way.
-    //
-    // Calculation:
-    // 40 years
-    // 365 days
-    // 24 hours
-    // 60 minutes
-    // 60 seconds
-    // 1000 milliseconds
-    // 1000 microseconds
-#ifndef _MSC_VER
-    else if (time < 1261440000000000LLU)
-#else
-    else if (time < 1261440000000000)
-#endif
-    {
-        //        QLOG_DEBUG() << "GEN time:" << time/1000 + onboardTimeOffset;
-        if (onboardTimeOffset == 0)
-        {
-            onboardTimeOffset = QGC::groundTimeMilliseconds() - time/1000;
-        }
-        return time/1000 + onboardTimeOffset;
-    }
-    else
-    {
-        // Time is not zero and larger than 40 years -> has to be
-        // a Unix epoch timestamp. Do nothing.
-        return time/1000;
-    }
+    return QGCTimebase::instance()->toGroundMilliseconds(uasId, time/1000);
 }
 
 /**
@@ -1817,56 +1734,7 @@ quint64 UAS::getUnixTimeFromMs(quint64 time)
 */
 quint64 UAS::getUnixTime(quint64 time)
 {
-    quint64 ret = 0;
-    if (attitudeStamped)
-    {
-        ret = lastAttitude;
-    }
-
-    if (time == 0)
-    {
-        ret = QGC::groundTimeMilliseconds();
-    }
-    // Check if time is smaller than 40 years,
-    // assuming no system without Unix timestamp
-    // runs longer than 40 years continuously without
-    // reboot. In worst case this will add/subtract the
-    // communication delay between GCS and MAV,
-    // it will never alter the timestamp in a safety
-    // critical way.
-    //
-    // Calculation:
-    // 40 years
-    // 365 days
-    // 24 hours
-    // 60 minutes
-    // 60 seconds
-    // 1000 milliseconds
-    // 1000 microseconds
-#ifndef _MSC_VER
-    else if (time < 1261440000000000LLU)
-#else
-    else if (time < 1261440000000000)
-#endif
-    {
-        //        QLOG_DEBUG() << "GEN time:" << time/1000 + onboardTimeOffset;
-        if (onboardTimeOffset == 0 || time < (lastNonNullTime - 100))
-        {
-            lastNonNullTime = time;
-            onboardTimeOffset = QGC::groundTimeMilliseconds() - time/1000;
-        }
-        if (time > lastNonNullTime) lastNonNullTime = time;
-
-        ret = time/1000 + onboardTimeOffset;
-    }
-    else
-    {
-        // Time is not zero and larger than 40 years -> has to be
-        // a Unix epoch timestamp. Do nothing.
-        ret = time/1000;
-    }
-
-    return ret;
+    return QGCTimebase::instance()->toGroundMilliseconds(uasId, time/1000);
 }
 
 /**
@@ -1934,10 +1802,12 @@ void UAS::setMode(int mode, int custom_mode)
 void UAS::sendMessage(mavlink_message_t message)
 {
     if (!LinkManager::instance()) return;
+    // Fetch the list of known links once, not once per link
+    const QList<LinkInterface*> managedLinks = LinkManager::instance()->getLinks();
     // Emit message on all links that are currently connected
     foreach (LinkInterface* link, *links)
     {
-        if (LinkManager::instance()->getLinks().contains(link))
+        if (managedLinks.contains(link))
         {
             sendMessage(link, message);
         }
@@ -1955,25 +1825,20 @@ void UAS::sendMessage(mavlink_message_t message)
 */
 void UAS::forwardMessage(mavlink_message_t message)
 {
+    // With multiplexing the protocol already routed this broadcast message to all other links
+    if (mavlink->multiplexingEnabled()) return;
+
     // Emit message on all links that are currently connected
     QList<LinkInterface*>link_list = LinkManager::instance()->getLinksForProtocol(mavlink);
 
     foreach(LinkInterface* link, link_list)
     {
-        if (link)
+        // Only serial links not connected to this system, once each
+        SerialLink* serial = qobject_cast<SerialLink*>(link);
+        if (serial && !links->contains(serial))
         {
-            SerialLink* serial = dynamic_cast<SerialLink*>(link);
-            if(serial != 0)
-            {
-                for(int i=0; i<links->size(); i++)
-                {
-                    if(serial != links->at(i))
-                    {
-                        QLOG_TRACE()<<"Antenna tracking: Forwarding Over link: "<<serial->getName()<<" "<<serial;
-                        sendMessage(serial, message);
-                    }
-                }
-            }
+            QLOG_TRACE()<<"Antenna tracking: Forwarding Over link: "<<serial->getName()<<" "<<serial;
+            mavlink->forwardMessage(serial, message);
         }
     }
 }
@@ -1995,8 +1860,9 @@ void UAS::sendMessage(LinkInterface* link, mavlink_message_t message)
     // If link is connected
     if (link->isConnected())
     {
-        // Send the portion of the buffer now occupied by the message
-        link->writeBytes((const char*)buffer, len);
+        // Hand the frame to the link's transmit scheduler, which orders it
+        // by priority and shapes it to the link's data rate
+        LinkTxScheduler::forLink(link)->send(message.msgid, (const char*)buffer, len);
     }
 }
 
@@ -2027,6 +1893,65 @@ QString UAS::getCustomModeAudioText()
     return customModeString + getCustomModeText();
 }
 
+QString UAS::getArmedAudioText(bool armed)
+{
+    return armed ? " is armed" : " is disarmed";
+}
+
+/**
+* The announcement of a heartbeat as it is spoken, it depends on the autopilot.
+* The texts that did not change are empty.
+*/
+QString UAS::getStateAnnouncement(const QString& modeAudio, const QString& stateAudio, const QString& customModeAudio)
+{
+    QString audiostring = QString("System %1").arg(uasId);
+    bool modechanged = !modeAudio.isEmpty();
+    bool statechanged = !stateAudio.isEmpty();
+
+    if (modechanged && statechanged)
+    {
+        // Output the one message
+        switch (getAutopilotType()) {
+            // [ToDo] temp fix, need to refactor audio to UAS specialization classes.
+            case MAV_AUTOPILOT_ARDUPILOTMEGA: {
+                if (isFixedWing()) {
+                    // Output both messages
+                    audiostring += /*modeAudio + " and " +*/ " is " + customModeAudio ;
+                } else {
+                    // Output both messages
+                    audiostring += modeAudio + " and " + stateAudio;
+                }
+            } break;
+
+            case MAV_AUTOPILOT_PIXHAWK:
+            default: {
+            // Output both messages
+                audiostring += modeAudio + " and " + stateAudio;
+            }
+        }
+    }
+    else if (modechanged || statechanged)
+    {
+        // Output the one message
+        switch (getAutopilotType()) {
+            // [ToDo] temp fix, need to refactor audio to UAS specialization classes.
+            case MAV_AUTOPILOT_ARDUPILOTMEGA: {
+                if (isFixedWing()) {
+                    audiostring += /*modeAudio + stateAudio +*/ customModeAudio;
+                } else {
+                    audiostring += modeAudio /*+ stateAudio*/ + customModeAudio;
+                }
+            } break;
+
+            case MAV_AUTOPILOT_PIXHAWK:
+            default: {
+                 audiostring += modeAudio + stateAudio + customModeAudio;
+            }
+        }
+    }
+    return audiostring.toLower();
+}
+
 /** 
 * Get the status of the code and a description of the status.
 * Status can be unitialized, booting up, calibrating sensors, active
@@ -3075,6 +3000,14 @@ void UAS::sendHilGps(quint64 time_us, double lat, double lon, double alt, int fi
 }
 
 
+void UAS::requestHilMode()
+{
+    mavlink_message_t msg;
+    mavlink_msg_set_mode_pack(mavlink->getSystemId(), mavlink->getComponentId(), &msg, this->getUASID(), mode | MAV_MODE_FLAG_HIL_ENABLED, custom_mode);
+    sendMessage(msg);
+    QLOG_DEBUG() << __FILE__ << __LINE__ << "HIL is onboard not enabled, trying to enable.";
+}
+
 /**
 * Connect flight gear link.
 **/
@@ -33,6 +33,7 @@ This file is part of the QGROUNDCONTROL project
 #define _UAS_H_
 
 #include "UASInterface.h"
+#include "VehicleState.h"
 #include <MAVLinkProtocol.h>
 #include <QVector3D>
 #include "QGCMAVLink.h"
@@ -93,6 +94,10 @@ public:
     float filterVoltage(float value) const;
     /** @brief Get the links associated with this robot */
     QList<LinkInterface*>* getLinks();
+    /** @brief Get the protocol this robot is talking */
+    MAVLinkProtocol* getProtocol() const { return mavlink; }
+    /** @brief True if the last heartbeat reported HIL mode */
+    bool isHilModeEnabled() const { return mode & MAV_MODE_FLAG_HIL_ENABLED; }
 
     Q_PROPERTY(double localX READ getLocalX WRITE setLocalX NOTIFY localXChanged)
     Q_PROPERTY(double localY READ getLocalY WRITE setLocalY NOTIFY localYChanged)
@@ -402,7 +407,6 @@ protected: //COMMENTS FOR TEST UNIT
 
     /// TIMEKEEPING
     quint64 startTime;            ///< The time the UAS was switched on
-    quint64 onboardTimeOffset;
 
     /// MANUAL CONTROL
     bool controlRollManual;     ///< status flag, true if roll is controlled manually
@@ -494,6 +498,7 @@ protected: //COMMENTS FOR TEST UNIT
     QMap<int, QMap<QString, QVariant>* > parameters; ///< All parameters
     bool paramsOnceRequested;       ///< If the parameter list has been read at least once
     QGCUASParamManager* paramManager; ///< Parameter manager class
+    VehicleStateBuffer vehicleState;  ///< Snapshot of the decoded state, written by the decoder threads of the protocol
 
     /// SIMULATION
     QGCHilLink* simulation;         ///< Hardware in the loop simulation link
@@ -513,6 +518,10 @@ public:
 
     /** @brief Get the human-speakable custom mode string */
     virtual QString getCustomModeAudioText();
+    /** @brief Spoken arming state, as announced after a heartbeat */
+    static QString getArmedAudioText(bool armed);
+    /** @brief Lowercase announcement of a heartbeat, the empty texts did not change */
+    QString getStateAnnouncement(const QString& modeAudio, const QString& stateAudio, const QString& customModeAudio);
 
     /** @brief Check if vehicle is in autonomous mode */
     bool isAuto();
@@ -526,6 +535,10 @@ public:
     QGCUASParamManager* getParamManager() const {
         return paramManager;
     }
+    /** @brief Get the typed snapshot of the vehicle state */
+    const VehicleStateBuffer* getVehicleState() const {
+        return &vehicleState;
+    }
     /** @brief Get the HIL simulation */
     QGCHilLink* getHILSimulation() const {
         return simulation;
@@ -730,6 +743,9 @@ public slots:
     void sendHilGps(quint64 time_us, double lat, double lon, double alt, int fix_type, float eph, float epv, float vel, float cog, int satellites);
 
 
+    /** @brief Ask the MAV to switch into HIL mode, keeping its other mode flags */
+    void requestHilMode();
+
     /** @brief Places the UAV in Hardware-in-the-Loop simulation status **/
     void startHil();
 
@@ -898,7 +914,6 @@ protected:
     bool connectionLost; ///< Flag indicates a timed out connection
     quint64 connectionLossTime; ///< Time the connection was interrupted
     quint64 lastVoltageWarning; ///< Time at which the last voltage warning occured
-    quint64 lastNonNullTime;    ///< The last timestamp from the MAV that was not null
     unsigned int onboardTimeOffsetInvalidCount;     ///< Count when the offboard time offset estimation seemed wrong
     bool hilEnabled;            ///< Set to true if HIL mode is enabled from GCS (UAS might be in HIL even if this flag is not set, this defines the GCS HIL setting)
     bool sensorHil;             ///< True if sensor HIL is enabled
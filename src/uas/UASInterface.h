@@ -42,6 +42,7 @@ This file is part of the QGROUNDCONTROL project
 #include "ProtocolInterface.h"
 #include "UASWaypointManager.h"
 #include "QGCUASParamManager.h"
+#include "VehicleState.h"
 #include "RadioCalibration/RadioCalibrationData.h"
 
 #ifdef QGC_PROTOBUF_ENABLED
@@ -164,6 +165,8 @@ public:
     // TODO Will be removed
     /** @brief Set reference to the param manager **/
     virtual void setParamManager(QGCUASParamManager* manager) = 0;
+    /** @brief Get the typed snapshot of the vehicle state, for widgets that paint at their own rate **/
+    virtual const VehicleStateBuffer* getVehicleState() const = 0;
 
     /* COMMUNICATION FLAGS */
 
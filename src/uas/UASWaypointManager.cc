@@ -373,6 +373,7 @@ void UASWaypointManager::addWaypointViewOnly(Waypoint *wp)
         waypointsViewOnly.insert(waypointsViewOnly.size(), wp);
         connect(wp, SIGNAL(changed(Waypoint*)), this, SLOT(notifyOfChangeViewOnly(Waypoint*)));
 
+        emit waypointViewOnlyRowsInserted(waypointsViewOnly.size()-1, waypointsViewOnly.size()-1);
         emit waypointViewOnlyListChanged();
         emit waypointViewOnlyListChanged(uasid);
     }
@@ -401,6 +402,7 @@ void UASWaypointManager::addWaypointEditable(Waypoint *wp, bool enforceFirstActi
         waypointsEditable.insert(waypointsEditable.count(), wp);
         connect(wp, SIGNAL(changed(Waypoint*)), this, SLOT(notifyOfChangeEditable(Waypoint*)));
 
+        emit waypointEditableRowsInserted(waypointsEditable.count()-1, waypointsEditable.count()-1);
         emit waypointEditableListChanged();
         emit waypointEditableListChanged(uasid);
     }
@@ -428,6 +430,7 @@ Waypoint* UASWaypointManager::createWaypoint(bool enforceFirstActive)
     waypointsEditable.append(wp);
     connect(wp, SIGNAL(changed(Waypoint*)), this, SLOT(notifyOfChangeEditable(Waypoint*)));
 
+    emit waypointEditableRowsInserted(waypointsEditable.count()-1, waypointsEditable.count()-1);
     emit waypointEditableListChanged();
     emit waypointEditableListChanged(uasid);
     return wp;
@@ -452,6 +455,7 @@ int UASWaypointManager::removeWaypoint(quint16 seq)
         }
 
         waypointsEditable.removeAt(seq);
+        emit waypointEditableRowsRemoved(seq, seq);
         delete t;
         t = NULL;
 
@@ -471,24 +475,15 @@ void UASWaypointManager::moveWaypoint(quint16 cur_seq, quint16 new_seq)
 {
     if (cur_seq != new_seq && cur_seq < waypointsEditable.count() && new_seq < waypointsEditable.count())
     {
-        Waypoint *t = waypointsEditable[cur_seq];
-        if (cur_seq < new_seq) {
-            for (int i = cur_seq; i < new_seq; i++)
-            {
-                waypointsEditable[i] = waypointsEditable[i+1];
-                waypointsEditable[i]->setId(i);
-            }
-        }
-        else
+        waypointsEditable.move(cur_seq, new_seq);
+        emit waypointEditableRowMoved(cur_seq, new_seq);
+
+        // Renumber only after the move was announced, so the id of every
+        // changed waypoint already matches its row
+        for (int i = qMin(cur_seq, new_seq); i <= qMax(cur_seq, new_seq); i++)
         {
-            for (int i = cur_seq; i > new_seq; i--)
-            {
-                waypointsEditable[i] = waypointsEditable[i-1];
-                waypointsEditable[i]->setId(i);
-            }
+            waypointsEditable[i]->setId(i);
         }
-        waypointsEditable[new_seq] = t;
-        waypointsEditable[new_seq]->setId(new_seq);
 
         emit waypointEditableListChanged();
         emit waypointEditableListChanged(uasid);
@@ -543,6 +538,7 @@ void UASWaypointManager::loadWaypoints(const QString &loadFile)
             {
                 t->setId(waypointsEditable.count());
                 waypointsEditable.insert(waypointsEditable.count(), t);
+                connect(t, SIGNAL(changed(Waypoint*)), this, SLOT(notifyOfChangeEditable(Waypoint*)));
             }
             else
             {
@@ -154,6 +154,13 @@ signals:
     void waypointViewOnlyListChanged(void);                 ///< emits signal that the list of editable waypoints has been changed
     void waypointViewOnlyListChanged(int uasid);            ///< emits signal that the list of editable waypoints has been changed
     void waypointViewOnlyChanged(int uasid, Waypoint* wp);  ///< emits signal that a single editable waypoint has been changed
+    /** @name Incremental list changes, emitted before the matching ...ListChanged() signal */
+    /*@{*/
+    void waypointEditableRowsInserted(int first, int last); ///< editable waypoints first..last were inserted
+    void waypointEditableRowsRemoved(int first, int last);  ///< editable waypoints first..last were removed
+    void waypointEditableRowMoved(int from, int to);        ///< one editable waypoint moved from index from to index to
+    void waypointViewOnlyRowsInserted(int first, int last); ///< view-only waypoints first..last were inserted
+    /*@}*/
     void currentWaypointChanged(quint16);           ///< emits the new current waypoint sequence number
     void updateStatusString(const QString &);       ///< emits the current status string
     void waypointDistanceChanged(double distance);   ///< Distance to next waypoint changed (in meters)
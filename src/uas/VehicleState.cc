@@ -0,0 +1,257 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Typed snapshot of the vehicle state, double buffered per UAS
+ */
+
+#include "VehicleState.h"
+#include "QGC.h"
+
+#include <cmath>
+#include <qmath.h>
+
+VehicleState::VehicleState() :
+    version(0),
+    timestamp(0),
+    attitudeKnown(false),
+    roll(0.0),
+    pitch(0.0),
+    yaw(0.0),
+    rollSpeed(0.0),
+    pitchSpeed(0.0),
+    yawSpeed(0.0),
+    globalPositionKnown(false),
+    latitude(0.0),
+    longitude(0.0),
+    altitude(0.0),
+    relativeAltitude(0.0),
+    localPositionKnown(false),
+    localX(0.0),
+    localY(0.0),
+    localZ(0.0),
+    velocityKnown(false),
+    velocityX(0.0),
+    velocityY(0.0),
+    velocityZ(0.0),
+    primaryAltitudeKnown(false),
+    primaryAltitude(0.0),
+    airSpeedKnown(false),
+    airSpeed(0.0),
+    groundSpeed(0.0),
+    climbRate(0.0),
+    throttle(0.0),
+    batteryVoltage(0.0),
+    batteryCurrent(0.0),
+    batteryRemaining(-1.0),
+    gpsFixType(0),
+    satelliteCount(0),
+    navigationAltitudeError(0.0),
+    navigationSpeedError(0.0),
+    navigationCrosstrackError(0.0)
+{
+}
+
+VehicleStateBuffer::VehicleStateBuffer() :
+    modified(false),
+    attitudeComponent(-1),
+    localPositionComponent(-1),
+    globalPositionReceived(false)
+{
+}
+
+/** @brief Take a value from the first component that sent it, later components are ignored */
+static bool fromSource(int& source, int compid)
+{
+    if (source == -1)
+    {
+        source = compid;
+    }
+    return source == compid;
+}
+
+VehicleState& VehicleStateBuffer::edit()
+{
+    modified = true;
+    return back;
+}
+
+quint64 VehicleStateBuffer::publish(quint64 timestamp)
+{
+    back.timestamp = timestamp;
+    back.version++;
+    modified = false;
+
+    QMutexLocker locker(&mutex);
+    front = back;
+    return front.version;
+}
+
+quint64 VehicleStateBuffer::getVersion() const
+{
+    QMutexLocker locker(&mutex);
+    return front.version;
+}
+
+VehicleState VehicleStateBuffer::read() const
+{
+    QMutexLocker locker(&mutex);
+    return front;
+}
+
+bool VehicleStateBuffer::readIfNewer(quint64& version, VehicleState& state) const
+{
+    QMutexLocker locker(&mutex);
+    if (front.version == version) return false;
+    state = front;
+    version = front.version;
+    return true;
+}
+
+bool VehicleStateBuffer::update(const mavlink_message_t& message, quint64 timestamp)
+{
+    switch (message.msgid)
+    {
+    case MAVLINK_MSG_ID_SYS_STATUS:
+    {
+        mavlink_sys_status_t status;
+        mavlink_msg_sys_status_decode(&message, &status);
+        VehicleState& state = edit();
+        state.batteryVoltage = status.voltage_battery/1000.0;
+        if (status.current_battery != -1)
+        {
+            state.batteryCurrent = status.current_battery/100.0;
+        }
+        state.batteryRemaining = status.battery_remaining;
+    }
+        break;
+    case MAVLINK_MSG_ID_ATTITUDE:
+    {
+        if (!fromSource(attitudeComponent, message.compid))
+            break;
+        mavlink_attitude_t attitude;
+        mavlink_msg_attitude_decode(&message, &attitude);
+        VehicleState& state = edit();
+        state.attitudeKnown = true;
+        state.roll = QGC::limitAngleToPMPIf(attitude.roll);
+        state.pitch = QGC::limitAngleToPMPIf(attitude.pitch);
+        state.yaw = QGC::limitAngleToPMPIf(attitude.yaw);
+        state.rollSpeed = attitude.rollspeed;
+        state.pitchSpeed = attitude.pitchspeed;
+        state.yawSpeed = attitude.yawspeed;
+    }
+        break;
+    case MAVLINK_MSG_ID_VFR_HUD:
+    {
+        mavlink_vfr_hud_t hud;
+        mavlink_msg_vfr_hud_decode(&message, &hud);
+        VehicleState& state = edit();
+        if (!state.attitudeKnown)
+        {
+            state.yaw = QGC::limitAngleToPMPId((((double)hud.heading-180.0)/360.0)*M_PI);
+        }
+        state.throttle = hud.throttle/100.0;
+        state.primaryAltitudeKnown = true;
+        state.primaryAltitude = hud.alt;
+        state.airSpeedKnown = true;
+        state.airSpeed = hud.airspeed;
+        state.groundSpeed = hud.groundspeed;
+        state.climbRate = hud.climb;
+    }
+        break;
+    case MAVLINK_MSG_ID_LOCAL_POSITION_NED:
+    {
+        if (!fromSource(localPositionComponent, message.compid))
+            break;
+        mavlink_local_position_ned_t pos;
+        mavlink_msg_local_position_ned_decode(&message, &pos);
+        VehicleState& state = edit();
+        state.localPositionKnown = true;
+        state.localX = pos.x;
+        state.localY = pos.y;
+        state.localZ = pos.z;
+        state.velocityKnown = true;
+        state.velocityX = pos.vx;
+        state.velocityY = pos.vy;
+        state.velocityZ = pos.vz;
+    }
+        break;
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+    {
+        mavlink_global_position_int_t pos;
+        mavlink_msg_global_position_int_decode(&message, &pos);
+        globalPositionReceived = true;
+        VehicleState& state = edit();
+        state.globalPositionKnown = true;
+        state.latitude = pos.lat/(double)1E7;
+        state.longitude = pos.lon/(double)1E7;
+        state.altitude = pos.alt/1000.0;
+        state.relativeAltitude = pos.relative_alt/1000.0;
+        state.velocityKnown = true;
+        state.velocityX = pos.vx/100.0;
+        state.velocityY = pos.vy/100.0;
+        state.velocityZ = pos.vz/100.0;
+        state.groundSpeed = qSqrt(state.velocityX*state.velocityX+state.velocityY*state.velocityY);
+    }
+        break;
+    case MAVLINK_MSG_ID_GPS_RAW_INT:
+    {
+        mavlink_gps_raw_int_t pos;
+        mavlink_msg_gps_raw_int_decode(&message, &pos);
+        VehicleState& state = edit();
+        state.gpsFixType = pos.fix_type;
+        state.satelliteCount = pos.satellites_visible;
+        // Raw GPS values only stand in until the autopilot sends its estimate
+        if (pos.fix_type > 2 && !globalPositionReceived)
+        {
+            state.globalPositionKnown = true;
+            state.latitude = pos.lat/(double)1E7;
+            state.longitude = pos.lon/(double)1E7;
+            state.altitude = pos.alt/1000.0;
+            float vel = pos.vel/100.0f;
+            if ((vel < 1000000) && !isnan(vel) && !isinf(vel))
+            {
+                state.groundSpeed = vel;
+            }
+        }
+    }
+        break;
+    case MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT:
+    {
+        mavlink_nav_controller_output_t p;
+        mavlink_msg_nav_controller_output_decode(&message, &p);
+        VehicleState& state = edit();
+        state.navigationAltitudeError = p.alt_error;
+        state.navigationSpeedError = p.aspd_error;
+        state.navigationCrosstrackError = p.xtrack_error;
+    }
+        break;
+    default:
+        break;
+    }
+
+    if (!modified)
+        return false;
+    publish(timestamp);
+    return true;
+}
@@ -0,0 +1,147 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Typed snapshot of the vehicle state, double buffered per UAS
+ */
+
+#ifndef VEHICLESTATE_H
+#define VEHICLESTATE_H
+
+#include <QMutex>
+#include <QtGlobal>
+#include "QGCMAVLink.h"
+
+/**
+ * The values the instruments paint, in SI units and radians. Fields stay at
+ * their initial value until the first message carrying them arrives, the
+ * *Known flags tell these apart from real zeros.
+ */
+struct VehicleState
+{
+    VehicleState();
+
+    quint64 version;            ///< Version of the buffer this snapshot was published as
+    quint64 timestamp;          ///< Ground time of the last update in milliseconds
+
+    bool attitudeKnown;
+    double roll;
+    double pitch;
+    double yaw;
+    double rollSpeed;
+    double pitchSpeed;
+    double yawSpeed;
+
+    bool globalPositionKnown;
+    double latitude;
+    double longitude;
+    double altitude;            ///< AMSL altitude of the global position (GPS altitude on APM)
+    double relativeAltitude;    ///< Altitude above home
+
+    bool localPositionKnown;
+    double localX;
+    double localY;
+    double localZ;
+
+    bool velocityKnown;
+    double velocityX;           ///< North, m/s
+    double velocityY;           ///< East, m/s
+    double velocityZ;           ///< Down, m/s
+
+    bool primaryAltitudeKnown;
+    double primaryAltitude;     ///< Altitude the autopilot navigates with (VFR_HUD)
+    bool airSpeedKnown;
+    double airSpeed;
+    double groundSpeed;
+    double climbRate;
+    double throttle;            ///< 0..1
+
+    double batteryVoltage;
+    double batteryCurrent;
+    double batteryRemaining;    ///< Percent as reported by the autopilot, -1 if unknown
+
+    int gpsFixType;
+    int satelliteCount;
+
+    double navigationAltitudeError;
+    double navigationSpeedError;
+    double navigationCrosstrackError;
+};
+
+/**
+ * Two copies of the VehicleState. The decoding side fills the back buffer
+ * field by field and publishes it once per message, which copies it to the
+ * front buffer and increments the version. Readers take a copy of the front
+ * buffer, so they never see a half written message, and compare versions to
+ * skip work when nothing changed since their last read.
+ *
+ * There must be only one writer, edit(), publish() and update() are not
+ * locked. For a UAS that writer is MAVLinkProtocol::updateVehicleState(),
+ * called from the decoder thread of the link the message arrived on.
+ */
+class VehicleStateBuffer
+{
+public:
+    VehicleStateBuffer();
+
+    /** @brief Back buffer to write to, marks the buffer as modified */
+    VehicleState& edit();
+    /** @brief True if the back buffer was edited since the last publish() */
+    bool isModified() const { return modified; }
+    /**
+     * @brief Make the back buffer visible to the readers
+     * @return the new version
+     */
+    quint64 publish(quint64 timestamp);
+    /**
+     * @brief Write the fields one message carries and publish them
+     *
+     * Attitude and local position are taken from the first component that
+     * sent them, raw GPS positions only until a GLOBAL_POSITION_INT arrived,
+     * as the UAS does for its own values.
+     * @return true if the message changed the state and a new version was published
+     */
+    bool update(const mavlink_message_t& message, quint64 timestamp);
+
+    /** @brief Version of the published state, 0 before the first publish() */
+    quint64 getVersion() const;
+    /** @brief Copy of the published state */
+    VehicleState read() const;
+    /**
+     * @brief Copy the published state if it is newer than version
+     * @param version last version read by the caller, updated on success
+     * @return false if nothing was published since
+     */
+    bool readIfNewer(quint64& version, VehicleState& state) const;
+
+protected:
+    VehicleState back;
+    VehicleState front;
+    bool modified;
+    mutable QMutex mutex;       ///< Guards front
+    int attitudeComponent;      ///< Component the attitude is taken from, -1 before the first ATTITUDE
+    int localPositionComponent; ///< Component the local position is taken from, -1 before the first one
+    bool globalPositionReceived; ///< A GLOBAL_POSITION_INT arrived, raw GPS positions are ignored
+};
+
+#endif // VEHICLESTATE_H
@@ -47,20 +47,14 @@ DebugConsole::DebugConsole(QWidget *parent) :
     filterMAVLINK(false),
     autoHold(true),
     bytesToIgnore(0),
-    lastByte(-1),
-    escReceived(false),
-    escIndex(0),
     sentBytes(),
     holdBuffer(),
-    lineBuffer(""),
-    lastLineBuffer(0),
-    lineBufferTimer(),
     snapShotTimer(),
     snapShotInterval(500),
     snapShotBytes(0),
     dataRate(0.0f),
     lowpassDataRate(0.0f),
-    dataRateThreshold(400),
+    dataRateThreshold(200000),
     commandIndex(0),
     m_ui(new Ui::DebugConsole)
 {
@@ -70,19 +64,6 @@ DebugConsole::DebugConsole(QWidget *parent) :
     m_ui->sentText->setVisible(false);
     // Hide auto-send checkbox
     //m_ui->specialCheckBox->setVisible(false);
-    // Make text area not editable
-    m_ui->receiveText->setReadOnly(false);
-    // Limit to 500 lines
-    m_ui->receiveText->setMaximumBlockCount(500);
-    // Allow to wrap everywhere
-    m_ui->receiveText->setWordWrapMode(QTextOption::WrapAnywhere);
-//    // Set monospace font
-//    m_ui->receiveText->setFontFamily("Monospace");
-
-    // Enable 10 Hz output
-    //connect(&lineBufferTimer, SIGNAL(timeout()), this, SLOT(showData()));
-    //lineBufferTimer.setInterval(100); // 100 Hz
-    //lineBufferTimer.start();
     loadSettings();
 
     // Enable traffic measurements
@@ -216,9 +197,8 @@ void DebugConsole::removeLink(LinkInterface* const linkInterface)
 }
 void DebugConsole::linkStatusUpdate(const QString& name,const QString& text)
 {
-    m_ui->receiveText->appendPlainText(text);
-    // Ensure text area scrolls correctly
-    m_ui->receiveText->ensureCursorVisible();
+    Q_UNUSED(name);
+    m_ui->receiveText->appendMessage(text);
 }
 
 void DebugConsole::linkSelected(int linkId)
@@ -267,16 +247,6 @@ void DebugConsole::setAutoHold(bool hold)
         m_ui->holdCheckBox->setChecked(hold);
     }
 
-    if (!hold)
-    {
-        // Warn user about not activated hold
-        m_ui->receiveText->appendHtml(QString("<font color=\"%1\">%2</font>\n").arg(QColor(Qt::red).name(), tr("WARNING: You have NOT enabled auto-hold (stops updating the console if huge amounts of serial data arrive). Updating the console consumes significant CPU load, so if you receive more than about 5 KB/s of serial data, make sure to enable auto-hold if not using the console.")));
-    }
-    else
-    {
-        m_ui->receiveText->clear();
-    }
-
     // Set new state
     autoHold = hold;
 }
@@ -311,9 +281,7 @@ void DebugConsole::receiveTextMessage(int id, int component, int severity, QStri
             break;
         }
 
-        m_ui->receiveText->appendHtml(QString("<font color=\"%1\">(%2:%3) %4</font>\n").arg(UASManager::instance()->getUASForId(id)->getColor().name(), name, comp, text));
-        // Ensure text area scrolls correctly
-        m_ui->receiveText->ensureCursorVisible();
+        m_ui->receiveText->appendMessage(QString("(%1:%2) %3").arg(name, comp, text), UASManager::instance()->getUASForId(id)->getColor());
     }
 }
 
@@ -376,166 +344,84 @@ void DebugConsole::paintEvent(QPaintEvent *event)
 void DebugConsole::receiveBytes(LinkInterface* link, QByteArray bytes)
 {
     snapShotBytes += bytes.size();
+    // Only add data from current link
+    if (link != currLink) return;
+
+    if (holdOn)
+    {
+        holdBuffer.append(bytes);
+        if (holdBuffer.size() > 8192)
+            holdBuffer.remove(0, 4096); // drop old stuff
+        return;
+    }
+
+    appendReceivedBytes(bytes);
+}
+
+void DebugConsole::appendReceivedBytes(QByteArray bytes)
+{
+    // Filter MAVLink (http://qgroundcontrol.org/mavlink/) messages out of the stream.
+    if (filterMAVLINK)
+    {
+        bytes = filterMAVLINKBytes(bytes);
+    }
+
+    if (convertToAscii)
+    {
+        // VT100 cursor home, clear all text before it
+        int home = bytes.lastIndexOf("\x1b[H");
+        if (home >= 0)
+        {
+            m_ui->receiveText->clear();
+            bytes.remove(0, home + 3);
+        }
+    }
+
+    // The view only stores the bytes, they are converted when shown
+    m_ui->receiveText->appendData(bytes);
+}
+
+QByteArray DebugConsole::filterMAVLINKBytes(const QByteArray& bytes)
+{
+    QByteArray output;
+    output.reserve(bytes.size());
     int len = bytes.size();
-    int lastSpace = 0;
     if ((this->bytesToIgnore > 260) || (this->bytesToIgnore < -2)) this->bytesToIgnore = 0;
-    // Only add data from current link
-    if (link == currLink && !holdOn)
+    for (int j = 0; j < len; j++)
     {
-        // Parse all bytes
-        for (int j = 0; j < len; j++)
+        unsigned char byte = bytes.at(j);
+        if (this->bytesToIgnore > 0)
         {
-            unsigned char byte = bytes.at(j);
-            // Filter MAVLink (http://qgroundcontrol.org/mavlink/) messages out of the stream.
-            if (filterMAVLINK)
-            {
-                if (this->bytesToIgnore > 0)
-                {
-                    if ( (j + this->bytesToIgnore) < len )
-                        j += this->bytesToIgnore - 1, this->bytesToIgnore = 1;
-                    else
-                        this->bytesToIgnore -= (len - j - 1), j = len - 1;
-                } else
-                if (this->bytesToIgnore == -2)
-                {   // Payload plus header - but we got STX already
-                    this->bytesToIgnore = static_cast<unsigned int>(byte) + MAVLINK_NUM_NON_PAYLOAD_BYTES - 1;
-                    if ( (j + this->bytesToIgnore) < len )
-                        j += this->bytesToIgnore - 1, this->bytesToIgnore = 1;
-                    else
-                        this->bytesToIgnore -= (len - j - 1), j = len - 1;
-                } else
-                // Filtering is done by setting an ignore counter based on the MAVLINK packet length
-                if (static_cast<unsigned char>(byte) == MAVLINK_STX)
-                {
-                    this->bytesToIgnore = -1;
-                } else
-                    this->bytesToIgnore = 0;
-            } else this->bytesToIgnore = 0;
-
-            if ( (this->bytesToIgnore <= 0) && (this->bytesToIgnore != -1) )
-            {
-                QString str;
-                // Convert to ASCII for readability
-                if (convertToAscii)
-                {
-                    if (escReceived)
-                    {
-                        if (escIndex < static_cast<int>(sizeof(escBytes)))
-                        {
-                            escBytes[escIndex] = byte;
-                            //QLOG_DEBUG() << "GOT BYTE ESC:" << byte;
-                            if (/*escIndex == 1 && */escBytes[escIndex] == 0x48)
-                            {
-                                // Handle sequence
-                                // for this one, clear all text
-                                m_ui->receiveText->clear();
-                                escReceived = false;
-                            }
-                            else if (/*escIndex == 1 && */escBytes[escIndex] == 0x4b)
-                            {
-                                // Handle sequence
-                                // for this one, do nothing
-                                escReceived = false;
-                            }
-                            else if (byte == 0x5b)
-                            {
-                                // Do nothing, this is still a valid escape sequence
-                            }
-                            else
-                            {
-                                escReceived = false;
-                            }
-                         }
-                        else
-                        {
-                            // Obviously something went wrong, reset
-                            escReceived = false;
-                            escIndex = 0;
-                        }
-                    }
-                    else if ((byte <= 32) || (byte > 126))
-                    {
-                        switch (byte)
-                        {
-                            case (unsigned char)'\n':   // Accept line feed
-                                if (lastByte != '\r')   // Do not break line again for LF+CR
-                                    str.append(byte);   // only break line for single LF or CR bytes
-                            break;
-                            case (unsigned char)' ':    // space of any type means don't add another on hex output
-                            case (unsigned char)'\t':   // Accept tab
-                            case (unsigned char)'\r':   // Catch and carriage return
-                                if (lastByte != '\n')   // Do not break line again for CR+LF
-                                str.append(byte);       // only break line for single LF or CR bytes
-                                lastSpace = 1;
-                            break;
-                            /* VT100 emulation (partially */
-                            case 0x1b:                  // ESC received
-                                escReceived = true;
-                                escIndex = 0;
-                                //QLOG_DEBUG() << "GOT ESC";
-                                break;
-                            case 0x08:                  // BS (backspace) received
-                                // Do nothing for now
-                                break;
-                            default:                    // Append replacement character (box) if char is not ASCII
-//                                str.append(QChar(QChar::ReplacementCharacter));
-                                QString str2;
-                                if ( lastSpace == 1)
-                                    str2.sprintf("0x%02x ", byte);
-                                else str2.sprintf(" 0x%02x ", byte);
-                                str.append(str2);
-                                lastSpace = 1;
-                                escReceived = false;
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        // Ignore carriage return, because that
-                        // is auto-added with '\n'
-                        if (byte != '\r') str.append(byte);           // Append original character
-                        lastSpace = 0;
-                    }
-                }
-                else
-                {
-                    QString str2;
-                    str2.sprintf("%02x ", byte);
-                    str.append(str2);
-                }
-                lineBuffer.append(str);
-                lastByte = byte;
-            }
+            if ( (j + this->bytesToIgnore) < len )
+                j += this->bytesToIgnore - 1, this->bytesToIgnore = 1;
             else
-            {
-                if (filterMAVLINK) this->bytesToIgnore--;
-                // Constrain bytes to positive range
-//                bytesToIgnore = qMax(0, bytesToIgnore);
-            }
+                this->bytesToIgnore -= (len - j - 1), j = len - 1;
+        } else
+        if (this->bytesToIgnore == -2)
+        {   // Payload plus header - but we got STX already
+            this->bytesToIgnore = static_cast<unsigned int>(byte) + MAVLINK_NUM_NON_PAYLOAD_BYTES - 1;
+            if ( (j + this->bytesToIgnore) < len )
+                j += this->bytesToIgnore - 1, this->bytesToIgnore = 1;
+            else
+                this->bytesToIgnore -= (len - j - 1), j = len - 1;
+        } else
+        // Filtering is done by setting an ignore counter based on the MAVLINK packet length
+        if (static_cast<unsigned char>(byte) == MAVLINK_STX)
+        {
+            this->bytesToIgnore = -1;
+        } else
+            this->bytesToIgnore = 0;
 
+        if ( (this->bytesToIgnore <= 0) && (this->bytesToIgnore != -1) )
+        {
+            output.append(byte);
         }
-        // Plot every 200 ms if windows is visible
-        if (lineBuffer.length() > 0 && (QGC::groundTimeMilliseconds() - lastLineBuffer) > 200) {
-            if (isVisible())
-            {
-                m_ui->receiveText->appendPlainText(lineBuffer);
-                lineBuffer.clear();
-                lastLineBuffer = QGC::groundTimeMilliseconds();
-                // Ensure text area scrolls correctly
-                m_ui->receiveText->ensureCursorVisible();
-            }
-            if (lineBuffer.size() > 8192)
-            {
-                lineBuffer.remove(0, 4096);
-            }
+        else
+        {
+            this->bytesToIgnore--;
         }
     }
-    else if (link == currLink && holdOn)
-    {
-        holdBuffer.append(bytes);
-        if (holdBuffer.size() > 8192)
-            holdBuffer.remove(0, 4096); // drop old stuff
-    }
+    return output;
 }
 
 QByteArray DebugConsole::symbolNameToBytes(const QString& text)
@@ -747,7 +633,8 @@ void DebugConsole::hexModeEnabled(bool mode)
         if (m_ui->hexCheckBox->isChecked() != mode) {
             m_ui->hexCheckBox->setChecked(mode);
         }
-        m_ui->receiveText->clear();
+        // The received bytes are kept, only the way they are shown changes
+        m_ui->receiveText->setHexMode(mode);
         m_ui->sendText->clear();
         m_ui->sentText->clear();
         commandHistory.clear();
@@ -775,20 +662,13 @@ void DebugConsole::hold(bool hold)
     if (holdOn != hold) {
         // Check if we need to append bytes from the hold buffer
         if (this->holdOn && !hold) {
-            // TODO No conversion is done to the bytes in the hold buffer
-            m_ui->receiveText->appendPlainText(QString(holdBuffer));
+            appendReceivedBytes(holdBuffer);
             holdBuffer.clear();
             lowpassDataRate = 0.0f;
         }
 
         this->holdOn = hold;
 
-        // Change text interaction mode
-        if (hold) {
-            m_ui->receiveText->setTextInteractionFlags(Qt::TextSelectableByKeyboard | Qt::TextSelectableByMouse | Qt::LinksAccessibleByKeyboard | Qt::LinksAccessibleByMouse);
-        } else {
-            m_ui->receiveText->setTextInteractionFlags(Qt::NoTextInteraction);
-        }
         if (m_ui->holdCheckBox->isChecked() != hold) {
             m_ui->holdCheckBox->setChecked(hold);
         }
@@ -802,10 +682,10 @@ void DebugConsole::setConnectionState(bool connected)
 {
     if(connected) {
         m_ui->connectButton->setText(tr("Disconn."));
-        m_ui->receiveText->appendHtml(QString("<font color=\"%1\">%2</font>\n").arg(QGC::colorGreen.name(), tr("Link %1 is connected.").arg(currLink->getName())));
+        m_ui->receiveText->appendMessage(tr("Link %1 is connected.").arg(currLink->getName()), QGC::colorGreen);
     } else {
         m_ui->connectButton->setText(tr("Connect"));
-        m_ui->receiveText->appendHtml(QString("<font color=\"%1\">%2</font>\n").arg(QGC::colorOrange.name(), tr("Link %1 is unconnected.").arg(currLink->getName())));
+        m_ui->receiveText->appendMessage(tr("Link %1 is unconnected.").arg(currLink->getName()), QGC::colorOrange);
     }
 }
 
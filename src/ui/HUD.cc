@@ -58,6 +58,7 @@ This file is part of the QGROUNDCONTROL project
 HUD::HUD(int width, int height, QWidget* parent)
     : QLabel(parent),
       uas(NULL),
+      stateVersion(0),
       yawInt(0.0f),
       mode(tr("UNKNOWN MODE")),
       state(tr("UNKNOWN STATE")),
@@ -143,7 +144,7 @@ HUD::HUD(int width, int height, QWidget* parent)
 
     // Refresh timer
     refreshTimer->setInterval(updateInterval);
-    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(repaint()));
+    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(refreshState()));
 
     // Resize to correct size and fill with image
     QWidget::resize(this->width(), this->height());
@@ -245,16 +246,12 @@ void HUD::setActiveUAS(UASInterface* uas)
 {
     if (this->uas != NULL) {
         // Disconnect any previously connected active MAV
-        disconnect(this->uas, SIGNAL(attitudeChanged(UASInterface*, double, double, double, quint64)), this, SLOT(updateAttitude(UASInterface*, double, double, double, quint64)));
         disconnect(this->uas, SIGNAL(attitudeChanged(UASInterface*,int, double, double, double, quint64)), this, SLOT(updateAttitude(UASInterface*,int,double, double, double, quint64)));
         disconnect(this->uas, SIGNAL(batteryChanged(UASInterface*, double, double, double, int)), this, SLOT(updateBattery(UASInterface*, double, double, double, int)));
         disconnect(this->uas, SIGNAL(statusChanged(UASInterface*,QString,QString)), this, SLOT(updateState(UASInterface*,QString)));
         disconnect(this->uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateMode(int,QString,QString)));
         disconnect(this->uas, SIGNAL(heartbeat(UASInterface*)), this, SLOT(receiveHeartbeat(UASInterface*)));
 
-        disconnect(this->uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateLocalPosition(UASInterface*,double,double,double,quint64)));
-        disconnect(this->uas, SIGNAL(globalPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateGlobalPosition(UASInterface*,double,double,double,quint64)));
-        disconnect(this->uas, SIGNAL(velocityChanged_NEDspeedChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateSpeed(UASInterface*,double,double,double,quint64)));
         disconnect(this->uas, SIGNAL(waypointSelected(int,int)), this, SLOT(selectWaypoint(int, int)));
 
         // Try to disconnect the image link
@@ -267,17 +264,15 @@ void HUD::setActiveUAS(UASInterface* uas)
 
     if (uas) {
         // Now connect the new UAS
-        // Setup communication
-        connect(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateAttitude(UASInterface*, double, double, double, quint64)));
+        // Setup communication. The attitude, position and speed of the
+        // system arrive much faster than the HUD repaints, refreshState()
+        // reads them from the state snapshot once per frame instead.
         connect(uas, SIGNAL(attitudeChanged(UASInterface*,int,double,double,double,quint64)), this, SLOT(updateAttitude(UASInterface*,int,double, double, double, quint64)));
         connect(uas, SIGNAL(batteryChanged(UASInterface*, double, double, double, int)), this, SLOT(updateBattery(UASInterface*, double, double, double, int)));
         connect(uas, SIGNAL(statusChanged(UASInterface*,QString,QString)), this, SLOT(updateState(UASInterface*,QString)));
         connect(uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateMode(int,QString,QString)));
         connect(uas, SIGNAL(heartbeat(UASInterface*)), this, SLOT(receiveHeartbeat(UASInterface*)));
 
-        connect(uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateLocalPosition(UASInterface*,double,double,double,quint64)));
-        connect(uas, SIGNAL(globalPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateGlobalPosition(UASInterface*,double,double,double,quint64)));
-        connect(uas, SIGNAL(velocityChanged_NED(UASInterface*,double,double,double,quint64)), this, SLOT(updateSpeed(UASInterface*,double,double,double,quint64)));
         connect(uas, SIGNAL(waypointSelected(int,int)), this, SLOT(selectWaypoint(int, int)));
 
         // Try to connect the image link
@@ -289,9 +284,37 @@ void HUD::setActiveUAS(UASInterface* uas)
 
         // Set new UAS
         this->uas = uas;
+        stateVersion = 0;
     }
 }
 
+void HUD::refreshState()
+{
+    VehicleState state;
+    if (uas && uas->getVehicleState()->readIfNewer(stateVersion, state))
+    {
+        if (state.attitudeKnown || state.airSpeedKnown)
+        {
+            // VFR_HUD provides the heading until the first ATTITUDE arrives
+            updateAttitude(uas, state.roll, state.pitch, state.yaw, state.timestamp);
+        }
+        if (state.localPositionKnown)
+        {
+            updateLocalPosition(uas, state.localX, state.localY, state.localZ, state.timestamp);
+        }
+        if (state.globalPositionKnown)
+        {
+            updateGlobalPosition(uas, state.latitude, state.longitude, state.altitude, state.timestamp);
+        }
+        if (state.velocityKnown)
+        {
+            updateSpeed(uas, state.velocityX, state.velocityY, state.velocityZ, state.timestamp);
+        }
+    }
+    // The video and the blinking warnings are repainted in every frame
+    repaint();
+}
+
 //void HUD::updateAttitudeThrustSetPoint(UASInterface* uas, double rollDesired, double pitchDesired, double yawDesired, double thrustDesired, quint64 msec)
 //{
 ////    updateValue(uas, "roll desired", rollDesired, msec);
@@ -64,6 +64,8 @@ public slots:
 
     /** @brief Set the currently monitored UAS */
     virtual void setActiveUAS(UASInterface* uas);
+    /** @brief Copy the attitude, position and speed from the state snapshot of the UAS and repaint */
+    void refreshState();
 
     /** @brief Attitude from main autopilot / system state */
     void updateAttitude(UASInterface* uas, double roll, double pitch, double yaw, quint64 timestamp);
@@ -145,6 +147,7 @@ protected:
     QImage* image; ///< Double buffer image
     QImage glImage; ///< The background / camera image
     UASInterface* uas; ///< The uas currently monitored
+    quint64 stateVersion; ///< Version of the last vehicle state snapshot shown
     float yawInt; ///< The yaw integral. Used to damp the yaw indication.
     QString mode; ///< The current vehicle mode
     QString state; ///< The current vehicle state
@@ -0,0 +1,230 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Live view of the traffic and parser metrics of all links
+ */
+
+#include "LinkMetricsWidget.h"
+#include "LinkManager.h"
+#include "LinkTxScheduler.h"
+
+#include <QComboBox>
+#include <QDesktopServices>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace
+{
+enum LinkColumn
+{
+    COLUMN_LINK,
+    COLUMN_RX,
+    COLUMN_TX,
+    COLUMN_FRAMES,
+    COLUMN_CRC,
+    COLUMN_FRAMING,
+    COLUMN_RESYNCS,
+    COLUMN_LOST,
+    COLUMN_READ_INTERVAL,
+    COLUMN_FRAME_INTERVAL,
+    COLUMN_LATENCY,
+    LINK_COLUMNS
+};
+
+QString duration(quint32 us)
+{
+    if (us < 1000) return QString("%1 us").arg(us);
+    if (us < 1000000) return QString("%1 ms").arg(us / 1000);
+    return QString("%1 s").arg(us / 1000000.0, 0, 'f', 1);
+}
+
+/** @brief p50 / p95 / p99 of a histogram, as upper bin bounds */
+QString percentiles(const LinkMetrics::Window& window, LinkMetrics::Histogram histogram)
+{
+    if (window.count(histogram) == 0) return "-";
+    return QString("%1 / %2 / %3")
+            .arg(duration(window.percentile(histogram, 0.5)))
+            .arg(duration(window.percentile(histogram, 0.95)))
+            .arg(duration(window.percentile(histogram, 0.99)));
+}
+}
+
+LinkMetricsWidget::LinkMetricsWidget(QWidget *parent) :
+    QWidget(parent)
+{
+    windowComboBox = new QComboBox(this);
+    windowComboBox->addItem(tr("1 s"), 1);
+    windowComboBox->addItem(tr("10 s"), 10);
+    windowComboBox->addItem(tr("60 s"), 60);
+    windowComboBox->addItem(tr("120 s"), 120);
+    windowComboBox->setCurrentIndex(1);
+    recordButton = new QPushButton(tr("Record to CSV"), this);
+    recordButton->setCheckable(true);
+
+    QHBoxLayout* controls = new QHBoxLayout();
+    controls->addWidget(new QLabel(tr("Window"), this));
+    controls->addWidget(windowComboBox);
+    controls->addStretch();
+    controls->addWidget(recordButton);
+
+    QStringList header;
+    header << tr("Link") << tr("RX B/s") << tr("TX B/s") << tr("Frames/s")
+           << tr("CRC errors") << tr("Framing errors") << tr("Resyncs") << tr("Lost")
+           << tr("Read interval p50/p95/p99") << tr("Frame interval p50/p95/p99")
+           << tr("Handover latency p50/p95/p99");
+    linkTable = new QTableWidget(0, LINK_COLUMNS, this);
+    linkTable->setHorizontalHeaderLabels(header);
+    linkTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    linkTable->verticalHeader()->hide();
+
+    header.clear();
+    header << tr("Link") << tr("System") << tr("Frames/s") << tr("Lost") << tr("Loss %");
+    systemTable = new QTableWidget(0, header.size(), this);
+    systemTable->setHorizontalHeaderLabels(header);
+    systemTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    systemTable->verticalHeader()->hide();
+
+    header.clear();
+    header << tr("Link") << tr("TX class") << tr("Queued / max") << tr("Sent") << tr("Coalesced")
+           << tr("Dropped") << tr("Parked") << tr("Waited") << tr("Latency mean / max");
+    txTable = new QTableWidget(0, header.size(), this);
+    txTable->setHorizontalHeaderLabels(header);
+    txTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    txTable->verticalHeader()->hide();
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addLayout(controls);
+    layout->addWidget(linkTable, 2);
+    layout->addWidget(systemTable, 1);
+    layout->addWidget(txTable, 1);
+    setLayout(layout);
+
+    recordButton->setChecked(!LinkManager::instance()->getMetricsExportFile().isEmpty());
+    connect(recordButton, SIGNAL(toggled(bool)), this, SLOT(record(bool)));
+    connect(windowComboBox, SIGNAL(currentIndexChanged(int)), this, SLOT(refresh()));
+    connect(LinkManager::instance(), SIGNAL(metricsSampled()), this, SLOT(refresh()));
+    refresh();
+}
+
+void LinkMetricsWidget::setCell(QTableWidget* table, int row, int column, const QString& text)
+{
+    QTableWidgetItem* item = table->item(row, column);
+    if (!item)
+    {
+        item = new QTableWidgetItem();
+        table->setItem(row, column, item);
+    }
+    item->setText(text);
+}
+
+void LinkMetricsWidget::refresh()
+{
+    // Nothing to see while the dock is closed
+    if (!isVisible()) return;
+
+    int seconds = windowComboBox->itemData(windowComboBox->currentIndex()).toInt();
+    QList<LinkInterface*> links = LinkManager::instance()->getLinks();
+    linkTable->setRowCount(links.size());
+    int systemRow = 0;
+    int txRow = 0;
+    for (int row = 0; row < links.size(); ++row)
+    {
+        LinkInterface* link = links.at(row);
+        LinkMetrics::Window window = link->getMetrics().window(seconds);
+        setCell(linkTable, row, COLUMN_LINK, link->getName());
+        setCell(linkTable, row, COLUMN_RX, QString::number(window.rate(LinkMetrics::BYTES_RECEIVED), 'f', 0));
+        setCell(linkTable, row, COLUMN_TX, QString::number(window.rate(LinkMetrics::BYTES_SENT), 'f', 0));
+        setCell(linkTable, row, COLUMN_FRAMES, QString::number(window.rate(LinkMetrics::FRAMES), 'f', 1));
+        setCell(linkTable, row, COLUMN_CRC, QString::number(window.counts[LinkMetrics::CRC_ERRORS]));
+        setCell(linkTable, row, COLUMN_FRAMING, QString::number(window.counts[LinkMetrics::FRAMING_ERRORS]));
+        setCell(linkTable, row, COLUMN_RESYNCS, QString::number(window.counts[LinkMetrics::RESYNCS]));
+        setCell(linkTable, row, COLUMN_LOST, QString::number(window.counts[LinkMetrics::MESSAGES_LOST]));
+        setCell(linkTable, row, COLUMN_READ_INTERVAL, percentiles(window, LinkMetrics::READ_INTERVAL));
+        setCell(linkTable, row, COLUMN_FRAME_INTERVAL, percentiles(window, LinkMetrics::FRAME_INTERVAL));
+        setCell(linkTable, row, COLUMN_LATENCY, percentiles(window, LinkMetrics::HANDOVER_LATENCY));
+
+        QMap<int, LinkMetrics::SystemCounts>::const_iterator i;
+        for (i = window.systems.constBegin(); i != window.systems.constEnd(); ++i)
+        {
+            if (systemTable->rowCount() <= systemRow) systemTable->setRowCount(systemRow + 1);
+            setCell(systemTable, systemRow, 0, link->getName());
+            setCell(systemTable, systemRow, 1, QString::number(i.key()));
+            setCell(systemTable, systemRow, 2, QString::number(window.seconds > 0.0 ? i.value().frames / window.seconds : 0.0, 'f', 1));
+            setCell(systemTable, systemRow, 3, QString::number(i.value().lost));
+            setCell(systemTable, systemRow, 4, QString::number(i.value().loss(), 'f', 2));
+            ++systemRow;
+        }
+
+        // Counters since the link was created, only links that sent anything have a scheduler
+        LinkTxScheduler* scheduler = LinkTxScheduler::findForLink(link);
+        if (!scheduler) continue;
+        txTable->setRowCount(txRow + LinkTxScheduler::PRIORITY_COUNT);
+        for (int i = 0; i < LinkTxScheduler::PRIORITY_COUNT; ++i)
+        {
+            LinkTxScheduler::Priority priority = static_cast<LinkTxScheduler::Priority>(i);
+            LinkTxScheduler::ClassStatistics stats = scheduler->getStatistics(priority);
+            setCell(txTable, txRow, 0, link->getName());
+            setCell(txTable, txRow, 1, LinkTxScheduler::priorityName(priority));
+            setCell(txTable, txRow, 2, QString("%1 / %2").arg(stats.depth).arg(stats.maxDepth));
+            setCell(txTable, txRow, 3, QString::number(stats.sent));
+            setCell(txTable, txRow, 4, QString::number(stats.coalesced));
+            setCell(txTable, txRow, 5, QString::number(stats.dropped));
+            setCell(txTable, txRow, 6, QString::number(stats.parked));
+            setCell(txTable, txRow, 7, QString("%1 ms").arg(stats.blockedMs));
+            setCell(txTable, txRow, 8, QString("%1 / %2 ms").arg(stats.meanLatencyMs(), 0, 'f', 1).arg(stats.maxLatencyMs));
+            ++txRow;
+        }
+    }
+    systemTable->setRowCount(systemRow);
+    txTable->setRowCount(txRow);
+}
+
+void LinkMetricsWidget::record(bool enabled)
+{
+    if (!enabled)
+    {
+        LinkManager::instance()->setMetricsExportFile(QString());
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this, tr("Specify link metrics file name"),
+                                                    QDesktopServices::storageLocation(QDesktopServices::DesktopLocation),
+                                                    tr("CSV file (*.csv)"));
+    if (fileName.isEmpty() || !LinkManager::instance()->setMetricsExportFile(fileName))
+    {
+        if (!fileName.isEmpty())
+        {
+            QMessageBox::warning(this, tr("Link Metrics"), tr("Could not open %1 for writing.").arg(fileName));
+        }
+        recordButton->blockSignals(true);
+        recordButton->setChecked(false);
+        recordButton->blockSignals(false);
+    }
+}
@@ -0,0 +1,67 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Live view of the traffic and parser metrics of all links
+ */
+
+#ifndef LINKMETRICSWIDGET_H
+#define LINKMETRICSWIDGET_H
+
+#include <QWidget>
+
+class QComboBox;
+class QPushButton;
+class QTableWidget;
+
+/**
+ * @brief Shows rates, parser errors, losses and timing percentiles per link.
+ *
+ * A third table shows the transmit queues of every link by priority class.
+ * The tables are refreshed whenever the link manager sampled the metrics,
+ * over the window selected in the drop down. The record button writes the
+ * same numbers to a CSV file through the link manager.
+ */
+class LinkMetricsWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LinkMetricsWidget(QWidget *parent = 0);
+
+public slots:
+    void refresh();
+    /** @brief Ask for a file and start the CSV export, or stop it */
+    void record(bool enabled);
+
+protected:
+    void setCell(QTableWidget* table, int row, int column, const QString& text);
+
+    QComboBox* windowComboBox;
+    QPushButton* recordButton;
+    QTableWidget* linkTable;
+    QTableWidget* systemTable;
+    QTableWidget* txTable;
+};
+
+#endif // LINKMETRICSWIDGET_H
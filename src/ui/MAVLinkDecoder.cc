@@ -1,6 +1,80 @@
 #include "QsLog.h"
 #include "MAVLinkDecoder.h"
 #include "UASManager.h"
+#include "QGCTimebase.h"
+
+#include <mavlink_msg_visitor.hpp>
+
+namespace
+{
+// Kind of timestamp found in the first field of a message
+enum {
+    TIME_FIELD_NONE = 0,
+    TIME_FIELD_BOOT_MS,
+    TIME_FIELD_USEC
+};
+
+// Indexed by mavlink_message_type_t
+const char* fieldTypeNames[] = {
+    "char", "uint8_t", "int8_t", "uint16_t", "int16_t", "uint32_t",
+    "int32_t", "uint64_t", "int64_t", "float", "double"
+};
+
+// Type a field value is emitted with, picks the valueChanged() overload
+template <typename T> struct SignalType { typedef T type; };
+template <> struct SignalType<char> { typedef qint8 type; };
+template <> struct SignalType<int64_t> { typedef qint64 type; };
+template <> struct SignalType<uint64_t> { typedef quint64 type; };
+template <> struct SignalType<float> { typedef double type; };
+}
+
+/**
+ * Receives the fields of one message from the generated visitor in
+ * mavlink_msg_visitor.hpp. The values arrive typed and the names come
+ * from the cache, so no string is formatted per value.
+ */
+class MAVLinkDecoder::FieldEmitter
+{
+public:
+    FieldEmitter(MAVLinkDecoder* decoder, const mavlink_message_t* msg, const QVector<QStringList>& names,
+                 const QVector<QString>& units, quint64 time, bool skipTimeField) :
+        decoder(decoder),
+        msg(msg),
+        names(names),
+        units(units),
+        time(time),
+        skipTimeField(skipTimeField)
+    {
+    }
+
+    template <typename T> void value(uint8_t field, T value)
+    {
+        // The timestamp is not emitted as value, it is the time of all other values
+        if (field == 0 && skipTimeField) return;
+        emit decoder->valueChanged(msg->sysid, names.at(field).first(), units.at(field), (typename SignalType<T>::type)value, time);
+    }
+
+    template <typename T> void element(uint8_t field, uint8_t index, T value)
+    {
+        emit decoder->valueChanged(msg->sysid, names.at(field).at(index), units.at(field), (typename SignalType<T>::type)value, time);
+    }
+
+    void text(uint8_t field, const char* text, uint8_t length)
+    {
+        if (decoder->textMessageFilter.contains(msg->msgid)) return;
+        // The string is only null terminated if it is shorter than the field
+        QString string(names.at(field).first() + ": " + QString::fromLatin1(text, qstrnlen(text, length)));
+        emit decoder->textMessageReceived(msg->sysid, msg->compid, 0, string);
+    }
+
+private:
+    MAVLinkDecoder* decoder;
+    const mavlink_message_t* msg;
+    const QVector<QStringList>& names;
+    const QVector<QString>& units;
+    quint64 time;
+    bool skipTimeField;
+};
 
 MAVLinkDecoder::MAVLinkDecoder(MAVLinkProtocol* protocol, QObject *parent) :
     QObject(parent)
@@ -8,13 +82,11 @@ MAVLinkDecoder::MAVLinkDecoder(MAVLinkProtocol* protocol, QObject *parent) :
     mavlink_message_info_t msg[256] = MAVLINK_MESSAGE_INFO;
     memcpy(messageInfo, msg, sizeof(mavlink_message_info_t)*256);
     memset(receivedMessages, 0, sizeof(mavlink_message_t)*256);
+    memset(timeField, -1, sizeof(timeField));
     for (unsigned int i = 0; i<255;++i)
     {
         componentID[i] = -1;
         componentMulti[i] = false;
-        onboardTimeOffset[i] = 0;
-        onboardToGCSUnixTimeOffsetAndDelay[i] = 0;
-        firstOnboardTime[i] = 0;
     }
 
     // Fill filter
@@ -55,135 +127,105 @@ void MAVLinkDecoder::receiveMessage(LinkInterface* link,mavlink_message_t messag
 
     uint8_t msgid = message.msgid;
 
-    // Handle time sync message
-    if (message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME)
+    // Time sync message, the protocol aligns the clocks with it as the frames arrive
+    if (msgid == MAVLINK_MSG_ID_SYSTEM_TIME)
     {
-        mavlink_system_time_t timebase;
-        mavlink_msg_system_time_decode(&message, &timebase);
-        onboardTimeOffset[message.sysid] = (timebase.time_unix_usec+500)/1000 - timebase.time_boot_ms;
-        onboardToGCSUnixTimeOffsetAndDelay[message.sysid] = static_cast<qint64>(QGC::groundTimeMilliseconds() - (timebase.time_unix_usec+500)/1000);
+        // Not plotted
+    }
+    else if (msgid == MAVLINK_MSG_ID_DEBUG_VECT || msgid == MAVLINK_MSG_ID_DEBUG ||
+             msgid == MAVLINK_MSG_ID_NAMED_VALUE_FLOAT || msgid == MAVLINK_MSG_ID_NAMED_VALUE_INT)
+    {
+        // The value names of these messages are part of the payload
+        decodeFieldsGeneric(&message);
     }
     else
     {
-
-        QString messageName("%1 (#%2)");
-        messageName = messageName.arg(messageInfo[msgid].name).arg(msgid);
-
-        // See if first value is a time value
-        quint64 time = 0;
-        uint8_t fieldid = 0;
-        uint8_t* m = ((uint8_t*)(receivedMessages+msgid))+8;
-        if (QString(messageInfo[msgid].fields[fieldid].name) == QString("time_boot_ms") && messageInfo[msgid].fields[fieldid].type == MAVLINK_TYPE_UINT32_T)
-        {
-            time = *((quint32*)(m+messageInfo[msgid].fields[fieldid].wire_offset));
-        }
-        else if (QString(messageInfo[msgid].fields[fieldid].name).contains("usec") && messageInfo[msgid].fields[fieldid].type == MAVLINK_TYPE_UINT64_T)
-        {
-            time = *((quint64*)(m+messageInfo[msgid].fields[fieldid].wire_offset));
-            time = (time+500)/1000; // Scale to milliseconds, round up/down correctly
-        }
-        else
-        {
-            // First value is not time, send out value 0
-            emitFieldValue(&message, fieldid, getUnixTimeFromMs(message.sysid, 0));
-        }
-
-        // Align time to global time
-        time = getUnixTimeFromMs(message.sysid, time);
-
-        // Send out field values from 1..n
-        for (unsigned int i = 1; i < messageInfo[msgid].num_fields; ++i)
-        {
-            emitFieldValue(&message, i, time);
-        }
+        decodeFields(message);
     }
 
     // Send out combined math expressions
     // FIXME XXX TODO
 }
 
-quint64 MAVLinkDecoder::getUnixTimeFromMs(int systemID, quint64 time)
+void MAVLinkDecoder::decodeFieldsGeneric(mavlink_message_t* message)
 {
-    quint64 ret = 0;
-    if (time == 0)
+    uint8_t msgid = message->msgid;
+
+    // See if first value is a time value
+    quint64 time = 0;
+    uint8_t fieldid = 0;
+    uint8_t* m = ((uint8_t*)(receivedMessages+msgid))+8;
+    if (QString(messageInfo[msgid].fields[fieldid].name) == QString("time_boot_ms") && messageInfo[msgid].fields[fieldid].type == MAVLINK_TYPE_UINT32_T)
+    {
+        time = *((quint32*)(m+messageInfo[msgid].fields[fieldid].wire_offset));
+    }
+    else if (QString(messageInfo[msgid].fields[fieldid].name).contains("usec") && messageInfo[msgid].fields[fieldid].type == MAVLINK_TYPE_UINT64_T)
+    {
+        time = *((quint64*)(m+messageInfo[msgid].fields[fieldid].wire_offset));
+        time = (time+500)/1000; // Scale to milliseconds, round up/down correctly
+    }
+    else
     {
-        ret = QGC::groundTimeMilliseconds() - onboardToGCSUnixTimeOffsetAndDelay[systemID];
+        // First value is not time, send out value 0
+        emitFieldValue(message, fieldid, getUnixTimeFromMs(message->sysid, 0));
     }
-    // Check if time is smaller than 40 years,
-    // assuming no system without Unix timestamp
-    // runs longer than 40 years continuously without
-    // reboot. In worst case this will add/subtract the
-    // communication delay between GCS and MAV,
-    // it will never alter the timestamp in a safety
-    // critical way.
-    //
-    // Calculation:
-    // 40 years
-    // 365 days
-    // 24 hours
-    // 60 minutes
-    // 60 seconds
-    // 1000 milliseconds
-    // 1000 microseconds
-#ifndef _MSC_VER
-    else if (time < 1261440000000LLU)
-#else
-    else if (time < 1261440000000)
-#endif
+
+    // Align time to global time
+    time = getUnixTimeFromMs(message->sysid, time);
+
+    // Send out field values from 1..n
+    for (unsigned int i = 1; i < messageInfo[msgid].num_fields; ++i)
+    {
+        emitFieldValue(message, i, time);
+    }
+}
+
+void MAVLinkDecoder::decodeFields(const mavlink_message_t& message)
+{
+    uint8_t msgid = message.msgid;
+    bool multiComponent = isMultiComponent(&message);
+    if (messageFilter.contains(msgid)) return;
+
+    const mavlink_message_info_t& info = messageInfo[msgid];
+
+    // See once per message type if the first value is a time value
+    if (timeField[msgid] < 0)
     {
-        if (onboardTimeOffset[systemID] == 0 || time < (firstOnboardTime[systemID]-100))
+        timeField[msgid] = TIME_FIELD_NONE;
+        if (info.num_fields > 0)
         {
-            firstOnboardTime[systemID] = time;
-            onboardTimeOffset[systemID] = QGC::groundTimeMilliseconds() - time;
+            QString name(info.fields[0].name);
+            if (name == "time_boot_ms" && info.fields[0].type == MAVLINK_TYPE_UINT32_T)
+            {
+                timeField[msgid] = TIME_FIELD_BOOT_MS;
+            }
+            else if (name.contains("usec") && info.fields[0].type == MAVLINK_TYPE_UINT64_T)
+            {
+                timeField[msgid] = TIME_FIELD_USEC;
+            }
         }
+    }
 
-        if (time > firstOnboardTime[systemID]) firstOnboardTime[systemID] = time;
-
-        ret = time + onboardTimeOffset[systemID];
+    quint64 time = 0;
+    if (timeField[msgid] == TIME_FIELD_BOOT_MS)
+    {
+        time = _MAV_RETURN_uint32_t(&message, info.fields[0].wire_offset);
     }
-    else
+    else if (timeField[msgid] == TIME_FIELD_USEC)
     {
-        // Time is not zero and larger than 40 years -> has to be
-        // a Unix epoch timestamp. Do nothing.
-        ret = time;
+        time = (_MAV_RETURN_uint64_t(&message, info.fields[0].wire_offset)+500)/1000; // Scale to milliseconds, round up/down correctly
     }
 
+    // Align time to global time
+    time = getUnixTimeFromMs(message.sysid, time);
 
-//    // Check if the offset estimation likely went wrong
-//    // and we're talking to a new instance / the system
-//    // has rebooted. Only reset if this is consistent.
-//    if (!isNull && lastNonNullTime > ret)
-//    {
-//        onboardTimeOffsetInvalidCount++;
-//    }
-//    else if (!isNull && lastNonNullTime < ret)
-//    {
-//        onboardTimeOffsetInvalidCount = 0;
-//    }
-
-//    // Reset onboard time offset estimation, since it seems to be really off
-//    if (onboardTimeOffsetInvalidCount > 20)
-//    {
-//        onboardTimeOffset = 0;
-//        onboardTimeOffsetInvalidCount = 0;
-//        lastNonNullTime = 0;
-//        QLOG_DEBUG() << "RESETTET ONBOARD TIME OFFSET";
-//    }
-
-//    // If we're progressing in time, set it
-//    // else wait for the reboot detection to
-//    // catch the timestamp wrap / reset
-//    if (!isNull && (lastNonNullTime < ret)) {
-//        lastNonNullTime = ret;
-//    }
-
-    return ret;
+    FieldEmitter emitter(this, &message, getFieldNames(&message, multiComponent), getFieldUnits(msgid),
+                         time, timeField[msgid] != TIME_FIELD_NONE);
+    mavlink::visit(&message, emitter);
 }
 
-void MAVLinkDecoder::emitFieldValue(mavlink_message_t* msg, int fieldid, quint64 time)
+bool MAVLinkDecoder::isMultiComponent(const mavlink_message_t* msg)
 {
-    bool multiComponentSourceDetected = false;
-
     // Store component ID
     if (componentID[msg->msgid] == -1)
     {
@@ -198,7 +240,80 @@ void MAVLinkDecoder::emitFieldValue(mavlink_message_t* msg, int fieldid, quint64
         }
     }
 
-    if (componentMulti[msg->msgid] == true) multiComponentSourceDetected = true;
+    return componentMulti[msg->msgid];
+}
+
+const QVector<QStringList>& MAVLinkDecoder::getFieldNames(const mavlink_message_t* msg, bool multiComponent)
+{
+    quint32 key = (msg->sysid << 24) | msg->msgid;
+    if (multiComponent)
+    {
+        key |= 0x10000 | (msg->compid << 8);
+    }
+
+    QHash<quint32, QVector<QStringList> >::iterator i = fieldNames.find(key);
+    if (i != fieldNames.end())
+    {
+        return i.value();
+    }
+
+    const mavlink_message_info_t& info = messageInfo[msg->msgid];
+    QString prefix = QString("M%1:").arg(msg->sysid);
+    if (multiComponent)
+    {
+        prefix += QString("C%1:").arg(msg->compid);
+    }
+
+    QVector<QStringList> names(info.num_fields);
+    for (unsigned int f = 0; f < info.num_fields; ++f)
+    {
+        QString name = prefix + QString("%1.%2").arg(info.name).arg(info.fields[f].name);
+        if (info.fields[f].array_length > 0 && info.fields[f].type != MAVLINK_TYPE_CHAR)
+        {
+            for (unsigned int j = 0; j < info.fields[f].array_length; ++j)
+            {
+                names[f].append(QString("%1.%2").arg(name).arg(j));
+            }
+        }
+        else
+        {
+            names[f].append(name);
+        }
+    }
+    return fieldNames.insert(key, names).value();
+}
+
+const QVector<QString>& MAVLinkDecoder::getFieldUnits(uint8_t msgid)
+{
+    QVector<QString>& units = fieldUnits[msgid];
+    const mavlink_message_info_t& info = messageInfo[msgid];
+    if (units.size() != (int)info.num_fields)
+    {
+        units.resize(info.num_fields);
+        for (unsigned int f = 0; f < info.num_fields; ++f)
+        {
+            QString type(fieldTypeNames[info.fields[f].type]);
+            if (info.fields[f].array_length > 0 || info.fields[f].type == MAVLINK_TYPE_CHAR)
+            {
+                units[f] = QString("%1[%2]").arg(type).arg(info.fields[f].array_length);
+            }
+            else
+            {
+                units[f] = type;
+            }
+        }
+    }
+    return units;
+}
+
+quint64 MAVLinkDecoder::getUnixTimeFromMs(int systemID, quint64 time)
+{
+    return QGCTimebase::instance()->toGroundMilliseconds(systemID, time);
+}
+
+void MAVLinkDecoder::emitFieldValue(mavlink_message_t* msg, int fieldid, quint64 time)
+{
+    bool multiComponentSourceDetected = isMultiComponent(msg);
 
     // Add field tree widget item
     uint8_t msgid = msg->msgid;
@@ -2,6 +2,9 @@
 #define MAVLINKDECODER_H
 
 #include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
 #include "MAVLinkProtocol.h"
 
 class MAVLinkDecoder : public QObject
@@ -28,9 +31,22 @@ public slots:
     /** @brief Receive one message from the protocol and decode it */
     void receiveMessage(LinkInterface* link,mavlink_message_t message);
 protected:
+    class FieldEmitter;
+    friend class FieldEmitter;
+
+    /** @brief Emit all fields through the generated typed visitor */
+    void decodeFields(const mavlink_message_t& message);
+    /** @brief Emit all fields by walking MAVLINK_MESSAGE_INFO */
+    void decodeFieldsGeneric(mavlink_message_t* message);
+    /** @brief Track the sending component, true if several components send this message */
+    bool isMultiComponent(const mavlink_message_t* msg);
+    /** @brief Value names of all fields of this message and sender, built on first use */
+    const QVector<QStringList>& getFieldNames(const mavlink_message_t* msg, bool multiComponent);
+    /** @brief Unit (type) strings of all fields of this message, built on first use */
+    const QVector<QString>& getFieldUnits(uint8_t msgid);
     /** @brief Emit the value of one message field */
     void emitFieldValue(mavlink_message_t* msg, int fieldid, quint64 time);
-    /** @brief Shift a timestamp in Unix time if necessary */
+    /** @brief Align an onboard timestamp to the ground time, zero is now */
     quint64 getUnixTimeFromMs(int systemID, quint64 time);
 
     mavlink_message_t receivedMessages[256]; ///< Available / known messages
@@ -39,9 +55,9 @@ protected:
     QMap<uint16_t, bool> textMessageFilter;           ///< Message/field names not to emit in text mode
     int componentID[256];                             ///< Multi component detection
     bool componentMulti[256];                         ///< Multi components detected
-    quint64 onboardTimeOffset[256];                   ///< Offset of onboard time from Unix epoch (of the receiving GCS)
-    qint64 onboardToGCSUnixTimeOffsetAndDelay[256];   ///< Offset of onboard time and GCS Unix time
-    quint64 firstOnboardTime[256];                    ///< First seen onboard time
+    qint8 timeField[256];                             ///< Kind of timestamp in the first field, -1 if not checked yet
+    QHash<quint32, QVector<QStringList> > fieldNames; ///< Value names per system, component and message
+    QVector<QString> fieldUnits[256];                 ///< Unit strings per message
 
 };
 
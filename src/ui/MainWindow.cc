@@ -55,6 +55,7 @@ This file is part of the QGROUNDCONTROL project
 #include "ApmToolBar.h"
 #include "SerialSettingsDialog.h"
 #include "TerminalConsole.h"
+#include "QGCStartupTimer.h"
 
 #ifdef QGC_OSG_ENABLED
 #include "Q3DWidgetFactory.h"
@@ -206,8 +207,11 @@ MainWindow::MainWindow(QWidget *parent):
 
     emit initStatusChanged("Building common widgets.");
 
-    buildCommonWidgets();
-    connectCommonWidgets();
+    {
+        QGCStartupTimer::Scope timing("Common widgets");
+        buildCommonWidgets();
+        connectCommonWidgets();
+    }
 
     emit initStatusChanged("Building common actions.");
 
@@ -283,7 +287,7 @@ MainWindow::MainWindow(QWidget *parent):
 
     emit initStatusChanged("Restoring last view state.");
 
-    // Restore the window setup
+    // Restore the window setup, this builds the current view
     loadViewState();
 
     emit initStatusChanged("Restoring last window size.");
@@ -456,33 +460,24 @@ void MainWindow::buildCustomWidget()
             //settings.setValue(QString("TOOL_PARENT_") + "UNNAMED_TOOL_" + QString::number(ui.menuTools->actions().size()),currentView);
             settings.endGroup();
 
-            QDockWidget* dock;
-
             switch (view)
             {
             case VIEW_ENGINEER:
-                dock = createDockWidget(engineeringView,tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
-                break;
             case VIEW_FLIGHT:
-                dock = createDockWidget(pilotView,tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
-                break;
             case VIEW_SIMULATION:
-                dock = createDockWidget(simView,tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
-                break;
             case VIEW_MISSION:
-                dock = createDockWidget(plannerView,tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
-                break;
             case VIEW_MAVLINK:
-                dock = createDockWidget(mavlinkView,tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
+                // XXX temporary "fix", the dock starts hidden
+                createViewDockWidget((VIEW_SECTIONS)view,tool,tool->getTitle(),tool->objectName(),location,false);
                 break;
             default:
-                dock = createDockWidget(centerStack->currentWidget(),tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
+            {
+                QDockWidget* dock = createDockWidget(centerStack->currentWidget(),tool,tool->getTitle(),tool->objectName(),(VIEW_SECTIONS)view,location);
+                dock->hide();
+            }
                 break;
             }
 
-            // XXX temporary "fix"
-            dock->hide();
-
             //createDockWidget(0,tool,tool->getTitle(),tool->objectName(),view,location);
         }
     }
@@ -507,72 +502,7 @@ void MainWindow::buildCommonWidgets()
     logPlayer = new QGCMAVLinkLogPlayer(mavlink, customStatusBar);
     customStatusBar->setLogPlayer(logPlayer);
 
-    // Center widgets
-    if (!plannerView)
-    {
-        plannerView = new SubMainWindow(this);
-        plannerView->setObjectName("VIEW_MISSION");
-        plannerView->setCentralWidget(new QGCMapTool(this));
-        addToCentralStackedWidget(plannerView, VIEW_MISSION, "Maps");
-    }
-
-    //pilotView (aka Flight or Mission View)
-    if (!pilotView)
-    {
-        pilotView = new SubMainWindow(this);
-        pilotView->setObjectName("VIEW_FLIGHT");
-        pilotView->setCentralWidget(new QGCMapTool(this));
-        addToCentralStackedWidget(pilotView, VIEW_FLIGHT, "Pilot");
-    }
-
-    if (!configView)
-    {
-        configView = new SubMainWindow(this);
-        configView->setObjectName("VIEW_HARDWARE_CONFIG");
-        configView->setCentralWidget(new ApmHardwareConfig(this));
-        addToCentralStackedWidget(configView,VIEW_HARDWARE_CONFIG, tr("Hardware"));
-    }
-
-    if (!softwareConfigView)
-    {
-        softwareConfigView = new SubMainWindow(this);
-        softwareConfigView->setObjectName("VIEW_SOFTWARE_CONFIG");
-        softwareConfigView->setCentralWidget(new ApmSoftwareConfig(this));
-        addToCentralStackedWidget(softwareConfigView, VIEW_SOFTWARE_CONFIG, tr("Software"));
-    }
-
-    if (!engineeringView)
-    {
-        engineeringView = new SubMainWindow(this);
-        engineeringView->setObjectName("VIEW_ENGINEER");
-        engineeringView->setCentralWidget(new QGCDataPlot2D(this));
-        addToCentralStackedWidget(engineeringView, VIEW_ENGINEER, tr("Logfile Plot"));
-    }
-
-    if (!mavlinkView)
-    {
-        mavlinkView = new SubMainWindow(this);
-        mavlinkView->setObjectName("VIEW_MAVLINK");
-        mavlinkView->setCentralWidget(new XMLCommProtocolWidget(this));
-        addToCentralStackedWidget(mavlinkView, VIEW_MAVLINK, tr("Mavlink Generator"));
-    }
-
-    if (!simView)
-    {
-        simView = new SubMainWindow(this);
-        simView->setObjectName("VIEW_SIMULATOR");
-        simView->setCentralWidget(new QGCMapTool(this));
-        addToCentralStackedWidget(simView, VIEW_SIMULATION, tr("Simulation View"));
-    }
-
-    if (!terminalView)
-    {
-        terminalView = new SubMainWindow(this);
-        terminalView->setObjectName("VIEW_TERMINAL");
-        TerminalConsole *terminalConsole = new TerminalConsole(this);
-        terminalView->setCentralWidget(terminalConsole);
-        addToCentralStackedWidget(terminalView, VIEW_TERMINAL, tr("Terminal View"));
-    }
+    // Center widgets and their dock widgets are built on first activation, see getView()
 
     if (!debugOutput)
     {
@@ -585,17 +515,6 @@ void MainWindow::buildCommonWidgets()
     tempAction->setCheckable(true);
     connect(tempAction,SIGNAL(triggered(bool)),this, SLOT(showTool(bool)));
 
-    createDockWidget(simView,new UASControlWidget(this),tr("Control"),"UNMANNED_SYSTEM_CONTROL_DOCKWIDGET",VIEW_SIMULATION,Qt::LeftDockWidgetArea);
-
-    createDockWidget(plannerView,new UASListWidget(this),tr("Unmanned Systems"),"UNMANNED_SYSTEM_LIST_DOCKWIDGET",VIEW_MISSION,Qt::LeftDockWidgetArea);
-    createDockWidget(plannerView,new QGCWaypointListMulti(this),tr("Mission Plan"),"WAYPOINT_LIST_DOCKWIDGET",VIEW_MISSION,Qt::BottomDockWidgetArea);
-
-    createDockWidget(simView,new QGCWaypointListMulti(this),tr("Mission Plan"),"WAYPOINT_LIST_DOCKWIDGET",VIEW_SIMULATION,Qt::BottomDockWidgetArea);
-    createDockWidget(engineeringView,new QGCMAVLinkInspector(mavlink,this),tr("MAVLink Inspector"),"MAVLINK_INSPECTOR_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea);
-
-    createDockWidget(engineeringView,new ParameterInterface(this),tr("Parameters"),"PARAMETER_INTERFACE_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea);
-    createDockWidget(simView,new ParameterInterface(this),tr("Parameters"),"PARAMETER_INTERFACE_DOCKWIDGET",VIEW_SIMULATION,Qt::RightDockWidgetArea);
-
 
     /*{ //Status details disabled until such a point that we can ensure it's completly operational
         QAction* tempAction = ui.menuTools->addAction(tr("Status Details"));
@@ -616,9 +535,6 @@ void MainWindow::buildCommonWidgets()
 
         }
     }
-    //Horizontal situation disabled until such a point that we can ensure it's completly operational
-    //createDockWidget(simView,new HSIDisplay(this),tr("Horizontal Situation"),"HORIZONTAL_SITUATION_INDICATOR_DOCKWIDGET",VIEW_SIMULATION,Qt::BottomDockWidgetArea);
-
 
     {
         QAction* tempAction = ui.menuTools->addAction(tr("Flight Display"));
@@ -640,19 +556,6 @@ void MainWindow::buildCommonWidgets()
 	connect(tempAction,SIGNAL(triggered(bool)),this, SLOT(showTool(bool)));
     }*/
 
-    //HUD disabled until such a point that we can ensure it's completly operational
-    //createDockWidget(engineeringView,new HUD(320,240,this),tr("Video Downlink"),"HEAD_UP_DISPLAY_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea,this->width()/1.5);
-
-    createDockWidget(simView,new PrimaryFlightDisplay(320,240,this),tr("Primary Flight Display"),
-                     "PRIMARY_FLIGHT_DISPLAY_DOCKWIDGET",VIEW_SIMULATION,Qt::RightDockWidgetArea);
-    createDockWidget(pilotView,new PrimaryFlightDisplay(320,240,this),tr("Primary Flight Display"),
-                     "PRIMARY_FLIGHT_DISPLAY_DOCKWIDGET",VIEW_FLIGHT,Qt::LeftDockWidgetArea);
-
-    QGCTabbedInfoView *infoview = new QGCTabbedInfoView(this);
-    infoview->addSource(mavlinkDecoder);
-    createDockWidget(pilotView,infoview,tr("Info View"),"UAS_INFO_INFOVIEW_DOCKWIDGET",VIEW_FLIGHT,Qt::LeftDockWidgetArea);
-
-
     // Custom widgets, added last to all menus and layouts
     buildCustomWidget();
 
@@ -677,6 +580,176 @@ void MainWindow::buildCommonWidgets()
 #endif
 }
 
+SubMainWindow* MainWindow::getView(VIEW_SECTIONS view, bool build)
+{
+    QPointer<SubMainWindow>* window;
+    QString name;
+    QString title;
+    switch (view)
+    {
+    case VIEW_MISSION:
+        window = &plannerView;
+        name = "VIEW_MISSION";
+        title = "Maps";
+        break;
+    case VIEW_FLIGHT:
+        //pilotView (aka Flight or Mission View)
+        window = &pilotView;
+        name = "VIEW_FLIGHT";
+        title = "Pilot";
+        break;
+    case VIEW_HARDWARE_CONFIG:
+        window = &configView;
+        name = "VIEW_HARDWARE_CONFIG";
+        title = tr("Hardware");
+        break;
+    case VIEW_SOFTWARE_CONFIG:
+        window = &softwareConfigView;
+        name = "VIEW_SOFTWARE_CONFIG";
+        title = tr("Software");
+        break;
+    case VIEW_ENGINEER:
+        window = &engineeringView;
+        name = "VIEW_ENGINEER";
+        title = tr("Logfile Plot");
+        break;
+    case VIEW_MAVLINK:
+        window = &mavlinkView;
+        name = "VIEW_MAVLINK";
+        title = tr("Mavlink Generator");
+        break;
+    case VIEW_SIMULATION:
+        window = &simView;
+        name = "VIEW_SIMULATOR";
+        title = tr("Simulation View");
+        break;
+    case VIEW_TERMINAL:
+        window = &terminalView;
+        name = "VIEW_TERMINAL";
+        title = tr("Terminal View");
+        break;
+    default:
+        return NULL;
+    }
+
+    if (*window || !build)
+    {
+        return *window;
+    }
+
+    QGCStartupTimer::Scope timing(name);
+    *window = new SubMainWindow(this);
+    (*window)->setObjectName(name);
+    {
+        QGCStartupTimer::Scope timing(name + " center widget");
+        (*window)->setCentralWidget(createViewCentralWidget(view));
+    }
+    addToCentralStackedWidget(*window, view, title);
+    {
+        QGCStartupTimer::Scope timing(name + " dock widgets");
+        buildViewDockWidgets(view, *window);
+    }
+    return *window;
+}
+
+QWidget* MainWindow::createViewCentralWidget(VIEW_SECTIONS view)
+{
+    switch (view)
+    {
+    case VIEW_HARDWARE_CONFIG:
+        return new ApmHardwareConfig(this);
+    case VIEW_SOFTWARE_CONFIG:
+        return new ApmSoftwareConfig(this);
+    case VIEW_ENGINEER:
+        // Once a system is connected the realtime plot replaces the log plot
+        if (linechartWidget)
+        {
+            linechartWidget->show();
+            return linechartWidget;
+        }
+        return new QGCDataPlot2D(this);
+    case VIEW_MAVLINK:
+        return new XMLCommProtocolWidget(this);
+    case VIEW_TERMINAL:
+        return new TerminalConsole(this);
+    case VIEW_MISSION:
+    case VIEW_FLIGHT:
+    case VIEW_SIMULATION:
+    default:
+        return new QGCMapTool(this);
+    }
+}
+
+void MainWindow::buildViewDockWidgets(VIEW_SECTIONS view, SubMainWindow* window)
+{
+    switch (view)
+    {
+    case VIEW_MISSION:
+        createDockWidget(window,new UASListWidget(this),tr("Unmanned Systems"),"UNMANNED_SYSTEM_LIST_DOCKWIDGET",VIEW_MISSION,Qt::LeftDockWidgetArea);
+        createDockWidget(window,new QGCWaypointListMulti(this),tr("Mission Plan"),"WAYPOINT_LIST_DOCKWIDGET",VIEW_MISSION,Qt::BottomDockWidgetArea);
+        break;
+    case VIEW_FLIGHT:
+    {
+        createDockWidget(window,new PrimaryFlightDisplay(320,240,this),tr("Primary Flight Display"),
+                         "PRIMARY_FLIGHT_DISPLAY_DOCKWIDGET",VIEW_FLIGHT,Qt::LeftDockWidgetArea);
+        QGCTabbedInfoView *infoview = new QGCTabbedInfoView(this);
+        infoview->addSource(mavlinkDecoder);
+        createDockWidget(window,infoview,tr("Info View"),"UAS_INFO_INFOVIEW_DOCKWIDGET",VIEW_FLIGHT,Qt::LeftDockWidgetArea);
+    }
+        break;
+    case VIEW_ENGINEER:
+        createDockWidget(window,new QGCMAVLinkInspector(mavlink,this),tr("MAVLink Inspector"),"MAVLINK_INSPECTOR_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea);
+        createDockWidget(window,new LinkMetricsWidget(this),tr("Link Metrics"),"LINK_METRICS_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea);
+        createDockWidget(window,new ParameterInterface(this),tr("Parameters"),"PARAMETER_INTERFACE_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea);
+        //HUD disabled until such a point that we can ensure it's completly operational
+        //createDockWidget(window,new HUD(320,240,this),tr("Video Downlink"),"HEAD_UP_DISPLAY_DOCKWIDGET",VIEW_ENGINEER,Qt::RightDockWidgetArea,this->width()/1.5);
+        break;
+    case VIEW_SIMULATION:
+        createDockWidget(window,new UASControlWidget(this),tr("Control"),"UNMANNED_SYSTEM_CONTROL_DOCKWIDGET",VIEW_SIMULATION,Qt::LeftDockWidgetArea);
+        createDockWidget(window,new QGCWaypointListMulti(this),tr("Mission Plan"),"WAYPOINT_LIST_DOCKWIDGET",VIEW_SIMULATION,Qt::BottomDockWidgetArea);
+        createDockWidget(window,new ParameterInterface(this),tr("Parameters"),"PARAMETER_INTERFACE_DOCKWIDGET",VIEW_SIMULATION,Qt::RightDockWidgetArea);
+        //Horizontal situation disabled until such a point that we can ensure it's completly operational
+        //createDockWidget(window,new HSIDisplay(this),tr("Horizontal Situation"),"HORIZONTAL_SITUATION_INDICATOR_DOCKWIDGET",VIEW_SIMULATION,Qt::BottomDockWidgetArea);
+        createDockWidget(window,new PrimaryFlightDisplay(320,240,this),tr("Primary Flight Display"),
+                         "PRIMARY_FLIGHT_DISPLAY_DOCKWIDGET",VIEW_SIMULATION,Qt::RightDockWidgetArea);
+        break;
+    default:
+        break;
+    }
+
+    // Dock widgets that were added to this view before it was built
+    QList<PendingDockWidget> pending = pendingDockWidgets.take(view);
+    foreach (const PendingDockWidget& dock, pending)
+    {
+        if (!dock.child) continue;
+        QDockWidget* widget = createDockWidget(window,dock.child,dock.title,dock.objectName,view,dock.area);
+        dock.child->show();
+        if (!dock.visible) widget->hide();
+    }
+}
+
+QDockWidget* MainWindow::createViewDockWidget(VIEW_SECTIONS view,QWidget *child,QString title,QString objectname,Qt::DockWidgetArea area,bool visible)
+{
+    SubMainWindow* window = getView(view, false);
+    if (window)
+    {
+        QDockWidget* widget = createDockWidget(window,child,title,objectname,view,area);
+        if (!visible) widget->hide();
+        return widget;
+    }
+
+    // Keep the widget out of sight until its view is built
+    child->hide();
+    PendingDockWidget dock;
+    dock.child = child;
+    dock.title = title;
+    dock.objectName = objectname;
+    dock.area = area;
+    dock.visible = visible;
+    pendingDockWidgets[view].append(dock);
+    return NULL;
+}
+
 void MainWindow::addTool(SubMainWindow *parent,VIEW_SECTIONS view,QDockWidget* widget, const QString& title, Qt::DockWidgetArea area)
 {
     QList<QAction*> actionlist = ui.menuTools->actions();
@@ -790,6 +863,10 @@ void MainWindow::loadDockWidget(QString name)
     {
         createDockWidget(centerStack->currentWidget(),new QGCMAVLinkInspector(mavlink,this),tr("MAVLink Inspector"),"MAVLINK_INSPECTOR_DOCKWIDGET",currentView,Qt::RightDockWidgetArea);
     }
+    else if (name == "LINK_METRICS_DOCKWIDGET")
+    {
+        createDockWidget(centerStack->currentWidget(),new LinkMetricsWidget(this),tr("Link Metrics"),"LINK_METRICS_DOCKWIDGET",currentView,Qt::RightDockWidgetArea);
+    }
     else if (name == "PARAMETER_INTERFACE_DOCKWIDGET")
     {
         createDockWidget(centerStack->currentWidget(),new ParameterInterface(this),tr("Parameters"),"PARAMETER_INTERFACE_DOCKWIDGET",currentView,Qt::RightDockWidgetArea);
@@ -930,8 +1007,8 @@ void MainWindow::showHILConfigurationWidget(UASInterface* uas)
 
         QGCHilConfiguration* hconf = new QGCHilConfiguration(mav, this);
         QString hilDockName = tr("HIL Config %1").arg(uas->getUASName());
-        QDockWidget* hilDock = createDockWidget(simView, hconf,hilDockName, hilDockName.toUpper().replace(" ", "_"),VIEW_SIMULATION,Qt::LeftDockWidgetArea);
-        hilDocks.insert(mav->getUASID(), hilDock);
+        createViewDockWidget(VIEW_SIMULATION, hconf,hilDockName, hilDockName.toUpper().replace(" ", "_"),Qt::LeftDockWidgetArea);
+        hilDocks.insert(mav->getUASID(), hconf);
 
         //        if (currentView != VIEW_SIMULATION)
         //            hilDock->hide();
@@ -1010,16 +1087,10 @@ void MainWindow::loadCustomWidget(const QString& fileName, int view)
         switch ((VIEW_SECTIONS)view)
         {
         case VIEW_ENGINEER:
-            createDockWidget(engineeringView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_FLIGHT:
-            createDockWidget(pilotView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_SIMULATION:
-            createDockWidget(simView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_MISSION:
-            createDockWidget(plannerView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
+            createViewDockWidget((VIEW_SECTIONS)view,tool,tool->getTitle(),tool->objectName()+"DOCK",Qt::LeftDockWidgetArea);
             break;
         default:
         {
@@ -1055,16 +1126,10 @@ void MainWindow::loadCustomWidget(const QString& fileName, bool singleinstance)
         switch (view)
         {
         case VIEW_ENGINEER:
-            createDockWidget(engineeringView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_FLIGHT:
-            createDockWidget(pilotView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_SIMULATION:
-            createDockWidget(simView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
-            break;
         case VIEW_MISSION:
-            createDockWidget(plannerView,tool,tool->getTitle(),tool->objectName()+"DOCK",(VIEW_SECTIONS)view,Qt::LeftDockWidgetArea);
+            createViewDockWidget((VIEW_SECTIONS)view,tool,tool->getTitle(),tool->objectName()+"DOCK",Qt::LeftDockWidgetArea);
             break;
         default:
         {
@@ -1736,9 +1801,9 @@ void MainWindow::setActiveUAS(UASInterface* uas)
     // Enable and rename menu
     //    ui.menuUnmanned_System->setTitle(uas->getUASName());
     //    if (!ui.menuUnmanned_System->isEnabled()) ui.menuUnmanned_System->setEnabled(true);
-    if (settings.contains(getWindowStateKey()))
+    SubMainWindow *win = qobject_cast<SubMainWindow*>(centerStack->currentWidget());
+    if (win && settings.contains(getWindowStateKey()))
     {
-        SubMainWindow *win = qobject_cast<SubMainWindow*>(centerStack->currentWidget());
         //settings.setValue(getWindowStateKey(), win->saveState(QGC::applicationVersion()))
         win->restoreState(settings.value(getWindowStateKey()).toByteArray(), QGC::applicationVersion());
     }
@@ -1871,7 +1936,8 @@ void MainWindow::UASCreated(UASInterface* uas)
     }
 
     linechartWidget->addSource(mavlinkDecoder);
-    if (engineeringView->centralWidget() != linechartWidget)
+    // If the engineering view is not built yet, it picks up the realtime plot when it is
+    if (engineeringView && engineeringView->centralWidget() != linechartWidget)
     {
         engineeringView->setCentralWidget(linechartWidget);
         linechartWidget->show();
@@ -1981,6 +2047,7 @@ void MainWindow::storeViewState()
     {
         // Save current state
         SubMainWindow *win = qobject_cast<SubMainWindow*>(centerStack->currentWidget());
+        if (!win) return;
         QList<QDockWidget*> widgets = win->findChildren<QDockWidget*>();
         QString widgetnames = "";
         for (int i=0;i<widgets.size();i++)
@@ -2002,72 +2069,50 @@ void MainWindow::storeViewState()
 
 void MainWindow::loadViewState()
 {
-    // Restore center stack state
-    int index = settings.value(getWindowStateKey()+"CENTER_WIDGET", -1).toInt();
-    // The offline plot view is usually the consequence of a logging run, always show the realtime view first
-    if (centerStack->indexOf(engineeringView) == index)
-    {
-        // Rewrite to realtime plot
-        //index = centerStack->indexOf(linechartWidget);
-    }
-
-    if (index != -1)
-    {
-        centerStack->setCurrentIndex(index);
-    }
-    else
+    // The center stack index stored with the view state depends on the order
+    // the views were built in, the view is restored from currentView instead
+    if (!settings.contains(getWindowStateKey()+"CENTER_WIDGET"))
     {
         // Hide custom widgets
         if (detectionDockWidget) detectionDockWidget->hide();
         if (watchdogControlDockWidget) watchdogControlDockWidget->hide();
+    }
 
-        // Load defaults
-        switch (currentView)
-        {
-        case VIEW_HARDWARE_CONFIG:
-            centerStack->setCurrentWidget(configView);
-            break;
-        case VIEW_SOFTWARE_CONFIG:
-            centerStack->setCurrentWidget(softwareConfigView);
-            break;
-        case VIEW_ENGINEER:
-            centerStack->setCurrentWidget(engineeringView);
-            break;
-        case VIEW_FLIGHT:
-            centerStack->setCurrentWidget(pilotView);
-            break;
-        case VIEW_MAVLINK:
-            centerStack->setCurrentWidget(mavlinkView);
-            break;
-        case VIEW_FIRMWAREUPDATE:
-            centerStack->setCurrentWidget(firmwareUpdateWidget);
-            break;
-        case VIEW_MISSION:
-            centerStack->setCurrentWidget(plannerView);
-            break;
-
-        case VIEW_SIMULATION:
-            centerStack->setCurrentWidget(simView);
-            break;
-
-        case VIEW_TERMINAL:
-            centerStack->setCurrentWidget(terminalView);
-            break;
+    // Show the view, it is built on first activation
+    switch (currentView)
+    {
+    case VIEW_HARDWARE_CONFIG:
+    case VIEW_SOFTWARE_CONFIG:
+    case VIEW_ENGINEER:
+    case VIEW_FLIGHT:
+    case VIEW_MAVLINK:
+    case VIEW_MISSION:
+    case VIEW_SIMULATION:
+    case VIEW_TERMINAL:
+        centerStack->setCurrentWidget(getView(currentView));
+        break;
+    case VIEW_FIRMWAREUPDATE:
+        centerStack->setCurrentWidget(firmwareUpdateWidget);
+        break;
 
-        case VIEW_UNCONNECTED:
-        case VIEW_FULL:
-        default:
-            //centerStack->setCurrentWidget(mapWidget);
-            if (controlDockWidget)
-            {
-                controlDockWidget->hide();
-            }
-            if (listDockWidget)
-            {
-                listDockWidget->show();
-            }
-            break;
+    case VIEW_UNCONNECTED:
+    case VIEW_FULL:
+    default:
+        // Views without a center widget of their own keep the maps
+        if (centerStack->count() == 0)
+        {
+            centerStack->setCurrentWidget(getView(VIEW_MISSION));
+        }
+        //centerStack->setCurrentWidget(mapWidget);
+        if (controlDockWidget)
+        {
+            controlDockWidget->hide();
         }
+        if (listDockWidget)
+        {
+            listDockWidget->show();
+        }
+        break;
     }
 
     // Restore the widget positions and size
@@ -2084,9 +2129,9 @@ void MainWindow::loadViewState()
             }
         }
     }
-    if (settings.contains(getWindowStateKey()))
+    SubMainWindow *win = qobject_cast<SubMainWindow*>(centerStack->currentWidget());
+    if (win && settings.contains(getWindowStateKey()))
     {
-        SubMainWindow *win = qobject_cast<SubMainWindow*>(centerStack->currentWidget());
         //settings.setValue(getWindowStateKey(), win->saveState(QGC::applicationVersion()))
         win->restoreState(settings.value(getWindowStateKey()).toByteArray(), QGC::applicationVersion());
     }
@@ -78,6 +78,7 @@ This file is part of the QGROUNDCONTROL project
 #include "SlugsPadCameraControl.h"
 #include "UASControlParameters.h"
 #include "QGCMAVLinkInspector.h"
+#include "LinkMetricsWidget.h"
 #include "QGCMAVLinkLogPlayer.h"
 #include "QGCVehicleConfig.h"
 #include "MAVLinkDecoder.h"
@@ -327,6 +328,28 @@ protected:
      */
     void addToCentralStackedWidget(QWidget* widget, VIEW_SECTIONS viewSection, const QString& title);
 
+    /**
+     * @brief Returns the window of a view, built with its dock widgets on first use
+     *
+     * @param view      The view section
+     * @param build     If false, NULL is returned for views that were not built yet
+     * @return The window or NULL for sections without a window of their own
+     */
+    SubMainWindow* getView(VIEW_SECTIONS view, bool build = true);
+    /** @brief Creates the center widget of a view */
+    QWidget* createViewCentralWidget(VIEW_SECTIONS view);
+    /** @brief Creates the default dock widgets of a view and the ones added before it was built */
+    void buildViewDockWidgets(VIEW_SECTIONS view, SubMainWindow* window);
+    /**
+     * @brief Adds an already instantiated QWidget as dock widget to a view
+     *
+     * If the view was not built yet, the widget is hidden and docked once the
+     * view is built.
+     *
+     * @return The dock widget, NULL if it is docked later
+     */
+    QDockWidget* createViewDockWidget(VIEW_SECTIONS view,QWidget *child,QString title,QString objectname,Qt::DockWidgetArea area,bool visible=true);
+
     /** @brief Catch window resize events */
     void resizeEvent(QResizeEvent * event);
 
@@ -426,7 +449,7 @@ protected:
     QPointer<MAVLinkDecoder> mavlinkDecoder;
     QPointer<QDockWidget> mavlinkSenderWidget;
     QGCMAVLinkLogPlayer* logPlayer;
-    QMap<int, QDockWidget*> hilDocks;
+    QMap<int, QPointer<QWidget> > hilDocks;
 
     // Popup widgets
     QPointer<JoystickWidget> joystickWidget;
@@ -471,6 +494,16 @@ private:
     QMap<QAction*,QString > menuToDockNameMap;
     QMap<QDockWidget*,QWidget*> dockToTitleBarMap;
     QMap<VIEW_SECTIONS,QMap<QString,QWidget*> > centralWidgetToDockWidgetsMap;
+
+    /** @brief Dock widget waiting for its view to be built */
+    struct PendingDockWidget {
+        QPointer<QWidget> child;
+        QString title;
+        QString objectName;
+        Qt::DockWidgetArea area;
+        bool visible;
+    };
+    QMap<VIEW_SECTIONS,QList<PendingDockWidget> > pendingDockWidgets;
     bool isAdvancedMode;
     bool dockWidgetTitleBarEnabled;
     Ui::MainWindow ui;
@@ -124,6 +124,7 @@ PrimaryFlightDisplay::PrimaryFlightDisplay(int width, int height, QWidget *paren
     QWidget(parent),
 
     uas(NULL),
+    stateVersion(0),
 
     /*
     altimeterMode(GPS_MAIN),
@@ -179,7 +180,7 @@ PrimaryFlightDisplay::PrimaryFlightDisplay(int width, int height, QWidget *paren
     // Refresh timer
     refreshTimer->setInterval(updateInterval);
     //    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(paintHUD()));
-    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(update()));
+    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(refreshState()));
 }
 
 PrimaryFlightDisplay::~PrimaryFlightDisplay()
@@ -261,33 +262,9 @@ void PrimaryFlightDisplay::paintEvent(QPaintEvent *event)
 void PrimaryFlightDisplay::forgetUAS(UASInterface* uas)
 {
     if (this->uas != NULL && this->uas == uas) {
-        // Disconnect any previously connected active MAV
-        disconnect(this->uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)),
-                   this, SLOT(updateAttitude(UASInterface*, double, double, double, quint64)));
-        disconnect(this->uas, SIGNAL(attitudeChanged(UASInterface*,int,double,double,double,quint64)),
-                   this, SLOT(updateAttitude(UASInterface*,int,double, double, double, quint64)));
-        //disconnect(this->uas, SIGNAL(waypointSelected(int,int)),
-        //           this, SLOT(selectWaypoint(int, int)));
-        disconnect(this->uas, SIGNAL(primarySpeedChanged(UASInterface*, double, quint64)),
-                   this, SLOT(updatePrimarySpeed(UASInterface*,double,quint64)));
-        disconnect(this->uas, SIGNAL(gpsSpeedChanged(UASInterface*, double, quint64)),
-                   this, SLOT(updateGPSSpeed(UASInterface*,double,quint64)));
-        disconnect(this->uas, SIGNAL(climbRateChanged(UASInterface*, double, quint64)),
-                   this,SLOT(updateClimbRate(UASInterface*, double, quint64)));
-        disconnect(this->uas, SIGNAL(primaryAltitudeChanged(UASInterface*, double, quint64)),
-                   this, SLOT(updatePrimaryAltitude(UASInterface*, double, quint64)));
-        disconnect(this->uas, SIGNAL(gpsAltitudeChanged(UASInterface*, double, quint64)),
-                   this, SLOT(updateGPSAltitude(UASInterface*, double, quint64)));
-        disconnect(this->uas, SIGNAL(navigationControllerErrorsChanged(UASInterface*, double, double, double)),
-                   this, SLOT(updateNavigationControllerErrors(UASInterface*, double, double, double)));
-
-        //disconnect(this->uas, SIGNAL(batteryChanged(UASInterface*, double, double, double, int)), this, SLOT(updateBattery(UASInterface*, double, double, double, int)));
-        //disconnect(this->uas, SIGNAL(statusChanged(UASInterface*,QString,QString)), this, SLOT(updateState(UASInterface*,QString)));
-        //disconnect(this->uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateMode(int,QString,QString)));
-        //disconnect(this->uas, SIGNAL(heartbeat(UASInterface*)), this, SLOT(receiveHeartbeat(UASInterface*)));
-        //disconnect(this->uas, SIGNAL(armingChanged(bool)), this, SLOT(updateArmed(bool)));
-        //disconnect(this->uas, SIGNAL(satelliteCountChanged(double, QString)), this, SLOT(updateSatelliteCount(double, QString)));
-        //disconnect(this->uas, SIGNAL(localizationChanged(UASInterface* uas, int fix)), this, SLOT(updateGPSFixType(UASInterface*,int)));
+        // The state is polled, there are no signals to disconnect
+        this->uas = NULL;
+        stateVersion = 0;
     }
 }
 
@@ -300,117 +277,65 @@ void PrimaryFlightDisplay::setActiveUAS(UASInterface* uas)
     if (uas == this->uas)
         return; //no need to rewire
 
-    // Disconnect the previous one (if any)
+    // Forget the previous one (if any)
     forgetUAS(this->uas);
 
     if (uas) {
-        // Now connect the new UAS
-        // Setup communication
-        connect(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateAttitude(UASInterface*, double, double, double, quint64)));
-        connect(uas, SIGNAL(attitudeChanged(UASInterface*,int,double,double,double,quint64)), this, SLOT(updateAttitude(UASInterface*,int,double, double, double, quint64)));
-
-        //connect(uas, SIGNAL(batteryChanged(UASInterface*, double, double, double, int)), this, SLOT(updateBattery(UASInterface*, double, double, double, int)));
-        //connect(uas, SIGNAL(statusChanged(UASInterface*,QString,QString)), this, SLOT(updateState(UASInterface*,QString)));
-        //connect(uas, SIGNAL(modeChanged(int,QString,QString)), this, SLOT(updateMode(int,QString,QString)));
-        //connect(uas, SIGNAL(heartbeat(UASInterface*)), this, SLOT(receiveHeartbeat(UASInterface*)));
-        //connect(uas, SIGNAL(armingChanged(bool)), this, SLOT(updateArmed(bool)));
-        //connect(uas, SIGNAL(satelliteCountChanged(double, QString)), this, SLOT(updateSatelliteCount(double, QString)));
-
-        //connect(uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateLocalPosition(UASInterface*,double,double,double,quint64)));
-        //connect(uas, SIGNAL(globalPositionChanged(UASInterface*,double,double,double,quint64)), this, SLOT(updateGlobalPosition(UASInterface*,double,double,double,quint64)));
-        //connect(uas, SIGNAL(waypointSelected(int,int)), this,
-        //        SLOT(selectWaypoint(int, int)));
-        connect(uas, SIGNAL(primarySpeedChanged(UASInterface*, double, quint64)), this, SLOT(updatePrimarySpeed(UASInterface*,double,quint64)));
-        connect(uas, SIGNAL(gpsSpeedChanged(UASInterface*, double, quint64)), this, SLOT(updateGPSSpeed(UASInterface*,double,quint64)));
-        connect(uas, SIGNAL(climbRateChanged(UASInterface*, double, quint64)), this,
-                SLOT(updateClimbRate(UASInterface*, double, quint64)));
-        connect(uas, SIGNAL(primaryAltitudeChanged(UASInterface*, double, quint64)), this, SLOT(updatePrimaryAltitude(UASInterface*, double, quint64)));
-        connect(uas, SIGNAL(gpsAltitudeChanged(UASInterface*, double, quint64)), this, SLOT(updateGPSAltitude(UASInterface*, double, quint64)));
-        connect(uas, SIGNAL(navigationControllerErrorsChanged(UASInterface*, double, double, double)), this, SLOT(updateNavigationControllerErrors(UASInterface*, double, double, double)));
-
-        // Set new UAS
+        // Set new UAS, its state is read by refreshState() once per frame
         this->uas = uas;
+        stateVersion = 0;
     }
 }
 
-void PrimaryFlightDisplay::updateAttitude(UASInterface* uas, double roll, double pitch, double yaw, quint64 timestamp)
+static float toDegrees(double radians)
 {
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
-        // Called from UAS.cc l. 616
-        if (isnan(roll) || isinf(roll)) {
-            this->roll = UNKNOWN_ATTITUDE;
-        } else {
-            this->roll = roll * (180.0 / M_PI);
-        }
-
-        if (isnan(pitch) || isinf(pitch)) {
-            this->pitch = UNKNOWN_ATTITUDE;
-        } else {
-            this->pitch = pitch * (180.0 / M_PI);
-        }
-
-        if (isnan(yaw) || isinf(yaw)) {
-            this->heading = UNKNOWN_ATTITUDE;
-        } else {
-            yaw = yaw * (180.0 / M_PI);
-            if (yaw<0) yaw+=360;
-            this->heading = yaw;
-        }
-
-}
-
-void PrimaryFlightDisplay::updateAttitude(UASInterface* uas, int component, double roll, double pitch, double yaw, quint64 timestamp)
-{
-    Q_UNUSED(component);
-    this->updateAttitude(uas, roll, pitch, yaw, timestamp);
+    if (isnan(radians) || isinf(radians))
+        return UNKNOWN_ATTITUDE;
+    return radians * (180.0 / M_PI);
 }
 
-void PrimaryFlightDisplay::updatePrimarySpeed(UASInterface* uas, double speed, quint64 timestamp)
+void PrimaryFlightDisplay::refreshState()
 {
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
+    if (!uas)
+        return;
 
-    primarySpeed = speed;
-    didReceivePrimarySpeed = true;
-}
-
-void PrimaryFlightDisplay::updateGPSSpeed(UASInterface* uas, double speed, quint64 timestamp)
-{
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
+    VehicleState state;
+    if (!uas->getVehicleState()->readIfNewer(stateVersion, state))
+        return; // Nothing decoded since the last frame, no need to repaint
 
-    groundspeed = speed;
-    if (!didReceivePrimarySpeed)
-        primarySpeed = speed;
-}
+    if (state.attitudeKnown) {
+        roll = toDegrees(state.roll);
+        pitch = toDegrees(state.pitch);
+    }
+    // VFR_HUD provides the heading until the first ATTITUDE arrives
+    if (state.attitudeKnown || state.airSpeedKnown) {
+        heading = toDegrees(state.yaw);
+        if (heading != UNKNOWN_ATTITUDE && heading < 0)
+            heading += 360;
+    }
 
-void PrimaryFlightDisplay::updateClimbRate(UASInterface* uas, double climbRate, quint64 timestamp) {
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
-    verticalVelocity = climbRate;
-}
+    if (state.globalPositionKnown) {
+        GPSAltitude = state.altitude;
+        aboveHomeAltitude = state.relativeAltitude;
+    }
+    // The primary values come from VFR_HUD, fall back to GPS until it arrives
+    if (state.primaryAltitudeKnown) {
+        primaryAltitude = state.primaryAltitude;
+        verticalVelocity = state.climbRate;
+    } else if (state.globalPositionKnown) {
+        primaryAltitude = state.altitude;
+    }
 
-void PrimaryFlightDisplay::updatePrimaryAltitude(UASInterface* uas, double altitude, quint64 timestamp) {
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
-    primaryAltitude = altitude;
-    didReceivePrimaryAltitude = true;
-}
+    if (state.airSpeedKnown || state.globalPositionKnown) {
+        groundspeed = state.groundSpeed;
+        primarySpeed = state.airSpeedKnown ? state.airSpeed : state.groundSpeed;
+    }
 
-void PrimaryFlightDisplay::updateGPSAltitude(UASInterface* uas, double altitude, quint64 timestamp) {
-    Q_UNUSED(uas);
-    Q_UNUSED(timestamp);
-    GPSAltitude = altitude;
-    if (!didReceivePrimaryAltitude)
-        primaryAltitude = altitude;
-}
+    navigationAltitudeError = state.navigationAltitudeError;
+    navigationSpeedError = state.navigationSpeedError;
+    navigationCrosstrackError = state.navigationCrosstrackError;
 
-void PrimaryFlightDisplay::updateNavigationControllerErrors(UASInterface* uas, double altitudeError, double speedError, double xtrackError) {
-    Q_UNUSED(uas);
-    this->navigationAltitudeError = altitudeError;
-    this->navigationSpeedError = speedError;
-    this->navigationCrosstrackError = xtrackError;
+    update();
 }
 
 
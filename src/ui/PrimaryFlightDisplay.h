@@ -13,17 +13,8 @@ public:
     ~PrimaryFlightDisplay();
 
 public slots:
-    /** @brief Attitude from main autopilot / system state */
-    void updateAttitude(UASInterface* uas, double roll, double pitch, double yaw, quint64 timestamp);
-    /** @brief Attitude from one specific component / redundant autopilot */
-    void updateAttitude(UASInterface* uas, int component, double roll, double pitch, double yaw, quint64 timestamp);
-
-    void updatePrimarySpeed(UASInterface* uas, double speed, quint64 timstamp);
-    void updateGPSSpeed(UASInterface* uas, double speed, quint64 timstamp);
-    void updateClimbRate(UASInterface* uas, double altitude, quint64 timestamp);
-    void updatePrimaryAltitude(UASInterface* uas, double altitude, quint64 timestamp);
-    void updateGPSAltitude(UASInterface* uas, double altitude, quint64 timestamp);
-    void updateNavigationControllerErrors(UASInterface* uas, double altitudeError, double speedError, double xtrackError);
+    /** @brief Copy the state snapshot of the UAS and repaint, if it changed since the last frame */
+    void refreshState();
 
     /** @brief Set the currently monitored UAS */
     //void addUAS(UASInterface* uas);
@@ -125,8 +116,7 @@ private:
     SpeedMode speedMode;
     */
 
-    bool didReceivePrimaryAltitude;
-    bool didReceivePrimarySpeed;
+    quint64 stateVersion;       ///< Version of the last vehicle state snapshot painted
 
     float roll;
     float pitch;
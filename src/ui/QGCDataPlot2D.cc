@@ -50,6 +50,7 @@ QGCDataPlot2D::QGCDataPlot2D(QWidget *parent) :
     QWidget(parent),
     plot(new IncrementalPlot()),
     logFile(NULL),
+    dataFlashLog(new DataFlashLog()),
     ui(new Ui::QGCDataPlot2D)
 {
     ui->setupUi(this);
@@ -80,6 +81,8 @@ void QGCDataPlot2D::reloadFile()
             loadRawLog(fileName, ui->xAxis->currentText(), ui->yAxis->text());
         } else if (ui->inputFileType->currentText().contains("CSV")) {
             loadCsvLog(fileName, ui->xAxis->currentText(), ui->yAxis->text());
+        } else if (ui->inputFileType->currentText().contains("DataFlash")) {
+            loadDataFlashLog(fileName, ui->xAxis->currentText(), ui->yAxis->text());
         }
     }
 }
@@ -92,6 +95,8 @@ void QGCDataPlot2D::loadFile()
             loadRawLog(fileName);
         } else if (ui->inputFileType->currentText().contains("CSV")) {
             loadCsvLog(fileName);
+        } else if (ui->inputFileType->currentText().contains("DataFlash")) {
+            loadDataFlashLog(fileName);
         }
     }
 }
@@ -104,6 +109,8 @@ void QGCDataPlot2D::loadFile(QString file)
             loadRawLog(fileName);
         } else if (fileName.contains(".txt") || fileName.contains(".csv") || fileName.contains(".csv")) {
             loadCsvLog(fileName);
+        } else if (fileName.endsWith(".bin", Qt::CaseInsensitive)) {
+            loadDataFlashLog(fileName);
         }
     }
 }
@@ -252,6 +259,10 @@ void QGCDataPlot2D::selectFile()
     if (ui->inputFileType->currentText().contains("pxIMU") || ui->inputFileType->currentText().contains("RAW")) {
         fileName = QFileDialog::getOpenFileName(this, tr("Specify log file name"), QString(), "Logfile (*.imu *.raw)");
 	}
+    else if (ui->inputFileType->currentText().contains("DataFlash"))
+    {
+        fileName = QFileDialog::getOpenFileName(this, tr("Specify log file name"), QString(), "DataFlash log (*.bin)");
+    }
 	else
 	{
         fileName = QFileDialog::getOpenFileName(this, tr("Specify log file name"), QString(), "Logfile (*.csv *.txt *.log)");
@@ -323,6 +334,7 @@ void QGCDataPlot2D::loadRawLog(QString file, QString xAxisName, QString yAxisFil
  */
 void QGCDataPlot2D::loadCsvLog(QString file, QString xAxisName, QString yAxisFilter)
 {
+    dataFlashLog->close();
     if (logFile != NULL) {
         logFile->close();
         delete logFile;
@@ -559,6 +571,98 @@ void QGCDataPlot2D::loadCsvLog(QString file, QString xAxisName, QString yAxisFil
     plot->setStyleText(ui->style->currentText());
 }
 
+/**
+ * Plots fields of an APM DataFlash log. The log is mapped and indexed once,
+ * reloading with a different selection only decodes the new fields.
+ *
+ * @param file Name of the .bin file
+ * @param xAxisName "Time" for the timestamp of each message in seconds, "Index" for the message number
+ * @param yAxisFilter Fields to plot as MSG.Field, separated by "|". A field can be renamed
+ *        with MSG.Field:Name. If empty, the attitude (or the first message type) is plotted.
+ */
+void QGCDataPlot2D::loadDataFlashLog(QString file, QString xAxisName, QString yAxisFilter)
+{
+    if (logFile != NULL) {
+        logFile->close();
+        delete logFile;
+        logFile = NULL;
+    }
+    curveNames.clear();
+
+    if (!dataFlashLog->isOpen() || dataFlashLog->getFileName() != file) {
+        if (!dataFlashLog->open(file)) {
+            ui->filenameLabel->setText(dataFlashLog->getErrorString());
+            return;
+        }
+    }
+    QStringList messageNames = dataFlashLog->getMessageNames();
+    ui->filenameLabel->setText(tr("%1: %2 message types, %3 MB indexed at %4 MB/s")
+                               .arg(file.split("/").last().split("\\").last())
+                               .arg(messageNames.count())
+                               .arg(dataFlashLog->getSize() / (1024.0 * 1024.0), 0, 'f', 1)
+                               .arg(dataFlashLog->getIndexThroughput(), 0, 'f', 0));
+
+    // Set plot title
+    if (ui->plotTitle->text() != "") plot->setTitle(ui->plotTitle->text());
+    if (ui->plotXAxisLabel->text() != "") plot->setAxisTitle(QwtPlot::xBottom, ui->plotXAxisLabel->text());
+    if (ui->plotYAxisLabel->text() != "") plot->setAxisTitle(QwtPlot::yLeft, ui->plotYAxisLabel->text());
+
+    plot->removeData();
+
+    bool useIndex = (xAxisName == "Index");
+    ui->xAxis->clear();
+    ui->xAxis->addItem("Time");
+    ui->xAxis->addItem("Index");
+    ui->xAxis->setCurrentIndex(useIndex ? 1 : 0);
+    ui->xRegressionComboBox->clear();
+    ui->yRegressionComboBox->clear();
+    ui->regressionOutput->clear();
+
+    QStringList yCurves = yAxisFilter.split("|", QString::SkipEmptyParts);
+    if (yCurves.isEmpty() && !messageNames.isEmpty()) {
+        QString name = messageNames.contains("ATT") ? QString("ATT") : messageNames.first();
+        foreach (const QString& field, dataFlashLog->getFieldNames(name)) {
+            if (!field.startsWith("Time")) yCurves.append(name + "." + field);
+        }
+        ui->yAxis->setText(yCurves.join("|"));
+    }
+
+    foreach (const QString& curve, yCurves) {
+        QString source = curve.section(':', 0, 0);
+        QString label = curve.contains(':') ? curve.section(':', 1) : source;
+        QString name = source.section('.', 0, 0);
+        QString field = source.section('.', 1);
+
+        QVector<double> yValues = dataFlashLog->getColumn(name, field);
+        if (yValues.isEmpty()) continue;
+        QVector<double> xValues;
+        if (useIndex) {
+            xValues.resize(yValues.size());
+            for (int i = 0; i < xValues.size(); ++i) xValues[i] = i;
+        } else {
+            xValues = dataFlashLog->getTime(name);
+        }
+
+        // Only append definitely valid values
+        QVector<double> x;
+        QVector<double> y;
+        x.reserve(yValues.size());
+        y.reserve(yValues.size());
+        for (int i = 0; i < yValues.size(); ++i) {
+            if (!isnan(yValues.at(i)) && !isinf(yValues.at(i))) {
+                x.append(xValues.at(i));
+                y.append(yValues.at(i));
+            }
+        }
+        curveNames.append(label);
+        ui->xRegressionComboBox->addItem(label);
+        ui->yRegressionComboBox->addItem(label);
+        plot->appendData(label, x.data(), y.data(), x.size());
+    }
+    plot->updateScale();
+    plot->setStyleText(ui->style->currentText());
+}
+
 bool QGCDataPlot2D::calculateRegression()
 {
     // TODO: Add support for quadratic / cubic curve fitting
@@ -575,7 +679,7 @@ bool QGCDataPlot2D::calculateRegression(QString xName, QString yName, QString me
     bool result = false;
     QString function;
     if (xName != yName) {
-        if (QFileInfo(fileName).isReadable()) {
+        if (QFileInfo(fileName).isReadable() && !dataFlashLog->isOpen()) {
             loadCsvLog(fileName, xName, yName);
             ui->xRegressionComboBox->setCurrentIndex(curveNames.indexOf(xName));
             ui->yRegressionComboBox->setCurrentIndex(curveNames.indexOf(yName));
@@ -712,7 +816,42 @@ void QGCDataPlot2D::saveCsvLog()
     //            "CSV file (*.csv);;Text file (*.txt)");
     //    }
 
-    bool success = logFile->copy(fileName);
+    bool success = false;
+    if (dataFlashLog->isOpen()) {
+        // Export the plotted fields, one file per message type
+        QMap<QString, QStringList> fields;
+        foreach (QString curve, ui->yAxis->text().split("|", QString::SkipEmptyParts)) {
+            curve = curve.section(':', 0, 0);
+            fields[curve.section('.', 0, 0)].append(curve.section('.', 1));
+        }
+        success = !fields.isEmpty();
+        QMap<QString, QStringList>::iterator i;
+        for (i = fields.begin(); i != fields.end(); ++i) {
+            const DataFlashLog::Format* format = dataFlashLog->getFormat(i.key());
+            if (!format) {
+                success = false;
+                continue;
+            }
+            // Keep the timestamp of the message with its values
+            foreach (const QString& time, QStringList() << "TimeUS" << "TimeMS") {
+                if (format->labels.contains(time) && !i.value().contains(time)) {
+                    i.value().prepend(time);
+                    break;
+                }
+            }
+            QString name = fileName;
+            if (fields.count() > 1) {
+                QFileInfo info(fileName);
+                name = info.absolutePath() + "/" + info.completeBaseName() + "_" + i.key() + "." + info.suffix();
+            }
+            if (!dataFlashLog->exportCsv(name, i.key(), i.value())) {
+                QLOG_WARN() << "DataFlash CSV export failed:" << dataFlashLog->getErrorString();
+                success = false;
+            }
+        }
+    } else if (logFile) {
+        success = logFile->copy(fileName);
+    }
 
     QLOG_DEBUG() << "Saved CSV log. Success: " << success;
 
@@ -721,6 +860,7 @@ void QGCDataPlot2D::saveCsvLog()
 
 QGCDataPlot2D::~QGCDataPlot2D()
 {
+    delete dataFlashLog;
     delete ui;
 }
 
@@ -5,6 +5,7 @@
 #include <QFile>
 #include "IncrementalPlot.h"
 #include "LogCompressor.h"
+#include "DataFlashLog.h"
 
 namespace Ui
 {
@@ -34,6 +35,8 @@ public slots:
     void selectFile();
     void loadCsvLog(QString file, QString xAxisName="", QString yAxisFilter="");
     void loadRawLog(QString file, QString xAxisName="", QString yAxisFilter="");
+    /** @brief Plot fields of an APM DataFlash log, selected as MSG.Field in the y axis filter */
+    void loadDataFlashLog(QString file, QString xAxisName="", QString yAxisFilter="");
     void saveCsvLog();
     /** @brief Save plot to PDF or SVG */
     void savePlot();
@@ -66,6 +69,7 @@ protected:
     IncrementalPlot* plot;
     LogCompressor* compressor;
     QFile* logFile;
+    DataFlashLog* dataFlashLog;     ///< Open while a DataFlash log is plotted
     QString fileName;
     QStringList curveNames;
 
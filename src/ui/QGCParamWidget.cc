@@ -44,13 +44,18 @@ This file is part of the QGROUNDCONTROL project
 #include <QMessageBox>
 #include <QApplication>
 
+// Interval of the coalesced tree updates, roughly one display frame
+#define PARAM_VIEW_UPDATE_INTERVAL 20
+
 /**
  * @param uas MAV to set the parameters on
  * @param parent Parent widget
  */
 QGCParamWidget::QGCParamWidget(UASInterface* uas, QWidget *parent) :
     QGCUASParamManager(uas, parent),
-    components(new QMap<int, QTreeWidgetItem*>())
+    components(new QMap<int, QTreeWidgetItem*>()),
+    statusUpdatePending(false),
+    lastParameterCount(0)
 {
     // Load settings
     loadSettings();
@@ -148,6 +153,11 @@ QGCParamWidget::QGCParamWidget(UASInterface* uas, QWidget *parent) :
     connect(this, SIGNAL(requestParameter(int,int)), uas, SLOT(requestParameter(int,int)));
     connect(&retransmissionTimer, SIGNAL(timeout()), this, SLOT(retransmissionGuardTick()));
 
+    // Parameters arrive much faster than the tree can be redrawn, batch them
+    viewUpdateTimer.setSingleShot(true);
+    viewUpdateTimer.setInterval(PARAM_VIEW_UPDATE_INTERVAL);
+    connect(&viewUpdateTimer, SIGNAL(timeout()), this, SLOT(updateView()));
+
     // Get parameters
     if (uas) requestParameterList();
 }
@@ -328,6 +338,7 @@ void QGCParamWidget::addComponent(int uas, int component, QString componentName)
         components->insert(component, comp);
         // Create grouping and update maps
         paramGroups.insert(component, new QMap<QString, QTreeWidgetItem*>());
+        paramItems.insert(component, QHash<QString, QTreeWidgetItem*>());
         tree->addTopLevelItem(comp);
         tree->update();
         // Create map in parameters
@@ -350,29 +361,12 @@ void QGCParamWidget::addParameter(int uas, int component, int paramCount, int pa
 {
     addParameter(uas, component, parameterName, value);
 
-    // Missing packets list has to be instantiated for all components
-    if (!transmissionMissingPackets.contains(component)) {
-        transmissionMissingPackets.insert(component, new QList<int>());
-    }
-
     // List mode is different from single parameter transfers
     if (transmissionListMode) {
         // Only accept the list size once on the first packet from
-        // each component
-        if (!transmissionListSizeKnown.contains(component))
+        // each component, all other parameters start as missing
+        if (transmissionMissingPackets.addListParameter(component, paramCount, paramId))
         {
-            // Mark list size as known
-            transmissionListSizeKnown.insert(component, true);
-
-            // Mark all parameters as missing
-            for (int i = 0; i < paramCount; ++i)
-            {
-                if (!transmissionMissingPackets.value(component)->contains(i))
-                {
-                    transmissionMissingPackets.value(component)->append(i);
-                }
-            }
-
             // There is only one transmission timeout for all components
             // since components do not manage their transmission,
             // the longest timeout is safe for all components.
@@ -389,31 +383,26 @@ void QGCParamWidget::addParameter(int uas, int component, int paramCount, int pa
     }
 
     // Mark this parameter as received in read list
-    int index = transmissionMissingPackets.value(component)->indexOf(paramId);
-    // If the MAV sent the parameter without request, it wont be in missing list
-    if (index != -1) transmissionMissingPackets.value(component)->removeAt(index);
+    // If the MAV sent the parameter without request, it is not tracked
+    transmissionMissingPackets.markReceived(component, paramId);
 
     bool justWritten = false;
     bool writeMismatch = false;
+    QVariant writtenValue;
     //bool lastWritten = false;
     // Mark this parameter as received in write ACK list
     QMap<QString, QVariant>* map = transmissionMissingWriteAckPackets.value(component);
     if (map && map->contains(parameterName))
     {
         justWritten = true;
-        QVariant newval = map->value(parameterName);
-        if (map->value(parameterName) != value)
+        writtenValue = map->take(parameterName);
+        if (writtenValue != value)
         {
             writeMismatch = true;
         }
-        map->remove(parameterName);
     }
 
-    int missCount = 0;
-    foreach (int key, transmissionMissingPackets.keys())
-    {
-        missCount +=  transmissionMissingPackets.value(key)->count();
-    }
+    int missCount = transmissionMissingPackets.getMissingCount();
 
     int missWriteCount = 0;
     foreach (int key, transmissionMissingWriteAckPackets.keys())
@@ -421,6 +410,12 @@ void QGCParamWidget::addParameter(int uas, int component, int paramCount, int pa
         missWriteCount += transmissionMissingWriteAckPackets.value(key)->count();
     }
 
+    if (justWritten)
+    {
+        // Write results are rare and always shown right away
+        statusUpdatePending = false;
+    }
+
     if (justWritten && !writeMismatch && missWriteCount == 0)
     {
         // Just wrote one and count went to 0 - this was the last missing write parameter
@@ -440,36 +435,16 @@ void QGCParamWidget::addParameter(int uas, int component, int paramCount, int pa
         QPalette pal = statusLabel->palette();
         pal.setColor(backgroundRole(), QGC::colorRed);
         statusLabel->setPalette(pal);
-        statusLabel->setText(tr("FAILURE: Wrote %1: sent %2 != onboard %3").arg(parameterName).arg(map->value(parameterName).toDouble()).arg(value.toDouble()));
+        statusLabel->setText(tr("FAILURE: Wrote %1: sent %2 != onboard %3").arg(parameterName).arg(writtenValue.toDouble()).arg(value.toDouble()));
     }
     else
     {
-        if (missCount > 0)
-        {
-            QPalette pal = statusLabel->palette();
-            pal.setColor(backgroundRole(), QGC::colorOrange);
-            statusLabel->setPalette(pal);
-        }
-        else
-        {
-            QPalette pal = statusLabel->palette();
-            pal.setColor(backgroundRole(), QGC::colorGreen);
-            statusLabel->setPalette(pal);
-        }
-        QString val = QString("%1").arg(value.toFloat(), 5, 'f', 1, QChar(' '));
-        //statusLabel->setText(tr("OK: %1 %2 #%3/%4, %5 miss").arg(parameterName).arg(val).arg(paramId+1).arg(paramCount).arg(missCount));
-        if (missCount == 0)
-        {
-            // Transmission done
-            QTime time = QTime::currentTime();
-            QString timeString = time.toString();
-            statusLabel->setText(tr("All received. (updated at %1)").arg(timeString));
-        }
-        else
-        {
-            // Transmission in progress
-            statusLabel->setText(tr("OK: %1 %2 (%3/%4)").arg(parameterName).arg(val).arg(paramCount-missCount).arg(paramCount));
-        }
+        // The progress is shown together with the next tree update,
+        // updating the label for every single parameter is too slow
+        lastParameterName = parameterName;
+        lastParameterValue = value;
+        lastParameterCount = paramCount;
+        statusUpdatePending = true;
     }
 
     // Check if last parameter was received
@@ -477,11 +452,7 @@ void QGCParamWidget::addParameter(int uas, int component, int paramCount, int pa
     {
         this->transmissionActive = false;
         this->transmissionListMode = false;
-        transmissionListSizeKnown.clear();
-        foreach (int key, transmissionMissingPackets.keys())
-        {
-            transmissionMissingPackets.value(key)->clear();
-        }
+        transmissionMissingPackets.clear();
 
         // Expand visual tree
         tree->expandItem(tree->topLevelItem(0));
@@ -497,9 +468,6 @@ void QGCParamWidget::addParameter(int uas, int component, QString parameterName,
 {
     //QLOG_DEBUG() << "PARAM WIDGET GOT PARAM:" << value;
     Q_UNUSED(uas);
-    // Reference to item in tree
-    QTreeWidgetItem* parameterItem = NULL;
-
     // Get component
     if (!components->contains(component))
     {
@@ -521,122 +489,145 @@ void QGCParamWidget::addParameter(int uas, int component, QString parameterName,
     }
 
     // Replace value in map
-
-    // FIXME
-    if (parameters.value(component)->contains(parameterName)) parameters.value(component)->remove(parameterName);
     parameters.value(component)->insert(parameterName, value);
 
+    // The tree item is created or updated with the next view update,
+    // a newer value of the same parameter replaces the pending one
+    pendingItemUpdates[component].insert(parameterName, value);
+    if (!viewUpdateTimer.isActive())
+    {
+        viewUpdateTimer.start();
+    }
+
+    if (changedValues.contains(component)) changedValues.value(component)->remove(parameterName);
+}
 
-    QString splitToken = "_";
-    // Check if auto-grouping can work
-    if (parameterName.contains(splitToken))
+void QGCParamWidget::updateView()
+{
+    if (!pendingItemUpdates.isEmpty())
     {
-        QString parent = parameterName.section(splitToken, 0, 0, QString::SectionSkipEmpty);
-        QMap<QString, QTreeWidgetItem*>* compParamGroups = paramGroups.value(component);
-        if (!compParamGroups->contains(parent))
-        {
-            // Insert group item
-            QStringList glist;
-            glist.append(parent);
-            QTreeWidgetItem* item = new QTreeWidgetItem(glist);
-            compParamGroups->insert(parent, item);
-            components->value(component)->addChild(item);
-        }
+        // Draw the tree once for the whole batch. Signals are blocked, the
+        // items are changed by the MAV and not by the user.
+        tree->setUpdatesEnabled(false);
+        bool blocked = tree->blockSignals(true);
 
-        // Append child to group
-        bool found = false;
-        QTreeWidgetItem* parentItem = compParamGroups->value(parent);
-        for (int i = 0; i < parentItem->childCount(); i++) {
-            QTreeWidgetItem* child = parentItem->child(i);
-            QString key = child->data(0, Qt::DisplayRole).toString();
-            if (key == parameterName)
+        QMap<int, QMap<QString, QVariant> >::const_iterator i;
+        for (i = pendingItemUpdates.constBegin(); i != pendingItemUpdates.constEnd(); ++i)
+        {
+            // The component may have been removed by clear() in the meantime
+            if (!components->contains(i.key())) continue;
+            QMap<QString, QVariant>::const_iterator j;
+            for (j = i.value().constBegin(); j != i.value().constEnd(); ++j)
             {
-                //QLOG_DEBUG() << "UPDATED CHILD";
-                parameterItem = child;
-                if (value.type() == QVariant::Char)
-                {
-                    parameterItem->setData(1, Qt::DisplayRole, value.toUInt());
-                }
-                else
-                {
-                    parameterItem->setData(1, Qt::DisplayRole, value);
-                }
-                found = true;
+                updateParameterItem(i.key(), j.key(), j.value());
             }
         }
+        pendingItemUpdates.clear();
 
-        if (!found)
-        {
-            // Insert parameter into map
-            QStringList plist;
-            plist.append(parameterName);
-            // CREATE PARAMETER ITEM
-            parameterItem = new QTreeWidgetItem(plist);
-            // CONFIGURE PARAMETER ITEM
-            if (value.type() == QVariant::Char)
-            {
-                parameterItem->setData(1, Qt::DisplayRole, value.toUInt());
-            }
-            else
-            {
-                parameterItem->setData(1, Qt::DisplayRole, value);
-            }
+        tree->blockSignals(blocked);
+        tree->setUpdatesEnabled(true);
+    }
 
-            compParamGroups->value(parent)->addChild(parameterItem);
-            parameterItem->setFlags(parameterItem->flags() | Qt::ItemIsEditable);
-        }
+    if (statusUpdatePending)
+    {
+        updateDownloadStatus();
+    }
+}
+
+void QGCParamWidget::updateDownloadStatus()
+{
+    statusUpdatePending = false;
+
+    int missCount = transmissionMissingPackets.getMissingCount();
+
+    QPalette pal = statusLabel->palette();
+    pal.setColor(backgroundRole(), (missCount > 0) ? QGC::colorOrange : QGC::colorGreen);
+    statusLabel->setPalette(pal);
+
+    if (missCount == 0)
+    {
+        // Transmission done
+        QTime time = QTime::currentTime();
+        QString timeString = time.toString();
+        statusLabel->setText(tr("All received. (updated at %1)").arg(timeString));
     }
     else
     {
-        bool found = false;
-        QTreeWidgetItem* parent = components->value(component);
-        for (int i = 0; i < parent->childCount(); i++)
+        // Transmission in progress
+        QString val = QString("%1").arg(lastParameterValue.toFloat(), 5, 'f', 1, QChar(' '));
+        statusLabel->setText(tr("OK: %1 %2 (%3/%4)").arg(lastParameterName).arg(val).arg(lastParameterCount-missCount).arg(lastParameterCount));
+    }
+}
+
+/**
+ * @param component id of the component, has to be in the tree already
+ * @param parameterName human friendly name of the parameter
+ * @param value value as received from the MAV
+ */
+void QGCParamWidget::updateParameterItem(int component, const QString& parameterName, const QVariant& value)
+{
+    // Reference to item in tree
+    QTreeWidgetItem* parameterItem = paramItems.value(component).value(parameterName, NULL);
+
+    if (!parameterItem)
+    {
+        QTreeWidgetItem* parentItem = components->value(component);
+
+        QString splitToken = "_";
+        // Check if auto-grouping can work
+        if (parameterName.contains(splitToken))
         {
-            QTreeWidgetItem* child = parent->child(i);
-            QString key = child->data(0, Qt::DisplayRole).toString();
-            if (key == parameterName)
+            QString parent = parameterName.section(splitToken, 0, 0, QString::SectionSkipEmpty);
+            QMap<QString, QTreeWidgetItem*>* compParamGroups = paramGroups.value(component);
+            if (!compParamGroups->contains(parent))
             {
-                //QLOG_DEBUG() << "UPDATED CHILD";
-                parameterItem = child;
-                parameterItem->setData(1, Qt::DisplayRole, value);
-                found = true;
+                // Insert group item
+                QStringList glist;
+                glist.append(parent);
+                QTreeWidgetItem* item = new QTreeWidgetItem(glist);
+                compParamGroups->insert(parent, item);
+                components->value(component)->addChild(item);
             }
+            parentItem = compParamGroups->value(parent);
         }
 
-        if (!found)
+        // Insert parameter into map
+        QStringList plist;
+        plist.append(parameterName);
+        // CREATE PARAMETER ITEM
+        parameterItem = new QTreeWidgetItem(plist);
+        parentItem->addChild(parameterItem);
+        parameterItem->setFlags(parameterItem->flags() | Qt::ItemIsEditable);
+        paramItems[component].insert(parameterName, parameterItem);
+
+        // Add tooltip
+        QString tooltipFormat;
+        if (paramDefault.contains(parameterName))
+        {
+            tooltipFormat = tr("Default: %1, %2");
+            tooltipFormat = tooltipFormat.arg(paramDefault.value(parameterName, 0.0f)).arg(paramToolTips.value(parameterName, ""));
+        }
+        else
         {
-            // Insert parameter into map
-            QStringList plist;
-            plist.append(parameterName);
-            // CREATE PARAMETER ITEM
-            parameterItem = new QTreeWidgetItem(plist);
-            // CONFIGURE PARAMETER ITEM
-            parameterItem->setData(1, Qt::DisplayRole, value);
-
-            components->value(component)->addChild(parameterItem);
-            parameterItem->setFlags(parameterItem->flags() | Qt::ItemIsEditable);
+            tooltipFormat = paramToolTips.value(parameterName, "");
         }
-        //tree->expandAll();
+        parameterItem->setToolTip(0, tooltipFormat);
+        parameterItem->setToolTip(1, tooltipFormat);
     }
-    // Reset background color
-    parameterItem->setBackground(0, Qt::NoBrush);
-    parameterItem->setBackground(1, Qt::NoBrush);
-    // Add tooltip
-    QString tooltipFormat;
-    if (paramDefault.contains(parameterName))
+
+    // CONFIGURE PARAMETER ITEM
+    if (value.type() == QVariant::Char)
     {
-        tooltipFormat = tr("Default: %1, %2");
-        tooltipFormat = tooltipFormat.arg(paramDefault.value(parameterName, 0.0f)).arg(paramToolTips.value(parameterName, ""));
+        parameterItem->setData(1, Qt::DisplayRole, value.toUInt());
     }
     else
     {
-        tooltipFormat = paramToolTips.value(parameterName, "");
+        parameterItem->setData(1, Qt::DisplayRole, value);
     }
-    parameterItem->setToolTip(0, tooltipFormat);
-    parameterItem->setToolTip(1, tooltipFormat);
 
-    //tree->update();
-    if (changedValues.contains(component)) changedValues.value(component)->remove(parameterName);
+    // Reset background color
+    parameterItem->setBackground(0, Qt::NoBrush);
+    parameterItem->setBackground(1, Qt::NoBrush);
 }
 
 /**
@@ -659,11 +650,7 @@ void QGCParamWidget::requestParameterList()
     received.clear();
     // Clear transmission state
     transmissionListMode = true;
-    transmissionListSizeKnown.clear();
-    foreach (int key, transmissionMissingPackets.keys())
-    {
-        transmissionMissingPackets.value(key)->clear();
-    }
+    transmissionMissingPackets.clear();
     transmissionActive = true;
 
     // Set status text
@@ -903,12 +890,8 @@ void QGCParamWidget::retransmissionGuardTick()
 
             // Empty read retransmission list
             // Empty write retransmission list
-            int missingReadCount = 0;
-            QList<int> readKeys = transmissionMissingPackets.keys();
-            foreach (int component, readKeys) {
-                missingReadCount += transmissionMissingPackets.value(component)->count();
-                transmissionMissingPackets.value(component)->clear();
-            }
+            int missingReadCount = transmissionMissingPackets.getMissingCount();
+            transmissionMissingPackets.clear();
 
             // Empty write retransmission list
             int missingWriteCount = 0;
@@ -921,25 +904,15 @@ void QGCParamWidget::retransmissionGuardTick()
         }
 
         // Re-request at maximum retransmissionBurstRequestSize parameters at once
-        // to prevent link flooding
-        QMap<int, QMap<QString, QVariant>*>::iterator i;
-        for (i = parameters.begin(); i != parameters.end(); ++i) {
-            // Iterate through the parameters of the component
-            int component = i.key();
-            // Request n parameters from this component (at maximum)
-            QList<int> * paramList = transmissionMissingPackets.value(component, NULL);
-            if (paramList) {
-                int count = 0;
-                foreach (int id, *paramList) {
-                    if (count < retransmissionBurstRequestSize) {
-                        //QLOG_DEBUG() << __FILE__ << __LINE__ << "RETRANSMISSION GUARD REQUESTS RETRANSMISSION OF PARAM #" << id << "FROM COMPONENT #" << component;
-                        emit requestParameter(component, id);
-                        statusLabel->setText(tr("Requested retransmission of #%1").arg(id+1));
-                        count++;
-                    } else {
-                        break;
-                    }
-                }
+        // to prevent link flooding. Only indices from the missing ranges are
+        // requested, lowest first.
+        QList<QPair<int, int> > requests = transmissionMissingPackets.getRetransmissionRequests(retransmissionBurstRequestSize);
+        for (int i = 0; i < requests.size(); ++i) {
+            int component = requests.at(i).first;
+            //QLOG_DEBUG() << __FILE__ << __LINE__ << "RETRANSMISSION GUARD REQUESTS RETRANSMISSION OF PARAM #" << requests.at(i).second << "FROM COMPONENT #" << component;
+            emit requestParameter(component, requests.at(i).second);
+            if (i + 1 == requests.size() || requests.at(i + 1).first != component) {
+                statusLabel->setText(tr("Requested retransmission of %1 missing in %2 gaps").arg(transmissionMissingPackets.getMissingCount(component)).arg(transmissionMissingPackets.getMissingRanges(component).size()));
             }
         }
 
@@ -1178,6 +1151,15 @@ void QGCParamWidget::readParameters()
  */
 void QGCParamWidget::clear()
 {
+    viewUpdateTimer.stop();
+    pendingItemUpdates.clear();
+    statusUpdatePending = false;
     tree->clear();
     components->clear();
+    paramItems.clear();
+    foreach (QMap<QString, QTreeWidgetItem*>* groups, paramGroups)
+    {
+        delete groups;
+    }
+    paramGroups.clear();
 }
@@ -34,6 +34,7 @@ This file is part of the QGROUNDCONTROL project
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QMap>
+#include <QHash>
 #include <QLabel>
 #include <QTimer>
 
@@ -98,12 +99,21 @@ public slots:
 
     /** @brief Check for missing parameters */
     void retransmissionGuardTick();
+    /** @brief Apply all parameter updates received since the last view update */
+    void updateView();
 
 protected:
     QTreeWidget* tree;   ///< The parameter tree
     QLabel* statusLabel; ///< Parameter transmission label
     QMap<int, QTreeWidgetItem*>* components; ///< The list of components
     QMap<int, QMap<QString, QTreeWidgetItem*>* > paramGroups; ///< Parameter groups
+    QMap<int, QHash<QString, QTreeWidgetItem*> > paramItems; ///< Parameter items by name
+    QMap<int, QMap<QString, QVariant> > pendingItemUpdates; ///< Values not yet shown in the tree
+    QTimer viewUpdateTimer;        ///< Coalesces tree updates to one per frame
+    bool statusUpdatePending;      ///< Download progress not yet shown in the status label
+    QString lastParameterName;     ///< Last parameter received in list mode
+    QVariant lastParameterValue;   ///< Value of the last parameter received in list mode
+    int lastParameterCount;        ///< List size announced with the last parameter
 
     // Tooltip data structures
     QMap<QString, QString> paramToolTips; ///< Tooltip values
@@ -112,6 +122,10 @@ protected:
     QMap<QString, double> paramDefault; ///< Default param values
     QMap<QString, double> paramMax; ///< Minimum param values
 
+    /** @brief Create or update the tree item of one parameter */
+    void updateParameterItem(int component, const QString& parameterName, const QVariant& value);
+    /** @brief Show the download progress in the status label */
+    void updateDownloadStatus();
     /** @brief Activate / deactivate parameter retransmission */
     void setRetransmissionGuardEnabled(bool enabled);
     /** @brief Load  settings */
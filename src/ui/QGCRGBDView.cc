@@ -9,7 +9,8 @@
 QGCRGBDView::QGCRGBDView(int width, int height, QWidget *parent) :
     HUD(width, height, parent),
     rgbEnabled(false),
-    depthEnabled(false)
+    depthEnabled(false),
+    depthColormap(10.0f, true, RGBD::DepthColormap::BGR)
 {
     enableRGBAction = new QAction(tr("Enable RGB Image"), this);
     enableRGBAction->setStatusTip(tr("Show the RGB image live stream in this window"));
@@ -115,137 +116,6 @@ void QGCRGBDView::enableDepth(bool enabled)
     QWidget::resize(size().width(), size().height());
 }
 
-float colormapJet[128][3] = {
-    {0.0f,0.0f,0.53125f},
-    {0.0f,0.0f,0.5625f},
-    {0.0f,0.0f,0.59375f},
-    {0.0f,0.0f,0.625f},
-    {0.0f,0.0f,0.65625f},
-    {0.0f,0.0f,0.6875f},
-    {0.0f,0.0f,0.71875f},
-    {0.0f,0.0f,0.75f},
-    {0.0f,0.0f,0.78125f},
-    {0.0f,0.0f,0.8125f},
-    {0.0f,0.0f,0.84375f},
-    {0.0f,0.0f,0.875f},
-    {0.0f,0.0f,0.90625f},
-    {0.0f,0.0f,0.9375f},
-    {0.0f,0.0f,0.96875f},
-    {0.0f,0.0f,1.0f},
-    {0.0f,0.03125f,1.0f},
-    {0.0f,0.0625f,1.0f},
-    {0.0f,0.09375f,1.0f},
-    {0.0f,0.125f,1.0f},
-    {0.0f,0.15625f,1.0f},
-    {0.0f,0.1875f,1.0f},
-    {0.0f,0.21875f,1.0f},
-    {0.0f,0.25f,1.0f},
-    {0.0f,0.28125f,1.0f},
-    {0.0f,0.3125f,1.0f},
-    {0.0f,0.34375f,1.0f},
-    {0.0f,0.375f,1.0f},
-    {0.0f,0.40625f,1.0f},
-    {0.0f,0.4375f,1.0f},
-    {0.0f,0.46875f,1.0f},
-    {0.0f,0.5f,1.0f},
-    {0.0f,0.53125f,1.0f},
-    {0.0f,0.5625f,1.0f},
-    {0.0f,0.59375f,1.0f},
-    {0.0f,0.625f,1.0f},
-    {0.0f,0.65625f,1.0f},
-    {0.0f,0.6875f,1.0f},
-    {0.0f,0.71875f,1.0f},
-    {0.0f,0.75f,1.0f},
-    {0.0f,0.78125f,1.0f},
-    {0.0f,0.8125f,1.0f},
-    {0.0f,0.84375f,1.0f},
-    {0.0f,0.875f,1.0f},
-    {0.0f,0.90625f,1.0f},
-    {0.0f,0.9375f,1.0f},
-    {0.0f,0.96875f,1.0f},
-    {0.0f,1.0f,1.0f},
-    {0.03125f,1.0f,0.96875f},
-    {0.0625f,1.0f,0.9375f},
-    {0.09375f,1.0f,0.90625f},
-    {0.125f,1.0f,0.875f},
-    {0.15625f,1.0f,0.84375f},
-    {0.1875f,1.0f,0.8125f},
-    {0.21875f,1.0f,0.78125f},
-    {0.25f,1.0f,0.75f},
-    {0.28125f,1.0f,0.71875f},
-    {0.3125f,1.0f,0.6875f},
-    {0.34375f,1.0f,0.65625f},
-    {0.375f,1.0f,0.625f},
-    {0.40625f,1.0f,0.59375f},
-    {0.4375f,1.0f,0.5625f},
-    {0.46875f,1.0f,0.53125f},
-    {0.5f,1.0f,0.5f},
-    {0.53125f,1.0f,0.46875f},
-    {0.5625f,1.0f,0.4375f},
-    {0.59375f,1.0f,0.40625f},
-    {0.625f,1.0f,0.375f},
-    {0.65625f,1.0f,0.34375f},
-    {0.6875f,1.0f,0.3125f},
-    {0.71875f,1.0f,0.28125f},
-    {0.75f,1.0f,0.25f},
-    {0.78125f,1.0f,0.21875f},
-    {0.8125f,1.0f,0.1875f},
-    {0.84375f,1.0f,0.15625f},
-    {0.875f,1.0f,0.125f},
-    {0.90625f,1.0f,0.09375f},
-    {0.9375f,1.0f,0.0625f},
-    {0.96875f,1.0f,0.03125f},
-    {1.0f,1.0f,0.0f},
-    {1.0f,0.96875f,0.0f},
-    {1.0f,0.9375f,0.0f},
-    {1.0f,0.90625f,0.0f},
-    {1.0f,0.875f,0.0f},
-    {1.0f,0.84375f,0.0f},
-    {1.0f,0.8125f,0.0f},
-    {1.0f,0.78125f,0.0f},
-    {1.0f,0.75f,0.0f},
-    {1.0f,0.71875f,0.0f},
-    {1.0f,0.6875f,0.0f},
-    {1.0f,0.65625f,0.0f},
-    {1.0f,0.625f,0.0f},
-    {1.0f,0.59375f,0.0f},
-    {1.0f,0.5625f,0.0f},
-    {1.0f,0.53125f,0.0f},
-    {1.0f,0.5f,0.0f},
-    {1.0f,0.46875f,0.0f},
-    {1.0f,0.4375f,0.0f},
-    {1.0f,0.40625f,0.0f},
-    {1.0f,0.375f,0.0f},
-    {1.0f,0.34375f,0.0f},
-    {1.0f,0.3125f,0.0f},
-    {1.0f,0.28125f,0.0f},
-    {1.0f,0.25f,0.0f},
-    {1.0f,0.21875f,0.0f},
-    {1.0f,0.1875f,0.0f},
-    {1.0f,0.15625f,0.0f},
-    {1.0f,0.125f,0.0f},
-    {1.0f,0.09375f,0.0f},
-    {1.0f,0.0625f,0.0f},
-    {1.0f,0.03125f,0.0f},
-    {1.0f,0.0f,0.0f},
-    {0.96875f,0.0f,0.0f},
-    {0.9375f,0.0f,0.0f},
-    {0.90625f,0.0f,0.0f},
-    {0.875f,0.0f,0.0f},
-    {0.84375f,0.0f,0.0f},
-    {0.8125f,0.0f,0.0f},
-    {0.78125f,0.0f,0.0f},
-    {0.75f,0.0f,0.0f},
-    {0.71875f,0.0f,0.0f},
-    {0.6875f,0.0f,0.0f},
-    {0.65625f,0.0f,0.0f},
-    {0.625f,0.0f,0.0f},
-    {0.59375f,0.0f,0.0f},
-    {0.5625f,0.0f,0.0f},
-    {0.53125f,0.0f,0.0f},
-    {0.5f,0.0f,0.0f}
-};
-
 void QGCRGBDView::updateData(UASInterface *uas)
 {
 #if defined(QGC_PROTOBUF_ENABLED) && defined(QGC_USE_PIXHAWK_MESSAGES)
@@ -290,27 +160,10 @@ void QGCRGBDView::updateData(UASInterface *uas)
 
     if (depthEnabled)
     {
-        QByteArray coloredDepth(rgbdImage.cols() * rgbdImage.rows() * 3, 0);
-
-        for (uint32_t r = 0; r < rgbdImage.rows(); ++r)
-        {
-            const float* depth = reinterpret_cast<const float*>(rgbdImage.imagedata2().c_str() + r * rgbdImage.step2());
-            uint8_t* pixel = reinterpret_cast<uint8_t*>(coloredDepth.data()) + r * rgbdImage.cols() * 3;
-            for (uint32_t c = 0; c < rgbdImage.cols(); ++c)
-            {
-                if (depth[c] != 0)
-                {
-                    int idx = fminf(depth[c], 10.0f) / 10.0f * 127.0f;
-                    idx = 127 - idx;
-
-                    pixel[0] = colormapJet[idx][2] * 255.0f;
-                    pixel[1] = colormapJet[idx][1] * 255.0f;
-                    pixel[2] = colormapJet[idx][0] * 255.0f;
-                }
-
-                pixel += 3;
-            }
-        }
+        coloredDepth.resize(rgbdImage.cols() * rgbdImage.rows() * 3);
+        depthColormap.colorize(reinterpret_cast<const float*>(rgbdImage.imagedata2().c_str()),
+                               rgbdImage.cols(), rgbdImage.rows(), rgbdImage.step2(),
+                               reinterpret_cast<uchar*>(coloredDepth.data()), rgbdImage.cols() * 3);
 
         fill = QImage(reinterpret_cast<const uchar*>(coloredDepth.constData()),
                       rgbdImage.cols(), rgbdImage.rows(), QImage::Format_RGB888);
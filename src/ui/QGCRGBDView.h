@@ -2,6 +2,7 @@
 #define QGCRGBDVIEW_H
 
 #include "HUD.h"
+#include "RGBDKernels.h"
 
 class QGCRGBDView : public HUD
 {
@@ -25,6 +26,9 @@ protected:
     bool depthEnabled;
     QAction* enableRGBAction;
     QAction* enableDepthAction;
+    RGBD::DepthColormap depthColormap;
+    /** @brief Colored depth image, kept from frame to frame */
+    QByteArray coloredDepth;
 
     void contextMenuEvent (QContextMenuEvent* event);
     /** @brief Store current configuration of widget */
@@ -0,0 +1,262 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Bounded byte ring buffer with a line index for terminal views
+ */
+
+#include "QGCTerminalBuffer.h"
+
+#include <string.h>
+
+QGCTerminalBuffer::QGCTerminalBuffer(int capacity) :
+    data(qMax((int)MIN_CAPACITY, capacity), 0)
+{
+    clear();
+}
+
+void QGCTerminalBuffer::setCapacity(int capacity)
+{
+    data = QByteArray(qMax((int)MIN_CAPACITY, capacity), 0);
+    clear();
+}
+
+void QGCTerminalBuffer::clear()
+{
+    written = 0;
+    lineStarts.clear();
+    lineStarts.append(0);
+    lineHead = 0;
+    firstLine = 0;
+    lineColors.clear();
+}
+
+void QGCTerminalBuffer::append(const char* bytes, int length)
+{
+    if (length <= 0) return;
+
+    const int capacity = data.size();
+    if (length > capacity)
+    {
+        // Only the end of the block is kept, it starts a new line
+        int skip = length - capacity;
+        bytes += skip;
+        length = capacity;
+        written += skip;
+        if (lineStarts.last() != written) lineStarts.append(written);
+    }
+
+    // Copy into the ring, wrapping at most once
+    int pos = written % capacity;
+    int first = qMin(length, capacity - pos);
+    memcpy(data.data() + pos, bytes, first);
+    if (first < length)
+    {
+        memcpy(data.data(), bytes + first, length - first);
+    }
+
+    // Index the line starts
+    quint64 lineStart = lineStarts.last();
+    const char* p = bytes;
+    const char* end = bytes + length;
+    while (p < end)
+    {
+        const char* lf = static_cast<const char*>(memchr(p, '\n', end - p));
+        quint64 contentEnd = written + ((lf ? lf : end) - bytes);
+        while (contentEnd - lineStart > MAX_LINE_LENGTH)
+        {
+            lineStart += MAX_LINE_LENGTH;
+            lineStarts.append(lineStart);
+        }
+        if (!lf) break;
+        lineStart = contentEnd + 1;
+        lineStarts.append(lineStart);
+        p = lf + 1;
+    }
+
+    written += length;
+    dropLines();
+}
+
+void QGCTerminalBuffer::appendMessage(const QString& text, const QColor& color)
+{
+    if (lineStarts.last() != written)
+    {
+        // Finish the partial line of received data
+        append("\n", 1);
+    }
+    quint64 line = firstLine + (lineStarts.size() - 1 - lineHead);
+
+    QByteArray bytes = text.toUtf8();
+    bytes.replace('\n', ' ');
+    bytes.append('\n');
+    append(bytes);
+
+    if (color.isValid())
+    {
+        quint64 next = firstLine + (lineStarts.size() - 1 - lineHead);
+        for (quint64 i = qMax(line, firstLine); i < next; ++i)
+        {
+            lineColors.insert(i, color);
+        }
+    }
+}
+
+quint64 QGCTerminalBuffer::getFirstOffset() const
+{
+    const quint64 capacity = data.size();
+    return written > capacity ? written - capacity : 0;
+}
+
+QByteArray QGCTerminalBuffer::read(quint64 offset, int length) const
+{
+    quint64 start = qMax(offset, getFirstOffset());
+    quint64 stop = qMin(offset + length, written);
+    if (stop <= start) return QByteArray();
+
+    const int capacity = data.size();
+    int size = stop - start;
+    int pos = start % capacity;
+    int first = qMin(size, capacity - pos);
+    QByteArray bytes(data.constData() + pos, first);
+    if (first < size)
+    {
+        bytes.append(data.constData(), size - first);
+    }
+    return bytes;
+}
+
+int QGCTerminalBuffer::getLineCount() const
+{
+    int count = lineStarts.size() - lineHead;
+    if (lineStarts.last() == written) count--;
+    return count;
+}
+
+QByteArray QGCTerminalBuffer::getLineBytes(quint64 line) const
+{
+    if (line < firstLine || line >= firstLine + getLineCount()) return QByteArray();
+    int index = lineHead + (line - firstLine);
+    quint64 start = lineStarts.at(index);
+    quint64 stop = (index + 1 < lineStarts.size()) ? lineStarts.at(index + 1) : written;
+    return read(start, stop - start);
+}
+
+QString QGCTerminalBuffer::getLine(quint64 line) const
+{
+    return toPrintable(getLineBytes(line));
+}
+
+int QGCTerminalBuffer::getHexRowCount() const
+{
+    if (written == 0) return 0;
+    return (written - 1) / HEX_ROW_LENGTH - getFirstHexRow() + 1;
+}
+
+QString QGCTerminalBuffer::getHexRow(quint64 row) const
+{
+    quint64 offset = row * HEX_ROW_LENGTH;
+    quint64 start = qMax(offset, getFirstOffset());
+    QByteArray bytes = read(start, offset + HEX_ROW_LENGTH - start);
+    int skip = start - offset;
+
+    QString text = QString("%1 ").arg(offset, 8, 16, QLatin1Char('0'));
+    QString ascii;
+    for (int i = 0; i < HEX_ROW_LENGTH; ++i)
+    {
+        if (i == HEX_ROW_LENGTH / 2) text.append(' ');
+        int index = i - skip;
+        if (index < 0 || index >= bytes.size())
+        {
+            text.append("   ");
+            ascii.append(' ');
+            continue;
+        }
+        unsigned char byte = bytes.at(index);
+        text.append(QString(" %1").arg(byte, 2, 16, QLatin1Char('0')));
+        ascii.append((byte >= 32 && byte <= 126) ? QChar(byte) : QChar('.'));
+    }
+    return text + "  |" + ascii + "|";
+}
+
+QString QGCTerminalBuffer::toPrintable(const QByteArray& bytes)
+{
+    QString text;
+    text.reserve(bytes.size());
+    const int length = bytes.size();
+    for (int i = 0; i < length; ++i)
+    {
+        unsigned char byte = bytes.at(i);
+        if (byte >= 32 && byte <= 126)
+        {
+            text.append(QChar(byte));
+        }
+        else if (byte == '\n' || byte == '\r')
+        {
+            // Line ends are implied by the line
+        }
+        else if (byte == '\t')
+        {
+            text.append(QString(8 - text.length() % 8, ' '));
+        }
+        else if (byte == 0x1b)
+        {
+            // Skip VT100 escape sequences: ESC [ parameters final byte, or ESC and one byte
+            if (i + 1 < length && bytes.at(i + 1) == '[')
+            {
+                i += 2;
+                while (i < length && (bytes.at(i) < 0x40 || bytes.at(i) > 0x7e)) i++;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        else
+        {
+            text.append(QString(" 0x%1 ").arg(byte, 2, 16, QLatin1Char('0')));
+        }
+    }
+    return text;
+}
+
+void QGCTerminalBuffer::dropLines()
+{
+    quint64 oldest = getFirstOffset();
+    const int last = lineStarts.size() - 1;
+    while (lineHead < last && lineStarts.at(lineHead) < oldest)
+    {
+        lineHead++;
+        firstLine++;
+    }
+    while (!lineColors.isEmpty() && lineColors.begin().key() < firstLine)
+    {
+        lineColors.erase(lineColors.begin());
+    }
+    // Compact the index once most of it is dropped lines
+    if (lineHead > 1024 && lineHead * 2 > lineStarts.size())
+    {
+        lineStarts.remove(0, lineHead);
+        lineHead = 0;
+    }
+}
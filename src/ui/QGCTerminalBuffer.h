@@ -0,0 +1,110 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Bounded byte ring buffer with a line index for terminal views
+ */
+
+#ifndef QGCTERMINALBUFFER_H
+#define QGCTERMINALBUFFER_H
+
+#include <QByteArray>
+#include <QColor>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * Keeps the last received bytes of a stream in a fixed size ring. Appending
+ * only copies the bytes and records where lines start, the text of a line
+ * (ASCII) or of a row of 16 bytes (HEX) is only formatted when it is asked
+ * for, so a view formats the lines it shows and nothing else.
+ *
+ * Lines are numbered from the first byte ever appended. Lines longer than
+ * MAX_LINE_LENGTH are broken, so a binary stream without line feeds still
+ * has a bounded cost per line.
+ */
+class QGCTerminalBuffer
+{
+public:
+    enum {
+        DEFAULT_CAPACITY = 1024 * 1024,
+        MIN_CAPACITY = 4096,
+        MAX_LINE_LENGTH = 256,
+        HEX_ROW_LENGTH = 16
+    };
+
+    QGCTerminalBuffer(int capacity = DEFAULT_CAPACITY);
+
+    /** @brief Set the number of bytes kept, clears the buffer */
+    void setCapacity(int capacity);
+    int getCapacity() const { return data.size(); }
+    void clear();
+
+    /** @brief Append received bytes, the oldest bytes are dropped once the buffer is full */
+    void append(const char* bytes, int length);
+    void append(const QByteArray& bytes) { append(bytes.constData(), bytes.size()); }
+    /** @brief Append a message on a line of its own, shown in the given color */
+    void appendMessage(const QString& text, const QColor& color);
+
+    /** @brief Number of bytes appended since the last clear */
+    quint64 getBytesWritten() const { return written; }
+    /** @brief Stream offset of the oldest byte kept */
+    quint64 getFirstOffset() const;
+    /** @brief Copy bytes out of the ring, offsets are stream offsets */
+    QByteArray read(quint64 offset, int length) const;
+
+    /** @brief Number of the oldest line kept */
+    quint64 getFirstLine() const { return firstLine; }
+    /** @brief Number of lines kept, an empty line after the last line feed is not counted */
+    int getLineCount() const;
+    /** @brief Bytes of a line including its line feed */
+    QByteArray getLineBytes(quint64 line) const;
+    /** @brief Printable text of a line, control characters as 0xNN, escape sequences removed */
+    QString getLine(quint64 line) const;
+    /** @brief Color of a message line, invalid for received data */
+    QColor getLineColor(quint64 line) const { return lineColors.value(line); }
+
+    /** @brief Number of the oldest HEX row kept */
+    quint64 getFirstHexRow() const { return getFirstOffset() / HEX_ROW_LENGTH; }
+    /** @brief Number of HEX rows kept */
+    int getHexRowCount() const;
+    /** @brief Offset, HEX bytes and ASCII column of a row of 16 bytes */
+    QString getHexRow(quint64 row) const;
+
+    /** @brief Printable text of bytes, as shown in lines */
+    static QString toPrintable(const QByteArray& bytes);
+
+protected:
+    /** @brief Forget the lines whose start was overwritten */
+    void dropLines();
+
+    QByteArray data;            ///< The ring
+    quint64 written;            ///< Stream offset of the next byte
+    QVector<quint64> lineStarts;///< Stream offsets of the line starts, from lineHead on
+    int lineHead;               ///< Index of the oldest line kept in lineStarts
+    quint64 firstLine;          ///< Number of the line at lineHead
+    QMap<quint64, QColor> lineColors;
+};
+
+#endif // QGCTERMINALBUFFER_H
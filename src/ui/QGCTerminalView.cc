@@ -0,0 +1,313 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Terminal view painting the visible lines of a byte ring buffer
+ */
+
+#include "QGCTerminalView.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QStringList>
+
+QGCTerminalView::QGCTerminalView(QWidget* parent) :
+    QAbstractScrollArea(parent),
+    hexMode(false),
+    modified(false),
+    followTail(true),
+    topRow(0),
+    selectionStart(-1),
+    selectionEnd(-1),
+    rowHeight(1),
+    ascent(0),
+    charWidth(1)
+{
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    setFont(font);
+    updateMetrics();
+
+    setFocusPolicy(Qt::StrongFocus);
+    viewport()->setCursor(Qt::IBeamCursor);
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(scrolled(int)));
+    connect(horizontalScrollBar(), SIGNAL(valueChanged(int)), viewport(), SLOT(update()));
+
+    // Appended data is shown at most every REFRESH_INTERVAL ms
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(REFRESH_INTERVAL);
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+}
+
+void QGCTerminalView::setCapacity(int bytes)
+{
+    buffer.setCapacity(bytes);
+    clear();
+}
+
+int QGCTerminalView::getRowCount() const
+{
+    return hexMode ? buffer.getHexRowCount() : buffer.getLineCount();
+}
+
+quint64 QGCTerminalView::getFirstRow() const
+{
+    return hexMode ? buffer.getFirstHexRow() : buffer.getFirstLine();
+}
+
+QString QGCTerminalView::getRowText(quint64 row, QColor* color) const
+{
+    if (hexMode)
+    {
+        if (color) *color = QColor();
+        return buffer.getHexRow(row);
+    }
+    if (color) *color = buffer.getLineColor(row);
+    return buffer.getLine(row);
+}
+
+QString QGCTerminalView::getSelectedText() const
+{
+    if (selectionStart < 0 || getRowCount() == 0) return QString();
+    quint64 first = qMax((quint64)qMax(Q_INT64_C(0), qMin(selectionStart, selectionEnd)), getFirstRow());
+    quint64 last = qMin((quint64)qMax(selectionStart, selectionEnd), getFirstRow() + getRowCount() - 1);
+    QStringList lines;
+    for (quint64 row = first; row <= last; ++row)
+    {
+        lines.append(getRowText(row));
+    }
+    return lines.join("\n");
+}
+
+void QGCTerminalView::appendData(const QByteArray& data)
+{
+    buffer.append(data);
+    modified = true;
+    if (!refreshTimer.isActive()) refreshTimer.start();
+}
+
+void QGCTerminalView::appendMessage(const QString& text, const QColor& color)
+{
+    buffer.appendMessage(text, color);
+    modified = true;
+    if (!refreshTimer.isActive()) refreshTimer.start();
+}
+
+void QGCTerminalView::setHexMode(bool hex)
+{
+    if (hexMode == hex) return;
+    hexMode = hex;
+    selectionStart = -1;
+    followTail = true;
+    updateScrollBar();
+    viewport()->update();
+}
+
+void QGCTerminalView::clear()
+{
+    buffer.clear();
+    selectionStart = -1;
+    topRow = 0;
+    followTail = true;
+    updateScrollBar();
+    viewport()->update();
+}
+
+void QGCTerminalView::copy()
+{
+    QString text = getSelectedText();
+    if (!text.isEmpty())
+    {
+        QApplication::clipboard()->setText(text);
+    }
+}
+
+void QGCTerminalView::scrollToBottom()
+{
+    followTail = true;
+    updateScrollBar();
+    viewport()->update();
+}
+
+void QGCTerminalView::refresh()
+{
+    if (!modified) return;
+    modified = false;
+    updateScrollBar();
+    viewport()->update();
+}
+
+void QGCTerminalView::scrolled(int value)
+{
+    topRow = getFirstRow() + value;
+    followTail = (value == verticalScrollBar()->maximum());
+    viewport()->update();
+}
+
+int QGCTerminalView::getVisibleRows() const
+{
+    return qMax(1, viewport()->height() / rowHeight);
+}
+
+quint64 QGCTerminalView::rowAt(const QPoint& pos) const
+{
+    return topRow + qMax(0, pos.y()) / rowHeight;
+}
+
+void QGCTerminalView::updateMetrics()
+{
+    QFontMetrics metrics(font());
+    rowHeight = qMax(1, metrics.lineSpacing());
+    ascent = metrics.ascent();
+    charWidth = qMax(1, metrics.width(QLatin1Char('0')));
+}
+
+void QGCTerminalView::updateScrollBar()
+{
+    const quint64 first = getFirstRow();
+    const int visible = getVisibleRows();
+    const int maximum = qMax(0, getRowCount() - visible);
+
+    if (followTail || topRow > first + maximum)
+    {
+        topRow = first + maximum;
+    }
+    else if (topRow < first)
+    {
+        // The rows in view were dropped from the buffer
+        topRow = first;
+    }
+
+    QScrollBar* bar = verticalScrollBar();
+    bar->blockSignals(true);
+    bar->setRange(0, maximum);
+    bar->setPageStep(visible);
+    bar->setValue(topRow - first);
+    bar->blockSignals(false);
+
+    // Wide enough for a full line or HEX row
+    const int columns = hexMode ? 80 : QGCTerminalBuffer::MAX_LINE_LENGTH;
+    horizontalScrollBar()->setRange(0, qMax(0, columns * charWidth - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(charWidth);
+}
+
+void QGCTerminalView::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().base());
+
+    const quint64 end = getFirstRow() + getRowCount();
+    const int width = viewport()->width();
+    const int height = viewport()->height();
+    const int left = 2 - horizontalScrollBar()->value();
+    const qint64 selectedFirst = qMin(selectionStart, selectionEnd);
+    const qint64 selectedLast = qMax(selectionStart, selectionEnd);
+
+    // Only the rows in the viewport are formatted
+    int y = 0;
+    for (quint64 row = topRow; row < end && y < height; ++row, y += rowHeight)
+    {
+        QRect rect(0, y, width, rowHeight);
+        if (!event->rect().intersects(rect)) continue;
+
+        QColor color;
+        QString text = getRowText(row, &color);
+        if (selectionStart >= 0 && (qint64)row >= selectedFirst && (qint64)row <= selectedLast)
+        {
+            painter.fillRect(rect, palette().highlight());
+            color = palette().color(QPalette::HighlightedText);
+        }
+        else if (!color.isValid())
+        {
+            color = palette().color(QPalette::Text);
+        }
+        drawRow(painter, QRect(left, y, width - left, rowHeight), text, color);
+    }
+}
+
+void QGCTerminalView::drawRow(QPainter& painter, const QRect& rect, const QString& text, const QColor& color)
+{
+    painter.setPen(color);
+    painter.drawText(rect.left(), rect.top() + ascent, text);
+}
+
+void QGCTerminalView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+}
+
+void QGCTerminalView::mousePressEvent(QMouseEvent* event)
+{
+    setFocus();
+    if (event->button() == Qt::LeftButton)
+    {
+        selectionStart = rowAt(event->pos());
+        selectionEnd = selectionStart;
+        viewport()->update();
+    }
+}
+
+void QGCTerminalView::mouseMoveEvent(QMouseEvent* event)
+{
+    if ((event->buttons() & Qt::LeftButton) && selectionStart >= 0)
+    {
+        selectionEnd = rowAt(event->pos());
+        viewport()->update();
+    }
+}
+
+void QGCTerminalView::keyPressEvent(QKeyEvent* event)
+{
+    if (event->matches(QKeySequence::Copy))
+    {
+        copy();
+    }
+    else if (event->matches(QKeySequence::SelectAll))
+    {
+        selectionStart = getFirstRow();
+        selectionEnd = getFirstRow() + getRowCount() - 1;
+        viewport()->update();
+    }
+    else
+    {
+        QAbstractScrollArea::keyPressEvent(event);
+    }
+}
+
+void QGCTerminalView::changeEvent(QEvent* event)
+{
+    QAbstractScrollArea::changeEvent(event);
+    if (event->type() == QEvent::FontChange)
+    {
+        updateMetrics();
+        updateScrollBar();
+        viewport()->update();
+    }
+}
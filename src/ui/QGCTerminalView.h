@@ -0,0 +1,116 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Terminal view painting the visible lines of a byte ring buffer
+ */
+
+#ifndef QGCTERMINALVIEW_H
+#define QGCTERMINALVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QTimer>
+
+#include "QGCTerminalBuffer.h"
+
+/**
+ * Shows the bytes of a QGCTerminalBuffer as text lines or as HEX rows.
+ * Received data is only copied into the buffer, the view is repainted at
+ * most REFRESH_INTERVAL ms apart and only the rows in the viewport are
+ * formatted and drawn, so the cost of a repaint does not depend on the
+ * amount of data kept or received.
+ *
+ * Whole rows can be selected with the mouse and copied with Ctrl+C. The
+ * view follows new data as long as it is scrolled to the end.
+ */
+class QGCTerminalView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    enum {
+        REFRESH_INTERVAL = 40
+    };
+
+    explicit QGCTerminalView(QWidget* parent = 0);
+
+    QGCTerminalBuffer* getBuffer() { return &buffer; }
+    /** @brief Set the number of bytes kept, clears the view */
+    void setCapacity(int bytes);
+
+    bool isHexMode() const { return hexMode; }
+    /** @brief Number of lines, or HEX rows, the view holds */
+    int getRowCount() const;
+    /** @brief Text of the selected rows, one per line */
+    QString getSelectedText() const;
+
+public slots:
+    /** @brief Append received bytes */
+    void appendData(const QByteArray& data);
+    /** @brief Append a message on a line of its own */
+    void appendMessage(const QString& text, const QColor& color = QColor());
+    /** @brief Show the data as HEX rows instead of text lines */
+    void setHexMode(bool hex);
+    void clear();
+    /** @brief Copy the selected rows to the clipboard */
+    void copy();
+    void scrollToBottom();
+
+protected slots:
+    /** @brief Update the scroll range and repaint if data was appended */
+    void refresh();
+    void scrolled(int value);
+
+protected:
+    void paintEvent(QPaintEvent* event);
+    void resizeEvent(QResizeEvent* event);
+    void mousePressEvent(QMouseEvent* event);
+    void mouseMoveEvent(QMouseEvent* event);
+    void keyPressEvent(QKeyEvent* event);
+    void changeEvent(QEvent* event);
+
+    /** @brief Draw one row, override to highlight parts of it */
+    virtual void drawRow(QPainter& painter, const QRect& rect, const QString& text, const QColor& color);
+
+    quint64 getFirstRow() const;
+    QString getRowText(quint64 row, QColor* color = 0) const;
+    int getVisibleRows() const;
+    /** @brief Row at a viewport position */
+    quint64 rowAt(const QPoint& pos) const;
+    void updateMetrics();
+    /** @brief Fit the scroll bar to the rows and keep the top row in range */
+    void updateScrollBar();
+
+    QGCTerminalBuffer buffer;
+    bool hexMode;
+    bool modified;          ///< Data was appended since the last refresh
+    bool followTail;        ///< Keep the last row in view
+    quint64 topRow;         ///< First row in the viewport
+    qint64 selectionStart;  ///< First selected row, -1 if none
+    qint64 selectionEnd;    ///< Last selected row
+    int rowHeight;
+    int ascent;
+    int charWidth;
+    QTimer refreshTimer;
+};
+
+#endif // QGCTERMINALVIEW_H
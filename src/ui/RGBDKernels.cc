@@ -0,0 +1,599 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Per-frame kernels of the RGBD views
+ */
+
+#include "RGBDKernels.h"
+
+#include <cmath>
+#include <string.h>
+
+// SSE2 is part of every x86-64 target, AVX only when the compiler is told so
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RGBD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RGBD_SSE2
+#endif
+
+namespace
+{
+const float colormapJet[128][3] = {
+    {0.0f,0.0f,0.53125f},
+    {0.0f,0.0f,0.5625f},
+    {0.0f,0.0f,0.59375f},
+    {0.0f,0.0f,0.625f},
+    {0.0f,0.0f,0.65625f},
+    {0.0f,0.0f,0.6875f},
+    {0.0f,0.0f,0.71875f},
+    {0.0f,0.0f,0.75f},
+    {0.0f,0.0f,0.78125f},
+    {0.0f,0.0f,0.8125f},
+    {0.0f,0.0f,0.84375f},
+    {0.0f,0.0f,0.875f},
+    {0.0f,0.0f,0.90625f},
+    {0.0f,0.0f,0.9375f},
+    {0.0f,0.0f,0.96875f},
+    {0.0f,0.0f,1.0f},
+    {0.0f,0.03125f,1.0f},
+    {0.0f,0.0625f,1.0f},
+    {0.0f,0.09375f,1.0f},
+    {0.0f,0.125f,1.0f},
+    {0.0f,0.15625f,1.0f},
+    {0.0f,0.1875f,1.0f},
+    {0.0f,0.21875f,1.0f},
+    {0.0f,0.25f,1.0f},
+    {0.0f,0.28125f,1.0f},
+    {0.0f,0.3125f,1.0f},
+    {0.0f,0.34375f,1.0f},
+    {0.0f,0.375f,1.0f},
+    {0.0f,0.40625f,1.0f},
+    {0.0f,0.4375f,1.0f},
+    {0.0f,0.46875f,1.0f},
+    {0.0f,0.5f,1.0f},
+    {0.0f,0.53125f,1.0f},
+    {0.0f,0.5625f,1.0f},
+    {0.0f,0.59375f,1.0f},
+    {0.0f,0.625f,1.0f},
+    {0.0f,0.65625f,1.0f},
+    {0.0f,0.6875f,1.0f},
+    {0.0f,0.71875f,1.0f},
+    {0.0f,0.75f,1.0f},
+    {0.0f,0.78125f,1.0f},
+    {0.0f,0.8125f,1.0f},
+    {0.0f,0.84375f,1.0f},
+    {0.0f,0.875f,1.0f},
+    {0.0f,0.90625f,1.0f},
+    {0.0f,0.9375f,1.0f},
+    {0.0f,0.96875f,1.0f},
+    {0.0f,1.0f,1.0f},
+    {0.03125f,1.0f,0.96875f},
+    {0.0625f,1.0f,0.9375f},
+    {0.09375f,1.0f,0.90625f},
+    {0.125f,1.0f,0.875f},
+    {0.15625f,1.0f,0.84375f},
+    {0.1875f,1.0f,0.8125f},
+    {0.21875f,1.0f,0.78125f},
+    {0.25f,1.0f,0.75f},
+    {0.28125f,1.0f,0.71875f},
+    {0.3125f,1.0f,0.6875f},
+    {0.34375f,1.0f,0.65625f},
+    {0.375f,1.0f,0.625f},
+    {0.40625f,1.0f,0.59375f},
+    {0.4375f,1.0f,0.5625f},
+    {0.46875f,1.0f,0.53125f},
+    {0.5f,1.0f,0.5f},
+    {0.53125f,1.0f,0.46875f},
+    {0.5625f,1.0f,0.4375f},
+    {0.59375f,1.0f,0.40625f},
+    {0.625f,1.0f,0.375f},
+    {0.65625f,1.0f,0.34375f},
+    {0.6875f,1.0f,0.3125f},
+    {0.71875f,1.0f,0.28125f},
+    {0.75f,1.0f,0.25f},
+    {0.78125f,1.0f,0.21875f},
+    {0.8125f,1.0f,0.1875f},
+    {0.84375f,1.0f,0.15625f},
+    {0.875f,1.0f,0.125f},
+    {0.90625f,1.0f,0.09375f},
+    {0.9375f,1.0f,0.0625f},
+    {0.96875f,1.0f,0.03125f},
+    {1.0f,1.0f,0.0f},
+    {1.0f,0.96875f,0.0f},
+    {1.0f,0.9375f,0.0f},
+    {1.0f,0.90625f,0.0f},
+    {1.0f,0.875f,0.0f},
+    {1.0f,0.84375f,0.0f},
+    {1.0f,0.8125f,0.0f},
+    {1.0f,0.78125f,0.0f},
+    {1.0f,0.75f,0.0f},
+    {1.0f,0.71875f,0.0f},
+    {1.0f,0.6875f,0.0f},
+    {1.0f,0.65625f,0.0f},
+    {1.0f,0.625f,0.0f},
+    {1.0f,0.59375f,0.0f},
+    {1.0f,0.5625f,0.0f},
+    {1.0f,0.53125f,0.0f},
+    {1.0f,0.5f,0.0f},
+    {1.0f,0.46875f,0.0f},
+    {1.0f,0.4375f,0.0f},
+    {1.0f,0.40625f,0.0f},
+    {1.0f,0.375f,0.0f},
+    {1.0f,0.34375f,0.0f},
+    {1.0f,0.3125f,0.0f},
+    {1.0f,0.28125f,0.0f},
+    {1.0f,0.25f,0.0f},
+    {1.0f,0.21875f,0.0f},
+    {1.0f,0.1875f,0.0f},
+    {1.0f,0.15625f,0.0f},
+    {1.0f,0.125f,0.0f},
+    {1.0f,0.09375f,0.0f},
+    {1.0f,0.0625f,0.0f},
+    {1.0f,0.03125f,0.0f},
+    {1.0f,0.0f,0.0f},
+    {0.96875f,0.0f,0.0f},
+    {0.9375f,0.0f,0.0f},
+    {0.90625f,0.0f,0.0f},
+    {0.875f,0.0f,0.0f},
+    {0.84375f,0.0f,0.0f},
+    {0.8125f,0.0f,0.0f},
+    {0.78125f,0.0f,0.0f},
+    {0.75f,0.0f,0.0f},
+    {0.71875f,0.0f,0.0f},
+    {0.6875f,0.0f,0.0f},
+    {0.65625f,0.0f,0.0f},
+    {0.625f,0.0f,0.0f},
+    {0.59375f,0.0f,0.0f},
+    {0.5625f,0.0f,0.0f},
+    {0.53125f,0.0f,0.0f},
+    {0.5f,0.0f,0.0f}
+};
+
+// Voxel coordinates are packed into 21 bits each
+const qint64 kVoxelOffset = 1 << 20;
+const qint64 kVoxelMask = (1 << 21) - 1;
+// Packed voxels use 63 bits, so this is never one of them
+const quint64 kEmptyVoxel = ~Q_UINT64_C(0);
+}
+
+namespace RGBD
+{
+
+const char* instructionSet()
+{
+#if defined(RGBD_AVX)
+    return "AVX";
+#elif defined(RGBD_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+DepthColormap::DepthColormap(float maxDepth, bool nearIsRed, ChannelOrder order)
+    : mMaxDepth(maxDepth)
+    , mScale((COLORS - 1) / maxDepth)
+    , mNearIsRed(nearIsRed)
+{
+    for (int i = 0; i < COLORS; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            mColors[i][c] = colormapJet[i][c];
+        }
+        int r = (order == RGB) ? 0 : 2;
+        mTable[i][0] = colormapJet[i][r] * 255.0f;
+        mTable[i][1] = colormapJet[i][1] * 255.0f;
+        mTable[i][2] = colormapJet[i][2 - r] * 255.0f;
+    }
+    mTable[BLACK][0] = 0;
+    mTable[BLACK][1] = 0;
+    mTable[BLACK][2] = 0;
+}
+
+float
+DepthColormap::maxDepth(void) const
+{
+    return mMaxDepth;
+}
+
+int
+DepthColormap::index(float depth) const
+{
+    if (depth == 0.0f)
+    {
+        return BLACK;
+    }
+
+    // Written like the SIMD min and max, so NaN ends up at the far end as well
+    float d = (depth < mMaxDepth) ? depth : mMaxDepth;
+    d = (d > 0.0f) ? d : 0.0f;
+    float f = d * mScale;
+    f = (f < COLORS - 1) ? f : COLORS - 1;
+    int idx = static_cast<int>(f);
+    return mNearIsRed ? (COLORS - 1) - idx : idx;
+}
+
+void
+DepthColormap::color(float depth, float& r, float& g, float& b) const
+{
+    int idx = index(depth);
+    if (idx == BLACK)
+    {
+        r = g = b = 0.0f;
+        return;
+    }
+    r = mColors[idx][0];
+    g = mColors[idx][1];
+    b = mColors[idx][2];
+}
+
+void
+DepthColormap::colorizeScalar(const float* depth, int cols, int rows, int depthStep,
+                              unsigned char* rgb, int rgbStep) const
+{
+    for (int r = 0; r < rows; ++r)
+    {
+        const float* in = reinterpret_cast<const float*>(reinterpret_cast<const char*>(depth) + r * depthStep);
+        unsigned char* pixel = rgb + r * rgbStep;
+        for (int c = 0; c < cols; ++c)
+        {
+            const unsigned char* color = mTable[index(in[c])];
+            pixel[0] = color[0];
+            pixel[1] = color[1];
+            pixel[2] = color[2];
+            pixel += 3;
+        }
+    }
+}
+
+void
+DepthColormap::colorize(const float* depth, int cols, int rows, int depthStep,
+                        unsigned char* rgb, int rgbStep) const
+{
+#if defined(RGBD_AVX) || defined(RGBD_SSE2)
+#if defined(RGBD_AVX)
+    const int width = 8;
+    const __m256 maxDepth = _mm256_set1_ps(mMaxDepth);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 scale = _mm256_set1_ps(mScale);
+    const __m256 last = _mm256_set1_ps(COLORS - 1);
+    const __m256 black = _mm256_set1_ps(BLACK);
+#else
+    const int width = 4;
+    const __m128 maxDepth = _mm_set1_ps(mMaxDepth);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 scale = _mm_set1_ps(mScale);
+    const __m128 last = _mm_set1_ps(COLORS - 1);
+    const __m128 black = _mm_set1_ps(BLACK);
+#endif
+    int indices[8];
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const float* in = reinterpret_cast<const float*>(reinterpret_cast<const char*>(depth) + r * depthStep);
+        unsigned char* pixel = rgb + r * rgbStep;
+        int c = 0;
+        for (; c + width <= cols; c += width)
+        {
+            // The table indices are computed as floats, they are exact up to 2^24
+#if defined(RGBD_AVX)
+            __m256 d = _mm256_loadu_ps(in + c);
+            __m256 invalid = _mm256_cmp_ps(d, zero, _CMP_EQ_OQ);
+            __m256 f = _mm256_mul_ps(_mm256_max_ps(_mm256_min_ps(d, maxDepth), zero), scale);
+            f = _mm256_round_ps(_mm256_min_ps(f, last), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            if (mNearIsRed)
+            {
+                f = _mm256_sub_ps(last, f);
+            }
+            f = _mm256_blendv_ps(f, black, invalid);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(indices), _mm256_cvttps_epi32(f));
+#else
+            __m128 d = _mm_loadu_ps(in + c);
+            __m128 invalid = _mm_cmpeq_ps(d, zero);
+            __m128 f = _mm_mul_ps(_mm_max_ps(_mm_min_ps(d, maxDepth), zero), scale);
+            f = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(f, last)));
+            if (mNearIsRed)
+            {
+                f = _mm_sub_ps(last, f);
+            }
+            f = _mm_or_ps(_mm_and_ps(invalid, black), _mm_andnot_ps(invalid, f));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(f));
+#endif
+            for (int i = 0; i < width; ++i)
+            {
+                const unsigned char* color = mTable[indices[i]];
+                pixel[0] = color[0];
+                pixel[1] = color[1];
+                pixel[2] = color[2];
+                pixel += 3;
+            }
+        }
+        for (; c < cols; ++c)
+        {
+            const unsigned char* color = mTable[index(in[c])];
+            pixel[0] = color[0];
+            pixel[1] = color[1];
+            pixel[2] = color[2];
+            pixel += 3;
+        }
+    }
+#else
+    colorizeScalar(depth, cols, rows, depthStep, rgb, rgbStep);
+#endif
+}
+
+DepthProjector::DepthProjector()
+{
+}
+
+void
+DepthProjector::setIntrinsics(int cols, int rows, float fx, float fy, float cx, float cy)
+{
+    int count = cols * rows;
+    mRayX.resize(count);
+    mRayY.resize(count);
+    mRayZ.resize(count);
+    mPoints.resize(count * 3);
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < cols; ++c)
+        {
+            int i = r * cols + c;
+            mRayX[i] = (c - cx) / fx;
+            mRayY[i] = (r - cy) / fy;
+            mRayZ[i] = 1.0f;
+        }
+    }
+}
+
+void
+DepthProjector::setRays(const QVector3D* rays, int count)
+{
+    mRayX.resize(count);
+    mRayY.resize(count);
+    mRayZ.resize(count);
+    mPoints.resize(count * 3);
+    for (int i = 0; i < count; ++i)
+    {
+        mRayX[i] = rays[i].x();
+        mRayY[i] = rays[i].y();
+        mRayZ[i] = rays[i].z();
+    }
+}
+
+int
+DepthProjector::size(void) const
+{
+    return mRayX.size();
+}
+
+const QVector<float>&
+DepthProjector::projectScalar(const float* range, int& count)
+{
+    const float* rayX = mRayX.constData();
+    const float* rayY = mRayY.constData();
+    const float* rayZ = mRayZ.constData();
+    float* out = mPoints.data();
+    int n = mRayX.size();
+
+    count = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (range[i] > 0.0f)
+        {
+            out[0] = rayX[i] * range[i];
+            out[1] = rayY[i] * range[i];
+            out[2] = rayZ[i] * range[i];
+            out += 3;
+            ++count;
+        }
+    }
+    return mPoints;
+}
+
+const QVector<float>&
+DepthProjector::project(const float* range, int& count)
+{
+#if defined(RGBD_AVX) || defined(RGBD_SSE2)
+    const float* rayX = mRayX.constData();
+    const float* rayY = mRayY.constData();
+    const float* rayZ = mRayZ.constData();
+    float* out = mPoints.data();
+    int n = mRayX.size();
+#if defined(RGBD_AVX)
+    const int width = 8;
+    const __m256 zero = _mm256_setzero_ps();
+#else
+    const int width = 4;
+    const __m128 zero = _mm_setzero_ps();
+#endif
+    float x[8], y[8], z[8];
+
+    count = 0;
+    int i = 0;
+    for (; i + width <= n; i += width)
+    {
+#if defined(RGBD_AVX)
+        __m256 r = _mm256_loadu_ps(range + i);
+        int valid = _mm256_movemask_ps(_mm256_cmp_ps(r, zero, _CMP_GT_OQ));
+        if (valid == 0)
+        {
+            continue;
+        }
+        _mm256_storeu_ps(x, _mm256_mul_ps(_mm256_loadu_ps(rayX + i), r));
+        _mm256_storeu_ps(y, _mm256_mul_ps(_mm256_loadu_ps(rayY + i), r));
+        _mm256_storeu_ps(z, _mm256_mul_ps(_mm256_loadu_ps(rayZ + i), r));
+#else
+        __m128 r = _mm_loadu_ps(range + i);
+        int valid = _mm_movemask_ps(_mm_cmpgt_ps(r, zero));
+        if (valid == 0)
+        {
+            continue;
+        }
+        _mm_storeu_ps(x, _mm_mul_ps(_mm_loadu_ps(rayX + i), r));
+        _mm_storeu_ps(y, _mm_mul_ps(_mm_loadu_ps(rayY + i), r));
+        _mm_storeu_ps(z, _mm_mul_ps(_mm_loadu_ps(rayZ + i), r));
+#endif
+        // Only the points with a range are written out
+        for (int j = 0; j < width; ++j)
+        {
+            if (valid & (1 << j))
+            {
+                out[0] = x[j];
+                out[1] = y[j];
+                out[2] = z[j];
+                out += 3;
+                ++count;
+            }
+        }
+    }
+    for (; i < n; ++i)
+    {
+        if (range[i] > 0.0f)
+        {
+            out[0] = rayX[i] * range[i];
+            out[1] = rayY[i] * range[i];
+            out[2] = rayZ[i] * range[i];
+            out += 3;
+            ++count;
+        }
+    }
+    return mPoints;
+#else
+    return projectScalar(range, count);
+#endif
+}
+
+VoxelGrid::VoxelGrid(float leafSize)
+    : mLeafSize(leafSize)
+{
+}
+
+void
+VoxelGrid::setLeafSize(float leafSize)
+{
+    mLeafSize = leafSize;
+}
+
+float
+VoxelGrid::leafSize(void) const
+{
+    return mLeafSize;
+}
+
+int
+VoxelGrid::filter(float* xyz, float* rgba, int count)
+{
+    if (mLeafSize <= 0.0f || count <= 1)
+    {
+        return count;
+    }
+
+    // At most half full, so the probe sequences stay short
+    int size = 1024;
+    while (size < count * 2)
+    {
+        size *= 2;
+    }
+    if (mKeys.size() != size)
+    {
+        mKeys.resize(size);
+        mSlots.resize(size);
+    }
+    memset(mKeys.data(), 0xff, size * sizeof(quint64));
+    if (mSums.size() < count * 8)
+    {
+        mSums.resize(count * 8);
+    }
+
+    quint64* keys = mKeys.data();
+    int* slots = mSlots.data();
+    float* sums = mSums.data();
+    float inverse = 1.0f / mLeafSize;
+    int voxels = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const float* p = xyz + i * 3;
+        quint64 key = 0;
+        for (int c = 0; c < 3; ++c)
+        {
+            qint64 v = static_cast<qint64>(floorf(p[c] * inverse)) + kVoxelOffset;
+            key = (key << 21) | (static_cast<quint64>(v) & kVoxelMask);
+        }
+
+        quint64 slot = (key * Q_UINT64_C(0x9E3779B97F4A7C15)) >> 32;
+        for (slot &= size - 1; keys[slot] != kEmptyVoxel && keys[slot] != key; slot = (slot + 1) & (size - 1))
+        {
+        }
+        float* sum;
+        if (keys[slot] == kEmptyVoxel)
+        {
+            keys[slot] = key;
+            slots[slot] = voxels;
+            sum = sums + voxels * 8;
+            memset(sum, 0, 8 * sizeof(float));
+            ++voxels;
+        }
+        else
+        {
+            sum = sums + slots[slot] * 8;
+        }
+
+        sum[0] += p[0];
+        sum[1] += p[1];
+        sum[2] += p[2];
+        if (rgba)
+        {
+            const float* color = rgba + i * 4;
+            sum[3] += color[0];
+            sum[4] += color[1];
+            sum[5] += color[2];
+            sum[6] += color[3];
+        }
+        sum[7] += 1.0f;
+    }
+
+    // All points are summed by now, the input is overwritten with the averages
+    for (int v = 0; v < voxels; ++v)
+    {
+        const float* sum = sums + v * 8;
+        float n = sum[7];
+        xyz[v * 3] = sum[0] / n;
+        xyz[v * 3 + 1] = sum[1] / n;
+        xyz[v * 3 + 2] = sum[2] / n;
+        if (rgba)
+        {
+            rgba[v * 4] = sum[3] / n;
+            rgba[v * 4 + 1] = sum[4] / n;
+            rgba[v * 4 + 2] = sum[5] / n;
+            rgba[v * 4 + 3] = sum[6] / n;
+        }
+    }
+    return voxels;
+}
+
+}
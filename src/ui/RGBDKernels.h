@@ -0,0 +1,169 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Per-frame kernels of the RGBD views: depth colorization,
+ *          depth to point projection and voxel grid downsampling
+ */
+
+#ifndef RGBDKERNELS_H
+#define RGBDKERNELS_H
+
+#include <QVector>
+#include <QVector3D>
+
+namespace RGBD
+{
+
+/** @brief Instruction set the kernels were compiled for: "AVX", "SSE2" or "scalar" */
+const char* instructionSet();
+
+/**
+ * @brief Maps depth values onto the jet colormap.
+ *
+ * The colors are kept in a lookup table with one extra black entry for
+ * pixels without depth, so the inner loop does not branch. The table index
+ * is computed for 4 (SSE2) or 8 (AVX) pixels at a time.
+ */
+class DepthColormap
+{
+public:
+    enum ChannelOrder
+    {
+        RGB,
+        BGR
+    };
+
+    /**
+     * @param maxDepth Depth mapped onto the last color, farther pixels are clamped
+     * @param nearIsRed Near pixels red and far pixels blue, otherwise the other way round
+     */
+    explicit DepthColormap(float maxDepth = 10.0f, bool nearIsRed = true,
+                           ChannelOrder order = RGB);
+
+    float maxDepth(void) const;
+
+    /**
+     * @brief Colorize a depth image into packed 24 bit pixels
+     *
+     * @param depth First row of the depth image
+     * @param depthStep Bytes between two rows of the depth image
+     * @param rgb First row of the output, 3 bytes per pixel
+     * @param rgbStep Bytes between two rows of the output
+     */
+    void colorize(const float* depth, int cols, int rows, int depthStep,
+                  unsigned char* rgb, int rgbStep) const;
+    /** @brief Same as colorize(), without SIMD. Reference for the tests. */
+    void colorizeScalar(const float* depth, int cols, int rows, int depthStep,
+                        unsigned char* rgb, int rgbStep) const;
+
+    /** @brief Color of a single depth value, components from 0 to 1 */
+    void color(float depth, float& r, float& g, float& b) const;
+
+private:
+    enum
+    {
+        COLORS = 128,
+        BLACK = COLORS      ///< Entry of pixels without depth
+    };
+
+    int index(float depth) const;
+
+    float mMaxDepth;
+    float mScale;
+    bool mNearIsRed;
+    unsigned char mTable[COLORS + 1][3];
+    float mColors[COLORS][3];
+};
+
+/**
+ * @brief Projects depth images into 3D points along a ray per pixel.
+ *
+ * The rays are kept as separate x, y and z tables, so a row of points is
+ * computed with SIMD multiplications. The output buffer is allocated once
+ * and reused for every frame.
+ */
+class DepthProjector
+{
+public:
+    DepthProjector();
+
+    /** @brief Pinhole camera rays for a cols x rows image */
+    void setIntrinsics(int cols, int rows, float fx, float fy, float cx, float cy);
+    /** @brief Rays of a calibrated camera, e.g. with the lens distortion removed */
+    void setRays(const QVector3D* rays, int count);
+
+    int size(void) const;
+
+    /**
+     * @brief Project a frame of ranges, one per ray
+     *
+     * Pixels with a range of zero or less are skipped.
+     * @return The points, x y z interleaved. Valid until the next call.
+     */
+    const QVector<float>& project(const float* range, int& count);
+    /** @brief Same as project(), without SIMD. Reference for the tests. */
+    const QVector<float>& projectScalar(const float* range, int& count);
+
+private:
+    QVector<float> mRayX;
+    QVector<float> mRayY;
+    QVector<float> mRayZ;
+    QVector<float> mPoints;
+};
+
+/**
+ * @brief Downsamples point clouds to one point per cubic voxel.
+ *
+ * The points of each voxel are averaged, and their colors with them. The
+ * voxels are found through an open addressing hash table, which keeps its
+ * memory from frame to frame like the other buffers.
+ */
+class VoxelGrid
+{
+public:
+    explicit VoxelGrid(float leafSize = 0.05f);
+
+    void setLeafSize(float leafSize);
+    float leafSize(void) const;
+
+    /**
+     * @brief Downsample in place
+     *
+     * @param xyz Points, x y z interleaved
+     * @param rgba Colors, 4 floats per point, or NULL
+     * @return The number of points left at the start of the buffers, in the
+     *         order their voxels were first seen
+     */
+    int filter(float* xyz, float* rgba, int count);
+
+private:
+    float mLeafSize;
+    QVector<quint64> mKeys;     ///< Voxel of each slot
+    QVector<int> mSlots;        ///< Index into mSums of each slot
+    QVector<float> mSums;       ///< x y z r g b a and point count per voxel
+};
+
+}
+
+#endif // RGBDKERNELS_H
@@ -0,0 +1,121 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Cell editors of the waypoint table
+ */
+
+#include "WaypointItemDelegate.h"
+#include "WaypointTableModel.h"
+
+#include <QComboBox>
+#include <QDoubleSpinBox>
+
+WaypointItemDelegate::WaypointItemDelegate(QObject* parent) :
+    QStyledItemDelegate(parent)
+{
+}
+
+QWidget* WaypointItemDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    switch (index.column())
+    {
+    case WaypointTableModel::COLUMN_COMMAND:
+    {
+        QComboBox* box = new QComboBox(parent);
+        foreach (int command, WaypointTableModel::getCommands())
+        {
+            box->addItem(WaypointTableModel::getCommandName(command), command);
+        }
+        return box;
+    }
+    case WaypointTableModel::COLUMN_FRAME:
+    {
+        QComboBox* box = new QComboBox(parent);
+        foreach (int frame, WaypointTableModel::getFrames())
+        {
+            box->addItem(WaypointTableModel::getFrameName(frame), frame);
+        }
+        return box;
+    }
+    case WaypointTableModel::COLUMN_PARAM1:
+    case WaypointTableModel::COLUMN_PARAM2:
+    case WaypointTableModel::COLUMN_PARAM3:
+    case WaypointTableModel::COLUMN_PARAM4:
+    case WaypointTableModel::COLUMN_X:
+    case WaypointTableModel::COLUMN_Y:
+    case WaypointTableModel::COLUMN_Z:
+    {
+        QDoubleSpinBox* box = new QDoubleSpinBox(parent);
+        box->setRange(-100000000.0, 100000000.0);
+        // Latitude and longitude need 7 decimals for centimeter resolution
+        bool position = (index.column() == WaypointTableModel::COLUMN_X || index.column() == WaypointTableModel::COLUMN_Y);
+        box->setDecimals(position ? 7 : 2);
+        return box;
+    }
+    default:
+        return QStyledItemDelegate::createEditor(parent, option, index);
+    }
+}
+
+void WaypointItemDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const
+{
+    QVariant value = index.data(Qt::EditRole);
+
+    if (QComboBox* box = qobject_cast<QComboBox*>(editor))
+    {
+        int item = box->findData(value.toInt());
+        if (item < 0)
+        {
+            // Keep commands the editor does not know, e.g. read from the MAV
+            box->addItem(index.data(Qt::DisplayRole).toString(), value.toInt());
+            item = box->count() - 1;
+        }
+        box->setCurrentIndex(item);
+    }
+    else if (QDoubleSpinBox* box = qobject_cast<QDoubleSpinBox*>(editor))
+    {
+        box->setValue(value.toDouble());
+    }
+    else
+    {
+        QStyledItemDelegate::setEditorData(editor, index);
+    }
+}
+
+void WaypointItemDelegate::setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const
+{
+    if (QComboBox* box = qobject_cast<QComboBox*>(editor))
+    {
+        model->setData(index, box->itemData(box->currentIndex()), Qt::EditRole);
+    }
+    else if (QDoubleSpinBox* box = qobject_cast<QDoubleSpinBox*>(editor))
+    {
+        box->interpretText();
+        model->setData(index, box->value(), Qt::EditRole);
+    }
+    else
+    {
+        QStyledItemDelegate::setModelData(editor, model, index);
+    }
+}
@@ -1,8 +1,7 @@
-/*=====================================================================
-
+/*===================================================================
 APM_PLANNER Open Source Ground Control Station
 
-(c) 2013, Bill Bonney <billbonney@communistech.com>
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
 
 This file is part of the APM_PLANNER project
 
@@ -23,29 +22,28 @@ This file is part of the APM_PLANNER project
 
 /**
  * @file
- *   @brief APM Highligther for ArduPilot Console.
- *
- *   @author Bill Bonney <billbonney@communistech.com>
- *
+ *   @brief Cell editors of the waypoint table
  */
 
-#ifndef APMHIGHLIGHTER_H
-#define APMHIGHLIGHTER_H
+#ifndef WAYPOINTITEMDELEGATE_H
+#define WAYPOINTITEMDELEGATE_H
 
-#include "ApmHighlighter.h"
-#include <QSyntaxHighlighter>
+#include <QStyledItemDelegate>
 
-class APMHighlighter : public QSyntaxHighlighter
+/**
+ * Creates a combo box or spin box for the one cell that is being edited,
+ * all other cells are only painted. Together with the table view this
+ * keeps the widget count independent of the mission size.
+ */
+class WaypointItemDelegate : public QStyledItemDelegate
 {
     Q_OBJECT
 public:
-    explicit APMHighlighter(QObject *parent = 0);
-    void highlightBlock(const QString &text);
+    explicit WaypointItemDelegate(QObject* parent = 0);
 
-signals:
-    
-public slots:
-    
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const;
 };
 
-#endif // APMHIGHLIGHTER_H
+#endif // WAYPOINTITEMDELEGATE_H
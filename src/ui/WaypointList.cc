@@ -33,6 +33,7 @@ This file is part of the PIXHAWK project
 
 #include "WaypointList.h"
 #include "ui_WaypointList.h"
+#include "WaypointItemDelegate.h"
 #include <UASInterface.h>
 #include <UAS.h>
 #include <UASManager.h>
@@ -40,9 +41,13 @@ This file is part of the PIXHAWK project
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QMouseEvent>
+#include <QHeaderView>
 
 WaypointList::WaypointList(QWidget *parent, UASWaypointManager* wpm) :
     QWidget(parent),
+    editableModel(new WaypointTableModel(WaypointTableModel::EDITABLE, this)),
+    viewOnlyModel(new WaypointTableModel(WaypointTableModel::VIEW_ONLY, this)),
+    detailWaypoint(NULL),
     uas(NULL),
     WPM(wpm),
     mavX(0.0),
@@ -57,11 +62,20 @@ WaypointList::WaypointList(QWidget *parent, UASWaypointManager* wpm) :
 
     //EDIT TAB
 
-    editableListLayout = new QVBoxLayout(m_ui->editableListWidget);
-    editableListLayout->setSpacing(0);
-    editableListLayout->setMargin(0);
-    editableListLayout->setAlignment(Qt::AlignTop);
-    m_ui->editableListWidget->setLayout(editableListLayout);
+    // The table only paints the visible rows, editors exist for the edited
+    // cell and the full editor for the selected waypoint only
+    m_ui->editableTableView->setModel(editableModel);
+    m_ui->editableTableView->setItemDelegate(new WaypointItemDelegate(this));
+    m_ui->editableTableView->verticalHeader()->hide();
+    m_ui->editableTableView->horizontalHeader()->setStretchLastSection(true);
+    connect(m_ui->editableTableView->selectionModel(), SIGNAL(currentRowChanged(QModelIndex,QModelIndex)),
+            this, SLOT(editableRowChanged(QModelIndex,QModelIndex)));
+
+    editableDetailLayout = new QVBoxLayout(m_ui->editableDetailWidget);
+    editableDetailLayout->setSpacing(0);
+    editableDetailLayout->setMargin(0);
+    editableDetailLayout->setAlignment(Qt::AlignTop);
+    m_ui->editableDetailWidget->setLayout(editableDetailLayout);
 
     // ADD WAYPOINT
     // Connect add action, set right button icon and connect action to this class
@@ -88,11 +102,9 @@ WaypointList::WaypointList(QWidget *parent, UASWaypointManager* wpm) :
 
     //VIEW TAB
 
-    viewOnlyListLayout = new QVBoxLayout(m_ui->viewOnlyListWidget);
-    viewOnlyListLayout->setSpacing(0);
-    viewOnlyListLayout->setMargin(0);
-    viewOnlyListLayout->setAlignment(Qt::AlignTop);
-    m_ui->viewOnlyListWidget->setLayout(viewOnlyListLayout);
+    m_ui->viewOnlyTableView->setModel(viewOnlyModel);
+    m_ui->viewOnlyTableView->verticalHeader()->hide();
+    m_ui->viewOnlyTableView->horizontalHeader()->setStretchLastSection(true);
 
     // REFRESH VIEW TAB
 
@@ -109,24 +121,12 @@ WaypointList::WaypointList(QWidget *parent, UASWaypointManager* wpm) :
             m_ui->refreshButton->hide();
             //FIXME: The whole "Onboard Waypoints"-tab should be hidden, instead of "refresh" button
             UnconnectedUASInfoWidget* inf = new UnconnectedUASInfoWidget(this);
-            viewOnlyListLayout->insertWidget(0, inf); //insert a "NO UAV" info into the Onboard Tab
+            m_ui->viewOnlyListLayout->insertWidget(0, inf); //insert a "NO UAV" info into the Onboard Tab
             showOfflineWarning = true;
+            connectWaypointManager();
         } else {
             setUAS(static_cast<UASInterface*>(WPM->getUAS()));
         }
-
-        /* connect slots */
-        connect(WPM, SIGNAL(updateStatusString(const QString &)),        this, SLOT(updateStatusLabel(const QString &)));
-        connect(WPM, SIGNAL(waypointEditableListChanged(void)),                  this, SLOT(waypointEditableListChanged(void)));
-        connect(WPM, SIGNAL(waypointEditableChanged(int,Waypoint*)), this, SLOT(updateWaypointEditable(int,Waypoint*)));
-        connect(WPM, SIGNAL(waypointViewOnlyListChanged(void)),                  this, SLOT(waypointViewOnlyListChanged(void)));
-        connect(WPM, SIGNAL(waypointViewOnlyChanged(int,Waypoint*)), this, SLOT(updateWaypointViewOnly(int,Waypoint*)));
-        connect(WPM, SIGNAL(currentWaypointChanged(quint16)),            this, SLOT(currentWaypointViewOnlyChanged(quint16)));
-
-        //Even if there are no waypoints, since this is a new instance and there is an
-        //existing WPM, then we need to assume things have changed, and act appropriatly.
-        waypointEditableListChanged();
-        waypointViewOnlyListChanged();
     }
 
     // STATUS LABEL
@@ -174,11 +174,7 @@ void WaypointList::setUAS(UASInterface* uas)
         on_clearWPListButton_clicked();
         // Disconnect everything
         disconnect(WPM, SIGNAL(updateStatusString(const QString &)),        this, SLOT(updateStatusLabel(const QString &)));
-        disconnect(WPM, SIGNAL(waypointEditableListChanged(void)),                  this, SLOT(waypointEditableListChanged(void)));
         disconnect(WPM, SIGNAL(waypointEditableChanged(int,Waypoint*)), this, SLOT(updateWaypointEditable(int,Waypoint*)));
-        disconnect(WPM, SIGNAL(waypointViewOnlyListChanged(void)),                  this, SLOT(waypointViewOnlyListChanged(void)));
-        disconnect(WPM, SIGNAL(waypointViewOnlyChanged(int,Waypoint*)), this, SLOT(updateWaypointViewOnly(int,Waypoint*)));
-        disconnect(WPM, SIGNAL(currentWaypointChanged(quint16)),            this, SLOT(currentWaypointViewOnlyChanged(quint16)));
         disconnect(this->uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)),  this, SLOT(updatePosition(UASInterface*,double,double,double,quint64)));
         disconnect(this->uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)),       this, SLOT(updateAttitude(UASInterface*,double,double,double,quint64)));
     }
@@ -186,12 +182,7 @@ void WaypointList::setUAS(UASInterface* uas)
     WPM = uas->getWaypointManager();
 
     this->uas = uas;
-    connect(WPM, SIGNAL(updateStatusString(const QString &)),        this, SLOT(updateStatusLabel(const QString &)));
-    connect(WPM, SIGNAL(waypointEditableListChanged(void)),                  this, SLOT(waypointEditableListChanged(void)));
-    connect(WPM, SIGNAL(waypointEditableChanged(int,Waypoint*)), this, SLOT(updateWaypointEditable(int,Waypoint*)));
-    connect(WPM, SIGNAL(waypointViewOnlyListChanged(void)),                  this, SLOT(waypointViewOnlyListChanged(void)));
-    connect(WPM, SIGNAL(waypointViewOnlyChanged(int,Waypoint*)), this, SLOT(updateWaypointViewOnly(int,Waypoint*)));
-    connect(WPM, SIGNAL(currentWaypointChanged(quint16)),            this, SLOT(currentWaypointViewOnlyChanged(quint16)));
+    connectWaypointManager();
     connect(uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)),  this, SLOT(updatePosition(UASInterface*,double,double,double,quint64)));
     connect(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)),       this, SLOT(updateAttitude(UASInterface*,double,double,double,quint64)));
     //connect(WPM,SIGNAL(loadWPFile()),this,SLOT(setIsLoadFileWP()));
@@ -201,6 +192,16 @@ void WaypointList::setUAS(UASInterface* uas)
     read();
 }
 
+void WaypointList::connectWaypointManager()
+{
+    connect(WPM, SIGNAL(updateStatusString(const QString &)),        this, SLOT(updateStatusLabel(const QString &)));
+    connect(WPM, SIGNAL(waypointEditableChanged(int,Waypoint*)), this, SLOT(updateWaypointEditable(int,Waypoint*)));
+
+    // The models follow all list changes of the manager on their own
+    editableModel->setWaypointManager(WPM);
+    viewOnlyModel->setWaypointManager(WPM);
+}
+
 void WaypointList::saveWaypoints()
 {
 
@@ -211,6 +212,8 @@ void WaypointList::saveWaypoints()
 
 void WaypointList::loadWaypoints()
 {
+    // Every load starts from a clean state
+    loadFileGlobalWP = false;
     QString fileName = QFileDialog::getOpenFileName(this, tr("Load File"), ".", tr("Waypoint File (*.txt)"));
     WPM->loadWaypoints(fileName);
 }
@@ -367,170 +370,61 @@ void WaypointList::changeCurrentWaypoint(quint16 seq)
 // Request UASWaypointManager to set the new "current" and make sure all other waypoints are not "current"
 void WaypointList::currentWaypointEditableChanged(quint16 seq)
 {
-        WPM->setCurrentEditable(seq);
-        const QList<Waypoint *> &waypoints = WPM->getWaypointEditableList();
-
-        if (seq < waypoints.count())
-        {
-            for(int i = 0; i < waypoints.count(); i++)
-            {
-                WaypointEditableView* widget = wpEditableViews.find(waypoints[i]).value();
-
-                if (waypoints[i]->getId() == seq)
-                {
-                    widget->setCurrent(true);
-                }
-                else
-                {
-                    widget->setCurrent(false);
-                }
-            }
-        }
-}
-
-// Update waypointViews to correctly indicate the new current waypoint
-void WaypointList::currentWaypointViewOnlyChanged(quint16 seq)
-{
-    const QList<Waypoint *> &waypoints = WPM->getWaypointViewOnlyList();
-
-    if (seq < waypoints.count())
-    {
-        for(int i = 0; i < waypoints.count(); i++)
-        {
-            WaypointViewOnlyView* widget = wpViewOnlyViews.find(waypoints[i]).value();
-
-            if (waypoints[i]->getId() == seq)
-            {
-                widget->setCurrent(true);
-            }
-            else
-            {
-                widget->setCurrent(false);
-            }
-        }
-    }
+    // The table model repaints the rows whose waypoints changed
+    WPM->setCurrentEditable(seq);
 }
 
 void WaypointList::updateWaypointEditable(int uas, Waypoint* wp)
 {
     Q_UNUSED(uas);
-    WaypointEditableView *wpv = wpEditableViews.value(wp);
-    wpv->updateValues();
+    if (detailView && detailWaypoint == wp)
+    {
+        detailView->updateValues();
+    }
 }
 
-void WaypointList::updateWaypointViewOnly(int uas, Waypoint* wp)
+void WaypointList::editableRowChanged(const QModelIndex& current, const QModelIndex& previous)
 {
-    Q_UNUSED(uas);
-    WaypointViewOnlyView *wpv = wpViewOnlyViews.value(wp);
-    wpv->updateValues();
+    Q_UNUSED(previous);
+    showWaypointDetail(editableModel->getWaypoint(current.row()));
 }
 
-void WaypointList::waypointViewOnlyListChanged()
+void WaypointList::showWaypointDetail(Waypoint* wp)
 {
-    // Prevent updates to prevent visual flicker
-    this->setUpdatesEnabled(false);
-    const QList<Waypoint *> &waypoints = WPM->getWaypointViewOnlyList();
-
-    if (!wpViewOnlyViews.empty()) {
-        QMapIterator<Waypoint*,WaypointViewOnlyView*> viewIt(wpViewOnlyViews);
-        viewIt.toFront();
-        while(viewIt.hasNext()) {
-            viewIt.next();
-            Waypoint *cur = viewIt.key();
-            int i;
-            for (i = 0; i < waypoints.count(); i++) {
-                if (waypoints[i] == cur) {
-                    break;
-                }
-            }
-            if (i == waypoints.count()) {
-                WaypointViewOnlyView* widget = wpViewOnlyViews.find(cur).value();
-                widget->hide();
-                viewOnlyListLayout->removeWidget(widget);
-                wpViewOnlyViews.remove(cur);
-            }
-        }
+    if (detailView)
+    {
+        if (detailWaypoint == wp)
+            return;
+        detailView->hide();
+        editableDetailLayout->removeWidget(detailView);
+        detailView->deleteLater();
+        detailView = NULL;
+        detailWaypoint = NULL;
     }
 
-    // then add/update the views for each waypoint in the list
-    for(int i = 0; i < waypoints.count(); i++) {
-        Waypoint *wp = waypoints[i];
-        if (!wpViewOnlyViews.contains(wp)) {
-            WaypointViewOnlyView* wpview = new WaypointViewOnlyView(wp, this);
-            wpViewOnlyViews.insert(wp, wpview);
-            connect(wpview, SIGNAL(changeCurrentWaypoint(quint16)), this, SLOT(changeCurrentWaypoint(quint16)));
-            viewOnlyListLayout->insertWidget(i, wpview);
-        }
-        WaypointViewOnlyView *wpv = wpViewOnlyViews.value(wp);
-
-        //check if ordering has changed
-        if(viewOnlyListLayout->itemAt(i)->widget() != wpv) {
-            viewOnlyListLayout->removeWidget(wpv);
-            viewOnlyListLayout->insertWidget(i, wpv);
-        }
-
-        wpv->updateValues();    // update the values of the ui elements in the view
-    }
-    this->setUpdatesEnabled(true);
-    loadFileGlobalWP = false;
+    if (!wp)
+        return;
 
+    detailView = new WaypointEditableView(wp, this);
+    detailWaypoint = wp;
+    connect(detailView, SIGNAL(moveDownWaypoint(Waypoint*)),    this, SLOT(moveDown(Waypoint*)));
+    connect(detailView, SIGNAL(moveUpWaypoint(Waypoint*)),      this, SLOT(moveUp(Waypoint*)));
+    connect(detailView, SIGNAL(removeWaypoint(Waypoint*)),      this, SLOT(removeWaypoint(Waypoint*)));
+    connect(detailView, SIGNAL(changeCurrentWaypoint(quint16)), this, SLOT(currentWaypointEditableChanged(quint16)));
+    connect(wp, SIGNAL(destroyed()), this, SLOT(detailWaypointDestroyed()));
+    editableDetailLayout->addWidget(detailView);
 }
 
-
-void WaypointList::waypointEditableListChanged()
+void WaypointList::detailWaypointDestroyed()
 {
-    // Prevent updates to prevent visual flicker
-    this->setUpdatesEnabled(false);
-    const QList<Waypoint *> &waypoints = WPM->getWaypointEditableList();
-
-    if (!wpEditableViews.empty()) {
-        QMapIterator<Waypoint*,WaypointEditableView*> viewIt(wpEditableViews);
-        viewIt.toFront();
-        while(viewIt.hasNext()) {
-            viewIt.next();
-            Waypoint *cur = viewIt.key();
-            int i;
-            for (i = 0; i < waypoints.count(); i++) {
-                if (waypoints[i] == cur) {
-                    break;
-                }
-            }
-            if (i == waypoints.count()) {
-                WaypointEditableView* widget = wpEditableViews.find(cur).value();
-                widget->hide();
-                editableListLayout->removeWidget(widget);
-                wpEditableViews.remove(cur);
-            }
-        }
-    }
-
-    // then add/update the views for each waypoint in the list
-    for(int i = 0; i < waypoints.count(); i++) {
-        Waypoint *wp = waypoints[i];
-        if (!wpEditableViews.contains(wp)) {
-            WaypointEditableView* wpview = new WaypointEditableView(wp, this);
-            wpEditableViews.insert(wp, wpview);
-            connect(wpview, SIGNAL(moveDownWaypoint(Waypoint*)),    this, SLOT(moveDown(Waypoint*)));
-            connect(wpview, SIGNAL(moveUpWaypoint(Waypoint*)),      this, SLOT(moveUp(Waypoint*)));
-            connect(wpview, SIGNAL(removeWaypoint(Waypoint*)),      this, SLOT(removeWaypoint(Waypoint*)));
-            //connect(wpview, SIGNAL(currentWaypointChanged(quint16)), this, SLOT(currentWaypointChanged(quint16)));
-            connect(wpview, SIGNAL(changeCurrentWaypoint(quint16)), this, SLOT(currentWaypointEditableChanged(quint16)));
-            editableListLayout->insertWidget(i, wpview);
-        }
-        WaypointEditableView *wpv = wpEditableViews.value(wp);
-
-        //check if ordering has changed
-        if(editableListLayout->itemAt(i)->widget() != wpv) {
-            editableListLayout->removeWidget(wpv);
-            editableListLayout->insertWidget(i, wpv);
-        }
-
-        wpv->updateValues();    // update the values of the ui elements in the view
+    if (detailView && detailWaypoint == sender())
+    {
+        detailView->hide();
+        editableDetailLayout->removeWidget(detailView);
+        detailView->deleteLater();
+        detailView = NULL;
+        detailWaypoint = NULL;
     }
-    this->setUpdatesEnabled(true);
-    loadFileGlobalWP = false;
-
-
 }
 
 void WaypointList::moveUp(Waypoint* wp)
@@ -589,25 +483,15 @@ void WaypointList::on_clearWPListButton_clicked()
 {
     if (uas) {
         emit clearPathclicked();
-        const QList<Waypoint *> &waypoints = WPM->getWaypointEditableList();
-        while(!waypoints.isEmpty()) {
-            WaypointEditableView* widget = wpEditableViews.find(waypoints[0]).value();
-            widget->remove();
-        }
+        clearWPWidget();
     }
 }
 
 void WaypointList::clearWPWidget()
-{    
-        // Get list
-        const QList<Waypoint *> &waypoints = WPM->getWaypointEditableList();
-
-
-        // XXX delete wps as well
-
-        // Clear UI elements
-        while(!waypoints.isEmpty()) {
-            WaypointEditableView* widget = wpEditableViews.find(waypoints[0]).value();
-            widget->remove();
-        }
+{
+    // Remove from the end, so no waypoint needs to be renumbered
+    const QList<Waypoint *> &waypoints = WPM->getWaypointEditableList();
+    while(!waypoints.isEmpty()) {
+        WPM->removeWaypoint(waypoints.count()-1);
+    }
 }
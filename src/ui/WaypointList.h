@@ -35,13 +35,14 @@ This file is part of the QGROUNDCONTROL project
 #define WAYPOINTLIST_H
 
 #include <QtGui/QWidget>
-#include <QMap>
 #include <QVBoxLayout>
 #include <QTimer>
+#include <QPointer>
+#include <QModelIndex>
 #include "Waypoint.h"
 #include "UASInterface.h"
 #include "WaypointEditableView.h"
-#include "WaypointViewOnlyView.h"
+#include "WaypointTableModel.h"
 #include "UnconnectedUASInfoWidget.h"
 //#include "PopupMessage.h"
 
@@ -91,16 +92,8 @@ public slots:
     void changeCurrentWaypoint(quint16 seq);
     /** @brief Current waypoint in edit-tab was changed, so the list must be updated (to contain only one waypoint checked as "current")  */
     void currentWaypointEditableChanged(quint16 seq);
-    /** @brief Current waypoint on UAV was changed, update view-tab  */
-    void currentWaypointViewOnlyChanged(quint16 seq);
     /** @brief The waypoint manager informs that one editable waypoint was changed */
     void updateWaypointEditable(int uas, Waypoint* wp);
-    /** @brief The waypoint manager informs that one viewonly waypoint was changed */
-    void updateWaypointViewOnly(int uas, Waypoint* wp);
-    /** @brief The waypoint manager informs that the editable waypoint list was changed */
-    void waypointEditableListChanged(void);
-    /** @brief The waypoint manager informs that the waypoint list on the MAV was changed */
-    void waypointViewOnlyListChanged(void);
 
 //    /** @brief The MapWidget informs that a waypoint global was changed on the map */
 //    void waypointGlobalChanged(const QPointF coordinate, const int indexWP);
@@ -128,10 +121,16 @@ protected:
     virtual void changeEvent(QEvent *e);
 
 protected:
-    QMap<Waypoint*, WaypointEditableView*> wpEditableViews;
-    QMap<Waypoint*, WaypointViewOnlyView*> wpViewOnlyViews;
-    QVBoxLayout* viewOnlyListLayout;
-    QVBoxLayout* editableListLayout;
+    /** @brief Connect the table models and the status label to the waypoint manager */
+    void connectWaypointManager();
+    /** @brief Show the full editor of one waypoint below the table, NULL hides it */
+    void showWaypointDetail(Waypoint* wp);
+
+    WaypointTableModel* editableModel;
+    WaypointTableModel* viewOnlyModel;
+    Waypoint* detailWaypoint;                    ///< Waypoint shown in the detail editor
+    QPointer<WaypointEditableView> detailView;   ///< Editor of the selected waypoint, the only one
+    QVBoxLayout* editableDetailLayout;
     UASInterface* uas;
     UASWaypointManager* WPM;
     double mavX;
@@ -152,6 +151,10 @@ private:
 
 private slots:
     void on_clearWPListButton_clicked();
+    /** @brief Another row of the edit-tab was selected */
+    void editableRowChanged(const QModelIndex& current, const QModelIndex& previous);
+    /** @brief The waypoint of the detail editor is being deleted */
+    void detailWaypointDestroyed();
 
 };
 
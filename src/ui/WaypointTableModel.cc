@@ -0,0 +1,462 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Table model of the editable or the onboard waypoint list
+ */
+
+#include "WaypointTableModel.h"
+#include "UASWaypointManager.h"
+
+#include <QFont>
+
+WaypointTableModel::WaypointTableModel(ListType type, QObject* parent) :
+    QAbstractTableModel(parent),
+    type(type),
+    currentSeq(-1)
+{
+}
+
+void WaypointTableModel::setWaypointManager(UASWaypointManager* wpm)
+{
+    if (this->wpm == wpm)
+        return;
+
+    if (this->wpm)
+    {
+        disconnect(this->wpm, 0, this, 0);
+    }
+
+    beginResetModel();
+    this->wpm = wpm;
+    currentSeq = -1;
+    waypoints = managerList();
+    endResetModel();
+
+    if (!wpm)
+        return;
+
+    if (type == EDITABLE)
+    {
+        connect(wpm, SIGNAL(waypointEditableRowsInserted(int,int)), this, SLOT(managerRowsInserted(int,int)));
+        connect(wpm, SIGNAL(waypointEditableRowsRemoved(int,int)), this, SLOT(managerRowsRemoved(int,int)));
+        connect(wpm, SIGNAL(waypointEditableRowMoved(int,int)), this, SLOT(managerRowMoved(int,int)));
+        connect(wpm, SIGNAL(waypointEditableListChanged()), this, SLOT(managerListChanged()));
+        connect(wpm, SIGNAL(waypointEditableChanged(int,Waypoint*)), this, SLOT(managerWaypointChanged(int,Waypoint*)));
+    }
+    else
+    {
+        connect(wpm, SIGNAL(waypointViewOnlyRowsInserted(int,int)), this, SLOT(managerRowsInserted(int,int)));
+        connect(wpm, SIGNAL(waypointViewOnlyListChanged()), this, SLOT(managerListChanged()));
+        connect(wpm, SIGNAL(waypointViewOnlyChanged(int,Waypoint*)), this, SLOT(managerWaypointChanged(int,Waypoint*)));
+        connect(wpm, SIGNAL(currentWaypointChanged(quint16)), this, SLOT(managerCurrentChanged(quint16)));
+    }
+}
+
+const QList<Waypoint*>& WaypointTableModel::managerList() const
+{
+    static const QList<Waypoint*> empty;
+    if (!wpm)
+        return empty;
+    return (type == EDITABLE) ? wpm->getWaypointEditableList() : wpm->getWaypointViewOnlyList();
+}
+
+Waypoint* WaypointTableModel::getWaypoint(int row) const
+{
+    if (row < 0 || row >= waypoints.size())
+        return NULL;
+    return waypoints.at(row);
+}
+
+int WaypointTableModel::getRow(Waypoint* wp) const
+{
+    // The id is the list index as long as the manager keeps them in sync
+    int row = wp ? wp->getId() : -1;
+    if (row >= 0 && row < waypoints.size() && waypoints.at(row) == wp)
+        return row;
+    return waypoints.indexOf(wp);
+}
+
+int WaypointTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : waypoints.size();
+}
+
+int WaypointTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant WaypointTableModel::data(const QModelIndex& index, int role) const
+{
+    Waypoint* wp = getWaypoint(index.row());
+    if (!wp)
+        return QVariant();
+
+    bool current = (type == VIEW_ONLY && currentSeq >= 0) ? (index.row() == currentSeq) : wp->getCurrent();
+
+    if (role == Qt::FontRole && current)
+    {
+        QFont font;
+        font.setBold(true);
+        return font;
+    }
+
+    if (role == Qt::CheckStateRole)
+    {
+        if (index.column() == COLUMN_CURRENT)
+            return current ? Qt::Checked : Qt::Unchecked;
+        if (index.column() == COLUMN_AUTOCONTINUE)
+            return wp->getAutoContinue() ? Qt::Checked : Qt::Unchecked;
+        return QVariant();
+    }
+
+    if (role != Qt::DisplayRole && role != Qt::EditRole && role != Qt::ToolTipRole)
+        return QVariant();
+
+    bool global = (wp->getFrame() == MAV_FRAME_GLOBAL || wp->getFrame() == MAV_FRAME_GLOBAL_RELATIVE_ALT);
+
+    switch (index.column())
+    {
+    case COLUMN_SEQ:
+        return wp->getId();
+    case COLUMN_COMMAND:
+        if (role == Qt::EditRole)
+            return (int)wp->getAction();
+        return getCommandName(wp->getAction());
+    case COLUMN_FRAME:
+        if (role == Qt::EditRole)
+            return (int)wp->getFrame();
+        return getFrameName(wp->getFrame());
+    case COLUMN_PARAM1:
+        return wp->getParam1();
+    case COLUMN_PARAM2:
+        return wp->getParam2();
+    case COLUMN_PARAM3:
+        return wp->getParam3();
+    case COLUMN_PARAM4:
+        return wp->getParam4();
+    case COLUMN_X:
+        if (role == Qt::EditRole)
+            return wp->getX();
+        return QString::number(wp->getX(), 'f', global ? 7 : 2);
+    case COLUMN_Y:
+        if (role == Qt::EditRole)
+            return wp->getY();
+        return QString::number(wp->getY(), 'f', global ? 7 : 2);
+    case COLUMN_Z:
+        if (role == Qt::EditRole)
+            return wp->getZ();
+        return QString::number(wp->getZ(), 'f', 2);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant WaypointTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Vertical)
+        return section;
+
+    switch (section)
+    {
+    case COLUMN_SEQ:
+        return tr("#");
+    case COLUMN_CURRENT:
+        return tr("Current");
+    case COLUMN_COMMAND:
+        return tr("Command");
+    case COLUMN_FRAME:
+        return tr("Frame");
+    case COLUMN_PARAM1:
+        return tr("Param 1");
+    case COLUMN_PARAM2:
+        return tr("Param 2");
+    case COLUMN_PARAM3:
+        return tr("Param 3");
+    case COLUMN_PARAM4:
+        return tr("Param 4");
+    case COLUMN_X:
+        return tr("Lat/X");
+    case COLUMN_Y:
+        return tr("Lon/Y");
+    case COLUMN_Z:
+        return tr("Alt/Z");
+    case COLUMN_AUTOCONTINUE:
+        return tr("Auto");
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags WaypointTableModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+
+    Qt::ItemFlags flags = Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+
+    if (index.column() == COLUMN_CURRENT)
+        return flags | Qt::ItemIsUserCheckable;
+
+    if (type == VIEW_ONLY)
+        return flags;
+
+    if (index.column() == COLUMN_AUTOCONTINUE)
+        return flags | Qt::ItemIsUserCheckable;
+    if (index.column() != COLUMN_SEQ)
+        return flags | Qt::ItemIsEditable;
+    return flags;
+}
+
+bool WaypointTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    Waypoint* wp = getWaypoint(index.row());
+    if (!wp || !wpm)
+        return false;
+
+    if (role == Qt::CheckStateRole)
+    {
+        bool checked = (value.toInt() == Qt::Checked);
+        if (index.column() == COLUMN_CURRENT)
+        {
+            // There is always exactly one current waypoint, it can only be moved
+            if (!checked)
+                return false;
+            if (type == VIEW_ONLY)
+                return wpm->getUAS() && wpm->setCurrentWaypoint(wp->getId()) == 0;
+            return wpm->setCurrentEditable(wp->getId()) == 0;
+        }
+        if (index.column() == COLUMN_AUTOCONTINUE && type == EDITABLE)
+        {
+            wp->setAutocontinue(checked);
+            return true;
+        }
+        return false;
+    }
+
+    if (role != Qt::EditRole || type != EDITABLE)
+        return false;
+
+    // The waypoint announces the change, the model answers with dataChanged()
+    switch (index.column())
+    {
+    case COLUMN_COMMAND:
+        wp->setAction(value.toInt());
+        return true;
+    case COLUMN_FRAME:
+        wp->setFrame((MAV_FRAME)value.toInt());
+        return true;
+    case COLUMN_PARAM1:
+        wp->setParam1(value.toDouble());
+        return true;
+    case COLUMN_PARAM2:
+        wp->setParam2(value.toDouble());
+        return true;
+    case COLUMN_PARAM3:
+        wp->setParam3(value.toDouble());
+        return true;
+    case COLUMN_PARAM4:
+        wp->setParam4(value.toDouble());
+        return true;
+    case COLUMN_X:
+        wp->setParam5(value.toDouble());
+        return true;
+    case COLUMN_Y:
+        wp->setParam6(value.toDouble());
+        return true;
+    case COLUMN_Z:
+        wp->setParam7(value.toDouble());
+        return true;
+    default:
+        return false;
+    }
+}
+
+void WaypointTableModel::managerRowsInserted(int first, int last)
+{
+    const QList<Waypoint*>& list = managerList();
+    // Out of step with the manager, fall back to a full compare
+    if (first > waypoints.size() || last >= list.size() || last < first)
+    {
+        managerListChanged();
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), first, last);
+    for (int i = first; i <= last; i++)
+    {
+        waypoints.insert(i, list.at(i));
+    }
+    endInsertRows();
+}
+
+void WaypointTableModel::managerRowsRemoved(int first, int last)
+{
+    if (first < 0 || last >= waypoints.size() || last < first)
+    {
+        managerListChanged();
+        return;
+    }
+
+    beginRemoveRows(QModelIndex(), first, last);
+    for (int i = last; i >= first; i--)
+    {
+        waypoints.removeAt(i);
+    }
+    endRemoveRows();
+}
+
+void WaypointTableModel::managerRowMoved(int from, int to)
+{
+    if (from < 0 || to < 0 || from >= waypoints.size() || to >= waypoints.size() || from == to)
+    {
+        managerListChanged();
+        return;
+    }
+
+    // Qt wants the row the item ends up in front of, before the move
+    int destination = (to > from) ? to + 1 : to;
+    if (!beginMoveRows(QModelIndex(), from, from, QModelIndex(), destination))
+    {
+        managerListChanged();
+        return;
+    }
+    waypoints.move(from, to);
+    endMoveRows();
+}
+
+void WaypointTableModel::managerListChanged()
+{
+    // Row notifications already brought the mirror in sync in most cases,
+    // comparing the pointers is cheap compared to a reset of the views
+    const QList<Waypoint*>& list = managerList();
+    if (waypoints == list)
+        return;
+
+    beginResetModel();
+    waypoints = list;
+    if (currentSeq >= waypoints.size())
+        currentSeq = -1;
+    endResetModel();
+}
+
+void WaypointTableModel::managerWaypointChanged(int uasid, Waypoint* wp)
+{
+    Q_UNUSED(uasid);
+    // Ids beyond the mirror belong to waypoints that are about to be inserted
+    if (!wp || wp->getId() >= waypoints.size())
+        return;
+
+    int row = getRow(wp);
+    if (row < 0)
+        return;
+    emit dataChanged(index(row, 0), index(row, COLUMN_COUNT - 1));
+}
+
+void WaypointTableModel::managerCurrentChanged(quint16 seq)
+{
+    currentSeq = seq;
+    if (!waypoints.isEmpty())
+    {
+        emit dataChanged(index(0, 0), index(waypoints.size() - 1, COLUMN_COUNT - 1));
+    }
+}
+
+QList<int> WaypointTableModel::getCommands()
+{
+    static QList<int> commands;
+    if (commands.isEmpty())
+    {
+        commands << MAV_CMD_NAV_WAYPOINT
+                 << MAV_CMD_NAV_TAKEOFF
+                 << MAV_CMD_NAV_LOITER_UNLIM
+                 << MAV_CMD_NAV_LOITER_TIME
+                 << MAV_CMD_NAV_LOITER_TURNS
+                 << MAV_CMD_NAV_RETURN_TO_LAUNCH
+                 << MAV_CMD_NAV_LAND
+                 << MAV_CMD_CONDITION_DELAY
+                 << MAV_CMD_DO_JUMP;
+    }
+    return commands;
+}
+
+QString WaypointTableModel::getCommandName(int command)
+{
+    switch (command)
+    {
+    case MAV_CMD_NAV_WAYPOINT:
+        return tr("NAV: Waypoint");
+    case MAV_CMD_NAV_TAKEOFF:
+        return tr("NAV: TakeOff");
+    case MAV_CMD_NAV_LOITER_UNLIM:
+        return tr("NAV: Loiter Unlim.");
+    case MAV_CMD_NAV_LOITER_TIME:
+        return tr("NAV: Loiter Time");
+    case MAV_CMD_NAV_LOITER_TURNS:
+        return tr("NAV: Loiter Turns");
+    case MAV_CMD_NAV_RETURN_TO_LAUNCH:
+        return tr("NAV: Ret. to Launch");
+    case MAV_CMD_NAV_LAND:
+        return tr("NAV: Land");
+    case MAV_CMD_CONDITION_DELAY:
+        return tr("IF: Delay over");
+    case MAV_CMD_DO_JUMP:
+        return tr("DO: Jump to Index");
+    default:
+        return tr("Other (%1)").arg(command);
+    }
+}
+
+QList<int> WaypointTableModel::getFrames()
+{
+    static QList<int> frames;
+    if (frames.isEmpty())
+    {
+        frames << MAV_FRAME_GLOBAL
+               << MAV_FRAME_GLOBAL_RELATIVE_ALT
+               << MAV_FRAME_LOCAL_NED
+               << MAV_FRAME_MISSION;
+    }
+    return frames;
+}
+
+QString WaypointTableModel::getFrameName(int frame)
+{
+    switch (frame)
+    {
+    case MAV_FRAME_GLOBAL:
+        return tr("Global/Abs. Alt");
+    case MAV_FRAME_GLOBAL_RELATIVE_ALT:
+        return tr("Global/Rel. Alt");
+    case MAV_FRAME_LOCAL_NED:
+        return tr("Local(NED)");
+    case MAV_FRAME_MISSION:
+        return tr("Mission");
+    default:
+        return tr("Frame %1").arg(frame);
+    }
+}
@@ -0,0 +1,115 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Table model of the editable or the onboard waypoint list
+ */
+
+#ifndef WAYPOINTTABLEMODEL_H
+#define WAYPOINTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QPointer>
+#include "Waypoint.h"
+
+class UASWaypointManager;
+
+/**
+ * Mirrors one waypoint list of a UASWaypointManager. Single items that are
+ * added, removed or moved arrive as row notifications, so the views only
+ * touch the affected rows. A plain list change (read from the MAV, file
+ * load, clear) resets the model once. Views ask for the visible rows only,
+ * the model itself creates no widgets.
+ */
+class WaypointTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum ListType {
+        EDITABLE,
+        VIEW_ONLY
+    };
+
+    enum Column {
+        COLUMN_SEQ,
+        COLUMN_CURRENT,
+        COLUMN_COMMAND,
+        COLUMN_FRAME,
+        COLUMN_PARAM1,
+        COLUMN_PARAM2,
+        COLUMN_PARAM3,
+        COLUMN_PARAM4,
+        COLUMN_X,
+        COLUMN_Y,
+        COLUMN_Z,
+        COLUMN_AUTOCONTINUE,
+        COLUMN_COUNT
+    };
+
+    explicit WaypointTableModel(ListType type, QObject* parent = 0);
+
+    /** @brief Follow the list of this manager, NULL detaches the model */
+    void setWaypointManager(UASWaypointManager* wpm);
+    UASWaypointManager* getWaypointManager() const { return wpm; }
+    ListType getListType() const { return type; }
+
+    /** @brief Waypoint shown in a row, NULL if the row does not exist */
+    Waypoint* getWaypoint(int row) const;
+    /** @brief Row of a waypoint, -1 if it is not in the list */
+    int getRow(Waypoint* wp) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+    Qt::ItemFlags flags(const QModelIndex& index) const;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
+
+    /** @brief Commands offered by the editors, in display order */
+    static QList<int> getCommands();
+    static QString getCommandName(int command);
+    /** @brief Frames offered by the editors, in display order */
+    static QList<int> getFrames();
+    static QString getFrameName(int frame);
+
+protected slots:
+    void managerRowsInserted(int first, int last);
+    void managerRowsRemoved(int first, int last);
+    void managerRowMoved(int from, int to);
+    /** @brief Reset if the list changed without a row notification */
+    void managerListChanged();
+    void managerWaypointChanged(int uasid, Waypoint* wp);
+    /** @brief The MAV reports a new current waypoint */
+    void managerCurrentChanged(quint16 seq);
+
+protected:
+    const QList<Waypoint*>& managerList() const;
+
+    ListType type;
+    QPointer<UASWaypointManager> wpm;
+    QList<Waypoint*> waypoints;     ///< Rows as last announced, only dereferenced while in sync
+    int currentSeq;                 ///< Current waypoint reported by the MAV, -1 if none
+};
+
+#endif // WAYPOINTTABLEMODEL_H
@@ -0,0 +1,338 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Incremental ellipsoid fit of magnetometer samples
+ */
+
+#include "CompassCalibrator.h"
+
+#include <QMutexLocker>
+#include <qmath.h>
+#include <string.h>
+
+namespace
+{
+/** @brief Solve a * x = b by Gaussian elimination with partial pivoting, a and b are destroyed */
+bool solveLinear(double a[CompassCalibrator::PARAMETERS][CompassCalibrator::PARAMETERS],
+                 double b[CompassCalibrator::PARAMETERS], double x[CompassCalibrator::PARAMETERS])
+{
+    const int n = CompassCalibrator::PARAMETERS;
+    for (int col = 0; col < n; col++)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < n; row++)
+        {
+            if (qAbs(a[row][col]) > qAbs(a[pivot][col])) pivot = row;
+        }
+        if (qAbs(a[pivot][col]) < 1e-12) return false;
+        if (pivot != col)
+        {
+            for (int k = 0; k < n; k++) qSwap(a[col][k], a[pivot][k]);
+            qSwap(b[col], b[pivot]);
+        }
+        for (int row = col + 1; row < n; row++)
+        {
+            double factor = a[row][col] / a[col][col];
+            for (int k = col; k < n; k++) a[row][k] -= factor * a[col][k];
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = n - 1; row >= 0; row--)
+    {
+        double value = b[row];
+        for (int k = row + 1; k < n; k++) value -= a[row][k] * x[k];
+        x[row] = value / a[row][row];
+    }
+    return true;
+}
+
+/** @brief Eigenvalues and eigenvectors (columns of v) of a symmetric 3x3 matrix, Jacobi rotations */
+void eigenSymmetric(const double m[3][3], double values[3], double v[3][3])
+{
+    double a[3][3];
+    memcpy(a, m, sizeof(a));
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+
+    for (int sweep = 0; sweep < 50; sweep++)
+    {
+        double off = qAbs(a[0][1]) + qAbs(a[0][2]) + qAbs(a[1][2]);
+        if (off < 1e-15) break;
+        for (int p = 0; p < 2; p++)
+        {
+            for (int q = p + 1; q < 3; q++)
+            {
+                if (qAbs(a[p][q]) < 1e-18) continue;
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (qAbs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+                for (int k = 0; k < 3; k++)
+                {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; k++)
+                {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) values[i] = a[i][i];
+}
+}
+
+CompassCalibrator::Result::Result() :
+    valid(false),
+    samples(0),
+    radius(0.0),
+    residual(0.0),
+    coverage(0.0)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        offsets[i] = 0.0;
+        for (int j = 0; j < 3; j++) softIron[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+}
+
+CompassCalibrator::CompassCalibrator(QObject* parent) :
+    QObject(parent),
+    bins(COVERAGE_BANDS * COVERAGE_SECTORS)
+{
+    qRegisterMetaType<CompassCalibrator::Result>("CompassCalibrator::Result");
+    reset();
+}
+
+void CompassCalibrator::reset()
+{
+    QMutexLocker locker(&mutex);
+    scale = 0.0;
+    memset(normal, 0, sizeof(normal));
+    memset(rhs, 0, sizeof(rhs));
+    targetSquares = 0.0;
+    memset(sum, 0, sizeof(sum));
+    samples = 0;
+    sinceSolve = 0;
+    bins.fill(false);
+    result = Result();
+}
+
+CompassCalibrator::Result CompassCalibrator::getResult()
+{
+    QMutexLocker locker(&mutex);
+    return result;
+}
+
+void CompassCalibrator::addSample(double x, double y, double z)
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (scale == 0.0)
+        {
+            // Keeps the normal equations well conditioned whatever the units are
+            scale = qMax(1e-6, sqrt(x * x + y * y + z * z));
+        }
+        x /= scale;
+        y /= scale;
+        z /= scale;
+
+        // a(x2-z2) + b(y2-z2) + 2dxy + 2exz + 2fyz + 2gx + 2hy + 2iz + j = -3z2,
+        // the quadric with trace(A) = 3, valid wherever the origin is
+        const double d[PARAMETERS] = { x * x - z * z, y * y - z * z, 2 * x * y, 2 * x * z, 2 * y * z,
+                                       2 * x, 2 * y, 2 * z, 1.0 };
+        const double t = -3.0 * z * z;
+        for (int i = 0; i < PARAMETERS; i++)
+        {
+            for (int j = i; j < PARAMETERS; j++) normal[i][j] += d[i] * d[j];
+            rhs[i] += d[i] * t;
+        }
+        targetSquares += t * t;
+        sum[0] += x;
+        sum[1] += y;
+        sum[2] += z;
+        samples++;
+        sinceSolve++;
+
+        // Direction seen from the best center known now
+        double v[3];
+        if (result.valid)
+        {
+            double raw[3] = { x * scale, y * scale, z * scale };
+            correct(result, raw, v);
+        }
+        else
+        {
+            v[0] = x - sum[0] / samples;
+            v[1] = y - sum[1] / samples;
+            v[2] = z - sum[2] / samples;
+        }
+        int bin = coverageBin(v[0], v[1], v[2]);
+        if (bin >= 0) bins.setBit(bin);
+    }
+
+    if (sinceSolve >= SOLVE_INTERVAL)
+    {
+        update();
+    }
+}
+
+void CompassCalibrator::update()
+{
+    Result current;
+    {
+        QMutexLocker locker(&mutex);
+        sinceSolve = 0;
+        Result fitted = result;
+        fitted.samples = samples;
+        fitted.coverage = (double)bins.count(true) / bins.size();
+        if (samples >= MIN_SAMPLES && solve(fitted))
+        {
+            fitted.valid = true;
+        }
+        result = fitted;
+        current = result;
+    }
+    emit resultChanged(current);
+}
+
+bool CompassCalibrator::solve(Result& fit) const
+{
+    double a[PARAMETERS][PARAMETERS];
+    double b[PARAMETERS];
+    double p[PARAMETERS];
+    for (int i = 0; i < PARAMETERS; i++)
+    {
+        for (int j = 0; j < PARAMETERS; j++) a[i][j] = (j >= i) ? normal[i][j] : normal[j][i];
+        b[i] = rhs[i];
+    }
+    if (!solveLinear(a, b, p)) return false;
+
+    const double A[3][3] = {
+        { p[0], p[2], p[3] },
+        { p[2], p[1], p[4] },
+        { p[3], p[4], 3.0 - p[0] - p[1] }
+    };
+
+    // Center c = -A^-1 g
+    double det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+               - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+               + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+    if (qAbs(det) < 1e-12) return false;
+    double inv[3][3];
+    inv[0][0] =  (A[1][1] * A[2][2] - A[1][2] * A[2][1]) / det;
+    inv[0][1] = -(A[0][1] * A[2][2] - A[0][2] * A[2][1]) / det;
+    inv[0][2] =  (A[0][1] * A[1][2] - A[0][2] * A[1][1]) / det;
+    inv[1][0] = inv[0][1];
+    inv[1][1] =  (A[0][0] * A[2][2] - A[0][2] * A[2][0]) / det;
+    inv[1][2] = -(A[0][0] * A[1][2] - A[0][2] * A[1][0]) / det;
+    inv[2][0] = inv[0][2];
+    inv[2][1] = inv[1][2];
+    inv[2][2] =  (A[0][0] * A[1][1] - A[0][1] * A[1][0]) / det;
+
+    const double g[3] = { p[5], p[6], p[7] };
+    double center[3];
+    for (int i = 0; i < 3; i++)
+    {
+        center[i] = -(inv[i][0] * g[0] + inv[i][1] * g[1] + inv[i][2] * g[2]);
+    }
+
+    // (m - c)^T A (m - c) = k
+    double k = -p[8];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            k += center[i] * A[i][j] * center[j];
+    if (qAbs(k) < 1e-12) return false;
+
+    double M[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            M[i][j] = A[i][j] / k;
+
+    double values[3];
+    double V[3][3];
+    eigenSymmetric(M, values, V);
+    if (values[0] <= 0.0 || values[1] <= 0.0 || values[2] <= 0.0) return false;
+
+    // Geometric mean of the semi axes, the soft iron matrix keeps the volume
+    double radius = pow(values[0] * values[1] * values[2], -1.0 / 6.0);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            double value = 0.0;
+            for (int e = 0; e < 3; e++) value += V[i][e] * sqrt(values[e]) * V[j][e];
+            fit.softIron[i][j] = radius * value;
+        }
+    }
+
+    // Algebraic residual e = k((m-c)^T M (m-c) - 1), about 2k times the relative radial error
+    double ssr = targetSquares;
+    for (int i = 0; i < PARAMETERS; i++)
+    {
+        double np = 0.0;
+        for (int j = 0; j < PARAMETERS; j++) np += ((j >= i) ? normal[i][j] : normal[j][i]) * p[j];
+        ssr += p[i] * np - 2.0 * p[i] * rhs[i];
+    }
+    fit.residual = sqrt(qMax(0.0, ssr) / samples) / (2.0 * qAbs(k));
+
+    for (int i = 0; i < 3; i++) fit.offsets[i] = -center[i] * scale;
+    fit.radius = radius * scale;
+    return true;
+}
+
+void CompassCalibrator::correct(const Result& result, const double raw[3], double corrected[3])
+{
+    double m[3];
+    for (int i = 0; i < 3; i++) m[i] = raw[i] + result.offsets[i];
+    for (int i = 0; i < 3; i++)
+    {
+        corrected[i] = result.softIron[i][0] * m[0] + result.softIron[i][1] * m[1] + result.softIron[i][2] * m[2];
+    }
+}
+
+int CompassCalibrator::coverageBin(double x, double y, double z)
+{
+    double norm = sqrt(x * x + y * y + z * z);
+    if (norm <= 0.0) return -1;
+    // Bands of equal height in z have equal area on the sphere
+    int band = qBound(0, (int)((z / norm + 1.0) * 0.5 * COVERAGE_BANDS), COVERAGE_BANDS - 1);
+    int sector = qBound(0, (int)((atan2(y, x) + M_PI) / (2.0 * M_PI) * COVERAGE_SECTORS), COVERAGE_SECTORS - 1);
+    return band * COVERAGE_SECTORS + sector;
+}
@@ -0,0 +1,113 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+
+/**
+ * @file
+ *   @brief Incremental ellipsoid fit of magnetometer samples
+ */
+
+#ifndef COMPASSCALIBRATOR_H
+#define COMPASSCALIBRATOR_H
+
+#include <QObject>
+#include <QBitArray>
+#include <QMetaType>
+#include <QMutex>
+
+/**
+ * Fits an ellipsoid to magnetometer samples while they arrive. Every sample
+ * is added to the normal equations of a linear least squares fit of a
+ * general quadric (trace constrained), so the memory needed does not grow
+ * with the number of samples and a solution is available at any time.
+ *
+ * The ellipsoid gives the hard iron offsets and a symmetric soft iron
+ * matrix with determinant 1, so corrected = softIron * (raw + offsets)
+ * lies on a sphere of the field strength. The residual and the part of
+ * the sphere the samples were taken from tell the user when to stop.
+ *
+ * Meant to live in a worker thread, the samples come in through the
+ * addSample() slot and the results go out through resultChanged().
+ */
+class CompassCalibrator : public QObject
+{
+    Q_OBJECT
+public:
+    enum {
+        PARAMETERS = 9,         ///< Unknowns of the quadric
+        COVERAGE_BANDS = 8,     ///< Equal area bands from pole to pole
+        COVERAGE_SECTORS = 16,  ///< Sectors per band
+        MIN_SAMPLES = 20,       ///< Samples needed before a fit is attempted
+        SOLVE_INTERVAL = 10     ///< Samples between two fits
+    };
+
+    struct Result {
+        Result();
+        bool valid;
+        int samples;
+        double offsets[3];      ///< Added to the raw field, as COMPASS_OFS_X/Y/Z
+        double softIron[3][3];  ///< Applied after the offsets
+        double radius;          ///< Field strength after the correction
+        double residual;        ///< RMS deviation from the ellipsoid relative to its radius
+        double coverage;        ///< Part of the sphere directions seen, 0..1
+    };
+
+    explicit CompassCalibrator(QObject* parent = 0);
+
+    /** @brief Latest result, thread safe */
+    Result getResult();
+
+    /** @brief Apply a result to a raw sample */
+    static void correct(const Result& result, const double raw[3], double corrected[3]);
+
+public slots:
+    /** @brief Forget all samples */
+    void reset();
+    /** @brief Add one raw magnetometer sample */
+    void addSample(double x, double y, double z);
+    /** @brief Fit the samples added so far and emit the result */
+    void update();
+
+signals:
+    void resultChanged(const CompassCalibrator::Result& result);
+
+protected:
+    /** @brief Solve the normal equations, false if the samples do not describe an ellipsoid */
+    bool solve(Result& result) const;
+    /** @brief Coverage bin of a direction */
+    static int coverageBin(double x, double y, double z);
+
+    QMutex mutex;
+    double scale;               ///< Samples are divided by this, the norm of the first one
+    double normal[PARAMETERS][PARAMETERS];  ///< Sum of d * d^T
+    double rhs[PARAMETERS];     ///< Sum of d * t
+    double targetSquares;       ///< Sum of t^2
+    double sum[3];              ///< Sum of the scaled samples, for the centroid
+    int samples;
+    int sinceSolve;
+    QBitArray bins;             ///< Directions seen from the current center
+    Result result;
+};
+
+Q_DECLARE_METATYPE(CompassCalibrator::Result)
+
+#endif // COMPASSCALIBRATOR_H
@@ -25,14 +25,33 @@ This file is part of the APM_PLANNER project
 #include <qmath.h>
 #include "QGCCore.h"
 
+namespace
+{
+const int kCalibrationSeconds = 60;
+// The calibration finishes early once the fit is this good
+const double kDoneCoverage = 0.9;
+const double kDoneResidual = 0.02;
+}
+
 CompassConfig::CompassConfig(QWidget *parent) : AP2ConfigWidget(parent),
     m_progressDialog(NULL),
     m_timer(NULL),
-    m_rawImuList(),
+    m_calibrator(NULL),
+    m_calibrationSeconds(0),
+    m_calibrating(false),
     m_allOffsetsSet(0)
 {
     ui.setupUi(this);
 
+    // The fit runs next to the GUI, samples and results are queued across
+    m_calibrator = new CompassCalibrator();
+    m_calibrator->moveToThread(&m_calibrationThread);
+    connect(this, SIGNAL(magSample(double,double,double)),
+            m_calibrator, SLOT(addSample(double,double,double)), Qt::QueuedConnection);
+    connect(m_calibrator, SIGNAL(resultChanged(CompassCalibrator::Result)),
+            this, SLOT(calibrationUpdate(CompassCalibrator::Result)), Qt::QueuedConnection);
+    m_calibrationThread.start(QThread::LowPriority);
+
     QList<QWidget*> widgetList = this->findChildren<QWidget*>();
     for (int i=0;i<widgetList.size();i++)
     {
@@ -134,7 +153,9 @@ CompassConfig::~CompassConfig()
 {
     delete m_timer;
     delete m_progressDialog;
-    m_rawImuList.clear();
+    m_calibrationThread.quit();
+    m_calibrationThread.wait();
+    delete m_calibrator;
 }
 
 void CompassConfig::parameterChanged(int uas, int component, QString parameterName, QVariant value)
@@ -296,7 +317,8 @@ void CompassConfig::liveCalibrationClicked()
     }
 
     QMessageBox::information(this,tr("Live Compass calibration"),
-                             tr("Data will be collected for 60 seconds, Please click ok and move the apm around all axises"));
+                             tr("Data will be collected for up to 60 seconds, Please click ok and move the apm around all axises. "
+                                "The calibration finishes as soon as enough directions have been seen."));
 
     QGCUASParamManager* pm = m_uas->getParamManager();
     if ((pm->getParameterValue(1, "COMPASS_OFS_X") != 0.0f)
@@ -320,7 +342,15 @@ void CompassConfig::startDataCollection()
                 this, SLOT(sensorUpdateMessage(UASInterface*,mavlink_sensor_offsets_t)));
      m_uas->enableRawSensorDataTransmission(10);
 
-    m_progressDialog = new QProgressDialog(tr("Compass calibration in progress. Please rotate your craft around all its axes for 60 seconds."), tr("Cancel"), 0, 60);
+    // Queued behind any samples still in flight from an earlier run
+    QMetaObject::invokeMethod(m_calibrator, "reset", Qt::QueuedConnection);
+    m_calibrationSeconds = 0;
+    m_calibrating = true;
+
+    // The progress is the part of the sphere covered so far
+    m_progressDialog = new QProgressDialog(tr("Compass calibration in progress. Please rotate your craft around all its axes for 60 seconds."), tr("Cancel"), 0, 100);
+    m_progressDialog->setAutoReset(false);
+    m_progressDialog->setAutoClose(false);
     connect(m_progressDialog, SIGNAL(canceled()), this, SLOT(cancelCompassCalibration()));
     m_timer = new QTimer(this);
     connect(m_timer, SIGNAL(timeout()), this, SLOT(progressCounter()));
@@ -329,10 +359,9 @@ void CompassConfig::startDataCollection()
 
 void CompassConfig::progressCounter()
 {
-
-    int newValue = m_progressDialog->value()+1;
-    m_progressDialog->setValue(newValue);
-    if (newValue < 60) {
+    if (!m_calibrating) return;
+    m_calibrationSeconds++;
+    if (m_calibrationSeconds < kCalibrationSeconds) {
         m_timer->start(1000);
     } else {
         finishCompassCalibration();
@@ -350,43 +379,79 @@ void CompassConfig::cancelCompassCalibration()
 
 void CompassConfig::cleanup()
 {
-    if (m_timer) m_timer->stop();
-    delete m_timer;
-    m_rawImuList.clear();
-    delete m_progressDialog;
+    m_calibrating = false;
+    // The dialog may be the sender of the signal being handled
+    if (m_timer) {
+        m_timer->stop();
+        m_timer->deleteLater();
+        m_timer = 0;
+    }
+    if (m_progressDialog) {
+        m_progressDialog->deleteLater();
+        m_progressDialog = 0;
+    }
+}
+
+void CompassConfig::calibrationUpdate(const CompassCalibrator::Result& result)
+{
+    // Results of the final fit arrive after the calibration was finished or cancelled
+    if (!m_calibrating || !m_progressDialog) return;
+
+    m_progressDialog->setValue(qRound(result.coverage * 100.0));
+    QString text = tr("Compass calibration in progress. Please rotate your craft around all its axes.\n\n"
+                      "Samples: %1\nSphere covered: %2%").arg(result.samples).arg(qRound(result.coverage * 100.0));
+    if (result.valid) {
+        text += tr("\nFit residual: %1%").arg(result.residual * 100.0, 0, 'f', 1);
+    }
+    m_progressDialog->setLabelText(text);
+
+    if (result.valid && result.coverage >= kDoneCoverage && result.residual < kDoneResidual) {
+        QLOG_INFO() << "Compass calibration complete after" << m_calibrationSeconds << "s";
+        finishCompassCalibration();
+    }
 }
 
 void CompassConfig::finishCompassCalibration()
 {
-    QLOG_INFO() << "finishCompassCalibration with " << m_rawImuList.count() << " data points";
+    if (!m_calibrating) return;
+    // From here on, late results and timer ticks are ignored
+    m_calibrating = false;
     disconnect(m_uas, SIGNAL(rawImuMessageUpdate(UASInterface*,mavlink_raw_imu_t)),
                 this, SLOT(rawImuMessageUpdate(UASInterface*,mavlink_raw_imu_t)));
     m_uas->enableRawSensorDataTransmission(2);
-    m_timer->stop();
+    if (m_timer) m_timer->stop();
 
-    // Now calulate the offsets
+    // Fit everything queued so far, the worker is idle apart from that
+    QMetaObject::invokeMethod(m_calibrator, "update", Qt::BlockingQueuedConnection);
+    CompassCalibrator::Result result = m_calibrator->getResult();
+    QLOG_INFO() << "finishCompassCalibration with " << result.samples << " data points";
 
-    if (m_rawImuList.count() < 10) {
+    if (result.samples < 10) {
         QLOG_ERROR() << "Not enough data points for calculation:" ;
+        cleanup();
         QMessageBox::warning(this, tr("Compass Calibration Failed"), tr("Not enough data points to calibrate the compass."));
         return;
     }
+    if (!result.valid) {
+        QLOG_ERROR() << "Compass samples do not describe an ellipsoid";
+        cleanup();
+        QMessageBox::warning(this, tr("Compass Calibration Failed"), tr("The compass data could not be fitted. Please rotate the craft around all its axes and try again."));
+        return;
+    }
 
-    // Calculate and send the update message
-    alglib::real_1d_array* answer = leastSq(&m_rawImuList);
-    saveOffsets(*answer);
-    delete answer;
+    saveOffsets(result);
 }
 
-void CompassConfig::saveOffsets(alglib::real_1d_array& ofs)
+void CompassConfig::saveOffsets(const CompassCalibrator::Result& result)
 {
-    float xOffset = static_cast<float>(ofs[0]);
-    float yOffset = static_cast<float>(ofs[1]);
-    float zOffset = static_cast<float>(ofs[2]);
+    float xOffset = static_cast<float>(result.offsets[0]);
+    float yOffset = static_cast<float>(result.offsets[1]);
+    float zOffset = static_cast<float>(result.offsets[2]);
 
     QLOG_INFO() << "New Mag Offset to be set are: " << xOffset
                 << ", " <<  yOffset
-                << ", " <<  zOffset;
+                << ", " <<  zOffset
+                << " residual " << result.residual << " coverage " << result.coverage;
 
     QGCUASParamManager* paramMgr = m_uas->getParamManager();
 
@@ -396,11 +461,29 @@ void CompassConfig::saveOffsets(alglib::real_1d_array& ofs)
     paramMgr->setParameter(1, "COMPASS_OFS_Y", yOffset);
     paramMgr->setParameter(1, "COMPASS_OFS_Z", zOffset);
 
+    // Only firmware with soft iron support has the diagonal and off diagonal terms
+    QVariant value;
+    bool softIron = paramMgr->getParameterValue(1, "COMPASS_DIA_X", value);
+    if (softIron) {
+        paramMgr->setParameter(1, "COMPASS_DIA_X", static_cast<float>(result.softIron[0][0]));
+        paramMgr->setParameter(1, "COMPASS_DIA_Y", static_cast<float>(result.softIron[1][1]));
+        paramMgr->setParameter(1, "COMPASS_DIA_Z", static_cast<float>(result.softIron[2][2]));
+        paramMgr->setParameter(1, "COMPASS_ODI_X", static_cast<float>(result.softIron[0][1]));
+        paramMgr->setParameter(1, "COMPASS_ODI_Y", static_cast<float>(result.softIron[0][2]));
+        paramMgr->setParameter(1, "COMPASS_ODI_Z", static_cast<float>(result.softIron[1][2]));
+    }
+
     cleanup();
 
-    QMessageBox::information(this, tr("New Mag Offsets"), tr("New offsets are \n\nx:") + QString::number(xOffset,'f',3)
-                             + " y:" + QString::number(yOffset,'f',3) + " z:" + QString::number(zOffset,'f',3)
-                             + tr("\n\nThese have been saved for you."));
+    QString text = tr("New offsets are \n\nx:") + QString::number(xOffset,'f',3)
+            + " y:" + QString::number(yOffset,'f',3) + " z:" + QString::number(zOffset,'f',3)
+            + tr("\n\nFit residual: %1% of the field, %2% of the sphere covered")
+              .arg(result.residual * 100.0, 0, 'f', 1).arg(qRound(result.coverage * 100.0));
+    if (softIron) {
+        text += tr("\nSoft iron correction saved as well.");
+    }
+    text += tr("\n\nThese have been saved for you.");
+    QMessageBox::information(this, tr("New Mag Offsets"), text);
 }
 
 
@@ -413,12 +496,9 @@ void CompassConfig::rawImuMessageUpdate(UASInterface* uas, mavlink_raw_imu_t raw
             m_oldymag != rawImu.ymag &&
             m_oldzmag != rawImu.zmag)
         {
-            RawImuTuple value;
-            value.magX = rawImu.xmag - (float)m_sensorOffsets.mag_ofs_x;
-            value.magY = rawImu.ymag - (float)m_sensorOffsets.mag_ofs_y;
-            value.magZ = rawImu.zmag - (float)m_sensorOffsets.mag_ofs_z;
-
-            m_rawImuList.append(value);
+            emit magSample(rawImu.xmag - (float)m_sensorOffsets.mag_ofs_x,
+                           rawImu.ymag - (float)m_sensorOffsets.mag_ofs_y,
+                           rawImu.zmag - (float)m_sensorOffsets.mag_ofs_z);
 
             m_oldxmag = rawImu.xmag;
             m_oldymag = rawImu.ymag;
@@ -433,58 +513,3 @@ void CompassConfig::sensorUpdateMessage(UASInterface* uas, mavlink_sensor_offset
         m_sensorOffsets = sensorOffsets;
     }
 }
-
-/// <summary>
-/// Does the least sq adjustment to find the center of the sphere
-/// </summary>
-/// <param name="data">list of x,y,z data</param>
-/// <returns>offsets</returns>
-///
-
-alglib::real_1d_array* CompassConfig::leastSq(QVector<RawImuTuple> *data)
-{
-    {
-    using namespace alglib;
-
-        real_1d_array* x = new real_1d_array("[0.0 , 0.0 , 0.0 , 0.0]");
-        double epsg = 0.0000000001;
-        double epsf = 0;
-        double epsx = 0;
-        int maxits = 0;
-        alglib::minlmstate state;
-        alglib::minlmreport rep;
-
-        alglib::minlmcreatev(data->count(), *x, 100.0f,  state);
-        alglib::minlmsetcond(state, epsg, epsf, epsx, maxits);
-        alglib::minlmoptimize(state, &CompassConfig::sphere_error, NULL, data);
-        alglib::minlmresults(state, *x, rep);
-
-        QLOG_INFO() << "rep.terminationType" << rep.terminationtype;
-//        QLOG_DEBUG() << "alglib" << alglib::ap::format(x, 2));
-
-        return x;
-
-    }
-}
-
-void CompassConfig::sphere_error(const alglib::real_1d_array &xi, alglib::real_1d_array &fi, void *obj)
-{
-    double xofs = xi[0];
-    double yofs = xi[1];
-    double zofs = xi[2];
-    double r = xi[3];
-    int a = 0;
-
-    QVector<RawImuTuple>& rawImuVector = *reinterpret_cast<QVector<RawImuTuple>*>(obj);
-
-    for(int count = 0; count < rawImuVector.count() ; count ++)
-        {
-            RawImuTuple d = rawImuVector[count];
-            double x = d.magX;
-            double y = d.magY;
-            double z = d.magZ;
-            double err = r - sqrt(pow((x + xofs), 2) + pow((y + yofs), 2) + pow((z + zofs), 2));
-            fi[a] = err;
-            a++;
-        }
-}
@@ -37,25 +37,8 @@ This file is part of the APM_PLANNER project
 #include "AP2ConfigWidget.h"
 #include <QWidget>
 #include <QProgressDialog>
-// Using alglib for least squares calc (could migrate to Eigen Lib?)
-#include "ap.h"
-#include "optimization.h"
-#include "interpolation.h"
-
-
-class RawImuTuple{
-public:
-    RawImuTuple():magX(0.0f),
-        magY(0.0f),
-        magZ(0.0f){}
-
-public:
-    float magX;
-    float magY;
-    float magZ;
-};
-
-using namespace alglib;
+#include <QThread>
+#include "CompassCalibrator.h"
 
 class CompassConfig : public AP2ConfigWidget
 {
@@ -65,7 +48,9 @@ public:
     explicit CompassConfig(QWidget *parent = 0);
     ~CompassConfig();
 
-    static void sphere_error(const alglib::real_1d_array &xi, alglib::real_1d_array &fi, void *obj);
+signals:
+    /** @brief Raw magnetometer sample for the calibrator thread */
+    void magSample(double x, double y, double z);
 
 private:
     enum CompassType {none, APM, ExternalCompass, PX4};
@@ -86,8 +71,8 @@ private slots:
     void rawImuMessageUpdate(UASInterface* uas, mavlink_raw_imu_t rawImu);
     void sensorUpdateMessage(UASInterface* uas, mavlink_sensor_offsets_t sensorOffsets);
 
-    real_1d_array* leastSq(QVector<RawImuTuple> *rawImuList);
-    void saveOffsets(real_1d_array &ofs);
+    void calibrationUpdate(const CompassCalibrator::Result& result);
+    void saveOffsets(const CompassCalibrator::Result& result);
     void degreeEditFinished();
 
     void setCompassAPMOnBoard();
@@ -101,7 +86,10 @@ private:
     Ui::CompassConfig ui;
     QPointer<QProgressDialog> m_progressDialog;
     QPointer<QTimer> m_timer;
-    QVector<RawImuTuple> m_rawImuList;
+    CompassCalibrator* m_calibrator;
+    QThread m_calibrationThread;
+    int m_calibrationSeconds;
+    bool m_calibrating; ///< Between startDataCollection() and finish or cancel
     mavlink_sensor_offsets_t m_sensorOffsets;
     double m_oldxmag;
     double m_oldymag;
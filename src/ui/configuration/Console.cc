@@ -34,32 +34,26 @@ This file is part of the APM_PLANNER project
  */
 
 #include "Console.h"
-#include "ApmHighlighter.h"
 
-#include <QScrollBar>
+#include <QKeyEvent>
+#include <QPainter>
 
 #include <QtCore/QDebug>
 
 Console::Console(QWidget *parent)
-    : QPlainTextEdit(parent)
+    : QGCTerminalView(parent)
     , localEchoEnabled(false)
+    , m_highlight("^Ardu[A-Za-z]+\\b")
 {
-    document()->setMaximumBlockCount(500);
     QPalette p = palette();
     p.setColor(QPalette::Base, Qt::black);
     p.setColor(QPalette::Text, Qt::green);
     setPalette(p);
-
-    m_highlighter = new APMHighlighter(document());
-
 }
 
 void Console::putData(const QByteArray &data)
 {
-    insertPlainText(QString(data));
-
-    QScrollBar *bar = verticalScrollBar();
-    bar->setValue(bar->maximum());
+    appendData(data);
 }
 
 void Console::setLocalEchoEnabled(bool set)
@@ -69,7 +63,17 @@ void Console::setLocalEchoEnabled(bool set)
 
 void Console::keyPressEvent(QKeyEvent *e)
 {
+    if (e->matches(QKeySequence::Copy)) {
+        QGCTerminalView::keyPressEvent(e);
+        return;
+    }
+
     switch (e->key()) {
+    case Qt::Key_PageUp:
+    case Qt::Key_PageDown:
+        // scroll the view
+        QGCTerminalView::keyPressEvent(e);
+        break;
     case Qt::Key_Backspace:
     case Qt::Key_Left:
     case Qt::Key_Right:
@@ -79,23 +83,35 @@ void Console::keyPressEvent(QKeyEvent *e)
         break;
     default:
         if (localEchoEnabled)
-            QPlainTextEdit::keyPressEvent(e);
+            appendData(e->text().toLocal8Bit());
         emit getData(e->text().toLocal8Bit());
     }
 }
 
-void Console::mousePressEvent(QMouseEvent *e)
+void Console::contextMenuEvent(QContextMenuEvent *e)
 {
     Q_UNUSED(e)
-    setFocus();
 }
 
-void Console::mouseDoubleClickEvent(QMouseEvent *e)
+void Console::drawRow(QPainter& painter, const QRect& rect, const QString& text, const QColor& color)
 {
-    Q_UNUSED(e)
-}
+    if (m_highlight.indexIn(text) != 0) {
+        QGCTerminalView::drawRow(painter, rect, text, color);
+        return;
+    }
 
-void Console::contextMenuEvent(QContextMenuEvent *e)
-{
-    Q_UNUSED(e)
+    int length = m_highlight.matchedLength();
+    QString head = text.left(length);
+    QFont bold = painter.font();
+    bold.setBold(true);
+
+    painter.save();
+    painter.setFont(bold);
+    painter.setPen(Qt::darkMagenta);
+    painter.drawText(rect.left(), rect.top() + ascent, head);
+    int x = rect.left() + QFontMetrics(bold).width(head);
+    painter.restore();
+
+    painter.setPen(color);
+    painter.drawText(x, rect.top() + ascent, text.mid(length));
 }
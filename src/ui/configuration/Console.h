@@ -36,11 +36,11 @@ This file is part of the APM_PLANNER project
 #ifndef CONSOLE_H
 #define CONSOLE_H
 
-#include <QPlainTextEdit>
+#include <QRegExp>
 
-class APMHighlighter;
+#include "QGCTerminalView.h"
 
-class Console : public QPlainTextEdit
+class Console : public QGCTerminalView
 {
     Q_OBJECT
 
@@ -56,13 +56,13 @@ public:
 
 protected:
     virtual void keyPressEvent(QKeyEvent *e);
-    virtual void mousePressEvent(QMouseEvent *e);
-    virtual void mouseDoubleClickEvent(QMouseEvent *e);
     virtual void contextMenuEvent(QContextMenuEvent *e);
+    /** @brief Highlight the ArduPilot banner lines */
+    virtual void drawRow(QPainter& painter, const QRect& rect, const QString& text, const QColor& color);
 
 private:
     bool localEchoEnabled;
-    APMHighlighter* m_highlighter;
+    QRegExp m_highlight;
 
 };
 
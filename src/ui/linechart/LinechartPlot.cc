@@ -36,6 +36,7 @@ LinechartPlot::LinechartPlot(QWidget *parent, int plotid, quint64 interval): Qwt
     lastTime(0),
     maxTime(100),
     maxInterval(MAX_STORAGE_INTERVAL),
+    memoryBudget(Q_INT64_C(1024) * 1024 * DEFAULT_MEMORY_BUDGET),
     plotPosition(0),
     timeScaleStep(DEFAULT_SCALE_INTERVAL), // 10 seconds
     automaticScrollActive(false),
@@ -300,7 +301,10 @@ void LinechartPlot::appendData(QString dataname, quint64 ms, double value)
     {
         time = QGC::groundTimeMilliseconds();
     }
-    dataset->append(time, value);
+    if (dataset->append(time, value))
+    {
+        enforceMemoryBudget();
+    }
 
     lastUpdate.insert(dataname, time);
 
@@ -320,15 +324,124 @@ void LinechartPlot::appendData(QString dataname, quint64 ms, double value)
     if (value > maxValue) maxValue = value;
     valueInterval = maxValue - minValue;
 
-    // Assign dataset to curve
-    QwtPlotCurve* curve = curves.value(dataname);
-    curve->setRawData(dataset->getPlotX(), dataset->getPlotY(), dataset->getPlotCount());
-
     //    QLOG_DEBUG() << "mintime" << minTime << "maxtime" << maxTime << "last max time" << "window position" << getWindowPosition();
 
     datalock.unlock();
 }
 
+/**
+ * @brief Copy the data points of the plot window into the curves
+ *
+ * Only the visible window is handed to the curves, decoding compressed
+ * data points when scrolling back. Called before every repaint.
+ **/
+void LinechartPlot::updateCurves()
+{
+    datalock.lock();
+    quint64 start = (plotPosition > plotInterval) ? plotPosition - plotInterval : 0;
+    QMap<QString, QwtPlotCurve*>::iterator i;
+    for(i = curves.begin(); i != curves.end(); ++i)
+    {
+        TimeSeriesData* dataset = data.value(i.key());
+        if (!dataset) continue;
+        dataset->updateWindow(start, plotPosition);
+        i.value()->setRawData(dataset->getPlotX(), dataset->getPlotY(), dataset->getPlotCount());
+    }
+    datalock.unlock();
+}
+
+/**
+ * @brief Drop the oldest compressed data points while over the memory budget
+ *
+ * The curve with the oldest block loses it first, so all curves keep about
+ * the same time span. Must be called with the data lock held.
+ **/
+void LinechartPlot::enforceMemoryBudget()
+{
+    qint64 usage = 0;
+    foreach (TimeSeriesData* series, data)
+    {
+        usage += series->getMemoryUsage();
+    }
+    if (usage <= memoryBudget) return;
+
+    while (usage > memoryBudget)
+    {
+        TimeSeriesData* oldest = NULL;
+        quint64 oldestEnd = QUINT64_MAX;
+        foreach (TimeSeriesData* series, data)
+        {
+            quint64 end = series->getOldestBlockEnd();
+            if (end > 0 && end < oldestEnd)
+            {
+                oldest = series;
+                oldestEnd = end;
+            }
+        }
+        // Only the recent data points are left
+        if (!oldest) break;
+
+        usage -= oldest->getMemoryUsage();
+        oldest->dropOldestBlock();
+        usage += oldest->getMemoryUsage();
+    }
+
+    // The data interval starts with the oldest data point left
+    quint64 first = QUINT64_MAX;
+    foreach (TimeSeriesData* series, data)
+    {
+        if (series->getCount() > 0) first = qMin(first, series->getFirstTime());
+    }
+    if (first != QUINT64_MAX && first > minTime)
+    {
+        minTime = first;
+        storageInterval = maxTime - minTime;
+    }
+}
+
+/**
+ * @param megabytes The memory budget of all curves, in megabytes
+ */
+void LinechartPlot::setMemoryBudget(int megabytes)
+{
+    datalock.lock();
+    memoryBudget = Q_INT64_C(1024) * 1024 * megabytes;
+    enforceMemoryBudget();
+    datalock.unlock();
+}
+
+qint64 LinechartPlot::getMemoryBudget()
+{
+    return memoryBudget;
+}
+
+/**
+ * @return The bytes used by the data points of the curve, 0 if it does not exist
+ */
+qint64 LinechartPlot::getMemoryUsage(QString id)
+{
+    qint64 usage = 0;
+    datalock.lock();
+    if (data.contains(id))
+    {
+        usage = data.value(id)->getMemoryUsage();
+    }
+    datalock.unlock();
+    return usage;
+}
+
+qint64 LinechartPlot::getMemoryUsage()
+{
+    qint64 usage = 0;
+    datalock.lock();
+    foreach (TimeSeriesData* series, data)
+    {
+        usage += series->getMemoryUsage();
+    }
+    datalock.unlock();
+    return usage;
+}
+
 /**
  * @param enforce true to reset the data timestamp with the receive / ground timestamp
  */
@@ -423,8 +536,8 @@ void LinechartPlot::setWindowPosition(quint64 end)
         plotPosition = end;
         setAxisScale(QwtPlot::xBottom, (plotPosition - getPlotInterval()), plotPosition, timeScaleStep);
     }
-    //@TODO Update the rest of the plot and update drawing
     windowLock.unlock();
+    updateCurves();
 }
 
 /**
@@ -719,6 +832,8 @@ void LinechartPlot::paintRealtime()
 
         windowLock.unlock();
 
+        updateCurves();
+
         // Defined both on windows 32- and 64 bit
 #if !(defined Q_OS_WIN)
 
@@ -805,11 +920,13 @@ TimeSeriesData::TimeSeriesData(QwtPlot* plot, QString friendlyName, quint64 plot
     minValue(DBL_MAX),
     maxValue(DBL_MIN),
     zeroValue(0),
-    count(0),
     mean(0.0),
     median(0.0),
     variance(0.0),
-    averageWindow(50)
+    averageWindow(50),
+    outputStart(0),
+    outputEnd(0),
+    outputCount(-1)
 {
     this->plot = plot;
     this->friendlyName = friendlyName;
@@ -822,6 +939,10 @@ TimeSeriesData::TimeSeriesData(QwtPlot* plot, QString friendlyName, quint64 plot
     stopTime = QUINT64_MIN;
 
     plotCount = 0;
+
+    // Keeps the plot arrays allocated while the window moves
+    outputMs.reserve(TimeSeriesStore::BLOCK_SIZE);
+    outputValue.reserve(TimeSeriesStore::BLOCK_SIZE);
 }
 
 TimeSeriesData::~TimeSeriesData()
@@ -844,61 +965,34 @@ void TimeSeriesData::setAverageWindowSize(int windowSize)
  *
  * @param ms The time in milliseconds
  * @param value The data value
+ * @return True if older data points were compressed into a new block
  **/
-void TimeSeriesData::append(quint64 ms, double value)
+bool TimeSeriesData::append(quint64 ms, double value)
 {
     dataMutex.lock();
-    // Pre- allocate new space
-    // FIXME Check this for validity
-    if(static_cast<quint64>(size()) < (count + 100)) {
-        this->ms.resize(size() + 10000);
-        this->value.resize(size() + 10000);
-    }
-    this->ms[count] = ms;
-    this->value[count] = value;
+    bool compressed = store.append(ms, value);
     this->lastValue = value;
+
+    // The averaging window is smaller than the raw tier of the store
+    int window = qMin(static_cast<int>(averageWindow), store.rawCount());
     this->mean = 0;
-    //QList<double> medianList = QList<double>();
-    for (unsigned int i = 0; (i < averageWindow) && (((int)count - (int)i) >= 0); ++i) {
-        this->mean += this->value[count-i];
-        //medianList.append(this->value[count-i]);
+    for (int i = 0; i < window; ++i) {
+        this->mean += store.recentValue(i);
     }
-    this->mean = mean / static_cast<double>(qMin(averageWindow,static_cast<unsigned int>(count)));
+    this->mean = mean / static_cast<double>(window);
 
     this->variance = 0;
-    for (unsigned int i = 0; (i < averageWindow) && (((int)count - (int)i) >= 0); ++i) {
-        this->variance += (this->value[count-i] - mean) * (this->value[count-i] - mean);
+    for (int i = 0; i < window; ++i) {
+        double sample = store.recentValue(i);
+        this->variance += (sample - mean) * (sample - mean);
     }
-    this->variance = this->variance / static_cast<double>(qMin(averageWindow,static_cast<unsigned int>(count)));
-
-//    qSort(medianList);
-
-//    if (medianList.count() > 2)
-//    {
-//        if (medianList.count() % 2 == 0)
-//        {
-//            median = (medianList.at(medianList.count()/2) + medianList.at(medianList.count()/2+1)) / 2.0;
-//        }
-//        else
-//        {
-//            median = medianList.at(medianList.count()/2+1);
-//        }
-//    }
+    this->variance = this->variance / static_cast<double>(window);
 
     // Update statistical values
     if(ms < startTime) startTime = ms;
     if(ms > stopTime) stopTime = ms;
     interval = stopTime - startTime;
 
-    if (interval > plotInterval) {
-        while (this->ms[count - plotCount] < stopTime - plotInterval) {
-            plotCount--;
-        }
-    }
-
-    count++;
-    plotCount++;
-
     if(minValue > value) minValue = value;
     if(maxValue < value) maxValue = value;
 
@@ -906,18 +1000,73 @@ void TimeSeriesData::append(quint64 ms, double value)
     if(maxInterval > 0) {
         // maxInterval = 0 means infinite
 
-        if(interval > maxInterval && !this->ms.isEmpty() && !this->value.isEmpty()) {
+        if(interval > maxInterval) {
             // The time at which this time series should be cut
-            double minTime = stopTime - maxInterval;
-            // Delete elements from the start of the list as long the time
-            // value of this elements is before the cut time
-            while(this->ms.first() < minTime) {
-                this->ms.pop_front();
-                this->value.pop_front();
+            quint64 minTime = stopTime - maxInterval;
+            // Drop whole blocks as long as all their elements are before the cut time
+            while(store.blockCount() > 0 && store.oldestBlockEnd() < minTime) {
+                store.dropOldestBlock();
+                outputCount = -1;
             }
+            startTime = store.firstTime();
         }
     }
     dataMutex.unlock();
+    return compressed;
+}
+
+/**
+ * @brief Copy the data points from start to end into the plot arrays
+ *
+ * Nothing is copied if neither the window nor the data changed since the last call.
+ *
+ * @param start The left edge of the plot window, in milliseconds
+ * @param end The right edge of the plot window, in milliseconds
+ **/
+void TimeSeriesData::updateWindow(quint64 start, quint64 end)
+{
+    dataMutex.lock();
+    if (start != outputStart || end != outputEnd || store.count() != outputCount)
+    {
+        plotCount = store.read(start, end, outputMs, outputValue);
+        outputStart = start;
+        outputEnd = end;
+        outputCount = store.count();
+    }
+    dataMutex.unlock();
+}
+
+qint64 TimeSeriesData::getMemoryUsage()
+{
+    dataMutex.lock();
+    qint64 usage = store.memoryUsage() + (outputMs.capacity() + outputValue.capacity()) * sizeof(double);
+    dataMutex.unlock();
+    return usage;
+}
+
+quint64 TimeSeriesData::getFirstTime()
+{
+    dataMutex.lock();
+    quint64 first = store.firstTime();
+    dataMutex.unlock();
+    return first;
+}
+
+quint64 TimeSeriesData::getOldestBlockEnd()
+{
+    dataMutex.lock();
+    quint64 end = store.oldestBlockEnd();
+    dataMutex.unlock();
+    return end;
+}
+
+int TimeSeriesData::dropOldestBlock()
+{
+    dataMutex.lock();
+    int dropped = store.dropOldestBlock();
+    outputCount = -1;
+    dataMutex.unlock();
+    return dropped;
 }
 
 /**
@@ -1008,7 +1157,7 @@ void TimeSeriesData::setZeroValue(double zeroValue)
  **/
 int TimeSeriesData::getCount() const
 {
-    return count;
+    return store.count();
 }
 
 /**
@@ -1022,44 +1171,23 @@ int TimeSeriesData::getPlotCount() const
 }
 
 /**
- * @brief Get the data array size
- * The data array size is \e NOT equal to the number of items in the data set, as
- * array space is pre-allocated. Use getCount() to get the number of data points.
- *
- * @return The data array size
- * @see getCount()
- **/
-int TimeSeriesData::size() const
-{
-    return ms.size();
-}
-
-/**
- * @brief Get the X (time) values
+ * @brief Get the X (time) values of the plot window
  *
- * @return The x values
+ * @return The x values, valid until the next updateWindow()
+ * @see updateWindow()
  **/
-const double* TimeSeriesData::getX() const
-{
-    return ms.data();
-}
-
 const double* TimeSeriesData::getPlotX() const
 {
-    return ms.data() + (count - plotCount);
+    return outputMs.constData();
 }
 
 /**
- * @brief Get the Y (data) values
+ * @brief Get the Y (data) values of the plot window
  *
- * @return The y values
+ * @return The y values, valid until the next updateWindow()
+ * @see updateWindow()
  **/
-const double* TimeSeriesData::getY() const
-{
-    return value.data();
-}
-
 const double* TimeSeriesData::getPlotY() const
 {
-    return value.data() + (count - plotCount);
+    return outputValue.constData();
 }
@@ -49,6 +49,7 @@ This file is part of the PIXHAWK project
 #include <qwt_plot.h>
 #include <ScrollZoomer.h>
 #include "MG.h"
+#include "TimeSeriesStore.h"
 
 class TimeScaleDraw: public QwtScaleDraw
 {
@@ -102,6 +103,9 @@ class QwtPlotCurve;
 /**
  * @brief Container class for the time series data
  *
+ * The samples are kept in a TimeSeriesStore, older ones compressed. The
+ * samples of the plot window are copied into plain arrays by updateWindow()
+ * before the curve is drawn.
  **/
 class TimeSeriesData
 {
@@ -110,14 +114,17 @@ public:
     TimeSeriesData(QwtPlot* plot, QString friendlyName = "data", quint64 plotInterval = 10000, quint64 maxInterval = 0, double zeroValue = 0);
     ~TimeSeriesData();
 
-    void append(quint64 ms, double value);
+    /**
+     * @brief Append a data point
+     * @return True if older data points were compressed into a new block
+     */
+    bool append(quint64 ms, double value);
+    /** @brief Copy the data points from start to end into the plot arrays */
+    void updateWindow(quint64 start, quint64 end);
 
     QwtScaleMap* getScaleMap();
 
     int getCount() const;
-    int size() const;
-    const double* getX() const;
-    const double* getY() const;
 
     const double* getPlotX() const;
     const double* getPlotY() const;
@@ -140,6 +147,15 @@ public:
     void setInterval(quint64 ms);
     void setAverageWindowSize(int windowSize);
 
+    /** @brief Bytes used by the stored data points */
+    qint64 getMemoryUsage();
+    /** @brief Oldest time stamp stored */
+    quint64 getFirstTime();
+    /** @brief Newest time stamp of the oldest compressed block, 0 if there is none */
+    quint64 getOldestBlockEnd();
+    /** @brief Drop the oldest compressed block, returns the number of data points dropped */
+    int dropOldestBlock();
+
 protected:
     QwtPlot* plot;
     quint64 startTime;
@@ -163,15 +179,16 @@ protected:
     void updateScaleMap();
 
 private:
-    quint64 count;
-    QwtArray<double> ms;
-    QwtArray<double> value;
+    TimeSeriesStore store;
     double mean;
     double median;
     double variance;
     unsigned int averageWindow;
-    QwtArray<double> outputMs;
+    QwtArray<double> outputMs;     ///< Data points of the plot window
     QwtArray<double> outputValue;
+    quint64 outputStart;            ///< Window of the plot arrays
+    quint64 outputEnd;
+    int outputCount;                ///< Number of data points stored when the plot arrays were filled
 };
 
 
@@ -215,6 +232,11 @@ public:
     double getVariance(QString id);
     /** @brief Get the last inserted value */
     double getCurrentValue(QString id);
+    /** @brief Get the bytes used by the data points of a curve */
+    qint64 getMemoryUsage(QString id);
+    /** @brief Get the bytes used by the data points of all curves */
+    qint64 getMemoryUsage();
+    qint64 getMemoryBudget();
 
     static const int SCALE_ABSOLUTE = 0;
     static const int SCALE_BEST_FIT = 1;
@@ -223,6 +245,7 @@ public:
     static const int DEFAULT_REFRESH_RATE = 100; ///< The default refresh rate is 10 Hz / every 100 ms
     static const int DEFAULT_PLOT_INTERVAL = 1000 * 8; ///< The default plot interval is 15 seconds
     static const int DEFAULT_SCALE_INTERVAL = 1000 * 8;
+    static const int DEFAULT_MEMORY_BUDGET = 128; ///< Megabytes of data points kept by all curves
 
 public slots:
     void setRefreshRate(int ms);
@@ -268,6 +291,15 @@ public slots:
     /** @brief Set the number of values to average over */
     void setAverageWindow(int windowSize);
     void removeTimedOutCurves();
+    /**
+     * @brief Set the memory available for the data points of all curves
+     *
+     * When the budget is exceeded the oldest compressed data points are dropped.
+     * The most recent data points of each curve are always kept.
+     *
+     * @param megabytes The budget, in megabytes
+     */
+    void setMemoryBudget(int megabytes);
 
     /** @brief Reset color map */
     void shuffleColors()
@@ -303,6 +335,7 @@ protected:
     quint64 maxTime; ///< The biggest timestamp occured so far
     quint64 maxInterval;
     quint64 storageInterval;
+    qint64 memoryBudget; ///< Bytes available for the data points of all curves
 
     double maxValue;
     double minValue;
@@ -325,6 +358,10 @@ protected:
 
     // Methods
     void addCurve(QString id);
+    /** @brief Copy the data points of the plot window into the curves */
+    void updateCurves();
+    /** @brief Drop the oldest compressed data points while over the memory budget */
+    void enforceMemoryBudget();
     QColor getNextColor();
     void showEvent(QShowEvent* event);
     void hideEvent(QHideEvent* event);
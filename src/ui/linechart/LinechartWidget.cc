@@ -104,6 +104,7 @@ LinechartWidget::LinechartWidget(int systemid, QWidget *parent) : QWidget(parent
     QLabel* value;
     QLabel* mean;
     QLabel* variance;
+    QLabel* memory;
 
     connect(ui.recolorButton, SIGNAL(clicked()), this, SLOT(recolor()));
     connect(ui.shortNameCheckBox, SIGNAL(clicked(bool)), this, SLOT(setShortNames(bool)));
@@ -136,6 +137,11 @@ LinechartWidget::LinechartWidget(int systemid, QWidget *parent) : QWidget(parent
     variance->setText("Variance");
     curvesWidgetLayout->addWidget(variance, labelRow, 6);
 
+    // Memory
+    memory = new QLabel(this);
+    memory->setText("Memory");
+    curvesWidgetLayout->addWidget(memory, labelRow, 7);
+
     // Create the layout
     createLayout();
 
@@ -186,6 +192,7 @@ void LinechartWidget::writeSettings()
     if (timeButton) settings.setValue("ENFORCE_GROUNDTIME", enforceGT);
     if (ui.showUnitsCheckBox) settings.setValue("SHOW_UNITS", ui.showUnitsCheckBox->isChecked());
     if (ui.shortNameCheckBox) settings.setValue("SHORT_NAMES", ui.shortNameCheckBox->isChecked());
+    settings.setValue("MEMORY_BUDGET_MB", memoryBudgetSpinBox->value());
     settings.endGroup();
     settings.sync();
 }
@@ -203,6 +210,7 @@ void LinechartWidget::readSettings()
     }
     if (ui.showUnitsCheckBox) ui.showUnitsCheckBox->setChecked(settings.value("SHOW_UNITS", ui.showUnitsCheckBox->isChecked()).toBool());
     if (ui.shortNameCheckBox) ui.shortNameCheckBox->setChecked(settings.value("SHORT_NAMES", ui.shortNameCheckBox->isChecked()).toBool());
+    memoryBudgetSpinBox->setValue(settings.value("MEMORY_BUDGET_MB", memoryBudgetSpinBox->value()).toInt());
     settings.endGroup();
 }
 
@@ -279,6 +287,19 @@ void LinechartWidget::createLayout()
     connect(timeButton, SIGNAL(clicked(bool)), activePlot, SLOT(enforceGroundTime(bool)));
     connect(timeButton, SIGNAL(clicked()), this, SLOT(writeSettings()));
 
+    // Memory budget spin box
+    memoryBudgetSpinBox = new QSpinBox(this);
+    memoryBudgetSpinBox->setToolTip(tr("Memory for the data of all curves. The oldest data is dropped when it is used up."));
+    memoryBudgetSpinBox->setWhatsThis(tr("Memory for the data of all curves. The oldest data is dropped when it is used up."));
+    memoryBudgetSpinBox->setSuffix(tr(" MB"));
+    memoryBudgetSpinBox->setMinimum(16);
+    memoryBudgetSpinBox->setMaximum(4096);
+    memoryBudgetSpinBox->setValue(LinechartPlot::DEFAULT_MEMORY_BUDGET);
+    layout->addWidget(memoryBudgetSpinBox, 1, 5);
+    layout->setColumnStretch(5, 0);
+    connect(memoryBudgetSpinBox, SIGNAL(valueChanged(int)), activePlot, SLOT(setMemoryBudget(int)));
+    connect(memoryBudgetSpinBox, SIGNAL(editingFinished()), this, SLOT(writeSettings()));
+
     // Initialize the "Show units" checkbox. This is configured in the .ui file, so all
     // we do here is attach the clicked() signal.
     connect(ui.showUnitsCheckBox, SIGNAL(clicked()), this, SLOT(writeSettings()));
@@ -523,6 +544,17 @@ void LinechartWidget::refresh()
         str.sprintf("% 8.3e", activePlot->getVariance(l.key()));
         l.value()->setText(str);
     }
+    QMap<QString, QLabel*>::iterator m;
+    for (m = curveMemory.begin(); m != curveMemory.end(); ++m) {
+        // Memory used by the raw and compressed data
+        qint64 bytes = activePlot->getMemoryUsage(m.key());
+        if (bytes >= 1024 * 1024) {
+            str.sprintf("%6.1f MB", bytes / (1024.0 * 1024.0));
+        } else {
+            str.sprintf("%6.1f KB", bytes / 1024.0);
+        }
+        m.value()->setText(str);
+    }
     setUpdatesEnabled(true);
 }
 
@@ -651,6 +683,7 @@ void LinechartWidget::addCurve(const QString& curve, const QString& unit)
     QLabel* unitLabel;
     QLabel* mean;
     QLabel* variance;
+    QLabel* memory;
 
     curveNames.insert(curve+unit, curve);
 
@@ -729,6 +762,14 @@ void LinechartWidget::addCurve(const QString& curve, const QString& unit)
     curveVariances->insert(curve+unit, variance);
     curvesWidgetLayout->addWidget(variance, labelRow, 6);
 
+    // Memory
+    memory = new QLabel(this);
+    memory->setStyleSheet(QString("QLabel {font-family:\"Courier\"; color: %1;}").arg("#AAAAAA"));
+    memory->setToolTip(tr("Memory used by the data of %1, older data is compressed").arg(curve));
+    memory->setWhatsThis(tr("Memory used by the data of %1, older data is compressed").arg(curve));
+    curveMemory.insert(curve+unit, memory);
+    curvesWidgetLayout->addWidget(memory, labelRow, 7);
+
     /* Color picker
     QColor color = QColorDialog::getColor(Qt::green, this);
          if (color.isValid()) {
@@ -771,6 +812,9 @@ void LinechartWidget::removeCurve(QString curve)
     widget = curveMeans->take(curve);
     curvesWidgetLayout->removeWidget(widget);
     widget->deleteLater();
+    widget = curveMemory.take(curve);
+    curvesWidgetLayout->removeWidget(widget);
+    widget->deleteLater();
     widget = curveMedians->take(curve);
     curvesWidgetLayout->removeWidget(widget);
     widget->deleteLater();
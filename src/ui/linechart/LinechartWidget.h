@@ -145,6 +145,7 @@ protected:
     QMap<QString, QLabel*>* curveMeans;   ///< References to the curve means
     QMap<QString, QLabel*>* curveMedians; ///< References to the curve medians
     QMap<QString, QLabel*>* curveVariances; ///< References to the curve variances
+    QMap<QString, QLabel*> curveMemory;   ///< References to the memory used by the curves
     QMap<QString, int> intData;           ///< Current values for integer-valued curves
     QMap<QString, QWidget*> colorIcons;    ///< Reference to color icons
 
@@ -152,6 +153,7 @@ protected:
     QGridLayout* curvesWidgetLayout;      ///< The layout for the curvesWidget QWidget
     QScrollBar* scrollbar;                ///< The plot window scroll bar
     QSpinBox* averageSpinBox;             ///< Spin box to setup average window filter size
+    QSpinBox* memoryBudgetSpinBox;        ///< Spin box to setup the memory budget of all curves
 
     QAction* setScalingLogarithmic;       ///< Set logarithmic scaling
     QAction* setScalingLinear;            ///< Set linear scaling
@@ -0,0 +1,462 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Tiered storage of the samples of a time series
+ */
+
+#include "TimeSeriesStore.h"
+
+#include <string.h>
+
+namespace
+{
+const int RAW_CAPACITY = (TimeSeriesStore::RAW_BLOCKS + 1) * TimeSeriesStore::BLOCK_SIZE;
+
+quint64 doubleBits(double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsDouble(quint64 bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int leadingZeros(quint64 x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while (!(x & (Q_UINT64_C(1) << 63)))
+    {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+int trailingZeros(quint64 x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1))
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/** @brief Appends bits to a byte array, most significant bit first */
+class BitWriter
+{
+public:
+    BitWriter(QByteArray& out) : out(out), free(0) {}
+
+    void write(quint64 value, int bits)
+    {
+        while (bits > 0)
+        {
+            if (free == 0)
+            {
+                out.append('\0');
+                free = 8;
+            }
+            int n = qMin(bits, free);
+            uchar chunk = (value >> (bits - n)) & ((1u << n) - 1);
+            out.data()[out.size() - 1] |= chunk << (free - n);
+            free -= n;
+            bits -= n;
+        }
+    }
+
+private:
+    QByteArray& out;
+    int free;   ///< Bits left in the last byte
+};
+
+class BitReader
+{
+public:
+    BitReader(const QByteArray& in) :
+        data(reinterpret_cast<const uchar*>(in.constData())),
+        size(in.size() * 8),
+        pos(0)
+    {}
+
+    quint64 read(int bits)
+    {
+        quint64 value = 0;
+        while (bits > 0 && pos < size)
+        {
+            int offset = pos & 7;
+            int available = 8 - offset;
+            int n = qMin(bits, available);
+            uchar chunk = (data[pos >> 3] >> (available - n)) & ((1u << n) - 1);
+            value = (value << n) | chunk;
+            pos += n;
+            bits -= n;
+        }
+        return value << bits;
+    }
+
+private:
+    const uchar* data;
+    qint64 size;
+    qint64 pos;
+};
+}
+
+TimeSeriesStore::TimeSeriesStore() :
+    rawStart(0),
+    rawSize(0),
+    compressedCount(0),
+    compressedSize(0)
+{
+}
+
+bool TimeSeriesStore::append(quint64 ms, double value)
+{
+    // Keep the samples sorted for the binary searches of read()
+    if (rawSize > 0 && ms < recentTime(0))
+    {
+        ms = recentTime(0);
+    }
+
+    bool compressed = false;
+    if (rawSize == RAW_CAPACITY)
+    {
+        compressOldest();
+        compressed = true;
+    }
+
+    // The ring grows until it is full the first time, nothing is compressed before
+    if (rawMs.size() < RAW_CAPACITY)
+    {
+        rawMs.append(ms);
+        rawValues.append(value);
+    }
+    else
+    {
+        int i = (rawStart + rawSize) % RAW_CAPACITY;
+        rawMs[i] = ms;
+        rawValues[i] = value;
+    }
+    ++rawSize;
+    return compressed;
+}
+
+void TimeSeriesStore::clear()
+{
+    rawMs.clear();
+    rawValues.clear();
+    rawStart = 0;
+    rawSize = 0;
+    blocks.clear();
+    compressedCount = 0;
+    compressedSize = 0;
+}
+
+int TimeSeriesStore::count() const
+{
+    return compressedCount + rawSize;
+}
+
+int TimeSeriesStore::rawCount() const
+{
+    return rawSize;
+}
+
+int TimeSeriesStore::blockCount() const
+{
+    return blocks.size();
+}
+
+int TimeSeriesStore::rawIndex(int age) const
+{
+    return (rawStart + rawSize - 1 - age) % RAW_CAPACITY;
+}
+
+double TimeSeriesStore::recentValue(int age) const
+{
+    return rawValues.at(rawIndex(age));
+}
+
+quint64 TimeSeriesStore::recentTime(int age) const
+{
+    return rawMs.at(rawIndex(age));
+}
+
+quint64 TimeSeriesStore::firstTime() const
+{
+    if (!blocks.isEmpty()) return blocks.first().firstMs;
+    if (rawSize > 0) return rawMs.at(rawStart);
+    return 0;
+}
+
+quint64 TimeSeriesStore::oldestBlockEnd() const
+{
+    if (blocks.isEmpty()) return 0;
+    return blocks.first().lastMs;
+}
+
+int TimeSeriesStore::dropOldestBlock()
+{
+    if (blocks.isEmpty()) return 0;
+    Block block = blocks.takeFirst();
+    compressedCount -= block.count;
+    compressedSize -= block.bits.size();
+    return block.count;
+}
+
+qint64 TimeSeriesStore::memoryUsage() const
+{
+    return (qint64)rawMs.capacity() * sizeof(quint64)
+            + (qint64)rawValues.capacity() * sizeof(double)
+            + compressedSize + (qint64)blocks.size() * sizeof(Block);
+}
+
+qint64 TimeSeriesStore::compressedBytes() const
+{
+    return compressedSize;
+}
+
+void TimeSeriesStore::compressOldest()
+{
+    quint64 ms[BLOCK_SIZE];
+    double values[BLOCK_SIZE];
+    for (int i = 0; i < BLOCK_SIZE; ++i)
+    {
+        int j = (rawStart + i) % RAW_CAPACITY;
+        ms[i] = rawMs.at(j);
+        values[i] = rawValues.at(j);
+    }
+
+    Block block;
+    block.firstMs = ms[0];
+    block.lastMs = ms[BLOCK_SIZE - 1];
+    block.count = BLOCK_SIZE;
+    encode(ms, values, BLOCK_SIZE, block.bits);
+    block.bits.squeeze();
+    blocks.append(block);
+    compressedCount += block.count;
+    compressedSize += block.bits.size();
+
+    rawStart = (rawStart + BLOCK_SIZE) % RAW_CAPACITY;
+    rawSize -= BLOCK_SIZE;
+}
+
+int TimeSeriesStore::read(quint64 start, quint64 end, QVector<double>& ms, QVector<double>& values) const
+{
+    ms.resize(0);
+    values.resize(0);
+    if (end < start) return 0;
+
+    foreach (const Block& block, blocks)
+    {
+        if (block.lastMs < start) continue;
+        if (block.firstMs > end) break;
+        decode(block.bits, block.count, start, end, ms, values);
+    }
+
+    // First raw sample of the window
+    int low = 0;
+    int high = rawSize;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (rawMs.at((rawStart + middle) % RAW_CAPACITY) < start)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    for (int i = low; i < rawSize; ++i)
+    {
+        int j = (rawStart + i) % RAW_CAPACITY;
+        if (rawMs.at(j) > end) break;
+        ms.append(rawMs.at(j));
+        values.append(rawValues.at(j));
+    }
+    return ms.size();
+}
+
+/*
+ * Block layout: the first timestamp and value with 64 bits each, then for
+ * every further sample its timestamp and its value.
+ *
+ * Timestamp, delta-of-delta D of the previous two intervals:
+ *   0                  D = 0
+ *   10   + 7 bits      D in -63..64
+ *   110  + 9 bits      D in -255..256
+ *   1110 + 12 bits     D in -2047..2048
+ *   1111 + 64 bits     any other D
+ *
+ * Value, X = bits of the value XOR bits of the previous value:
+ *   0                  X = 0
+ *   10 + bits          meaningful bits of X within the previous leading and trailing zeros
+ *   11 + 5 bits leading zeros + 6 bits length - 1 + bits
+ */
+void TimeSeriesStore::encode(const quint64* ms, const double* values, int count, QByteArray& bits)
+{
+    BitWriter writer(bits);
+    if (count == 0) return;
+    writer.write(ms[0], 64);
+    quint64 previous = doubleBits(values[0]);
+    writer.write(previous, 64);
+
+    qint64 previousDelta = 0;
+    int previousLeading = -1;
+    int previousTrailing = 0;
+    for (int i = 1; i < count; ++i)
+    {
+        qint64 delta = (qint64)(ms[i] - ms[i - 1]);
+        qint64 dod = delta - previousDelta;
+        previousDelta = delta;
+        if (dod == 0)
+        {
+            writer.write(0, 1);
+        }
+        else if (dod >= -63 && dod <= 64)
+        {
+            writer.write(2, 2);
+            writer.write(dod + 63, 7);
+        }
+        else if (dod >= -255 && dod <= 256)
+        {
+            writer.write(6, 3);
+            writer.write(dod + 255, 9);
+        }
+        else if (dod >= -2047 && dod <= 2048)
+        {
+            writer.write(14, 4);
+            writer.write(dod + 2047, 12);
+        }
+        else
+        {
+            writer.write(15, 4);
+            writer.write((quint64)dod, 64);
+        }
+
+        quint64 value = doubleBits(values[i]);
+        quint64 x = value ^ previous;
+        previous = value;
+        if (x == 0)
+        {
+            writer.write(0, 1);
+            continue;
+        }
+        int leading = qMin(leadingZeros(x), 31);
+        int trailing = trailingZeros(x);
+        if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing)
+        {
+            writer.write(2, 2);
+            writer.write(x >> previousTrailing, 64 - previousLeading - previousTrailing);
+        }
+        else
+        {
+            int length = 64 - leading - trailing;
+            writer.write(3, 2);
+            writer.write(leading, 5);
+            writer.write(length - 1, 6);
+            writer.write(x >> trailing, length);
+            previousLeading = leading;
+            previousTrailing = trailing;
+        }
+    }
+}
+
+void TimeSeriesStore::decode(const QByteArray& bits, int count, quint64 start, quint64 end,
+                             QVector<double>& ms, QVector<double>& values)
+{
+    BitReader reader(bits);
+    if (count == 0) return;
+    quint64 time = reader.read(64);
+    quint64 value = reader.read(64);
+    if (time >= start && time <= end)
+    {
+        ms.append(time);
+        values.append(bitsDouble(value));
+    }
+
+    qint64 delta = 0;
+    int leading = 0;
+    int trailing = 0;
+    for (int i = 1; i < count && time <= end; ++i)
+    {
+        qint64 dod;
+        if (reader.read(1) == 0)
+        {
+            dod = 0;
+        }
+        else if (reader.read(1) == 0)
+        {
+            dod = (qint64)reader.read(7) - 63;
+        }
+        else if (reader.read(1) == 0)
+        {
+            dod = (qint64)reader.read(9) - 255;
+        }
+        else if (reader.read(1) == 0)
+        {
+            dod = (qint64)reader.read(12) - 2047;
+        }
+        else
+        {
+            dod = (qint64)reader.read(64);
+        }
+        delta += dod;
+        time += delta;
+
+        if (reader.read(1) == 1)
+        {
+            if (reader.read(1) == 1)
+            {
+                leading = reader.read(5);
+                int length = reader.read(6) + 1;
+                trailing = 64 - leading - length;
+            }
+            quint64 x = reader.read(64 - leading - trailing);
+            value ^= x << trailing;
+        }
+
+        if (time >= start && time <= end)
+        {
+            ms.append(time);
+            values.append(bitsDouble(value));
+        }
+    }
+}
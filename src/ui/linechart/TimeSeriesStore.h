@@ -0,0 +1,122 @@
+/*===================================================================
+APM_PLANNER Open Source Ground Control Station
+
+(c) 2013 APM_PLANNER PROJECT <http://www.diydrones.com>
+
+This file is part of the APM_PLANNER project
+
+    APM_PLANNER is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    APM_PLANNER is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with APM_PLANNER. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Tiered storage of the samples of a time series
+ */
+
+#ifndef TIMESERIESSTORE_H
+#define TIMESERIESSTORE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief Stores the samples of a time series in two tiers.
+ *
+ * The most recent samples are kept raw in a ring buffer. Whenever the ring
+ * is full, its oldest BLOCK_SIZE samples are compressed into a block, the
+ * timestamps with delta-of-delta and the values with XOR encoding as done
+ * by Facebook's Gorilla time series database. Regular telemetry shrinks to
+ * a few bits per sample. Blocks are only decoded while a time window
+ * overlapping them is read.
+ *
+ * The samples are kept in ascending order of time, read() relies on it.
+ * A timestamp earlier than the newest one, e.g. after the clock of the
+ * vehicle was set back, is raised to the newest one. The store is not
+ * thread safe.
+ */
+class TimeSeriesStore
+{
+public:
+    enum
+    {
+        BLOCK_SIZE = 1024,  ///< Samples per compressed block
+        RAW_BLOCKS = 10     ///< Blocks kept raw at least, more than the largest averaging window
+    };
+
+    TimeSeriesStore();
+
+    /**
+     * @brief Append a sample
+     * @param ms Timestamp, raised to the newest one if it is earlier
+     * @return True if the oldest raw samples were compressed into a new block
+     */
+    bool append(quint64 ms, double value);
+    void clear();
+
+    /** @brief Number of samples stored, raw and compressed */
+    int count() const;
+    int rawCount() const;
+    int blockCount() const;
+
+    /** @brief Raw sample, 0 is the newest one */
+    double recentValue(int age) const;
+    quint64 recentTime(int age) const;
+
+    /** @brief Oldest timestamp stored, 0 if empty */
+    quint64 firstTime() const;
+    /** @brief Newest timestamp of the oldest block, 0 without blocks */
+    quint64 oldestBlockEnd() const;
+
+    /**
+     * @brief Copy all samples from start to end, both included
+     *
+     * The compressed blocks overlapping the window are decoded.
+     * @return The number of samples copied
+     */
+    int read(quint64 start, quint64 end, QVector<double>& ms, QVector<double>& values) const;
+
+    /** @brief Drop the oldest compressed block, e.g. to stay within a memory budget */
+    int dropOldestBlock();
+
+    /** @brief Bytes allocated for the raw and the compressed samples */
+    qint64 memoryUsage() const;
+    qint64 compressedBytes() const;
+
+private:
+    struct Block
+    {
+        quint64 firstMs;
+        quint64 lastMs;
+        int count;
+        QByteArray bits;
+    };
+
+    int rawIndex(int age) const;
+    void compressOldest();
+    static void encode(const quint64* ms, const double* values, int count, QByteArray& bits);
+    static void decode(const QByteArray& bits, int count, quint64 start, quint64 end,
+                       QVector<double>& ms, QVector<double>& values);
+
+    QVector<quint64> rawMs;
+    QVector<double> rawValues;
+    int rawStart;       ///< Index of the oldest raw sample in the ring
+    int rawSize;
+    QList<Block> blocks;
+    int compressedCount;
+    qint64 compressedSize;
+};
+
+#endif // TIMESERIESSTORE_H
@@ -274,9 +274,7 @@ Imagery::draw3D(double radius, double tileResolution,
 bool
 Imagery::update(void)
 {
-    mTextureCache->sync();
-
-    return true;
+    return mTextureCache->sync();
 }
 
 void
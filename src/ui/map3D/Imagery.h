@@ -71,6 +71,11 @@ public:
                 double xOffset, double yOffset,
                 const QString& utmZone);
 
+    /**
+     * @brief Synchronizes downloaded tiles with their textures.
+     * @return true while tiles are still being loaded and the
+     * scene should be redrawn again.
+     */
     bool update(void);
 
     static void LLtoUTM(double latitude, double longitude,
@@ -0,0 +1,256 @@
+/*=====================================================================
+
+QGroundControl Open Source Ground Control Station
+
+(c) 2009, 2010 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+
+This file is part of the QGROUNDCONTROL project
+
+    QGROUNDCONTROL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    QGROUNDCONTROL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with QGROUNDCONTROL. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Definition of the class OffscreenRenderBenchmark.
+ *
+ */
+
+#include "OffscreenRenderBenchmark.h"
+#include "MainWindow.h"
+#include "MAVLinkProtocol.h"
+#include "MAVLinkSimulationLink.h"
+#include "Pixhawk3DWidget.h"
+#include "QGCMAVLink.h"
+#include "UASManager.h"
+#include "QsLog.h"
+
+#include <QFile>
+#include <algorithm>
+
+#include <osg/Timer>
+#include <osgViewer/Viewer>
+
+namespace
+{
+/**
+ * Blocks until the GPU (or the software rasterizer) finished the frame,
+ * otherwise only the time to queue the GL commands would be measured.
+ */
+struct FinishDrawCallback : public osg::Camera::DrawCallback
+{
+    virtual void operator()(osg::RenderInfo& renderInfo) const
+    {
+        Q_UNUSED(renderInfo);
+        glFinish();
+    }
+};
+}
+
+OffscreenRenderBenchmark::OffscreenRenderBenchmark(int width, int height)
+    : mWidth(width)
+    , mHeight(height)
+    , mSystemId(-1)
+    , mLocalFrame(false)
+{
+
+}
+
+bool
+OffscreenRenderBenchmark::loadFlight(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        QLOG_ERROR() << "3D benchmark: cannot open" << fileName;
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    mMessages.clear();
+    mFrameEnds.clear();
+    mSystemId = -1;
+
+    mavlink_message_t message;
+    mavlink_status_t status;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    QVector<int> localEnds;
+    QVector<int> globalEnds;
+
+    // The 64 bit timestamps between the frames are skipped by the parser
+    for (int i = 0; i < data.size(); ++i)
+    {
+        if (!mavlink_parse_char(MAVLINK_COMM_3, static_cast<uint8_t>(data.at(i)), &message, &status))
+        {
+            continue;
+        }
+        if (mSystemId == -1)
+        {
+            mSystemId = message.sysid;
+        }
+        if (message.sysid != mSystemId)
+        {
+            continue;
+        }
+
+        int length = mavlink_msg_to_send_buffer(buffer, &message);
+        mMessages.append(QByteArray(reinterpret_cast<const char*>(buffer), length));
+
+        if (message.msgid == MAVLINK_MSG_ID_LOCAL_POSITION_NED)
+        {
+            localEnds.append(mMessages.size());
+        }
+        else if (message.msgid == MAVLINK_MSG_ID_GLOBAL_POSITION_INT)
+        {
+            globalEnds.append(mMessages.size());
+        }
+    }
+
+    // One position source, mixing both would make the vehicle jump between frames
+    mLocalFrame = !localEnds.isEmpty();
+    mFrameEnds = mLocalFrame ? localEnds : globalEnds;
+
+    QLOG_INFO() << "3D benchmark: loaded" << mFrameEnds.size()
+                << (mLocalFrame ? "LOCAL_POSITION_NED" : "GLOBAL_POSITION_INT")
+                << "frames of system" << mSystemId << "from" << fileName;
+
+    return !mFrameEnds.isEmpty();
+}
+
+bool
+OffscreenRenderBenchmark::run(Result& result)
+{
+    osg::ref_ptr<osg::GraphicsContext::Traits> traits = new osg::GraphicsContext::Traits;
+    traits->x = 0;
+    traits->y = 0;
+    traits->width = mWidth;
+    traits->height = mHeight;
+    traits->red = 8;
+    traits->green = 8;
+    traits->blue = 8;
+    traits->alpha = 8;
+    traits->depth = 24;
+    traits->windowDecoration = false;
+    traits->pbuffer = true;
+    traits->doubleBuffer = false;
+
+    osg::ref_ptr<osg::GraphicsContext> gc = osg::GraphicsContext::createGraphicsContext(traits.get());
+    if (!gc.valid())
+    {
+        QLOG_ERROR() << "3D benchmark: could not create an offscreen (pbuffer) context";
+        return false;
+    }
+
+    // The widget of the live view, never shown. It picks up the vehicle
+    // through UASManager like it does in flight.
+    Pixhawk3DWidget* widget = new Pixhawk3DWidget(MainWindow::instance());
+    widget->globalViewParams()->frameChanged(mLocalFrame ? "Local" : "Global");
+    Q3DWidget* view = widget->view();
+
+    // Replayed like QGCMAVLinkLogPlayer does
+    MAVLinkProtocol* protocol = MainWindow::instance()->getMAVLink();
+    MAVLinkSimulationLink* link = new MAVLinkSimulationLink("");
+
+    osgViewer::Viewer viewer;
+    viewer.setThreadingModel(osgViewer::Viewer::SingleThreaded);
+    viewer.getCamera()->setGraphicsContext(gc.get());
+    viewer.getCamera()->setViewport(new osg::Viewport(0, 0, mWidth, mHeight));
+    viewer.getCamera()->setProjectionMatrixAsPerspective(view->cameraParams().fov(),
+                                                         static_cast<double>(mWidth) / mHeight,
+                                                         view->cameraParams().minClipRange(),
+                                                         view->cameraParams().maxClipRange());
+    viewer.getCamera()->setComputeNearFarMode(osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR);
+    viewer.getCamera()->setClearColor(osg::Vec4f(0.0f, 0.0f, 0.0f, 0.0f));
+    viewer.getCamera()->setFinalDrawCallback(new FinishDrawCallback);
+    viewer.setLightingMode(osg::View::SKY_LIGHT);
+    viewer.setSceneData(view->getSceneData());
+    viewer.realize();
+
+    QVector<double> frameTimes;
+    frameTimes.reserve(mFrameEnds.size());
+    osg::Timer* timer = osg::Timer::instance();
+    bool following = false;
+
+    int next = 0;
+    for (int i = 0; i < mFrameEnds.size(); ++i)
+    {
+        QByteArray bytes;
+        for (; next < mFrameEnds.at(i); ++next)
+        {
+            bytes.append(mMessages.at(next));
+        }
+        protocol->receiveBytes(link, bytes);
+
+        // The vehicle exists once its first heartbeat was replayed
+        if (!following && UASManager::instance()->getUASForId(mSystemId))
+        {
+            widget->globalViewParams()->followCameraChanged(QString("MAV %1").arg(mSystemId));
+            following = true;
+        }
+
+        // Same work as a frame of the live view: update the scene, then draw it
+        osg::Timer_t start = timer->tick();
+        widget->update();
+        viewer.getCamera()->setViewMatrix(view->cameraManipulator()->getInverseMatrix());
+        viewer.frame();
+        frameTimes.append(timer->delta_m(start, timer->tick()));
+    }
+
+    link->disconnect();
+    delete link;
+    delete widget;
+
+    result = Result();
+    result.frames = frameTimes.size();
+    if (result.frames == 0)
+    {
+        return true;
+    }
+
+    for (int i = 0; i < frameTimes.size(); ++i)
+    {
+        result.totalMs += frameTimes.at(i);
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    result.minMs = frameTimes.first();
+    result.maxMs = frameTimes.last();
+    result.medianMs = frameTimes.at(frameTimes.size() / 2);
+    result.p95Ms = frameTimes.at(qMin(frameTimes.size() - 1, (frameTimes.size() * 95) / 100));
+
+    return true;
+}
+
+int
+OffscreenRenderBenchmark::exec(const QString& fileName, int width, int height)
+{
+    OffscreenRenderBenchmark benchmark(width, height);
+    if (!benchmark.loadFlight(fileName))
+    {
+        QLOG_ERROR() << "3D benchmark: no position data in" << fileName;
+        return 1;
+    }
+
+    Result result;
+    if (!benchmark.run(result))
+    {
+        return 1;
+    }
+
+    QLOG_INFO() << "3D benchmark:" << result.frames << "frames at" << width << "x" << height
+                << "mean" << result.meanMs() << "ms/frame"
+                << "median" << result.medianMs << "p95" << result.p95Ms
+                << "min" << result.minMs << "max" << result.maxMs;
+
+    return 0;
+}
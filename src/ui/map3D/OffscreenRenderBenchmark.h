@@ -0,0 +1,105 @@
+/*=====================================================================
+
+QGroundControl Open Source Ground Control Station
+
+(c) 2009, 2010 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+
+This file is part of the QGROUNDCONTROL project
+
+    QGROUNDCONTROL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    QGROUNDCONTROL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with QGROUNDCONTROL. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Definition of the class OffscreenRenderBenchmark.
+ *
+ */
+
+#ifndef OFFSCREENRENDERBENCHMARK_H
+#define OFFSCREENRENDERBENCHMARK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Renders a recorded flight with the scene graph of Pixhawk3DWidget
+ * into an offscreen pbuffer and reports the time spent per frame.
+ *
+ * The log is a QGroundControl .mavlink log. Its messages are fed through
+ * MAVLinkProtocol like a log replay, so the vehicle is created and moved by
+ * the same code as in flight. Every position message is one frame: the
+ * widget updates its scene (trail, model, camera following the vehicle)
+ * and the scene is drawn. No window and no GPU are needed, with Mesa the
+ * pbuffer is rendered in software (llvmpipe / OSMesa builds of
+ * OpenSceneGraph).
+ *
+ * The frames follow one position source only: LOCAL_POSITION_NED if the
+ * log has it, drawn in the local frame, otherwise GLOBAL_POSITION_INT,
+ * drawn in the global frame.
+ *
+ * Started from the command line, after the application was initialized,
+ * with
+ *   apmplanner2 --benchmark-3d <logfile> [width height]
+ */
+class OffscreenRenderBenchmark
+{
+public:
+    struct Result
+    {
+        Result() : frames(0), totalMs(0.0), minMs(0.0), maxMs(0.0),
+            medianMs(0.0), p95Ms(0.0) {}
+        int frames;
+        double totalMs;
+        double minMs;
+        double maxMs;
+        double medianMs;
+        double p95Ms;
+        double meanMs(void) const { return frames ? totalMs / frames : 0.0; }
+    };
+
+    OffscreenRenderBenchmark(int width = 1024, int height = 768);
+
+    /**
+     * @brief Reads the messages of the first system in a .mavlink log.
+     * @return false if the file could not be read or had no positions.
+     */
+    bool loadFlight(const QString& fileName);
+
+    /**
+     * @brief Replays the messages and renders one frame per position.
+     * Needs the main window, the 3D widget is created as its child.
+     * @return false if no offscreen context could be created.
+     */
+    bool run(Result& result);
+
+    /**
+     * @brief Loads the log, runs the benchmark and logs the result.
+     * @return process exit code.
+     */
+    static int exec(const QString& fileName, int width, int height);
+
+private:
+    int mWidth;
+    int mHeight;
+    int mSystemId;
+    bool mLocalFrame; /**< Frames follow LOCAL_POSITION_NED, not GLOBAL_POSITION_INT. */
+
+    /** Messages of the system, a frame ends after each position message. */
+    QVector<QByteArray> mMessages;
+    QVector<int> mFrameEnds;
+};
+
+#endif // OFFSCREENRENDERBENCHMARK_H
@@ -44,6 +44,7 @@
 #include "PixhawkCheetahNode.h"
 #include "TerrainParamDialog.h"
 #include "UASManager.h"
+#include "UASWaypointManager.h"
 
 #include "QGC.h"
 #include "gpl.h"
@@ -62,6 +63,8 @@ Pixhawk3DWidget::Pixhawk3DWidget(QWidget* parent)
  , mGlobalViewParams(new GlobalViewParams)
  , mFollowCameraId(-1)
  , mInitCameraPos(false)
+ , mDepthColormap(7.0f, true)
+ , mDistanceColormap(7.0f, false)
  , m3DWidget(new Q3DWidget(this))
  , mViewParamWidget(new ViewParamWidget(mGlobalViewParams, mSystemViewParamMap, this, parent))
 {
@@ -96,6 +99,12 @@ Pixhawk3DWidget::Pixhawk3DWidget(QWidget* parent)
     connect(mGlobalViewParams.data(), SIGNAL(imageryParamsChanged(void)),
             this, SLOT(imageryParamsChanged(void)));
 
+    // render on demand: redraw whenever the displayed state changes
+    connect(mGlobalViewParams.data(), SIGNAL(followCameraChanged(int)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(mGlobalViewParams.data(), SIGNAL(imageryParamsChanged(void)),
+            m3DWidget, SLOT(scheduleRedraw()));
+
     MainWindow* parentWindow = qobject_cast<MainWindow*>(parent);
     parentWindow->addDockWidget(Qt::LeftDockWidgetArea, mViewParamWidget);
 
@@ -110,6 +119,18 @@ Pixhawk3DWidget::~Pixhawk3DWidget()
 
 }
 
+Q3DWidget*
+Pixhawk3DWidget::view(void)
+{
+    return m3DWidget;
+}
+
+GlobalViewParamsPtr&
+Pixhawk3DWidget::globalViewParams(void)
+{
+    return mGlobalViewParams;
+}
+
 void
 Pixhawk3DWidget::activeSystemChanged(UASInterface* uas)
 {
@@ -145,6 +166,24 @@ Pixhawk3DWidget::systemCreated(UASInterface *uas)
             this, SLOT(setpointChanged(int,float,float,float,float)));
     connect(uas, SIGNAL(homePositionChanged(int,double,double,double)),
             this, SLOT(homePositionChanged(int,double,double,double)));
+
+    // render on demand: redraw whenever the displayed state changes
+    connect(uas, SIGNAL(localPositionChanged(UASInterface*,int,double,double,double,quint64)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas, SIGNAL(localPositionChanged(UASInterface*,double,double,double,quint64)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas, SIGNAL(attitudeChanged(UASInterface*,int,double,double,double,quint64)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas, SIGNAL(attitudeChanged(UASInterface*,double,double,double,quint64)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas, SIGNAL(userPositionSetPointsChanged(int,float,float,float,float)),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas->getWaypointManager(), SIGNAL(waypointEditableListChanged()),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas->getWaypointManager(), SIGNAL(waypointViewOnlyListChanged()),
+            m3DWidget, SLOT(scheduleRedraw()));
+    connect(uas->getWaypointManager(), SIGNAL(currentWaypointChanged(quint16)),
+            m3DWidget, SLOT(scheduleRedraw()));
 #if defined(QGC_PROTOBUF_ENABLED) && defined(QGC_USE_PIXHAWK_MESSAGES)
     connect(uas, SIGNAL(overlayChanged(UASInterface*)),
             this, SLOT(addOverlay(UASInterface*)));
@@ -477,6 +516,8 @@ Pixhawk3DWidget::clearData(void)
         systemData.trailMap().clear();
         systemData.trailNode()->removeDrawables(0, systemData.trailNode()->getNumDrawables());
     }
+
+    m3DWidget->scheduleRedraw();
 }
 
 void
@@ -577,6 +618,8 @@ Pixhawk3DWidget::modelChanged(int systemId, int index)
     systemGroupNode->egocentricMap()->removeChild(systemData.modelNode());
     systemData.modelNode() = systemData.models().at(index);
     systemGroupNode->egocentricMap()->addChild(systemData.modelNode());
+
+    m3DWidget->scheduleRedraw();
 }
 
 void
@@ -586,6 +629,7 @@ Pixhawk3DWidget::setBirdEyeView(void)
 
     m3DWidget->rotateCamera(0.0, 0.0, 0.0);
     m3DWidget->setCameraDistance(100.0);
+    m3DWidget->scheduleRedraw();
 }
 
 void
@@ -1258,7 +1302,8 @@ Pixhawk3DWidget::update(void)
         if (systemViewParams->displayPointCloud())
         {
             updatePointCloud(uas, frame, x, y, z, systemData.pointCloudNode(),
-                             systemViewParams->colorPointCloudByDistance());
+                             systemViewParams->colorPointCloudByDistance(),
+                             systemViewParams->pointCloudVoxelSize());
         }
         if (systemViewParams->displayRGBD())
         {
@@ -2357,7 +2402,11 @@ Pixhawk3DWidget::updateImagery(double originX, double originY,
                                  zone);
     }
 
-    mImageryNode->update();
+    if (mImageryNode->update())
+    {
+        // tiles are still arriving, draw them as they come in
+        m3DWidget->scheduleRedraw();
+    }
 }
 
 void
@@ -2511,33 +2560,18 @@ Pixhawk3DWidget::updateRGBD(UASInterface* uas, MAV_FRAME frame,
                                         osg::Image::NO_DELETE);
         rgbImageNode->image()->dirty();
 
-        QByteArray coloredDepth(rgbdImage.cols() * rgbdImage.rows() * 3, 0);
-        for (uint32_t r = 0; r < rgbdImage.rows(); ++r)
+        // The image owns the colored depth, it is only reallocated when the size changes
+        osg::Image* depthImage = depthImageNode->image();
+        if (depthImage->s() != static_cast<int>(rgbdImage.cols()) ||
+            depthImage->t() != static_cast<int>(rgbdImage.rows()) ||
+            depthImage->getPixelFormat() != GL_RGB)
         {
-            const float* depth = reinterpret_cast<const float*>(rgbdImage.imagedata2().c_str() + r * rgbdImage.step2());
-            uint8_t* pixel = reinterpret_cast<uint8_t*>(coloredDepth.data()) + r * rgbdImage.cols() * 3;
-            for (uint32_t c = 0; c < rgbdImage.cols(); ++c)
-            {
-                if (depth[c] != 0)
-                {
-                    int idx = fminf(depth[c], 7.0f) / 7.0f * 127.0f;
-                    idx = 127 - idx;
-
-                    float r, g, b;
-                    qgc::colormap("jet", idx, r, g, b);
-                    pixel[0] = r * 255.0f;
-                    pixel[1] = g * 255.0f;
-                    pixel[2] = b * 255.0f;
-                }
-
-                pixel += 3;
-            }
+            depthImage->allocateImage(rgbdImage.cols(), rgbdImage.rows(), 1,
+                                      GL_RGB, GL_UNSIGNED_BYTE);
         }
-
-        depthImageNode->image()->setImage(rgbdImage.cols(), rgbdImage.rows(), 1,
-                                          GL_RGB, GL_RGB, GL_UNSIGNED_BYTE,
-                                          reinterpret_cast<unsigned char *>(coloredDepth.data()),
-                                          osg::Image::NO_DELETE);
+        mDepthColormap.colorize(reinterpret_cast<const float*>(rgbdImage.imagedata2().c_str()),
+                                rgbdImage.cols(), rgbdImage.rows(), rgbdImage.step2(),
+                                depthImage->data(), rgbdImage.cols() * 3);
         depthImageNode->image()->dirty();
     }
 }
@@ -2546,7 +2580,8 @@ void
 Pixhawk3DWidget::updatePointCloud(UASInterface* uas, MAV_FRAME frame,
                                   double robotX, double robotY, double robotZ,
                                   osg::ref_ptr<osg::Geode>& pointCloudNode,
-                                  bool colorPointCloudByDistance)
+                                  bool colorPointCloudByDistance,
+                                  float voxelSize)
 {
     Q_UNUSED(frame);
 
@@ -2563,14 +2598,21 @@ Pixhawk3DWidget::updatePointCloud(UASInterface* uas, MAV_FRAME frame,
         return;
     }
 
-    for (int i = 0; i < pointCloud.points_size(); ++i)
+    // The arrays are sized for a full frame in createPointCloud(), they only grow
+    int pointCount = pointCloud.points_size();
+    if (static_cast<int>(vertices->size()) < pointCount)
     {
-        const px::PointCloudXYZRGB_PointXYZRGB& p = pointCloud.points(i);
+        vertices->resize(pointCount);
+        colors->resize(pointCount);
+    }
 
-        double x = p.x() - robotX;
-        double y = p.y() - robotY;
-        double z = p.z() - robotZ;
+    for (int i = 0; i < pointCount; ++i)
+    {
+        const px::PointCloudXYZRGB_PointXYZRGB& p = pointCloud.points(i);
 
+        float x = p.x() - robotX;
+        float y = p.y() - robotY;
+        float z = p.z() - robotZ;
 
         (*vertices)[i].set(y, x, -z);
 
@@ -2586,26 +2628,30 @@ Pixhawk3DWidget::updatePointCloud(UASInterface* uas, MAV_FRAME frame,
         }
         else
         {
-            double dist = sqrt(x * x + y * y + z * z);
-            int colorIndex = static_cast<int>(fmin(dist / 7.0 * 127.0, 127.0));
-
             float r, g, b;
-            qgc::colormap("jet", colorIndex, r, g, b);
+            mDistanceColormap.color(sqrtf(x * x + y * y + z * z), r, g, b);
 
             (*colors)[i].set(r, g, b, 1.0f);
         }
     }
 
+    if (voxelSize > 0.0f && pointCount > 0)
+    {
+        mPointCloudGrid.setLeafSize(voxelSize);
+        pointCount = mPointCloudGrid.filter((*vertices)[0].ptr(), (*colors)[0].ptr(), pointCount);
+    }
+
     if (geometry->getNumPrimitiveSets() == 0)
     {
         geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS,
-                                  0, pointCloud.points_size()));
+                                  0, pointCount));
     }
     else
     {
         osg::DrawArrays* drawarrays = static_cast<osg::DrawArrays*>(geometry->getPrimitiveSet(0));
-        drawarrays->setCount(pointCloud.points_size());
+        drawarrays->setCount(pointCount);
     }
+    geometry->dirtyBound();
 }
 
 #endif
@@ -37,6 +37,7 @@
 #include "HUDScaleGeode.h"
 #include "Imagery.h"
 #include "Q3DWidget.h"
+#include "RGBDKernels.h"
 #include "SystemContainer.h"
 #include "ViewParamWidget.h"
 
@@ -53,6 +54,12 @@ public:
     explicit Pixhawk3DWidget(QWidget* parent = 0);
     ~Pixhawk3DWidget();
 
+    /**
+     * @brief The view which draws the scene graph of this widget.
+     */
+    Q3DWidget* view(void);
+    GlobalViewParamsPtr& globalViewParams(void);
+
 public slots:
     void activeSystemChanged(UASInterface* uas);
     void systemCreated(UASInterface* uas);
@@ -62,6 +69,10 @@ public slots:
     void attitudeChanged(UASInterface* uas, double roll, double pitch, double yaw, quint64 time);
     void homePositionChanged(int uasId, double lat, double lon, double alt);
     void setpointChanged(int uasId, float x, float y, float z, float yaw);
+    /**
+     * @brief Updates the scene graph from the systems, called before every frame.
+     */
+    void update(void);
 
 signals:
     void systemCreatedSignal(UASInterface* uas);
@@ -97,7 +108,6 @@ private slots:
     void rotateTerrain(void);
 
     void sizeChanged(int width, int height);
-    void update(void);
 
 protected:
     void addModels(QVector< osg::ref_ptr<osg::Node> >& models,
@@ -169,7 +179,8 @@ private:
     void updatePointCloud(UASInterface* uas, MAV_FRAME frame,
                           double robotX, double robotY, double robotZ,
                           osg::ref_ptr<osg::Geode>& pointCloudNode,
-                          bool colorPointCloudByDistance);
+                          bool colorPointCloudByDistance,
+                          float voxelSize);
     void updateObstacles(UASInterface* uas, MAV_FRAME frame,
                          double robotX, double robotY, double robotZ,
                          osg::ref_ptr<ObstacleGroupNode>& obstacleGroupNode);
@@ -223,6 +234,10 @@ private:
     QVector3D mCameraPos;
     bool mInitCameraPos;
 
+    RGBD::DepthColormap mDepthColormap;
+    RGBD::DepthColormap mDistanceColormap;
+    RGBD::VoxelGrid mPointCloudGrid;
+
     Q3DWidget* m3DWidget;
     ViewParamWidget* mViewParamWidget;
 };
@@ -49,6 +49,9 @@ Q3DWidget::Q3DWidget(QWidget* parent)
     , mRoot(new osg::Group())
     , mHudGroup(new osg::Switch())
     , mHudProjectionMatrix(new osg::Projection)
+    , mRenderOnDemand(true)
+    , mContinuousUpdate(false)
+    , mLastFrameTick(0)
     , mFps(30.0f)
 {
 #ifdef QGC_OSG_QT_ENABLED
@@ -99,9 +102,91 @@ Q3DWidget::init(float fps)
     mCameraManipulator->setDistance(mCameraParams.minZoomRange() * 2.0);
 
     connect(&mTimer, SIGNAL(timeout()), this, SLOT(redraw()));
+    mTimer.setSingleShot(mRenderOnDemand);
+    // Catches scene changes nobody announced, e.g. timed out overlays
+    mIdleTimer.setInterval(1000);
+    connect(&mIdleTimer, SIGNAL(timeout()), this, SLOT(scheduleRedraw()));
     // DO NOT START TIMER IN INITIALIZATION! IT IS STARTED IN THE SHOW EVENT
 }
 
+void
+Q3DWidget::setRenderOnDemand(bool enabled)
+{
+    mRenderOnDemand = enabled;
+    mTimer.stop();
+    mIdleTimer.stop();
+    mTimer.setSingleShot(enabled);
+
+    if (isVisible())
+    {
+        if (enabled)
+        {
+            mIdleTimer.start();
+            scheduleRedraw();
+        }
+        else
+        {
+            mTimer.start(static_cast<int>(floorf(1000.0f / mFps)));
+        }
+    }
+}
+
+bool
+Q3DWidget::renderOnDemand(void) const
+{
+    return mRenderOnDemand;
+}
+
+const Q3DWidget::FrameStatistics&
+Q3DWidget::frameStatistics(void) const
+{
+    return mFrameStatistics;
+}
+
+void
+Q3DWidget::resetFrameStatistics(void)
+{
+    mFrameStatistics = FrameStatistics();
+}
+
+void
+Q3DWidget::requestRedraw(void)
+{
+    scheduleRedraw();
+}
+
+void
+Q3DWidget::requestContinuousUpdate(bool needed)
+{
+    mContinuousUpdate = needed;
+    if (needed)
+    {
+        scheduleRedraw();
+    }
+}
+
+void
+Q3DWidget::scheduleRedraw(void)
+{
+    ++mFrameStatistics.redrawRequests;
+
+    if (!mRenderOnDemand || !isVisible() || mTimer.isActive())
+    {
+        return;
+    }
+
+    // Keep the frame rate cap: wait for the rest of the frame interval
+    double intervalMs = 1000.0 / mFps;
+    double elapsedMs = osg::Timer::instance()->delta_m(mLastFrameTick,
+                                                       osg::Timer::instance()->tick());
+    int delayMs = 0;
+    if (mLastFrameTick != 0 && elapsedMs < intervalMs)
+    {
+        delayMs = static_cast<int>(intervalMs - elapsedMs);
+    }
+    mTimer.start(delayMs);
+}
+
 void
 Q3DWidget::setCameraParams(float minZoomRange, float cameraFov,
                            float minClipRange, float maxClipRange)
@@ -257,6 +342,7 @@ Q3DWidget::handleKeyPressEvent(QKeyEvent* event)
             static_cast<osgGA::GUIEventAdapter::KeySymbol>(
                 *(event->text().toAscii().data())));
     }
+    scheduleRedraw();
 }
 
 void
@@ -277,6 +363,7 @@ Q3DWidget::handleKeyReleaseEvent(QKeyEvent* event)
             static_cast<osgGA::GUIEventAdapter::KeySymbol>(
                 *(event->text().toAscii().data())));
     }
+    scheduleRedraw();
 }
 
 void
@@ -306,6 +393,7 @@ Q3DWidget::handleMousePressEvent(QMouseEvent* event)
         {}
     }
     mOsgGW->getEventQueue()->mouseButtonPress(event->x(), event->y(), button);
+    scheduleRedraw();
 }
 
 void
@@ -335,6 +423,7 @@ Q3DWidget::handleMouseReleaseEvent(QMouseEvent* event)
         {}
     }
     mOsgGW->getEventQueue()->mouseButtonRelease(event->x(), event->y(), button);
+    scheduleRedraw();
 }
 
 void
@@ -346,6 +435,7 @@ Q3DWidget::handleMouseMoveEvent(QMouseEvent* event)
     }
 
     mOsgGW->getEventQueue()->mouseMotion(event->x(), event->y());
+    scheduleRedraw();
 }
 
 void
@@ -359,6 +449,7 @@ Q3DWidget::handleWheelEvent(QWheelEvent* event)
     mOsgGW->getEventQueue()->mouseScroll((event->delta() > 0) ?
                                          osgGA::GUIEventAdapter::SCROLL_UP :
                                          osgGA::GUIEventAdapter::SCROLL_DOWN);
+    scheduleRedraw();
 }
 
 void
@@ -369,6 +460,11 @@ Q3DWidget::redraw(void)
     QLOG_DEBUG() << "EVENTLOOP:" << __FILE__ << __LINE__;
 #endif
     updateGL();
+
+    if (mRenderOnDemand && mContinuousUpdate)
+    {
+        scheduleRedraw();
+    }
 }
 
 void
@@ -382,6 +478,7 @@ Q3DWidget::resizeGL(int width, int height)
     mOsgGW->resized(0 , 0, width, height);
 
     emit sizeChanged(width, height);
+    scheduleRedraw();
 }
 
 void
@@ -480,7 +577,15 @@ Q3DWidget::showEvent(QShowEvent* event)
     // React only to internal (pre/post-display)
     // events
     Q_UNUSED(event)
-    mTimer.start(static_cast<int>(floorf(1000.0f / mFps)));
+    if (mRenderOnDemand)
+    {
+        mIdleTimer.start();
+        scheduleRedraw();
+    }
+    else
+    {
+        mTimer.start(static_cast<int>(floorf(1000.0f / mFps)));
+    }
 }
 
 void
@@ -490,6 +595,7 @@ Q3DWidget::hideEvent(QHideEvent* event)
     // events
     Q_UNUSED(event)
     mTimer.stop();
+    mIdleTimer.stop();
 }
 
 osg::ref_ptr<osg::Node>
@@ -526,7 +632,25 @@ Q3DWidget::paintGL(void)
     getCamera()->setClearColor(osg::Vec4f(0.0f, 0.0f, 0.0f, 0.0f));
     getCamera()->setClearMask(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    osg::Timer_t start = osg::Timer::instance()->tick();
+
     frame();
+
+    double frameMs = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+    mLastFrameTick = start;
+
+    FrameStatistics& stats = mFrameStatistics;
+    if (stats.frames == 0 || frameMs < stats.minMs)
+    {
+        stats.minMs = frameMs;
+    }
+    if (frameMs > stats.maxMs)
+    {
+        stats.maxMs = frameMs;
+    }
+    stats.lastMs = frameMs;
+    stats.totalMs += frameMs;
+    ++stats.frames;
 }
 
 osgGA::GUIEventAdapter::KeySymbol
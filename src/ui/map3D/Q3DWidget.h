@@ -37,6 +37,7 @@ This file is part of the QGROUNDCONTROL project
 
 #include <osg/LineSegment>
 #include <osg/PositionAttitudeTransform>
+#include <osg/Timer>
 #include <osgGA/TrackballManipulator>
 #include <osgText/Font>
 #include <osgViewer/Viewer>
@@ -156,6 +157,53 @@ public:
 
      void handleWheelEvent(QWheelEvent* event);
 
+     /**
+      * @brief Frame time statistics of the rendered frames.
+      */
+     struct FrameStatistics
+     {
+         FrameStatistics() : frames(0), redrawRequests(0), totalMs(0.0),
+             minMs(0.0), maxMs(0.0), lastMs(0.0) {}
+         quint64 frames;         /**< Number of frames rendered. */
+         quint64 redrawRequests; /**< Number of redraw requests received. */
+         double totalMs;         /**< Sum of all frame times. */
+         double minMs;           /**< Fastest frame. */
+         double maxMs;           /**< Slowest frame. */
+         double lastMs;          /**< Most recent frame. */
+         double meanMs(void) const { return frames ? totalMs / frames : 0.0; }
+     };
+
+     /**
+      * @brief Enables or disables render-on-demand.
+      * With render-on-demand enabled (the default) a frame is only drawn
+      * after scheduleRedraw() has been called, at most at the configured
+      * frame rate. With it disabled the scene is redrawn continuously.
+      */
+     void setRenderOnDemand(bool enabled);
+     bool renderOnDemand(void) const;
+
+     const FrameStatistics& frameStatistics(void) const;
+     void resetFrameStatistics(void);
+
+     /**
+      * @brief Called by OSG event handlers (e.g. the camera manipulator)
+      * when the scene needs to be drawn again.
+      */
+     virtual void requestRedraw(void);
+
+     /**
+      * @brief Called by OSG event handlers which need to be animated,
+      * e.g. a thrown camera, until they call it again with false.
+      */
+     virtual void requestContinuousUpdate(bool needed = true);
+
+public slots:
+    /**
+     * @brief Marks the scene as dirty, a frame is drawn as soon as the
+     * frame rate allows.
+     */
+    void scheduleRedraw(void);
+
 protected slots:
     /**
      * @brief Updates the widget.
@@ -257,6 +305,11 @@ protected:
     osg::ref_ptr<GCManipulator> mCameraManipulator; /**< Camera manipulator. */
 
     QTimer mTimer; /**< Timer which draws graphics based on specified fps. */
+    QTimer mIdleTimer; /**< Low rate refresh while nothing requests redraws. */
+    bool mRenderOnDemand; /**< Only draw frames that were requested. */
+    bool mContinuousUpdate; /**< An OSG handler requested animation. */
+    osg::Timer_t mLastFrameTick; /**< Start of the last rendered frame. */
+    FrameStatistics mFrameStatistics;
 
     CameraParams mCameraParams; /**< Struct representing camera parameters. */
     float mFps;
@@ -15,6 +15,7 @@ SystemViewParams::SystemViewParams(int systemId)
  , mDisplayTrails(true)
  , mDisplayWaypoints(true)
  , mModelIndex(-1)
+ , mPointCloudVoxelSize(0.0f)
  , mSetpointHistoryLength(100)
 {
 
@@ -177,6 +178,18 @@ SystemViewParams::modelNames(void) const
     return mModelNames;
 }
 
+float&
+SystemViewParams::pointCloudVoxelSize(void)
+{
+    return mPointCloudVoxelSize;
+}
+
+float
+SystemViewParams::pointCloudVoxelSize(void) const
+{
+    return mPointCloudVoxelSize;
+}
+
 int&
 SystemViewParams::setpointHistoryLength(void)
 {
@@ -197,6 +210,12 @@ SystemViewParams::modelChanged(int index)
     emit modelChangedSignal(mSystemId, index);
 }
 
+void
+SystemViewParams::setPointCloudVoxelSize(double size)
+{
+    mPointCloudVoxelSize = size;
+}
+
 void
 SystemViewParams::setSetpointHistoryLength(int length)
 {
@@ -53,11 +53,15 @@ public:
     QVector<QString>& modelNames(void);
     const QVector<QString>& modelNames(void) const;
 
+    float& pointCloudVoxelSize(void);
+    float pointCloudVoxelSize(void) const;
+
     int& setpointHistoryLength(void);
     int setpointHistoryLength(void) const;
 
 public slots:
     void modelChanged(int index);
+    void setPointCloudVoxelSize(double size);
     void setSetpointHistoryLength(int length);
     void toggleColorPointCloud(int state);
     void toggleLocalGrid(int state);
@@ -90,6 +94,7 @@ private:
     bool mDisplayWaypoints;
     int mModelIndex;
     QVector<QString> mModelNames;
+    float mPointCloudVoxelSize;
     int mSetpointHistoryLength;
 };
 
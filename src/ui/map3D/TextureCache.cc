@@ -46,13 +46,16 @@ TextureCache::TextureCache(int cacheSize)
 TexturePtr
 TextureCache::get(const QString& tileURL)
 {
+    // Looked up in the image cache first, so the tiles in view are marked
+    // as used and are the last ones to be replaced
+    QPair<WebImagePtr, int> p2 = mImageCache->lookup(tileURL);
+
     QPair<TexturePtr, int> p1 = lookup(tileURL);
     if (!p1.first.isNull())
     {
         return p1.first;
     }
 
-    QPair<WebImagePtr, int> p2 = mImageCache->lookup(tileURL);
     if (!p2.first.isNull())
     {
         mTextures[p2.second]->sync(p2.first);
@@ -64,41 +67,27 @@ TextureCache::get(const QString& tileURL)
     return TexturePtr();
 }
 
-void
+bool
 TextureCache::sync(void)
 {
-    if (requireSync())
+    // Only the tiles that finished loading or failed since the last frame
+    QVector<int> changed = mImageCache->takeChanged();
+    for (int i = 0; i < changed.size(); ++i)
     {
-        for (int i = 0; i < mTextures.size(); ++i)
-        {
-            mTextures[i]->sync(mImageCache->at(i));
-        }
+        mTextures[changed[i]]->sync(mImageCache->at(changed[i]));
     }
+
+    return mImageCache->hasPendingRequests();
 }
 
 QPair<TexturePtr, int>
 TextureCache::lookup(const QString& tileURL)
 {
-    for (int i = 0; i < mTextures.size(); ++i)
+    int index = mImageCache->indexOf(tileURL);
+    if (index >= 0 && mTextures[index]->getSourceURL() == tileURL)
     {
-        if (mTextures[i]->getSourceURL() == tileURL)
-        {
-            return qMakePair(mTextures[i], i);
-        }
+        return qMakePair(mTextures[index], index);
     }
 
     return qMakePair(TexturePtr(), -1);
 }
-
-bool
-TextureCache::requireSync(void) const
-{
-    for (int i = 0; i < mCacheSize; ++i)
-    {
-        if (mImageCache->at(i)->getSyncFlag())
-        {
-            return true;
-        }
-    }
-    return false;
-}
@@ -44,13 +44,15 @@ public:
 
     TexturePtr get(const QString& tileURL);
 
-    void sync(void);
+    /**
+     * @brief Uploads new images to their textures.
+     * @return true while images are still being loaded.
+     */
+    bool sync(void);
 
 private:
     QPair<TexturePtr, int32_t> lookup(const QString& tileURL);
 
-    bool requireSync(void) const;
-
     int mCacheSize;
     QVector<TexturePtr> mTextures;
 
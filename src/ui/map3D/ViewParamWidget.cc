@@ -2,6 +2,7 @@
 
 #include <osg/LineWidth>
 #include <QCheckBox>
+#include <QDoubleSpinBox>
 #include <QGroupBox>
 #include <QLabel>
 #include <QPushButton>
@@ -189,6 +190,15 @@ ViewParamWidget::addTab(int systemId)
     QCheckBox* pointCloudCheckBox = new QCheckBox(this);
     pointCloudCheckBox->setChecked(systemViewParams->displayPointCloud());
 
+    // 0 shows every point, otherwise one point per voxel
+    QDoubleSpinBox* voxelSizeSpinBox = new QDoubleSpinBox(this);
+    voxelSizeSpinBox->setRange(0.0, 1.0);
+    voxelSizeSpinBox->setSingleStep(0.01);
+    voxelSizeSpinBox->setDecimals(2);
+    voxelSizeSpinBox->setSuffix(" m");
+    voxelSizeSpinBox->setSpecialValueText(tr("Off"));
+    voxelSizeSpinBox->setValue(systemViewParams->pointCloudVoxelSize());
+
     QCheckBox* rgbdCheckBox = new QCheckBox(this);
     rgbdCheckBox->setChecked(systemViewParams->displayRGBD());
 
@@ -223,6 +233,7 @@ ViewParamWidget::addTab(int systemId)
     formLayout->addRow(tr("Obstacles"), obstacleListCheckBox);
     formLayout->addRow(tr("Planned Path"), plannedPathCheckBox);
     formLayout->addRow(tr("Point Cloud"), pointCloudCheckBox);
+    formLayout->addRow(tr("Point Cloud Voxel Size"), voxelSizeSpinBox);
     formLayout->addRow(tr("RGBD"), rgbdCheckBox);
     formLayout->addRow(tr("Setpoints"), setpointsCheckBox);
     formLayout->addRow(tr("Setpoint History Length"), mSetpointHistoryLengthSpinBox);
@@ -249,6 +260,8 @@ ViewParamWidget::addTab(int systemId)
             systemViewParams.data(), SLOT(togglePlannedPath(int)));
     connect(pointCloudCheckBox, SIGNAL(stateChanged(int)),
             systemViewParams.data(), SLOT(togglePointCloud(int)));
+    connect(voxelSizeSpinBox, SIGNAL(valueChanged(double)),
+            systemViewParams.data(), SLOT(setPointCloudVoxelSize(double)));
     connect(rgbdCheckBox, SIGNAL(stateChanged(int)),
             systemViewParams.data(), SLOT(toggleRGBD(int)));
     connect(setpointsCheckBox, SIGNAL(stateChanged(int)),
@@ -86,41 +86,59 @@ WebImage::getImageData(void) const
 bool
 WebImage::setData(const QByteArray& data)
 {
-    QImage tempImage;
-    if (tempImage.loadFromData(data))
-    {
-        if (mImage.isNull())
-        {
-            mImage.reset(new QImage);
-        }
-        *mImage = QGLWidget::convertToGLFormat(tempImage);
-
-        return true;
-    }
-    else
+    QImage image = toTexture(data);
+    if (image.isNull())
     {
         return false;
     }
+    setImage(image);
+
+    return true;
 }
 
 bool
 WebImage::setData(const QString& filename)
 {
-    QImage tempImage;
-    if (tempImage.load(filename))
+    QImage image = toTexture(filename);
+    if (image.isNull())
+    {
+        return false;
+    }
+    setImage(image);
+
+    return true;
+}
+
+void
+WebImage::setImage(const QImage& image)
+{
+    if (mImage.isNull())
     {
-        if (mImage.isNull())
-        {
-            mImage.reset(new QImage);
-        }
-        *mImage = QGLWidget::convertToGLFormat(tempImage);
+        mImage.reset(new QImage);
+    }
+    *mImage = image;
+}
 
-        return true;
+QImage
+WebImage::toTexture(const QByteArray& data)
+{
+    QImage tempImage;
+    if (!tempImage.loadFromData(data))
+    {
+        return QImage();
     }
-    else
+    return QGLWidget::convertToGLFormat(tempImage);
+}
+
+QImage
+WebImage::toTexture(const QString& filename)
+{
+    QImage tempImage;
+    if (!tempImage.load(filename))
     {
-        return false;
+        return QImage();
     }
+    return QGLWidget::convertToGLFormat(tempImage);
 }
 
 int
@@ -59,6 +59,16 @@ public:
     uchar* getImageData(void) const;
     bool setData(const QByteArray& data);
     bool setData(const QString& filename);
+    /** @brief Takes an image already converted with toTexture(). */
+    void setImage(const QImage& image);
+
+    /**
+     * @brief Decodes an image into the layout of an OpenGL texture.
+     * Safe to call from any thread.
+     * @return a null image if the data could not be decoded.
+     */
+    static QImage toTexture(const QByteArray& data);
+    static QImage toTexture(const QString& filename);
 
     int getWidth(void) const;
     int getHeight(void) const;
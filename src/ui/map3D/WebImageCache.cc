@@ -32,14 +32,28 @@ This file is part of the QGROUNDCONTROL project
 #include "WebImageCache.h"
 
 #include <cstdio>
+#include <QDesktopServices>
+#include <QNetworkDiskCache>
 #include <QNetworkReply>
 #include <QPixmap>
+#include <QUrl>
+
+namespace
+{
+    const qint64 kDiskCacheSize = 200 * 1024 * 1024;
+}
 
 WebImageCache::WebImageCache(QObject* parent, int cacheSize)
     : QObject(parent)
     , mCacheSize(cacheSize)
+    , mPrev(cacheSize, -1)
+    , mNext(cacheSize, -1)
+    , mHead(-1)
+    , mTail(-1)
     , mCurrentReference(0)
+    , mPendingRequests(0)
     , mNetworkManager(new QNetworkAccessManager)
+    , mLoader(new WebImageLoader)
 {
     for (int i = 0; i < mCacheSize; ++i)
     {
@@ -47,101 +61,106 @@ WebImageCache::WebImageCache(QObject* parent, int cacheSize)
 
         mWebImages.push_back(image);
     }
+    // Taken from the back, the first slots are used first
+    for (int i = mCacheSize - 1; i >= 0; --i)
+    {
+        mFree.push_back(i);
+    }
+    mIndex.reserve(mCacheSize);
+
+    // Tiles downloaded in earlier sessions are read from disk
+    QNetworkDiskCache* diskCache = new QNetworkDiskCache(mNetworkManager.data());
+    diskCache->setCacheDirectory(QDesktopServices::storageLocation(QDesktopServices::CacheLocation) + "/imagery");
+    diskCache->setMaximumCacheSize(kDiskCacheSize);
+    mNetworkManager->setCache(diskCache);
 
     connect(mNetworkManager.data(), SIGNAL(finished(QNetworkReply*)),
             this, SLOT(downloadFinished(QNetworkReply*)));
+
+    mLoader->moveToThread(&mLoaderThread);
+    connect(this, SIGNAL(loadFileRequested(int,QString,QString)),
+            mLoader.data(), SLOT(loadFile(int,QString,QString)));
+    connect(this, SIGNAL(decodeRequested(int,QString,QByteArray)),
+            mLoader.data(), SLOT(decode(int,QString,QByteArray)));
+    connect(mLoader.data(), SIGNAL(loaded(int,QString,QImage)),
+            this, SLOT(imageLoaded(int,QString,QImage)));
+    mLoaderThread.start(QThread::LowPriority);
+}
+
+WebImageCache::~WebImageCache()
+{
+    mLoaderThread.quit();
+    mLoaderThread.wait();
 }
 
 QPair<WebImagePtr, int>
 WebImageCache::lookup(const QString& url)
 {
-    QPair<WebImagePtr, int> cacheEntry;
-
-    for (int i = 0; i < mWebImages.size(); ++i)
+    QHash<QString, int>::const_iterator it = mIndex.constFind(url);
+    if (it != mIndex.constEnd())
     {
-        WebImagePtr& image = mWebImages[i];
-
-        if (image->getState() != WebImage::UNINITIALIZED &&
-            image->getSourceURL() == url)
+        int index = it.value();
+        WebImagePtr& image = mWebImages[index];
+        if (image->getState() == WebImage::READY)
+        {
+            image->setLastReference(mCurrentReference);
+            ++mCurrentReference;
+            unlink(index);
+            pushFront(index);
+            return qMakePair(image, index);
+        }
+        else
         {
-            cacheEntry.first = image;
-            cacheEntry.second = i;
-            break;
+            return qMakePair(WebImagePtr(), -1);
         }
     }
 
-    if (cacheEntry.first.isNull())
+    int index;
+    if (!mFree.isEmpty())
     {
-        for (int i = 0; i < mWebImages.size(); ++i)
-        {
-            WebImagePtr& image = mWebImages[i];
-
-            // get uninitialized image
-            if (image->getState() == WebImage::UNINITIALIZED)
-            {
-                cacheEntry.first = image;
-                cacheEntry.second = i;
-                break;
-            }
-            // get oldest image
-            else if (image->getState() == WebImage::READY &&
-                     (cacheEntry.first.isNull() ||
-                      image->getLastReference() <
-                      cacheEntry.first->getLastReference()))
-            {
-                cacheEntry.first = image;
-                cacheEntry.second = i;
-            }
-        }
+        index = mFree.back();
+        mFree.pop_back();
+    }
+    else if (mTail >= 0)
+    {
+        // Replace the least recently used tile
+        index = mTail;
+        unlink(index);
+        mIndex.remove(mWebImages[index]->getSourceURL());
+        mWebImages[index]->clear();
+    }
+    else
+    {
+        return qMakePair(WebImagePtr(), -1);
+    }
 
-        if (cacheEntry.first.isNull())
-        {
-           return qMakePair(WebImagePtr(), -1);
-        }
-        else
-        {
-            if (cacheEntry.first->getState() == WebImage::READY)
-            {
-                cacheEntry.first->clear();
-            }
-            cacheEntry.first->setSourceURL(url);
-            cacheEntry.first->setLastReference(mCurrentReference);
-            ++mCurrentReference;
-            cacheEntry.first->setState(WebImage::REQUESTED);
-
-            if (url.left(4).compare("http") == 0)
-            {
-                mNetworkManager->get(QNetworkRequest(QUrl(url)));
-            }
-            else
-            {
-                if (cacheEntry.first->setData(url))
-                {
-                    cacheEntry.first->setSyncFlag(true);
-                    cacheEntry.first->setState(WebImage::READY);
-                }
-                else
-                {
-                    cacheEntry.first->setState(WebImage::UNINITIALIZED);
-                }
-            }
-
-            return cacheEntry;
-        }
+    WebImagePtr& image = mWebImages[index];
+    image->setSourceURL(url);
+    image->setLastReference(mCurrentReference);
+    ++mCurrentReference;
+    image->setState(WebImage::REQUESTED);
+    mIndex.insert(url, index);
+    ++mPendingRequests;
+
+    if (url.left(4).compare("http") == 0)
+    {
+        QNetworkRequest request = QNetworkRequest(QUrl(url));
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute,
+                             QNetworkRequest::PreferCache);
+        request.setAttribute(QNetworkRequest::User, url);
+        mNetworkManager->get(request);
     }
     else
     {
-        if (cacheEntry.first->getState() == WebImage::READY)
+        QString filename = url;
+        if (url.startsWith("file:"))
         {
-            cacheEntry.first->setLastReference(mCurrentReference);
-            ++mCurrentReference;
-            return cacheEntry;
-        }
-        else
-        {
-            return qMakePair(WebImagePtr(), -1);
+            filename = QUrl(url).toLocalFile();
         }
+        emit loadFileRequested(index, url, filename);
     }
+
+    return qMakePair(image, index);
 }
 
 WebImagePtr
@@ -150,31 +169,125 @@ WebImageCache::at(int index) const
     return mWebImages[index];
 }
 
+int
+WebImageCache::indexOf(const QString& url) const
+{
+    return mIndex.value(url, -1);
+}
+
+QVector<int>
+WebImageCache::takeChanged(void)
+{
+    QVector<int> changed;
+    changed.swap(mChanged);
+    return changed;
+}
+
+bool
+WebImageCache::hasPendingRequests(void) const
+{
+    return mPendingRequests > 0;
+}
+
 void
 WebImageCache::downloadFinished(QNetworkReply* reply)
 {
     reply->deleteLater();
 
-    if (reply->error() != QNetworkReply::NoError)
+    QString url = reply->request().attribute(QNetworkRequest::User).toString();
+    int index = indexOf(url);
+    if (index < 0)
     {
         return;
     }
-    QVariant attribute = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
-    if (attribute.isValid())
+
+    if (reply->error() != QNetworkReply::NoError ||
+        reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid())
     {
+        drop(index);
         return;
     }
 
-    WebImagePtr image;
-    foreach(image, mWebImages)
+    // Still pending until the loader thread has decoded it
+    emit decodeRequested(index, url, reply->readAll());
+}
+
+void
+WebImageCache::imageLoaded(int index, const QString& url, const QImage& image)
+{
+    if (indexOf(url) != index ||
+        mWebImages[index]->getState() != WebImage::REQUESTED)
     {
-        if (reply->url().toString() == image->getSourceURL())
-        {
-            image->setData(reply->readAll());
-            image->setSyncFlag(true);
-            image->setState(WebImage::READY);
+        return;
+    }
+    if (image.isNull())
+    {
+        drop(index);
+        return;
+    }
 
-            return;
-        }
+    if (mPendingRequests > 0)
+    {
+        --mPendingRequests;
+    }
+    mWebImages[index]->setImage(image);
+    mWebImages[index]->setSyncFlag(true);
+    mWebImages[index]->setState(WebImage::READY);
+    pushFront(index);
+    mChanged.push_back(index);
+}
+
+void
+WebImageCache::drop(int index)
+{
+    if (mPendingRequests > 0)
+    {
+        --mPendingRequests;
+    }
+    // Requested again the next time it is looked up
+    mIndex.remove(mWebImages[index]->getSourceURL());
+    mWebImages[index]->clear();
+    mFree.push_back(index);
+    mChanged.push_back(index);
+}
+
+void
+WebImageCache::unlink(int index)
+{
+    int prev = mPrev[index];
+    int next = mNext[index];
+    if (prev >= 0)
+    {
+        mNext[prev] = next;
+    }
+    else if (mHead == index)
+    {
+        mHead = next;
+    }
+    if (next >= 0)
+    {
+        mPrev[next] = prev;
+    }
+    else if (mTail == index)
+    {
+        mTail = prev;
+    }
+    mPrev[index] = -1;
+    mNext[index] = -1;
+}
+
+void
+WebImageCache::pushFront(int index)
+{
+    mPrev[index] = -1;
+    mNext[index] = mHead;
+    if (mHead >= 0)
+    {
+        mPrev[mHead] = index;
+    }
+    mHead = index;
+    if (mTail < 0)
+    {
+        mTail = index;
     }
 }
@@ -32,33 +32,81 @@ This file is part of the QGROUNDCONTROL project
 #ifndef WEBIMAGECACHE_H
 #define WEBIMAGECACHE_H
 
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QObject>
 #include <QPair>
+#include <QThread>
+#include <QVector>
 
 #include "WebImage.h"
+#include "WebImageLoader.h"
 
+/**
+ * @brief Fixed number of imagery tiles, looked up by their URL.
+ *
+ * Tiles are found through a hash of their URLs. When the cache is full, the
+ * least recently used ready tile is replaced, found in constant time from
+ * a list ordered by use. Local tiles are read and all tiles are decoded in
+ * a loader thread. Downloads go through a disk cache shared across
+ * sessions.
+ */
 class WebImageCache : public QObject
 {
     Q_OBJECT
 
 public:
     WebImageCache(QObject* parent, int cacheSize);
+    ~WebImageCache();
 
+    /**
+     * @brief Returns the tile of the URL, requesting it if it is not cached.
+     * @return the image and its index, a null image if the tile is still
+     *         loading or no slot is free.
+     */
     QPair<WebImagePtr, int> lookup(const QString& url);
 
     WebImagePtr at(int index) const;
 
+    /** @return the index of the tile with the URL, -1 if it is not cached. */
+    int indexOf(const QString& url) const;
+
+    /** @brief Returns and forgets the indices of the tiles loaded or dropped since the last call */
+    QVector<int> takeChanged(void);
+
+    /** @brief True while tiles are still being downloaded */
+    bool hasPendingRequests(void) const;
+
+signals:
+    void loadFileRequested(int index, const QString& url, const QString& filename);
+    void decodeRequested(int index, const QString& url, const QByteArray& data);
+
 private Q_SLOTS:
     void downloadFinished(QNetworkReply* reply);
+    void imageLoaded(int index, const QString& url, const QImage& image);
 
 private:
+    /** @brief Frees the slot of a tile that could not be loaded */
+    void drop(int index);
+    void unlink(int index);
+    void pushFront(int index);
+
     int mCacheSize;
 
     QVector<WebImagePtr> mWebImages;
+    QHash<QString, int> mIndex;     /**< Slot of every requested or ready URL. */
+    QVector<int> mFree;             /**< Slots without a tile. */
+    QVector<int> mPrev;             /**< Ready tiles, most recently used first. */
+    QVector<int> mNext;
+    int mHead;
+    int mTail;
+    QVector<int> mChanged;
     quint64 mCurrentReference;
+    int mPendingRequests;
 
     QScopedPointer<QNetworkAccessManager> mNetworkManager;
+    QThread mLoaderThread;
+    QScopedPointer<WebImageLoader> mLoader;
 };
 
 #endif // WEBIMAGECACHE_H
@@ -0,0 +1,59 @@
+/*=====================================================================
+
+QGroundControl Open Source Ground Control Station
+
+(c) 2009, 2010 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+
+This file is part of the QGROUNDCONTROL project
+
+    QGROUNDCONTROL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    QGROUNDCONTROL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with QGROUNDCONTROL. If not, see <http://www.gnu.org/licenses/>.
+
+======================================================================*/
+
+/**
+ * @file
+ *   @brief Definition of the class WebImageLoader.
+ *
+ */
+
+#ifndef WEBIMAGELOADER_H
+#define WEBIMAGELOADER_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QObject>
+#include <QString>
+
+/**
+ * @brief Reads and decodes imagery tiles away from the render thread.
+ *
+ * Lives in the loader thread of WebImageCache. Every request is answered
+ * with loaded(), the image is null if the tile could not be read.
+ */
+class WebImageLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WebImageLoader(QObject* parent = 0);
+
+public slots:
+    void loadFile(int index, const QString& url, const QString& filename);
+    void decode(int index, const QString& url, const QByteArray& data);
+
+signals:
+    void loaded(int index, const QString& url, const QImage& image);
+};
+
+#endif // WEBIMAGELOADER_H